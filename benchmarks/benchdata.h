@@ -0,0 +1,39 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <canframerecord.h>
+
+namespace Bench {
+
+// Typical size of single backend drain at high bus load
+constexpr int kBatchSize = 64;
+
+/**
+*   @brief  Generates 8 byte frames cycling through given number of ids, timestamps advance 100 us per frame
+*/
+inline QVector<QCanBusFrame> makeFrames(int count, int ids = 200, quint64 firstTimestamp = 1000000)
+{
+    QVector<QCanBusFrame> frames;
+
+    frames.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QCanBusFrame frame(static_cast<quint32>(0x100 + i % ids), QByteArray(8, static_cast<char>(i)));
+        const quint64 ts = firstTimestamp + static_cast<quint64>(i) * 100;
+
+        frame.setTimeStamp(QCanBusFrame::TimeStamp(ts / 1000000, ts % 1000000));
+        frames.append(frame);
+    }
+
+    return frames;
+}
+
+inline CanFrameBatch makeBatch(int count, int ids = 200, quint64 firstTimestamp = 1000000)
+{
+    return toCanFrameBatch(makeFrames(count, ids, firstTimestamp), Direction::RX);
+}
+
+} // namespace Bench
+
+#endif // BENCHDATA_H
@@ -0,0 +1,148 @@
+#include "benchmark.h"
+#include <QtCore/QCommandLineParser>
+#include <QtWidgets/QApplication>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <log.h>
+#include <new>
+#include <string>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+std::atomic<quint64> allocations{ 0 };
+
+struct Case {
+    const char* name;
+    Bench::Function fn;
+    std::vector<qint64> args;
+};
+
+std::vector<Case>& registry()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void* allocate(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return std::malloc(size ? size : 1);
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* ptr = allocate(size);
+
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace Bench {
+
+quint64 allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+Registrar::Registrar(const char* name, const Function& fn, std::vector<qint64> args)
+{
+    registry().push_back({ name, fn, std::move(args) });
+}
+
+} // namespace Bench
+
+int main(int argc, char* argv[])
+{
+    // Components create widgets, nothing is shown though
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cds_benchmarks");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Micro-benchmarks of frame pipeline hot paths");
+    parser.addHelpOption();
+    QCommandLineOption filterOption(
+        QStringList{ "f", "filter" }, "Run only benchmarks whose name contains given text.", "text");
+    QCommandLineOption timeOption(
+        QStringList{ "t", "min-time" }, "Minimum measured time of each benchmark in seconds.", "seconds", "0.5");
+    parser.addOption(filterOption);
+    parser.addOption(timeOption);
+    parser.process(app);
+
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    // Benchmarked paths log on purpose (e.g. full send queue), that should not be measured
+    kDefaultLogger->set_level(spdlog::level::err);
+
+    const std::string filter = parser.value(filterOption).toStdString();
+    const double minTime = parser.value(timeOption).toDouble();
+
+    std::printf("%-40s %10s %10s %12s %14s %12s\n", "benchmark", "arg", "iterations", "ns/item", "items/s",
+        "allocs/item");
+
+    for (const auto& c : registry()) {
+        if (std::string(c.name).find(filter) == std::string::npos) {
+            continue;
+        }
+
+        for (auto arg : c.args) {
+            Bench::State state(arg, minTime);
+
+            c.fn(state);
+
+            const auto& r = state.result();
+            const double items = static_cast<double>(r.items ? r.items : 1);
+
+            std::printf("%-40s %10lld %10llu %12.1f %14.0f %12.3f\n", c.name, static_cast<long long>(arg),
+                static_cast<unsigned long long>(r.iterations), r.seconds * 1e9 / items, r.items / r.seconds,
+                r.allocations / items);
+            std::fflush(stdout);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QtCore/QtGlobal>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+/**
+*   @brief  Minimal micro-benchmark harness
+*
+*   Every benchmark runs its body until minimum time elapses and reports throughput together with number of heap
+*   allocations per processed item. Allocations are counted process wide by replaced global operator new, so
+*   allocations made by Qt on behalf of the measured code are included.
+*/
+namespace Bench {
+
+/**
+*   @return number of heap allocations since program start
+*/
+quint64 allocationCount();
+
+struct Result {
+    quint64 iterations{ 0 };
+    quint64 items{ 0 };
+    quint64 allocations{ 0 };
+    double seconds{ 0.0 };
+};
+
+class State {
+public:
+    State(qint64 arg, double minTime)
+        : _arg(arg)
+        , _minTime(minTime)
+    {
+    }
+
+    /**
+    *   @return argument the benchmark was registered with (e.g. number of rows)
+    */
+    qint64 arg() const
+    {
+        return _arg;
+    }
+
+    /**
+    *   @brief  Runs body repeatedly until minimum time elapses. Only the body is measured.
+    *   @param  setup executed before every iteration, not measured
+    *   @param  body measured code, returns number of items (e.g. frames) it processed
+    */
+    template <typename S, typename F> void run(S&& setup, F&& body)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Warm-up fills caches and lets containers reach their steady size
+        setup();
+        body();
+
+        do {
+            setup();
+
+            const quint64 allocations = allocationCount();
+            const auto start = Clock::now();
+            const quint64 items = body();
+            const auto end = Clock::now();
+
+            _result.allocations += allocationCount() - allocations;
+            _result.seconds += std::chrono::duration<double>(end - start).count();
+            _result.items += items;
+            ++_result.iterations;
+        } while (_result.seconds < _minTime);
+    }
+
+    template <typename F> void run(F&& body)
+    {
+        run([] {}, std::forward<F>(body));
+    }
+
+    const Result& result() const
+    {
+        return _result;
+    }
+
+private:
+    const qint64 _arg;
+    const double _minTime;
+    Result _result;
+};
+
+typedef std::function<void(State&)> Function;
+
+/**
+*   @brief  Registers benchmark at static initialization. Benchmark is run once per argument.
+*/
+struct Registrar {
+    Registrar(const char* name, const Function& fn, std::vector<qint64> args);
+};
+
+} // namespace Bench
+
+#define CDS_BENCHMARK_ARGS(fn, ...) static const Bench::Registrar fn##_registrar(#fn, fn, { __VA_ARGS__ })
+#define CDS_BENCHMARK(fn) CDS_BENCHMARK_ARGS(fn, 0)
+
+#endif // BENCHMARK_H
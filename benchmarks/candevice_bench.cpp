@@ -0,0 +1,107 @@
+#include "benchdata.h"
+#include "benchmark.h"
+#include "fakecandevice.h"
+#include <QtCore/QCoreApplication>
+#include <candevice.h>
+#include <context.h>
+#include <datamodeltypes/candevicedata.h>
+#include <projectconfig/candevicemodel.h>
+
+namespace {
+
+/**
+*   @brief  CanDevice on top of fake backend, started without I/O thread
+*/
+struct FakeDeviceFixture {
+    FakeDeviceFixture()
+        : backend(new FakeCanDevice)
+        , device(CanDeviceCtx(backend))
+    {
+        device.init("fake", "fake0");
+        // Simulation slots are private, they are normally reached through ComponentModel signals
+        QMetaObject::invokeMethod(&device, "startSimulation");
+    }
+
+    FakeCanDevice* backend; // owned by device
+    CanDevice device;
+};
+
+void CanDeviceSendFrame(Bench::State& state)
+{
+    FakeDeviceFixture fixture;
+    const auto frames = Bench::makeFrames(Bench::kBatchSize);
+    quint64 confirmed = 0;
+
+    QObject::connect(&fixture.device, &CanDevice::frameBatchSent,
+        [&confirmed](bool, const QVector<QCanBusFrame>& sent) { confirmed += sent.size(); });
+
+    state.run([&] {
+        for (const auto& frame : frames) {
+            fixture.device.sendFrame(frame);
+            fixture.backend->framesWritten(1);
+        }
+
+        return static_cast<quint64>(frames.size());
+    });
+}
+CDS_BENCHMARK(CanDeviceSendFrame);
+
+void CanDeviceSendFrames(Bench::State& state)
+{
+    FakeDeviceFixture fixture;
+    const auto frames = Bench::makeFrames(static_cast<int>(state.arg()));
+    quint64 confirmed = 0;
+
+    QObject::connect(&fixture.device, &CanDevice::frameBatchSent,
+        [&confirmed](bool, const QVector<QCanBusFrame>& sent) { confirmed += sent.size(); });
+
+    state.run([&] {
+        fixture.device.sendFrames(frames);
+        // Backend typically confirms the whole batch at once
+        fixture.backend->framesWritten(frames.size());
+
+        return static_cast<quint64>(frames.size());
+    });
+}
+CDS_BENCHMARK_ARGS(CanDeviceSendFrames, 1, Bench::kBatchSize, 1024);
+
+void CanDeviceFramesReceived(Bench::State& state)
+{
+    FakeDeviceFixture fixture;
+    const auto frames = Bench::makeFrames(static_cast<int>(state.arg()));
+    quint64 received = 0;
+
+    QObject::connect(&fixture.device, &CanDevice::frameBatchReceived,
+        [&received](const QVector<QCanBusFrame>& batch) { received += batch.size(); });
+
+    state.run([&] {
+        fixture.backend->receive(frames);
+
+        return static_cast<quint64>(frames.size());
+    });
+}
+CDS_BENCHMARK_ARGS(CanDeviceFramesReceived, 1, Bench::kBatchSize, 1024);
+
+void CanDeviceModelOutData(Bench::State& state)
+{
+    CanDeviceModel model;
+    const auto frames = Bench::makeFrames(static_cast<int>(state.arg()));
+    quint64 propagated = 0;
+
+    // Stands in for the flow scene, which pulls data of every updated port
+    QObject::connect(&model, &CanDeviceModel::dataUpdated, [&model, &propagated](QtNodes::PortIndex port) {
+        auto data = std::static_pointer_cast<CanDeviceDataOut>(model.outData(port));
+        propagated += data->records().size();
+    });
+
+    state.run([&] {
+        model.frameBatchReceived(frames);
+        // Queued frameOnQueue propagates everything received so far
+        QCoreApplication::processEvents();
+
+        return static_cast<quint64>(frames.size());
+    });
+}
+CDS_BENCHMARK_ARGS(CanDeviceModelOutData, 1, Bench::kBatchSize, 1024);
+
+} // namespace
@@ -0,0 +1,139 @@
+#include "benchdata.h"
+#include "benchmark.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <algorithm>
+#include <canrawview.h>
+#include <context.h>
+#include <frametablemodel.h>
+#include <gui/crvheadlessgui.h>
+#include <uniquefiltermodel.h>
+
+namespace {
+
+std::vector<double> makeTimes(const CanFrameBatch& frames)
+{
+    std::vector<double> times;
+
+    times.reserve(frames.size());
+    for (const auto& frame : frames) {
+        times.push_back(frame.timestamp / 1000000.0);
+    }
+
+    return times;
+}
+
+/**
+*   @brief  Fills table model with given number of rows in batches
+*/
+void fillModel(FrameTableModel& model, int rows)
+{
+    const auto batch = Bench::makeBatch(Bench::kBatchSize);
+    const auto times = makeTimes(batch);
+
+    for (int i = 0; i < rows; i += batch.size()) {
+        const int n = std::min(batch.size(), rows - i);
+
+        if (n == batch.size()) {
+            model.appendFrames(batch, times);
+        } else {
+            model.appendFrames(batch.mid(0, n), std::vector<double>(times.begin(), times.begin() + n));
+        }
+    }
+}
+
+/**
+*   @brief  Started CanRawView without display, filled up to its retention limit. Every batch is passed to table
+*           model immediately.
+*/
+struct ViewFixture {
+    explicit ViewFixture(int retention)
+        : view(CanRawViewCtx(new CRVHeadlessGui))
+    {
+        QJsonObject config{ { "displayRate", 0 }, { "retention", retention } };
+        const auto batch = Bench::makeBatch(Bench::kBatchSize);
+
+        view.setConfig(config);
+        view.startSimulation();
+
+        for (int i = 0; i < retention; i += batch.size()) {
+            view.frameBatchReceived(batch);
+        }
+    }
+
+    CanRawView view;
+};
+
+void CanRawViewFrameView(Bench::State& state)
+{
+    ViewFixture fixture(static_cast<int>(state.arg()));
+    const auto batch = Bench::makeBatch(Bench::kBatchSize);
+
+    // Steady state, oldest rows are evicted with every batch
+    state.run([&] {
+        fixture.view.frameBatchReceived(batch);
+
+        return static_cast<quint64>(batch.size());
+    });
+}
+CDS_BENCHMARK_ARGS(CanRawViewFrameView, 10000, 100000, 1000000);
+
+void UniqueFilterToggle(Bench::State& state)
+{
+    FrameTableModel model;
+    UniqueFilterModel filter;
+
+    filter.setSourceModel(&model);
+    fillModel(model, static_cast<int>(state.arg()));
+
+    // Every toggle runs filterAcceptsRow for all rows of source model
+    state.run([&] {
+        filter.toggleFilter();
+
+        return static_cast<quint64>(model.rowCount());
+    });
+}
+CDS_BENCHMARK_ARGS(UniqueFilterToggle, 10000, 100000, 1000000);
+
+void UniqueFilterAppend(Bench::State& state)
+{
+    FrameTableModel model;
+    UniqueFilterModel filter;
+    const auto batch = Bench::makeBatch(Bench::kBatchSize);
+    const auto times = makeTimes(batch);
+
+    model.setRetention(static_cast<int>(state.arg()));
+    filter.setSourceModel(&model);
+    filter.toggleFilter();
+    fillModel(model, static_cast<int>(state.arg()));
+
+    // Filter is updated only for appended rows and rows superseded by them
+    state.run([&] {
+        model.appendFrames(batch, times);
+
+        return static_cast<quint64>(batch.size());
+    });
+}
+CDS_BENCHMARK_ARGS(UniqueFilterAppend, 10000, 100000, 1000000);
+
+void CanRawViewSaveSettings(Bench::State& state)
+{
+    ViewFixture fixture(static_cast<int>(state.arg()));
+    QTemporaryDir dir;
+    const QString path = dir.filePath("view.cdst");
+
+    // Project save: JSON config plus side file job, which runs in worker thread in the application
+    state.run([&] {
+        const QJsonObject config = fixture.view.getConfig();
+        const ComponentSideData side = fixture.view.sideData();
+
+        if (config.isEmpty() || !side.write || !side.write(path)) {
+            return quint64{ 0 };
+        }
+
+        return static_cast<quint64>(state.arg());
+    });
+}
+CDS_BENCHMARK_ARGS(CanRawViewSaveSettings, 10000, 100000, 1000000);
+
+} // namespace
@@ -0,0 +1,80 @@
+#ifndef FAKECANDEVICE_H
+#define FAKECANDEVICE_H
+
+#include <candeviceinterface.h>
+
+/**
+*   @brief  Backend without I/O. Written frames are only counted, received frames are served from preloaded
+*           batch. Callbacks are fired by benchmark to mimic backend notifications.
+*/
+struct FakeCanDevice : public CanDeviceInterface {
+    void setFramesWrittenCbk(const framesWritten_t& cb) override
+    {
+        framesWritten = cb;
+    }
+
+    void setFramesReceivedCbk(const framesReceived_t& cb) override
+    {
+        framesReceived = cb;
+    }
+
+    void setErrorOccurredCbk(const errorOccurred_t& cb) override
+    {
+        errorOccurred = cb;
+    }
+
+    bool init(const QString&, const QString&) override
+    {
+        return true;
+    }
+
+    bool writeFrame(const QCanBusFrame&) override
+    {
+        ++written;
+        return true;
+    }
+
+    qint64 writeFrames(const QVector<QCanBusFrame>& frames) override
+    {
+        written += frames.size();
+        return frames.size();
+    }
+
+    bool connectDevice() override
+    {
+        return true;
+    }
+
+    void disconnectDevice() override
+    {
+    }
+
+    qint64 framesAvailable() override
+    {
+        return rx.size() - rxPos;
+    }
+
+    QCanBusFrame readFrame() override
+    {
+        return (rxPos < rx.size()) ? rx[rxPos++] : QCanBusFrame(QCanBusFrame::InvalidFrame);
+    }
+
+    /**
+    *   @brief  Makes frames available for reading and notifies device
+    */
+    void receive(const QVector<QCanBusFrame>& frames)
+    {
+        rx = frames;
+        rxPos = 0;
+        framesReceived();
+    }
+
+    framesWritten_t framesWritten;
+    framesReceived_t framesReceived;
+    errorOccurred_t errorOccurred;
+    QVector<QCanBusFrame> rx;
+    int rxPos{ 0 };
+    qint64 written{ 0 };
+};
+
+#endif // FAKECANDEVICE_H
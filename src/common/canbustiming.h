@@ -0,0 +1,51 @@
+#ifndef __CANBUSTIMING_H
+#define __CANBUSTIMING_H
+
+#include <QtCore/QtGlobal>
+#include <canframerecord.h>
+
+namespace CanBusTiming {
+// Worst case number of stuff bits inserted into bits subject to stuffing
+inline quint32 stuffBits(quint32 bits)
+{
+    return (bits - 1) / 4;
+}
+
+inline quint64 bitsToNs(quint64 bits, quint32 bitrate)
+{
+    return bitrate ? (bits * 1000000000ULL) / bitrate : 0;
+}
+} // namespace CanBusTiming
+
+/**
+*   @brief  Worst-case time a frame occupies the bus, including stuff bits and interframe space
+*   @param  rec frame
+*   @param  bitrate nominal (arbitration) bitrate in bit/s
+*   @param  dataBitrate data phase bitrate of CAN FD frames with bitrate switch in bit/s
+*   @return nanoseconds
+*/
+inline quint64 frameBusTimeNs(const CanFrameRecord& rec, quint32 bitrate, quint32 dataBitrate)
+{
+    using namespace CanBusTiming;
+
+    const bool extended = rec.hasFlag(CanFrameRecord::ExtendedId);
+    const quint32 dataBits = rec.hasFlag(CanFrameRecord::Remote) ? 0 : 8u * rec.length;
+
+    if (!rec.hasFlag(CanFrameRecord::FlexibleDataRate)) {
+        // SOF to CRC is subject to stuffing, CRC delimiter, ACK, EOF and interframe space are not
+        const quint32 stuffed = (extended ? 54 : 34) + dataBits;
+
+        return bitsToNs(stuffed + stuffBits(stuffed) + 13, bitrate);
+    }
+
+    // Arbitration phase: SOF to BRS, plus CRC delimiter to interframe space
+    const quint32 header = extended ? 36 : 17;
+    // Data phase: ESI, DLC, data, stuff count and CRC with its fixed stuff bits
+    const quint32 crc = (rec.length > 16) ? 21 : 17;
+    const quint32 data = 1 + 4 + dataBits + stuffBits(5 + dataBits) + 4 + crc + (crc + 4) / 4;
+
+    return bitsToNs(header + stuffBits(header) + 13, bitrate)
+        + bitsToNs(data, rec.hasFlag(CanFrameRecord::BitrateSwitch) ? dataBitrate : bitrate);
+}
+
+#endif /* !__CANBUSTIMING_H */
@@ -0,0 +1,142 @@
+#ifndef __CANFILTER_H
+#define __CANFILTER_H
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusDevice>
+#include <algorithm>
+
+/**
+*   @brief  List of acceptance filters. Frame is accepted if it matches any filter, empty list accepts all frames.
+*
+*   Filters follow QCanBusDevice::RawFilterKey semantics: frame matches if (frameId & mask) == (id & mask).
+*/
+typedef QList<QCanBusDevice::Filter> CanFilterList;
+
+/**
+*   @brief  Creates filter that matches id/mask pair regardless of frame type and format
+*/
+inline QCanBusDevice::Filter makeCanFilter(quint32 id, quint32 mask)
+{
+    QCanBusDevice::Filter filter;
+
+    filter.frameId = id;
+    filter.frameIdMask = mask;
+    filter.type = QCanBusFrame::InvalidFrame; // any frame type
+    filter.format = QCanBusDevice::Filter::MatchBaseAndExtendedFormat;
+
+    return filter;
+}
+
+/**
+*   @brief  Parses filters from config, e.g. [ { "id": 291, "mask": 2047, "format": "base" } ]
+*   @param  json array of filter objects. "format" is optional and one of base, extended, both.
+*   @return filter list
+*/
+inline CanFilterList canFiltersFromJson(const QJsonArray& json)
+{
+    CanFilterList filters;
+
+    for (const auto& item : json) {
+        const QJsonObject obj = item.toObject();
+        auto filter = makeCanFilter(static_cast<quint32>(obj["id"].toDouble()),
+            static_cast<quint32>(obj["mask"].toDouble(static_cast<double>(0x1fffffff))));
+        const QString format = obj["format"].toString();
+
+        if (format == "base") {
+            filter.format = QCanBusDevice::Filter::MatchBaseFormat;
+        } else if (format == "extended") {
+            filter.format = QCanBusDevice::Filter::MatchExtendedFormat;
+        }
+
+        filters.append(filter);
+    }
+
+    return filters;
+}
+
+/**
+*   @brief  Converts filters to config representation
+*/
+inline QJsonArray canFiltersToJson(const CanFilterList& filters)
+{
+    QJsonArray json;
+
+    for (const auto& filter : filters) {
+        QJsonObject obj;
+
+        obj["id"] = static_cast<double>(filter.frameId);
+        obj["mask"] = static_cast<double>(filter.frameIdMask);
+        if (filter.format == QCanBusDevice::Filter::MatchBaseFormat) {
+            obj["format"] = "base";
+        } else if (filter.format == QCanBusDevice::Filter::MatchExtendedFormat) {
+            obj["format"] = "extended";
+        } else {
+            obj["format"] = "both";
+        }
+
+        json.append(obj);
+    }
+
+    return json;
+}
+
+/**
+*   @brief  Union of filters declared by several consumers
+*   @param  consumers filter lists of consumers
+*   @return empty list (accept all) if any consumer accepts everything, otherwise all filters without duplicates
+*/
+inline CanFilterList mergeCanFilters(const QVector<CanFilterList>& consumers)
+{
+    CanFilterList merged;
+
+    for (const auto& filters : consumers) {
+        if (filters.isEmpty()) {
+            return {};
+        }
+
+        for (const auto& filter : filters) {
+            const bool known = std::any_of(merged.begin(), merged.end(), [&filter](const QCanBusDevice::Filter& f) {
+                return (f.frameId == filter.frameId) && (f.frameIdMask == filter.frameIdMask)
+                    && (f.type == filter.type) && (f.format == filter.format);
+            });
+
+            if (!known) {
+                merged.append(filter);
+            }
+        }
+    }
+
+    return merged;
+}
+
+/**
+*   @brief  Checks frame id against filters, type of frame is not checked
+*   @param  filters filter list
+*   @param  id frame id
+*   @param  extended true if frame uses extended format
+*   @return true if frame is accepted
+*/
+inline bool canFiltersAccept(const CanFilterList& filters, quint32 id, bool extended)
+{
+    if (filters.isEmpty()) {
+        return true;
+    }
+
+    for (const auto& filter : filters) {
+        if ((extended && (filter.format == QCanBusDevice::Filter::MatchBaseFormat))
+            || (!extended && (filter.format == QCanBusDevice::Filter::MatchExtendedFormat))) {
+            continue;
+        }
+
+        if ((id & filter.frameIdMask) == (filter.frameId & filter.frameIdMask)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif /* !__CANFILTER_H */
@@ -0,0 +1,254 @@
+#ifndef __CANFRAMERECORD_H
+#define __CANFRAMERECORD_H
+
+#include "simclock.h"
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+#include <QtSerialBus/QCanBusFrame>
+#include <cstring>
+#include <type_traits>
+
+/**
+*   @brief The enum class describing frame direction
+*/
+enum class Direction { RX, TX };
+
+/**
+*   @brief  Compact, trivially copyable representation of a single CAN / CAN FD frame
+*
+*   Payload is stored inline, so copying a record never touches the heap. Records are passed through the node
+*   graph in CanFrameBatch containers, which are implicitly shared (reference counted).
+*/
+struct CanFrameRecord {
+    static constexpr int kMaxPayload = 64;
+
+    enum Flags : quint8 {
+        ExtendedId = 0x01,
+        Remote = 0x02,
+        Error = 0x04,
+        FlexibleDataRate = 0x08,
+        BitrateSwitch = 0x10,
+        ErrorStateIndicator = 0x20,
+        Tx = 0x40,
+        TxFailed = 0x80,
+    };
+
+    quint64 timestamp; // microseconds since epoch, as provided by backend (see stampFrame)
+    quint32 id;
+    quint8 flags;
+    quint8 length; // payload length in bytes
+    quint16 channel; // 1-based channel frame was captured on, 0 if not tagged (see Merge)
+    quint8 payload[kMaxPayload];
+
+    Direction direction() const
+    {
+        return (flags & Tx) ? Direction::TX : Direction::RX;
+    }
+
+    bool hasFlag(Flags flag) const
+    {
+        return (flags & flag) != 0;
+    }
+};
+
+static_assert(std::is_trivially_copyable<CanFrameRecord>::value, "CanFrameRecord must be trivially copyable");
+
+/**
+*   @brief  Batch of frame records. QVector is implicitly shared, so batches are passed by handle, not copied.
+*/
+typedef QVector<CanFrameRecord> CanFrameBatch;
+
+Q_DECLARE_METATYPE(CanFrameRecord)
+
+/**
+*   @brief  Key of (id, format, direction) triple, e.g. for per-ID rows of views. Extended ids use 29 bits, bit 29
+*           tells them from standard ids of the same value, topmost bit is direction.
+*   @param  id frame id
+*   @param  flags CanFrameRecord::Flags, only ExtendedId and Tx are used
+*/
+inline quint32 canFrameKey(quint32 id, quint8 flags)
+{
+    return id | ((flags & CanFrameRecord::ExtendedId) ? 0x20000000u : 0u)
+        | ((flags & CanFrameRecord::Tx) ? 0x80000000u : 0u);
+}
+
+/**
+*   @brief  Payload length of CAN FD frame able to carry given number of bytes. FD lengths above 8 bytes come in
+*           DLC steps (12, 16, 20, 24, 32, 48, 64), shorter payload is padded by sender.
+*   @param  length requested payload length
+*   @return length in range 0-64
+*/
+inline int canFdLength(int length)
+{
+    static const int steps[] = { 8, 12, 16, 20, 24, 32, 48, 64 };
+
+    if (length <= 8) {
+        return qMax(length, 0);
+    }
+
+    for (int step : steps) {
+        if (length <= step) {
+            return step;
+        }
+    }
+
+    return CanFrameRecord::kMaxPayload;
+}
+
+/**
+*   @brief  Short description of frame format, e.g. "FD BRS", "EXT RTR". Empty for standard data frame.
+*   @param  flags CanFrameRecord::Flags
+*/
+inline QString canFrameFlagsText(quint8 flags)
+{
+    static const struct {
+        quint8 flag;
+        const char* text;
+    } names[] = { { CanFrameRecord::ExtendedId, "EXT" }, { CanFrameRecord::FlexibleDataRate, "FD" },
+        { CanFrameRecord::BitrateSwitch, "BRS" }, { CanFrameRecord::ErrorStateIndicator, "ESI" },
+        { CanFrameRecord::Remote, "RTR" }, { CanFrameRecord::Error, "ERR" } };
+    QString text;
+
+    for (const auto& name : names) {
+        if (flags & name.flag) {
+            if (!text.isEmpty()) {
+                text += QLatin1Char(' ');
+            }
+            text += QLatin1String(name.text);
+        }
+    }
+
+    return text;
+}
+
+/**
+*   @brief  Current time in the same clock domain as socketcan timestamps (wall clock, or virtual time of SimClock)
+*   @return microseconds since epoch
+*/
+inline quint64 canTimestampNow()
+{
+    return SimClock::nowUs();
+}
+
+/**
+*   @brief  Stamps frame with current time, unless backend already provided timestamp
+*   @param  frame frame to be stamped
+*/
+inline void stampFrame(QCanBusFrame& frame)
+{
+    const QCanBusFrame::TimeStamp ts = frame.timeStamp();
+
+    if ((ts.seconds() == 0) && (ts.microSeconds() == 0)) {
+        const quint64 now = canTimestampNow();
+        frame.setTimeStamp(
+            QCanBusFrame::TimeStamp(static_cast<qint64>(now / 1000000), static_cast<qint64>(now % 1000000)));
+    }
+}
+
+/**
+*   @brief  Converts Qt frame to compact record
+*   @param  frame source frame
+*   @param  dir frame direction
+*   @return record
+*/
+inline CanFrameRecord toCanFrameRecord(const QCanBusFrame& frame, Direction dir = Direction::RX)
+{
+    CanFrameRecord rec;
+    const QByteArray& data = frame.payload();
+    const QCanBusFrame::TimeStamp ts = frame.timeStamp();
+
+    rec.timestamp = static_cast<quint64>(ts.seconds()) * 1000000 + static_cast<quint64>(ts.microSeconds());
+    rec.id = frame.frameId();
+    rec.flags = 0;
+    rec.length = static_cast<quint8>(qMin(data.size(), static_cast<int>(CanFrameRecord::kMaxPayload)));
+    rec.channel = 0;
+    std::memcpy(rec.payload, data.constData(), rec.length);
+    std::memset(rec.payload + rec.length, 0, CanFrameRecord::kMaxPayload - rec.length);
+
+    if (frame.hasExtendedFrameFormat()) {
+        rec.flags |= CanFrameRecord::ExtendedId;
+    }
+    if (frame.frameType() == QCanBusFrame::RemoteRequestFrame) {
+        rec.flags |= CanFrameRecord::Remote;
+    } else if (frame.frameType() == QCanBusFrame::ErrorFrame) {
+        rec.flags |= CanFrameRecord::Error;
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    if (frame.hasFlexibleDataRateFormat()) {
+        rec.flags |= CanFrameRecord::FlexibleDataRate;
+    }
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    if (frame.hasBitrateSwitch()) {
+        rec.flags |= CanFrameRecord::BitrateSwitch;
+    }
+    if (frame.hasErrorStateIndicator()) {
+        rec.flags |= CanFrameRecord::ErrorStateIndicator;
+    }
+#endif
+    if (dir == Direction::TX) {
+        rec.flags |= CanFrameRecord::Tx;
+    }
+
+    return rec;
+}
+
+/**
+*   @brief  Converts compact record back to Qt frame
+*   @param  rec source record
+*   @return frame
+*/
+inline QCanBusFrame toQCanBusFrame(const CanFrameRecord& rec)
+{
+    QCanBusFrame frame(rec.id, QByteArray(reinterpret_cast<const char*>(rec.payload), rec.length));
+
+    frame.setExtendedFrameFormat(rec.hasFlag(CanFrameRecord::ExtendedId));
+    if (rec.hasFlag(CanFrameRecord::Remote)) {
+        frame.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    } else if (rec.hasFlag(CanFrameRecord::Error)) {
+        frame.setFrameType(QCanBusFrame::ErrorFrame);
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    frame.setFlexibleDataRateFormat(rec.hasFlag(CanFrameRecord::FlexibleDataRate));
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    frame.setBitrateSwitch(rec.hasFlag(CanFrameRecord::BitrateSwitch));
+    frame.setErrorStateIndicator(rec.hasFlag(CanFrameRecord::ErrorStateIndicator));
+#endif
+    frame.setTimeStamp(QCanBusFrame::TimeStamp(
+        static_cast<qint64>(rec.timestamp / 1000000), static_cast<qint64>(rec.timestamp % 1000000)));
+
+    return frame;
+}
+
+/**
+*   @brief  Converts batch of Qt frames to records
+*/
+inline CanFrameBatch toCanFrameBatch(const QVector<QCanBusFrame>& frames, Direction dir)
+{
+    CanFrameBatch batch;
+
+    batch.reserve(frames.size());
+    for (const auto& frame : frames) {
+        batch.append(toCanFrameRecord(frame, dir));
+    }
+
+    return batch;
+}
+
+/**
+*   @brief  Converts frames into existing batch. Storage of batch is reused unless it is shared with another
+*           handle, so converting into the same batch repeatedly does not allocate once it grew large enough.
+*/
+inline void toCanFrameBatch(const QVector<QCanBusFrame>& frames, Direction dir, CanFrameBatch& batch)
+{
+    // Keeps capacity of detached vector, shared one is detached here
+    batch.resize(0);
+    batch.reserve(frames.size());
+    for (const auto& frame : frames) {
+        batch.append(toCanFrameRecord(frame, dir));
+    }
+}
+
+#endif /* !__CANFRAMERECORD_H */
@@ -2,9 +2,37 @@
 #define __COMPONENTINTERFACE_H
 
 #include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <canfilter.h>
 #include <functional>
+#include <memory>
 
 class QWidget;
+class FrameIdDirectory;
+
+// Model JSON key referencing side file with bulky component state (see ComponentSideData)
+const char kSideDataKey[] = "sideData";
+// Model JSON key selecting thread component is executed in (see FlowPlan::setAffinity), main thread if missing
+const char kThreadAffinityKey[] = "thread";
+
+/**
+*   @brief  Bulky component state (e.g. view contents) stored in side file next to project file instead of inline
+*           in project JSON
+*/
+struct ComponentSideData {
+    QString suffix; // file name suffix, e.g. ".cdst"
+    // Writes snapshot of state to given path. Executed in worker thread, so it must not touch the component.
+    std::function<bool(const QString& path)> write;
+};
+
+/**
+*   @brief  Work GUI consumers may do per frame, lowered by LoadGovernor while main thread is overloaded
+*/
+enum class LoadLevel {
+    Normal,
+    Reduced, ///< lower refresh rate, sorting paused
+    Sampled ///< as Reduced, only a sample of frames is displayed
+};
 
 /**
 *   @brief  Interface to be implemented by every component
@@ -45,6 +73,15 @@ struct ComponentInterface {
         return nullptr;
     }
 
+    /**
+    *   @brief  Components may build main widget on first getMainWidget() call
+    *   @return true if main widget exists already, false if it was not requested yet or component has none
+    */
+    virtual bool mainWidgetCreated() const
+    {
+        return false;
+    }
+
     /**
     *   @brief  Callback, called when component requests dock/undock action
     */
@@ -60,6 +97,50 @@ struct ComponentInterface {
     {
         return true;
     }
+
+    /**
+    *   @brief  Frames component is interested in, used to set up acceptance filtering in CAN device
+    *   @return filter list, empty list if component needs all frames
+    */
+    virtual CanFilterList acceptanceFilters() const
+    {
+        return {};
+    }
+
+    /**
+    *   @brief  Passes directory of frame IDs of the bus component is fed from (see FrameIdDirectory). Set by
+    *           FlowPlan when all input of component comes from single CAN device, reset to nullptr otherwise.
+    *   @param  directory shared directory of the device, nullptr if there is none
+    */
+    virtual void setIdDirectory(const std::shared_ptr<FrameIdDirectory>&)
+    {
+    }
+
+    /**
+    *   @brief  Takes snapshot of bulky state to be saved in side file. Called in GUI thread during project save.
+    *   @return side data, empty write job if component has nothing to save
+    */
+    virtual ComponentSideData sideData() const
+    {
+        return {};
+    }
+
+    /**
+    *   @brief  Restores state from side file written by sideData() job. Called when project is loaded.
+    *   @param  path absolute path of side file
+    */
+    virtual void loadSideData(const QString&)
+    {
+    }
+
+    /**
+    *   @brief  Degrades displaying of frames while main thread is overloaded. Called in main thread. Components
+    *           storing, routing or counting frames ignore it, only what is displayed may be reduced.
+    *   @param  level new load level
+    */
+    virtual void setLoadLevel(LoadLevel)
+    {
+    }
 };
 
 #endif /* !__COMPONENTINTERFACE_H */
@@ -41,10 +41,15 @@ struct CanDeviceInterface;
 typedef Context<CanDeviceInterface> CanDeviceCtx;
 
 struct CRSGuiInterface;
-struct NLMFactoryInterface;
-typedef Context<CRSGuiInterface, NLMFactoryInterface> CanRawSenderCtx;
+typedef Context<CRSGuiInterface> CanRawSenderCtx;
 
 struct CRVGuiInterface;
 typedef Context<CRVGuiInterface> CanRawViewCtx;
 
+struct SPGuiInterface;
+typedef Context<SPGuiInterface> SignalPlotCtx;
+
+struct BSGuiInterface;
+typedef Context<BSGuiInterface> BusStatisticsCtx;
+
 #endif /* !__CONTEXT_H */
@@ -4,14 +4,11 @@
 #include <nodes/NodeDataModel>
 
 #include <QCanBusFrame>
+#include <QVector>
+#include <canframerecord.h>
 
 using QtNodes::NodeDataType;
 
-/**
-*   @brief The enum class describing frame direction
-*/
-enum class Direction { RX, TX };
-
 /**
 *   @brief The class describing data model used as input for CanDevice node
 */
@@ -19,9 +16,22 @@ class CanDeviceDataIn : public NodeData {
 public:
     CanDeviceDataIn(){};
     CanDeviceDataIn(QCanBusFrame const& frame)
-        : _frame(frame)
+        : _records{ toCanFrameRecord(frame, Direction::TX) }
     {
     }
+    CanDeviceDataIn(CanFrameRecord const& record)
+        : _records{ record }
+    {
+    }
+
+    /**
+    *   @brief  Creates data carrying whole batch of frames to be sent (no copy is made)
+    */
+    CanDeviceDataIn(CanFrameBatch const& records)
+        : _records(records)
+    {
+    }
+
     /**
     *   @brief  Used to get data type id and displayed text for ports
     *   @return NodeDataType of rawsender
@@ -32,14 +42,34 @@ public:
     }
     /**
     *   @brief  Used to get frame
+    *   @return first frame of the batch
     */
     QCanBusFrame frame() const
     {
-        return _frame;
+        return _records.isEmpty() ? QCanBusFrame() : toQCanBusFrame(_records.first());
+    };
+
+    /**
+    *   @brief  Used to get frame in compact form
+    *   @return first frame of the batch
+    */
+    const CanFrameRecord& record() const
+    {
+        static const CanFrameRecord empty{};
+
+        return _records.isEmpty() ? empty : _records.first();
+    };
+
+    /**
+    *   @brief  Used to get all frames carried by this data in compact form
+    */
+    const CanFrameBatch& records() const
+    {
+        return _records;
     };
 
 private:
-    QCanBusFrame _frame;
+    CanFrameBatch _records;
 };
 
 /**
@@ -49,11 +79,32 @@ class CanDeviceDataOut : public NodeData {
 public:
     CanDeviceDataOut(){};
     CanDeviceDataOut(QCanBusFrame const& frame, Direction const direction, bool status)
-        : _frame(frame)
+        : _records{ toCanFrameRecord(frame, direction) }
         , _direction(direction)
         , _status(status)
     {
     }
+
+    /**
+    *   @brief  Creates data carrying whole batch of frames sharing direction and status
+    */
+    CanDeviceDataOut(QVector<QCanBusFrame> const& frames, Direction const direction, bool status)
+        : _records(toCanFrameBatch(frames, direction))
+        , _direction(direction)
+        , _status(status)
+    {
+    }
+
+    /**
+    *   @brief  Creates data sharing already converted batch of records (no copy is made)
+    */
+    CanDeviceDataOut(CanFrameBatch const& records, Direction const direction, bool status)
+        : _records(records)
+        , _direction(direction)
+        , _status(status)
+    {
+    }
+
     /**
     *   @brief  Used to get data type id and displayed text for ports
     *   @return NodeDataType of rawview
@@ -65,10 +116,19 @@ public:
 
     /**
     *   @brief  Used to get frame
+    *   @return first frame of the batch
     */
     QCanBusFrame frame() const
     {
-        return _frame;
+        return _records.isEmpty() ? QCanBusFrame() : toQCanBusFrame(_records.first());
+    };
+
+    /**
+    *   @brief  Used to get all frames carried by this data in compact form
+    */
+    const CanFrameBatch& records() const
+    {
+        return _records;
     };
 
     /**
@@ -88,9 +148,9 @@ public:
     };
 
 private:
-    QCanBusFrame _frame;
-    Direction _direction;
-    bool _status; // used only for frameSent, ignored for frameReceived
+    CanFrameBatch _records;
+    Direction _direction{ Direction::RX };
+    bool _status{ false }; // used only for frameSent, ignored for frameReceived
 };
 
 #endif /* !__CANDEVICEDATA_H */
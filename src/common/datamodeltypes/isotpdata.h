@@ -0,0 +1,47 @@
+#ifndef ISOTPDATA_H
+#define ISOTPDATA_H
+
+#include <nodes/NodeDataModel>
+
+#include <isotppdu.h>
+
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+/**
+*   @brief The class describing data model used by IsoTp node ports carrying whole ISO-TP messages
+*/
+class IsoTpData : public NodeData {
+public:
+    IsoTpData(){};
+
+    /**
+    *   @brief  Creates data referring to PDU, data of received PDUs stays in reassembly buffer (no copy is made)
+    */
+    IsoTpData(IsoTpPdu const& pdu)
+        : _pdu(pdu)
+    {
+    }
+
+    /**
+    *   @brief  Used to get data type id and displayed text for ports
+    *   @return NodeDataType of ISO-TP messages
+    */
+    NodeDataType type() const override
+    {
+        return NodeDataType{ "isotp", "PDU" };
+    }
+
+    /**
+    *   @brief  Used to get message, valid only while data is being propagated, see IsoTpPdu
+    */
+    const IsoTpPdu& pdu() const
+    {
+        return _pdu;
+    };
+
+private:
+    IsoTpPdu _pdu{ 0, 0, nullptr, 0, 0 };
+};
+
+#endif // ISOTPDATA_H
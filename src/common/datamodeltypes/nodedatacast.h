@@ -0,0 +1,20 @@
+#ifndef __NODEDATACAST_H
+#define __NODEDATACAST_H
+
+#include <cassert>
+#include <memory>
+#include <nodes/NodeDataModel>
+
+/**
+*   @brief  Downcast of data delivered to model input port. Scene connects only ports of the same data type, so
+*           the type is known statically and is verified in debug builds only.
+*   @return data of port type, nullptr if nodeData is empty. Valid as long as nodeData is.
+*/
+template <typename T> T* nodeDataCast(const std::shared_ptr<QtNodes::NodeData>& nodeData)
+{
+    assert(!nodeData || (dynamic_cast<T*>(nodeData.get()) != nullptr));
+
+    return static_cast<T*>(nodeData.get());
+}
+
+#endif /* !__NODEDATACAST_H */
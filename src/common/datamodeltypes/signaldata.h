@@ -0,0 +1,57 @@
+#ifndef SIGNALDATA_H
+#define SIGNALDATA_H
+
+#include <nodes/NodeDataModel>
+
+#include <signalsample.h>
+
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+/**
+*   @brief The class describing data model used as output of SignalDecoder node
+*/
+class SignalData : public NodeData {
+public:
+    SignalData(){};
+
+    /**
+    *   @brief  Creates data sharing batch of samples and description of signals they refer to (no copy is made)
+    */
+    SignalData(SignalSampleBatch const& samples, SignalCatalogPtr const& catalog)
+        : _samples(samples)
+        , _catalog(catalog)
+    {
+    }
+
+    /**
+    *   @brief  Used to get data type id and displayed text for ports
+    *   @return NodeDataType of decoded signals
+    */
+    NodeDataType type() const override
+    {
+        return NodeDataType{ "signals", "Signals" };
+    }
+
+    /**
+    *   @brief  Used to get decoded values
+    */
+    const SignalSampleBatch& samples() const
+    {
+        return _samples;
+    };
+
+    /**
+    *   @brief  Used to get signals, indexed by SignalSample::signal. May be nullptr for empty data.
+    */
+    const SignalCatalogPtr& catalog() const
+    {
+        return _catalog;
+    };
+
+private:
+    SignalSampleBatch _samples;
+    SignalCatalogPtr _catalog;
+};
+
+#endif // SIGNALDATA_H
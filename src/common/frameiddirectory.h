@@ -0,0 +1,324 @@
+#ifndef __FRAMEIDDIRECTORY_H
+#define __FRAMEIDDIRECTORY_H
+
+#include "canframerecord.h"
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+*   @brief  Dense directory of frame IDs seen on one bus, shared by CAN device and its consumers
+*
+*   Every (id, format) pair is interned once and gets small integer handle, handles are assigned in order of first
+*   appearance and stay valid for lifetime of directory. Entry holds display string of ID, name of DBC message
+*   carrying it, last payload and frame counters, so consumers index per-ID data by handle instead of hashing IDs
+*   and formatting strings per frame.
+*
+*   Handle of standard ID is read from direct table, extended IDs are found in open addressing table, both without
+*   locking. Interning takes lock, entries are never moved nor removed. Payload and counters are updated by one
+*   thread (dispatcher of the device, see FlowPlan) and may be read from any thread.
+*/
+class FrameIdDirectory {
+public:
+    typedef quint32 Handle;
+
+    static constexpr Handle kInvalidHandle = 0xffffffffU;
+    static constexpr int kChunkEntries = 256;
+    static constexpr int kMaxChunks = 32;
+    // IDs beyond the limit are not interned, consumers fall back to their own lookup
+    static constexpr Handle kMaxEntries = kChunkEntries * kMaxChunks;
+
+    FrameIdDirectory()
+    {
+        for (auto& slot : _standard) {
+            slot.store(kInvalidHandle, std::memory_order_relaxed);
+        }
+        for (auto& slot : _extended) {
+            slot.store(kEmptySlot, std::memory_order_relaxed);
+        }
+        for (auto& chunk : _chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~FrameIdDirectory()
+    {
+        for (auto& chunk : _chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    FrameIdDirectory(const FrameIdDirectory&) = delete;
+    FrameIdDirectory& operator=(const FrameIdDirectory&) = delete;
+
+    /**
+    *   @return handle of ID, kInvalidHandle if ID was not interned
+    */
+    Handle find(quint32 id, bool extended) const
+    {
+        if (!extended) {
+            return (id < kStandardIds) ? _standard[id].load(std::memory_order_acquire) : kInvalidHandle;
+        }
+
+        for (quint32 slot = hash(id);; slot = (slot + 1) & (kExtendedSlots - 1)) {
+            const quint64 value = _extended[slot].load(std::memory_order_acquire);
+
+            if (value == kEmptySlot) {
+                return kInvalidHandle;
+            }
+            if (static_cast<quint32>(value >> 32) == id) {
+                return static_cast<Handle>(value);
+            }
+        }
+    }
+
+    Handle find(const CanFrameRecord& rec) const
+    {
+        return find(rec.id, rec.hasFlag(CanFrameRecord::ExtendedId));
+    }
+
+    /**
+    *   @brief  Returns handle of ID, creating entry if ID is new. Thread safe.
+    *   @return handle, kInvalidHandle if directory is full or standard ID is out of 11-bit range (e.g. frame of
+    *           bridge peer or imported trace that lost its format flag)
+    */
+    Handle intern(quint32 id, bool extended)
+    {
+        if (!extended && (id >= kStandardIds)) {
+            return kInvalidHandle;
+        }
+
+        const Handle known = find(id, extended);
+
+        if (known != kInvalidHandle) {
+            return known;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Other thread may have been faster
+        const Handle existing = find(id, extended);
+        const Handle handle = _size.load(std::memory_order_relaxed);
+        if ((existing != kInvalidHandle) || (handle == kMaxEntries)) {
+            return existing;
+        }
+
+        Entry* chunk = _chunks[handle / kChunkEntries].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Entry[kChunkEntries];
+            _chunks[handle / kChunkEntries].store(chunk, std::memory_order_release);
+        }
+
+        // Entry is complete before handle is published
+        Entry& entry = chunk[handle % kChunkEntries];
+        entry.id = id;
+        entry.extended = extended;
+        entry.idText = QStringLiteral("0x") + QString::number(id, 16);
+        _size.store(handle + 1, std::memory_order_release);
+
+        if (!extended) {
+            _standard[id].store(handle, std::memory_order_release);
+        } else {
+            quint32 slot = hash(id);
+            while (_extended[slot].load(std::memory_order_relaxed) != kEmptySlot) {
+                slot = (slot + 1) & (kExtendedSlots - 1);
+            }
+            _extended[slot].store((static_cast<quint64>(id) << 32) | handle, std::memory_order_release);
+        }
+
+        return handle;
+    }
+
+    Handle intern(const CanFrameRecord& rec)
+    {
+        return intern(rec.id, rec.hasFlag(CanFrameRecord::ExtendedId));
+    }
+
+    /**
+    *   @return number of interned IDs, handles are lower than that
+    */
+    std::size_t size() const
+    {
+        return _size.load(std::memory_order_acquire);
+    }
+
+    quint32 frameId(Handle handle) const
+    {
+        return entry(handle).id;
+    }
+
+    bool isExtended(Handle handle) const
+    {
+        return entry(handle).extended;
+    }
+
+    /**
+    *   @return ID formatted for display, e.g. "0x1a3". String is created once and shared.
+    */
+    const QString& idText(Handle handle) const
+    {
+        return entry(handle).idText;
+    }
+
+    /**
+    *   @brief  Names ID after DBC message, e.g. by signal decoder fed by the bus. Thread safe.
+    */
+    void setMessageName(Handle handle, const QString& name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        entry(handle).messageName = name;
+    }
+
+    /**
+    *   @return name of DBC message, empty if no decoder named the ID. Thread safe.
+    */
+    QString messageName(Handle handle) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        return entry(handle).messageName;
+    }
+
+    /**
+    *   @brief  Interns IDs of frames and updates their payload and counters. Called by one thread at a time.
+    */
+    void update(const CanFrameBatch& frames)
+    {
+        for (const auto& rec : frames) {
+            const Handle handle = intern(rec);
+
+            if (handle == kInvalidHandle) {
+                continue;
+            }
+
+            Entry& e = entry(handle);
+            auto& counter = (rec.flags & CanFrameRecord::Tx) ? e.txFrames : e.rxFrames;
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            // Failed transmissions never appeared on the bus
+            if (rec.flags & CanFrameRecord::TxFailed) {
+                continue;
+            }
+
+            // Sequence lock, readers retry while it is odd or changed meanwhile
+            const quint32 seq = e.seq.load(std::memory_order_relaxed);
+            e.seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (int w = 0; w < kPayloadWords; ++w) {
+                quint64 word = 0;
+                std::memcpy(&word, rec.payload + w * sizeof(word), sizeof(word));
+                e.payload[w].store(word, std::memory_order_relaxed);
+            }
+            e.length.store(rec.length, std::memory_order_relaxed);
+            e.timestamp.store(rec.timestamp, std::memory_order_relaxed);
+            e.seq.store(seq + 2, std::memory_order_release);
+        }
+    }
+
+    /**
+    *   @return number of frames of ID received or sent since last reset
+    */
+    quint64 frameCount(Handle handle, Direction dir) const
+    {
+        const Entry& e = entry(handle);
+
+        return ((dir == Direction::TX) ? e.txFrames : e.rxFrames).load(std::memory_order_relaxed);
+    }
+
+    /**
+    *   @brief  Copies the last payload that appeared on the bus
+    *   @param  payload output of CanFrameRecord::kMaxPayload bytes
+    *   @param  timestamp set to timestamp of the frame, 0 if ID did not appear since last reset
+    *   @return payload length
+    */
+    int lastPayload(Handle handle, quint8* payload, quint64& timestamp) const
+    {
+        const Entry& e = entry(handle);
+        quint32 seq;
+        int length;
+
+        do {
+            seq = e.seq.load(std::memory_order_acquire);
+            for (int w = 0; w < kPayloadWords; ++w) {
+                const quint64 word = e.payload[w].load(std::memory_order_relaxed);
+                std::memcpy(payload + w * sizeof(word), &word, sizeof(word));
+            }
+            length = e.length.load(std::memory_order_relaxed);
+            timestamp = e.timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || (e.seq.load(std::memory_order_relaxed) != seq));
+
+        return length;
+    }
+
+    /**
+    *   @brief  Clears payloads and counters, e.g. when simulation starts. Handles and names are kept.
+    *           Called by the updating thread only, concurrent update() would leave entries locked.
+    */
+    void resetSlots()
+    {
+        const std::size_t count = size();
+
+        for (Handle handle = 0; handle < count; ++handle) {
+            Entry& e = entry(handle);
+            const quint32 seq = e.seq.load(std::memory_order_relaxed);
+
+            e.seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            e.length.store(0, std::memory_order_relaxed);
+            e.timestamp.store(0, std::memory_order_relaxed);
+            e.rxFrames.store(0, std::memory_order_relaxed);
+            e.txFrames.store(0, std::memory_order_relaxed);
+            e.seq.store(seq + 2, std::memory_order_release);
+        }
+    }
+
+private:
+    static constexpr quint32 kStandardIds = 0x800;
+    // Twice the entry limit, so that probing always ends at empty slot
+    static constexpr int kExtendedBits = 14;
+    static constexpr quint32 kExtendedSlots = 1U << kExtendedBits;
+    static_assert(kExtendedSlots >= 2 * kMaxEntries, "Extended ID table must stay half empty");
+    static constexpr quint64 kEmptySlot = ~0ULL;
+    static constexpr int kPayloadWords = CanFrameRecord::kMaxPayload / 8;
+
+    struct Entry {
+        quint32 id{ 0 };
+        bool extended{ false };
+        QString idText;
+        QString messageName; // guarded by directory mutex
+        std::atomic<quint32> seq{ 0 };
+        std::atomic<int> length{ 0 };
+        std::atomic<quint64> timestamp{ 0 };
+        std::atomic<quint64> payload[kPayloadWords] = {};
+        std::atomic<quint64> rxFrames{ 0 };
+        std::atomic<quint64> txFrames{ 0 };
+    };
+
+    static quint32 hash(quint32 id)
+    {
+        // Fibonacci hashing, the top bits are the well mixed ones
+        return (id * 2654435761U) >> (32 - kExtendedBits);
+    }
+
+    Entry& entry(Handle handle) const
+    {
+        return _chunks[handle / kChunkEntries].load(std::memory_order_acquire)[handle % kChunkEntries];
+    }
+
+    mutable std::mutex _mutex;
+    std::atomic<Handle> _size{ 0 };
+    std::array<std::atomic<Handle>, kStandardIds> _standard;
+    std::array<std::atomic<quint64>, kExtendedSlots> _extended;
+    std::array<std::atomic<Entry*>, kMaxChunks> _chunks;
+};
+
+typedef std::shared_ptr<FrameIdDirectory> FrameIdDirectoryPtr;
+
+#endif /* !__FRAMEIDDIRECTORY_H */
@@ -0,0 +1,349 @@
+#ifndef __INSTRUMENTATION_H
+#define __INSTRUMENTATION_H
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+*   @brief  Process wide counters and histograms of the frame path, used to find out where frames are lost or
+*           delayed
+*
+*   Every thread updates its own block, so updates are plain relaxed load/store pairs without locked
+*   instructions or shared cache lines. Blocks are registered on first use and never freed, readers take
+*   snapshot by summing all blocks. Snapshots are monotonic, subtract two of them to get activity in between.
+*/
+namespace Instrumentation {
+
+enum class Counter {
+    RxFrames, ///< frames read from backend
+    RxOverflows, ///< received frames dropped because I/O thread queue was full
+    TxRequested, ///< frames passed to CanDevice for sending
+    TxConfirmed, ///< frames confirmed by backend
+    TxFailed, ///< frames rejected by backend, not fitting into send queue or failed with WriteError
+    TxQueueFull, ///< subset of TxFailed, frames not fitting into send queue
+    DeviceErrors, ///< errors reported by backend
+    ViewFrames, ///< frames reaching CanRawView
+    PoolAllocations, ///< frame path objects allocated from per-thread pools (see Pool::allocate)
+    HeapAllocations, ///< frame path objects that had to be allocated from heap
+    GatewayFrames, ///< frames routed by Gateway to target device
+    TxStale, ///< subset of TxFailed, frames dropped from transmit queue after maxAge of their class
+    Count
+};
+
+enum class Histogram {
+    ReadToViewUs, ///< time from frame reception to CanRawView in microseconds
+    SendQueueDepth, ///< frames waiting for backend confirmation after each write
+    GatewayUs, ///< time from frame reception to write to target device by Gateway in microseconds
+    TxQueueResidencyUs, ///< time frames spent in transmit queue of CanDevice before handover to backend
+    TxHandoffUs, ///< time from CanDevice::sendFrames to handover to backend in microseconds
+    TxConfirmUs, ///< time from handover to backend to its confirmation in microseconds
+    TxLatencyUs, ///< time from CanDevice::sendFrames to backend confirmation in microseconds
+    ReleaseLatenessUs, ///< time from planned release of scheduled or replayed frame to its release in microseconds
+    Count
+};
+
+constexpr int kCounters = static_cast<int>(Counter::Count);
+constexpr int kHistograms = static_cast<int>(Histogram::Count);
+// Bin 0 holds zeros, bin k > 0 holds [2^(k-1), 2^k), the last bin everything above
+constexpr int kHistogramBins = 32;
+
+inline int histogramBin(quint64 value)
+{
+    int bin = 0;
+
+    while ((value != 0) && (bin < kHistogramBins - 1)) {
+        value >>= 1;
+        ++bin;
+    }
+
+    return bin;
+}
+
+struct HistogramSnapshot {
+    std::array<quint64, kHistogramBins> bins{};
+    quint64 count{ 0 };
+    quint64 sum{ 0 };
+    quint64 max{ 0 };
+
+    double mean() const
+    {
+        return count ? static_cast<double>(sum) / count : 0.0;
+    }
+
+    /**
+    *   @brief  Adds value. For histograms owned by single thread, process wide ones are updated with record().
+    */
+    void add(quint64 value)
+    {
+        bins[histogramBin(value)] += 1;
+        count += 1;
+        sum += value;
+        max = std::max(max, value);
+    }
+
+    /**
+    *   @brief  Adds all values of other histogram
+    */
+    void merge(const HistogramSnapshot& other)
+    {
+        for (int bin = 0; bin < kHistogramBins; ++bin) {
+            bins[bin] += other.bins[bin];
+        }
+        count += other.count;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+
+    /**
+    *   @param  fraction percentile as fraction, e.g. 0.99
+    *   @return upper bound of bin containing the percentile, 0 if histogram is empty
+    */
+    quint64 percentile(double fraction) const
+    {
+        // Bins are summed independently from count in snapshot, so count may be slightly off
+        quint64 total = 0;
+        for (auto n : bins) {
+            total += n;
+        }
+
+        const auto target = static_cast<quint64>(fraction * total);
+        quint64 seen = 0;
+
+        for (int bin = 0; bin < kHistogramBins; ++bin) {
+            seen += bins[bin];
+
+            if ((seen > target) || ((seen == total) && (total != 0))) {
+                return (bin == 0) ? 0 : std::min<quint64>(1ULL << bin, max);
+            }
+        }
+
+        return 0;
+    }
+};
+
+struct Snapshot {
+    std::array<quint64, kCounters> counters{};
+    std::array<HistogramSnapshot, kHistograms> histograms{};
+
+    quint64 counter(Counter c) const
+    {
+        return counters[static_cast<int>(c)];
+    }
+
+    const HistogramSnapshot& histogram(Histogram h) const
+    {
+        return histograms[static_cast<int>(h)];
+    }
+
+    /**
+    *   @brief  Activity since base snapshot. Maximum cannot be subtracted, it is the maximum since start.
+    */
+    Snapshot operator-(const Snapshot& base) const
+    {
+        Snapshot result = *this;
+
+        for (int i = 0; i < kCounters; ++i) {
+            result.counters[i] -= base.counters[i];
+        }
+
+        for (int i = 0; i < kHistograms; ++i) {
+            auto& h = result.histograms[i];
+            const auto& b = base.histograms[i];
+
+            for (int bin = 0; bin < kHistogramBins; ++bin) {
+                h.bins[bin] -= b.bins[bin];
+            }
+            h.count -= b.count;
+            h.sum -= b.sum;
+        }
+
+        return result;
+    }
+};
+
+namespace detail {
+    struct HistogramBlock {
+        std::atomic<quint64> bins[kHistogramBins];
+        std::atomic<quint64> count;
+        std::atomic<quint64> sum;
+        std::atomic<quint64> max;
+    };
+
+    struct ThreadBlock {
+        ThreadBlock()
+        {
+            for (auto& c : counters) {
+                c.store(0, std::memory_order_relaxed);
+            }
+
+            for (auto& h : histograms) {
+                for (auto& bin : h.bins) {
+                    bin.store(0, std::memory_order_relaxed);
+                }
+                h.count.store(0, std::memory_order_relaxed);
+                h.sum.store(0, std::memory_order_relaxed);
+                h.max.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<quint64> counters[kCounters];
+        HistogramBlock histograms[kHistograms];
+        // Keeps block of other thread allocated next to this one off the last cache line
+        char padding[64];
+    };
+
+    class Registry {
+    public:
+        static Registry& instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        ThreadBlock* create()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _blocks.push_back(std::make_unique<ThreadBlock>());
+
+            return _blocks.back().get();
+        }
+
+        template <typename F> void forEach(F&& fn)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            for (const auto& block : _blocks) {
+                fn(*block);
+            }
+        }
+
+    private:
+        std::mutex _mutex;
+        std::vector<std::unique_ptr<ThreadBlock>> _blocks;
+    };
+
+    inline ThreadBlock& local()
+    {
+        thread_local ThreadBlock* block = Registry::instance().create();
+        return *block;
+    }
+
+    // Only the owning thread writes to a block, so read-modify-write does not have to be atomic
+    inline void bump(std::atomic<quint64>& value, quint64 n)
+    {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+} // namespace detail
+
+/**
+*   @brief  Increments counter of calling thread
+*/
+inline void add(Counter counter, quint64 n = 1)
+{
+    detail::bump(detail::local().counters[static_cast<int>(counter)], n);
+}
+
+/**
+*   @brief  Adds value to histogram of calling thread
+*/
+inline void record(Histogram histogram, quint64 value)
+{
+    auto& h = detail::local().histograms[static_cast<int>(histogram)];
+
+    detail::bump(h.bins[histogramBin(value)], 1);
+    detail::bump(h.count, 1);
+    detail::bump(h.sum, value);
+    if (value > h.max.load(std::memory_order_relaxed)) {
+        h.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+/**
+*   @brief  Sums blocks of all threads. Safe to call from any thread.
+*/
+inline Snapshot snapshot()
+{
+    Snapshot result;
+
+    detail::Registry::instance().forEach([&result](const detail::ThreadBlock& block) {
+        for (int i = 0; i < kCounters; ++i) {
+            result.counters[i] += block.counters[i].load(std::memory_order_relaxed);
+        }
+
+        for (int i = 0; i < kHistograms; ++i) {
+            auto& h = result.histograms[i];
+            const auto& b = block.histograms[i];
+
+            for (int bin = 0; bin < kHistogramBins; ++bin) {
+                h.bins[bin] += b.bins[bin].load(std::memory_order_relaxed);
+            }
+            h.count += b.count.load(std::memory_order_relaxed);
+            h.sum += b.sum.load(std::memory_order_relaxed);
+            h.max = std::max(h.max, b.max.load(std::memory_order_relaxed));
+        }
+    });
+
+    return result;
+}
+
+inline const char* name(Counter counter)
+{
+    static const char* const names[kCounters] = { "rx frames", "rx overflows", "tx requested", "tx confirmed",
+        "tx failed", "tx queue full", "device errors", "view frames", "pool allocations", "heap allocations",
+        "gateway frames", "tx stale" };
+
+    return names[static_cast<int>(counter)];
+}
+
+inline const char* name(Histogram histogram)
+{
+    static const char* const names[kHistograms] = { "read to view [us]", "send queue depth", "gateway rx to tx [us]",
+        "tx queue residency [us]", "tx request to handoff [us]", "tx handoff to confirm [us]",
+        "tx request to confirm [us]", "release lateness [us]" };
+
+    return names[static_cast<int>(histogram)];
+}
+
+/**
+*   @brief  Formats snapshot, one counter or histogram per line
+*   @param  snapshot counters to be formatted
+*   @param  seconds time span of snapshot, counters are also shown per second if greater than 0
+*/
+inline QString toString(const Snapshot& snapshot, double seconds = 0.0)
+{
+    QString str;
+
+    for (int i = 0; i < kCounters; ++i) {
+        const auto counter = static_cast<Counter>(i);
+
+        str += QString("%1: %2").arg(name(counter)).arg(snapshot.counter(counter));
+        if (seconds > 0.0) {
+            str += QString(" (%1/s)").arg(snapshot.counter(counter) / seconds, 0, 'f', 0);
+        }
+        str += '\n';
+    }
+
+    for (int i = 0; i < kHistograms; ++i) {
+        const auto& h = snapshot.histograms[i];
+
+        str += QString("%1: mean %2, p50 %3, p99 %4, max %5\n")
+                   .arg(name(static_cast<Histogram>(i)))
+                   .arg(h.mean(), 0, 'f', 1)
+                   .arg(h.percentile(0.5))
+                   .arg(h.percentile(0.99))
+                   .arg(h.max);
+    }
+
+    return str.trimmed();
+}
+
+} // namespace Instrumentation
+
+#endif /* !__INSTRUMENTATION_H */
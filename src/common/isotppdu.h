@@ -0,0 +1,38 @@
+#ifndef __ISOTPPDU_H
+#define __ISOTPPDU_H
+
+#include <QtCore/QMetaType>
+#include <QtCore/QtGlobal>
+
+/**
+*   @brief  ISO 15765-2 (ISO-TP) message, i.e. diagnostic PDU carried by one or more CAN frames
+*
+*   Received PDUs are views into reassembly buffer of the channel, so no copy is made when transfer completes.
+*   Data stays valid until the next single or first frame is received on the same channel, which is never before
+*   the handler returns when it is called directly (signal connected with direct connection, FlowPlan edge).
+*   Consumers keeping PDU for later have to copy the data.
+*/
+struct IsoTpPdu {
+    quint32 rxId; // CAN id PDU was received on (or response is expected on)
+    quint32 txId; // CAN id PDU is sent with, selects channel when PDU is sent
+    const quint8* data;
+    quint32 length;
+    quint64 timestamp; // microseconds, capture time of the last frame of received PDU
+};
+
+Q_DECLARE_METATYPE(IsoTpPdu)
+
+/**
+*   @brief  Reason of aborted ISO-TP transfer
+*/
+enum class IsoTpError {
+    Busy, // PDU requested while previous one was still being sent
+    Overflow, // PDU exceeds reassembly buffer (locally or flow control overflow from peer)
+    WrongSequence, // consecutive frame with unexpected sequence number
+    UnexpectedFrame, // single or first frame received in the middle of reception
+    FlowControlTimeout, // N_Bs, flow control not received in time
+    ConsecutiveFrameTimeout, // N_Cr, consecutive frame not received in time
+    InvalidFrame // malformed protocol control information
+};
+
+#endif /* !__ISOTPPDU_H */
@@ -1,3 +1,7 @@
+#ifndef __LOG_H
+#define __LOG_H
+
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -6,21 +10,88 @@
 
 extern std::shared_ptr<spdlog::logger> kDefaultLogger;
 
-#define __FILENAME__ (std::strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
+#define CDS_LOG_LEVEL_DEBUG 0
+#define CDS_LOG_LEVEL_INFO 1
+#define CDS_LOG_LEVEL_WARN 2
+#define CDS_LOG_LEVEL_ERROR 3
 
-#define cds_debug(fmt, ...)                                                                                            \
-    do {                                                                                                               \
-        kDefaultLogger->debug("[{}():{}@{}] " fmt, __FUNCTION__, __FILENAME__, __LINE__, ##__VA_ARGS__);               \
-    } while (0)
-#define cds_warn(fmt, ...)                                                                                             \
-    do {                                                                                                               \
-        kDefaultLogger->warn("[{}():{}@{}] " fmt, __FUNCTION__, __FILENAME__, __LINE__, ##__VA_ARGS__);                \
-    } while (0)
-#define cds_error(fmt, ...)                                                                                            \
+// Calls below minimal level are compiled out. Release builds keep info and above unless set explicitly.
+#ifndef CDS_LOG_LEVEL
+#ifdef NDEBUG
+#define CDS_LOG_LEVEL CDS_LOG_LEVEL_INFO
+#else
+#define CDS_LOG_LEVEL CDS_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+/**
+*   @brief  File name part of path, evaluated at compile time when used in cds_* macros
+*/
+constexpr const char* cdsBasename(const char* path)
+{
+    const char* name = path;
+
+    for (const char* p = path; *p != '\0'; ++p) {
+        if ((*p == '/') || (*p == '\\')) {
+            name = p + 1;
+        }
+    }
+
+    return name;
+}
+
+// Power of 2, required by spdlog async queue
+constexpr std::size_t kAsyncLogQueueSize = 8192;
+
+/**
+*   @brief  Creates logger writing from background thread. Messages are only copied to lock-free queue by caller,
+*           if the queue is full they are discarded, so logging never blocks frame processing. Output is flushed
+*           periodically by the background thread.
+*   @param  name logger name
+*   @return logger, other loggers created afterwards stay synchronous
+*/
+inline std::shared_ptr<spdlog::logger> createAsyncLogger(const std::string& name)
+{
+    spdlog::set_async_mode(kAsyncLogQueueSize, spdlog::async_overflow_policy::discard_log_msg, nullptr,
+        std::chrono::milliseconds(500));
+    auto logger = spdlog::stdout_color_mt(name);
+    spdlog::set_sync_mode();
+
+    return logger;
+}
+
+#define cds_log_(level, fmt, ...)                                                                                      \
     do {                                                                                                               \
-        kDefaultLogger->error("[{}():{}@{}] " fmt, __FUNCTION__, __FILENAME__, __LINE__, ##__VA_ARGS__);               \
+        constexpr const char* cdsFile_ = cdsBasename(__FILE__);                                                       \
+        kDefaultLogger->level("[{}():{}@{}] " fmt, __FUNCTION__, cdsFile_, __LINE__, ##__VA_ARGS__);                  \
     } while (0)
-#define cds_info(fmt, ...)                                                                                             \
+
+// Disabled calls are still compiled, so arguments used only for logging do not trigger unused warnings
+#define cds_log_off_(level, fmt, ...)                                                                                  \
     do {                                                                                                               \
-        kDefaultLogger->info("[{}():{}@{}] " fmt, __FUNCTION__, __FILENAME__, __LINE__, ##__VA_ARGS__);                \
+        if (false) {                                                                                                   \
+            kDefaultLogger->level(fmt, ##__VA_ARGS__);                                                                 \
+        }                                                                                                              \
     } while (0)
+
+#if CDS_LOG_LEVEL <= CDS_LOG_LEVEL_DEBUG
+#define cds_debug(fmt, ...) cds_log_(debug, fmt, ##__VA_ARGS__)
+#else
+#define cds_debug(fmt, ...) cds_log_off_(debug, fmt, ##__VA_ARGS__)
+#endif
+
+#if CDS_LOG_LEVEL <= CDS_LOG_LEVEL_INFO
+#define cds_info(fmt, ...) cds_log_(info, fmt, ##__VA_ARGS__)
+#else
+#define cds_info(fmt, ...) cds_log_off_(info, fmt, ##__VA_ARGS__)
+#endif
+
+#if CDS_LOG_LEVEL <= CDS_LOG_LEVEL_WARN
+#define cds_warn(fmt, ...) cds_log_(warn, fmt, ##__VA_ARGS__)
+#else
+#define cds_warn(fmt, ...) cds_log_off_(warn, fmt, ##__VA_ARGS__)
+#endif
+
+#define cds_error(fmt, ...) cds_log_(error, fmt, ##__VA_ARGS__)
+
+#endif /* !__LOG_H */
@@ -2,12 +2,13 @@
 #ifndef MODELVISITOR_H
 #define MODELVISITOR_H
 
+#include <type_traits> // is_base_of
+#include <typeinfo> // bad_cast
 #include <utility> // move, forward
 
 #include <nodes/NodeDataModel>
 
 #include "visitor.h" // Visitor
-#include "visitablewith.h" // VisitableWith
 
 
 class CanRawViewModel;
@@ -15,7 +16,8 @@ class CanRawSenderModel;
 class CanDeviceModel;
 
 /**
- * Example usage with @c VisitableWith<CanNodeDataModelVisitor>:
+ * Example usage, visitable models need no common base other than
+ * NodeDataModel:
  *
  * @code
  *  auto m = node.nodeDataModel();
@@ -43,19 +45,28 @@ struct CanNodeDataModelVisitor
 };
 
 
-/** @throws bad_cast if object under @c m is not visitable with @c v. */
-inline void apply_model_visitor(QtNodes::NodeDataModel& m, CanNodeDataModelVisitor v)
+/**
+ * Dispatches through jump table of CanNodeDataModelVisitor::tags, model
+ * types must be complete where this is called. Template, so that it is
+ * instantiated only there.
+ *
+ * @throws bad_cast if object under @c m is not visitable with @c v.
+ */
+template<class Model>
+inline void apply_model_visitor(Model& m, CanNodeDataModelVisitor v)
 {
-    // NOTE: Cannot use static_cast since NodeDataModel and VisitableWith
-    //       are not in direct inheritance relation, i.e. only type derived
-    //       from NodeDataModel derives from VisitableWith.
+    static_assert(std::is_base_of<QtNodes::NodeDataModel, Model>::value
+                , "Node data model expected");
 
-    dynamic_cast<VisitableWith<CanNodeDataModelVisitor>&>(m).visit(v);  // throws!
+    if (! v.dispatch(m))
+    {
+        throw std::bad_cast{};
+    }
 }
 
 /** @throws bad_cast if object under @c m is not visitable with @c v. */
-template<class... Actions>
-inline void apply_model_visitor(QtNodes::NodeDataModel& m, Actions&&... actions)
+template<class Model, class... Actions>
+inline void apply_model_visitor(Model& m, Actions&&... actions)
 {
     CanNodeDataModelVisitor v{std::forward<Actions>(actions)...};
 
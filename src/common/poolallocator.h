@@ -0,0 +1,165 @@
+#ifndef __POOLALLOCATOR_H
+#define __POOLALLOCATOR_H
+
+#include <array>
+#include <cstddef>
+#include <instrumentation.h>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+*   @brief  Per-thread pools of fixed-size blocks for small objects created on the frame path (node data, shared
+*           pointer control blocks)
+*
+*   Blocks are grouped in size classes of kBlockGranularity bytes. Freed blocks go to free list of the freeing
+*   thread and are reused by the next allocation of the same class there, so in steady state allocation is a
+*   vector pop and never reaches the heap. Each free list keeps at most kMaxFreeBlocks blocks, the rest is
+*   returned to the heap. Pool hits and heap fallbacks are counted in Instrumentation.
+*/
+namespace Pool {
+
+constexpr std::size_t kBlockGranularity = 64;
+constexpr std::size_t kMaxBlockSize = 512;
+constexpr std::size_t kSizeClasses = kMaxBlockSize / kBlockGranularity;
+constexpr std::size_t kMaxFreeBlocks = 1024;
+
+namespace detail {
+    class FreeLists {
+    public:
+        FreeLists() = default;
+        FreeLists(const FreeLists&) = delete;
+        FreeLists& operator=(const FreeLists&) = delete;
+
+        ~FreeLists()
+        {
+            for (auto& list : _lists) {
+                for (void* block : list) {
+                    ::operator delete(block);
+                }
+            }
+        }
+
+        void* take(std::size_t sizeClass)
+        {
+            auto& list = _lists[sizeClass];
+
+            if (list.empty()) {
+                return nullptr;
+            }
+
+            void* block = list.back();
+            list.pop_back();
+
+            return block;
+        }
+
+        bool give(std::size_t sizeClass, void* block)
+        {
+            auto& list = _lists[sizeClass];
+
+            if (list.size() >= kMaxFreeBlocks) {
+                return false;
+            }
+
+            list.push_back(block);
+
+            return true;
+        }
+
+    private:
+        std::array<std::vector<void*>, kSizeClasses> _lists;
+    };
+
+    inline FreeLists& local()
+    {
+        thread_local FreeLists lists;
+        return lists;
+    }
+
+    inline std::size_t sizeClass(std::size_t bytes)
+    {
+        return (bytes + kBlockGranularity - 1) / kBlockGranularity - 1;
+    }
+} // namespace detail
+
+/**
+*   @brief  Allocates block of at least given size, aligned like ::operator new
+*/
+inline void* allocate(std::size_t bytes)
+{
+    if ((bytes == 0) || (bytes > kMaxBlockSize)) {
+        Instrumentation::add(Instrumentation::Counter::HeapAllocations);
+        return ::operator new(bytes);
+    }
+
+    const std::size_t sizeClass = detail::sizeClass(bytes);
+
+    if (void* block = detail::local().take(sizeClass)) {
+        Instrumentation::add(Instrumentation::Counter::PoolAllocations);
+        return block;
+    }
+
+    Instrumentation::add(Instrumentation::Counter::HeapAllocations);
+
+    return ::operator new((sizeClass + 1) * kBlockGranularity);
+}
+
+/**
+*   @brief  Releases block returned by allocate. May be called from any thread.
+*   @param  bytes size passed to allocate
+*/
+inline void deallocate(void* block, std::size_t bytes)
+{
+    if ((bytes == 0) || (bytes > kMaxBlockSize) || !detail::local().give(detail::sizeClass(bytes), block)) {
+        ::operator delete(block);
+    }
+}
+
+/**
+*   @brief  Standard allocator drawing from the pools, stateless
+*/
+template <typename T> struct Allocator {
+    typedef T value_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Pool blocks are aligned like ::operator new");
+
+    Allocator() = default;
+
+    template <typename U> Allocator(const Allocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(Pool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        Pool::deallocate(p, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U> bool operator==(const Allocator<T>&, const Allocator<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U> bool operator!=(const Allocator<T>&, const Allocator<U>&)
+{
+    return false;
+}
+
+/**
+*   @brief  std::make_shared counterpart, object and control block share one pooled block
+*/
+template <typename T, typename... Args> std::shared_ptr<T> makeShared(Args&&... args)
+{
+    return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace Pool
+
+#endif /* !__POOLALLOCATOR_H */
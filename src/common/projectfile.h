@@ -0,0 +1,240 @@
+#ifndef __PROJECTFILE_H
+#define __PROJECTFILE_H
+
+#include <QtCore/QBuffer>
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+*   @brief  Binary encoding of CANdevStudio project (.cds), alternative to scene JSON
+*
+*   File layout:
+*
+*       FileHeader
+*       node table          id, model name, scene part of node, blob offset and size   <- nodeCount entries
+*       connection table    connection JSON                                            <- connectionCount entries
+*       blobs               quint32 size, model JSON of node                           <- one per node
+*
+*   Tables are QDataStream (Qt 5.6) encoded, tableSize bytes in total. Blob of node holds "model" object of the
+*   node, i.e. component configuration, as compact JSON. Offsets of blobs are relative to the end of tables, so
+*   the whole graph is known after reading tables only and a blob is parsed when its component is first needed
+*   (see Document::model). The same project can be exported as JSON, toJson() gives layout produced by
+*   FlowScene::saveToMemory().
+*
+*   Integers of FileHeader and blob sizes are stored in host byte order (little endian on all supported platforms).
+*/
+namespace ProjectFile {
+
+constexpr quint64 kFileMagic = 0x31304a5250534443ULL; // "CDSPRJ01"
+constexpr quint16 kVersion = 1;
+
+struct FileHeader {
+    quint64 magic;
+    quint16 version;
+    quint16 headerSize; // sizeof(FileHeader), readers skip unknown tail
+    quint32 nodeCount;
+    quint32 connectionCount;
+    quint32 tableSize;
+};
+
+static_assert(std::is_trivially_copyable<FileHeader>::value, "FileHeader must be trivially copyable");
+static_assert(sizeof(FileHeader) == 24, "Unexpected FileHeader layout");
+
+struct Node {
+    QString id;
+    QString model; // name of data model, e.g. "CanDeviceModel"
+    QJsonObject scene; // node JSON except id and model, e.g. position
+    quint32 offset; // offset of blob data, relative to the end of tables
+    quint32 size;
+};
+
+/**
+*   @brief  Project read from binary file. Holds content of the file, blobs are parsed on demand.
+*/
+struct Document {
+    std::vector<Node> nodes;
+    std::vector<QJsonObject> connections;
+    QByteArray data;
+    int blobs{ 0 }; // offset of blob area in data
+
+    /**
+    *   @return "model" object of node, parsed from its blob
+    */
+    QJsonObject model(const Node& node) const
+    {
+        return QJsonDocument::fromJson(QByteArray::fromRawData(data.constData() + blobs + node.offset, node.size))
+            .object();
+    }
+
+    /**
+    *   @return complete node JSON, as produced by QtNodes::Node::save()
+    */
+    QJsonObject node(const Node& node) const
+    {
+        QJsonObject json = node.scene;
+
+        json["id"] = node.id;
+        json["model"] = model(node);
+
+        return json;
+    }
+
+    /**
+    *   @return whole project as scene JSON, e.g. for export
+    */
+    QJsonObject toJson() const
+    {
+        QJsonArray nodesJson;
+        QJsonArray connectionsJson;
+
+        for (const auto& n : nodes) {
+            nodesJson.append(node(n));
+        }
+        for (const auto& connection : connections) {
+            connectionsJson.append(connection);
+        }
+
+        return QJsonObject{ { "connections", connectionsJson }, { "nodes", nodesJson } };
+    }
+};
+
+/**
+*   @param  head first bytes of file, at least sizeof(quint64)
+*   @return true if file is binary project, false for JSON
+*/
+inline bool isBinary(const QByteArray& head)
+{
+    quint64 magic = 0;
+
+    if (head.size() < static_cast<int>(sizeof(magic))) {
+        return false;
+    }
+
+    std::memcpy(&magic, head.constData(), sizeof(magic));
+
+    return magic == kFileMagic;
+}
+
+/**
+*   @brief  Reads tables of binary project, blobs are only located
+*   @param  data content of project file, kept by document
+*   @param  doc output
+*   @param  error set to description of the problem if file is not valid
+*   @return false if data is not a valid binary project
+*/
+inline bool read(const QByteArray& data, Document& doc, QString& error)
+{
+    FileHeader header;
+
+    doc = Document();
+
+    if (!isBinary(data) || (data.size() < static_cast<int>(sizeof(header)))) {
+        error = "not a binary project";
+        return false;
+    }
+
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if ((header.version > kVersion) || (header.headerSize < static_cast<quint16>(sizeof(header)))
+        || (static_cast<quint64>(header.headerSize) + header.tableSize > static_cast<quint64>(data.size()))) {
+        error = QString("unsupported version %1 or truncated header").arg(header.version);
+        return false;
+    }
+
+    doc.data = data;
+    doc.blobs = header.headerSize + header.tableSize;
+
+    const QByteArray table = QByteArray::fromRawData(data.constData() + header.headerSize, header.tableSize);
+    QDataStream in(table);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    const quint64 blobsSize = static_cast<quint64>(data.size() - doc.blobs);
+    for (quint32 i = 0; (i < header.nodeCount) && (in.status() == QDataStream::Ok); ++i) {
+        Node node;
+        QByteArray scene;
+
+        in >> node.id >> node.model >> scene >> node.offset >> node.size;
+        if (static_cast<quint64>(node.offset) + node.size > blobsSize) {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+
+        node.scene = QJsonDocument::fromJson(scene).object();
+        doc.nodes.push_back(std::move(node));
+    }
+
+    for (quint32 i = 0; (i < header.connectionCount) && (in.status() == QDataStream::Ok); ++i) {
+        QByteArray connection;
+
+        in >> connection;
+        doc.connections.push_back(QJsonDocument::fromJson(connection).object());
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        error = "corrupted node or connection table";
+        doc = Document();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+*   @brief  Writes project in binary encoding
+*   @param  out output device, e.g. QSaveFile
+*   @param  nodes node JSONs, as produced by QtNodes::Node::save()
+*   @param  connections connection JSONs
+*   @return false if write failed
+*/
+inline bool write(QIODevice& out, const std::vector<QJsonObject>& nodes, const std::vector<QJsonObject>& connections)
+{
+    QByteArray table;
+    QByteArray blobs;
+    QBuffer tableBuffer(&table);
+    tableBuffer.open(QIODevice::WriteOnly);
+    QDataStream tableOut(&tableBuffer);
+    tableOut.setVersion(QDataStream::Qt_5_6);
+
+    for (const auto& node : nodes) {
+        QJsonObject scene = node;
+        const QByteArray model = QJsonDocument(node["model"].toObject()).toJson(QJsonDocument::Compact);
+        const quint32 size = static_cast<quint32>(model.size());
+
+        scene.remove("id");
+        scene.remove("model");
+
+        // Blob data follows its size
+        blobs.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        tableOut << node["id"].toString() << node["model"].toObject()["name"].toString()
+                 << QJsonDocument(scene).toJson(QJsonDocument::Compact) << static_cast<quint32>(blobs.size()) << size;
+        blobs.append(model);
+    }
+
+    for (const auto& connection : connections) {
+        tableOut << QJsonDocument(connection).toJson(QJsonDocument::Compact);
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kFileMagic;
+    header.version = kVersion;
+    header.headerSize = sizeof(header);
+    header.nodeCount = static_cast<quint32>(nodes.size());
+    header.connectionCount = static_cast<quint32>(connections.size());
+    header.tableSize = static_cast<quint32>(table.size());
+
+    return (out.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header)))
+        && (out.write(table) == table.size()) && (out.write(blobs) == blobs.size());
+}
+
+} // namespace ProjectFile
+
+#endif /* !__PROJECTFILE_H */
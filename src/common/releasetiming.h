@@ -0,0 +1,135 @@
+#ifndef __RELEASETIMING_H
+#define __RELEASETIMING_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QtGlobal>
+#include <algorithm>
+#include <chrono>
+#include <log.h>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+*   @brief  How thread releasing frames at planned times (TxScheduler, TraceReplay) waits for them
+*
+*   OS timers wake threads up with jitter of about a millisecond. With hybrid wait thread sleeps until spin
+*   before release time and spins on monotonic clock for the rest, so frames are released within microseconds
+*   at the cost of a busy core for the spin part of every wait. Affinity to isolated core and real-time
+*   priority keep spinning thread from being preempted. Both are applied on Linux only and need privileges
+*   (CAP_SYS_NICE), failure is logged and thread keeps running with default scheduling.
+*
+*   Kept in "timing" key of component configuration, keys: spinUs, cpu, rtPriority.
+*/
+struct ReleaseTiming {
+    static constexpr int kAnyCpu = -1;
+
+    std::chrono::microseconds spin{ 0 }; // 0 sleeps all the way to release time
+    int cpu{ kAnyCpu };
+    int priority{ 0 }; // SCHED_FIFO priority 1..99, 0 keeps default scheduling
+
+    bool operator==(const ReleaseTiming& other) const
+    {
+        return (spin == other.spin) && (cpu == other.cpu) && (priority == other.priority);
+    }
+
+    bool operator!=(const ReleaseTiming& other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+    *   @return false if timing is the default one, i.e. thread is woken up by OS timer only
+    */
+    bool isPrecise() const
+    {
+        return *this != ReleaseTiming();
+    }
+
+    static ReleaseTiming fromJson(const QJsonObject& json)
+    {
+        ReleaseTiming timing;
+
+        timing.spin = std::chrono::microseconds(std::max(json["spinUs"].toInt(0), 0));
+        const int cpu = json["cpu"].toInt(kAnyCpu);
+        timing.cpu = (cpu < 0) ? kAnyCpu : cpu;
+        timing.priority = qBound(0, json["rtPriority"].toInt(0), 99);
+
+        return timing;
+    }
+
+    QJsonObject toJson() const
+    {
+        return QJsonObject{ { "spinUs", static_cast<int>(spin.count()) }, { "cpu", cpu }, { "rtPriority", priority } };
+    }
+
+    /**
+    *   @brief  Applies affinity and priority to calling thread. Default timing puts thread back to affinity of the
+    *           process and to default scheduling.
+    *   @return false if any of them could not be applied
+    */
+    bool applyToCurrentThread() const
+    {
+        bool status = true;
+
+#ifdef Q_OS_LINUX
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (cpu != kAnyCpu) {
+            CPU_SET(cpu, &set);
+        } else if (sched_getaffinity(getpid(), sizeof(set), &set) != 0) {
+            // Affinity of main thread is that of the process
+            CPU_ZERO(&set);
+        }
+
+        if (CPU_COUNT(&set) && (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)) {
+            cds_warn("Failed to set CPU affinity {} of release thread", cpu);
+            status = false;
+        }
+
+        sched_param param;
+        param.sched_priority = priority;
+        if (pthread_setschedparam(pthread_self(), (priority > 0) ? SCHED_FIFO : SCHED_OTHER, &param) != 0) {
+            cds_warn("Failed to set real-time priority {} of release thread", priority);
+            status = false;
+        }
+#else
+        if ((cpu != kAnyCpu) || (priority > 0)) {
+            cds_warn("CPU affinity and real-time priority are supported on Linux only");
+            status = false;
+        }
+#endif
+
+        return status;
+    }
+
+    /**
+    *   @return time thread should be woken up at to release frame at deadline
+    */
+    template <typename TimePoint> TimePoint wakeUp(TimePoint deadline) const
+    {
+        return deadline - spin;
+    }
+
+    /**
+    *   @brief  Busy waits until deadline
+    */
+    template <typename Clock> static void spinUntil(typename Clock::time_point deadline)
+    {
+        while (Clock::now() < deadline) {
+#if defined(__x86_64__) || defined(__i386__)
+            // Lets sibling hyperthread run and saves power while spinning
+            _mm_pause();
+#endif
+        }
+    }
+};
+
+#endif /* !__RELEASETIMING_H */
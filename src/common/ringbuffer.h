@@ -0,0 +1,260 @@
+#ifndef __RINGBUFFER_H
+#define __RINGBUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+inline std::size_t roundUpPow2(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+*   @brief  Bounded, lock-free single-producer/single-consumer queue
+*
+*   One thread may call push(), another one may call pop()/consumeAll() concurrently without any locking.
+*   Capacity is rounded up to the next power of two. push() fails (and leaves the queue untouched) when the
+*   queue is full, so the producer decides what to do with the overflow.
+*/
+template <typename T> class SpscRingBuffer {
+public:
+    /**
+    *   @param  capacity minimal number of elements that can be stored
+    */
+    explicit SpscRingBuffer(std::size_t capacity)
+        : _buffer(roundUpPow2(capacity))
+        , _mask(_buffer.size() - 1)
+    {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /**
+    *   @brief  Appends element. Producer side only.
+    *   @return false if queue is full
+    */
+    template <typename U> bool push(U&& value)
+    {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+
+        if (head - _tail.load(std::memory_order_acquire) == _buffer.size()) {
+            return false;
+        }
+
+        _buffer[head & _mask] = std::forward<U>(value);
+        _head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+    *   @brief  Takes oldest element. Consumer side only.
+    *   @return false if queue is empty
+    */
+    bool pop(T& value)
+    {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = std::move(_buffer[tail & _mask]);
+        _tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+    *   @brief  Passes all currently available elements to fn. Consumer side only.
+    *   @return number of consumed elements
+    */
+    template <typename F> std::size_t consumeAll(F&& fn)
+    {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        const std::size_t head = _head.load(std::memory_order_acquire);
+        const std::size_t count = head - tail;
+
+        for (; tail != head; ++tail) {
+            fn(std::move(_buffer[tail & _mask]));
+        }
+
+        _tail.store(tail, std::memory_order_release);
+
+        return count;
+    }
+
+    /**
+    *   @return number of elements. Exact only when called from producer or consumer while the other side is idle.
+    */
+    std::size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const
+    {
+        return _buffer.size();
+    }
+
+private:
+    std::vector<T> _buffer;
+    const std::size_t _mask;
+    // head and tail are kept on separate cache lines to avoid false sharing between producer and consumer
+    std::atomic<std::size_t> _head{ 0 };
+    char _padding[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> _tail{ 0 };
+};
+
+/**
+*   @brief  Bounded FIFO queue for use within a single thread
+*
+*   Storage is allocated once, so push/pop never allocate and never shift elements. Capacity is rounded up to
+*   the next power of two.
+*/
+template <typename T> class RingBuffer {
+public:
+    /**
+    *   @param  capacity minimal number of elements that can be stored
+    */
+    explicit RingBuffer(std::size_t capacity)
+        : _buffer(roundUpPow2(capacity))
+        , _mask(_buffer.size() - 1)
+    {
+    }
+
+    /**
+    *   @brief  Appends element
+    *   @return false if queue is full, element is not stored in that case
+    */
+    template <typename U> bool push(U&& value)
+    {
+        if (full()) {
+            return false;
+        }
+
+        _buffer[_head++ & _mask] = std::forward<U>(value);
+
+        return true;
+    }
+
+    /**
+    *   @brief  Appends element, oldest element is overwritten if queue is full
+    *   @return false if oldest element was overwritten
+    */
+    template <typename U> bool pushOverwrite(U&& value)
+    {
+        const bool wasFull = full();
+
+        if (wasFull) {
+            ++_tail;
+        }
+
+        _buffer[_head++ & _mask] = std::forward<U>(value);
+
+        return !wasFull;
+    }
+
+    /**
+    *   @brief  Takes oldest element
+    *   @return false if queue is empty
+    */
+    bool pop(T& value)
+    {
+        if (empty()) {
+            return false;
+        }
+
+        value = std::move(_buffer[_tail++ & _mask]);
+
+        return true;
+    }
+
+    /**
+    *   @brief  Removes up to count oldest elements in O(1)
+    *   @return number of removed elements
+    */
+    std::size_t drop(std::size_t count)
+    {
+        count = std::min(count, size());
+        _tail += count;
+
+        return count;
+    }
+
+    /**
+    *   @brief  Removes up to count newest elements in O(1)
+    *   @return number of removed elements
+    */
+    std::size_t dropBack(std::size_t count)
+    {
+        count = std::min(count, size());
+        _head -= count;
+
+        return count;
+    }
+
+    /**
+    *   @brief  Access to element, 0 being the oldest one
+    */
+    T& operator[](std::size_t ndx)
+    {
+        return _buffer[(_tail + ndx) & _mask];
+    }
+
+    const T& operator[](std::size_t ndx) const
+    {
+        return _buffer[(_tail + ndx) & _mask];
+    }
+
+    T& front()
+    {
+        return (*this)[0];
+    }
+
+    T& back()
+    {
+        return (*this)[size() - 1];
+    }
+
+    void clear()
+    {
+        _tail = _head;
+    }
+
+    std::size_t size() const
+    {
+        return _head - _tail;
+    }
+
+    std::size_t capacity() const
+    {
+        return _buffer.size();
+    }
+
+    bool empty() const
+    {
+        return _head == _tail;
+    }
+
+    bool full() const
+    {
+        return size() == _buffer.size();
+    }
+
+private:
+    std::vector<T> _buffer;
+    const std::size_t _mask;
+    std::size_t _head{ 0 };
+    std::size_t _tail{ 0 };
+};
+
+#endif /* !__RINGBUFFER_H */
@@ -0,0 +1,50 @@
+#ifndef __SIGNALSAMPLE_H
+#define __SIGNALSAMPLE_H
+
+#include <QtCore/QMetaType>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtCore/QtGlobal>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+*   @brief  Description of decoded signal. Samples refer to signals by index in SignalCatalog.
+*/
+struct SignalInfo {
+    QString message; // name of message carrying the signal
+    QString name;
+    QString unit;
+    quint32 frameId;
+    bool extended;
+    double minimum;
+    double maximum;
+};
+
+/**
+*   @brief  Signals known to decoder, shared read-only with consumers of its samples
+*/
+typedef std::vector<SignalInfo> SignalCatalog;
+typedef std::shared_ptr<const SignalCatalog> SignalCatalogPtr;
+
+/**
+*   @brief  Single physical value of a signal
+*/
+struct SignalSample {
+    quint64 timestamp; // microseconds since epoch, timestamp of frame carrying the value
+    quint32 signal; // index in SignalCatalog
+    quint32 reserved;
+    double value;
+};
+
+static_assert(std::is_trivially_copyable<SignalSample>::value, "SignalSample must be trivially copyable");
+
+/**
+*   @brief  Batch of samples, implicitly shared like CanFrameBatch
+*/
+typedef QVector<SignalSample> SignalSampleBatch;
+
+Q_DECLARE_METATYPE(SignalSample)
+
+#endif /* !__SIGNALSAMPLE_H */
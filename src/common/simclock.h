@@ -0,0 +1,290 @@
+#ifndef __SIMCLOCK_H
+#define __SIMCLOCK_H
+
+#include <QtCore/QMetaObject>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+*   @brief  Simulation clock, source of frame timestamps (see canTimestampNow) and of scheduling of simulated sources
+*
+*   In real time mode clock is wall clock, microseconds since epoch as used by socketcan timestamps. In virtual mode
+*   clock starts at wall clock when simulation starts and advances only by running events registered with
+*   schedule(). Driver runs all events of the earliest instant, advances clock to it and returns to event loop, so
+*   that frames queued meanwhile are delivered before the next instant. Idle periods are skipped, replayed and
+*   synthetic traffic then runs as fast as its consumers process it. Virtual mode makes sense only if every
+*   source of frames is simulated, hardware devices keep their own pace.
+*
+*   Clock is started and stopped with simulation by ProjectConfig or HeadlessProject. Events are run in thread of
+*   their context object. Events of other threads are posted there, clock advances to the next instant only after
+*   all of them reported back, event loop of main thread keeps running meanwhile.
+*/
+class SimClock {
+public:
+    enum class Mode { RealTime, Virtual };
+    typedef quint64 EventId;
+
+    static constexpr EventId kInvalidEvent = 0;
+    // Events run by single driver step at most, so that one busy instant does not starve event loop
+    static constexpr int kEventsPerStep = 256;
+
+    static SimClock& instance()
+    {
+        static SimClock clock;
+        return clock;
+    }
+
+    static quint64 wallClockUs()
+    {
+        using namespace std::chrono;
+        return static_cast<quint64>(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+    *   @return current simulation time in microseconds since epoch
+    */
+    static quint64 nowUs()
+    {
+        const SimClock& clock = instance();
+
+        return clock._virtual.load(std::memory_order_relaxed) ? clock._nowUs.load(std::memory_order_acquire)
+                                                               : wallClockUs();
+    }
+
+    static bool isVirtual()
+    {
+        return instance()._virtual.load(std::memory_order_relaxed);
+    }
+
+    /**
+    *   @brief  Starts clock, called from main thread before components start
+    *   @param  mode real time or virtual time
+    */
+    void start(Mode mode)
+    {
+        stop();
+
+        if (mode == Mode::Virtual) {
+            if (!_driver) {
+                _driver = std::make_unique<QTimer>();
+                _driver->setInterval(0);
+                QObject::connect(_driver.get(), &QTimer::timeout, [this] { step(); });
+            }
+            _nowUs.store(wallClockUs(), std::memory_order_release);
+            _held = false;
+            _virtual.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+    *   @brief  Stops clock, pending events are dropped and clock follows wall clock again. Called from main thread,
+    *           may be called by event.
+    */
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _virtual.store(false, std::memory_order_relaxed);
+        _events.clear();
+        if (_driver) {
+            _driver->stop();
+        }
+    }
+
+    Mode mode() const
+    {
+        return isVirtual() ? Mode::Virtual : Mode::RealTime;
+    }
+
+    /**
+    *   @brief  Held clock does not advance, events wait until it is released. Lets embedding application process
+    *           events between runs without the clock moving on, see SimulationEngine.
+    */
+    void setHeld(bool held)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _held = held;
+        if (!held && _driver && !_events.empty()) {
+            QMetaObject::invokeMethod(_driver.get(), "start", Qt::QueuedConnection);
+        }
+    }
+
+    /**
+    *   @brief  Registers event run when virtual clock reaches given time. Thread safe.
+    *   @param  context event runs in thread of context, event of destroyed context is dropped
+    *   @param  dueUs virtual time of event, events in the past run at current time
+    *   @param  fn event
+    *   @return event id, kInvalidEvent if clock is not virtual
+    */
+    EventId schedule(QObject* context, quint64 dueUs, std::function<void()> fn)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!_virtual.load(std::memory_order_relaxed)) {
+            return kInvalidEvent;
+        }
+
+        const EventId id = _nextId++;
+        _events.push_back({ std::max(dueUs, _nowUs.load(std::memory_order_relaxed)), id, context, std::move(fn) });
+        std::push_heap(_events.begin(), _events.end(), later);
+
+        // Driver lives in main thread
+        QMetaObject::invokeMethod(_driver.get(), "start", Qt::QueuedConnection);
+
+        return id;
+    }
+
+    /**
+    *   @brief  Drops event that did not run yet. Unknown ids are ignored.
+    */
+    void cancel(EventId id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = std::find_if(_events.begin(), _events.end(), [id](const Event& event) { return event.id == id; });
+        if (it != _events.end()) {
+            _events.erase(it);
+            std::make_heap(_events.begin(), _events.end(), later);
+        }
+    }
+
+    /**
+    *   @brief  Advances clock to the earliest event and runs all events due then. Called by driver, may be
+    *           called directly from main thread, e.g. by tests.
+    *   @return false if there was no event to run, clock is held or events of previous instant still run
+    */
+    bool step()
+    {
+        std::vector<Event> due;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // Driver is started again by the last event that reports back
+            if (_events.empty() || _held || (_running > 0)) {
+                if (_driver) {
+                    _driver->stop();
+                }
+                return false;
+            }
+
+            const quint64 instant = _events.front().dueUs;
+            const std::size_t limit = kEventsPerStep;
+            while (!_events.empty() && (_events.front().dueUs == instant) && (due.size() < limit)) {
+                std::pop_heap(_events.begin(), _events.end(), later);
+                due.push_back(std::move(_events.back()));
+                _events.pop_back();
+            }
+            _nowUs.store(instant, std::memory_order_release);
+        }
+
+        // Events may schedule new ones
+        for (auto& event : due) {
+            run(event);
+        }
+
+        return true;
+    }
+
+    /**
+    *   @return number of events waiting to run
+    */
+    std::size_t pendingEvents() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        return _events.size();
+    }
+
+private:
+    struct Event {
+        quint64 dueUs;
+        EventId id;
+        QPointer<QObject> context;
+        std::function<void()> fn;
+    };
+
+    SimClock() = default;
+
+    // Events of the same instant run in order they were scheduled
+    static bool later(const Event& a, const Event& b)
+    {
+        return (a.dueUs != b.dueUs) ? (a.dueUs > b.dueUs) : (a.id > b.id);
+    }
+
+    // Reports back event posted to other thread, also when it was dropped with its context
+    class Completion {
+    public:
+        ~Completion()
+        {
+            release();
+        }
+
+        void release()
+        {
+            if (!_released) {
+                _released = true;
+                instance().eventDone();
+            }
+        }
+
+    private:
+        bool _released{ false };
+    };
+
+    void run(Event& event)
+    {
+        QObject* context = event.context.data();
+
+        if (!context) {
+            return;
+        }
+
+        if (context->thread() == QThread::currentThread()) {
+            event.fn();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_running;
+        }
+
+        auto done = std::make_shared<Completion>();
+        QTimer::singleShot(0, context, [fn = std::move(event.fn), done] {
+            fn();
+            done->release();
+        });
+    }
+
+    void eventDone()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if ((--_running == 0) && !_held && _driver && !_events.empty()) {
+            QMetaObject::invokeMethod(_driver.get(), "start", Qt::QueuedConnection);
+        }
+    }
+
+    mutable std::mutex _mutex;
+    std::vector<Event> _events; // min-heap ordered by due time
+    std::atomic<bool> _virtual{ false };
+    std::atomic<quint64> _nowUs{ 0 };
+    EventId _nextId{ kInvalidEvent + 1 };
+    bool _held{ false };
+    int _running{ 0 }; // events posted to other threads that did not report back yet
+    std::unique_ptr<QTimer> _driver; // created by first virtual start, lives in main thread
+};
+
+#endif /* !__SIMCLOCK_H */
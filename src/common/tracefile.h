@@ -0,0 +1,85 @@
+#ifndef __TRACEFILE_H
+#define __TRACEFILE_H
+
+#include <QtCore/QtGlobal>
+#include <canframerecord.h>
+#include <type_traits>
+
+/**
+*   @brief  On-disk layout of CANdevStudio binary trace (.cdst)
+*
+*   File is append-only:
+*
+*       TraceFileHeader
+*       TraceBlockHeader(Data)  CanFrameRecord[count]
+*       TraceBlockHeader(Data)  CanFrameRecord[count]
+*       ...
+*       TraceBlockHeader(Index) TraceIndexEntry[count]     <- every kIndexInterval data blocks
+*       ...
+*       TraceBlockHeader(Index) TraceIndexEntry[count]     <- data blocks after previous index
+*       TraceFileTrailer                                   <- only if trace was closed properly
+*
+*   Records are raw CanFrameRecord structures (fixed size). Each index block lists data blocks written since
+*   previous index block and links to it, so readers can find all blocks walking back from the trailer without
+*   touching data. If trailer is missing (e.g. application crashed), block headers can be scanned sequentially.
+*
+*   All integers are stored in host byte order (little endian on all supported platforms).
+*/
+namespace TraceFile {
+
+constexpr quint64 kFileMagic = 0x3130545344434443ULL; // "CDCDST01"
+constexpr quint32 kBlockMagic = 0x4b4c4243; // "CBLK"
+constexpr quint64 kTrailerMagic = 0x444e455453444443ULL; // "CDDSTEND"
+constexpr quint16 kVersion = 1;
+
+// Number of data blocks described by one index block
+constexpr int kIndexInterval = 64;
+
+enum BlockKind : quint16 { DataBlock = 1, IndexBlock = 2 };
+
+struct FileHeader {
+    quint64 magic;
+    quint16 version;
+    quint16 headerSize; // sizeof(FileHeader), readers skip unknown tail
+    quint16 recordSize; // sizeof(CanFrameRecord)
+    quint16 reserved;
+    quint64 startTimestamp; // microseconds since epoch, same clock as CanFrameRecord::timestamp
+};
+
+struct BlockHeader {
+    quint32 magic;
+    quint16 kind; // BlockKind
+    quint16 reserved;
+    quint32 count; // number of records (data block) or entries (index block)
+    quint32 reserved2;
+    quint64 minTimestamp; // data block: timestamps range of records, index block: range of indexed blocks
+    quint64 maxTimestamp;
+    quint64 link; // data block: index of first record in trace, index block: offset of previous index (0 if none)
+};
+
+struct IndexEntry {
+    quint64 offset; // offset of data block header
+    quint64 firstRecord; // index of first record of block in trace
+    quint32 count;
+    quint32 reserved;
+    quint64 minTimestamp;
+    quint64 maxTimestamp;
+};
+
+struct FileTrailer {
+    quint64 magic;
+    quint64 lastIndexOffset;
+    quint64 recordCount;
+    quint64 endTimestamp;
+};
+
+static_assert(std::is_trivially_copyable<FileHeader>::value, "FileHeader must be trivially copyable");
+static_assert(sizeof(FileHeader) == 24, "Unexpected FileHeader layout");
+static_assert(sizeof(BlockHeader) == 40, "Unexpected BlockHeader layout");
+static_assert(sizeof(IndexEntry) == 40, "Unexpected IndexEntry layout");
+static_assert(sizeof(FileTrailer) == 32, "Unexpected FileTrailer layout");
+static_assert(sizeof(CanFrameRecord) == 80, "CanFrameRecord layout is part of trace format");
+
+} // namespace TraceFile
+
+#endif /* !__TRACEFILE_H */
@@ -0,0 +1,337 @@
+#ifndef __TRACEREADER_H
+#define __TRACEREADER_H
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <algorithm>
+#include <cstring>
+#include <tracefile.h>
+#include <vector>
+
+/**
+*   @brief  Read-only, memory-mapped access to binary trace (see tracefile.h)
+*
+*   File is mapped, not read. Opening walks index blocks only (block list is ~1/4096 of record count), records are
+*   touched when accessed, so opening even very large trace is instant and only pages actually used become
+*   resident. Traces without trailer (writer did not finish) are opened by scanning block headers.
+*/
+class TraceReader {
+public:
+    struct Block {
+        quint64 offset; // offset of first record
+        quint64 firstRecord;
+        quint32 count;
+        quint64 minTimestamp;
+        quint64 maxTimestamp;
+    };
+
+    TraceReader() = default;
+
+    ~TraceReader()
+    {
+        close();
+    }
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    /**
+    *   @brief  Opens and maps trace. Trace currently open is closed first.
+    *   @param  path trace file path
+    *   @return false if file cannot be mapped or is not a trace
+    */
+    bool open(const QString& path)
+    {
+        close();
+
+        _file.setFileName(path);
+        if (!_file.open(QIODevice::ReadOnly) || (_file.size() < static_cast<qint64>(sizeof(TraceFile::FileHeader)))) {
+            close();
+            return false;
+        }
+
+        _size = static_cast<quint64>(_file.size());
+        _data = _file.map(0, _file.size());
+        if (!_data) {
+            close();
+            return false;
+        }
+
+        std::memcpy(&_header, _data, sizeof(_header));
+        if ((_header.magic != TraceFile::kFileMagic) || (_header.recordSize != sizeof(CanFrameRecord))
+            || (_header.headerSize < sizeof(TraceFile::FileHeader))) {
+            close();
+            return false;
+        }
+
+        if (!loadIndex()) {
+            scanBlocks();
+        }
+
+        if (!_blocks.empty()) {
+            const Block& last = _blocks.back();
+            _recordCount = last.firstRecord + last.count;
+        }
+
+        return true;
+    }
+
+    void close()
+    {
+        if (_data) {
+            _file.unmap(_data);
+            _data = nullptr;
+        }
+
+        _file.close();
+        _blocks.clear();
+        _recordCount = 0;
+        _size = 0;
+        _complete = false;
+        _header = TraceFile::FileHeader{};
+    }
+
+    bool isOpen() const
+    {
+        return _data != nullptr;
+    }
+
+    /**
+    *   @return path of trace, empty if none is open
+    */
+    QString fileName() const
+    {
+        return isOpen() ? _file.fileName() : QString();
+    }
+
+    /**
+    *   @return true if trace was properly finalized (trailer and index present)
+    */
+    bool isComplete() const
+    {
+        return _complete;
+    }
+
+    quint64 recordCount() const
+    {
+        return _recordCount;
+    }
+
+    /**
+    *   @return time of trace creation, microseconds since epoch
+    */
+    quint64 startTimestamp() const
+    {
+        return _header.startTimestamp;
+    }
+
+    /**
+    *   @return timestamp of first record, startTimestamp() if trace is empty
+    */
+    quint64 firstTimestamp() const
+    {
+        return _blocks.empty() ? _header.startTimestamp : _blocks.front().minTimestamp;
+    }
+
+    /**
+    *   @return highest record timestamp in trace
+    */
+    quint64 lastTimestamp() const
+    {
+        quint64 last = firstTimestamp();
+
+        for (const auto& block : _blocks) {
+            last = std::max(last, block.maxTimestamp);
+        }
+
+        return last;
+    }
+
+    const std::vector<Block>& blocks() const
+    {
+        return _blocks;
+    }
+
+    /**
+    *   @brief  Direct access to mapped record
+    *   @param  ndx record index, must be lower than recordCount()
+    *   @return pointer into mapped file
+    */
+    const CanFrameRecord* record(quint64 ndx) const
+    {
+        const Block& block = blockOf(ndx);
+
+        return reinterpret_cast<const CanFrameRecord*>(_data + block.offset) + (ndx - block.firstRecord);
+    }
+
+    /**
+    *   @brief  Copies range of records
+    *   @param  first index of first record
+    *   @param  count number of records, truncated at end of trace
+    *   @return copied records
+    */
+    CanFrameBatch records(quint64 first, quint64 count) const
+    {
+        CanFrameBatch batch;
+
+        if (first >= _recordCount) {
+            return batch;
+        }
+
+        count = std::min(count, _recordCount - first);
+        batch.resize(static_cast<int>(count));
+
+        quint64 copied = 0;
+        while (copied < count) {
+            const quint64 ndx = first + copied;
+            const Block& block = blockOf(ndx);
+            const quint64 inBlock = std::min<quint64>(block.firstRecord + block.count - ndx, count - copied);
+
+            std::memcpy(batch.data() + copied, record(ndx), inBlock * sizeof(CanFrameRecord));
+            copied += inBlock;
+        }
+
+        return batch;
+    }
+
+    /**
+    *   @brief  Finds first record with timestamp not lower than given one. Records are assumed to be (mostly)
+    *           ordered by time, as they are written in order of arrival.
+    *   @param  timestamp microseconds since epoch
+    *   @return record index, recordCount() if all records are older
+    */
+    quint64 findTimestamp(quint64 timestamp) const
+    {
+        auto it = std::partition_point(
+            _blocks.begin(), _blocks.end(), [timestamp](const Block& b) { return b.maxTimestamp < timestamp; });
+
+        if (it == _blocks.end()) {
+            return _recordCount;
+        }
+
+        const CanFrameRecord* recs = reinterpret_cast<const CanFrameRecord*>(_data + it->offset);
+        const auto pos = std::partition_point(
+            recs, recs + it->count, [timestamp](const CanFrameRecord& r) { return r.timestamp < timestamp; });
+
+        return it->firstRecord + static_cast<quint64>(pos - recs);
+    }
+
+private:
+    const Block& blockOf(quint64 ndx) const
+    {
+        auto it = std::upper_bound(_blocks.begin(), _blocks.end(), ndx,
+            [](quint64 value, const Block& b) { return value < b.firstRecord; });
+
+        return *(it - 1);
+    }
+
+    template <typename T> bool readAt(quint64 offset, T& value) const
+    {
+        if ((offset > _size) || (_size - offset < sizeof(T))) {
+            return false;
+        }
+
+        std::memcpy(&value, _data + offset, sizeof(T));
+
+        return true;
+    }
+
+    bool addBlock(quint64 headerOffset, const TraceFile::BlockHeader& header, quint64 firstRecord)
+    {
+        const quint64 offset = headerOffset + sizeof(TraceFile::BlockHeader);
+
+        if ((header.magic != TraceFile::kBlockMagic) || (offset > _size)
+            || ((_size - offset) / sizeof(CanFrameRecord) < header.count)) {
+            return false;
+        }
+
+        _blocks.push_back(Block{ offset, firstRecord, header.count, header.minTimestamp, header.maxTimestamp });
+
+        return true;
+    }
+
+    bool loadIndex()
+    {
+        TraceFile::FileTrailer trailer;
+
+        if ((_size < sizeof(trailer)) || !readAt(_size - sizeof(trailer), trailer)
+            || (trailer.magic != TraceFile::kTrailerMagic)) {
+            return false;
+        }
+
+        // Index blocks are linked from the newest to the oldest one
+        std::vector<std::vector<TraceFile::IndexEntry>> chain;
+        quint64 indexOffset = trailer.lastIndexOffset;
+
+        while (indexOffset != 0) {
+            TraceFile::BlockHeader header;
+
+            if (!readAt(indexOffset, header) || (header.magic != TraceFile::kBlockMagic)
+                || (header.kind != TraceFile::IndexBlock) || (header.link >= indexOffset)) {
+                return false;
+            }
+
+            std::vector<TraceFile::IndexEntry> entries(header.count);
+            const quint64 entriesSize = header.count * sizeof(TraceFile::IndexEntry);
+            if (_size - indexOffset - sizeof(header) < entriesSize) {
+                return false;
+            }
+            std::memcpy(entries.data(), _data + indexOffset + sizeof(header), entriesSize);
+
+            chain.push_back(std::move(entries));
+            indexOffset = header.link;
+        }
+
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            for (const auto& entry : *it) {
+                TraceFile::BlockHeader header;
+
+                if (!readAt(entry.offset, header) || (header.kind != TraceFile::DataBlock)
+                    || !addBlock(entry.offset, header, entry.firstRecord)) {
+                    _blocks.clear();
+                    return false;
+                }
+            }
+        }
+
+        _complete = true;
+
+        return true;
+    }
+
+    void scanBlocks()
+    {
+        quint64 offset = _header.headerSize;
+        quint64 records = 0;
+        TraceFile::BlockHeader header;
+
+        _blocks.clear();
+
+        while (readAt(offset, header) && (header.magic == TraceFile::kBlockMagic)) {
+            quint64 payload;
+
+            if (header.kind == TraceFile::DataBlock) {
+                if (!addBlock(offset, header, records)) {
+                    // Block truncated by crash of writer
+                    break;
+                }
+                records += header.count;
+                payload = header.count * sizeof(CanFrameRecord);
+            } else {
+                payload = header.count * sizeof(TraceFile::IndexEntry);
+            }
+
+            offset += sizeof(header) + payload;
+        }
+    }
+
+    QFile _file;
+    uchar* _data{ nullptr };
+    quint64 _size{ 0 };
+    TraceFile::FileHeader _header{};
+    std::vector<Block> _blocks;
+    quint64 _recordCount{ 0 };
+    bool _complete{ false };
+};
+
+#endif /* !__TRACEREADER_H */
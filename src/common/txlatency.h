@@ -0,0 +1,98 @@
+#ifndef __TXLATENCY_H
+#define __TXLATENCY_H
+
+#include <QtCore/QHash>
+#include <QtCore/QtGlobal>
+#include <QtSerialBus/QCanBusFrame>
+#include <instrumentation.h>
+#include <vector>
+
+/**
+*   @brief  Transmit latency of one id. Times are in microseconds.
+*/
+struct TxLatencyStats {
+    quint32 id{ 0 };
+    bool extended{ false };
+    Instrumentation::HistogramSnapshot handoffUs; ///< request (CanDevice::sendFrames) to handover to backend
+    Instrumentation::HistogramSnapshot confirmUs; ///< handover to backend to its confirmation
+    Instrumentation::HistogramSnapshot totalUs; ///< request to confirmation
+};
+
+/**
+*   @brief  Per id transmit latency histograms of a device
+*
+*   Single writer, readers get a copy with snapshot(). Ids beyond kMaxIds are only counted.
+*/
+class TxLatencyTable {
+public:
+    static constexpr int kMaxIds = 4096;
+
+    /**
+    *   @brief  Accounts one confirmed frame
+    *   @param  frame confirmed frame
+    *   @param  requestUs time frame was requested
+    *   @param  handoffUs time frame was handed over to backend
+    *   @param  confirmUs time backend confirmed the frame
+    */
+    void record(const QCanBusFrame& frame, quint64 requestUs, quint64 handoffUs, quint64 confirmUs)
+    {
+        const quint32 key = frame.frameId() | (frame.hasExtendedFrameFormat() ? (1u << 31) : 0);
+        auto it = _index.constFind(key);
+
+        if (it == _index.cend()) {
+            if (_index.size() >= kMaxIds) {
+                ++_untracked;
+                return;
+            }
+
+            it = _index.insert(key, static_cast<int>(_stats.size()));
+            _stats.push_back(TxLatencyStats());
+            _stats.back().id = frame.frameId();
+            _stats.back().extended = frame.hasExtendedFrameFormat();
+        }
+
+        TxLatencyStats& stats = _stats[static_cast<std::size_t>(it.value())];
+
+        stats.handoffUs.add(elapsed(requestUs, handoffUs));
+        stats.confirmUs.add(elapsed(handoffUs, confirmUs));
+        stats.totalUs.add(elapsed(requestUs, confirmUs));
+    }
+
+    /**
+    *   @return statistics in order ids were first seen
+    */
+    std::vector<TxLatencyStats> snapshot() const
+    {
+        return _stats;
+    }
+
+    /**
+    *   @return frames of ids that did not fit into table
+    */
+    quint64 untrackedCount() const
+    {
+        return _untracked;
+    }
+
+    void clear()
+    {
+        _index.clear();
+        _stats.clear();
+        _untracked = 0;
+    }
+
+    /**
+    *   @return time between two timestamps, 0 if clock went backwards
+    */
+    static quint64 elapsed(quint64 fromUs, quint64 toUs)
+    {
+        return (toUs > fromUs) ? toUs - fromUs : 0;
+    }
+
+private:
+    QHash<quint32, int> _index;
+    std::vector<TxLatencyStats> _stats;
+    quint64 _untracked{ 0 };
+};
+
+#endif /* !__TXLATENCY_H */
@@ -2,24 +2,164 @@
 #ifndef VISTOR_H
 #define VISTOR_H
 
+#include <cassert> // assert
+#include <cstddef> // size_t
 #include <functional> // function
 #include <tuple> // tuple, tuple_element, get
-#include <type_traits> // {is,remove}_reference, {true,false}_type, enable_if
+#include <type_traits> // {is,remove}_reference, {true,false}_type, enable_if, integral_constant
+#include <typeinfo> // type_info
 #include <utility> // move, forward
 
 #include "visitablewith.h" // VisitableWith
 
 
 
+/**
+ * Compile-time tags for a closed set of polymorphic types. Tag of
+ * a type is its position in Types. Objects are dispatched on their
+ * exact dynamic type: typeid lookup yields the tag, and a generated
+ * jump table of static_casts invokes the action, so no cross casts
+ * through RTTI hierarchy are made. Casts are verified with
+ * dynamic_cast in debug builds only. Types must derive
+ * non-virtually from the Base used for dispatch.
+ *
+ * Example
+ * @code
+ *  using Tags = TypeTags<A, B>;
+ *
+ *  static_assert(Tags::tag_of<B>() == 1, "");
+ *
+ *  Base& b = ...;
+ *  Tags::dispatch(b, [](auto& t) { t.doSomething(); });  // A& or B&
+ *  A* a = Tags::cast<A>(&b);                               // nullptr if b is not A
+ * @endcode
+ */
+template<class... Types>
+class TypeTags
+{
+    template<class T, class... Ts>
+    struct index_of;  // T is not in Types if incomplete
+
+    template<class T, class... Ts>
+    struct index_of<T, T, Ts...>
+      : std::integral_constant<std::size_t, 0>
+    {};
+
+    template<class T, class U, class... Ts>
+    struct index_of<T, U, Ts...>
+      : std::integral_constant<std::size_t, 1 + index_of<T, Ts...>::value>
+    {};
+
+ public:
+
+    using types = std::tuple<Types...>;  // DO NOT PASS REFERENCES
+
+    template<class T>
+    struct type_tag
+    {
+        using type = T;
+    };
+
+    static constexpr std::size_t none = sizeof...(Types);
+
+
+    template<class T>
+    static constexpr std::size_t tag_of()
+    {
+        return index_of<T, Types...>::value;
+    }
+
+
+    /** @return tag of dynamic type of @c b or @c none if it is not in Types. */
+    template<class Base>
+    static std::size_t tag(Base const& b)
+    {
+        static std::type_info const* const ids[] = { &typeid(Types)... };
+
+        std::type_info const& id = typeid(b);
+
+        for (std::size_t i = 0; i < sizeof...(Types); ++i)
+        {
+            if (*ids[i] == id)
+            {
+                return i;
+            }
+        }
+
+        return none;
+    }
+
+
+    /** Calls @c f with @c b cast to its dynamic type. @return false if type is not in Types. */
+    template<class Base, class F>
+    static bool dispatch(Base& b, F&& f)
+    {
+        using thunk_type = void (*)(Base&, std::remove_reference_t<F>&);
+
+        static thunk_type const table[] = { &thunk<Types, Base, std::remove_reference_t<F>>... };
+
+        auto const t = tag(b);
+
+        if (t == none)
+        {
+            return false;
+        }
+
+        table[t](b, f);
+
+        return true;
+    }
+
+
+    /** @return @c b cast to @c T or nullptr if dynamic type of @c b is not exactly @c T. */
+    template<class T, class Base>
+    static T* cast(Base* b)
+    {
+        if ((nullptr == b) || (tag(*b) != tag_of<T>()))
+        {
+            return nullptr;
+        }
+
+        assert(dynamic_cast<T*>(b) == static_cast<T*>(b));
+
+        return static_cast<T*>(b);
+    }
+
+
+    /** Calls @c f with @c type_tag of each type, in order of tags. */
+    template<class F>
+    static void for_each(F&& f)
+    {
+        int dummy[sizeof...(Types)] = { (f(type_tag<Types>{}), 0)... };
+
+        (void) dummy;
+    }
+
+ private:
+
+    template<class T, class Base, class F>
+    static void thunk(Base& b, F& f)
+    {
+        assert(dynamic_cast<T*>(&b) == static_cast<T*>(&b));
+
+        f(static_cast<T&>(b));
+    }
+};
+
+template<class... Types>
+constexpr std::size_t TypeTags<Types...>::none;
+
+
 /**
  * Visitor type generator for types included in visitable_types.
  * Produces type-safe instance of Visitor per given Tag and a
  * type-list of Visitables (at least one). User shall derive
  * publicly from this type Visitor<Tag, Vs...> (tag can be the
  * name of the derived type), and inherit Visitor constructor.
- * Visitable types must be derived from VisitableWith<T> where
- * T is the name of the visitor. Do not pass references in
- * Visitables type-list.
+ * Visitables are either derived from VisitableWith<T> where
+ * T is the name of the visitor, or reached through dispatch()
+ * from their common base. Do not pass references in Visitables
+ * type-list.
  *
  * Example
  * @code
@@ -143,6 +283,20 @@ class Visitor
     }
 
 
+    using tags = TypeTags<Visitables...>;
+
+
+    /**
+     * Static dispatch on dynamic type of @c b, see TypeTags.
+     * @return false if type of @c b is not visitable.
+     */
+    template<class Base>
+    bool dispatch(Base& b)
+    {
+        return tags::dispatch(b, [this](auto& t) { (*this)(t); });
+    }
+
+
     template<class... Fs>
     Visitor(Fs&&... fs)
     {
@@ -0,0 +1,140 @@
+#include "busstatistics.h"
+#include "busstatistics_p.h"
+#include <log.h>
+
+constexpr int BusStatistics::kRefreshIntervalMs;
+
+BusStatistics::BusStatistics()
+    : d_ptr(new BusStatisticsPrivate(this))
+{
+}
+
+BusStatistics::BusStatistics(BusStatisticsCtx&& ctx)
+    : d_ptr(new BusStatisticsPrivate(this, std::move(ctx)))
+{
+}
+
+BusStatistics::~BusStatistics()
+{
+}
+
+void BusStatistics::startSimulation()
+{
+    Q_D(BusStatistics);
+
+    d->reset();
+    d->_refreshTimer.start();
+}
+
+void BusStatistics::stopSimulation()
+{
+    Q_D(BusStatistics);
+
+    d->_refreshTimer.stop();
+    d->flush();
+    d->refresh();
+}
+
+void BusStatistics::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(BusStatistics);
+
+    d->ingest(frames);
+}
+
+void BusStatistics::frameBatchSent(bool status, const CanFrameBatch& frames)
+{
+    Q_D(BusStatistics);
+
+    if (status) {
+        d->ingest(frames);
+    }
+}
+
+std::vector<FrameStatistics> BusStatistics::statistics() const
+{
+    return d_ptr->_table.snapshot();
+}
+
+quint64 BusStatistics::frameCount() const
+{
+    return d_ptr->_table.frameCount();
+}
+
+double BusStatistics::busLoad() const
+{
+    return d_ptr->_load;
+}
+
+void BusStatistics::setTxLatencySource(const QObject* device, TxLatencySource source)
+{
+    Q_D(BusStatistics);
+    auto& sources = d->_latencySources;
+
+    sources.erase(std::remove_if(sources.begin(), sources.end(),
+                      [device](const std::pair<const QObject*, TxLatencySource>& s) { return s.first == device; }),
+        sources.end());
+
+    if (source) {
+        sources.emplace_back(device, std::move(source));
+    }
+}
+
+std::vector<TxLatencyStats> BusStatistics::txLatency() const
+{
+    return d_ptr->txLatency();
+}
+
+QWidget* BusStatistics::getMainWidget()
+{
+    Q_D(BusStatistics);
+
+    return d->_ui.getMainWidget();
+}
+
+bool BusStatistics::mainWidgetCreated() const
+{
+    return d_ptr->_ui.isMainWidgetCreated();
+}
+
+void BusStatistics::setConfig(QJsonObject& json)
+{
+    Q_D(BusStatistics);
+
+    const auto readBitrate = [&json](const QString& key, quint32& bitrate) {
+        if (json.contains(key)) {
+            const int value = json[key].toInt();
+
+            if (value > 0) {
+                bitrate = static_cast<quint32>(value);
+            } else {
+                cds_warn("Invalid {} '{}', keeping {}", key.toStdString(), value, bitrate);
+            }
+        }
+    };
+
+    readBitrate("bitrate", d->_bitrate);
+    readBitrate("dataBitrate", d->_dataBitrate);
+    d->applyBitrates();
+}
+
+QJsonObject BusStatistics::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+void BusStatistics::setDockUndockClbk(const std::function<void()>& cb)
+{
+    Q_D(BusStatistics);
+
+    d->_ui.setDockUndockCbk(cb);
+}
+
+bool BusStatistics::mainWidgetDocked() const
+{
+    return d_ptr->docked;
+}
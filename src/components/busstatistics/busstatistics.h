@@ -0,0 +1,121 @@
+#ifndef BUSSTATISTICS_H
+#define BUSSTATISTICS_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <context.h>
+#include <functional>
+#include <txlatency.h>
+#include <vector>
+
+class BusStatisticsPrivate;
+struct FrameStatistics;
+class QWidget;
+
+/**
+*   @brief  Component collecting per (id, direction) frame count, cycle time, jitter and last payload, plus
+*           bus load estimate
+*
+*   Frames are accounted in background thread (see StatsTable), the component's thread only posts batches
+*   there. Statistics are read without locking, GUI is refreshed every kRefreshIntervalMs while simulation runs.
+*/
+class BusStatistics : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(BusStatistics)
+
+public:
+    static constexpr int kRefreshIntervalMs = 100;
+
+    /**
+    *   @brief  Provides per id transmit latency of a device, see CanDevice::txLatencyStats
+    */
+    typedef std::function<std::vector<TxLatencyStats>()> TxLatencySource;
+
+    BusStatistics();
+    explicit BusStatistics(BusStatisticsCtx&& ctx);
+    ~BusStatistics();
+
+    /**
+    *   @see ComponentInterface
+    */
+    QWidget* getMainWidget() override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    bool mainWidgetCreated() const override;
+
+    /**
+    *   @brief  Supported keys: bitrate, dataBitrate (bit/s, used for bus load estimate)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    void setDockUndockClbk(const std::function<void()>& cb) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    bool mainWidgetDocked() const override;
+
+    /**
+    *   @brief  Takes snapshot of statistics. Frames posted to background thread may not be accounted yet.
+    *   @return statistics in no particular order
+    */
+    std::vector<FrameStatistics> statistics() const;
+
+    /**
+    *   @return number of accounted frames, error frames excluded
+    */
+    quint64 frameCount() const;
+
+    /**
+    *   @return bus load in percent, as measured between the last two refreshes
+    */
+    double busLoad() const;
+
+    /**
+    *   @brief  Sets source of transmit latency shown with TX frames of device. Sources are queried on refresh.
+    *   @param  device device the latency belongs to
+    *   @param  source latency source, empty to remove
+    */
+    void setTxLatencySource(const QObject* device, TxLatencySource source);
+
+    /**
+    *   @return transmit latency per id, merged over all devices
+    */
+    std::vector<TxLatencyStats> txLatency() const;
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Frames that failed to be sent never occupied the bus, they are not accounted
+    */
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Waits until background thread accounted all frames, refreshes statistics
+    */
+    void stopSimulation(void) override;
+
+    /**
+    *   @brief  Resets statistics
+    */
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<BusStatisticsPrivate> d_ptr;
+};
+
+#endif // BUSSTATISTICS_H
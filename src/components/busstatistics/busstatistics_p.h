@@ -0,0 +1,194 @@
+#ifndef BUSSTATISTICS_P_H
+#define BUSSTATISTICS_P_H
+
+#include "busstatistics.h"
+#include "gui/bsgui.h"
+#include "statstable.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class BusStatisticsPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(BusStatistics)
+
+public:
+    BusStatisticsPrivate(BusStatistics* q, BusStatisticsCtx&& ctx = BusStatisticsCtx(new BSGui))
+        : _ctx(std::move(ctx))
+        , _ui(_ctx.get<BSGuiInterface>())
+        , q_ptr(q)
+    {
+        _ui.setDockUndockCbk([this] { docked = !docked; });
+
+        _refreshTimer.setInterval(BusStatistics::kRefreshIntervalMs);
+        connect(&_refreshTimer, &QTimer::timeout, this, &BusStatisticsPrivate::refresh);
+
+        // Table is written by this thread only
+        _ingestThread.setObjectName("BusStatistics");
+        _ingestContext = std::make_unique<QObject>();
+        _ingestContext->moveToThread(&_ingestThread);
+        _ingestThread.start();
+    }
+
+    ~BusStatisticsPrivate()
+    {
+        _ingestThread.quit();
+        _ingestThread.wait();
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["bitrate"] = static_cast<qint64>(_bitrate);
+        json["dataBitrate"] = static_cast<qint64>(_dataBitrate);
+    }
+
+    /**
+    *   @brief  Executes fn in ingest thread, after all work posted before
+    */
+    template <typename F> void post(F&& fn)
+    {
+        QTimer::singleShot(0, _ingestContext.get(), std::forward<F>(fn));
+    }
+
+    void ingest(const CanFrameBatch& frames)
+    {
+        if (!frames.isEmpty()) {
+            post([this, frames] { _table.update(frames); });
+        }
+    }
+
+    void applyBitrates()
+    {
+        const quint32 bitrate = _bitrate;
+        const quint32 dataBitrate = _dataBitrate;
+
+        post([this, bitrate, dataBitrate] { _table.setBitrates(bitrate, dataBitrate); });
+    }
+
+    void reset()
+    {
+        post([this] { _table.clear(); });
+        _lastCounts.clear();
+        _lastBusTime = 0;
+        _load = 0.0;
+        _elapsed.start();
+        _lastRefreshNs = 0;
+    }
+
+    /**
+    *   @brief  Blocks until ingest thread processed everything posted so far
+    */
+    void flush()
+    {
+        QSemaphore done;
+
+        post([&done] { done.release(); });
+        done.acquire();
+    }
+
+    static quint64 rowKey(const FrameStatistics& stats)
+    {
+        return (static_cast<quint64>(stats.flags) << 32) | stats.id;
+    }
+
+    void refresh()
+    {
+        const qint64 now = _elapsed.isValid() ? _elapsed.nsecsElapsed() : 0;
+        const qint64 interval = now - _lastRefreshNs;
+        const quint64 busTime = _table.busTimeNs();
+
+        // Counters may have been cleared by ingest thread since the last refresh
+        const quint64 busy = (busTime >= _lastBusTime) ? busTime - _lastBusTime : busTime;
+
+        if (interval > 0) {
+            _load = 100.0 * static_cast<double>(busy) / interval;
+        }
+        _lastBusTime = busTime;
+        _lastRefreshNs = now;
+
+        if (!_ui.isMainWidgetCreated()) {
+            return;
+        }
+
+        std::vector<StatisticsRow> rows;
+        QHash<quint64, quint64> counts;
+        QHash<quint64, Instrumentation::HistogramSnapshot> latency;
+
+        for (const auto& stats : txLatency()) {
+            const quint8 flags = FrameStatistics::Tx | (stats.extended ? FrameStatistics::Extended : 0);
+            latency.insert((static_cast<quint64>(flags) << 32) | stats.id, stats.totalUs);
+        }
+
+        for (const auto& stats : _table.snapshot()) {
+            const quint64 key = rowKey(stats);
+            const quint64 last = std::min(_lastCounts.value(key, stats.count), stats.count);
+
+            rows.push_back({ stats, (interval > 0) ? (stats.count - last) * 1e9 / interval : 0.0, latency.value(key) });
+            counts.insert(key, stats.count);
+        }
+        _lastCounts.swap(counts);
+
+        std::sort(rows.begin(), rows.end(), [](const StatisticsRow& a, const StatisticsRow& b) {
+            return (a.stats.id != b.stats.id) ? (a.stats.id < b.stats.id) : (a.stats.flags < b.stats.flags);
+        });
+
+        _ui.setStatistics(
+            rows, { _load, _table.frameCount(), _table.untrackedCount(), _table.errorFrameCount() });
+    }
+
+    /**
+    *   @brief  Queries latency sources, entries of the same id are merged
+    */
+    std::vector<TxLatencyStats> txLatency() const
+    {
+        std::vector<TxLatencyStats> result;
+        QHash<quint64, std::size_t> index;
+
+        for (const auto& source : _latencySources) {
+            for (const auto& stats : source.second()) {
+                const quint64 key = (static_cast<quint64>(stats.extended) << 32) | stats.id;
+                const auto it = index.constFind(key);
+
+                if (it == index.cend()) {
+                    index.insert(key, result.size());
+                    result.push_back(stats);
+                    continue;
+                }
+
+                auto& merged = result[it.value()];
+                merged.handoffUs.merge(stats.handoffUs);
+                merged.confirmUs.merge(stats.confirmUs);
+                merged.totalUs.merge(stats.totalUs);
+            }
+        }
+
+        return result;
+    }
+
+    BusStatisticsCtx _ctx;
+    BSGuiInterface& _ui;
+    bool docked{ true };
+    quint32 _bitrate{ StatsTable::kDefaultBitrate };
+    quint32 _dataBitrate{ StatsTable::kDefaultDataBitrate };
+    StatsTable _table;
+    QThread _ingestThread;
+    std::unique_ptr<QObject> _ingestContext;
+    QTimer _refreshTimer;
+    QElapsedTimer _elapsed;
+    qint64 _lastRefreshNs{ 0 };
+    quint64 _lastBusTime{ 0 };
+    QHash<quint64, quint64> _lastCounts;
+    double _load{ 0.0 };
+    std::vector<std::pair<const QObject*, BusStatistics::TxLatencySource>> _latencySources;
+
+private:
+    BusStatistics* q_ptr;
+};
+
+#endif // BUSSTATISTICS_P_H
@@ -0,0 +1,107 @@
+#ifndef BSGUI_H
+#define BSGUI_H
+
+#include "bsguiinterface.h"
+#include "statisticsmodel.h"
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QTableView>
+#include <QtWidgets/QVBoxLayout>
+#include <functional>
+#include <vector>
+
+/**
+*   @brief  Widget implementation of BSGuiInterface
+*
+*   As with CRVGui, widgets are built on first getMainWidget() call and calls made before are recorded.
+*/
+struct BSGui : public BSGuiInterface {
+
+    BSGui() = default;
+
+    virtual void setDockUndockCbk(const dockUndock_t& cb) override
+    {
+        apply([this, cb] { QObject::connect(_pbDockUndock, &QPushButton::toggled, cb); });
+    }
+
+    virtual QWidget* getMainWidget() override
+    {
+        if (!_widget) {
+            build();
+        }
+
+        return _widget;
+    }
+
+    virtual bool isMainWidgetCreated() override
+    {
+        return _widget != nullptr;
+    }
+
+    virtual void setStatistics(const std::vector<StatisticsRow>& rows, const BusSummary& summary) override
+    {
+        if (!_widget) {
+            return;
+        }
+
+        _model->setRows(rows);
+        _summary->setText(QString("Bus load: %1 %   Frames: %2   Untracked: %3   Error frames: %4")
+                              .arg(summary.load, 0, 'f', 1)
+                              .arg(summary.frames)
+                              .arg(summary.untracked)
+                              .arg(summary.errorFrames));
+    }
+
+private:
+    void apply(std::function<void()>&& action)
+    {
+        if (_widget) {
+            action();
+        } else {
+            _pending.push_back(std::move(action));
+        }
+    }
+
+    void build()
+    {
+        _widget = new QWidget;
+        _widget->setWindowTitle("BusStatistics");
+        _widget->resize(700, 300);
+
+        auto layout = new QVBoxLayout(_widget);
+        auto toolbar = new QHBoxLayout;
+        _summary = new QLabel;
+        _pbDockUndock = new QPushButton("Undock");
+        _pbDockUndock->setCheckable(true);
+        toolbar->addWidget(_summary);
+        toolbar->addStretch();
+        toolbar->addWidget(_pbDockUndock);
+        layout->addLayout(toolbar);
+
+        _model = new StatisticsModel(_widget);
+        _table = new QTableView;
+        _table->setModel(_model);
+        _table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        _table->verticalHeader()->hide();
+        _table->horizontalHeader()->setStretchLastSection(true);
+        // Rows are refreshed several times per second, resizing to contents would scan them all every time
+        _table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        layout->addWidget(_table, 1);
+
+        for (auto& action : _pending) {
+            action();
+        }
+        _pending.clear();
+    }
+
+    QWidget* _widget{ nullptr };
+    QLabel* _summary{ nullptr };
+    QPushButton* _pbDockUndock{ nullptr };
+    QTableView* _table{ nullptr };
+    StatisticsModel* _model{ nullptr };
+    std::vector<std::function<void()>> _pending;
+};
+
+#endif // BSGUI_H
@@ -0,0 +1,51 @@
+#ifndef BSGUIINTERFACE_H
+#define BSGUIINTERFACE_H
+
+#include <QtCore/QtGlobal>
+#include <functional>
+#include <instrumentation.h>
+#include <statstable.h>
+#include <vector>
+
+class QWidget;
+
+/**
+*   @brief  Statistics of one (id, direction) pair as presented by GUI
+*/
+struct StatisticsRow {
+    FrameStatistics stats;
+    double rate; // frames per second since previous refresh
+    Instrumentation::HistogramSnapshot latencyUs; // request to confirmation of TX frames, empty if not known
+};
+
+/**
+*   @brief  Statistics of the whole bus
+*/
+struct BusSummary {
+    double load; // percent of time bus was occupied since previous refresh
+    quint64 frames;
+    quint64 untracked;
+    quint64 errorFrames;
+};
+
+struct BSGuiInterface {
+    typedef std::function<void()> dockUndock_t;
+
+    virtual void setDockUndockCbk(const dockUndock_t& cb) = 0;
+
+    virtual ~BSGuiInterface()
+    {
+    }
+
+    virtual QWidget* getMainWidget() = 0;
+    virtual bool isMainWidgetCreated() = 0;
+
+    /**
+    *   @brief  Shows statistics. Called periodically while simulation runs and main widget exists.
+    *   @param  rows statistics sorted by id and direction
+    *   @param  summary bus statistics
+    */
+    virtual void setStatistics(const std::vector<StatisticsRow>& rows, const BusSummary& summary) = 0;
+};
+
+#endif // BSGUIINTERFACE_H
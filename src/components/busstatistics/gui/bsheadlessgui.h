@@ -0,0 +1,29 @@
+#ifndef BSHEADLESSGUI_H
+#define BSHEADLESSGUI_H
+
+#include "bsguiinterface.h"
+
+/**
+*   @brief  No-op implementation of BSGuiInterface for running without display. Statistics are still collected.
+*/
+struct BSHeadlessGui : public BSGuiInterface {
+    void setDockUndockCbk(const dockUndock_t&) override
+    {
+    }
+
+    QWidget* getMainWidget() override
+    {
+        return nullptr;
+    }
+
+    bool isMainWidgetCreated() override
+    {
+        return false;
+    }
+
+    void setStatistics(const std::vector<StatisticsRow>&, const BusSummary&) override
+    {
+    }
+};
+
+#endif // BSHEADLESSGUI_H
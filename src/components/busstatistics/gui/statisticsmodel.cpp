@@ -0,0 +1,104 @@
+#include "statisticsmodel.h"
+#include <algorithm>
+#include <hexformat.h>
+
+namespace {
+const char* const kHeaderLabels[StatisticsModel::ColumnCount] = { "id", "dir", "count", "rate [1/s]", "min [ms]",
+    "avg [ms]", "max [ms]", "jitter p99 [ms]", "tx latency p50 [ms]", "tx latency p99 [ms]", "tx latency max [ms]",
+    "dlc", "data" };
+
+QVariant milliseconds(double us)
+{
+    return QString::number(us / 1000.0, 'f', 3);
+}
+
+bool sameKey(const StatisticsRow& a, const StatisticsRow& b)
+{
+    return (a.stats.id == b.stats.id) && (a.stats.flags == b.stats.flags);
+}
+} // namespace
+
+StatisticsModel::StatisticsModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int StatisticsModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(_rows.size());
+}
+
+int StatisticsModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant StatisticsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (index.row() >= rowCount()) || (role != Qt::DisplayRole)) {
+        return {};
+    }
+
+    const StatisticsRow& row = _rows[index.row()];
+    const FrameStatistics& stats = row.stats;
+    const bool cycles = stats.count > 1;
+    const bool latency = row.latencyUs.count > 0;
+
+    switch (index.column()) {
+    case Id:
+        return QString("0x" + QString::number(stats.id, 16));
+    case Dir:
+        return QString((stats.direction() == Direction::TX) ? "TX" : "RX");
+    case Count:
+        return static_cast<qulonglong>(stats.count);
+    case Rate:
+        return QString::number(row.rate, 'f', 1);
+    case MinCycle:
+        return cycles ? milliseconds(stats.minCycle) : QVariant();
+    case AvgCycle:
+        return cycles ? milliseconds(stats.avgCycle()) : QVariant();
+    case MaxCycle:
+        return cycles ? milliseconds(stats.maxCycle) : QVariant();
+    case Jitter:
+        return (stats.count > 2) ? milliseconds(stats.jitterPercentile(0.99)) : QVariant();
+    case LatencyP50:
+        return latency ? milliseconds(row.latencyUs.percentile(0.5)) : QVariant();
+    case LatencyP99:
+        return latency ? milliseconds(row.latencyUs.percentile(0.99)) : QVariant();
+    case LatencyMax:
+        return latency ? milliseconds(row.latencyUs.max) : QVariant();
+    case Dlc:
+        return static_cast<int>(stats.length);
+    case Data:
+        return HexFormat::payloadToHex(stats.payload, stats.length);
+    default:
+        return {};
+    }
+}
+
+QVariant StatisticsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) && (section >= 0) && (section < ColumnCount)) {
+        return QString(kHeaderLabels[section]);
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void StatisticsModel::setRows(const std::vector<StatisticsRow>& rows)
+{
+    const bool sameRows = (rows.size() == _rows.size()) && std::equal(rows.begin(), rows.end(), _rows.begin(), sameKey);
+
+    if (!sameRows) {
+        beginResetModel();
+        _rows = rows;
+        endResetModel();
+
+        return;
+    }
+
+    _rows = rows;
+    if (!_rows.empty()) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, ColumnCount - 1), { Qt::DisplayRole });
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef STATISTICSMODEL_H
+#define STATISTICSMODEL_H
+
+#include "bsguiinterface.h"
+#include <QtCore/QAbstractTableModel>
+#include <vector>
+
+/**
+*   @brief  Table model presenting per (id, direction) statistics
+*
+*   Rows are replaced as a whole on every refresh. As long as set of rows does not change only dataChanged is
+*   emitted, so selection and scroll position survive periodic updates.
+*/
+class StatisticsModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+    *   @brief  Columns order
+    */
+    enum Column {
+        Id = 0,
+        Dir,
+        Count,
+        Rate,
+        MinCycle,
+        AvgCycle,
+        MaxCycle,
+        Jitter,
+        LatencyP50,
+        LatencyP99,
+        LatencyMax,
+        Dlc,
+        Data,
+        ColumnCount
+    };
+
+    explicit StatisticsModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+    *   @param  rows new contents, sorted by id and direction
+    */
+    void setRows(const std::vector<StatisticsRow>& rows);
+
+private:
+    std::vector<StatisticsRow> _rows;
+};
+
+#endif // STATISTICSMODEL_H
@@ -0,0 +1,261 @@
+#include "statstable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+constexpr int FrameStatistics::kJitterBins;
+constexpr std::size_t StatsTable::kDefaultCapacity;
+constexpr quint32 StatsTable::kDefaultBitrate;
+constexpr quint32 StatsTable::kDefaultDataBitrate;
+constexpr quint32 StatsTable::kEmptyKey;
+constexpr std::size_t StatsTable::kWords;
+
+quint64 FrameStatistics::jitterPercentile(double fraction) const
+{
+    quint64 total = 0;
+
+    for (auto n : jitter) {
+        total += n;
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    const auto target = static_cast<quint64>(fraction * total);
+    quint64 seen = 0;
+
+    for (int bin = 0; bin < kJitterBins; ++bin) {
+        seen += jitter[bin];
+
+        if (seen > target || (seen == total)) {
+            return (bin == 0) ? 0 : (1ULL << bin);
+        }
+    }
+
+    return 1ULL << kJitterBins;
+}
+
+int FrameStatistics::jitterBin(quint64 deviation)
+{
+    int bin = 0;
+
+    while ((deviation != 0) && (bin < kJitterBins - 1)) {
+        deviation >>= 1;
+        ++bin;
+    }
+
+    return bin;
+}
+
+StatsTable::StatsTable(std::size_t capacity)
+    : _mask(roundUpPow2(std::max<std::size_t>(capacity, 4)) - 1)
+    , _maxEntries((_mask + 1) / 4 * 3)
+    , _slots(new Slot[_mask + 1])
+    , _keys(_mask + 1, kEmptyKey)
+    , _entries(_mask + 1)
+{
+    for (std::size_t i = 0; i <= _mask; ++i) {
+        for (auto& word : _slots[i].words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    _used.reserve(_maxEntries);
+}
+
+StatsTable::~StatsTable()
+{
+}
+
+void StatsTable::setBitrates(quint32 bitrate, quint32 dataBitrate)
+{
+    _bitrate = bitrate;
+    _dataBitrate = dataBitrate;
+}
+
+void StatsTable::update(const CanFrameRecord* records, std::size_t count)
+{
+    quint64 busTime = 0;
+    quint64 untracked = 0;
+    quint64 errors = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const CanFrameRecord& rec = records[i];
+
+        if (rec.hasFlag(CanFrameRecord::Error)) {
+            // Error frames carry error class in their id, they do not belong to any message
+            ++errors;
+            continue;
+        }
+
+        busTime += frameBusTimeNs(rec, _bitrate, _dataBitrate);
+
+        const std::size_t slot = findSlot(makeKey(rec));
+        if (slot > _mask) {
+            ++untracked;
+            continue;
+        }
+
+        account(_entries[slot], rec);
+        publish(slot);
+    }
+
+    _frames.fetch_add(count - errors, std::memory_order_relaxed);
+    _untracked.fetch_add(untracked, std::memory_order_relaxed);
+    _errorFrames.fetch_add(errors, std::memory_order_relaxed);
+    _busTimeNs.fetch_add(busTime, std::memory_order_relaxed);
+}
+
+void StatsTable::clear()
+{
+    for (auto slot : _used) {
+        _keys[slot] = kEmptyKey;
+        std::memset(&_entries[slot], 0, sizeof(FrameStatistics));
+        publish(slot);
+    }
+    _used.clear();
+
+    _frames.store(0, std::memory_order_relaxed);
+    _untracked.store(0, std::memory_order_relaxed);
+    _errorFrames.store(0, std::memory_order_relaxed);
+    _busTimeNs.store(0, std::memory_order_relaxed);
+}
+
+std::vector<FrameStatistics> StatsTable::snapshot() const
+{
+    std::vector<FrameStatistics> result;
+    quint64 words[kWords];
+
+    for (std::size_t i = 0; i <= _mask; ++i) {
+        const Slot& slot = _slots[i];
+
+        // Slot never written
+        if (slot.seq.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        quint64 before;
+        quint64 after;
+        do {
+            before = slot.seq.load(std::memory_order_acquire);
+            for (std::size_t w = 0; w < kWords; ++w) {
+                words[w] = slot.words[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = slot.seq.load(std::memory_order_relaxed);
+        } while ((before != after) || (before & 1));
+
+        FrameStatistics entry;
+        std::memcpy(&entry, words, sizeof(entry));
+
+        // Slot emptied by clear()
+        if (entry.count != 0) {
+            result.push_back(entry);
+        }
+    }
+
+    return result;
+}
+
+quint64 StatsTable::frameCount() const
+{
+    return _frames.load(std::memory_order_relaxed);
+}
+
+quint64 StatsTable::untrackedCount() const
+{
+    return _untracked.load(std::memory_order_relaxed);
+}
+
+quint64 StatsTable::errorFrameCount() const
+{
+    return _errorFrames.load(std::memory_order_relaxed);
+}
+
+quint64 StatsTable::busTimeNs() const
+{
+    return _busTimeNs.load(std::memory_order_relaxed);
+}
+
+std::size_t StatsTable::capacity() const
+{
+    return _mask + 1;
+}
+
+quint32 StatsTable::makeKey(const CanFrameRecord& rec)
+{
+    // 29 id bits, so key never equals kEmptyKey
+    return (rec.id & 0x1fffffff) | (rec.hasFlag(CanFrameRecord::ExtendedId) ? (1u << 29) : 0)
+        | (rec.hasFlag(CanFrameRecord::Tx) ? (1u << 30) : 0);
+}
+
+std::size_t StatsTable::findSlot(quint32 key)
+{
+    // Fibonacci hashing spreads consecutive ids, linear probing keeps probes within few cache lines
+    std::size_t slot = static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ULL) >> 32) & _mask;
+
+    while (_keys[slot] != key) {
+        if (_keys[slot] == kEmptyKey) {
+            if (_used.size() >= _maxEntries) {
+                return _mask + 1;
+            }
+
+            FrameStatistics& entry = _entries[slot];
+            _keys[slot] = key;
+            entry.id = key & 0x1fffffff;
+            entry.flags = ((key & (1u << 29)) ? FrameStatistics::Extended : 0)
+                | ((key & (1u << 30)) ? FrameStatistics::Tx : 0);
+            _used.push_back(slot);
+
+            break;
+        }
+
+        slot = (slot + 1) & _mask;
+    }
+
+    return slot;
+}
+
+void StatsTable::account(FrameStatistics& entry, const CanFrameRecord& rec)
+{
+    if (entry.count > 0) {
+        const quint64 cycle = (rec.timestamp > entry.lastTimestamp) ? rec.timestamp - entry.lastTimestamp : 0;
+
+        if (entry.count > 1) {
+            const auto mean = static_cast<qint64>(entry.cycleSum / (entry.count - 1));
+            const auto deviation = static_cast<quint64>(std::abs(static_cast<qint64>(cycle) - mean));
+
+            ++entry.jitter[FrameStatistics::jitterBin(deviation)];
+            entry.minCycle = std::min(entry.minCycle, cycle);
+            entry.maxCycle = std::max(entry.maxCycle, cycle);
+        } else {
+            entry.minCycle = cycle;
+            entry.maxCycle = cycle;
+        }
+
+        entry.cycleSum += cycle;
+    }
+
+    ++entry.count;
+    entry.lastTimestamp = rec.timestamp;
+    entry.length = rec.length;
+    std::memcpy(entry.payload, rec.payload, sizeof(entry.payload));
+}
+
+void StatsTable::publish(std::size_t index)
+{
+    Slot& slot = _slots[index];
+    quint64 words[kWords];
+    const quint64 seq = slot.seq.load(std::memory_order_relaxed);
+
+    std::memcpy(words, &_entries[index], sizeof(words));
+
+    // Odd sequence marks slot being written, readers retry until it is even again
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t w = 0; w < kWords; ++w) {
+        slot.words[w].store(words[w], std::memory_order_relaxed);
+    }
+    slot.seq.store(seq + 2, std::memory_order_release);
+}
@@ -0,0 +1,163 @@
+#ifndef STATSTABLE_H
+#define STATSTABLE_H
+
+#include <QtCore/QtGlobal>
+#include <array>
+#include <atomic>
+#include <canbustiming.h>
+#include <canframerecord.h>
+#include <memory>
+#include <ringbuffer.h>
+#include <type_traits>
+#include <vector>
+
+/**
+*   @brief  Statistics of one (id, direction) pair. Times are in microseconds.
+*/
+struct FrameStatistics {
+    static constexpr int kJitterBins = 16;
+
+    enum Flags : quint8 { Extended = 0x01, Tx = 0x02 };
+
+    quint32 id;
+    quint8 flags;
+    quint8 length; // length of the last payload
+    quint16 reserved;
+    quint64 count;
+    quint64 lastTimestamp;
+    quint64 minCycle;
+    quint64 maxCycle;
+    quint64 cycleSum; // sum of count - 1 cycles
+    // Deviation of cycle from mean cycle. Bin 0 holds exact hits, bin k > 0 holds [2^(k-1), 2^k) us, the last
+    // bin everything above.
+    std::array<quint32, kJitterBins> jitter;
+    quint8 payload[CanFrameRecord::kMaxPayload]; // last payload
+
+    bool extended() const
+    {
+        return (flags & Extended) != 0;
+    }
+
+    Direction direction() const
+    {
+        return (flags & Tx) ? Direction::TX : Direction::RX;
+    }
+
+    /**
+    *   @return mean cycle time, 0 if less than two frames were seen
+    */
+    double avgCycle() const
+    {
+        return (count > 1) ? static_cast<double>(cycleSum) / (count - 1) : 0.0;
+    }
+
+    /**
+    *   @brief  Estimates jitter percentile from histogram
+    *   @param  fraction percentile as fraction, e.g. 0.99
+    *   @return upper bound of bin containing the percentile in microseconds, 0 if no cycle was binned
+    */
+    quint64 jitterPercentile(double fraction) const;
+
+    /**
+    *   @return jitter bin of absolute cycle deviation
+    */
+    static int jitterBin(quint64 deviation);
+};
+
+static_assert(std::is_trivially_copyable<FrameStatistics>::value, "FrameStatistics must be trivially copyable");
+static_assert(sizeof(FrameStatistics) % sizeof(quint64) == 0, "FrameStatistics must consist of whole words");
+
+/**
+*   @brief  Per (id, direction) frame statistics shared between single writer and any number of readers
+*
+*   Entries live in dense open-addressing table of fixed capacity, so update never allocates. Each slot is guarded
+*   by sequence lock: writer keeps private copy of every entry, updates it and publishes it to the slot, readers
+*   copy slot and retry if sequence changed meanwhile. Writer never waits for readers, so e.g. GUI can take
+*   snapshots at any rate without slowing down ingest. Frames of pairs that do not fit into the table are
+*   only counted.
+*/
+class StatsTable {
+public:
+    static constexpr std::size_t kDefaultCapacity = 8192;
+    static constexpr quint32 kDefaultBitrate = 500000;
+    static constexpr quint32 kDefaultDataBitrate = 2000000;
+
+    /**
+    *   @param  capacity number of slots, rounded up to power of two. Up to 3/4 of slots are used.
+    */
+    explicit StatsTable(std::size_t capacity = kDefaultCapacity);
+    ~StatsTable();
+
+    StatsTable(const StatsTable&) = delete;
+    StatsTable& operator=(const StatsTable&) = delete;
+
+    /**
+    *   @brief  Sets bitrates used for bus load estimate. Writer side only.
+    */
+    void setBitrates(quint32 bitrate, quint32 dataBitrate);
+
+    /**
+    *   @brief  Accounts frames. Writer side only.
+    *   @param  records frames in time order
+    *   @param  count number of frames
+    */
+    void update(const CanFrameRecord* records, std::size_t count);
+
+    void update(const CanFrameBatch& records)
+    {
+        update(records.constData(), static_cast<std::size_t>(records.size()));
+    }
+
+    /**
+    *   @brief  Removes all entries and resets counters. Writer side only.
+    */
+    void clear();
+
+    /**
+    *   @brief  Copies all entries. Safe to call from any thread concurrently with writer.
+    *   @return entries in no particular order
+    */
+    std::vector<FrameStatistics> snapshot() const;
+
+    /**
+    *   @brief  Counters below are safe to read from any thread
+    */
+    quint64 frameCount() const;
+    quint64 untrackedCount() const; // frames of pairs that did not fit into table
+    quint64 errorFrameCount() const;
+    quint64 busTimeNs() const; // bus occupancy of all frames
+
+    std::size_t capacity() const;
+
+private:
+    static constexpr quint32 kEmptyKey = 0xffffffff;
+    static constexpr std::size_t kWords = sizeof(FrameStatistics) / sizeof(quint64);
+
+    struct Slot {
+        std::atomic<quint64> seq{ 0 };
+        std::atomic<quint64> words[kWords];
+    };
+
+    static quint32 makeKey(const CanFrameRecord& rec);
+    std::size_t findSlot(quint32 key);
+    void account(FrameStatistics& entry, const CanFrameRecord& rec);
+    void publish(std::size_t slot);
+
+    const std::size_t _mask;
+    const std::size_t _maxEntries;
+    std::unique_ptr<Slot[]> _slots;
+
+    // Writer only
+    std::vector<quint32> _keys;
+    std::vector<FrameStatistics> _entries;
+    std::vector<std::size_t> _used;
+    quint32 _bitrate{ kDefaultBitrate };
+    quint32 _dataBitrate{ kDefaultDataBitrate };
+
+    std::atomic<quint64> _frames{ 0 };
+    std::atomic<quint64> _untracked{ 0 };
+    std::atomic<quint64> _errorFrames{ 0 };
+    std::atomic<quint64> _busTimeNs{ 0 };
+};
+
+#endif // STATSTABLE_H
@@ -0,0 +1,131 @@
+#include "canbackendcatalog.h"
+#include "syntheticcanbusdevice.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtSerialBus/QCanBus>
+#include <chrono>
+#include <future>
+#include <log.h>
+#include <mutex>
+
+#ifdef Q_OS_LINUX
+#include "nativesocketcanbusdevice.h"
+#endif
+
+namespace {
+using Backends = QVector<CanBackendCatalog::Backend>;
+
+std::mutex& discoveryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::shared_future<Backends>& discovery()
+{
+    static std::shared_future<Backends> future;
+    return future;
+}
+
+Backends discover()
+{
+    QElapsedTimer timer;
+    Backends backends;
+
+    timer.start();
+    backends.append({ SyntheticCanBusDevice::kBackendName, {} });
+
+    // First use of QCanBus loads plugins, that is the slow part
+    QCanBus* bus = QCanBus::instance();
+    QStringList socketCanInterfaces;
+
+    for (const auto& plugin : bus->plugins()) {
+        CanBackendCatalog::Backend backend{ QString(plugin), {} };
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+        QString error;
+
+        for (const auto& info : bus->availableDevices(backend.name, &error)) {
+            backend.interfaces.append(info.name());
+        }
+
+        if (!error.isEmpty()) {
+            cds_debug(
+                "Devices of CAN backend '{}' not enumerated: {}", backend.name.toStdString(), error.toStdString());
+        }
+#endif
+
+        if (backend.name == "socketcan") {
+            socketCanInterfaces = backend.interfaces;
+        }
+
+        backends.append(backend);
+    }
+
+#ifdef Q_OS_LINUX
+    // Uses the same interfaces as socketcan plugin
+    backends.insert(1, { NativeSocketCanBusDevice::kBackendName, socketCanInterfaces });
+#endif
+
+    // Bus was created in this thread, which ends now
+    if (QCoreApplication::instance() && (bus->thread() == QThread::currentThread())) {
+        bus->moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    cds_info("Found {} CAN backends in {} ms", backends.size(), timer.elapsed());
+
+    return backends;
+}
+
+std::shared_future<Backends> startDiscovery()
+{
+    std::lock_guard<std::mutex> lock(discoveryMutex());
+    auto& future = discovery();
+
+    if (!future.valid()) {
+        future = std::async(std::launch::async, discover).share();
+    }
+
+    return future;
+}
+} // namespace
+
+void CanBackendCatalog::prefetch()
+{
+    startDiscovery();
+}
+
+bool CanBackendCatalog::isReady()
+{
+    std::lock_guard<std::mutex> lock(discoveryMutex());
+    const auto& future = discovery();
+
+    return future.valid() && (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+qint64 CanBackendCatalog::waitUntilReady()
+{
+    QElapsedTimer timer;
+
+    timer.start();
+    startDiscovery().wait();
+
+    return timer.elapsed();
+}
+
+QVector<CanBackendCatalog::Backend> CanBackendCatalog::backends()
+{
+    return startDiscovery().get();
+}
+
+QStringList CanBackendCatalog::interfaces(const QString& backend)
+{
+    for (const auto& known : backends()) {
+        if (known.name == backend) {
+            return known.interfaces;
+        }
+    }
+
+    return {};
+}
@@ -0,0 +1,51 @@
+#ifndef CANBACKENDCATALOG_H
+#define CANBACKENDCATALOG_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/**
+*   @brief  Cached list of CAN backends and their interfaces
+*
+*   Loading QtSerialBus plugins and enumerating their devices scans plugin directories and may wait for drivers,
+*   so it is done once, in background thread started with prefetch() early at application start. Creating device
+*   of plugin backend waits for discovery to complete, so that plugins are never loaded twice or concurrently.
+*   Built-in backends (synthetic, nativesocketcan) do not need plugins and never wait.
+*/
+class CanBackendCatalog {
+public:
+    struct Backend {
+        QString name;
+        QStringList interfaces; // empty if backend cannot enumerate its devices
+    };
+
+    /**
+    *   @brief  Starts discovery in background thread. Nothing happens if it was started already.
+    */
+    static void prefetch();
+
+    /**
+    *   @return true if discovery has completed, i.e. backends() does not block
+    */
+    static bool isReady();
+
+    /**
+    *   @brief  Blocks until discovery (started now if it was not) completes
+    *   @return time spent waiting in milliseconds
+    */
+    static qint64 waitUntilReady();
+
+    /**
+    *   @return backends, built-in ones first. Blocks until discovery completes.
+    */
+    static QVector<Backend> backends();
+
+    /**
+    *   @return interfaces of backend found by discovery, empty if backend is not known. Blocks until discovery
+    *           completes.
+    */
+    static QStringList interfaces(const QString& backend);
+};
+
+#endif // CANBACKENDCATALOG_H
@@ -1,6 +1,10 @@
 #include "candevice.h"
 #include "candevice_p.h"
+#include <QtCore/QMetaMethod>
 #include <QtCore/QQueue>
+#include <QtCore/QThread>
+#include <algorithm>
+#include <instrumentation.h>
 
 CanDevice::CanDevice()
     : d_ptr(new CanDevicePrivate())
@@ -14,19 +18,42 @@ CanDevice::CanDevice(CanDeviceCtx&& ctx)
 
 CanDevice::~CanDevice()
 {
+    Q_D(CanDevice);
+
+    // Make sure that I/O thread does not call back into partially destroyed object
+    d->stopIoThread();
 }
 
-bool CanDevice::init(const QString& backend, const QString& interface)
+bool CanDevice::init(const QString& backend, const QString& interface, bool ioThread)
 {
     Q_D(CanDevice);
     QString errorString;
 
     d->_initialized = false;
+    d->_configDirty = false;
+    d->_filtersInstalled = false;
+    d->_config["backend"] = backend;
+    d->_config["interface"] = interface;
+    d->_config["ioThread"] = ioThread;
+
+    // Device must not be recreated while I/O thread is still using it
+    d->stopIoThread();
 
     if (d->_canDevice.init(backend, interface)) {
-        d->_canDevice.setFramesWrittenCbk(std::bind(&CanDevice::framesWritten, this, std::placeholders::_1));
-        d->_canDevice.setFramesReceivedCbk(std::bind(&CanDevice::framesReceived, this));
-        d->_canDevice.setErrorOccurredCbk(std::bind(&CanDevice::errorOccurred, this, std::placeholders::_1));
+        if (ioThread) {
+            // Callbacks are executed in I/O thread. Received frames are passed via lock-free queue, send results
+            // are correlated with send queue in I/O thread and forwarded to the thread owning CanDevice.
+            d->_canDevice.setFramesWrittenCbk(std::bind(&CanDevice::framesWritten, this, std::placeholders::_1));
+            d->_canDevice.setFramesReceivedCbk(std::bind(&CanDevice::framesReceived, this));
+            d->_canDevice.setErrorOccurredCbk(std::bind(&CanDevice::errorOccurred, this, std::placeholders::_1));
+
+            connect(&d->_drainTimer, &QTimer::timeout, this, &CanDevice::drainRxQueue, Qt::UniqueConnection);
+            d->startIoThread();
+        } else {
+            d->_canDevice.setFramesWrittenCbk(std::bind(&CanDevice::framesWritten, this, std::placeholders::_1));
+            d->_canDevice.setFramesReceivedCbk(std::bind(&CanDevice::framesReceived, this));
+            d->_canDevice.setErrorOccurredCbk(std::bind(&CanDevice::errorOccurred, this, std::placeholders::_1));
+        }
 
         d->_initialized = true;
     }
@@ -35,23 +62,219 @@ bool CanDevice::init(const QString& backend, const QString& interface)
 }
 
 void CanDevice::sendFrame(const QCanBusFrame& frame)
+{
+    sendFrames({ frame });
+}
+
+void CanDevice::sendFrames(const QVector<QCanBusFrame>& frames)
 {
     Q_D(CanDevice);
-    bool status = false;
 
-    if (!d->_initialized) {
+    if (!d->_initialized || frames.isEmpty()) {
+        return;
+    }
+
+    // Latency of frame is measured from here, including handover to I/O thread
+    const quint64 requestUs = canTimestampNow();
+
+    if (d->_ioThreaded) {
+        if (QThread::currentThread() == d->_ioContext->thread()) {
+            // Called from I/O thread (e.g. by Gateway routing frames of another device), written at once
+            transmit(frames, requestUs);
+        } else {
+            // Send queue is owned by I/O thread. Batches are written there in order of sendFrames calls.
+            QTimer::singleShot(0, d->_ioContext.get(), [this, frames, requestUs] { transmit(frames, requestUs); });
+        }
+
+        return;
+    }
+
+    transmit(frames, requestUs);
+}
+
+void CanDevice::transmit(const QVector<QCanBusFrame>& frames, quint64 requestUs)
+{
+    Q_D(CanDevice);
+    auto& queue = d->_sendQueue;
+
+    Instrumentation::add(Instrumentation::Counter::TxRequested, frames.size());
+
+    if (d->_txQueueEnabled) {
+        enqueue(frames, requestUs);
+        return;
+    }
+
+    // Success will be reported in framesWritten signal. Sending may be buffered, so frames are queued before
+    // write to keep correlation between sending results and frames. Frames that do not fit are rejected.
+    const int room = static_cast<int>(std::min<std::size_t>(frames.size(), queue.capacity() - queue.size()));
+    const quint64 handoffUs = canTimestampNow();
+
+    for (int i = 0; i < room; ++i) {
+        queue.push(frames[i]);
+        d->_sendTimes.push(TxTiming{ requestUs, handoffUs });
+    }
+
+    qint64 accepted = 0;
+
+    if (room == 1) {
+        accepted = d->_canDevice.writeFrame(frames.first()) ? 1 : 0;
+    } else if (room > 1) {
+        accepted = d->_canDevice.writeFrames((room == frames.size()) ? frames : frames.mid(0, room));
+    }
+
+    Instrumentation::record(Instrumentation::Histogram::SendQueueDepth, queue.size());
+
+    if (accepted < frames.size()) {
+        if (room < frames.size()) {
+            cds_warn("Send queue full, {} frames rejected", frames.size() - room);
+            Instrumentation::add(Instrumentation::Counter::TxQueueFull, frames.size() - room);
+        }
+
+        // Frames not accepted by backend are the last ones queued
+        queue.dropBack(static_cast<std::size_t>(room - accepted));
+        d->_sendTimes.dropBack(static_cast<std::size_t>(room - accepted));
+        deliverFramesSent(false, frames.mid(static_cast<int>(accepted)));
+    }
+}
+
+void CanDevice::enqueue(const QVector<QCanBusFrame>& frames, quint64 requestUs)
+{
+    Q_D(CanDevice);
+    const quint64 now = canTimestampNow();
+    QVector<QCanBusFrame> rejected;
+
+    for (const auto& frame : frames) {
+        if (!d->_txQueue.push(frame, now, requestUs)) {
+            rejected.append(frame);
+        }
+    }
+
+    if (!rejected.isEmpty()) {
+        cds_warn("Transmit queue full, {} frames rejected", rejected.size());
+        Instrumentation::add(Instrumentation::Counter::TxQueueFull, rejected.size());
+        deliverFramesSent(false, rejected);
+    }
+
+    serviceTxQueue();
+}
+
+void CanDevice::serviceTxQueue()
+{
+    Q_D(CanDevice);
+
+    // Backend may confirm frames synchronously from within write, queue is serviced again once write returns
+    if (d->_txServicing) {
+        d->_txServiceAgain = true;
+        return;
+    }
+
+    d->_txServicing = true;
+
+    do {
+        d->_txServiceAgain = false;
+
+        const quint64 now = canTimestampNow();
+        const QVector<QCanBusFrame> stale = d->_txQueue.dropStale(now);
+
+        if (!stale.isEmpty()) {
+            Instrumentation::add(Instrumentation::Counter::TxStale, stale.size());
+            deliverFramesSent(false, stale);
+        }
+
+        writeTxQueue(now);
+    } while (d->_txServiceAgain);
+
+    d->_txServicing = false;
+}
+
+void CanDevice::writeTxQueue(quint64 nowUs)
+{
+    Q_D(CanDevice);
+    auto& queue = d->_sendQueue;
+    const std::size_t limit = std::min<std::size_t>(static_cast<std::size_t>(d->_txInFlight), queue.capacity());
+
+    if (d->_txQueue.empty() || (queue.size() >= limit)) {
+        return;
+    }
+
+    // Backend gets only a few frames at a time, so that frame queued later with higher priority does not wait
+    // behind frames already buffered by driver
+    std::vector<TxPriorityQueue::Pending> batch;
+    QVector<QCanBusFrame> frames;
+
+    while (!d->_txQueue.empty() && (queue.size() < limit)) {
+        batch.push_back(d->_txQueue.take());
+        frames.append(batch.back().frame);
+        queue.push(batch.back().frame);
+        d->_sendTimes.push(TxTiming{ batch.back().requestUs, nowUs });
+    }
+
+    const qint64 accepted = (frames.size() == 1) ? (d->_canDevice.writeFrame(frames.first()) ? 1 : 0)
+                                                 : d->_canDevice.writeFrames(frames);
+
+    for (qint64 i = 0; i < accepted; ++i) {
+        const auto& pending = batch[static_cast<std::size_t>(i)];
+
+        d->_txQueue.recordResidency(pending, nowUs);
+        Instrumentation::record(Instrumentation::Histogram::TxQueueResidencyUs,
+            (nowUs > pending.queuedUs) ? nowUs - pending.queuedUs : 0);
+    }
+
+    Instrumentation::record(Instrumentation::Histogram::SendQueueDepth, queue.size());
+
+    if (accepted == frames.size()) {
+        return;
+    }
+
+    // Frames not accepted by backend are the last ones queued. They keep their place in transmit queue and are
+    // retried until backend has room for them.
+    queue.dropBack(static_cast<std::size_t>(frames.size() - accepted));
+    d->_sendTimes.dropBack(static_cast<std::size_t>(frames.size() - accepted));
+
+    QVector<QCanBusFrame> failed;
+
+    for (auto i = static_cast<std::size_t>(accepted); i < batch.size(); ++i) {
+        auto& pending = batch[i];
+
+        if (++pending.retries > d->_txRetries) {
+            failed.append(pending.frame);
+        } else {
+            d->_txQueue.restore(std::move(pending));
+        }
+    }
+
+    if (!failed.isEmpty()) {
+        cds_warn("Backend did not accept {} frames after {} retries", failed.size(), d->_txRetries);
+        deliverFramesSent(false, failed);
+    }
+
+    scheduleTxRetry();
+}
+
+void CanDevice::scheduleTxRetry()
+{
+    Q_D(CanDevice);
+
+    if (d->_txRetryPending || d->_txQueue.empty()) {
         return;
     }
 
-    // Success will be reported in framesWritten signal.
-    // Sending may be buffered. Keep correlation between sending results and frame/context
-    d->_sendQueue.push_back(frame);
+    d->_txRetryPending = true;
 
-    status = d->_canDevice.writeFrame(frame);
+    QObject* context = d->_ioThreaded ? d->_ioContext.get() : static_cast<QObject*>(this);
+    QTimer::singleShot(CanDevicePrivate::kTxRetryIntervalMs, context, [this, d] {
+        d->_txRetryPending = false;
+        serviceTxQueue();
+    });
+}
 
-    if (!status) {
-        emit frameSent(status, frame);
-        d->_sendQueue.takeFirst();
+void CanDevice::flushTxQueue()
+{
+    Q_D(CanDevice);
+    const QVector<QCanBusFrame> frames = d->_txQueue.clear();
+
+    if (!frames.isEmpty()) {
+        deliverFramesSent(false, frames);
     }
 }
 
@@ -63,52 +286,306 @@ void CanDevice::framesReceived()
         return;
     }
 
+    if (d->_ioThreaded) {
+        // Executed in I/O thread. Frames are delivered by drainRxQueue.
+        quint64 read = 0;
+        quint64 dropped = 0;
+        const bool tapped = static_cast<bool>(d->_receiveTap);
+
+        while (static_cast<bool>(d->_canDevice.framesAvailable())) {
+            QCanBusFrame frame = d->_canDevice.readFrame();
+
+            // Stamp as close to reception as possible, if backend does not do it
+            stampFrame(frame);
+            ++read;
+            if (tapped) {
+                d->_tapFrames.append(frame);
+            }
+            if (!d->_rxQueue.push(std::move(frame))) {
+                ++dropped;
+            }
+        }
+
+        if (tapped && !d->_tapFrames.isEmpty()) {
+            d->_receiveTap(d->_tapFrames);
+            d->_tapFrames.resize(0);
+        }
+
+        Instrumentation::add(Instrumentation::Counter::RxFrames, read);
+        if (dropped) {
+            d->_rxOverflows.fetch_add(dropped, std::memory_order_relaxed);
+            Instrumentation::add(Instrumentation::Counter::RxOverflows, dropped);
+        }
+
+        return;
+    }
+
+    QVector<QCanBusFrame> frames;
+
     while (static_cast<bool>(d->_canDevice.framesAvailable())) {
-        const QCanBusFrame frame = d->_canDevice.readFrame();
-        emit frameReceived(frame);
+        frames.append(d->_canDevice.readFrame());
+        stampFrame(frames.last());
+    }
+
+    Instrumentation::add(Instrumentation::Counter::RxFrames, frames.size());
+    if (d->_receiveTap && !frames.isEmpty()) {
+        d->_receiveTap(frames);
+    }
+    notifyFramesReceived(frames);
+}
+
+void CanDevice::drainRxQueue()
+{
+    Q_D(CanDevice);
+    QVector<QCanBusFrame> frames;
+
+    frames.reserve(static_cast<int>(d->_rxQueue.size()));
+    d->_rxQueue.consumeAll([&frames](QCanBusFrame&& frame) { frames.append(std::move(frame)); });
+
+    const quint64 overflows = d->_rxOverflows.load(std::memory_order_relaxed);
+    if (overflows != d->_rxOverflowsReported) {
+        cds_warn("RX queue overflow, {} frames dropped ({} in total)", overflows - d->_rxOverflowsReported, overflows);
+        d->_rxOverflowsReported = overflows;
+    }
+
+    notifyFramesReceived(frames);
+}
+
+void CanDevice::setAcceptanceFilters(const CanFilterList& filters)
+{
+    Q_D(CanDevice);
+
+    if (!d->_simulationRunning) {
+        d->_consumerFilters = filters;
+        return;
+    }
+
+    // Consumer added while simulation runs gets its frames at once
+    d->runInIoThread([d, &filters] {
+        d->_consumerFilters = filters;
+        d->applyFilters();
+    });
+}
+
+quint64 CanDevice::rxOverflowCount() const
+{
+    return d_ptr->_rxOverflows.load(std::memory_order_relaxed);
+}
+
+void CanDevice::setReceiveTap(ReceiveTap tap)
+{
+    Q_D(CanDevice);
+
+    if (!d->_ioThreaded || (QThread::currentThread() == d->_ioContext->thread())) {
+        d->_receiveTap = std::move(tap);
+        return;
+    }
+
+    // Callback is swapped between two drains, so the previous one is not called once this returns
+    QSemaphore done;
+
+    QTimer::singleShot(0, d->_ioContext.get(), [d, &tap, &done] {
+        d->_receiveTap = std::move(tap);
+        done.release();
+    });
+    done.acquire();
+}
+
+std::vector<TxClassStats> CanDevice::txQueueStats() const
+{
+    Q_D(const CanDevice);
+    std::vector<TxClassStats> stats;
+
+    // Queue is owned by I/O thread
+    d->runInIoThread([d, &stats] { stats = d->_txQueue.stats(); });
+
+    return stats;
+}
+
+std::vector<TxLatencyStats> CanDevice::txLatencyStats() const
+{
+    Q_D(const CanDevice);
+    std::vector<TxLatencyStats> stats;
+
+    d->runInIoThread([d, &stats] { stats = d->_txLatency.snapshot(); });
+
+    return stats;
+}
+
+QThread* CanDevice::ioThread() const
+{
+    return d_ptr->_ioThreaded ? d_ptr->_reactor->thread() : thread();
+}
+
+FrameIdDirectoryPtr CanDevice::idDirectory() const
+{
+    return d_ptr->_idDirectory;
+}
+
+void CanDevice::notifyFramesReceived(const QVector<QCanBusFrame>& frames)
+{
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    emit frameBatchReceived(frames);
+
+    // Per-frame signal is kept for compatibility. Skip the loop when nobody listens to it.
+    static const QMetaMethod frameReceivedSignal = QMetaMethod::fromSignal(&CanDevice::frameReceived);
+    if (isSignalConnected(frameReceivedSignal)) {
+        for (const auto& frame : frames) {
+            emit frameReceived(frame);
+        }
     }
 }
 
-void CanDevice::framesWritten(qint64)
+void CanDevice::framesWritten(qint64 framesCnt)
 {
     Q_D(CanDevice);
+    auto& queue = d->_sendQueue;
+    const int count = static_cast<int>(std::min<qint64>(framesCnt, static_cast<qint64>(queue.size())));
 
-    if (!d->_sendQueue.isEmpty()) {
-        auto sendItem = d->_sendQueue.takeFirst();
-        emit frameSent(true, sendItem);
+    if (count > 0) {
+        const quint64 confirmUs = canTimestampNow();
+        QVector<QCanBusFrame> sent;
+
+        sent.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            recordLatency(queue[i], d->_sendTimes[i], confirmUs);
+            sent.append(std::move(queue[i]));
+        }
+        queue.drop(count);
+        d->_sendTimes.drop(count);
+
+        deliverFramesSent(true, std::move(sent));
+    }
+
+    if (d->_txQueueEnabled) {
+        serviceTxQueue();
     }
 }
 
 void CanDevice::errorOccurred(int error)
 {
     Q_D(CanDevice);
+    QCanBusFrame sendItem;
+    TxTiming timing;
+
+    Instrumentation::add(Instrumentation::Counter::DeviceErrors);
+
+    if (error == QCanBusDevice::WriteError && d->_sendQueue.pop(sendItem)) {
+        d->_sendTimes.pop(timing);
+        deliverFramesSent(false, { sendItem });
+
+        if (d->_txQueueEnabled) {
+            serviceTxQueue();
+        }
+    }
+}
+
+void CanDevice::recordLatency(const QCanBusFrame& frame, const TxTiming& timing, quint64 confirmUs)
+{
+    Q_D(CanDevice);
+
+    d->_txLatency.record(frame, timing.requestUs, timing.handoffUs, confirmUs);
+
+    Instrumentation::record(
+        Instrumentation::Histogram::TxHandoffUs, TxLatencyTable::elapsed(timing.requestUs, timing.handoffUs));
+    Instrumentation::record(
+        Instrumentation::Histogram::TxConfirmUs, TxLatencyTable::elapsed(timing.handoffUs, confirmUs));
+    Instrumentation::record(
+        Instrumentation::Histogram::TxLatencyUs, TxLatencyTable::elapsed(timing.requestUs, confirmUs));
+}
+
+void CanDevice::deliverFramesSent(bool status, QVector<QCanBusFrame> frames)
+{
+    Q_D(CanDevice);
+
+    Instrumentation::add(status ? Instrumentation::Counter::TxConfirmed : Instrumentation::Counter::TxFailed,
+        frames.size());
+
+    // Frames queued for sending carry no timestamp. Stamp them with time of confirmation.
+    for (auto& frame : frames) {
+        stampFrame(frame);
+    }
 
-    if (error == QCanBusDevice::WriteError && !d->_sendQueue.isEmpty()) {
-        auto sendItem = d->_sendQueue.takeFirst();
-        emit frameSent(false, sendItem);
+    if (d->_ioThreaded) {
+        // Executed in I/O thread, results are reported in the thread owning CanDevice
+        QTimer::singleShot(0, this, [this, status, frames] { notifyFramesSent(status, frames); });
+
+        return;
     }
+
+    notifyFramesSent(status, frames);
 }
 
-void CanDevice::setConfig(QJsonObject&)
+void CanDevice::notifyFramesSent(bool status, const QVector<QCanBusFrame>& frames)
 {
-    // TODO
+    emit frameBatchSent(status, frames);
+
+    static const QMetaMethod frameSentSignal = QMetaMethod::fromSignal(&CanDevice::frameSent);
+    if (isSignalConnected(frameSentSignal)) {
+        for (const auto& frame : frames) {
+            emit frameSent(status, frame);
+        }
+    }
+}
+
+void CanDevice::setConfig(QJsonObject& json)
+{
+    Q_D(CanDevice);
+
+    // Configuration is applied on next simulation start
+    d->mergeConfig(json);
+    d->_configDirty = true;
 }
 
 QJsonObject CanDevice::getConfig() const
 {
-    // TODO
-    return {};
+    return d_ptr->_config;
 }
 
 void CanDevice::startSimulation()
 {
     Q_D(CanDevice);
 
+    if (d->_configDirty) {
+        const QJsonObject& config = d->_config;
+
+        init(config["backend"].toString(), config["interface"].toString(), config["ioThread"].toBool());
+    }
+
+    // Handles stay, so that consumers keep indexing the same entries. Directory has single writer, dispatcher of
+    // frames emitted in the thread owning device.
+    if (QThread::currentThread() == thread()) {
+        d->_idDirectory->resetSlots();
+    } else {
+        QTimer::singleShot(0, this, [d] { d->_idDirectory->resetSlots(); });
+    }
+
     if (!d->_initialized) {
         cds_info("CanDevice not initialized");
         return;
     }
 
+    d->_simulationRunning = true;
+    if (d->_ioThreaded) {
+        QTimer::singleShot(0, d->_ioContext.get(), [d] {
+            d->applyConfiguration();
+            d->_txLatency.clear();
+
+            if (!d->_canDevice.connectDevice()) {
+                cds_error("Failed to connect device");
+            }
+        });
+        d->_drainTimer.start();
+
+        return;
+    }
+
+    d->applyConfiguration();
+    d->_txLatency.clear();
+
     if (!d->_canDevice.connectDevice()) {
         cds_error("Failed to connect device");
     }
@@ -123,5 +600,18 @@ void CanDevice::stopSimulation()
         return;
     }
 
+    d->_simulationRunning = false;
+    if (d->_ioThreaded) {
+        QTimer::singleShot(0, d->_ioContext.get(), [this, d] {
+            flushTxQueue();
+            d->_canDevice.disconnectDevice();
+        });
+        d->_drainTimer.stop();
+        drainRxQueue();
+
+        return;
+    }
+
+    flushTxQueue();
     d->_canDevice.disconnectDevice();
 }
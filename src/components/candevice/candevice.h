@@ -1,13 +1,22 @@
 #ifndef __CANDEVICE_H
 #define __CANDEVICE_H
 
+#include "txpriorityqueue.h"
 #include <QScopedPointer>
 #include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
 #include <componentinterface.h>
 #include <context.h>
+#include <frameiddirectory.h>
+#include <functional>
+#include <txlatency.h>
+#include <vector>
+
+class QThread;
 
 class CanDevicePrivate;
-class QCanBusFrame;
+struct TxTiming;
 
 /**
 *   @brief The class provides abstraction layer for CAN BUS hardware
@@ -17,6 +26,12 @@ class CanDevice : public QObject, public ComponentInterface {
     Q_DECLARE_PRIVATE(CanDevice)
 
 public:
+    /**
+    *   @brief  Callback receiving frames in the thread reading them from backend
+    *   @param  frames stamped frames of one backend notification, in reception order
+    */
+    typedef std::function<void(const QVector<QCanBusFrame>& frames)> ReceiveTap;
+
     CanDevice();
     CanDevice(CanDeviceCtx&& ctx);
     ~CanDevice();
@@ -28,11 +43,72 @@ public:
     *
     *   @param  backend one of backends supported by QtCanBus class
     *   @param  iface CAN BUS interface index (e.g. can0 for socketcan backend)
+    *   @param  ioThread if true device is serviced by dedicated thread and received frames are handed over
+    *           to this object's thread via bounded lock-free queue
     *   @return true on success, false of failure
     */
-    bool init(const QString& backend, const QString& iface);
+    bool init(const QString& backend, const QString& iface, bool ioThread = false);
+
+    /**
+    *   @brief  Sets acceptance filters requested by consumers of received frames. Filters are installed in
+    *           backend (socketcan CAN_RAW_FILTER) at once while simulation runs, otherwise on next start. Filters
+    *           from configuration take precedence.
+    *   @param  filters union of consumers' filters, empty list to receive all frames
+    */
+    void setAcceptanceFilters(const CanFilterList& filters);
+
+    /**
+    *   @brief  Number of received frames dropped because I/O thread queue was full
+    *   @return overflow counter, always 0 when I/O thread is not used
+    */
+    quint64 rxOverflowCount() const;
+
+    /**
+    *   @brief  Installs callback called with received frames before they are handed over to consumers. With
+    *           ioThread it runs in I/O thread, so frames can be processed (e.g. routed by Gateway) without
+    *           waiting for event loop of main thread. Callback must not block. Blocks until I/O thread is done
+    *           with previous callback.
+    *   @param  tap callback, empty to remove
+    */
+    void setReceiveTap(ReceiveTap tap);
+
+    /**
+    *   @brief  Counters of transmit queue classes. Blocks until I/O thread is done with current work.
+    *   @return one entry per class including the default one, empty classes when "txQueue" is not configured
+    */
+    std::vector<TxClassStats> txQueueStats() const;
+
+    /**
+    *   @brief  Per id latency of frames confirmed since simulation start, from sendFrames call over handover to
+    *           backend to backend's confirmation. Blocks until I/O thread is done with current work.
+    *   @return one entry per id, in order ids were first sent
+    */
+    std::vector<TxLatencyStats> txLatencyStats() const;
 
     /**
+    *   @return thread backend is read and written in, i.e. I/O thread if device is serviced by one
+    */
+    QThread* ioThread() const;
+
+    /**
+    *   @brief  Directory of IDs seen on the bus, shared with consumers (see ComponentInterface::setIdDirectory).
+    *           Kept for lifetime of device, so handles stay valid across simulations, payloads and counters are
+    *           cleared on simulation start. Updated by FlowPlan with every batch passed to consumers.
+    */
+    FrameIdDirectoryPtr idDirectory() const;
+
+    /**
+    *   @brief  Sets device configuration. Configuration is applied on next simulation start.
+    *
+    *   Supported keys: backend, interface, ioThread (devices share single I/O thread), bitrate, canFd,
+    *   dataBitrate, receiveOwn, filters, synthetic (traffic profile of "synthetic" backend, see
+    *   SyntheticTrafficProfile), txQueue. Unknown keys are ignored.
+    *
+    *   txQueue enables software transmit queue ordered by arbitration priority instead of sendFrames order:
+    *   { enabled (default true), inFlight (frames handed to backend at once, default 32), retries (attempts
+    *   before frame not accepted by backend is reported as failed, default 100), classes (see TxClass, matched
+    *   in order) }. Per-class counters are returned by txQueueStats.
+    *
     *   @see ComponentInterface
     */
     void setConfig(QJsonObject& json) override;
@@ -46,17 +122,49 @@ signals:
     void frameReceived(const QCanBusFrame& frame);
     void frameSent(bool status, const QCanBusFrame& frame);
 
+    /**
+    *   @brief  Emitted once per backend notification with all frames read in that drain
+    *   @param  frames received frames in reception order
+    */
+    void frameBatchReceived(const QVector<QCanBusFrame>& frames);
+
+    /**
+    *   @brief  Emitted once per group of frames confirmed (or rejected) by backend
+    *   @param  status true if frames were written successfully
+    *   @param  frames sent frames in transmission order
+    */
+    void frameBatchSent(bool status, const QVector<QCanBusFrame>& frames);
+
 public slots:
     void sendFrame(const QCanBusFrame& frame);
 
+    /**
+    *   @brief  Writes batch of frames. Frames rejected by backend (or not fitting into send queue) are reported
+    *           with single frameBatchSent(false, ...) per call, successful ones as backend confirms them.
+    *   @param  frames frames to be sent, in transmission order
+    */
+    void sendFrames(const QVector<QCanBusFrame>& frames);
+
 private slots:
     void errorOccurred(int error);
     void framesWritten(qint64 framesCnt);
     void framesReceived();
+    void drainRxQueue();
     void startSimulation();
     void stopSimulation();
 
 private:
+    void notifyFramesReceived(const QVector<QCanBusFrame>& frames);
+    void transmit(const QVector<QCanBusFrame>& frames, quint64 requestUs);
+    void enqueue(const QVector<QCanBusFrame>& frames, quint64 requestUs);
+    void serviceTxQueue();
+    void writeTxQueue(quint64 nowUs);
+    void scheduleTxRetry();
+    void flushTxQueue();
+    void recordLatency(const QCanBusFrame& frame, const TxTiming& timing, quint64 confirmUs);
+    void deliverFramesSent(bool status, QVector<QCanBusFrame> frames);
+    void notifyFramesSent(bool status, const QVector<QCanBusFrame>& frames);
+
     QScopedPointer<CanDevicePrivate> d_ptr;
 };
 
@@ -1,21 +1,268 @@
 #ifndef __CANDEVICE_P_H
 #define __CANDEVICE_P_H
 
+#include "candevice.h"
 #include "candeviceqt.h"
+#include "canioreactor.h"
+#include "txpriorityqueue.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSemaphore>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/QVector>
+#include <algorithm>
+#include <atomic>
+#include <canfilter.h>
+#include <canframerecord.h>
+#include <frameiddirectory.h>
+#include <memory>
+#include <ringbuffer.h>
+#include <txlatency.h>
+
+/**
+*   @brief  Timestamps of frame waiting for backend confirmation, kept in step with send queue
+*/
+struct TxTiming {
+    quint64 requestUs; // CanDevice::sendFrames called
+    quint64 handoffUs; // frame written to backend
+};
 
 class CanDevicePrivate {
 public:
+    // Capacity of queue between I/O thread and GUI thread. ~100ms of fully loaded CAN FD bus.
+    static constexpr std::size_t kRxQueueCapacity = 16384;
+    static constexpr int kRxDrainIntervalMs = 10;
+    // Frames written but not yet confirmed by backend. Frames that do not fit are reported as failed.
+    static constexpr std::size_t kSendQueueCapacity = 4096;
+    // Defaults of transmit queue, see applyTxQueueConfig
+    static constexpr int kDefaultTxInFlight = 32;
+    static constexpr int kDefaultTxRetries = 100;
+    static constexpr int kTxRetryIntervalMs = 1;
+
     CanDevicePrivate(CanDeviceCtx&& ctx = CanDeviceCtx(new CanDeviceQt))
         : _ctx(std::move(ctx))
+        , _sendQueue(kSendQueueCapacity)
+        , _sendTimes(kSendQueueCapacity)
         , _canDevice(_ctx.get<CanDeviceInterface>())
+        , _rxQueue(kRxQueueCapacity)
+        , _txQueue(kSendQueueCapacity)
+    {
+        _drainTimer.setInterval(kRxDrainIntervalMs);
+    }
+
+    ~CanDevicePrivate()
+    {
+        stopIoThread();
+    }
+
+    void startIoThread()
+    {
+        _reactor = CanIoReactor::acquire();
+
+        // Context object is used to post work (write, connect, disconnect) to I/O thread
+        _ioContext = std::make_unique<QObject>();
+        _ioContext->moveToThread(_reactor->thread());
+        _canDevice.moveToThread(_reactor->thread());
+        _ioThreaded = true;
+    }
+
+    void stopIoThread()
+    {
+        _drainTimer.stop();
+
+        if (_ioThreaded) {
+            // Reactor thread is shared with other devices, so it cannot be simply stopped. Pull device back to
+            // current thread instead. It has to be done from the thread device currently lives in.
+            QThread* owner = QThread::currentThread();
+            QSemaphore done;
+
+            QTimer::singleShot(0, _ioContext.get(), [this, owner, &done] {
+                _canDevice.moveToThread(owner);
+                _ioContext->moveToThread(owner);
+                done.release();
+            });
+            done.acquire();
+
+            _ioContext.reset();
+            _reactor.reset();
+            _ioThreaded = false;
+        }
+    }
+
+    /**
+    *   @brief  Executes fn in I/O thread (or at once if device has none) and waits until it is done
+    */
+    template <typename F> void runInIoThread(F&& fn) const
+    {
+        if (!_ioThreaded || (QThread::currentThread() == _ioContext->thread())) {
+            fn();
+            return;
+        }
+
+        QSemaphore done;
+
+        QTimer::singleShot(0, _ioContext.get(), [&fn, &done] {
+            fn();
+            done.release();
+        });
+        done.acquire();
+    }
+
+    /**
+    *   @brief  Merges configuration keys known to CanDevice into current configuration
+    *   @param  json configuration
+    */
+    void mergeConfig(const QJsonObject& json)
+    {
+        for (const auto& key : configKeys()) {
+            if (json.contains(key)) {
+                _config[key] = json[key];
+            }
+        }
+    }
+
+    /**
+    *   @brief  Passes backend parameters from configuration to device. Has to be called in device's thread.
+    */
+    void applyConfiguration()
+    {
+        const int bitrate = _config.value("bitrate").toInt();
+        if (bitrate > 0) {
+            _canDevice.setConfigurationParameter(QCanBusDevice::BitRateKey, bitrate);
+        }
+
+        if (_config.contains("receiveOwn")) {
+            _canDevice.setConfigurationParameter(QCanBusDevice::ReceiveOwnKey, _config.value("receiveOwn").toBool());
+        }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+        if (_config.contains("canFd")) {
+            _canDevice.setConfigurationParameter(QCanBusDevice::CanFdKey, _config.value("canFd").toBool());
+        }
+#endif
+
+        applyFilters();
+        applyTxQueueConfig();
+
+        if (_config.value("backend").toString() == SyntheticCanBusDevice::kBackendName) {
+            const QJsonObject profile = _config.value("synthetic").toObject();
+            _canDevice.setConfigurationParameter(SyntheticCanBusDevice::ProfileKey, profile);
+        }
+
+#ifdef Q_OS_LINUX
+        if (_config.value("backend").toString() == NativeSocketCanBusDevice::kBackendName) {
+            _canDevice.setConfigurationParameter(
+                NativeSocketCanBusDevice::HardwareTimestampKey, _config.value("hardwareTimestamps").toBool());
+        }
+#endif
+
+        const int dataBitrate = _config.value("dataBitrate").toInt();
+        if (dataBitrate > 0) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+            _canDevice.setConfigurationParameter(QCanBusDevice::DataBitRateKey, dataBitrate);
+#else
+            cds_warn("CAN FD data bitrate requires Qt 5.9");
+#endif
+        }
+    }
+
+    /**
+    *   @brief  Installs acceptance filters in backend. Filters from configuration take precedence over filters
+    *           requested by consumers.
+    */
+    void applyFilters()
+    {
+        CanFilterList filters = canFiltersFromJson(_config.value("filters").toArray());
+
+        if (filters.isEmpty()) {
+            filters = _consumerFilters;
+        }
+
+        const bool acceptAll = filters.isEmpty();
+
+        if (acceptAll) {
+            if (!_filtersInstalled) {
+                return;
+            }
+
+            // Empty filter list would block all frames in socketcan. Install filter matching everything instead.
+            filters.append(makeCanFilter(0, 0));
+        }
+
+        _canDevice.setConfigurationParameter(QCanBusDevice::RawFilterKey, QVariant::fromValue(filters));
+        _filtersInstalled = !acceptAll;
+    }
+
+    /**
+    *   @brief  Sets up transmit queue from "txQueue" configuration. Without the key frames are written in order
+    *           of sendFrames calls and frames rejected by backend are reported as failed at once.
+    */
+    void applyTxQueueConfig()
+    {
+        const QJsonObject json = _config.value("txQueue").toObject();
+
+        _txQueueEnabled = _config.contains("txQueue") && json["enabled"].toBool(true);
+        const int inFlight = json["inFlight"].toInt(kDefaultTxInFlight);
+        _txInFlight = std::max(1, std::min(inFlight, static_cast<int>(kSendQueueCapacity)));
+        _txRetries = std::max(0, json["retries"].toInt(kDefaultTxRetries));
+
+        std::vector<TxClass> classes;
+        for (const auto& txClass : json["classes"].toArray()) {
+            classes.push_back(TxClass::fromJson(txClass.toObject()));
+        }
+        _txQueue.setClasses(classes);
+    }
+
+    static QStringList configKeys()
     {
+        return { "backend", "interface", "ioThread", "bitrate", "canFd", "dataBitrate", "receiveOwn", "filters",
+            "synthetic", "hardwareTimestamps", "txQueue" };
+    }
+
+    static QJsonObject defaultConfig()
+    {
+        QJsonObject json;
+
+        json["backend"] = "socketcan";
+        json["interface"] = "can0";
+        json["ioThread"] = true;
+
+        return json;
     }
 
     CanDeviceCtx _ctx;
-    QVector<QCanBusFrame> _sendQueue;
+    RingBuffer<QCanBusFrame> _sendQueue; // owned by I/O thread when ioThread is used
+    RingBuffer<TxTiming> _sendTimes; // timestamps of frames in _sendQueue
+    TxLatencyTable _txLatency; // owned by I/O thread when ioThread is used
     CanDeviceInterface& _canDevice;
     bool _initialized{ false };
+    QJsonObject _config{ defaultConfig() };
+    bool _configDirty{ true }; // configuration has to be applied on next start
+    bool _simulationRunning{ false };
+    CanFilterList _consumerFilters;
+    bool _filtersInstalled{ false };
+    FrameIdDirectoryPtr _idDirectory{ std::make_shared<FrameIdDirectory>() };
+
+    bool _ioThreaded{ false };
+    std::shared_ptr<CanIoReactor> _reactor;
+    std::unique_ptr<QObject> _ioContext;
+    QTimer _drainTimer;
+    SpscRingBuffer<QCanBusFrame> _rxQueue;
+    std::atomic<quint64> _rxOverflows{ 0 };
+    quint64 _rxOverflowsReported{ 0 };
+    CanDevice::ReceiveTap _receiveTap; // called in I/O thread when ioThread is used
+    QVector<QCanBusFrame> _tapFrames; // frames of one drain passed to tap, reused
+
+    // Transmit queue, owned by I/O thread when ioThread is used
+    bool _txQueueEnabled{ false };
+    TxPriorityQueue _txQueue;
+    int _txInFlight{ kDefaultTxInFlight }; // frames handed to backend and not confirmed yet
+    int _txRetries{ kDefaultTxRetries }; // attempts to hand frame to backend before it is reported as failed
+    bool _txRetryPending{ false };
+    bool _txServicing{ false }; // backend may confirm frames from within write
+    bool _txServiceAgain{ false };
 };
 
 #endif /* !__CANDEVICE_P_H */
@@ -1,10 +1,14 @@
 #ifndef CANDEVICEINTERFACE_H_DNXOI7PW
 #define CANDEVICEINTERFACE_H_DNXOI7PW
 
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
 #include <QtCore/QtGlobal>
 #include <QtSerialBus/QCanBusFrame>
 #include <functional>
 
+class QThread;
+
 struct CanDeviceInterface {
     virtual ~CanDeviceInterface()
     {
@@ -20,11 +24,50 @@ struct CanDeviceInterface {
 
     virtual bool init(const QString& backend, const QString& iface) = 0;
     virtual bool writeFrame(const QCanBusFrame& frame) = 0;
+
+    /**
+    *   @brief  Writes batch of frames. Backends able to hand over many frames in one system call should
+    *           override it, default implementation writes frames one by one.
+    *   @param  frames frames to be written, in transmission order
+    *   @return number of leading frames accepted by backend. Writing stops at first rejected frame.
+    */
+    virtual qint64 writeFrames(const QVector<QCanBusFrame>& frames)
+    {
+        qint64 accepted = 0;
+
+        for (const auto& frame : frames) {
+            if (!writeFrame(frame)) {
+                break;
+            }
+            ++accepted;
+        }
+
+        return accepted;
+    }
+
     virtual bool connectDevice() = 0;
     virtual void disconnectDevice() = 0;
     virtual qint64 framesAvailable() = 0;
 
     virtual QCanBusFrame readFrame() = 0;
+
+    /**
+    *   @brief  Changes thread affinity of underlying device. All other methods and callbacks shall be then
+    *           executed in context of that thread.
+    *   @param  thread target thread
+    */
+    virtual void moveToThread(QThread*)
+    {
+    }
+
+    /**
+    *   @brief  Sets backend configuration parameter. Applied by backend on next connectDevice at the latest.
+    *   @param  key one of QCanBusDevice::ConfigurationKey
+    *   @param  value parameter value
+    */
+    virtual void setConfigurationParameter(int, const QVariant&)
+    {
+    }
 };
 
 #endif /* end of include guard: CANDEVICEINTERFACE_H_DNXOI7PW */
@@ -1,11 +1,17 @@
 #ifndef CANDEVICEQT_H_JYBV8GIQ
 #define CANDEVICEQT_H_JYBV8GIQ
 
+#include "canbackendcatalog.h"
 #include "candeviceinterface.h"
+#include "syntheticcanbusdevice.h"
 #include <QtSerialBus/QCanBus>
 #include <QtSerialBus/QCanBusDevice>
 #include <log.h>
 
+#ifdef Q_OS_LINUX
+#include "nativesocketcanbusdevice.h"
+#endif
+
 struct CanDeviceQt : public CanDeviceInterface {
     virtual void setFramesWrittenCbk(const framesWritten_t& cb) override
     {
@@ -39,7 +45,28 @@ struct CanDeviceQt : public CanDeviceInterface {
 
     virtual bool init(const QString& backend, const QString& iface) override
     {
-        _device.reset(QCanBus::instance()->createDevice(backend.toUtf8(), iface));
+#ifdef Q_OS_LINUX
+        _native = nullptr;
+#endif
+
+        if (backend == SyntheticCanBusDevice::kBackendName) {
+            // Built-in backend, not provided by QtSerialBus plugin
+            _device = std::make_unique<SyntheticCanBusDevice>();
+#ifdef Q_OS_LINUX
+        } else if (backend == NativeSocketCanBusDevice::kBackendName) {
+            _native = new NativeSocketCanBusDevice(iface);
+            _device.reset(_native);
+#endif
+        } else {
+            // Plugins are loaded by background discovery, device is created once they are available
+            const qint64 waited = CanBackendCatalog::waitUntilReady();
+
+            if (waited > 0) {
+                cds_info("Waited {} ms for CAN backend discovery", waited);
+            }
+
+            _device.reset(QCanBus::instance()->createDevice(backend.toUtf8(), iface));
+        }
 
         if (!_device) {
             cds_error("Failed to create candevice");
@@ -62,6 +89,18 @@ struct CanDeviceQt : public CanDeviceInterface {
         return false;
     }
 
+    virtual qint64 writeFrames(const QVector<QCanBusFrame>& frames) override
+    {
+#ifdef Q_OS_LINUX
+        if (_native) {
+            // Whole batch in a few sendmmsg calls
+            return _native->writeFrames(frames);
+        }
+#endif
+
+        return CanDeviceInterface::writeFrames(frames);
+    }
+
     virtual bool connectDevice() override
     {
         if (_device) {
@@ -101,8 +140,31 @@ struct CanDeviceQt : public CanDeviceInterface {
         }
     }
 
+    virtual void setConfigurationParameter(int key, const QVariant& value) override
+    {
+        if (_device) {
+            _device->setConfigurationParameter(key, value);
+        } else {
+            cds_error("candevice is null. Call init firts!");
+            throw std::runtime_error("candevice is null. Call init first!");
+        }
+    }
+
+    virtual void moveToThread(QThread* thread) override
+    {
+        if (_device) {
+            _device->moveToThread(thread);
+        } else {
+            cds_error("candevice is null. Call init firts!");
+            throw std::runtime_error("candevice is null. Call init first!");
+        }
+    }
+
 private:
     std::unique_ptr<QCanBusDevice> _device;
+#ifdef Q_OS_LINUX
+    NativeSocketCanBusDevice* _native{ nullptr }; // _device if native backend is used
+#endif
 };
 
 #endif /* end of include guard: CANDEVICEQT_H_JYBV8GIQ */
@@ -0,0 +1,59 @@
+#ifndef __CANIOREACTOR_H
+#define __CANIOREACTOR_H
+
+#include <QtCore/QThread>
+#include <memory>
+#include <mutex>
+
+/**
+*   @brief  I/O thread shared by all CanDevice instances working in threaded mode
+*
+*   The thread is started when the first device acquires the reactor and stopped when the last one releases it,
+*   so any number of CAN channels in one project is serviced by a single event loop.
+*/
+class CanIoReactor {
+public:
+    /**
+    *   @brief  Gets reactor shared by all devices, creates it if needed
+    *   @return reactor instance
+    */
+    static std::shared_ptr<CanIoReactor> acquire()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<CanIoReactor> shared;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto reactor = shared.lock();
+        if (!reactor) {
+            reactor.reset(new CanIoReactor());
+            shared = reactor;
+        }
+
+        return reactor;
+    }
+
+    ~CanIoReactor()
+    {
+        _thread.quit();
+        _thread.wait();
+    }
+
+    CanIoReactor(const CanIoReactor&) = delete;
+    CanIoReactor& operator=(const CanIoReactor&) = delete;
+
+    QThread* thread()
+    {
+        return &_thread;
+    }
+
+private:
+    CanIoReactor()
+    {
+        _thread.setObjectName("CanDeviceIO");
+        _thread.start(QThread::HighPriority);
+    }
+
+    QThread _thread;
+};
+
+#endif /* !__CANIOREACTOR_H */
@@ -0,0 +1,486 @@
+#include "nativesocketcanbusdevice.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <instrumentation.h>
+#include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
+#include <log.h>
+#include <net/if.h>
+#include <unistd.h>
+
+constexpr const char* NativeSocketCanBusDevice::kBackendName;
+constexpr int NativeSocketCanBusDevice::HardwareTimestampKey;
+constexpr unsigned NativeSocketCanBusDevice::kBatchSize;
+constexpr int NativeSocketCanBusDevice::kReceiveBufferSize;
+constexpr int NativeSocketCanBusDevice::kMaxBatchesPerWakeup;
+
+namespace {
+quint64 toMicroseconds(const timespec& ts)
+{
+    return static_cast<quint64>(ts.tv_sec) * 1000000 + static_cast<quint64>(ts.tv_nsec) / 1000;
+}
+} // namespace
+
+NativeSocketCanBusDevice::NativeSocketCanBusDevice(const QString& interface, QObject* parent)
+    : QCanBusDevice(parent)
+    , _interface(interface)
+    , _rxSlots(kBatchSize)
+    , _rxHeaders(kBatchSize)
+    , _txFrames(kBatchSize)
+    , _txVectors(kBatchSize)
+    , _txHeaders(kBatchSize)
+{
+    // Buffers are allocated once, headers keep pointing to them
+    for (unsigned i = 0; i < kBatchSize; ++i) {
+        RxSlot& slot = _rxSlots[i];
+        msghdr& rx = _rxHeaders[i].msg_hdr;
+
+        slot.iov = { &slot.frame, sizeof(slot.frame) };
+        std::memset(&rx, 0, sizeof(rx));
+        rx.msg_iov = &slot.iov;
+        rx.msg_iovlen = 1;
+        rx.msg_control = slot.control;
+
+        msghdr& tx = _txHeaders[i].msg_hdr;
+
+        _txVectors[i] = { &_txFrames[i], sizeof(canfd_frame) };
+        std::memset(&tx, 0, sizeof(tx));
+        tx.msg_iov = &_txVectors[i];
+        tx.msg_iovlen = 1;
+    }
+}
+
+NativeSocketCanBusDevice::~NativeSocketCanBusDevice()
+{
+    if (_socket >= 0) {
+        close();
+    }
+}
+
+void NativeSocketCanBusDevice::setConfigurationParameter(int key, const QVariant& value)
+{
+    QCanBusDevice::setConfigurationParameter(key, value);
+
+    if (key == HardwareTimestampKey) {
+        _hardwareTimestamps = value.toBool();
+    } else if (_socket >= 0) {
+        // Options set on connected device take effect immediately, otherwise they are applied by open()
+        applySocketOption(key);
+    }
+}
+
+bool NativeSocketCanBusDevice::writeFrame(const QCanBusFrame& frame)
+{
+    // Rejection is reported by return value only, see SyntheticCanBusDevice::writeFrame
+    if ((_socket < 0) || !frame.isValid()) {
+        return false;
+    }
+
+    canfd_frame& kernelFrame = _txFrames.front();
+    const std::size_t size = toKernelFrame(toCanFrameRecord(frame, Direction::TX), kernelFrame);
+
+    if ((size == CANFD_MTU) && !_canFd) {
+        cds_warn("CAN FD frame written to {} with CAN FD disabled", _interface.toStdString());
+        return false;
+    }
+
+    if (::write(_socket, &kernelFrame, size) != static_cast<ssize_t>(size)) {
+        cds_debug("Write to {} failed: {}", _interface.toStdString(), std::strerror(errno));
+        return false;
+    }
+
+    emit framesWritten(1);
+
+    return true;
+}
+
+qint64 NativeSocketCanBusDevice::writeFrames(const QVector<QCanBusFrame>& frames)
+{
+    if (_socket < 0) {
+        return 0;
+    }
+
+    qint64 accepted = 0;
+
+    for (int offset = 0; offset < frames.size(); offset += static_cast<int>(kBatchSize)) {
+        const int count = std::min(static_cast<int>(kBatchSize), frames.size() - offset);
+        int prepared = 0;
+
+        for (; prepared < count; ++prepared) {
+            const QCanBusFrame& frame = frames[offset + prepared];
+
+            if (!frame.isValid()) {
+                break;
+            }
+
+            const std::size_t size = toKernelFrame(toCanFrameRecord(frame, Direction::TX), _txFrames[prepared]);
+
+            if ((size == CANFD_MTU) && !_canFd) {
+                cds_warn("CAN FD frame written to {} with CAN FD disabled", _interface.toStdString());
+                break;
+            }
+            _txVectors[prepared].iov_len = size;
+        }
+
+        const int sent = (prepared > 0) ? ::sendmmsg(_socket, _txHeaders.data(), prepared, MSG_DONTWAIT) : 0;
+
+        if (sent > 0) {
+            accepted += sent;
+        } else if (sent < 0) {
+            cds_debug("Write to {} failed: {}", _interface.toStdString(), std::strerror(errno));
+        }
+
+        // Kernel queue is full (ENOBUFS) or frame was rejected, rest of the batch is reported by CanDevice
+        if (sent < count) {
+            break;
+        }
+    }
+
+    if (accepted > 0) {
+        emit framesWritten(accepted);
+    }
+
+    return accepted;
+}
+
+QString NativeSocketCanBusDevice::interpretErrorFrame(const QCanBusFrame&)
+{
+    return {};
+}
+
+CanFrameRecord NativeSocketCanBusDevice::fromKernelFrame(const canfd_frame& frame, std::size_t size, quint64 timestamp)
+{
+    CanFrameRecord rec{};
+    const bool fd = (size == CANFD_MTU);
+
+    rec.timestamp = timestamp;
+
+    if (frame.can_id & CAN_ERR_FLAG) {
+        rec.id = frame.can_id & CAN_ERR_MASK;
+        rec.flags |= CanFrameRecord::Error;
+    } else if (frame.can_id & CAN_EFF_FLAG) {
+        rec.id = frame.can_id & CAN_EFF_MASK;
+        rec.flags |= CanFrameRecord::ExtendedId;
+    } else {
+        rec.id = frame.can_id & CAN_SFF_MASK;
+    }
+
+    if (!fd && (frame.can_id & CAN_RTR_FLAG)) {
+        // Length of remote request is the requested one, there is no payload
+        rec.flags |= CanFrameRecord::Remote;
+        rec.length = std::min<quint8>(frame.len, CAN_MAX_DLEN);
+        return rec;
+    }
+
+    if (fd) {
+        rec.flags |= CanFrameRecord::FlexibleDataRate;
+        if (frame.flags & CANFD_BRS) {
+            rec.flags |= CanFrameRecord::BitrateSwitch;
+        }
+        if (frame.flags & CANFD_ESI) {
+            rec.flags |= CanFrameRecord::ErrorStateIndicator;
+        }
+    }
+
+    rec.length = std::min<quint8>(frame.len, fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+    std::memcpy(rec.payload, frame.data, rec.length);
+
+    return rec;
+}
+
+std::size_t NativeSocketCanBusDevice::toKernelFrame(const CanFrameRecord& rec, canfd_frame& frame)
+{
+    const bool fd = rec.hasFlag(CanFrameRecord::FlexibleDataRate);
+
+    std::memset(&frame, 0, sizeof(frame));
+
+    if (rec.hasFlag(CanFrameRecord::Error)) {
+        frame.can_id = (rec.id & CAN_ERR_MASK) | CAN_ERR_FLAG;
+    } else if (rec.hasFlag(CanFrameRecord::ExtendedId)) {
+        frame.can_id = (rec.id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+    } else {
+        frame.can_id = rec.id & CAN_SFF_MASK;
+    }
+
+    if (!fd && rec.hasFlag(CanFrameRecord::Remote)) {
+        frame.can_id |= CAN_RTR_FLAG;
+    }
+
+    if (fd) {
+        if (rec.hasFlag(CanFrameRecord::BitrateSwitch)) {
+            frame.flags |= CANFD_BRS;
+        }
+        if (rec.hasFlag(CanFrameRecord::ErrorStateIndicator)) {
+            frame.flags |= CANFD_ESI;
+        }
+    }
+
+    frame.len = std::min<quint8>(rec.length, fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+    std::memcpy(frame.data, rec.payload, frame.len);
+
+    return fd ? CANFD_MTU : CAN_MTU;
+}
+
+std::vector<can_filter> NativeSocketCanBusDevice::toKernelFilters(const CanFilterList& filters)
+{
+    std::vector<can_filter> result;
+
+    result.reserve(static_cast<std::size_t>(filters.size()));
+
+    for (const auto& filter : filters) {
+        can_filter kernelFilter;
+
+        kernelFilter.can_id = filter.frameId;
+        kernelFilter.can_mask = filter.frameIdMask;
+
+        if (filter.format == QCanBusDevice::Filter::MatchBaseFormat) {
+            kernelFilter.can_mask |= CAN_EFF_FLAG;
+        } else if (filter.format == QCanBusDevice::Filter::MatchExtendedFormat) {
+            kernelFilter.can_id |= CAN_EFF_FLAG;
+            kernelFilter.can_mask |= CAN_EFF_FLAG;
+        }
+
+        if (filter.type == QCanBusFrame::DataFrame) {
+            kernelFilter.can_mask |= CAN_RTR_FLAG;
+        } else if (filter.type == QCanBusFrame::RemoteRequestFrame) {
+            kernelFilter.can_id |= CAN_RTR_FLAG;
+            kernelFilter.can_mask |= CAN_RTR_FLAG;
+        }
+
+        result.push_back(kernelFilter);
+    }
+
+    return result;
+}
+
+bool NativeSocketCanBusDevice::open()
+{
+    const unsigned index = ::if_nametoindex(_interface.toLatin1().constData());
+
+    if (index == 0) {
+        setError(QString("Unknown CAN interface %1").arg(_interface), QCanBusDevice::ConnectionError);
+        return false;
+    }
+
+    _socket = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+
+    if (_socket < 0) {
+        setError(QString("Cannot create CAN socket: %1").arg(std::strerror(errno)), QCanBusDevice::ConnectionError);
+        return false;
+    }
+
+    for (const int key : configurationKeys()) {
+        if (!applySocketOption(key)) {
+            close();
+            return false;
+        }
+    }
+
+    // Forcing works with CAP_NET_ADMIN only, otherwise size is limited by net.core.rmem_max
+    const int receiveBuffer = kReceiveBufferSize;
+    if (::setsockopt(_socket, SOL_SOCKET, SO_RCVBUFFORCE, &receiveBuffer, sizeof(receiveBuffer)) != 0) {
+        setOption(SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer), "SO_RCVBUF");
+    }
+
+    const int timestamping = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE
+        | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    if (!setOption(SOL_SOCKET, SO_TIMESTAMPING, &timestamping, sizeof(timestamping), "SO_TIMESTAMPING")) {
+        const int enable = 1;
+        setOption(SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable), "SO_TIMESTAMPNS");
+    }
+
+    const int overflows = 1;
+    setOption(SOL_SOCKET, SO_RXQ_OVFL, &overflows, sizeof(overflows), "SO_RXQ_OVFL");
+
+    sockaddr_can address;
+    std::memset(&address, 0, sizeof(address));
+    address.can_family = AF_CAN;
+    address.can_ifindex = static_cast<int>(index);
+
+    if (::bind(_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        setError(QString("Cannot bind to %1: %2").arg(_interface, std::strerror(errno)),
+            QCanBusDevice::ConnectionError);
+        close();
+        return false;
+    }
+
+    int actualBuffer = 0;
+    socklen_t length = sizeof(actualBuffer);
+    ::getsockopt(_socket, SOL_SOCKET, SO_RCVBUF, &actualBuffer, &length);
+    cds_info("{} opened, receive buffer {} bytes", _interface.toStdString(), actualBuffer);
+
+    _kernelDrops = 0;
+    _notifier = std::make_unique<QSocketNotifier>(_socket, QSocketNotifier::Read);
+    connect(_notifier.get(), &QSocketNotifier::activated, this, &NativeSocketCanBusDevice::readFrames);
+
+    setState(QCanBusDevice::ConnectedState);
+
+    return true;
+}
+
+void NativeSocketCanBusDevice::close()
+{
+    _notifier.reset();
+
+    if (_socket >= 0) {
+        ::close(_socket);
+        _socket = -1;
+    }
+
+    setState(QCanBusDevice::UnconnectedState);
+}
+
+void NativeSocketCanBusDevice::readFrames()
+{
+    QVector<QCanBusFrame> frames;
+    const quint32 dropsBefore = _kernelDrops;
+
+    for (int i = 0; i < kMaxBatchesPerWakeup; ++i) {
+        if (readBatch(frames) < static_cast<int>(kBatchSize)) {
+            break;
+        }
+    }
+
+    if (_kernelDrops != dropsBefore) {
+        const quint32 dropped = _kernelDrops - dropsBefore;
+
+        cds_warn("{} receive buffer overflow, {} frames dropped by kernel", _interface.toStdString(), dropped);
+        Instrumentation::add(Instrumentation::Counter::RxOverflows, dropped);
+    }
+
+    if (!frames.isEmpty()) {
+        enqueueReceivedFrames(frames);
+    }
+}
+
+int NativeSocketCanBusDevice::readBatch(QVector<QCanBusFrame>& frames)
+{
+    // Kernel overwrites control length and flags
+    for (auto& header : _rxHeaders) {
+        header.msg_hdr.msg_controllen = sizeof(RxSlot::control);
+        header.msg_hdr.msg_flags = 0;
+    }
+
+    const int count = ::recvmmsg(_socket, _rxHeaders.data(), kBatchSize, MSG_DONTWAIT, nullptr);
+
+    if (count < 0) {
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+            setError(QString("Read from %1 failed: %2").arg(_interface, std::strerror(errno)),
+                QCanBusDevice::ReadError);
+        }
+        return 0;
+    }
+
+    frames.reserve(frames.size() + count);
+
+    for (int i = 0; i < count; ++i) {
+        const std::size_t size = _rxHeaders[i].msg_len;
+
+        if ((size != CAN_MTU) && (size != CANFD_MTU)) {
+            cds_warn("Unexpected frame size {} on {}", size, _interface.toStdString());
+            continue;
+        }
+
+        const quint64 timestamp = parseControl(_rxHeaders[i].msg_hdr);
+
+        frames.append(toQCanBusFrame(fromKernelFrame(_rxSlots[i].frame, size, timestamp)));
+    }
+
+    return count;
+}
+
+quint64 NativeSocketCanBusDevice::parseControl(const msghdr& header)
+{
+    quint64 timestamp = 0;
+
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&header), cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+
+        if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+            // Software, deprecated, raw hardware
+            timespec ts[3];
+            std::memcpy(ts, CMSG_DATA(cmsg), sizeof(ts));
+
+            const bool hardware = _hardwareTimestamps && ((ts[2].tv_sec != 0) || (ts[2].tv_nsec != 0));
+            timestamp = toMicroseconds(hardware ? ts[2] : ts[0]);
+        } else if (cmsg->cmsg_type == SO_TIMESTAMPNS) {
+            timespec ts;
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            timestamp = toMicroseconds(ts);
+        } else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+            // Total number of frames dropped by socket so far
+            quint32 drops = 0;
+            std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+            _kernelDrops = std::max(_kernelDrops, drops);
+        }
+    }
+
+    // Frames without timestamp are stamped by CanDevice
+    return timestamp;
+}
+
+bool NativeSocketCanBusDevice::applySocketOption(int key)
+{
+    const QVariant value = configurationParameter(key);
+
+    switch (key) {
+    case QCanBusDevice::RawFilterKey: {
+        const auto filters = toKernelFilters(value.value<CanFilterList>());
+
+        return setOption(SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+            static_cast<socklen_t>(filters.size() * sizeof(can_filter)), "CAN_RAW_FILTER");
+    }
+
+    case QCanBusDevice::ErrorFilterKey: {
+        const can_err_mask_t mask = static_cast<can_err_mask_t>(value.value<QCanBusFrame::FrameErrors>());
+
+        return setOption(SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &mask, sizeof(mask), "CAN_RAW_ERR_FILTER");
+    }
+
+    case QCanBusDevice::LoopbackKey: {
+        const int loopback = value.toBool() ? 1 : 0;
+
+        return setOption(SOL_CAN_RAW, CAN_RAW_LOOPBACK, &loopback, sizeof(loopback), "CAN_RAW_LOOPBACK");
+    }
+
+    case QCanBusDevice::ReceiveOwnKey: {
+        const int receiveOwn = value.toBool() ? 1 : 0;
+
+        return setOption(
+            SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &receiveOwn, sizeof(receiveOwn), "CAN_RAW_RECV_OWN_MSGS");
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    case QCanBusDevice::CanFdKey: {
+        const int canFd = value.toBool() ? 1 : 0;
+
+        if (!setOption(SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &canFd, sizeof(canFd), "CAN_RAW_FD_FRAMES")) {
+            return false;
+        }
+        _canFd = (canFd != 0);
+
+        return true;
+    }
+#endif
+
+    case QCanBusDevice::BitRateKey:
+        cds_info("Bitrate of {} has to be configured on the interface", _interface.toStdString());
+        return true;
+
+    default:
+        return true;
+    }
+}
+
+bool NativeSocketCanBusDevice::setOption(int level, int option, const void* value, socklen_t size, const char* name)
+{
+    if (::setsockopt(_socket, level, option, value, size) != 0) {
+        cds_warn("{} on {} failed: {}", name, _interface.toStdString(), std::strerror(errno));
+        return false;
+    }
+
+    return true;
+}
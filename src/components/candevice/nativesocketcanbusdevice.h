@@ -0,0 +1,104 @@
+#ifndef NATIVESOCKETCANBUSDEVICE_H
+#define NATIVESOCKETCANBUSDEVICE_H
+
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusDevice>
+#include <canfilter.h>
+#include <canframerecord.h>
+#include <linux/can.h>
+#include <memory>
+#include <sys/socket.h>
+#include <vector>
+
+/**
+*   @brief  Linux CAN_RAW socket used directly, without QtSerialBus socketcan plugin
+*
+*   Up to kBatchSize frames are moved per system call with recvmmsg / sendmmsg. Kernel frames are converted to
+*   CanFrameRecord first, so payload is copied once and flags are mapped the same way as everywhere else.
+*   Timestamps requested with SO_TIMESTAMPING are taken from kernel. Software ones use the same clock as
+*   canTimestampNow, hardware ones are used only with HardwareTimestampKey set, as adapter clock is usually not
+*   synchronized with system time. Socket is watched by QSocketNotifier in the thread device lives in, so with
+*   ioThread all channels share the CanIoReactor event loop. Frames dropped by kernel because receive buffer was
+*   full are reported with SO_RXQ_OVFL.
+*
+*   Selected with "nativesocketcan" backend name. Bitrate cannot be set on CAN_RAW socket and has to be
+*   configured on the interface (ip link).
+*/
+class NativeSocketCanBusDevice : public QCanBusDevice {
+    Q_OBJECT
+
+public:
+    static constexpr const char* kBackendName = "nativesocketcan";
+    // Configuration parameter, true selects raw hardware timestamps when adapter provides them
+    static constexpr int HardwareTimestampKey = QCanBusDevice::UserKey;
+    static constexpr unsigned kBatchSize = 64;
+    // Requested receive buffer, ~8 ms of CAN FD frames on 8 fully loaded channels
+    static constexpr int kReceiveBufferSize = 8 * 1024 * 1024;
+    // Batches read per socket notification, so other sockets serviced by the same thread are not starved
+    static constexpr int kMaxBatchesPerWakeup = 16;
+
+    explicit NativeSocketCanBusDevice(const QString& interface, QObject* parent = nullptr);
+    ~NativeSocketCanBusDevice();
+
+    void setConfigurationParameter(int key, const QVariant& value) override;
+    bool writeFrame(const QCanBusFrame& frame) override;
+    QString interpretErrorFrame(const QCanBusFrame& errorFrame) override;
+
+    /**
+    *   @brief  Writes frames with sendmmsg, kBatchSize frames per call
+    *   @return number of leading frames accepted by kernel
+    */
+    qint64 writeFrames(const QVector<QCanBusFrame>& frames);
+
+    /**
+    *   @brief  Converts kernel frame to record
+    *   @param  frame received frame
+    *   @param  size number of bytes received, CAN_MTU or CANFD_MTU
+    *   @param  timestamp microseconds since epoch
+    */
+    static CanFrameRecord fromKernelFrame(const canfd_frame& frame, std::size_t size, quint64 timestamp);
+
+    /**
+    *   @brief  Converts record to kernel frame
+    *   @return number of bytes to be written, CAN_MTU or CANFD_MTU
+    */
+    static std::size_t toKernelFrame(const CanFrameRecord& rec, canfd_frame& frame);
+
+    /**
+    *   @brief  Translates acceptance filters to CAN_RAW_FILTER socket option
+    */
+    static std::vector<can_filter> toKernelFilters(const CanFilterList& filters);
+
+protected:
+    bool open() override;
+    void close() override;
+
+private:
+    // Receive buffers of one batch
+    struct RxSlot {
+        canfd_frame frame;
+        iovec iov;
+        alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(timespec)) + CMSG_SPACE(sizeof(quint32))];
+    };
+
+    void readFrames();
+    int readBatch(QVector<QCanBusFrame>& frames);
+    quint64 parseControl(const msghdr& header);
+    bool applySocketOption(int key);
+    bool setOption(int level, int option, const void* value, socklen_t size, const char* name);
+
+    const QString _interface;
+    int _socket{ -1 };
+    std::unique_ptr<QSocketNotifier> _notifier;
+    std::vector<RxSlot> _rxSlots;
+    std::vector<mmsghdr> _rxHeaders;
+    std::vector<canfd_frame> _txFrames;
+    std::vector<iovec> _txVectors;
+    std::vector<mmsghdr> _txHeaders;
+    bool _canFd{ false };
+    bool _hardwareTimestamps{ false };
+    quint32 _kernelDrops{ 0 }; // reported by SO_RXQ_OVFL since open
+};
+
+#endif // NATIVESOCKETCANBUSDEVICE_H
@@ -0,0 +1,367 @@
+#include "syntheticcanbusdevice.h"
+#include <QtCore/QJsonArray>
+#include <algorithm>
+#include <canbustiming.h>
+#include <canframerecord.h>
+#include <limits>
+#include <log.h>
+
+constexpr const char* SyntheticCanBusDevice::kBackendName;
+constexpr int SyntheticCanBusDevice::ProfileKey;
+constexpr quint32 SyntheticCanBusDevice::kDefaultBitrate;
+constexpr quint32 SyntheticCanBusDevice::kDefaultDataBitrate;
+constexpr std::size_t SyntheticCanBusDevice::kTxQueueCapacity;
+constexpr quint64 SyntheticCanBusDevice::kMaxLagNs;
+
+namespace {
+constexpr quint64 kNsPerMs = 1000000;
+
+int maxPayload(bool canFd)
+{
+    return canFd ? CanFrameRecord::kMaxPayload : 8;
+}
+} // namespace
+
+SyntheticTrafficProfile SyntheticTrafficProfile::fromJson(const QJsonObject& json)
+{
+    SyntheticTrafficProfile profile;
+
+    // Reads positive integer, reports and ignores other values
+    auto readInt = [&json](const char* key, int& value, int min, int max) {
+        if (!json.contains(key)) {
+            return;
+        }
+
+        const int v = json[key].toInt(min - 1);
+        if ((v < min) || (v > max)) {
+            cds_warn("Synthetic profile: invalid {} value, keeping {}", key, value);
+            return;
+        }
+
+        value = v;
+    };
+
+    readInt("ids", profile.ids, 0, 2048);
+    readInt("burstLength", profile.burstLength, 0, 4096);
+    readInt("burstInterval", profile.burstInterval, 1, 3600000);
+    readInt("batchInterval", profile.batchInterval, 0, 1000);
+
+    int baseId = static_cast<int>(profile.baseId);
+    readInt("baseId", baseId, 0, 0x1fffffff);
+    profile.baseId = static_cast<quint32>(baseId);
+
+    int burstId = 0;
+    readInt("burstId", burstId, 0, 0x1fffffff);
+    profile.burstId = static_cast<quint32>(burstId);
+
+    int seed = static_cast<int>(profile.seed);
+    readInt("seed", seed, 0, std::numeric_limits<int>::max());
+    profile.seed = static_cast<quint32>(seed);
+
+    profile.extended = json["extended"].toBool(profile.extended);
+    profile.canFd = json["canFd"].toBool(profile.canFd);
+    profile.bitrateSwitch = json["bitrateSwitch"].toBool(profile.bitrateSwitch);
+    profile.randomPayload = json["randomPayload"].toBool(profile.randomPayload);
+
+    if (profile.canFd && !json.contains("length")) {
+        profile.length = CanFrameRecord::kMaxPayload;
+    }
+    readInt("length", profile.length, 0, maxPayload(profile.canFd));
+    if (profile.canFd) {
+        profile.length = canFdLength(profile.length);
+    }
+
+    if (json.contains("periods")) {
+        QVector<int> periods;
+
+        for (const auto& period : json["periods"].toArray()) {
+            if (period.toInt() > 0) {
+                periods.append(period.toInt());
+            } else {
+                cds_warn("Synthetic profile: invalid period ignored");
+            }
+        }
+
+        if (!periods.isEmpty()) {
+            profile.periods = periods;
+        }
+    }
+
+    if (json.contains("busLoad")) {
+        const double load = json["busLoad"].toDouble(-1.0);
+
+        if ((load < 0.0) || (load > 100.0)) {
+            cds_warn("Synthetic profile: busLoad has to be in range 0-100");
+        } else {
+            profile.busLoad = load;
+        }
+    }
+
+    if (profile.extended && (profile.baseId + profile.ids > 0x1fffffff)) {
+        cds_warn("Synthetic profile: ids exceed extended range");
+    } else if (!profile.extended && (profile.baseId + profile.ids + (profile.burstLength ? 1 : 0) > 0x800)) {
+        cds_warn("Synthetic profile: ids exceed 11-bit range, some ids are truncated");
+    }
+
+    return profile;
+}
+
+SyntheticCanBusDevice::SyntheticCanBusDevice(QObject* parent)
+    : QCanBusDevice(parent)
+    , _timer(this)
+{
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, [this] { generate(canTimestampNow()); });
+}
+
+void SyntheticCanBusDevice::setConfigurationParameter(int key, const QVariant& value)
+{
+    if (key == ProfileKey) {
+        _profile = SyntheticTrafficProfile::fromJson(value.toJsonObject());
+    }
+
+    QCanBusDevice::setConfigurationParameter(key, value);
+}
+
+bool SyntheticCanBusDevice::writeFrame(const QCanBusFrame& frame)
+{
+    // Rejection is reported by return value only. WriteError would make CanDevice fail the oldest pending frame
+    // in addition to the rejected one.
+    if ((state() != QCanBusDevice::ConnectedState) || !frame.isValid() || (_txQueue.size() >= kTxQueueCapacity)) {
+        return false;
+    }
+
+    _txQueue.push_back({ frame, canTimestampNow() * 1000 });
+
+    return true;
+}
+
+QString SyntheticCanBusDevice::interpretErrorFrame(const QCanBusFrame&)
+{
+    return {};
+}
+
+bool SyntheticCanBusDevice::open()
+{
+    const QVariant bitrate = configurationParameter(QCanBusDevice::BitRateKey);
+    _bitrate = (bitrate.toUInt() > 0) ? bitrate.toUInt() : kDefaultBitrate;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    const QVariant dataBitrate = configurationParameter(QCanBusDevice::DataBitRateKey);
+    _dataBitrate = (dataBitrate.toUInt() > 0) ? dataBitrate.toUInt() : kDefaultDataBitrate;
+#endif
+
+    _random.seed(_profile.seed);
+    _txQueue.clear();
+    _busFreeNs = canTimestampNow() * 1000;
+    _lastGenerateNs = _busFreeNs;
+    buildSources();
+
+    cds_info("Synthetic traffic: {} sources, {} bit/s", _sources.size(), _bitrate);
+
+    if (SimClock::isVirtual()) {
+        scheduleBatch();
+    } else if (_profile.batchInterval > 0) {
+        _timer.start(_profile.batchInterval);
+    }
+
+    setState(QCanBusDevice::ConnectedState);
+
+    return true;
+}
+
+void SyntheticCanBusDevice::close()
+{
+    _timer.stop();
+    SimClock::instance().cancel(_batchEvent);
+    _batchEvent = SimClock::kInvalidEvent;
+    setState(QCanBusDevice::UnconnectedState);
+}
+
+void SyntheticCanBusDevice::scheduleBatch()
+{
+    if (_profile.batchInterval <= 0) {
+        return;
+    }
+
+    const quint64 dueUs = SimClock::nowUs() + static_cast<quint64>(_profile.batchInterval) * 1000;
+    _batchEvent = SimClock::instance().schedule(this, dueUs, [this] {
+        _batchEvent = SimClock::kInvalidEvent;
+        generate(canTimestampNow());
+        if (state() == QCanBusDevice::ConnectedState) {
+            scheduleBatch();
+        }
+    });
+}
+
+void SyntheticCanBusDevice::generate(quint64 nowUs)
+{
+    if (state() != QCanBusDevice::ConnectedState) {
+        return;
+    }
+
+    const quint64 now = nowUs * 1000;
+    const bool receiveOwn = configurationParameter(QCanBusDevice::ReceiveOwnKey).toBool();
+    QVector<QCanBusFrame> received;
+    qint64 written = 0;
+
+    if (now > _lastGenerateNs + kMaxLagNs) {
+        cds_warn("Synthetic traffic fell behind by {} ms, schedule restarted", (now - _lastGenerateNs) / kNsPerMs);
+        _busFreeNs = std::max(_busFreeNs, now);
+        for (auto& source : _sources) {
+            source.anchorNs = std::max(source.anchorNs, now);
+            source.dueNs = std::max(source.dueNs, now);
+        }
+    }
+    _lastGenerateNs = std::max(_lastGenerateNs, now);
+
+    // Written frames win arbitration against generated ones
+    while (!_txQueue.empty()) {
+        auto& pending = _txQueue.front();
+        const quint64 end = std::max(pending.writtenNs, _busFreeNs) + busTimeNs(pending.frame);
+
+        if (end > now) {
+            break;
+        }
+
+        _busFreeNs = end;
+        ++written;
+        if (receiveOwn) {
+            pending.frame.setTimeStamp(QCanBusFrame::TimeStamp(
+                static_cast<qint64>(end / 1000000000ULL), static_cast<qint64>((end / 1000) % 1000000)));
+            received.append(pending.frame);
+        }
+        _txQueue.pop_front();
+    }
+
+    const auto later = [this](std::size_t a, std::size_t b) { return earlier(b, a); };
+
+    while (!_schedule.empty()) {
+        Source& source = _sources[_schedule.front()];
+        const quint64 end = std::max(source.dueNs, _busFreeNs) + source.busTimeNs;
+
+        if (end > now) {
+            break;
+        }
+
+        _busFreeNs = end;
+        received.append(makeFrame(source, end));
+
+        if (--source.burstLeft > 0) {
+            // Rest of the burst follows back-to-back
+            source.dueNs = end;
+        } else {
+            source.burstLeft = source.burstLength;
+            source.anchorNs += source.periodNs;
+            source.dueNs = source.anchorNs;
+        }
+
+        std::pop_heap(_schedule.begin(), _schedule.end(), later);
+        std::push_heap(_schedule.begin(), _schedule.end(), later);
+    }
+
+    if (!received.isEmpty()) {
+        enqueueReceivedFrames(received);
+    }
+
+    if (written > 0) {
+        emit framesWritten(written);
+    }
+}
+
+void SyntheticCanBusDevice::buildSources()
+{
+    const int count = _profile.ids;
+    const quint32 idMask = _profile.extended ? 0x1fffffff : 0x7ff;
+
+    _sources.clear();
+    _schedule.clear();
+
+    // Same length and format for every source, so bus time is computed once
+    CanFrameRecord prototype{};
+    prototype.length = static_cast<quint8>(_profile.length);
+    if (_profile.extended) {
+        prototype.flags |= CanFrameRecord::ExtendedId;
+    }
+    if (_profile.canFd) {
+        prototype.flags |= CanFrameRecord::FlexibleDataRate;
+        if (_profile.bitrateSwitch) {
+            prototype.flags |= CanFrameRecord::BitrateSwitch;
+        }
+    }
+    const quint64 frameNs = frameBusTimeNs(prototype, _bitrate, _dataBitrate);
+
+    for (int i = 0; i < count; ++i) {
+        quint64 periodNs = static_cast<quint64>(_profile.periods[i % _profile.periods.size()]) * kNsPerMs;
+
+        if (_profile.busLoad > 0.0) {
+            // Sources take turns, together they occupy requested share of the bus
+            periodNs = static_cast<quint64>(count * frameNs * 100.0 / _profile.busLoad);
+        }
+
+        // Phases are spread, so sources with the same period do not collide
+        const quint64 phase = periodNs * static_cast<quint64>(i) / static_cast<quint64>(count);
+
+        const quint64 due = _busFreeNs + phase;
+
+        _sources.push_back({ (_profile.baseId + i) & idMask, periodNs, due, due, frameNs, 1, 1, 0 });
+    }
+
+    if (_profile.burstLength > 0) {
+        const quint32 id = _profile.burstId ? _profile.burstId : _profile.baseId + static_cast<quint32>(count);
+        const quint64 periodNs = static_cast<quint64>(_profile.burstInterval) * kNsPerMs;
+
+        const quint64 due = _busFreeNs + periodNs;
+
+        _sources.push_back({ id & idMask, periodNs, due, due, frameNs, _profile.burstLength, _profile.burstLength, 0 });
+    }
+
+    for (std::size_t i = 0; i < _sources.size(); ++i) {
+        _schedule.push_back(i);
+    }
+    std::make_heap(_schedule.begin(), _schedule.end(), [this](std::size_t a, std::size_t b) { return earlier(b, a); });
+}
+
+QCanBusFrame SyntheticCanBusDevice::makeFrame(Source& source, quint64 timestampNs)
+{
+    QByteArray payload(_profile.length, '\0');
+
+    if (_profile.randomPayload) {
+        for (auto& byte : payload) {
+            byte = static_cast<char>(_random() & 0xff);
+        }
+    } else {
+        // Little endian counter lets consumers detect gaps
+        for (int i = 0; (i < payload.size()) && (i < 4); ++i) {
+            payload[i] = static_cast<char>((source.counter >> (8 * i)) & 0xff);
+        }
+    }
+    ++source.counter;
+
+    QCanBusFrame frame(source.id, payload);
+    frame.setExtendedFrameFormat(_profile.extended);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    frame.setFlexibleDataRateFormat(_profile.canFd);
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    frame.setBitrateSwitch(_profile.canFd && _profile.bitrateSwitch);
+#endif
+    frame.setTimeStamp(QCanBusFrame::TimeStamp(
+        static_cast<qint64>(timestampNs / 1000000000ULL), static_cast<qint64>((timestampNs / 1000) % 1000000)));
+
+    return frame;
+}
+
+quint64 SyntheticCanBusDevice::busTimeNs(const QCanBusFrame& frame) const
+{
+    return frameBusTimeNs(toCanFrameRecord(frame), _bitrate, _dataBitrate);
+}
+
+bool SyntheticCanBusDevice::earlier(std::size_t a, std::size_t b) const
+{
+    const Source& sa = _sources[a];
+    const Source& sb = _sources[b];
+
+    // Lower id wins arbitration when both are due at the same time
+    return (sa.dueNs < sb.dueNs) || ((sa.dueNs == sb.dueNs) && (sa.id < sb.id));
+}
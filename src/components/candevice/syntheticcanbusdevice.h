@@ -0,0 +1,120 @@
+#ifndef SYNTHETICCANBUSDEVICE_H
+#define SYNTHETICCANBUSDEVICE_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusDevice>
+#include <deque>
+#include <simclock.h>
+#include <random>
+#include <vector>
+
+/**
+*   @brief  Traffic generated by SyntheticCanBusDevice. Periods and intervals are in milliseconds.
+*
+*   JSON keys: ids, baseId, extended, periods (array, assigned to ids round-robin), length, canFd, bitrateSwitch,
+*   randomPayload, busLoad (percent, overrides periods), burstLength, burstInterval, burstId, batchInterval
+*   (0 disables internal timer, traffic is then generated by explicit generate() calls only), seed.
+*/
+struct SyntheticTrafficProfile {
+    int ids{ 16 };
+    quint32 baseId{ 0x100 };
+    bool extended{ false };
+    QVector<int> periods{ 10 };
+    int length{ 8 };
+    bool canFd{ false };
+    bool bitrateSwitch{ true };
+    bool randomPayload{ true };
+    double busLoad{ 0.0 };
+    int burstLength{ 0 };
+    int burstInterval{ 100 };
+    quint32 burstId{ 0 }; // 0 selects first id after periodic ones
+    int batchInterval{ 1 };
+    quint32 seed{ 1 };
+
+    /**
+    *   @brief  Reads profile. Missing keys keep default values, invalid ones are reported and ignored.
+    */
+    static SyntheticTrafficProfile fromJson(const QJsonObject& json);
+};
+
+/**
+*   @brief  CAN bus device generating traffic without hardware
+*
+*   Frames are scheduled according to SyntheticTrafficProfile and serialized on simulated bus, so frames never
+*   overlap and bus load never exceeds 100%. Every batchInterval all frames that finished transmission meanwhile
+*   are delivered with single framesReceived signal. Timestamps mark end of transmission and use the same clock
+*   as socketcan. Written frames are put on the bus ahead of generated ones and confirmed with framesWritten,
+*   with ReceiveOwnKey set they are received too.
+*
+*   Selected with "synthetic" backend name, profile is passed with ProfileKey configuration parameter.
+*/
+class SyntheticCanBusDevice : public QCanBusDevice {
+    Q_OBJECT
+
+public:
+    static constexpr const char* kBackendName = "synthetic";
+    // Configuration parameter carrying profile as QJsonObject
+    static constexpr int ProfileKey = QCanBusDevice::UserKey;
+    static constexpr quint32 kDefaultBitrate = 500000;
+    static constexpr quint32 kDefaultDataBitrate = 2000000;
+    // Written frames waiting for the bus
+    static constexpr std::size_t kTxQueueCapacity = 4096;
+    // Schedule is restarted if generation falls behind by more than that, e.g. when event loop was blocked
+    static constexpr quint64 kMaxLagNs = 1000000000ULL;
+
+    explicit SyntheticCanBusDevice(QObject* parent = nullptr);
+
+    void setConfigurationParameter(int key, const QVariant& value) override;
+    bool writeFrame(const QCanBusFrame& frame) override;
+    QString interpretErrorFrame(const QCanBusFrame& errorFrame) override;
+
+    /**
+    *   @brief  Generates traffic up to given time. Called by internal timer unless batchInterval is 0, with virtual
+    *           SimClock batches are scheduled in virtual time instead.
+    *   @param  nowUs current time in microseconds since epoch (see canTimestampNow)
+    */
+    void generate(quint64 nowUs);
+
+protected:
+    bool open() override;
+    void close() override;
+
+private:
+    struct Source {
+        quint32 id;
+        quint64 periodNs;
+        quint64 anchorNs; // scheduled start of current period
+        quint64 dueNs;
+        quint64 busTimeNs;
+        int burstLength; // frames sent back-to-back when due, 1 for periodic sources
+        int burstLeft;
+        quint32 counter;
+    };
+
+    struct PendingWrite {
+        QCanBusFrame frame;
+        quint64 writtenNs;
+    };
+
+    void buildSources();
+    QCanBusFrame makeFrame(Source& source, quint64 timestampNs);
+    quint64 busTimeNs(const QCanBusFrame& frame) const;
+    bool earlier(std::size_t a, std::size_t b) const;
+    void scheduleBatch();
+
+    SyntheticTrafficProfile _profile;
+    quint32 _bitrate{ kDefaultBitrate };
+    quint32 _dataBitrate{ kDefaultDataBitrate };
+    QTimer _timer;
+    SimClock::EventId _batchEvent{ SimClock::kInvalidEvent };
+    std::mt19937 _random;
+    std::vector<Source> _sources;
+    std::vector<std::size_t> _schedule; // min-heap of source indices ordered by due time
+    std::deque<PendingWrite> _txQueue;
+    quint64 _busFreeNs{ 0 };
+    quint64 _lastGenerateNs{ 0 };
+};
+
+#endif // SYNTHETICCANBUSDEVICE_H
@@ -0,0 +1,225 @@
+#include "txpriorityqueue.h"
+#include <algorithm>
+#include <log.h>
+
+constexpr int TxClass::kDefaultQuota;
+
+namespace {
+bool later(const TxPriorityQueue::Pending& a, const TxPriorityQueue::Pending& b)
+{
+    return (a.key != b.key) ? (a.key > b.key) : (a.sequence > b.sequence);
+}
+} // namespace
+
+TxClass TxClass::fromJson(const QJsonObject& json)
+{
+    TxClass txClass;
+
+    txClass.name = json["name"].toString();
+    txClass.filters = canFiltersFromJson(json["filters"].toArray());
+
+    const int quota = json["quota"].toInt(kDefaultQuota);
+    if (quota > 0) {
+        txClass.quota = quota;
+    } else {
+        cds_warn("Transmit class {}: quota has to be positive, keeping {}", txClass.name.toStdString(), txClass.quota);
+    }
+
+    txClass.maxAgeMs = std::max(0, json["maxAge"].toInt());
+
+    return txClass;
+}
+
+QJsonObject TxClass::toJson() const
+{
+    return QJsonObject{ { "name", name }, { "filters", canFiltersToJson(filters) }, { "quota", quota },
+        { "maxAge", maxAgeMs } };
+}
+
+TxPriorityQueue::TxPriorityQueue(std::size_t capacity)
+    : _capacity(capacity)
+{
+    setClasses({});
+}
+
+void TxPriorityQueue::setClasses(const std::vector<TxClass>& classes)
+{
+    _classes = classes;
+    _classes.push_back(TxClass{ "default", {}, static_cast<int>(_capacity), 0 });
+    _state.assign(_classes.size(), ClassState());
+    _nextStaleUs = 0;
+
+    for (std::size_t i = 0; i < _classes.size(); ++i) {
+        _state[i].stats.name = _classes[i].name;
+    }
+
+    // Counters start over, pending frames are assigned to new classes
+    for (auto& pending : _heap) {
+        pending.txClass = classOf(pending.frame);
+        ++_state[pending.txClass].pending;
+
+        const int maxAgeMs = _classes[pending.txClass].maxAgeMs;
+        if (maxAgeMs > 0) {
+            const quint64 staleUs = pending.queuedUs + static_cast<quint64>(maxAgeMs) * 1000;
+            _nextStaleUs = _nextStaleUs ? std::min(_nextStaleUs, staleUs) : staleUs;
+        }
+    }
+}
+
+const std::vector<TxClass>& TxPriorityQueue::classes() const
+{
+    return _classes;
+}
+
+bool TxPriorityQueue::push(const QCanBusFrame& frame, quint64 nowUs, quint64 requestUs)
+{
+    const int txClass = classOf(frame);
+    ClassState& state = _state[txClass];
+
+    if ((_heap.size() >= _capacity) || (state.pending >= static_cast<std::size_t>(_classes[txClass].quota))) {
+        ++state.stats.rejected;
+        return false;
+    }
+
+    ++state.stats.queued;
+    pushPending(Pending{ frame, nowUs, requestUs ? requestUs : nowUs, arbitrationKey(frame), _sequence++, txClass, 0 });
+
+    return true;
+}
+
+void TxPriorityQueue::restore(Pending&& pending)
+{
+    // Frame was taken, so there is room for it in quota and capacity
+    pushPending(std::move(pending));
+}
+
+void TxPriorityQueue::pushPending(Pending&& pending)
+{
+    const int maxAgeMs = _classes[pending.txClass].maxAgeMs;
+
+    if (maxAgeMs > 0) {
+        const quint64 staleUs = pending.queuedUs + static_cast<quint64>(maxAgeMs) * 1000;
+        _nextStaleUs = _nextStaleUs ? std::min(_nextStaleUs, staleUs) : staleUs;
+    }
+
+    ++_state[pending.txClass].pending;
+    _heap.push_back(std::move(pending));
+    std::push_heap(_heap.begin(), _heap.end(), later);
+}
+
+TxPriorityQueue::Pending TxPriorityQueue::take()
+{
+    std::pop_heap(_heap.begin(), _heap.end(), later);
+    Pending pending = std::move(_heap.back());
+    _heap.pop_back();
+    --_state[pending.txClass].pending;
+
+    return pending;
+}
+
+QVector<QCanBusFrame> TxPriorityQueue::dropStale(quint64 nowUs)
+{
+    QVector<QCanBusFrame> dropped;
+
+    if ((_nextStaleUs == 0) || (nowUs < _nextStaleUs)) {
+        return dropped;
+    }
+
+    _nextStaleUs = 0;
+
+    auto end = std::remove_if(_heap.begin(), _heap.end(), [this, nowUs, &dropped](const Pending& pending) {
+        const int maxAgeMs = _classes[pending.txClass].maxAgeMs;
+
+        if (maxAgeMs == 0) {
+            return false;
+        }
+
+        const quint64 staleUs = pending.queuedUs + static_cast<quint64>(maxAgeMs) * 1000;
+        if (nowUs < staleUs) {
+            _nextStaleUs = _nextStaleUs ? std::min(_nextStaleUs, staleUs) : staleUs;
+            return false;
+        }
+
+        ClassState& state = _state[pending.txClass];
+        --state.pending;
+        ++state.stats.stale;
+        dropped.append(pending.frame);
+
+        return true;
+    });
+
+    if (end != _heap.end()) {
+        _heap.erase(end, _heap.end());
+        std::make_heap(_heap.begin(), _heap.end(), later);
+    }
+
+    return dropped;
+}
+
+QVector<QCanBusFrame> TxPriorityQueue::clear()
+{
+    QVector<QCanBusFrame> frames;
+
+    frames.reserve(static_cast<int>(_heap.size()));
+    while (!_heap.empty()) {
+        frames.append(take().frame);
+    }
+    _nextStaleUs = 0;
+
+    return frames;
+}
+
+void TxPriorityQueue::recordResidency(const Pending& pending, quint64 nowUs)
+{
+    _state[pending.txClass].stats.residencyUs.add((nowUs > pending.queuedUs) ? nowUs - pending.queuedUs : 0);
+}
+
+bool TxPriorityQueue::empty() const
+{
+    return _heap.empty();
+}
+
+std::size_t TxPriorityQueue::size() const
+{
+    return _heap.size();
+}
+
+std::vector<TxClassStats> TxPriorityQueue::stats() const
+{
+    std::vector<TxClassStats> stats;
+
+    stats.reserve(_state.size());
+    for (const auto& state : _state) {
+        stats.push_back(state.stats);
+        stats.back().pending = state.pending;
+    }
+
+    return stats;
+}
+
+quint64 TxPriorityQueue::arbitrationKey(const QCanBusFrame& frame)
+{
+    const quint64 id = frame.frameId();
+    const bool extended = frame.hasExtendedFrameFormat();
+    // Base id is sent first. Base format frame has dominant RTR (data) or IDE bit where extended frame sends
+    // recessive SRR, so it wins against extended frame with the same base id.
+    const quint64 base = extended ? (id >> 18) & 0x7ff : id & 0x7ff;
+    const quint64 arbitration = (base << 19) | (extended ? ((1ULL << 18) | (id & 0x3ffff)) : 0);
+    const bool remote = frame.frameType() == QCanBusFrame::RemoteRequestFrame;
+
+    // Recessive RTR bit loses against data frame with the same id
+    return (arbitration << 1) | (remote ? 1 : 0);
+}
+
+int TxPriorityQueue::classOf(const QCanBusFrame& frame) const
+{
+    const int last = static_cast<int>(_classes.size()) - 1;
+
+    for (int i = 0; i < last; ++i) {
+        if (canFiltersAccept(_classes[i].filters, frame.frameId(), frame.hasExtendedFrameFormat())) {
+            return i;
+        }
+    }
+
+    return last;
+}
@@ -0,0 +1,145 @@
+#ifndef __TXPRIORITYQUEUE_H
+#define __TXPRIORITYQUEUE_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <canfilter.h>
+#include <instrumentation.h>
+#include <vector>
+
+/**
+*   @brief  Class of transmitted frames with its own limits
+*
+*   JSON keys: name, filters (see canFiltersFromJson, empty matches all frames), quota (maximum number of pending
+*   frames of the class), maxAge (ms, pending frames older than that are dropped as stale, 0 keeps them).
+*/
+struct TxClass {
+    static constexpr int kDefaultQuota = 1024;
+
+    QString name;
+    CanFilterList filters;
+    int quota{ kDefaultQuota };
+    int maxAgeMs{ 0 };
+
+    static TxClass fromJson(const QJsonObject& json);
+    QJsonObject toJson() const;
+};
+
+/**
+*   @brief  Counters of transmit class
+*/
+struct TxClassStats {
+    QString name;
+    quint64 queued{ 0 }; ///< frames accepted into queue
+    quint64 rejected{ 0 }; ///< frames not fitting into quota of class or capacity of queue
+    quint64 stale{ 0 }; ///< frames dropped because they were pending longer than maxAge
+    quint64 pending{ 0 }; ///< frames waiting now
+    Instrumentation::HistogramSnapshot residencyUs; ///< time from queueing to handover to backend
+};
+
+/**
+*   @brief  Software transmit queue of CanDevice ordered the way bus arbitrates
+*
+*   Frames with lower arbitration field are taken first, base format frames win over extended ones with the same
+*   base id. Frames of equal priority keep their order. Each frame belongs to the first class whose filters accept
+*   it, frames matching no class belong to default class appended behind configured ones.
+*/
+class TxPriorityQueue {
+public:
+    struct Pending {
+        QCanBusFrame frame;
+        quint64 queuedUs; // canTimestampNow() when frame entered queue
+        quint64 requestUs; // time frame was requested by sender, see TxLatencyTable
+        quint64 key; // arbitration priority, lower is sent first
+        quint64 sequence; // keeps order of frames with equal priority
+        int txClass;
+        int retries;
+    };
+
+    /**
+    *   @param  capacity maximum number of pending frames of all classes
+    */
+    explicit TxPriorityQueue(std::size_t capacity = 4096);
+
+    /**
+    *   @brief  Sets classes, pending frames are kept in their classes. Default class is appended.
+    *   @param  classes classes in order of matching
+    */
+    void setClasses(const std::vector<TxClass>& classes);
+
+    /**
+    *   @return classes including the default one
+    */
+    const std::vector<TxClass>& classes() const;
+
+    /**
+    *   @brief  Queues frame
+    *   @param  frame frame to be sent
+    *   @param  nowUs current time, see canTimestampNow
+    *   @param  requestUs time frame was requested, 0 if it is nowUs
+    *   @return false if quota of frame's class or capacity of queue is exhausted
+    */
+    bool push(const QCanBusFrame& frame, quint64 nowUs, quint64 requestUs = 0);
+
+    /**
+    *   @brief  Puts frame taken with take() back, e.g. when backend buffer was full. Order and age are kept.
+    */
+    void restore(Pending&& pending);
+
+    /**
+    *   @brief  Takes frame with highest priority
+    *   @return frame, queue must not be empty
+    */
+    Pending take();
+
+    /**
+    *   @brief  Removes frames pending longer than maxAge of their class
+    *   @param  nowUs current time, see canTimestampNow
+    *   @return dropped frames
+    */
+    QVector<QCanBusFrame> dropStale(quint64 nowUs);
+
+    /**
+    *   @brief  Removes all frames
+    *   @return removed frames in priority order
+    */
+    QVector<QCanBusFrame> clear();
+
+    /**
+    *   @brief  Records time frame spent in queue once backend accepted it
+    */
+    void recordResidency(const Pending& pending, quint64 nowUs);
+
+    bool empty() const;
+    std::size_t size() const;
+
+    /**
+    *   @return counters of classes in order of classes()
+    */
+    std::vector<TxClassStats> stats() const;
+
+    /**
+    *   @brief  Arbitration priority of frame, lower values win arbitration
+    */
+    static quint64 arbitrationKey(const QCanBusFrame& frame);
+
+private:
+    struct ClassState {
+        std::size_t pending{ 0 };
+        TxClassStats stats;
+    };
+
+    int classOf(const QCanBusFrame& frame) const;
+    void pushPending(Pending&& pending);
+
+    std::size_t _capacity;
+    std::vector<TxClass> _classes;
+    std::vector<ClassState> _state;
+    std::vector<Pending> _heap;
+    quint64 _sequence{ 0 };
+    quint64 _nextStaleUs{ 0 }; // earliest time a pending frame becomes stale, 0 if none can
+};
+
+#endif /* !__TXPRIORITYQUEUE_H */
@@ -40,9 +40,53 @@ int CanRawSender::getLineCount() const
     return d_ptr->getLineCount();
 }
 
-void CanRawSender::setConfig(QJsonObject&)
+TxScheduler& CanRawSender::txScheduler()
 {
-    // TODO
+    Q_D(CanRawSender);
+
+    return d->_txScheduler;
+}
+
+bool CanRawSender::importSchedule(const QString& path, QString& error)
+{
+    Q_D(CanRawSender);
+
+    return d->importSchedule(path, error);
+}
+
+int CanRawSender::startCyclic()
+{
+    Q_D(CanRawSender);
+
+    return d->_tvModel.startCyclic();
+}
+
+FloodGenerator& CanRawSender::floodGenerator()
+{
+    Q_D(CanRawSender);
+
+    return d->_flood;
+}
+
+bool CanRawSender::setFloodEnabled(bool enabled)
+{
+    Q_D(CanRawSender);
+
+    return d->setFloodEnabled(enabled);
+}
+
+void CanRawSender::framesSent(bool status, const QVector<QCanBusFrame>& frames)
+{
+    Q_D(CanRawSender);
+
+    d->_flood.framesConfirmed(status, frames);
+}
+
+void CanRawSender::setConfig(QJsonObject& json)
+{
+    Q_D(CanRawSender);
+
+    d->restoreSettings(json);
 }
 
 QJsonObject CanRawSender::getConfig() const
@@ -61,6 +105,11 @@ void CanRawSender::setDockUndockClbk(const std::function<void()>& cb)
     d->_ui.setDockUndockCbk(cb);
 }
 
+bool CanRawSender::mainWidgetCreated() const
+{
+    return d_ptr->_ui.isMainWidgetCreated();
+}
+
 bool CanRawSender::mainWidgetDocked() const
 {
     return d_ptr->docked;
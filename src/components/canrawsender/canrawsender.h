@@ -3,11 +3,15 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QVector>
 #include <componentinterface.h>
 #include <context.h>
 
 class QCanBusFrame;
+class QString;
 class CanRawSenderPrivate;
+class FloodGenerator;
+class TxScheduler;
 class QWidget;
 
 class CanRawSender : public QObject, public ComponentInterface {
@@ -20,11 +24,52 @@ public:
     ~CanRawSender();
     int getLineCount() const;
 
+    /**
+    *   @brief  Scheduler of cyclic frames shared by all lines of the sender
+    *   @return scheduler
+    */
+    TxScheduler& txScheduler();
+
+    /**
+    *   @brief  Replaces lines with transmit schedule read from DBC (cycle time attributes) or CSV file
+    *   @param  path schedule file
+    *   @param  error description of failure, set if false is returned
+    *   @return false if file cannot be read, lines are kept then
+    *   @see    ScheduleImport
+    */
+    bool importSchedule(const QString& path, QString& error);
+
+    /**
+    *   @brief  Starts cyclic transmission of all lines with loop and interval set at once
+    *   @return number of lines started, 0 if simulation is stopped
+    */
+    int startCyclic();
+
+    /**
+    *   @brief  Bus stress generator. Its frames are emitted with sendFrames, profile is kept in "flood" key of
+    *           configuration.
+    *   @return generator
+    */
+    FloodGenerator& floodGenerator();
+
+    /**
+    *   @brief  Starts or stops flood mode. Flood runs only while simulation runs.
+    *   @param  enabled true to start flood
+    *   @return false if flood cannot be started now
+    */
+    bool setFloodEnabled(bool enabled);
+
     /**
     *   @see ComponentInterface
     */
     QWidget* getMainWidget() override;
 
+    /**
+    *   @brief  Main widget is built when it is shown for the first time
+    *   @see ComponentInterface
+    */
+    bool mainWidgetCreated() const override;
+
     /**
     *   @see ComponentInterface
     */
@@ -48,10 +93,23 @@ public:
 signals:
     void sendFrame(const QCanBusFrame& frame);
 
+    /**
+    *   @brief  Frames generated in flood mode, to be sent back-to-back
+    *   @param  frames frames
+    */
+    void sendFrames(const QVector<QCanBusFrame>& frames);
+
 public slots:
     void stopSimulation(void);
     void startSimulation(void);
 
+    /**
+    *   @brief  Transmit confirmations of connected device, flood mode is paced by them
+    *   @param  status true if frames were written to bus
+    *   @param  frames confirmed frames
+    */
+    void framesSent(bool status, const QVector<QCanBusFrame>& frames);
+
 private:
     QScopedPointer<CanRawSenderPrivate> d_ptr;
 };
@@ -1,13 +1,44 @@
 #include "canrawsender_p.h"
 #include "canrawsender.h"
+#include "scheduleimport.h"
+#include <QElapsedTimer>
 #include <QJsonArray>
+#include <log.h>
 
 void CanRawSenderPrivate::setSimulationState(bool state)
 {
     _simulationState = state;
-    for (auto& iter : _lines) {
-        iter->SetSimulationState(state);
+    if (state) {
+        _txScheduler.resetReleaseJitter();
     }
+    _tvModel.setSimulationState(state);
+
+    if (!state) {
+        setFloodEnabled(false);
+
+        const auto jitter = _txScheduler.releaseJitter();
+        if (jitter.count > 0) {
+            cds_info("Cyclic frames released {} times, lateness mean {:.1f} us, p99 {} us, max {} us", jitter.count,
+                jitter.mean(), jitter.percentile(0.99), jitter.max);
+        }
+    }
+}
+
+bool CanRawSenderPrivate::setFloodEnabled(bool enabled)
+{
+    if (enabled && !_simulationState) {
+        _ui.setFloodEnabled(false);
+        return false;
+    }
+
+    if (enabled) {
+        _flood.start();
+    } else {
+        _flood.stop();
+    }
+    _ui.setFloodEnabled(enabled);
+
+    return true;
 }
 
 void CanRawSenderPrivate::saveSettings(QJsonObject& json) const
@@ -18,17 +49,64 @@ void CanRawSenderPrivate::saveSettings(QJsonObject& json) const
     writeSortingRules(jSortingObject);
     json["sorting"] = std::move(jSortingObject);
 
-    for (const auto& lineItem : _lines) {
+    for (int row = 0; row < _tvModel.rowCount(); ++row) {
         QJsonObject lineObject;
-        lineItem->Line2Json(lineObject);
+        _tvModel.lineToJson(row, lineObject);
         lineArray.append(std::move(lineObject));
     }
     json["content"] = std::move(lineArray);
+
+    // Written only when changed, projects without flood settings stay as they were
+    const QJsonObject flood = _flood.profile().toJson();
+    if (flood != FloodProfile().toJson()) {
+        json["flood"] = flood;
+    }
+
+    const ReleaseTiming timing = _txScheduler.timing();
+    if (timing.isPrecise()) {
+        json["timing"] = timing.toJson();
+    }
+}
+
+void CanRawSenderPrivate::restoreSettings(const QJsonObject& json)
+{
+    const QJsonArray lineArray = json["content"].toArray();
+    std::vector<SenderTableModel::Line> lines;
+
+    lines.reserve(static_cast<std::size_t>(lineArray.size()));
+    for (const auto& value : lineArray) {
+        const QJsonObject lineObject = value.toObject();
+
+        lines.push_back({ lineObject["id"].toString(), lineObject["data"].toString(), lineObject["loop"].toInt() != 0,
+            lineObject["interval"].toString() });
+    }
+
+    _tvModel.setLines(lines);
+    _currentIndex = json["sorting"].toObject()["currentIndex"].toInt();
+    _flood.setProfile(FloodProfile::fromJson(json["flood"].toObject()));
+    _txScheduler.setTiming(ReleaseTiming::fromJson(json["timing"].toObject()));
+}
+
+bool CanRawSenderPrivate::importSchedule(const QString& path, QString& error)
+{
+    std::vector<SenderTableModel::Line> lines;
+    QElapsedTimer timer;
+
+    timer.start();
+    if (!ScheduleImport::load(path, lines, error)) {
+        cds_error("Failed to import transmit schedule {}: {}", path.toStdString(), error.toStdString());
+        return false;
+    }
+
+    _tvModel.setLines(lines);
+    cds_info("Imported {} lines from {} in {} ms", lines.size(), path.toStdString(), timer.elapsed());
+
+    return true;
 }
 
 int CanRawSenderPrivate::getLineCount() const
 {
-    return _lines.size();
+    return _tvModel.rowCount();
 }
 
 void CanRawSenderPrivate::writeColumnsOrder(QJsonObject& json) const
@@ -47,26 +125,17 @@ void CanRawSenderPrivate::writeSortingRules(QJsonObject& json) const
 
 void CanRawSenderPrivate::removeRowsSelectedByMouse()
 {
-    QModelIndexList IndexList = _ui.getSelectedRows();
-    std::list<QModelIndex> tmp = IndexList.toStdList();
+    std::vector<int> rows;
 
-    tmp.sort(); // List must to be sorted and reversed because erasing started from last row
-    tmp.reverse();
-
-    for (QModelIndex n : tmp) {
-        _tvModel.removeRow(n.row()); // Delete line from table view
-        _lines.erase(_lines.begin() + n.row()); // Delete lines also from collection
-        // TODO: check if works when the collums was sorted before
+    for (const auto& index : _ui.getSelectedRows()) {
+        rows.push_back(index.row());
     }
+
+    // Adjacent rows are removed at once, cyclic entries of removed lines are unregistered by model
+    _tvModel.removeLines(std::move(rows));
 }
 
 void CanRawSenderPrivate::addNewItem()
 {
-    QList<QStandardItem*> list{};
-    _tvModel.appendRow(list);
-    auto newLine = std::make_unique<NewLineManager>(q_ptr, _simulationState, _nlmFactory);
-    for (NewLineManager::ColName ii : NewLineManager::ColNameIterator()) {
-        _ui.setIndexWidget(_tvModel.index(_tvModel.rowCount() - 1, static_cast<int>(ii)), newLine->GetColsWidget(ii));
-    }
-    _lines.push_back(std::move(newLine));
+    _tvModel.insertRows(_tvModel.rowCount(), 1);
 }
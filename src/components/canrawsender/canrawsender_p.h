@@ -1,13 +1,14 @@
 #ifndef CANRAWSENDER_P_H
 #define CANRAWSENDER_P_H
 
+#include "canrawsender.h"
+#include "floodgenerator.h"
 #include "gui/crsgui.h"
-#include "newlinemanager.h"
+#include "sendertablemodel.h"
+#include "txscheduler.h"
 #include <QJsonObject>
-#include <QtGui/QStandardItemModel>
 #include <context.h>
 #include <memory>
-#include <nlmfactory.h>
 
 namespace Ui {
 class CanRawSenderPrivate;
@@ -25,23 +26,38 @@ public:
     /// \brief Create new CanRawSenderPrivate class
     /// \param[in] q Pointer to CanRawSender class
     /// \param[in] ctx CanRawSender context
-    CanRawSenderPrivate(CanRawSender* q, CanRawSenderCtx&& ctx = CanRawSenderCtx(new CRSGui, new NLMFactory))
+    CanRawSenderPrivate(CanRawSender* q, CanRawSenderCtx&& ctx = CanRawSenderCtx(new CRSGui))
         : _ctx(std::move(ctx))
         , _ui(_ctx.get<CRSGuiInterface>())
-        , _nlmFactory(_ctx.get<NLMFactoryInterface>())
-        , _simulationState(false)
+        , _tvModel(_txScheduler)
+        , _currentIndex(0)
         , _columnsOrder({ "Id", "Data", "Loop", "Interval", "" })
         , q_ptr(q)
     {
         // NOTE: Implementation must be kept here. Otherwise VS2015 fails to link.
 
-        _tvModel.setHorizontalHeaderLabels(_columnsOrder);
-
         _ui.initTableView(_tvModel);
 
         _ui.setAddCbk(std::bind(&CanRawSenderPrivate::addNewItem, this));
         _ui.setRemoveCbk(std::bind(&CanRawSenderPrivate::removeRowsSelectedByMouse, this));
         _ui.setDockUndockCbk([this] { docked = !docked; });
+        _ui.setImportCbk([this](const QString& path) {
+            QString error;
+            importSchedule(path, error);
+        });
+        _ui.setStartCyclicCbk([this] { _tvModel.startCyclic(); });
+        _ui.setFloodCbk([this](bool enabled) { setFloodEnabled(enabled); });
+
+        connect(&_flood, &FloodGenerator::framesGenerated, q, &CanRawSender::sendFrames);
+        connect(&_flood, &FloodGenerator::statsUpdated, this,
+            [this](const FloodStats& stats) { _ui.setFloodStatus(stats.toString()); });
+
+        connect(&_tvModel, &SenderTableModel::sendFrame, q, &CanRawSender::sendFrame);
+        connect(&_txScheduler, &TxScheduler::framesDue, this, [this](const QVector<QCanBusFrame>& frames) {
+            for (const auto& frame : frames) {
+                emit q_ptr->sendFrame(frame);
+            }
+        });
     }
 
     /// \brief destructor
@@ -55,6 +71,21 @@ public:
     /// \param[in] json Json object
     void saveSettings(QJsonObject& json) const;
 
+    /// \brief This method restores lines written by saveSettings, table is filled in one batch
+    /// \param[in] json Json object
+    void restoreSettings(const QJsonObject& json);
+
+    /// \brief This method replaces lines with transmit schedule file
+    /// \param[in] path DBC or CSV file
+    /// \param[out] error Description of failure
+    /// \return false if schedule cannot be read
+    bool importSchedule(const QString& path, QString& error);
+
+    /// \brief This method starts or stops flood mode
+    /// \param[in] enabled true to start flood
+    /// \return false if flood cannot be started because simulation is stopped
+    bool setFloodEnabled(bool enabled);
+
     /// \brief This method return actual number of lines in table
     /// \return Line count
     int getLineCount() const;
@@ -78,14 +109,14 @@ private slots:
 public:
     CanRawSenderCtx _ctx;
     CRSGuiInterface& _ui;
-    NLMFactoryInterface& _nlmFactory;
     bool docked{ true };
+    TxScheduler _txScheduler;
+    SenderTableModel _tvModel; // declared after scheduler, removes its cyclic entries when destroyed
+    FloodGenerator _flood;
 
 private:
-    std::vector<std::unique_ptr<NewLineManager>> _lines;
-    QStandardItemModel _tvModel;
-    bool _simulationState;
     int _currentIndex;
+    bool _simulationState{ false };
     QStringList _columnsOrder;
     CanRawSender* q_ptr;
 };
@@ -0,0 +1,299 @@
+#include "floodgenerator.h"
+#include <algorithm>
+#include <canbustiming.h>
+#include <canframerecord.h>
+#include <limits>
+#include <log.h>
+
+constexpr int FloodGenerator::kTickMs;
+constexpr int FloodGenerator::kStatsIntervalMs;
+constexpr quint64 FloodGenerator::kMaxLagUs;
+
+namespace {
+const char* const kIdModes[] = { "fixed", "sweep", "random" };
+const char* const kPayloadModes[] = { "fixed", "counter", "random" };
+
+template <typename Mode, std::size_t N>
+void readMode(const QJsonObject& json, const char* key, const char* const (&names)[N], Mode& mode)
+{
+    if (!json.contains(key)) {
+        return;
+    }
+
+    const QString name = json[key].toString();
+    const auto it = std::find_if(std::begin(names), std::end(names), [&name](const char* n) { return name == n; });
+
+    if (it == std::end(names)) {
+        cds_warn("Flood profile: unknown {} '{}', keeping {}", key, name.toStdString(), names[static_cast<int>(mode)]);
+        return;
+    }
+
+    mode = static_cast<Mode>(it - std::begin(names));
+}
+} // namespace
+
+FloodProfile FloodProfile::fromJson(const QJsonObject& json)
+{
+    FloodProfile profile;
+
+    // Reads integer, reports and ignores values out of range
+    auto readInt = [&json](const char* key, qint64 value, qint64 min, qint64 max) {
+        if (!json.contains(key)) {
+            return value;
+        }
+
+        const auto v = static_cast<qint64>(json[key].toDouble(static_cast<double>(min - 1)));
+        if ((v < min) || (v > max)) {
+            cds_warn("Flood profile: invalid {} value, keeping {}", key, value);
+            return value;
+        }
+
+        return v;
+    };
+
+    if (json.contains("busLoad")) {
+        const double load = json["busLoad"].toDouble(-1.0);
+
+        if ((load <= 0.0) || (load > 100.0)) {
+            cds_warn("Flood profile: busLoad has to be in range (0-100]");
+        } else {
+            profile.busLoad = load;
+        }
+    }
+
+    profile.bitrate = static_cast<quint32>(readInt("bitrate", profile.bitrate, 1, 10000000));
+    profile.dataBitrate = static_cast<quint32>(readInt("dataBitrate", profile.dataBitrate, 1, 20000000));
+    profile.gapUs = static_cast<int>(readInt("gap", profile.gapUs, 0, 1000000));
+    profile.maxInFlight = static_cast<int>(readInt("maxInFlight", profile.maxInFlight, 1, 65536));
+    profile.seed = static_cast<quint32>(readInt("seed", profile.seed, 0, std::numeric_limits<quint32>::max()));
+
+    profile.extended = json["extended"].toBool(profile.extended);
+    profile.canFd = json["canFd"].toBool(profile.canFd);
+    profile.bitrateSwitch = json["bitrateSwitch"].toBool(profile.bitrateSwitch);
+    readMode(json, "idMode", kIdModes, profile.idMode);
+    readMode(json, "payloadMode", kPayloadModes, profile.payloadMode);
+
+    const qint64 maxId = profile.extended ? 0x1fffffff : 0x7ff;
+    profile.firstId = static_cast<quint32>(readInt("firstId", profile.firstId, 0, maxId));
+    profile.lastId = static_cast<quint32>(readInt("lastId", profile.firstId, 0, maxId));
+    if (profile.lastId < profile.firstId) {
+        cds_warn("Flood profile: lastId below firstId, single id is sent");
+        profile.lastId = profile.firstId;
+    }
+
+    profile.length
+        = static_cast<int>(readInt("length", profile.length, 0, profile.canFd ? CanFrameRecord::kMaxPayload : 8));
+    if (profile.canFd) {
+        profile.length = canFdLength(profile.length);
+    }
+
+    if (json.contains("payload")) {
+        const QString hex = json["payload"].toString();
+
+        profile.payload = QByteArray::fromHex(hex.toLatin1());
+        if (profile.payload.size() * 2 != hex.size()) {
+            cds_warn("Flood profile: payload is not hexadecimal");
+            profile.payload.clear();
+        }
+    }
+
+    return profile;
+}
+
+QJsonObject FloodProfile::toJson() const
+{
+    return QJsonObject{ { "busLoad", busLoad }, { "bitrate", static_cast<double>(bitrate) },
+        { "dataBitrate", static_cast<double>(dataBitrate) }, { "gap", gapUs },
+        { "idMode", kIdModes[static_cast<int>(idMode)] }, { "firstId", static_cast<double>(firstId) },
+        { "lastId", static_cast<double>(lastId) }, { "extended", extended }, { "length", length }, { "canFd", canFd },
+        { "bitrateSwitch", bitrateSwitch }, { "payloadMode", kPayloadModes[static_cast<int>(payloadMode)] },
+        { "payload", QString::fromLatin1(payload.toHex()) }, { "maxInFlight", maxInFlight },
+        { "seed", static_cast<double>(seed) } };
+}
+
+QString FloodStats::toString() const
+{
+    return QString("Flood: %1% load, %2 sent, %3 confirmed, %4 failed")
+        .arg(achievedLoad, 0, 'f', 1)
+        .arg(framesGenerated)
+        .arg(framesConfirmed)
+        .arg(framesFailed);
+}
+
+FloodGenerator::FloodGenerator(QObject* parent)
+    : QObject(parent)
+{
+    _timer.setTimerType(Qt::PreciseTimer);
+    _timer.setInterval(kTickMs);
+    _statsTimer.setInterval(kStatsIntervalMs);
+
+    connect(&_timer, &QTimer::timeout, this, [this] { generate(canTimestampNow()); });
+    connect(&_statsTimer, &QTimer::timeout, this, [this] { emit statsUpdated(stats()); });
+}
+
+void FloodGenerator::setProfile(const FloodProfile& profile)
+{
+    _profile = profile;
+}
+
+const FloodProfile& FloodGenerator::profile() const
+{
+    return _profile;
+}
+
+void FloodGenerator::start(bool timer)
+{
+    _random.seed(_profile.seed);
+    _nextId = _profile.firstId;
+    _counter = 0;
+    _startUs = 0;
+    _stopUs = 0;
+    _inFlight = 0;
+    _confirmedBusNs = 0;
+    _stats = FloodStats();
+    _running = true;
+
+    if (timer) {
+        _timer.start();
+        _statsTimer.start();
+    }
+}
+
+void FloodGenerator::stop()
+{
+    if (!_running) {
+        return;
+    }
+
+    _running = false;
+    _timer.stop();
+    _statsTimer.stop();
+    emit statsUpdated(stats());
+}
+
+bool FloodGenerator::isRunning() const
+{
+    return _running;
+}
+
+void FloodGenerator::generate(quint64 nowUs)
+{
+    if (!_running) {
+        return;
+    }
+
+    const quint64 now = nowUs * 1000;
+
+    if (_startUs == 0) {
+        _startUs = nowUs;
+        _nextNs = now;
+    } else if (now > _nextNs + kMaxLagUs * 1000) {
+        cds_debug("Flood fell behind by {} us, schedule restarted", (now - _nextNs) / 1000);
+        _nextNs = now;
+    }
+    _stopUs = nowUs;
+
+    QVector<QCanBusFrame> frames;
+
+    while ((_nextNs <= now) && (_inFlight < _profile.maxInFlight)) {
+        frames.append(makeFrame());
+        ++_inFlight;
+
+        // Bus is idle for the rest of slot, so that frames take busLoad percent of bus time
+        const quint64 slotNs = busTimeNs(frames.back()) + static_cast<quint64>(_profile.gapUs) * 1000;
+        _nextNs += static_cast<quint64>(slotNs * 100.0 / _profile.busLoad);
+    }
+
+    if (_inFlight >= _profile.maxInFlight) {
+        // Bus is slower than requested, frames are not sent in burst once device catches up
+        _nextNs = std::max(_nextNs, now);
+    }
+
+    if (!frames.isEmpty()) {
+        _stats.framesGenerated += static_cast<quint64>(frames.size());
+        emit framesGenerated(frames);
+    }
+}
+
+FloodStats FloodGenerator::stats() const
+{
+    FloodStats stats = _stats;
+    const quint64 elapsedUs = (_stopUs > _startUs) ? _stopUs - _startUs : 0;
+
+    stats.seconds = elapsedUs / 1000000.0;
+    stats.achievedLoad = elapsedUs ? std::min(100.0, _confirmedBusNs / (elapsedUs * 10.0)) : 0.0;
+
+    return stats;
+}
+
+void FloodGenerator::framesConfirmed(bool status, const QVector<QCanBusFrame>& frames)
+{
+    // Confirmations of other frames written by device are counted too, they take bus time just the same
+    if (!_running && (_inFlight == 0)) {
+        return;
+    }
+
+    for (const auto& frame : frames) {
+        if (status) {
+            ++_stats.framesConfirmed;
+            _confirmedBusNs += busTimeNs(frame);
+        } else {
+            ++_stats.framesFailed;
+        }
+    }
+
+    _inFlight = std::max<qint64>(0, _inFlight - frames.size());
+}
+
+QCanBusFrame FloodGenerator::makeFrame()
+{
+    quint32 id = _profile.firstId;
+
+    switch (_profile.idMode) {
+    case FloodProfile::IdMode::Fixed:
+        break;
+    case FloodProfile::IdMode::Sweep:
+        id = _nextId;
+        _nextId = (_nextId >= _profile.lastId) ? _profile.firstId : _nextId + 1;
+        break;
+    case FloodProfile::IdMode::Random:
+        id = std::uniform_int_distribution<quint32>(_profile.firstId, _profile.lastId)(_random);
+        break;
+    }
+
+    QByteArray payload(_profile.length, '\0');
+
+    switch (_profile.payloadMode) {
+    case FloodProfile::PayloadMode::Fixed:
+        std::copy_n(_profile.payload.constData(), std::min(_profile.payload.size(), payload.size()), payload.data());
+        break;
+    case FloodProfile::PayloadMode::Counter:
+        // Little endian counter lets receiving ECU or logger detect lost frames
+        for (int i = 0; (i < payload.size()) && (i < 8); ++i) {
+            payload[i] = static_cast<char>((_counter >> (8 * i)) & 0xff);
+        }
+        break;
+    case FloodProfile::PayloadMode::Random:
+        for (auto& byte : payload) {
+            byte = static_cast<char>(_random() & 0xff);
+        }
+        break;
+    }
+    ++_counter;
+
+    QCanBusFrame frame(id, payload);
+    frame.setExtendedFrameFormat(_profile.extended);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    frame.setFlexibleDataRateFormat(_profile.canFd);
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    frame.setBitrateSwitch(_profile.canFd && _profile.bitrateSwitch);
+#endif
+
+    return frame;
+}
+
+quint64 FloodGenerator::busTimeNs(const QCanBusFrame& frame) const
+{
+    return frameBusTimeNs(toCanFrameRecord(frame), _profile.bitrate, _profile.dataBitrate);
+}
@@ -0,0 +1,131 @@
+#ifndef FLOODGENERATOR_H
+#define FLOODGENERATOR_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <random>
+
+/// \brief Traffic generated by FloodGenerator
+///
+/// JSON keys: busLoad (target in percent), bitrate, dataBitrate (bit/s, used to compute bus time of frames), gap
+/// (additional inter-frame gap in us), idMode ("fixed", "sweep" or "random"), firstId, lastId, extended, length,
+/// canFd, bitrateSwitch, payloadMode ("fixed", "counter" or "random"), payload (hex, fixed mode), maxInFlight, seed.
+struct FloodProfile {
+    enum class IdMode { Fixed, Sweep, Random };
+    enum class PayloadMode { Fixed, Counter, Random };
+
+    double busLoad{ 100.0 };
+    quint32 bitrate{ 500000 };
+    quint32 dataBitrate{ 2000000 };
+    int gapUs{ 0 };
+    IdMode idMode{ IdMode::Fixed };
+    quint32 firstId{ 0x100 };
+    quint32 lastId{ 0x100 };
+    bool extended{ false };
+    int length{ 8 };
+    bool canFd{ false };
+    bool bitrateSwitch{ true };
+    PayloadMode payloadMode{ PayloadMode::Counter };
+    QByteArray payload;
+    int maxInFlight{ 256 }; ///< frames handed to device and not confirmed yet, bounds device queue
+    quint32 seed{ 1 };
+
+    /// \brief Reads profile. Missing keys keep default values, invalid ones are reported and ignored.
+    static FloodProfile fromJson(const QJsonObject& json);
+
+    /// \brief Writes profile in format read by fromJson
+    QJsonObject toJson() const;
+};
+
+/// \brief Counters of flood run
+struct FloodStats {
+    quint64 framesGenerated{ 0 };
+    quint64 framesConfirmed{ 0 };
+    quint64 framesFailed{ 0 };
+    double achievedLoad{ 0.0 }; ///< percent of bus time taken by confirmed frames since start
+    double seconds{ 0.0 };
+
+    /// \brief Human readable summary
+    QString toString() const;
+};
+
+/// \class FloodGenerator
+/// \brief Bus stress generator of CanRawSender
+///
+/// Frames are emitted back-to-back in batches (framesGenerated), paced by their worst-case bus time so that the
+/// profile's target load is reached. The number of frames not yet confirmed by device is bounded, so generation
+/// follows actual bus speed when target is above what the bus takes. Achieved load is computed from device
+/// confirmations passed to framesConfirmed.
+class FloodGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    /// \brief Interval of internal timer driving generation
+    static constexpr int kTickMs = 1;
+    /// \brief Interval of statsUpdated signal
+    static constexpr int kStatsIntervalMs = 500;
+    /// \brief Schedule is restarted if generation falls behind by more than that, e.g. when event loop was blocked
+    static constexpr quint64 kMaxLagUs = 100000;
+
+    explicit FloodGenerator(QObject* parent = nullptr);
+
+    /// \brief Sets traffic profile, takes effect on next start()
+    void setProfile(const FloodProfile& profile);
+
+    /// \brief Traffic profile
+    const FloodProfile& profile() const;
+
+    /// \brief Starts flood, counters are reset
+    /// \param[in] timer true to generate from internal timer, false to generate by explicit generate() calls only
+    void start(bool timer = true);
+
+    /// \brief Stops flood, frames in flight are still confirmed
+    void stop();
+
+    /// \brief Indicates whether flood runs
+    bool isRunning() const;
+
+    /// \brief Generates frames due up to given time
+    /// \param[in] nowUs current time in microseconds since epoch (see canTimestampNow)
+    void generate(quint64 nowUs);
+
+    /// \brief Counters of current or last run
+    FloodStats stats() const;
+
+public slots:
+    /// \brief Feeds device transmit confirmations
+    /// \param[in] status true if frames were written to bus
+    /// \param[in] frames Confirmed frames
+    void framesConfirmed(bool status, const QVector<QCanBusFrame>& frames);
+
+signals:
+    /// \brief Frames to be sent to device at once
+    void framesGenerated(const QVector<QCanBusFrame>& frames);
+
+    /// \brief Emitted periodically while flood runs
+    void statsUpdated(const FloodStats& stats);
+
+private:
+    QCanBusFrame makeFrame();
+    quint64 busTimeNs(const QCanBusFrame& frame) const;
+
+    FloodProfile _profile;
+    QTimer _timer;
+    QTimer _statsTimer;
+    std::mt19937 _random;
+    bool _running{ false };
+    quint32 _nextId{ 0 };
+    quint64 _counter{ 0 };
+    quint64 _startUs{ 0 };
+    quint64 _stopUs{ 0 };
+    quint64 _nextNs{ 0 }; // earliest start of next frame
+    qint64 _inFlight{ 0 };
+    quint64 _confirmedBusNs{ 0 };
+    FloodStats _stats;
+};
+
+#endif // FLOODGENERATOR_H
@@ -2,60 +2,145 @@
 #define CRSGUI_H
 
 #include "crsguiinterface.h"
+#include "senderitemdelegate.h"
 #include "ui_canrawsender.h"
+#include <QtCore/QSignalBlocker>
+#include <QtWidgets/QFileDialog>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace Ui {
 class CanRawSenderPrivate;
 }
 
+/// \brief Widget implementation of CRSGuiInterface
+///
+/// Widget tree is built on first getMainWidget() call. Until then callbacks and table model are recorded and applied
+/// in order once widgets exist.
 struct CRSGui : public CRSGuiInterface {
-    CRSGui()
-        : ui(new Ui::CanRawSenderPrivate)
-        , widget(new QWidget)
-    {
-        ui->setupUi(widget);
-    }
+    CRSGui() = default;
 
     void setAddCbk(const add_t& cb) override
     {
-        QObject::connect(ui->pbAdd, &QPushButton::pressed, cb);
+        apply([this, cb] { QObject::connect(ui->pbAdd, &QPushButton::pressed, cb); });
     }
 
     void setRemoveCbk(const remove_t& cb) override
     {
-        QObject::connect(ui->pbRemove, &QPushButton::pressed, cb);
+        apply([this, cb] { QObject::connect(ui->pbRemove, &QPushButton::pressed, cb); });
     }
 
     void setDockUndockCbk(const dockUndock_t& cb) override
     {
-        QObject::connect(ui->pbDockUndock, &QPushButton::toggled, cb);
+        apply([this, cb] { QObject::connect(ui->pbDockUndock, &QPushButton::toggled, cb); });
+    }
+
+    void setImportCbk(const import_t& cb) override
+    {
+        apply([this, cb] {
+            QObject::connect(ui->pbImport, &QPushButton::pressed, [this, cb] {
+                const QString path = QFileDialog::getOpenFileName(widget, "Import transmit schedule", QString(),
+                    "Transmit schedules (*.dbc *.csv);;All files (*)");
+
+                if (!path.isEmpty()) {
+                    cb(path);
+                }
+            });
+        });
+    }
+
+    void setStartCyclicCbk(const startCyclic_t& cb) override
+    {
+        apply([this, cb] { QObject::connect(ui->pbStartCyclic, &QPushButton::pressed, cb); });
+    }
+
+    void setFloodCbk(const flood_t& cb) override
+    {
+        apply([this, cb] { QObject::connect(ui->pbFlood, &QPushButton::toggled, cb); });
+    }
+
+    void setFloodEnabled(bool enabled) override
+    {
+        _floodEnabled = enabled;
+        if (widget) {
+            showFloodEnabled();
+        }
+    }
+
+    void setFloodStatus(const QString& status) override
+    {
+        // Status is refreshed periodically, nothing is kept until widget is shown
+        if (widget) {
+            ui->lFloodStatus->setText(status);
+        }
     }
 
     QWidget* getMainWidget() override
     {
+        if (!widget) {
+            build();
+        }
+
         return widget;
     }
 
-    void initTableView(QAbstractItemModel& _tvModel) override
+    bool isMainWidgetCreated() override
     {
+        return widget != nullptr;
+    }
 
-        ui->tv->setModel(&_tvModel);
-        ui->tv->setSelectionBehavior(QAbstractItemView::SelectRows);
+    void initTableView(QAbstractItemModel& _tvModel) override
+    {
+        apply([this, &_tvModel] {
+            ui->tv->setModel(&_tvModel);
+            ui->tv->setSelectionBehavior(QAbstractItemView::SelectRows);
+            // Editor exists only for the cell being edited, the rest is painted by delegate
+            ui->tv->setItemDelegate(new SenderItemDelegate(ui->tv));
+            ui->tv->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::SelectedClicked
+                | QAbstractItemView::EditKeyPressed | QAbstractItemView::AnyKeyPressed);
+        });
     }
 
     QModelIndexList getSelectedRows() override
     {
-        return ui->tv->selectionModel()->selectedRows();
+        // Nothing can be selected before widget is shown
+        return widget ? ui->tv->selectionModel()->selectedRows() : QModelIndexList();
     }
 
-    void setIndexWidget(const QModelIndex& index, QWidget* widget) override
+private:
+    void apply(std::function<void()>&& action)
     {
-        ui->tv->setIndexWidget(index, widget);
+        if (widget) {
+            action();
+        } else {
+            _pending.push_back(std::move(action));
+        }
     }
 
-private:
-    Ui::CanRawSenderPrivate* ui;
-    QWidget* widget;
+    void build()
+    {
+        ui = new Ui::CanRawSenderPrivate;
+        widget = new QWidget;
+        ui->setupUi(widget);
+
+        for (auto& action : _pending) {
+            action();
+        }
+        _pending.clear();
+        showFloodEnabled();
+    }
+
+    void showFloodEnabled()
+    {
+        // State is reflected only, callback is not invoked again
+        const QSignalBlocker blocker(ui->pbFlood);
+        ui->pbFlood->setChecked(_floodEnabled);
+    }
+
+    Ui::CanRawSenderPrivate* ui{ nullptr };
+    QWidget* widget{ nullptr };
+    std::vector<std::function<void()>> _pending;
+    bool _floodEnabled{ false };
 };
 #endif // CRSGUI_H
@@ -2,12 +2,12 @@
 #define CRSGUIINTERFACE_H
 
 #include <QModelIndex>
+#include <QString>
 #include <functional>
 #include <memory>
 class QWidget;
 class QAbstractItemModel;
 class CanRawSender;
-class NewLineManager;
 
 struct CRSGuiInterface {
     virtual ~CRSGuiInterface()
@@ -17,13 +17,21 @@ struct CRSGuiInterface {
     typedef std::function<void()> add_t;
     typedef std::function<void()> remove_t;
     typedef std::function<void()> dockUndock_t;
+    typedef std::function<void(const QString& path)> import_t;
+    typedef std::function<void()> startCyclic_t;
+    typedef std::function<void(bool enabled)> flood_t;
     virtual void setAddCbk(const add_t& cb) = 0;
     virtual void setRemoveCbk(const remove_t& cb) = 0;
     virtual void setDockUndockCbk(const dockUndock_t& cb) = 0;
+    virtual void setImportCbk(const import_t& cb) = 0;
+    virtual void setStartCyclicCbk(const startCyclic_t& cb) = 0;
+    virtual void setFloodCbk(const flood_t& cb) = 0;
+    virtual void setFloodEnabled(bool enabled) = 0;
+    virtual void setFloodStatus(const QString& status) = 0;
 
     virtual QWidget* getMainWidget() = 0;
+    virtual bool isMainWidgetCreated() = 0;
     virtual void initTableView(QAbstractItemModel& _tvModel) = 0;
     virtual QModelIndexList getSelectedRows() = 0;
-    virtual void setIndexWidget(const QModelIndex& index, QWidget* widget) = 0;
 };
 #endif // CRSGUIINTERFACE_H
@@ -0,0 +1,60 @@
+#ifndef CRSHEADLESSGUI_H
+#define CRSHEADLESSGUI_H
+
+#include "crsguiinterface.h"
+
+/// \brief No-op implementation of CRSGuiInterface for running without display
+struct CRSHeadlessGui : public CRSGuiInterface {
+    void setAddCbk(const add_t&) override
+    {
+    }
+
+    void setRemoveCbk(const remove_t&) override
+    {
+    }
+
+    void setDockUndockCbk(const dockUndock_t&) override
+    {
+    }
+
+    void setImportCbk(const import_t&) override
+    {
+    }
+
+    void setStartCyclicCbk(const startCyclic_t&) override
+    {
+    }
+
+    void setFloodCbk(const flood_t&) override
+    {
+    }
+
+    void setFloodEnabled(bool) override
+    {
+    }
+
+    void setFloodStatus(const QString&) override
+    {
+    }
+
+    QWidget* getMainWidget() override
+    {
+        return nullptr;
+    }
+
+    bool isMainWidgetCreated() override
+    {
+        return false;
+    }
+
+    void initTableView(QAbstractItemModel&) override
+    {
+    }
+
+    QModelIndexList getSelectedRows() override
+    {
+        return {};
+    }
+};
+
+#endif // CRSHEADLESSGUI_H
@@ -0,0 +1,85 @@
+#ifndef SENDERITEMDELEGATE_H
+#define SENDERITEMDELEGATE_H
+
+#include "sendertablemodel.h"
+#include <QtCore/QEvent>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QPainter>
+#include <QtGui/QRegExpValidator>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QStyledItemDelegate>
+
+/// \brief Delegate of SenderTableModel
+///
+/// Text cells are edited with line edit restricted to SenderTableModel::PatternRole, created only while cell is
+/// edited. Send cell is painted as push button and activates SenderTableModel::SendRole when clicked.
+struct SenderItemDelegate : public QStyledItemDelegate {
+    explicit SenderItemDelegate(QObject* parent = nullptr)
+        : QStyledItemDelegate(parent)
+    {
+    }
+
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem&, const QModelIndex& index) const override
+    {
+        const QString pattern = index.data(SenderTableModel::PatternRole).toString();
+
+        if (pattern.isEmpty()) {
+            return nullptr;
+        }
+
+        auto editor = new QLineEdit(parent);
+        editor->setFrame(false);
+        editor->setAlignment(Qt::AlignHCenter);
+        editor->setPlaceholderText(index.data(SenderTableModel::PlaceholderRole).toString());
+        editor->setValidator(new QRegExpValidator(QRegExp(pattern), editor));
+
+        return editor;
+    }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        if (index.column() == SenderTableModel::SendColumn) {
+            QStyleOptionButton button;
+
+            button.rect = option.rect;
+            button.text = index.data().toString();
+            button.state = index.data(SenderTableModel::SendRole).toBool() ? QStyle::State_Enabled : QStyle::State_None;
+            style(option)->drawControl(QStyle::CE_PushButton, &button, painter);
+            return;
+        }
+
+        QStyledItemDelegate::paint(painter, option, index);
+
+        const QString placeholder = index.data(SenderTableModel::PlaceholderRole).toString();
+        if (!placeholder.isEmpty() && index.data().toString().isEmpty()) {
+            painter->save();
+            painter->setPen(option.palette.color(QPalette::Disabled, QPalette::Text));
+            painter->drawText(option.rect, Qt::AlignCenter, placeholder);
+            painter->restore();
+        }
+    }
+
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option,
+        const QModelIndex& index) override
+    {
+        if ((index.column() == SenderTableModel::SendColumn) && (event->type() == QEvent::MouseButtonRelease)) {
+            const auto mouse = static_cast<QMouseEvent*>(event);
+
+            if ((mouse->button() == Qt::LeftButton) && option.rect.contains(mouse->pos())) {
+                model->setData(index, true, SenderTableModel::SendRole);
+            }
+            return true;
+        }
+
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+
+private:
+    static QStyle* style(const QStyleOptionViewItem& option)
+    {
+        return option.widget ? option.widget->style() : QApplication::style();
+    }
+};
+
+#endif // SENDERITEMDELEGATE_H
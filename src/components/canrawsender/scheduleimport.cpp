@@ -0,0 +1,110 @@
+#include "scheduleimport.h"
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStringList>
+#include <algorithm>
+#include <dbcparser.h>
+
+namespace {
+const int kMaxPayloadLength = 64;
+
+QString csvError(int line, const char* what)
+{
+    return QString("Invalid %1 at line %2").arg(what).arg(line);
+}
+} // namespace
+
+namespace ScheduleImport {
+
+bool fromCsv(const QString& text, std::vector<SenderTableModel::Line>& lines, QString& error)
+{
+    static const QRegularExpression separator("[,;]");
+    static const QRegularExpression whitespace("\\s+");
+    const QStringList rows = text.split('\n');
+
+    lines.clear();
+    lines.reserve(static_cast<std::size_t>(rows.size()));
+
+    for (int i = 0; i < rows.size(); ++i) {
+        const QString row = rows[i].trimmed();
+
+        if (row.isEmpty() || row.startsWith('#') || row.startsWith("id", Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        const QStringList fields = row.split(separator);
+        SenderTableModel::Line line;
+
+        line.id = fields[0].trimmed();
+        if (line.id.startsWith("0x", Qt::CaseInsensitive)) {
+            line.id = line.id.mid(2);
+        }
+        line.data = (fields.size() > 1) ? fields[1].trimmed().remove(whitespace) : QString();
+        line.interval = (fields.size() > 2) ? fields[2].trimmed() : QString();
+        if (line.interval == "0") {
+            line.interval.clear();
+        }
+        line.loop = !line.interval.isEmpty();
+
+        if (line.id.isEmpty() || !SenderTableModel::matches(SenderTableModel::IdColumn, line.id)) {
+            error = csvError(i + 1, "id");
+            return false;
+        }
+        if (!SenderTableModel::matches(SenderTableModel::DataColumn, line.data) || (line.data.size() % 2 != 0)) {
+            error = csvError(i + 1, "data");
+            return false;
+        }
+        if (!SenderTableModel::matches(SenderTableModel::IntervalColumn, line.interval)) {
+            error = csvError(i + 1, "interval");
+            return false;
+        }
+
+        lines.push_back(std::move(line));
+    }
+
+    return true;
+}
+
+bool fromDbc(const QString& text, std::vector<SenderTableModel::Line>& lines, QString& error)
+{
+    std::vector<DbcMessage> messages;
+
+    lines.clear();
+
+    if (!DbcParser::parse(text, messages, error)) {
+        return false;
+    }
+
+    lines.reserve(messages.size());
+    for (const auto& message : messages) {
+        SenderTableModel::Line line;
+
+        line.id = QString::number(message.id, 16);
+        line.data = QString(2 * std::min(message.length, kMaxPayloadLength), '0');
+        line.loop = message.cycleTime > 0;
+        line.interval = line.loop ? QString::number(message.cycleTime) : QString();
+        lines.push_back(std::move(line));
+    }
+
+    return true;
+}
+
+bool load(const QString& path, std::vector<SenderTableModel::Line>& lines, QString& error)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = file.errorString();
+        return false;
+    }
+
+    if (QFileInfo(path).suffix().compare("dbc", Qt::CaseInsensitive) == 0) {
+        // See DbcParser::load
+        return fromDbc(QString::fromLatin1(file.readAll()), lines, error);
+    }
+
+    return fromCsv(QString::fromUtf8(file.readAll()), lines, error);
+}
+
+} // namespace ScheduleImport
@@ -0,0 +1,41 @@
+#ifndef SCHEDULEIMPORT_H
+#define SCHEDULEIMPORT_H
+
+#include "sendertablemodel.h"
+#include <QtCore/QString>
+#include <vector>
+
+/// \brief Readers of transmit schedules imported into CanRawSender in one batch
+namespace ScheduleImport {
+
+/// \brief Parses CSV schedule
+///
+/// One line per frame: id, data and interval separated by comma or semicolon. Id and data are hexadecimal, id may
+/// start with 0x and data bytes may be separated by spaces. Interval is given in ms, empty or 0 for frames that are
+/// not sent cyclically. Empty lines, lines starting with # and header line starting with "id" are skipped.
+/// \param[in] text File contents
+/// \param[out] lines Schedule lines
+/// \param[out] error Description of first malformed line, set if false is returned
+/// \return false if document is malformed
+bool fromCsv(const QString& text, std::vector<SenderTableModel::Line>& lines, QString& error);
+
+/// \brief Builds schedule from DBC messages
+///
+/// Every message becomes line with zero payload of message length, cyclic with GenMsgCycleTime if the attribute is
+/// set.
+/// \param[in] text DBC file contents
+/// \param[out] lines Schedule lines
+/// \param[out] error Description of malformed DBC, set if false is returned
+/// \return false if document is malformed
+bool fromDbc(const QString& text, std::vector<SenderTableModel::Line>& lines, QString& error);
+
+/// \brief Reads schedule file, files with .dbc suffix are read as DBC, all others as CSV
+/// \param[in] path File path
+/// \param[out] lines Schedule lines
+/// \param[out] error Description of failure, set if false is returned
+/// \return false if file cannot be read or is malformed
+bool load(const QString& path, std::vector<SenderTableModel::Line>& lines, QString& error);
+
+} // namespace ScheduleImport
+
+#endif // SCHEDULEIMPORT_H
@@ -0,0 +1,450 @@
+#include "sendertablemodel.h"
+#include <QtCore/QRegExp>
+#include <algorithm>
+#include <canframerecord.h>
+#include <chrono>
+
+namespace {
+// Editors accept every prefix of valid input, so patterns also match partially typed values
+const char* const kIdPattern = "[1]?[0-9A-Fa-f]{0,7}";
+// Up to 64 bytes. Payload longer than 8 bytes is sent as CAN FD frame.
+const char* const kDataPattern = "[0-9A-Fa-f]{0,128}";
+const char* const kIntervalPattern = "([1-9]\\d{0,6})?";
+} // namespace
+
+SenderTableModel::SenderTableModel(TxScheduler& scheduler, QObject* parent)
+    : QAbstractTableModel(parent)
+    , _scheduler(scheduler)
+{
+}
+
+SenderTableModel::~SenderTableModel()
+{
+    for (auto& row : _rows) {
+        _scheduler.remove(row.txEntry);
+    }
+}
+
+int SenderTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(_rows.size());
+}
+
+int SenderTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SenderTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (index.row() >= rowCount())) {
+        return {};
+    }
+
+    const Row& row = _rows[index.row()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        switch (index.column()) {
+        case IdColumn:
+            return row.line.id;
+        case DataColumn:
+            return row.line.data;
+        case IntervalColumn:
+            return row.line.interval;
+        case SendColumn:
+            return QString("Send");
+        default:
+            return {};
+        }
+
+    case Qt::CheckStateRole:
+        if (index.column() == LoopColumn) {
+            return row.line.loop ? Qt::Checked : Qt::Unchecked;
+        }
+        return {};
+
+    case Qt::TextAlignmentRole:
+        return static_cast<int>(Qt::AlignCenter);
+
+    case SendRole:
+        return (index.column() == SendColumn) && canSend(row);
+
+    case PlaceholderRole:
+        switch (index.column()) {
+        case IdColumn:
+            return QString("Id in hex");
+        case DataColumn:
+            return QString("Data in hex");
+        case IntervalColumn:
+            return QString(row.line.loop ? "Time in ms" : "Select Loop");
+        default:
+            return {};
+        }
+
+    case PatternRole:
+        return pattern(index.column());
+
+    default:
+        return {};
+    }
+}
+
+bool SenderTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || (index.row() >= rowCount())) {
+        return false;
+    }
+
+    Row& row = _rows[index.row()];
+
+    if (role == SendRole) {
+        return (index.column() == SendColumn) && send(index.row());
+    }
+
+    if ((role == Qt::CheckStateRole) && (index.column() == LoopColumn)) {
+        row.line.loop = (static_cast<Qt::CheckState>(value.toInt()) == Qt::Checked);
+        if (!row.line.loop) {
+            stopCyclic(row);
+        }
+        rowChanged(index.row());
+        return true;
+    }
+
+    if ((role != Qt::EditRole) || !(flags(index) & Qt::ItemIsEditable)) {
+        return false;
+    }
+
+    const QString text = value.toString();
+    if (!matches(index.column(), text)) {
+        return false;
+    }
+
+    switch (index.column()) {
+    case IdColumn:
+        row.line.id = text;
+        row.frameDirty = true;
+        break;
+    case DataColumn:
+        row.line.data = text;
+        row.frameDirty = true;
+        break;
+    case IntervalColumn:
+        row.line.interval = text;
+        break;
+    default:
+        return false;
+    }
+
+    // Send column depends on id
+    rowChanged(index.row());
+
+    return true;
+}
+
+Qt::ItemFlags SenderTableModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid() || (index.row() >= rowCount())) {
+        return Qt::NoItemFlags;
+    }
+
+    const Row& row = _rows[index.row()];
+    const bool cyclic = row.txEntry != TxScheduler::kInvalidEntry;
+    // Cells stay selectable regardless of state, so that whole rows can be selected for removal
+    Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+
+    switch (index.column()) {
+    case IdColumn:
+    case DataColumn:
+        if (!cyclic) {
+            flags |= Qt::ItemIsEditable;
+        }
+        break;
+    case IntervalColumn:
+        if (row.line.loop && !cyclic) {
+            flags |= Qt::ItemIsEditable;
+        }
+        break;
+    case LoopColumn:
+        flags |= Qt::ItemIsUserCheckable;
+        break;
+    default:
+        break;
+    }
+
+    return flags;
+}
+
+QVariant SenderTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case IdColumn:
+        return QString("Id");
+    case DataColumn:
+        return QString("Data");
+    case LoopColumn:
+        return QString("Loop");
+    case IntervalColumn:
+        return QString("Interval");
+    default:
+        return QString();
+    }
+}
+
+bool SenderTableModel::insertRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || (row < 0) || (row > rowCount()) || (count <= 0)) {
+        return false;
+    }
+
+    beginInsertRows(parent, row, row + count - 1);
+    _rows.insert(_rows.begin() + row, static_cast<std::size_t>(count), Row());
+    endInsertRows();
+
+    return true;
+}
+
+bool SenderTableModel::removeRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || (row < 0) || (count <= 0) || (row + count > rowCount())) {
+        return false;
+    }
+
+    beginRemoveRows(parent, row, row + count - 1);
+    for (int i = row; i < row + count; ++i) {
+        _scheduler.remove(_rows[i].txEntry);
+    }
+    _rows.erase(_rows.begin() + row, _rows.begin() + row + count);
+    endRemoveRows();
+
+    return true;
+}
+
+void SenderTableModel::appendLines(const std::vector<Line>& lines)
+{
+    if (lines.empty()) {
+        return;
+    }
+
+    const int first = rowCount();
+
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(lines.size()) - 1);
+    _rows.reserve(_rows.size() + lines.size());
+    for (const auto& line : lines) {
+        _rows.push_back(makeRow(line));
+    }
+    endInsertRows();
+}
+
+void SenderTableModel::setLines(const std::vector<Line>& lines)
+{
+    beginResetModel();
+    for (auto& row : _rows) {
+        stopCyclic(row);
+    }
+    _rows.clear();
+    _rows.reserve(lines.size());
+    for (const auto& line : lines) {
+        _rows.push_back(makeRow(line));
+    }
+    endResetModel();
+}
+
+void SenderTableModel::removeLines(std::vector<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [this](int row) { return (row < 0) || (row >= rowCount()); }),
+        rows.end());
+
+    // From the end, so that rows of ranges not yet removed keep their numbers
+    auto last = rows.rbegin();
+    while (last != rows.rend()) {
+        auto first = last;
+
+        while ((std::next(first) != rows.rend()) && (*std::next(first) == *first - 1)) {
+            ++first;
+        }
+
+        removeRows(*first, *last - *first + 1);
+        last = std::next(first);
+    }
+}
+
+const SenderTableModel::Line& SenderTableModel::line(int row) const
+{
+    return _rows.at(static_cast<std::size_t>(row)).line;
+}
+
+bool SenderTableModel::send(int row)
+{
+    if ((row < 0) || (row >= rowCount()) || !canSend(_rows[row])) {
+        return false;
+    }
+
+    Row& r = _rows[row];
+
+    emit sendFrame(encodedFrame(r));
+
+    if ((r.txEntry == TxScheduler::kInvalidEntry) && r.line.loop) {
+        const auto delay = r.line.interval.toUInt();
+
+        if (delay != 0) {
+            // Scheduler sends precomposed frame, no text is parsed per transmission
+            r.txEntry = _scheduler.add(r.frame, std::chrono::milliseconds(delay), r.payloadMutator);
+            rowChanged(row);
+        }
+    }
+
+    return true;
+}
+
+int SenderTableModel::startCyclic()
+{
+    std::vector<TxScheduler::Cyclic> entries;
+    std::vector<std::size_t> rows;
+
+    for (std::size_t i = 0; i < _rows.size(); ++i) {
+        Row& row = _rows[i];
+        const auto delay = row.line.interval.toUInt();
+
+        if (canSend(row) && row.line.loop && (delay != 0) && (row.txEntry == TxScheduler::kInvalidEntry)) {
+            entries.push_back({ encodedFrame(row), std::chrono::milliseconds(delay), row.payloadMutator });
+            rows.push_back(i);
+        }
+    }
+
+    if (entries.empty()) {
+        return 0;
+    }
+
+    const auto ids = _scheduler.addAll(entries);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        _rows[rows[i]].txEntry = ids[i];
+    }
+
+    emit dataChanged(index(0, 0), index(rowCount() - 1, ColumnCount - 1));
+
+    return static_cast<int>(entries.size());
+}
+
+bool SenderTableModel::isCyclic(int row) const
+{
+    return _rows.at(static_cast<std::size_t>(row)).txEntry != TxScheduler::kInvalidEntry;
+}
+
+void SenderTableModel::setPayloadMutator(int row, const TxScheduler::PayloadMutator& mutator)
+{
+    _rows.at(static_cast<std::size_t>(row)).payloadMutator = mutator;
+}
+
+void SenderTableModel::setSimulationState(bool state)
+{
+    _simulationState = state;
+
+    if (!state) {
+        for (auto& row : _rows) {
+            stopCyclic(row);
+        }
+    }
+
+    if (!_rows.empty()) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, ColumnCount - 1));
+    }
+}
+
+void SenderTableModel::lineToJson(int row, QJsonObject& json) const
+{
+    const Line& l = line(row);
+
+    json["id"] = l.id;
+    json["data"] = l.data;
+    json["interval"] = l.interval;
+    json["loop"] = l.loop ? 1 : 0;
+}
+
+QString SenderTableModel::pattern(int column)
+{
+    switch (column) {
+    case IdColumn:
+        return kIdPattern;
+    case DataColumn:
+        return kDataPattern;
+    case IntervalColumn:
+        return kIntervalPattern;
+    default:
+        return {};
+    }
+}
+
+const QCanBusFrame& SenderTableModel::encodedFrame(Row& row)
+{
+    if (row.frameDirty) {
+        QByteArray payload = QByteArray::fromHex(row.line.data.toUtf8());
+        const bool canFd = payload.size() > 8;
+
+        if (canFd) {
+            // FD payload lengths come in DLC steps, the rest is zero padded
+            payload.append(QByteArray(canFdLength(payload.size()) - payload.size(), '\0'));
+        }
+
+        row.frame.setFrameId(row.line.id.toUInt(nullptr, 16));
+        row.frame.setPayload(payload);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+        row.frame.setFlexibleDataRateFormat(canFd);
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+        // Data phase runs at data bitrate of the device
+        row.frame.setBitrateSwitch(canFd);
+#endif
+        row.frameDirty = false;
+    }
+
+    return row.frame;
+}
+
+void SenderTableModel::stopCyclic(Row& row)
+{
+    _scheduler.remove(row.txEntry);
+    row.txEntry = TxScheduler::kInvalidEntry;
+}
+
+bool SenderTableModel::canSend(const Row& row) const
+{
+    return _simulationState && !row.line.id.isEmpty();
+}
+
+void SenderTableModel::rowChanged(int row)
+{
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+}
+
+SenderTableModel::Row SenderTableModel::makeRow(const Line& line)
+{
+    Row row;
+
+    row.line.id = matches(IdColumn, line.id) ? line.id : QString();
+    row.line.data = matches(DataColumn, line.data) ? line.data : QString();
+    row.line.loop = line.loop;
+    row.line.interval = matches(IntervalColumn, line.interval) ? line.interval : QString();
+
+    return row;
+}
+
+bool SenderTableModel::matches(int column, const QString& text)
+{
+    // Compiled once, bulk operations validate thousands of fields
+    static const QRegExp expressions[ColumnCount] = { QRegExp(pattern(IdColumn)), QRegExp(pattern(DataColumn)),
+        QRegExp(pattern(LoopColumn)), QRegExp(pattern(IntervalColumn)), QRegExp(pattern(SendColumn)) };
+
+    if ((column < 0) || (column >= ColumnCount) || expressions[column].isEmpty()) {
+        return true;
+    }
+
+    return expressions[column].exactMatch(text);
+}
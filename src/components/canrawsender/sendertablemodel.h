@@ -0,0 +1,135 @@
+#ifndef SENDERTABLEMODEL_H
+#define SENDERTABLEMODEL_H
+
+#include "txscheduler.h"
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QJsonObject>
+#include <QtSerialBus/QCanBusFrame>
+#include <vector>
+
+/// \class SenderTableModel
+/// \brief Lines of CanRawSender kept as plain data
+///
+/// Columns are edited through item delegate (see SenderItemDelegate), so widgets exist only for the cell being
+/// edited. Send column is activated with setData(index, true, SendRole). Frame is encoded once after line was
+/// edited, cyclic lines are registered in TxScheduler and sent without parsing text per transmission. While line
+/// is sent cyclically its id, data and interval cannot be edited.
+class SenderTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { IdColumn = 0, DataColumn, LoopColumn, IntervalColumn, SendColumn, ColumnCount };
+
+    enum Role {
+        SendRole = Qt::UserRole + 1, ///< setData sends line, data tells if send is possible now
+        PlaceholderRole, ///< hint shown in empty cell
+        PatternRole ///< regular expression editor input has to match, see pattern()
+    };
+
+    /// \brief Plain content of line, as saved in project
+    struct Line {
+        QString id;
+        QString data;
+        bool loop{ false };
+        QString interval;
+    };
+
+    /// \brief constructor
+    /// \param[in] scheduler Scheduler of cyclic lines, has to outlive the model
+    /// \param[in] parent Parent object
+    explicit SenderTableModel(TxScheduler& scheduler, QObject* parent = nullptr);
+
+    /// \brief destructor
+    /// \brief Unregisters cyclic frames from scheduler
+    ~SenderTableModel();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /// \brief Inserts empty lines
+    bool insertRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+
+    /// \brief Removes lines, cyclic transmission of removed lines stops
+    bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+
+    /// \brief Appends lines with single model notification
+    /// \param[in] lines Lines to be appended, fields not matching pattern() are cleared
+    void appendLines(const std::vector<Line>& lines);
+
+    /// \brief Replaces all lines with single model reset. Cyclic transmission of previous lines stops.
+    /// \param[in] lines New lines, fields not matching pattern() are cleared
+    void setLines(const std::vector<Line>& lines);
+
+    /// \brief Removes lines given in any order, adjacent rows are removed with single notification
+    /// \param[in] rows Row numbers, duplicates are ignored
+    void removeLines(std::vector<int> rows);
+
+    /// \brief Content of line
+    /// \param[in] row Row number
+    const Line& line(int row) const;
+
+    /// \brief Sends line once, starts cyclic transmission if loop is set and interval is given
+    /// \param[in] row Row number
+    /// \return false if line cannot be sent (no id or simulation stopped)
+    bool send(int row);
+
+    /// \brief Starts cyclic transmission of all lines with loop and interval set, registering them with scheduler
+    /// at once. Unlike send() no frame is sent immediately, first transmission of every line follows one interval
+    /// later, so that large schedules do not start with a burst.
+    /// \return Number of lines started, 0 if simulation is stopped
+    int startCyclic();
+
+    /// \brief Indicates whether line is sent cyclically
+    bool isCyclic(int row) const;
+
+    /// \brief Sets hook modifying payload of cyclic frame before each transmission. Takes effect on next start of
+    /// cyclic transmission.
+    /// \param[in] row Row number
+    /// \param[in] mutator Payload hook, empty to send payload as entered
+    void setPayloadMutator(int row, const TxScheduler::PayloadMutator& mutator);
+
+    /// \brief Propagates simulation state. Lines can be sent only while simulation runs, stopping it stops cyclic
+    /// transmissions.
+    void setSimulationState(bool state);
+
+    /// \brief Writes line in project format
+    void lineToJson(int row, QJsonObject& json) const;
+
+    /// \brief Regular expression accepted by editor of column
+    /// \return pattern, empty for columns not edited as text
+    static QString pattern(int column);
+
+    /// \brief Checks text against pattern() of column
+    /// \return true if text is valid content of column
+    static bool matches(int column, const QString& text);
+
+signals:
+    /// \brief Emitted for every frame sent by hand, cyclic frames are delivered by TxScheduler
+    void sendFrame(const QCanBusFrame& frame);
+
+private:
+    struct Row {
+        Line line;
+        QCanBusFrame frame;
+        bool frameDirty{ true };
+        TxScheduler::PayloadMutator payloadMutator;
+        TxScheduler::EntryId txEntry{ TxScheduler::kInvalidEntry };
+    };
+
+    /// \brief Returns frame encoded from line. Text is parsed only once after it was edited.
+    const QCanBusFrame& encodedFrame(Row& row);
+    void stopCyclic(Row& row);
+    bool canSend(const Row& row) const;
+    void rowChanged(int row);
+    static Row makeRow(const Line& line);
+
+    TxScheduler& _scheduler;
+    std::vector<Row> _rows;
+    bool _simulationState{ false };
+};
+
+#endif // SENDERTABLEMODEL_H
@@ -0,0 +1,281 @@
+#include "txscheduler.h"
+
+constexpr TxScheduler::EntryId TxScheduler::kInvalidEntry;
+constexpr int TxScheduler::kMaxPendingFrames;
+
+TxScheduler::TxScheduler(QObject* parent)
+    : QObject(parent)
+    , _worker(*this)
+{
+    _worker.setObjectName("TxScheduler");
+}
+
+TxScheduler::~TxScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+
+    _cv.notify_one();
+    _worker.wait();
+}
+
+TxScheduler::EntryId TxScheduler::add(
+    const QCanBusFrame& frame, std::chrono::microseconds period, PayloadMutator mutator)
+{
+    EntryId id;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        id = _nextId++;
+        schedule(id, Entry{ frame, period, Clock::now() + period, std::move(mutator), 0, {} });
+    }
+
+    _cv.notify_one();
+
+    return id;
+}
+
+std::vector<TxScheduler::EntryId> TxScheduler::addAll(const std::vector<Cyclic>& entries)
+{
+    std::vector<EntryId> ids;
+
+    if (entries.empty()) {
+        return ids;
+    }
+
+    ids.reserve(entries.size());
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto now = Clock::now();
+
+        _entries.reserve(_entries.size() + entries.size());
+        for (const auto& cyclic : entries) {
+            const EntryId id = _nextId++;
+
+            schedule(id, Entry{ cyclic.frame, cyclic.period, now + cyclic.period, cyclic.mutator, 0, {} });
+            ids.push_back(id);
+        }
+    }
+
+    _cv.notify_one();
+
+    return ids;
+}
+
+TxScheduler::EntryId TxScheduler::addSequence(const QVector<QCanBusFrame>& frames, std::chrono::microseconds interval)
+{
+    if (frames.isEmpty()) {
+        return kInvalidEntry;
+    }
+
+    EntryId id;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        id = _nextId++;
+        schedule(id, Entry{ QCanBusFrame(), interval, Clock::now(), {}, 0, frames });
+    }
+
+    _cv.notify_one();
+
+    return id;
+}
+
+void TxScheduler::schedule(EntryId id, Entry&& entry)
+{
+    _heap.push(HeapItem{ entry.deadline, id });
+    _entries[id] = std::move(entry);
+
+    // Thread is started on first use
+    if (!_worker.isRunning()) {
+        _worker.start(QThread::TimeCriticalPriority);
+    }
+}
+
+bool TxScheduler::update(EntryId id, const QCanBusFrame& frame)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(id);
+
+    if (it == _entries.end()) {
+        return false;
+    }
+
+    it->second.frame = frame;
+
+    return true;
+}
+
+void TxScheduler::remove(EntryId id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Heap item is dropped lazily when it reaches the top
+    _entries.erase(id);
+}
+
+std::size_t TxScheduler::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _entries.size();
+}
+
+void TxScheduler::setTiming(const ReleaseTiming& timing)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (timing == _timing) {
+            return;
+        }
+
+        _timing = timing;
+        _timingChanged = true;
+    }
+
+    _cv.notify_one();
+}
+
+ReleaseTiming TxScheduler::timing() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _timing;
+}
+
+Instrumentation::HistogramSnapshot TxScheduler::releaseJitter() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _jitter;
+}
+
+void TxScheduler::resetReleaseJitter()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _jitter = Instrumentation::HistogramSnapshot();
+}
+
+void TxScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_quit) {
+        if (_timingChanged) {
+            _timingChanged = false;
+            _timing.applyToCurrentThread();
+        }
+
+        if (_heap.empty()) {
+            _cv.wait(lock);
+            continue;
+        }
+
+        const HeapItem top = _heap.top();
+        auto it = _entries.find(top.id);
+
+        if (it == _entries.end()) {
+            // Entry removed in the meantime
+            _heap.pop();
+            continue;
+        }
+
+        const auto now = Clock::now();
+        if (now < top.deadline) {
+            const auto wakeUp = _timing.wakeUp(top.deadline);
+
+            if (now < wakeUp) {
+                _cv.wait_until(lock, wakeUp);
+            } else {
+                // Entries added or removed while spinning are seen right after the deadline
+                lock.unlock();
+                ReleaseTiming::spinUntil<Clock>(top.deadline);
+                lock.lock();
+            }
+            continue;
+        }
+
+        while (!_heap.empty() && (_heap.top().deadline <= now)) {
+            const HeapItem item = _heap.top();
+            _heap.pop();
+
+            it = _entries.find(item.id);
+            if (it == _entries.end()) {
+                continue;
+            }
+
+            Entry& entry = it->second;
+            const auto lateUs = static_cast<quint64>(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - item.deadline).count());
+
+            if (!entry.sequence.isEmpty()) {
+                _due.append(entry.sequence[static_cast<int>(entry.count++)]);
+                recordRelease(lateUs);
+
+                if (static_cast<int>(entry.count) == entry.sequence.size()) {
+                    _entries.erase(it);
+                } else {
+                    // Relative to this transmission, separation is minimal time between frames
+                    entry.deadline = now + entry.period;
+                    _heap.push(HeapItem{ entry.deadline, item.id });
+                }
+                continue;
+            }
+
+            if (_due.size() < kMaxPendingFrames) {
+                if (entry.mutator) {
+                    // Payload is shared with frames already delivered, data() detaches it
+                    QByteArray payload = entry.frame.payload();
+                    entry.mutator(reinterpret_cast<quint8*>(payload.data()), payload.size(), entry.count);
+                    entry.frame.setPayload(payload);
+                }
+
+                _due.append(entry.frame);
+                ++entry.count;
+                recordRelease(lateUs);
+            }
+
+            // Absolute deadlines. Periods missed completely (e.g. system suspended) are skipped, not sent in burst.
+            entry.deadline += entry.period;
+            if (entry.deadline <= now) {
+                const auto missed = (now - entry.deadline) / entry.period + 1;
+                entry.deadline += missed * entry.period;
+            }
+
+            _heap.push(HeapItem{ entry.deadline, item.id });
+        }
+
+        if (!_due.isEmpty() && !_deliveryPending) {
+            _deliveryPending = true;
+            QMetaObject::invokeMethod(this, "deliverDue", Qt::QueuedConnection);
+        }
+    }
+}
+
+void TxScheduler::deliverDue()
+{
+    QVector<QCanBusFrame> frames;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        frames.swap(_due);
+        _deliveryPending = false;
+    }
+
+    if (!frames.isEmpty()) {
+        emit framesDue(frames);
+    }
+}
+
+void TxScheduler::recordRelease(quint64 lateUs)
+{
+    _jitter.add(lateUs);
+    Instrumentation::record(Instrumentation::Histogram::ReleaseLatenessUs, lateUs);
+}
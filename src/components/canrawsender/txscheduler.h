@@ -0,0 +1,173 @@
+#ifndef TXSCHEDULER_H
+#define TXSCHEDULER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <instrumentation.h>
+#include <mutex>
+#include <queue>
+#include <releasetiming.h>
+#include <unordered_map>
+#include <vector>
+
+/// \class TxScheduler
+/// \brief Central scheduler of cyclic frames
+///
+/// Deadlines of all entries are kept in a min-heap and serviced by a single high-priority thread. Deadlines are
+/// absolute (next = previous deadline + period), so jitter of a single wakeup does not accumulate. Due frames are
+/// collected per wakeup and delivered in the thread owning the scheduler with framesDue signal.
+///
+/// With precise timing (see setTiming) the thread sleeps until shortly before the deadline and spins for the rest,
+/// lateness of every release against its deadline is collected in releaseJitter.
+class TxScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    typedef quint64 EntryId;
+    typedef std::chrono::steady_clock Clock;
+
+    /// \brief Hook modifying payload of precomposed frame before each transmission (counters, CRCs, rolling values)
+    ///
+    /// Executed in scheduler thread, must not block. Payload modifications are kept, so next call gets payload of
+    /// previous transmission.
+    /// \param[in,out] payload Payload bytes
+    /// \param[in] length Payload length
+    /// \param[in] count Number of transmissions of this entry so far
+    typedef std::function<void(quint8* payload, int length, quint64 count)> PayloadMutator;
+
+    /// \brief Cyclic frame registered with addAll
+    struct Cyclic {
+        QCanBusFrame frame;
+        std::chrono::microseconds period;
+        PayloadMutator mutator;
+    };
+
+    /// \brief Invalid entry id, never returned by add
+    static constexpr EntryId kInvalidEntry = 0;
+
+    /// \brief Maximum number of frames waiting for delivery. Frames due while owner thread is blocked for long time
+    /// are dropped above this limit.
+    static constexpr int kMaxPendingFrames = 65536;
+
+    explicit TxScheduler(QObject* parent = nullptr);
+    ~TxScheduler();
+
+    /// \brief Registers cyclic frame. First transmission is scheduled one period from now.
+    /// \param[in] frame Frame to be sent
+    /// \param[in] period Transmission period, must be greater than 0
+    /// \param[in] mutator Optional payload hook, see PayloadMutator
+    /// \return Entry id used to unregister frame
+    EntryId add(const QCanBusFrame& frame, std::chrono::microseconds period, PayloadMutator mutator = {});
+
+    /// \brief Registers many cyclic frames at once (restbus schedules), scheduler thread is woken up only once.
+    /// First transmission of each frame is scheduled one period from the same point in time.
+    /// \param[in] entries Frames to be sent, periods must be greater than 0
+    /// \return Entry ids in order of entries
+    std::vector<EntryId> addAll(const std::vector<Cyclic>& entries);
+
+    /// \brief Schedules frames sent once each, first one immediately, then one per interval (transport protocol
+    /// blocks paced by separation time). Spacing is measured from actual transmission of the previous frame, so a
+    /// late wakeup never sends two frames closer than interval. Entry is removed after its last frame.
+    /// \param[in] frames Frames to be sent in order
+    /// \param[in] interval Minimal separation of consecutive frames, 0 sends all frames at once
+    /// \return Entry id used to cancel the rest of sequence, kInvalidEntry if frames is empty
+    EntryId addSequence(const QVector<QCanBusFrame>& frames, std::chrono::microseconds interval);
+
+    /// \brief Replaces precomposed frame of registered entry. Schedule and transmission count are kept.
+    /// \param[in] id Entry id returned by add
+    /// \param[in] frame New frame
+    /// \return false if entry does not exist
+    bool update(EntryId id, const QCanBusFrame& frame);
+
+    /// \brief Unregisters cyclic frame. Unknown ids are ignored.
+    /// \param[in] id Entry id returned by add
+    void remove(EntryId id);
+
+    /// \brief Number of registered entries
+    std::size_t size() const;
+
+    /// \brief Sets how scheduler thread waits for deadlines. Affinity and priority are applied to the thread when it
+    /// wakes up next, default timing restores default scheduling.
+    /// \param[in] timing Hybrid wait, CPU affinity and real-time priority of scheduler thread
+    void setTiming(const ReleaseTiming& timing);
+
+    /// \brief Timing set with setTiming
+    ReleaseTiming timing() const;
+
+    /// \brief Lateness of releases against their deadlines since last reset, in microseconds
+    Instrumentation::HistogramSnapshot releaseJitter() const;
+
+    /// \brief Clears releaseJitter, e.g. when simulation starts
+    void resetReleaseJitter();
+
+signals:
+    /// \brief Emitted in thread owning scheduler with all frames that became due since last emission
+    /// \param[in] frames Due frames in deadline order
+    void framesDue(const QVector<QCanBusFrame>& frames);
+
+private slots:
+    void deliverDue();
+
+private:
+    struct Entry {
+        QCanBusFrame frame;
+        Clock::duration period;
+        Clock::time_point deadline;
+        PayloadMutator mutator;
+        quint64 count;
+        QVector<QCanBusFrame> sequence; // one-shot frames of addSequence, frame is unused then
+    };
+
+    struct HeapItem {
+        Clock::time_point deadline;
+        EntryId id;
+
+        bool operator>(const HeapItem& other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+
+    class Worker : public QThread {
+    public:
+        explicit Worker(TxScheduler& scheduler)
+            : _scheduler(scheduler)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            _scheduler.run();
+        }
+
+    private:
+        TxScheduler& _scheduler;
+    };
+
+    void run();
+    void schedule(EntryId id, Entry&& entry);
+    void recordRelease(quint64 lateUs);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::unordered_map<EntryId, Entry> _entries;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> _heap;
+    EntryId _nextId{ kInvalidEntry + 1 };
+    bool _quit{ false };
+    ReleaseTiming _timing;
+    bool _timingChanged{ false }; // timing is applied by scheduler thread itself
+    Instrumentation::HistogramSnapshot _jitter;
+
+    QVector<QCanBusFrame> _due;
+    bool _deliveryPending{ false };
+
+    Worker _worker;
+};
+
+#endif // TXSCHEDULER_H
@@ -25,23 +25,22 @@ void CanRawView::startSimulation()
 {
     Q_D(CanRawView);
 
-    d->_timer.restart();
-    d->_simStarted = true;
-    d->clear();
+    d->closeTrace();
+    d->start();
 }
 
 void CanRawView::stopSimulation()
 {
     Q_D(CanRawView);
 
-    d->_simStarted = false;
+    d->stop();
 }
 
 void CanRawView::frameReceived(const QCanBusFrame& frame)
 {
     Q_D(CanRawView);
 
-    d->frameView(frame, "RX");
+    d->frameView({ toCanFrameRecord(frame, Direction::RX) });
 }
 
 void CanRawView::frameSent(bool status, const QCanBusFrame& frame)
@@ -49,7 +48,23 @@ void CanRawView::frameSent(bool status, const QCanBusFrame& frame)
     Q_D(CanRawView);
 
     if (status) {
-        d->frameView(frame, "TX");
+        d->frameView({ toCanFrameRecord(frame, Direction::TX) });
+    }
+}
+
+void CanRawView::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(CanRawView);
+
+    d->frameView(frames);
+}
+
+void CanRawView::frameBatchSent(bool status, const CanFrameBatch& frames)
+{
+    Q_D(CanRawView);
+
+    if (status) {
+        d->frameView(frames);
     }
 }
 
@@ -60,9 +75,25 @@ QWidget* CanRawView::getMainWidget()
     return d->_ui.getMainWidget();
 }
 
-void CanRawView::setConfig(QJsonObject&)
+void CanRawView::setConfig(QJsonObject& json)
 {
-    // TODO
+    Q_D(CanRawView);
+
+    if (json.contains("retention")) {
+        d->model().setRetention(json["retention"].toInt(FrameTableModel::kDefaultRetention));
+    }
+
+    if (json.contains("acceptanceFilters")) {
+        d->setAcceptanceFilters(canFiltersFromJson(json["acceptanceFilters"].toArray()));
+    }
+
+    if (json.contains("displayRate")) {
+        d->setDisplayRate(json["displayRate"].toInt(FrameCapture::kDefaultDisplayRate));
+    }
+
+    if (json.contains("changeMode")) {
+        d->setChangeMode(json["changeMode"].toBool());
+    }
 }
 
 QJsonObject CanRawView::getConfig() const
@@ -82,7 +113,89 @@ void CanRawView::setDockUndockClbk(const std::function<void()>& cb)
     d->_ui.setDockUndockCbk(cb);
 }
 
+bool CanRawView::mainWidgetCreated() const
+{
+    return d_ptr->_ui.isMainWidgetCreated();
+}
+
 bool CanRawView::mainWidgetDocked() const
 {
     return d_ptr->docked;
 }
+
+CanFilterList CanRawView::acceptanceFilters() const
+{
+    return d_ptr->_acceptanceFilters;
+}
+
+void CanRawView::setIdDirectory(const std::shared_ptr<FrameIdDirectory>& directory)
+{
+    d_ptr->setIdDirectory(directory);
+}
+
+void CanRawView::setLoadLevel(LoadLevel level)
+{
+    d_ptr->setLoadLevel(level);
+}
+
+ComponentSideData CanRawView::sideData() const
+{
+    return d_ptr->sideData();
+}
+
+void CanRawView::loadSideData(const QString& path)
+{
+    if (!d_ptr->openTrace(path)) {
+        cds_warn("View contents could not be restored from '{}'", path.toStdString());
+    }
+}
+
+bool CanRawView::openTrace(const QString& path)
+{
+    return d_ptr->openTrace(path);
+}
+
+void CanRawView::closeTrace()
+{
+    d_ptr->closeTrace();
+}
+
+void CanRawView::setChangeMode(bool changes)
+{
+    d_ptr->setChangeMode(changes);
+}
+
+bool CanRawView::changeMode() const
+{
+    return d_ptr->changeMode();
+}
+
+void CanRawView::search(const QString& query)
+{
+    d_ptr->search(query);
+}
+
+bool CanRawView::exportFrames(const QString& path)
+{
+    return d_ptr->exportFrames(path);
+}
+
+void CanRawView::shareCapture(CanRawView* other)
+{
+    d_ptr->shareCapture(other ? other->d_ptr.data() : nullptr);
+}
+
+bool CanRawView::sharesCapture(const CanRawView& other) const
+{
+    return d_ptr->sharesCapture(*other.d_ptr);
+}
+
+int CanRawView::frameCount() const
+{
+    return d_ptr->model().rowCount();
+}
+
+bool CanRawView::isTraceOpen() const
+{
+    return d_ptr->_traceModel.isOpen();
+}
@@ -3,11 +3,13 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <canframerecord.h>
 #include <componentinterface.h>
 #include <context.h>
 #include <memory>
 
-class QCanBusFrame;
 class CanRawViewPrivate;
 class QWidget;
 
@@ -25,6 +27,12 @@ public:
     */
     QWidget* getMainWidget() override;
 
+    /**
+    *   @brief  Main widget is built when it is shown for the first time
+    *   @see ComponentInterface
+    */
+    bool mainWidgetCreated() const override;
+
     /**
     *   @see ComponentInterface
     */
@@ -45,9 +53,99 @@ public:
     */
     bool mainWidgetDocked() const override;
 
+    /**
+    *   @brief  Filters set with "acceptanceFilters" config key. Frames not matching them are not displayed.
+    *   @see ComponentInterface
+    */
+    CanFilterList acceptanceFilters() const override;
+
+    /**
+    *   @brief  Capture of view fed by single device indexes its frames by IDs of the device
+    *   @see ComponentInterface
+    */
+    void setIdDirectory(const std::shared_ptr<FrameIdDirectory>& directory) override;
+
+    /**
+    *   @brief  View is refreshed less often, sorted lazily and finally shows sample of frames only while main
+    *           thread is overloaded. Overload is shown in the view.
+    *   @see ComponentInterface
+    */
+    void setLoadLevel(LoadLevel level) override;
+
+    /**
+    *   @brief  View contents are stored in side file as trace
+    *   @see ComponentInterface
+    */
+    ComponentSideData sideData() const override;
+
+    /**
+    *   @brief  Opens side file in offline trace view
+    *   @see ComponentInterface
+    */
+    void loadSideData(const QString& path) override;
+
+    /**
+    *   @brief  Switches view to offline browsing of binary trace (e.g. written by TraceLogger)
+    *   @param  path trace file path
+    *   @return false if trace could not be opened
+    */
+    bool openTrace(const QString& path);
+
+    /**
+    *   @brief  Closes trace and returns to live view
+    */
+    void closeTrace();
+
+    bool isTraceOpen() const;
+
+    /**
+    *   @brief  Switches to change-detection view, showing one row per id and direction with bytes changed by its
+    *           last update highlighted. Rows are updated only when payload bits change. Set with "changeMode"
+    *           config key as well.
+    *   @param  changes true for change view, false for frame history
+    */
+    void setChangeMode(bool changes);
+
+    bool changeMode() const;
+
+    /**
+    *   @brief  Shows only frames matching query, e.g. "id:100-1ff dir:rx data:11??22" (see FrameQuery). Capture is
+    *           scanned in parallel chunks and results appear progressively.
+    *   @param  query search query, empty to show all frames
+    */
+    void search(const QString& query);
+
+    /**
+    *   @brief  Exports what the view currently shows (live capture or open trace) in background thread. Format is
+    *           chosen by file suffix: .asc, .blf, .log (candump) or .pcapng.
+    *   @param  path output file, existing file is overwritten
+    *   @return false if format is not known or view is empty
+    */
+    bool exportFrames(const QString& path);
+
+    /**
+    *   @brief  Makes view projection of capture of other view, e.g. when both show the same device. Frames are
+    *           then stored once, each view keeps its own filter, sort order, columns and unique mode. Frames have
+    *           to be passed to all views sharing capture, only the first view stores them.
+    *   @param  other view whose capture is shared, nullptr to give view its own, empty capture again
+    */
+    void shareCapture(CanRawView* other);
+
+    /**
+    *   @return true if both views project the same capture
+    */
+    bool sharesCapture(const CanRawView& other) const;
+
+    /**
+    *   @return number of frames in capture of view, without filters of view applied
+    */
+    int frameCount() const;
+
 public slots:
     void frameReceived(const QCanBusFrame& frame);
     void frameSent(bool status, const QCanBusFrame& frame);
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
     void stopSimulation(void);
     void startSimulation(void);
 
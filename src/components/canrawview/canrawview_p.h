@@ -1,15 +1,26 @@
 #ifndef CANRAWVIEW_P_H
 #define CANRAWVIEW_P_H
 
+#include "changetablemodel.h"
+#include "framecapture.h"
+#include "framesearch.h"
+#include "frametablemodel.h"
 #include "gui/crvgui.h"
+#include "tracetablemodel.h"
 #include "uniquefiltermodel.h"
-#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QSortFilterProxyModel>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
-#include <QtGui/QStandardItemModel>
 #include <QtSerialBus/QCanBusFrame>
+#include <canframerecord.h>
+#include <componentinterface.h>
 #include <log.h>
+#include <traceexporter.h>
+#include <tracewriter.h>
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 class CanRawViewPrivate : public QObject {
     Q_OBJECT
@@ -20,87 +31,461 @@ public:
         : _ctx(std::move(ctx))
         , _simStarted(false)
         , _ui(_ctx.get<CRVGuiInterface>())
-        , _columnsOrder({ "rowID", "timeDouble", "time", "idInt", "id", "dir", "dlc", "data" })
+        , _columnsOrder({ "rowID", "timeDouble", "time", "idInt", "id", "dir", "dlc", "flags", "data" })
         , q_ptr(q)
     {
-        _tvModel.setHorizontalHeaderLabels(_columnsOrder);
-
-        _ui.initTableView(_tvModel);
-        _uniqueModel.setSourceModel(&_tvModel);
+        _changeProxy.setSourceModel(&_changeModel);
+        setCapture(std::make_shared<FrameCapture>());
+        _ui.initTableView(_capture->model());
         _ui.setModel(&_uniqueModel);
 
         _ui.setClearCbk(std::bind(&CanRawViewPrivate::clear, this));
         _ui.setSectionClikedCbk(std::bind(&CanRawViewPrivate::sort, this, std::placeholders::_1));
         _ui.setFilterCbk(std::bind(&CanRawViewPrivate::setFilter, this));
         _ui.setDockUndockCbk([this] { docked = !docked; });
+        _ui.setOpenTraceCbk([this](const QString& path) {
+            if (path.isEmpty()) {
+                closeTrace();
+            } else {
+                openTrace(path);
+            }
+        });
+        _ui.setGoToTimeCbk(std::bind(&CanRawViewPrivate::goToTime, this, std::placeholders::_1));
+        _ui.setIdFilterCbk(std::bind(&CanRawViewPrivate::setIdFilter, this, std::placeholders::_1));
+        _ui.setChangeModeCbk(std::bind(&CanRawViewPrivate::setChangeMode, this, std::placeholders::_1));
+        _ui.setSearchCbk(std::bind(&CanRawViewPrivate::search, this, std::placeholders::_1));
+        _ui.setExportCbk([this](const QString& path) { exportFrames(path); });
+
+        connect(&_exporter, &TraceExporter::exported, this, [](const QString& path, bool status) {
+            if (status) {
+                cds_info("View contents exported to '{}'", path.toStdString());
+            }
+        });
     }
 
     ~CanRawViewPrivate()
     {
+        _capture->detach(this);
     }
 
     void saveSettings(QJsonObject& json)
     {
         QJsonObject jSortingObject;
-        QJsonArray viewModelsArray;
 
         writeColumnsOrder(json);
         writeSortingRules(jSortingObject);
         json["sorting"] = std::move(jSortingObject);
         json["scrolling"] = _ui.isViewFrozen();
-        writeViewModel(viewModelsArray);
-        json["models"] = std::move(viewModelsArray);
+        json["retention"] = model().retention();
+        json["displayRate"] = _capture->displayRate();
+        json["changeMode"] = _changeMode;
+        json["acceptanceFilters"] = canFiltersToJson(_acceptanceFilters);
     }
 
-    void frameView(const QCanBusFrame& frame, const QString& direction)
+    void frameView(const CanFrameBatch& frames)
     {
         if (!_simStarted) {
             cds_debug("send/received frame while simulation stopped");
             return;
         }
 
-        auto payHex = frame.payload().toHex();
-        // insert space between bytes, skip the end
-        for (int ii = payHex.size() - 2; ii >= 2; ii -= 2) {
-            payHex.insert(ii, ' ');
+        _capture->append(this, frames);
+    }
+
+    /**
+    *   @brief  Starts capture, view leading shared capture clears it for all views
+    */
+    void start()
+    {
+        _simStarted = true;
+        _changeModel.clear();
+        _capture->start(this);
+    }
+
+    void stop()
+    {
+        _simStarted = false;
+        _capture->stop(this);
+    }
+
+    FrameTableModel& model()
+    {
+        return _capture->model();
+    }
+
+    const FrameTableModel& model() const
+    {
+        return _capture->model();
+    }
+
+    /**
+    *   @brief  Makes view projection of capture. View keeps its proxy settings, search is restarted on new capture.
+    *   @param  capture capture of this or other view
+    */
+    void setCapture(const std::shared_ptr<FrameCapture>& capture)
+    {
+        if (capture == _capture) {
+            return;
         }
 
-        QList<QVariant> qvList;
-        QList<QStandardItem*> list;
+        if (_capture) {
+            disconnect(_capture.get(), nullptr, this, nullptr);
+            _capture->detach(this);
+        }
+
+        _capture = capture;
+        _capture->attach(this, _acceptanceFilters);
+        // Joined capture is indexed by the same directory already
+        if (_idDirectory) {
+            _capture->model().setIdDirectory(_idDirectory);
+        }
+        connect(_capture.get(), &FrameCapture::appended, this, &CanRawViewPrivate::framesAppended);
+        connect(_capture.get(), &FrameCapture::viewsChanged, this, &CanRawViewPrivate::updateProjection);
 
-        int frameID = frame.frameId();
-        double time = _timer.elapsed() / 1000.0;
+        // Search keeps sequence numbers of its model, so it is bound to capture
+        _uniqueModel.setSearch(nullptr);
+        _search.reset(new FrameSearch(_capture->model()));
+        connect(_search.get(), &FrameSearch::progress, this, [this](std::size_t matches, bool complete) {
+            _ui.setSearchStatus(QString("%1 matches%2").arg(matches).arg(complete ? "" : "..."));
+        });
+        _ui.setSearchStatus(QString());
 
-        qvList.append(_rowID++);
-        qvList.append(std::move(time));
-        qvList.append(QString::number(time, 'f', 2));
-        qvList.append(std::move(frameID));
-        qvList.append(QString("0x" + QString::number(frameID, 16)));
-        qvList.append(direction);
-        qvList.append(QString::number(frame.payload().size()).toInt());
-        qvList.append(QString::fromUtf8(payHex.data(), payHex.size()));
+        _uniqueModel.setSourceModel(&_capture->model());
+        _uniqueModel.setSearch(_search.get());
+        updateProjection();
 
-        for (QVariant qvitem : qvList) {
-            QStandardItem* item = new QStandardItem();
-            item->setData(qvitem, Qt::DisplayRole);
-            list.append(item);
+        if (_changeMode) {
+            rebuildChangeModel();
         }
+    }
 
-        _tvModel.appendRow(list);
+    /**
+    *   @brief  Shares capture of other view, so that frames are stored once
+    *   @param  other view to share capture with, nullptr to leave shared capture. Own capture starts empty.
+    */
+    void shareCapture(CanRawViewPrivate* other)
+    {
+        if (other) {
+            setCapture(other->_capture);
+        } else if (_capture->viewCount() > 1) {
+            auto capture = std::make_shared<FrameCapture>();
+            const quint64 timeBase = _capture->timeBase();
 
-        // Sort after reception of each frame and appending it to _tvModel
-        _currentSortOrder = _ui.getSortOrder();
-        int currentSortIndicator = _ui.getSortSection();
-        _ui.setSorting(_sortIndex, currentSortIndicator, _currentSortOrder);
+            capture->model().setRetention(_capture->model().retention());
+            capture->setDisplayRate(_capture->displayRate());
+            setCapture(capture);
+
+            if (_simStarted) {
+                _capture->start(this);
+                _capture->setTimeBase(timeBase);
+            }
+        }
+    }
+
+    bool sharesCapture(const CanRawViewPrivate& other) const
+    {
+        return _capture == other._capture;
+    }
 
-        _uniqueModel.updateFilter(frameID, time, direction);
+    /**
+    *   @brief  Updates acceptance filters of view, capture keeps frames accepted by any of its views
+    */
+    void setAcceptanceFilters(const CanFilterList& filters)
+    {
+        _acceptanceFilters = filters;
+        _capture->attach(this, _acceptanceFilters);
+    }
 
-        if (!_ui.isViewFrozen()) {
-            _ui.scrollToBottom();
+    /**
+    *   @brief  Directory of device view is fed by, applies to capture shared with other views of the device
+    */
+    void setIdDirectory(const FrameIdDirectoryPtr& directory)
+    {
+        _idDirectory = directory;
+        _capture->model().setIdDirectory(directory);
+    }
+
+    /**
+    *   @brief  Sets how often buffered frames are passed to table view. Applies to all views of shared capture.
+    *   @param  rate flushes per second, 0 disables buffering
+    */
+    void setDisplayRate(int rate)
+    {
+        _capture->setDisplayRate(rate);
+    }
+
+    /**
+    *   @brief  Degrades view while main thread is overloaded: capture is flushed less often (and sampled at Sampled
+    *           level) and sorting is paused. Level applies to all views of shared capture.
+    */
+    void setLoadLevel(LoadLevel level)
+    {
+        _capture->setLoadLevel(level);
+        _uniqueModel.setSortPaused(level != LoadLevel::Normal);
+
+        switch (level) {
+        case LoadLevel::Reduced:
+            _ui.setLoadStatus(
+                QString("Overloaded: %1 updates/s, sorting paused").arg(FrameCapture::kReducedDisplayRate));
+            break;
+        case LoadLevel::Sampled:
+            _ui.setLoadStatus(
+                QString("Overloaded: showing 1 of %1 frames, sorting paused").arg(FrameCapture::kSampleRatio));
+            break;
+        default:
+            _ui.setLoadStatus(QString());
+            break;
+        }
+    }
+
+    /**
+    *   @brief  Passes buffered frames to table view. Model is updated with single insertion and view is scrolled
+    *           once per flush.
+    */
+    void flush()
+    {
+        _capture->flush();
+    }
+
+    /**
+    *   @brief  Switches view to offline browsing of trace file. Live frames are still collected in background.
+    *   @param  path trace file path
+    *   @return false if trace could not be opened
+    */
+    bool openTrace(const QString& path)
+    {
+        // Trace is browsed as frame history
+        setChangeMode(false);
+
+        if (!_traceModel.open(path)) {
+            cds_error("Failed to open trace '{}'", path.toStdString());
+            _ui.setTraceMode(false);
+            return false;
+        }
+
+        _traceModel.setUniqueOnly(_uniqueModel.isFilterActive());
+        _ui.setModel(&_traceModel);
+        _ui.setTraceMode(true);
+
+        return true;
+    }
+
+    /**
+    *   @brief  Closes trace and returns to live view
+    */
+    void closeTrace()
+    {
+        if (_traceModel.isOpen()) {
+            _ui.setModel(&_uniqueModel);
+            _traceModel.close();
+        }
+
+        _ui.setTraceMode(false);
+    }
+
+    /**
+    *   @brief  Scrolls trace view to first frame not older than given time
+    *   @param  seconds time since first frame of trace
+    */
+    void goToTime(double seconds)
+    {
+        if (_traceModel.isOpen()) {
+            _ui.scrollToRow(_traceModel.rowForTime(seconds));
+        }
+    }
+
+    /**
+    *   @brief  Sets ids shown in trace view
+    *   @param  text hex ids separated with spaces or commas, empty to show all
+    */
+    void setIdFilter(const QString& text)
+    {
+        QVector<quint32> ids;
+
+        for (const auto& item : text.split(QRegExp("[\\s,;]+"), QString::SkipEmptyParts)) {
+            bool ok = false;
+            const quint32 id = item.toUInt(&ok, 16);
+
+            if (ok) {
+                ids.append(id);
+            } else {
+                cds_warn("Invalid id '{}' ignored", item.toStdString());
+            }
         }
+
+        _traceModel.setIdFilter(ids);
+    }
+
+    /**
+    *   @brief  Switches between frame history and change-detection view. Change view starts with the newest
+    *           frame of each id and direction from history.
+    *   @param  changes true to show one row per id and direction, updated only when payload changes
+    */
+    void setChangeMode(bool changes)
+    {
+        if (changes == _changeMode) {
+            return;
+        }
+
+        _changeMode = changes;
+        _changeModel.clear();
+
+        if (_changeMode) {
+            closeTrace();
+            flush();
+
+            rebuildChangeModel();
+        }
+
+        _ui.setModel(_changeMode ? static_cast<QAbstractItemModel*>(&_changeProxy) : &_uniqueModel);
+        _ui.setChangeMode(_changeMode);
+    }
+
+    bool changeMode() const
+    {
+        return _changeMode;
+    }
+
+    /**
+    *   @brief  Restricts live view to frames matching query, results are shown as they are found
+    *   @param  text query in FrameQuery text form, empty to show all frames
+    */
+    void search(const QString& text)
+    {
+        _search->start(FrameQuery::parse(text));
+        _uniqueModel.refresh();
+
+        if (!_search->isActive()) {
+            _ui.setSearchStatus(QString());
+        }
+    }
+
+    /**
+    *   @brief  Exports view contents in background, open trace is exported straight from file
+    *   @param  path output file, format is chosen by suffix (see TraceExporter::formatFromPath)
+    *   @return false if format is not known or there is nothing to export
+    */
+    bool exportFrames(const QString& path)
+    {
+        TraceExporter::Options options;
+
+        if (!TraceExporter::formatFromPath(path, options.format)) {
+            cds_error("Unknown export format of '{}'", path.toStdString());
+            return false;
+        }
+
+        if (_traceModel.isOpen()) {
+            _exporter.exportAsync(path, _traceModel.path(), options);
+            return true;
+        }
+
+        flush();
+
+        const CanFrameBatch records = snapshot();
+        if (records.isEmpty()) {
+            cds_warn("View is empty, nothing to export");
+            return false;
+        }
+
+        _exporter.exportAsync(path, records, options);
+        return true;
     }
 
 private:
+    /**
+    *   @brief  Compact copy of rows with timestamps restored, so that it can be processed in worker thread. Rows of
+    *           shared capture not accepted by this view are left out.
+    */
+    CanFrameBatch snapshot() const
+    {
+        const FrameTableModel& frames = model();
+        const CanFilterList& filters = _uniqueModel.acceptanceFilters();
+        CanFrameBatch records;
+        records.reserve(frames.rowCount());
+
+        for (int row = 0; row < frames.rowCount(); ++row) {
+            CanFrameRecord rec = frames.record(row);
+            const qint64 timestamp
+                = static_cast<qint64>(_capture->timeBase()) + qRound64(frames.time(row) * 1000000.0);
+
+            if (!filters.isEmpty() && !canFiltersAccept(filters, rec.id, rec.hasFlag(CanFrameRecord::ExtendedId))) {
+                continue;
+            }
+
+            rec.timestamp = static_cast<quint64>(std::max<qint64>(0, timestamp));
+            records.append(rec);
+        }
+
+        return records;
+    }
+
+    /**
+    *   @brief  Change view starts with the newest frame of each id and direction from history
+    */
+    void rebuildChangeModel()
+    {
+        const FrameTableModel& frames = model();
+        CanFrameBatch latest;
+        std::vector<double> times;
+
+        _changeModel.clear();
+        for (int row = 0; row < frames.rowCount(); ++row) {
+            if (frames.isLatest(row)) {
+                latest.append(frames.record(row));
+                times.push_back(frames.time(row));
+            }
+        }
+        appendChanges(latest, times);
+    }
+
+    /**
+    *   @brief  Feeds change model, frames of shared capture are restricted to acceptance filters of this view
+    */
+    void appendChanges(const CanFrameBatch& frames, const std::vector<double>& times)
+    {
+        const CanFilterList& filters = _uniqueModel.acceptanceFilters();
+
+        if (filters.isEmpty()) {
+            _changeModel.appendFrames(frames, times);
+            return;
+        }
+
+        CanFrameBatch accepted;
+        std::vector<double> acceptedTimes;
+        for (int i = 0; i < frames.size(); ++i) {
+            if (canFiltersAccept(filters, frames[i].id, frames[i].hasFlag(CanFrameRecord::ExtendedId))) {
+                accepted.append(frames[i]);
+                acceptedTimes.push_back(times[static_cast<std::size_t>(i)]);
+            }
+        }
+        _changeModel.appendFrames(accepted, acceptedTimes);
+    }
+
+    void framesAppended(const CanFrameBatch& frames, const std::vector<double>& times)
+    {
+        if (_changeMode) {
+            appendChanges(frames, times);
+        }
+
+        // Rows of change view stay in place
+        if (!_ui.isViewFrozen() && !_traceModel.isOpen() && !_changeMode) {
+            _ui.scrollToBottom();
+        }
+    }
+
+    /**
+    *   @brief  Proxy filters rows only if capture is shared, own capture holds accepted frames only
+    */
+    void updateProjection()
+    {
+        const CanFilterList filters = (_capture->viewCount() > 1) ? _acceptanceFilters : CanFilterList();
+
+        // Filtering is re-evaluated for all rows, skipped when nothing is restricted before and after
+        if (!filters.isEmpty() || !_uniqueModel.acceptanceFilters().isEmpty()) {
+            _uniqueModel.setAcceptanceFilters(filters);
+        }
+    }
+
     void writeSortingRules(QJsonObject& json) const
     {
         json["prevIndex"] = _prevIndex;
@@ -121,18 +506,26 @@ private:
         json["columns"] = std::move(columnList);
     }
 
-    void writeViewModel(QJsonArray& jsonArray) const
+    /**
+    *   @brief  View contents are saved as trace, so that they can be browsed offline after project is loaded
+    *   @return side data job writing what the view currently shows
+    */
+    ComponentSideData sideData() const
     {
-        for (auto row = 0; row < _tvModel.rowCount(); ++row) {
-            QJsonArray lineIter;
-            for (auto column = 0; column < _tvModel.columnCount(); ++column) {
-                if (_ui.isColumnHidden(column) == false) {
-                    auto pp = _tvModel.data(_tvModel.index(row, column));
-                    lineIter.append(std::move(pp.toString()));
-                }
-            }
-            jsonArray.append(std::move(lineIter));
+        if (_traceModel.isOpen()) {
+            const QString source = _traceModel.path();
+
+            return { ".cdst", [source](const QString& path) { return QFile::copy(source, path); } };
+        }
+
+        if (model().rowCount() == 0) {
+            return {};
         }
+
+        // Formatting and I/O happen in worker thread
+        const CanFrameBatch records = snapshot();
+
+        return { ".cdst", [records](const QString& path) { return TraceWriter::writeTrace(path, records); } };
     }
 
 private slots:
@@ -143,8 +536,8 @@ private slots:
      */
     void clear()
     {
-        _tvModel.removeRows(0, _tvModel.rowCount());
-        _uniqueModel.clearFilter();
+        _capture->clear();
+        _changeModel.clear();
     }
 
     void sort(const int clickedIndex)
@@ -174,23 +567,32 @@ private slots:
     void setFilter()
     {
         _uniqueModel.toggleFilter();
+        // Unique view of trace is answered from its index
+        _traceModel.setUniqueOnly(_uniqueModel.isFilterActive());
     }
 
 public:
     CanRawViewCtx _ctx;
-    QElapsedTimer _timer;
-    QStandardItemModel _tvModel;
+    // Declared before models, which refer to its frames
+    std::shared_ptr<FrameCapture> _capture;
+    std::unique_ptr<FrameSearch> _search;
     UniqueFilterModel _uniqueModel;
+    ChangeTableModel _changeModel;
+    QSortFilterProxyModel _changeProxy;
+    TraceTableModel _traceModel;
+    TraceExporter _exporter;
     bool _simStarted;
     CRVGuiInterface& _ui;
     bool docked{ true };
+    CanFilterList _acceptanceFilters;
+    FrameIdDirectoryPtr _idDirectory; // set by FlowPlan if view shows single device
 
 private:
-    int _rowID{ 0 };
     int _prevIndex{ 0 };
     int _sortIndex{ 0 };
     Qt::SortOrder _currentSortOrder{ Qt::AscendingOrder };
     QStringList _columnsOrder;
+    bool _changeMode{ false };
     CanRawView* q_ptr;
 };
 #endif // CANRAWVIEW_P_H
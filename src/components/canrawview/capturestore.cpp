@@ -0,0 +1,306 @@
+#include "capturestore.h"
+#include <QtCore/QHash>
+#include <algorithm>
+
+constexpr int CaptureStore::kBlockFrames;
+constexpr int CaptureStore::kCachedBlocks;
+
+namespace {
+void putVarint(std::vector<quint8>& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<quint8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<quint8>(value));
+}
+
+quint64 getVarint(const quint8*& p)
+{
+    quint64 value = 0;
+    int shift = 0;
+    quint8 byte;
+
+    do {
+        byte = *p++;
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+
+// Small negative and positive values map to small unsigned ones
+quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+qint64 toUs(double time)
+{
+    return qRound64(time * 1000000.0);
+}
+
+quint64 shapeKey(const CaptureStore::Row& row)
+{
+    return (static_cast<quint64>(row.length) << 40) | (static_cast<quint64>(row.flags) << 32) | row.id;
+}
+} // namespace
+
+CaptureStore::CaptureStore()
+{
+    _open.reserve(kBlockFrames);
+}
+
+void CaptureStore::append(const CanFrameRecord& rec, double time)
+{
+    // Encoding of sealed block reads length bytes of payload, so length must not exceed it
+    const auto length = static_cast<quint8>(std::min<int>(rec.length, CanFrameRecord::kMaxPayload));
+    Row row{ time, rec.id, rec.flags, length, {} };
+
+    std::copy(rec.payload, rec.payload + length, row.payload.begin());
+    _open.push_back(row);
+    ++_count;
+
+    if (_open.size() == static_cast<std::size_t>(kBlockFrames)) {
+        seal();
+    }
+}
+
+void CaptureStore::dropFront(int count)
+{
+    count = std::min(count, _count);
+    _count -= count;
+    _skip += count;
+
+    while (!_blocks.empty() && (_skip >= kBlockFrames)) {
+        _sealedBytes -= _blocks.front().data.capacity();
+        _blocks.pop_front();
+        ++_firstBlockNo;
+        _skip -= kBlockFrames;
+    }
+}
+
+void CaptureStore::clear()
+{
+    _blocks.clear();
+    _open.clear();
+    _skip = 0;
+    _count = 0;
+    _firstBlockNo = 0;
+    _sealedBytes = 0;
+
+    // Block numbers start over, cached blocks would be taken for new ones
+    for (auto& entry : _cache) {
+        entry.blockNo = ~0ULL;
+        entry.rows.clear();
+    }
+}
+
+int CaptureStore::size() const
+{
+    return _count;
+}
+
+CaptureStore::Row CaptureStore::row(int index) const
+{
+    const std::size_t pos = static_cast<std::size_t>(_skip + index);
+    const std::size_t block = pos / kBlockFrames;
+
+    if (block < _blocks.size()) {
+        return cachedBlock(block)[pos % kBlockFrames];
+    }
+
+    return _open[pos - _blocks.size() * kBlockFrames];
+}
+
+void CaptureStore::forEach(int first, int last, const std::function<void(int, const Row&)>& fn) const
+{
+    std::vector<Row> rows;
+    std::size_t decoded = ~std::size_t(0);
+
+    first = std::max(0, first);
+    last = std::min(_count, last);
+
+    for (int index = first; index < last; ++index) {
+        const std::size_t pos = static_cast<std::size_t>(_skip + index);
+        const std::size_t block = pos / kBlockFrames;
+
+        if (block < _blocks.size()) {
+            if (block != decoded) {
+                decode(_blocks[block], rows);
+                decoded = block;
+            }
+            fn(index, rows[pos % kBlockFrames]);
+        } else {
+            fn(index, _open[pos - _blocks.size() * kBlockFrames]);
+        }
+    }
+}
+
+std::size_t CaptureStore::blockCount() const
+{
+    return _blocks.size();
+}
+
+std::size_t CaptureStore::bytes() const
+{
+    return _sealedBytes + _open.capacity() * sizeof(Row);
+}
+
+void CaptureStore::seal()
+{
+    _blocks.push_back(encode(_open));
+    _sealedBytes += _blocks.back().data.capacity();
+    _open.clear();
+}
+
+CaptureStore::Block CaptureStore::encode(const std::vector<Row>& rows)
+{
+    Block block;
+    std::vector<quint64> dictionary;
+    std::vector<int> indexes;
+    QHash<quint64, int> lookup;
+
+    block.firstTime = rows.front().time;
+    block.lastTime = rows.back().time;
+
+    // Buses carry a few hundred ids, most of them with constant format and length
+    indexes.reserve(rows.size());
+    for (const auto& row : rows) {
+        const quint64 key = shapeKey(row);
+        auto it = lookup.constFind(key);
+
+        if (it == lookup.cend()) {
+            it = lookup.insert(key, static_cast<int>(dictionary.size()));
+            dictionary.push_back(key);
+        }
+        indexes.push_back(it.value());
+    }
+
+    std::vector<quint8>& out = block.data;
+    out.reserve(rows.size() * 4);
+
+    putVarint(out, dictionary.size());
+    for (const quint64 key : dictionary) {
+        putVarint(out, key & 0xffffffff);
+        out.push_back(static_cast<quint8>(key >> 32));
+        out.push_back(static_cast<quint8>(key >> 40));
+    }
+
+    const bool wide = dictionary.size() > 256;
+    std::vector<Payload> previous(dictionary.size(), Payload{});
+    qint64 prevUs = 0;
+    qint64 prevDelta = 0;
+
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const Row& row = rows[i];
+        const int index = indexes[i];
+
+        // Cyclic frames arrive at almost constant intervals, their delta-of-delta is close to 0
+        const qint64 us = toUs(row.time);
+        const qint64 delta = us - prevUs;
+        putVarint(out, zigzag(delta - prevDelta));
+        prevUs = us;
+        prevDelta = delta;
+
+        out.push_back(static_cast<quint8>(index));
+        if (wide) {
+            out.push_back(static_cast<quint8>(index >> 8));
+        }
+
+        // Only bytes that changed since previous frame of the same id are stored
+        Payload& prev = previous[static_cast<std::size_t>(index)];
+        const std::size_t mask = out.size();
+        out.resize(mask + (row.length + 7) / 8, 0);
+
+        for (int b = 0; b < row.length; ++b) {
+            const quint8 x = row.payload[b] ^ prev[b];
+
+            if (x != 0) {
+                out[mask + b / 8] |= static_cast<quint8>(1 << (b % 8));
+                out.push_back(x);
+            }
+            prev[b] = row.payload[b];
+        }
+    }
+
+    out.shrink_to_fit();
+
+    return block;
+}
+
+void CaptureStore::decode(const Block& block, std::vector<Row>& rows)
+{
+    const quint8* p = block.data.data();
+    const quint8* const end = p + block.data.size();
+    std::vector<Row> dictionary(static_cast<std::size_t>(getVarint(p)));
+
+    for (auto& entry : dictionary) {
+        entry.id = static_cast<quint32>(getVarint(p));
+        entry.flags = *p++;
+        entry.length = *p++;
+    }
+
+    const bool wide = dictionary.size() > 256;
+    std::vector<Payload> previous(dictionary.size(), Payload{});
+    qint64 prevUs = 0;
+    qint64 prevDelta = 0;
+
+    rows.clear();
+    rows.reserve(kBlockFrames);
+
+    while (p < end) {
+        const qint64 delta = prevDelta + unzigzag(getVarint(p));
+        const qint64 us = prevUs + delta;
+        prevUs = us;
+        prevDelta = delta;
+
+        std::size_t index = *p++;
+        if (wide) {
+            index |= static_cast<std::size_t>(*p++) << 8;
+        }
+
+        const Row& entry = dictionary[index];
+        Payload& prev = previous[index];
+        const quint8* mask = p;
+        p += (entry.length + 7) / 8;
+
+        for (int b = 0; b < entry.length; ++b) {
+            if (mask[b / 8] & (1 << (b % 8))) {
+                prev[b] ^= *p++;
+            }
+        }
+
+        // Bytes past length are never set, so they stay zero
+        rows.push_back(Row{ us / 1000000.0, entry.id, entry.flags, entry.length, prev });
+    }
+}
+
+const std::vector<CaptureStore::Row>& CaptureStore::cachedBlock(std::size_t block) const
+{
+    const quint64 blockNo = _firstBlockNo + block;
+    CacheEntry* victim = &_cache[0];
+
+    for (auto& entry : _cache) {
+        if (entry.blockNo == blockNo) {
+            entry.used = ++_cacheClock;
+            return entry.rows;
+        }
+
+        if (entry.used < victim->used) {
+            victim = &entry;
+        }
+    }
+
+    decode(_blocks[block], victim->rows);
+    victim->blockNo = blockNo;
+    victim->used = ++_cacheClock;
+
+    return victim->rows;
+}
@@ -0,0 +1,112 @@
+#ifndef CAPTURESTORE_H
+#define CAPTURESTORE_H
+
+#include <QtCore/QtGlobal>
+#include <array>
+#include <canframerecord.h>
+#include <deque>
+#include <functional>
+#include <vector>
+
+/**
+*   @brief  Append-only frame store of FrameTableModel compressing sealed blocks
+*
+*   Frames are appended to open block. Once it holds kBlockFrames frames it is sealed and encoded:
+*   - times (whole microseconds) as zigzag varints of delta-of-delta,
+*   - (id, flags, length) through block dictionary, index takes one byte for up to 256 entries, two otherwise,
+*   - payload XORed with previous payload of the same dictionary entry, stored as bit mask of non-zero bytes
+*     followed by those bytes.
+*   Cyclic traffic takes a few bytes per frame instead of ~80. Row i is found in block (i + skip) / kBlockFrames,
+*   so random access decodes at most one block. The last decoded blocks are cached for GUI access.
+*
+*   Frames are removed from the front only (retention). Sealed blocks are immutable, so forEach() may be called by
+*   several threads at once while no frames are appended or removed.
+*/
+class CaptureStore {
+public:
+    static constexpr int kBlockFrames = 4096;
+    static constexpr int kCachedBlocks = 4;
+
+    typedef std::array<quint8, CanFrameRecord::kMaxPayload> Payload;
+
+    struct Row {
+        double time; // seconds since simulation start
+        quint32 id;
+        quint8 flags;
+        quint8 length;
+        Payload payload;
+    };
+
+    CaptureStore();
+
+    /**
+    *   @brief  Appends frame, seals open block once it is full
+    *   @param  rec frame, timestamp is not used
+    *   @param  time time of frame in seconds, kept at microsecond resolution
+    */
+    void append(const CanFrameRecord& rec, double time);
+
+    /**
+    *   @brief  Removes oldest frames, blocks are freed once all their frames are removed
+    *   @param  count number of frames, at most size()
+    */
+    void dropFront(int count);
+
+    void clear();
+
+    int size() const;
+
+    /**
+    *   @brief  Reads single frame. Not thread safe, uses decoding cache.
+    *   @param  index frame index, 0 is the oldest frame
+    */
+    Row row(int index) const;
+
+    /**
+    *   @brief  Reads range of frames in order without touching cache. May be called from several threads at once.
+    *   @param  first first frame
+    *   @param  last frame past the last one
+    *   @param  fn called with index and row of each frame
+    */
+    void forEach(int first, int last, const std::function<void(int, const Row&)>& fn) const;
+
+    /**
+    *   @return number of sealed blocks
+    */
+    std::size_t blockCount() const;
+
+    /**
+    *   @return bytes taken by frame data, sealed blocks and open block
+    */
+    std::size_t bytes() const;
+
+private:
+    struct Block {
+        std::vector<quint8> data;
+        double firstTime;
+        double lastTime;
+    };
+
+    struct CacheEntry {
+        quint64 blockNo{ ~0ULL };
+        std::vector<Row> rows;
+        quint64 used{ 0 };
+    };
+
+    void seal();
+    static Block encode(const std::vector<Row>& rows);
+    static void decode(const Block& block, std::vector<Row>& rows);
+    const std::vector<Row>& cachedBlock(std::size_t block) const;
+
+    std::deque<Block> _blocks;
+    std::vector<Row> _open;
+    int _skip{ 0 }; // frames removed from the first block (or open block if there is no sealed one)
+    int _count{ 0 };
+    quint64 _firstBlockNo{ 0 }; // serial number of _blocks.front(), keys cache entries
+    std::size_t _sealedBytes{ 0 };
+
+    mutable std::array<CacheEntry, kCachedBlocks> _cache;
+    mutable quint64 _cacheClock{ 0 };
+};
+
+#endif // CAPTURESTORE_H
@@ -0,0 +1,237 @@
+#include "changetablemodel.h"
+#include <algorithm>
+#include <cstring>
+#include <hexformat.h>
+
+namespace {
+const char* const kHeaderLabels[FrameTableModel::ColumnCount]
+    = { "rowID", "timeDouble", "time", "idInt", "id", "dir", "dlc", "flags", "data" };
+
+constexpr int kWords = CanFrameRecord::kMaxPayload / 8;
+
+quint64 lowBits(int n)
+{
+    return (n >= 64) ? ~0ULL : ((1ULL << n) - 1);
+}
+} // namespace
+
+ChangeTableModel::ChangeTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int ChangeTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _count;
+}
+
+int ChangeTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : FrameTableModel::ColumnCount;
+}
+
+QVariant ChangeTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (index.row() >= _count)) {
+        return {};
+    }
+
+    const int row = index.row();
+
+    if (role == ChangedBytesRole) {
+        return static_cast<qulonglong>(_changed[row]);
+    }
+
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (index.column()) {
+    case FrameTableModel::RowId:
+        return static_cast<qulonglong>(row);
+    case FrameTableModel::TimeDouble:
+        return _times[row];
+    case FrameTableModel::Time:
+        return QString::number(_times[row], 'f', 6);
+    case FrameTableModel::IdInt:
+        return static_cast<int>(_ids[row]);
+    case FrameTableModel::Id:
+        return QString("0x" + QString::number(_ids[row], 16));
+    case FrameTableModel::Dir:
+        return QString((_flags[row] & CanFrameRecord::Tx) ? "TX" : "RX");
+    case FrameTableModel::Dlc:
+        return static_cast<int>(_lengths[row]);
+    case FrameTableModel::Flags:
+        return canFrameFlagsText(_flags[row]);
+    case FrameTableModel::Data:
+        return HexFormat::payloadToHex(_payloads[row].bytes, _lengths[row]);
+    default:
+        return {};
+    }
+}
+
+QVariant ChangeTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) && (section >= 0)
+        && (section < FrameTableModel::ColumnCount)) {
+        return QString(kHeaderLabels[section]);
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+int ChangeTableModel::appendFrames(const CanFrameBatch& frames, const std::vector<double>& times)
+{
+    Q_ASSERT(static_cast<std::size_t>(frames.size()) == times.size());
+
+    std::vector<int> changed;
+    int updates = 0;
+
+    for (int i = 0; i < frames.size(); ++i) {
+        const CanFrameRecord& rec = frames[i];
+        const int length = std::min<int>(rec.length, CanFrameRecord::kMaxPayload);
+        const auto it = _rows.constFind(canFrameKey(rec.id, rec.flags));
+
+        if (it == _rows.constEnd()) {
+            // New rows are stored right away, views learn about them after the loop
+            const int row = static_cast<int>(_ids.size());
+            Payload payload{};
+
+            std::memcpy(payload.bytes, rec.payload, length);
+            _rows.insert(canFrameKey(rec.id, rec.flags), row);
+            _times.push_back(times[i]);
+            _ids.push_back(rec.id);
+            _flags.push_back(rec.flags);
+            _lengths.push_back(static_cast<quint8>(length));
+            _payloads.push_back(payload);
+            _changed.push_back(lowBits(length));
+            _changes.push_back(1);
+            ++updates;
+            continue;
+        }
+
+        const int row = *it;
+        const quint64 mask = diffMask(_payloads[row].bytes, _lengths[row], rec.payload, length);
+
+        // Format flags (e.g. bitrate switch) are part of the frame as well
+        if ((mask == 0) && (_flags[row] == rec.flags)) {
+            continue;
+        }
+
+        std::memcpy(_payloads[row].bytes, rec.payload, length);
+        std::memset(_payloads[row].bytes + length, 0, CanFrameRecord::kMaxPayload - length);
+        _times[row] = times[i];
+        _flags[row] = rec.flags;
+        _lengths[row] = static_cast<quint8>(length);
+        _changed[row] = mask;
+        ++_changes[row];
+        ++updates;
+
+        if (row < _count) {
+            changed.push_back(row);
+        }
+    }
+
+    const int total = static_cast<int>(_ids.size());
+    if (total > _count) {
+        beginInsertRows(QModelIndex(), _count, total - 1);
+        _count = total;
+        endInsertRows();
+    }
+
+    // Report changed rows in contiguous ranges, unchanged rows cost views nothing
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    for (std::size_t i = 0; i < changed.size();) {
+        std::size_t j = i;
+
+        while ((j + 1 < changed.size()) && (changed[j + 1] == changed[j] + 1)) {
+            ++j;
+        }
+
+        emit dataChanged(index(changed[i], 0), index(changed[j], FrameTableModel::ColumnCount - 1));
+        i = j + 1;
+    }
+
+    return updates;
+}
+
+void ChangeTableModel::clear()
+{
+    beginResetModel();
+    _times.clear();
+    _ids.clear();
+    _flags.clear();
+    _lengths.clear();
+    _payloads.clear();
+    _changed.clear();
+    _changes.clear();
+    _count = 0;
+    _rows.clear();
+    endResetModel();
+}
+
+quint64 ChangeTableModel::changedBytes(int row) const
+{
+    return _changed[row];
+}
+
+quint64 ChangeTableModel::changeCount(int row) const
+{
+    return _changes[row];
+}
+
+CanFrameRecord ChangeTableModel::record(int row) const
+{
+    CanFrameRecord rec{};
+
+    rec.id = _ids[row];
+    rec.flags = _flags[row];
+    rec.length = _lengths[row];
+    std::memcpy(rec.payload, _payloads[row].bytes, rec.length);
+
+    return rec;
+}
+
+quint64 ChangeTableModel::diffMask(const quint8* prev, int prevLength, const quint8* next, int nextLength)
+{
+    quint64 words[kWords];
+    quint64 any = 0;
+
+    // Fixed trip count without early exit, compiler turns this into vector XOR for whole FD payload
+    for (int w = 0; w < kWords; ++w) {
+        quint64 a;
+        quint64 b;
+
+        std::memcpy(&a, prev + 8 * w, sizeof(a));
+        std::memcpy(&b, next + 8 * w, sizeof(b));
+        words[w] = a ^ b;
+        any |= words[w];
+    }
+
+    const int common = std::min(prevLength, nextLength);
+    const quint64 commonMask = lowBits(common);
+    // Bytes present in one payload only
+    quint64 mask = lowBits(std::max(prevLength, nextLength)) & ~commonMask;
+
+    if (any == 0) {
+        return mask;
+    }
+
+    // Only words that differ are inspected byte by byte
+    quint64 bytes = 0;
+    for (int w = 0; (w < kWords) && (8 * w < common); ++w) {
+        if (words[w] == 0) {
+            continue;
+        }
+
+        for (int i = 8 * w; i < 8 * w + 8; ++i) {
+            if (prev[i] != next[i]) {
+                bytes |= 1ULL << i;
+            }
+        }
+    }
+
+    return mask | (bytes & commonMask);
+}
+
@@ -0,0 +1,90 @@
+#ifndef CHANGETABLEMODEL_H
+#define CHANGETABLEMODEL_H
+
+#include "frametablemodel.h"
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QHash>
+#include <canframerecord.h>
+#include <vector>
+
+/**
+*   @brief  Table model of change-detection mode of CanRawView, one row per (id, direction) pair
+*
+*   Last payload of each pair is kept in dense table. Incoming payload is compared with it word by word and the row
+*   is reported with dataChanged() only if some bits differ, so cyclic frames that repeat the same payload cause no
+*   view updates at all. Bytes changed by the last update are reported with ChangedBytesRole, so that view can
+*   highlight them. Columns are the same as those of FrameTableModel.
+*/
+class ChangeTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+    *   @brief  Custom data roles
+    */
+    enum Role {
+        ChangedBytesRole = Qt::UserRole + 2 ///< qulonglong, bit n set if byte n changed with the last update
+    };
+
+    explicit ChangeTableModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+    *   @brief  Updates rows with frames. Emits at most one rowsInserted signal for pairs seen for the first time,
+    *           changed rows are reported with dataChanged() in contiguous ranges.
+    *   @param  frames frames to be compared
+    *   @param  times time of each frame in seconds since simulation start, same size as frames
+    *   @return number of frames that changed payload of their row, first frames of a pair included
+    */
+    int appendFrames(const CanFrameBatch& frames, const std::vector<double>& times);
+
+    /**
+    *   @brief  Removes all rows
+    */
+    void clear();
+
+    /**
+    *   @return bytes changed by the last update of row, bit n set if byte n changed
+    */
+    quint64 changedBytes(int row) const;
+
+    /**
+    *   @return number of updates of row that changed its payload, first frame included
+    */
+    quint64 changeCount(int row) const;
+
+    CanFrameRecord record(int row) const;
+
+    /**
+    *   @brief  Compares payloads 8 bytes at a time
+    *   @param  prev previous payload, kMaxPayload bytes
+    *   @param  prevLength length of previous payload
+    *   @param  next new payload, kMaxPayload bytes (bytes beyond length are ignored)
+    *   @param  nextLength length of new payload
+    *   @return bit n set if byte n differs, bytes present in one payload only count as changed
+    */
+    static quint64 diffMask(const quint8* prev, int prevLength, const quint8* next, int nextLength);
+
+private:
+    // Aligned so that comparison loads whole words
+    struct alignas(8) Payload {
+        quint8 bytes[CanFrameRecord::kMaxPayload];
+    };
+
+    // One vector per column, rows in order of first appearance
+    std::vector<double> _times; // time of the last change
+    std::vector<quint32> _ids;
+    std::vector<quint8> _flags;
+    std::vector<quint8> _lengths;
+    std::vector<Payload> _payloads;
+    std::vector<quint64> _changed;
+    std::vector<quint64> _changes;
+    int _count{ 0 }; // rows announced to views
+    QHash<quint32, int> _rows; // canFrameKey -> row
+};
+
+#endif // CHANGETABLEMODEL_H
@@ -0,0 +1,270 @@
+#include "framecapture.h"
+#include <algorithm>
+#include <instrumentation.h>
+#include <log.h>
+
+constexpr int FrameCapture::kDefaultDisplayRate;
+constexpr quint64 FrameCapture::kMaxTimeBaseDiffUs;
+constexpr int FrameCapture::kReducedDisplayRate;
+constexpr int FrameCapture::kSampledDisplayRate;
+constexpr int FrameCapture::kSampleRatio;
+
+FrameCapture::FrameCapture()
+{
+    connect(&_flushTimer, &QTimer::timeout, this, &FrameCapture::flush);
+    setDisplayRate(kDefaultDisplayRate);
+}
+
+FrameTableModel& FrameCapture::model()
+{
+    return _model;
+}
+
+const FrameTableModel& FrameCapture::model() const
+{
+    return _model;
+}
+
+void FrameCapture::attach(const QObject* view, const CanFilterList& filters)
+{
+    auto it = std::find_if(_views.begin(), _views.end(),
+        [view](const std::pair<const QObject*, CanFilterList>& entry) { return entry.first == view; });
+
+    if (it != _views.end()) {
+        it->second = filters;
+    } else {
+        _views.emplace_back(view, filters);
+    }
+
+    emit viewsChanged();
+}
+
+void FrameCapture::detach(const QObject* view)
+{
+    auto it = std::find_if(_views.begin(), _views.end(),
+        [view](const std::pair<const QObject*, CanFilterList>& entry) { return entry.first == view; });
+
+    if (it != _views.end()) {
+        _views.erase(it);
+        emit viewsChanged();
+    }
+}
+
+std::size_t FrameCapture::viewCount() const
+{
+    return _views.size();
+}
+
+bool FrameCapture::isLeader(const QObject* view) const
+{
+    return !_views.empty() && (_views.front().first == view);
+}
+
+void FrameCapture::append(const QObject* view, const CanFrameBatch& frames)
+{
+    // Other views are fed with the same frames
+    if (!_running || !isLeader(view) || frames.isEmpty()) {
+        return;
+    }
+
+    const quint64 now = canTimestampNow();
+    Instrumentation::add(Instrumentation::Counter::ViewFrames, frames.size());
+    for (const auto& frame : frames) {
+        // Backend timestamps may come from other clock, e.g. those of replayed trace
+        Instrumentation::record(
+            Instrumentation::Histogram::ReadToViewUs, (now > frame.timestamp) ? now - frame.timestamp : 0);
+    }
+
+    const bool all = std::any_of(_views.begin(), _views.end(),
+        [](const std::pair<const QObject*, CanFilterList>& entry) { return entry.second.isEmpty(); });
+
+    if (all && (_loadLevel != LoadLevel::Sampled)) {
+        _pendingFrames.append(frames);
+        for (const auto& frame : frames) {
+            _pendingTimes.push_back(frameTime(frame));
+        }
+    } else {
+        // Device may pass frames requested by other consumers
+        for (const auto& frame : frames) {
+            if ((all || accepts(frame)) && sampled()) {
+                _pendingFrames.append(frame);
+                _pendingTimes.push_back(frameTime(frame));
+            }
+        }
+    }
+
+    if (!_flushTimer.isActive()) {
+        flush();
+    }
+}
+
+void FrameCapture::start(const QObject* view)
+{
+    if (!isLeader(view)) {
+        return;
+    }
+
+    _timeBase = canTimestampNow();
+    _startUs = _timeBase;
+    _timeBaseChecked = false;
+    _running = true;
+    _sampleCounter = 0;
+    _skipped = 0;
+    clear();
+    updateFlushTimer();
+}
+
+void FrameCapture::stop(const QObject* view)
+{
+    if (!isLeader(view)) {
+        return;
+    }
+
+    _running = false;
+    updateFlushTimer();
+}
+
+bool FrameCapture::isRunning() const
+{
+    return _running;
+}
+
+void FrameCapture::clear()
+{
+    _pendingFrames.clear();
+    _pendingTimes.clear();
+    _model.clear();
+}
+
+void FrameCapture::flush()
+{
+    if (_pendingFrames.isEmpty()) {
+        return;
+    }
+
+    // Proxy models keep their current order while rows are inserted (dynamic sorting), no need to re-sort here
+    _model.appendFrames(_pendingFrames, _pendingTimes);
+
+    // Buffers are swapped out first, so that frames appended by receivers start new buffer
+    const CanFrameBatch frames = std::move(_pendingFrames);
+    const std::vector<double> times = std::move(_pendingTimes);
+    _pendingFrames.clear();
+    _pendingTimes.clear();
+
+    emit appended(frames, times);
+}
+
+void FrameCapture::setDisplayRate(int rate)
+{
+    _displayRate = std::max(0, rate);
+
+    updateFlushTimer();
+}
+
+int FrameCapture::displayRate() const
+{
+    return _displayRate;
+}
+
+void FrameCapture::setLoadLevel(LoadLevel level)
+{
+    if (level == _loadLevel) {
+        return;
+    }
+
+    _loadLevel = level;
+    _sampleCounter = 0;
+    updateFlushTimer();
+}
+
+LoadLevel FrameCapture::loadLevel() const
+{
+    return _loadLevel;
+}
+
+quint64 FrameCapture::skippedFrames() const
+{
+    return _skipped;
+}
+
+quint64 FrameCapture::timeBase() const
+{
+    return _timeBase;
+}
+
+void FrameCapture::setTimeBase(quint64 timeBase)
+{
+    _timeBase = timeBase;
+    _timeBaseChecked = true;
+}
+
+bool FrameCapture::accepts(const CanFrameRecord& frame) const
+{
+    return std::any_of(_views.begin(), _views.end(), [&frame](const std::pair<const QObject*, CanFilterList>& entry) {
+        return canFiltersAccept(entry.second, frame.id, frame.hasFlag(CanFrameRecord::ExtendedId));
+    });
+}
+
+double FrameCapture::frameTime(const CanFrameRecord& frame)
+{
+    if (frame.timestamp == 0) {
+        // Frame not stamped by any backend, reception time is the best we have (virtual one with SimClock)
+        const quint64 now = canTimestampNow();
+        return (now > _startUs) ? (now - _startUs) / 1000000.0 : 0.0;
+    }
+
+    if (!_timeBaseChecked) {
+        // Hardware timestamps may use clock other than wall clock. Follow that clock in such case.
+        const quint64 diff = (frame.timestamp > _timeBase) ? frame.timestamp - _timeBase : _timeBase - frame.timestamp;
+        if (diff > kMaxTimeBaseDiffUs) {
+            cds_info("Frame timestamps do not follow system clock, using first frame as time base");
+            _timeBase = frame.timestamp;
+        }
+        _timeBaseChecked = true;
+    }
+
+    return (static_cast<qint64>(frame.timestamp) - static_cast<qint64>(_timeBase)) / 1000000.0;
+}
+
+void FrameCapture::updateFlushTimer()
+{
+    const int rate = effectiveDisplayRate();
+
+    if (rate > 0) {
+        _flushTimer.setInterval(1000 / rate);
+    }
+
+    if (_running && (rate > 0)) {
+        _flushTimer.start();
+    } else {
+        _flushTimer.stop();
+        flush();
+    }
+}
+
+int FrameCapture::effectiveDisplayRate() const
+{
+    // Unbuffered view is buffered while overloaded too
+    switch (_loadLevel) {
+    case LoadLevel::Reduced:
+        return (_displayRate > 0) ? std::min<int>(_displayRate, kReducedDisplayRate) : kReducedDisplayRate;
+    case LoadLevel::Sampled:
+        return (_displayRate > 0) ? std::min<int>(_displayRate, kSampledDisplayRate) : kSampledDisplayRate;
+    default:
+        return _displayRate;
+    }
+}
+
+bool FrameCapture::sampled()
+{
+    if (_loadLevel != LoadLevel::Sampled) {
+        return true;
+    }
+
+    if ((_sampleCounter++ % kSampleRatio) == 0) {
+        return true;
+    }
+
+    ++_skipped;
+    return false;
+}
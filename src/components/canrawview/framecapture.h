@@ -0,0 +1,152 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include "frametablemodel.h"
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <canfilter.h>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <utility>
+#include <vector>
+
+/**
+*   @brief  Frames captured from one source, shared by every CanRawView showing that source
+*
+*   Capture owns FrameTableModel, time base and display buffer. Views are projections of it: each one keeps its own
+*   proxy (unique mode, sort order, search, acceptance filters), columns and change model, while frames are stored,
+*   converted and timed once. Views register with attach(). All of them may be fed with the same frames, only the
+*   first attached view (leader) is taken, so adding a view costs neither copy nor extra model updates.
+*
+*   Frames are kept if at least one attached view accepts them, views with narrower filters restrict their proxy.
+*   Retention, display rate and clearing apply to all views of capture.
+*
+*   While main thread is overloaded (see setLoadLevel) frames are flushed less often and at Sampled level only
+*   every kSampleRatio-th frame is kept, so that views stay responsive. Other consumers of the source still get all
+*   frames.
+*/
+class FrameCapture : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kDefaultDisplayRate = 30;
+    static constexpr quint64 kMaxTimeBaseDiffUs = 3600ULL * 1000000ULL;
+    static constexpr int kReducedDisplayRate = 5;
+    static constexpr int kSampledDisplayRate = 2;
+    static constexpr int kSampleRatio = 10;
+
+    FrameCapture();
+
+    FrameTableModel& model();
+    const FrameTableModel& model() const;
+
+    /**
+    *   @brief  Registers view or updates its filters. The first registered view is leader.
+    *   @param  view view projecting capture
+    *   @param  filters acceptance filters of view, empty to accept all frames
+    */
+    void attach(const QObject* view, const CanFilterList& filters);
+
+    /**
+    *   @brief  Unregisters view, the next one becomes leader
+    */
+    void detach(const QObject* view);
+
+    std::size_t viewCount() const;
+
+    bool isLeader(const QObject* view) const;
+
+    /**
+    *   @brief  Buffers frames until next flush. Ignored unless view is leader and capture runs.
+    *   @param  view view frames were passed to
+    *   @param  frames frames of source
+    */
+    void append(const QObject* view, const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Clears capture and resets time base, so that times are relative to simulation start. Only leader
+    *           starts and stops capture.
+    */
+    void start(const QObject* view);
+
+    void stop(const QObject* view);
+
+    bool isRunning() const;
+
+    /**
+    *   @brief  Drops captured and buffered frames
+    */
+    void clear();
+
+    /**
+    *   @brief  Passes buffered frames to model with single insertion, then emits appended()
+    */
+    void flush();
+
+    /**
+    *   @brief  Sets how often buffered frames are passed to model
+    *   @param  rate flushes per second, 0 disables buffering
+    */
+    void setDisplayRate(int rate);
+
+    /**
+    *   @return display rate set with setDisplayRate, regardless of load level
+    */
+    int displayRate() const;
+
+    /**
+    *   @brief  Lowers display rate and samples frames while main thread is overloaded
+    */
+    void setLoadLevel(LoadLevel level);
+
+    LoadLevel loadLevel() const;
+
+    /**
+    *   @return frames left out by sampling since capture start
+    */
+    quint64 skippedFrames() const;
+
+    /**
+    *   @return time base in microseconds, same clock as CanFrameRecord::timestamp
+    */
+    quint64 timeBase() const;
+
+    /**
+    *   @brief  Continues time base of other capture, e.g. when view leaves shared capture while simulation runs
+    */
+    void setTimeBase(quint64 timeBase);
+
+signals:
+    /**
+    *   @brief  Emitted after frames were appended to model
+    */
+    void appended(const CanFrameBatch& frames, const std::vector<double>& times);
+
+    /**
+    *   @brief  Emitted when view is attached or detached
+    */
+    void viewsChanged();
+
+private:
+    bool accepts(const CanFrameRecord& frame) const;
+    double frameTime(const CanFrameRecord& frame);
+    void updateFlushTimer();
+    int effectiveDisplayRate() const;
+    bool sampled();
+
+    FrameTableModel _model;
+    std::vector<std::pair<const QObject*, CanFilterList>> _views;
+    QTimer _flushTimer;
+    int _displayRate{ kDefaultDisplayRate };
+    LoadLevel _loadLevel{ LoadLevel::Normal };
+    quint64 _sampleCounter{ 0 };
+    quint64 _skipped{ 0 };
+    bool _running{ false };
+    CanFrameBatch _pendingFrames;
+    std::vector<double> _pendingTimes;
+    quint64 _timeBase{ 0 }; // microseconds, same clock as CanFrameRecord::timestamp
+    bool _timeBaseChecked{ false };
+    quint64 _startUs{ 0 }; // capture start, time of frames without timestamp is relative to it
+};
+
+#endif // FRAMECAPTURE_H
@@ -0,0 +1,124 @@
+#include "framequery.h"
+#include <QtCore/QRegExp>
+#include <QtCore/QStringList>
+#include <log.h>
+
+namespace {
+bool parseIds(const QString& value, std::vector<std::pair<quint32, quint32>>& ranges)
+{
+    std::vector<std::pair<quint32, quint32>> parsed;
+
+    for (const auto& item : value.split(',', QString::SkipEmptyParts)) {
+        const QStringList bounds = item.split('-');
+        bool okFirst = false;
+        bool okLast = false;
+        const quint32 first = bounds.front().toUInt(&okFirst, 16);
+        const quint32 last = (bounds.size() == 2) ? bounds.back().toUInt(&okLast, 16) : first;
+
+        if (!okFirst || ((bounds.size() == 2) && !okLast) || (bounds.size() > 2) || (last < first)) {
+            return false;
+        }
+
+        parsed.emplace_back(first, last);
+    }
+
+    ranges.insert(ranges.end(), parsed.begin(), parsed.end());
+
+    return !parsed.empty();
+}
+
+bool parseTime(const QString& value, double& from, double& to)
+{
+    const int dash = value.indexOf('-');
+    const QString first = (dash < 0) ? value : value.left(dash);
+    const QString last = (dash < 0) ? value : value.mid(dash + 1);
+    bool ok = true;
+
+    if (!first.isEmpty()) {
+        from = first.toDouble(&ok);
+    }
+    if (ok && !last.isEmpty()) {
+        to = last.toDouble(&ok);
+    }
+
+    return ok && (from <= to);
+}
+
+bool parseData(const QString& value, QByteArray& data, QByteArray& mask)
+{
+    if ((value.size() % 2) || (value.size() / 2 > CanFrameRecord::kMaxPayload)) {
+        return false;
+    }
+
+    for (int i = 0; i < value.size(); i += 2) {
+        const QString byte = value.mid(i, 2);
+        bool ok = false;
+
+        if (byte == "??") {
+            data.append('\0');
+            mask.append('\0');
+            continue;
+        }
+
+        data.append(static_cast<char>(byte.toUInt(&ok, 16)));
+        mask.append('\xff');
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+FrameQuery FrameQuery::parse(const QString& text)
+{
+    FrameQuery query;
+
+    for (const auto& term : text.split(QRegExp("\\s+"), QString::SkipEmptyParts)) {
+        const int colon = term.indexOf(':');
+        const QString key = term.left(colon).toLower();
+        const QString value = term.mid(colon + 1).toLower();
+        bool ok = false;
+
+        if (colon < 0) {
+            // Not a term, reported below
+        } else if (key == "id") {
+            ok = parseIds(value, query.idRanges);
+        } else if (key == "t") {
+            ok = parseTime(value, query.timeFrom, query.timeTo);
+        } else if (key == "dir") {
+            ok = (value == "rx") || (value == "tx");
+            if (ok) {
+                query.direction = (value == "tx") ? Dir::Tx : Dir::Rx;
+            }
+        } else if (key == "data") {
+            QByteArray data;
+            QByteArray mask;
+
+            ok = parseData(value, data, mask);
+            if (ok) {
+                query.data = data;
+                query.dataMask = mask;
+            }
+        }
+
+        if (!ok) {
+            cds_warn("Invalid search term '{}' ignored", term.toStdString());
+        }
+    }
+
+    // Merge ranges, so that id lookup is a single binary search
+    std::sort(query.idRanges.begin(), query.idRanges.end());
+    std::vector<std::pair<quint32, quint32>> merged;
+    for (const auto& range : query.idRanges) {
+        if (!merged.empty() && (range.first <= merged.back().second + 1ULL)) {
+            merged.back().second = std::max(merged.back().second, range.second);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    query.idRanges = std::move(merged);
+
+    return query;
+}
@@ -0,0 +1,90 @@
+#ifndef FRAMEQUERY_H
+#define FRAMEQUERY_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <algorithm>
+#include <canframerecord.h>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+*   @brief  Search criteria over captured frames. Criteria of different kinds are ANDed, ids and id ranges are ORed.
+*
+*   Text form is a list of space separated terms:
+*       id:100-1ff,7df      hex ids and id ranges
+*       t:1.5-3             time range in seconds, either bound may be omitted ("t:2-")
+*       dir:rx              direction, rx or tx
+*       data:11??22         payload pattern from the first byte, ?? matches any byte
+*/
+struct FrameQuery {
+    enum class Dir { Any, Rx, Tx };
+
+    std::vector<std::pair<quint32, quint32>> idRanges; // sorted, disjoint, inclusive; empty matches all ids
+    double timeFrom{ -std::numeric_limits<double>::infinity() };
+    double timeTo{ std::numeric_limits<double>::infinity() };
+    Dir direction{ Dir::Any };
+    QByteArray data;
+    QByteArray dataMask; // same size as data
+
+    /**
+    *   @brief  Parses text form, invalid terms are reported and ignored
+    *   @param  text query text
+    *   @return query, empty if text has no valid term
+    */
+    static FrameQuery parse(const QString& text);
+
+    /**
+    *   @return true if query has no criteria, i.e. matches all frames
+    */
+    bool isEmpty() const
+    {
+        return idRanges.empty() && (timeFrom == -std::numeric_limits<double>::infinity())
+            && (timeTo == std::numeric_limits<double>::infinity()) && (direction == Dir::Any) && data.isEmpty();
+    }
+
+    /**
+    *   @brief  Checks single frame, cheapest criteria first
+    */
+    bool matches(quint32 id, quint8 flags, double time, quint8 length, const quint8* payload) const
+    {
+        if ((direction != Dir::Any) && (((flags & CanFrameRecord::Tx) != 0) != (direction == Dir::Tx))) {
+            return false;
+        }
+
+        if (!idRanges.empty() && !matchesId(id)) {
+            return false;
+        }
+
+        if ((time < timeFrom) || (time > timeTo)) {
+            return false;
+        }
+
+        if (length < data.size()) {
+            return false;
+        }
+
+        const char* pattern = data.constData();
+        const char* mask = dataMask.constData();
+        for (int i = 0; i < data.size(); ++i) {
+            if ((payload[i] ^ static_cast<quint8>(pattern[i])) & static_cast<quint8>(mask[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool matchesId(quint32 id) const
+    {
+        // Ranges are sorted by their first id, so the candidate is the last one starting at or below id
+        auto it = std::upper_bound(idRanges.begin(), idRanges.end(), id,
+            [](quint32 value, const std::pair<quint32, quint32>& range) { return value < range.first; });
+
+        return (it != idRanges.begin()) && (id <= std::prev(it)->second);
+    }
+};
+
+#endif // FRAMEQUERY_H
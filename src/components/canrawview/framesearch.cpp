@@ -0,0 +1,153 @@
+#include "framesearch.h"
+#include "frametablemodel.h"
+#include <QtCore/QThread>
+#include <algorithm>
+#include <thread>
+
+constexpr int FrameSearch::kStepRows;
+constexpr int FrameSearch::kMinChunkRows;
+
+FrameSearch::FrameSearch(FrameTableModel& model, QObject* parent)
+    : QObject(parent)
+    , _model(model)
+    , _threads(std::max(1, QThread::idealThreadCount()))
+{
+    _stepTimer.setSingleShot(true);
+    _stepTimer.setInterval(0);
+    connect(&_stepTimer, &QTimer::timeout, this, &FrameSearch::step);
+
+    connect(&_model, &FrameTableModel::rowsInserted, this, [this] {
+        if (_active) {
+            _stepTimer.start();
+        }
+    });
+    // Sequence numbers start from 0 again after reset
+    connect(&_model, &FrameTableModel::modelReset, this, [this] {
+        if (_active) {
+            restart();
+        }
+    });
+}
+
+void FrameSearch::start(const FrameQuery& query)
+{
+    if (query.isEmpty()) {
+        stop();
+        return;
+    }
+
+    _query = query;
+    _active = true;
+    restart();
+}
+
+void FrameSearch::stop()
+{
+    _active = false;
+    _stepTimer.stop();
+    _matches.clear();
+    _firstMatch = 0;
+}
+
+bool FrameSearch::isActive() const
+{
+    return _active;
+}
+
+bool FrameSearch::isComplete() const
+{
+    return !_active || (_nextSeq >= _model.seq(_model.rowCount()));
+}
+
+bool FrameSearch::matches(quint64 seq) const
+{
+    return !_active || std::binary_search(_matches.begin() + _firstMatch, _matches.end(), seq);
+}
+
+std::size_t FrameSearch::matchCount() const
+{
+    return _matches.size() - _firstMatch;
+}
+
+void FrameSearch::setThreadCount(int threads)
+{
+    _threads = std::max(1, threads);
+}
+
+void FrameSearch::step()
+{
+    if (!_active) {
+        return;
+    }
+
+    dropEvicted();
+
+    const quint64 firstSeq = _model.seq(0);
+    const int rows = _model.rowCount();
+
+    // Rows evicted before they were scanned are gone anyway
+    _nextSeq = std::max(_nextSeq, firstSeq);
+
+    const int first = static_cast<int>(_nextSeq - firstSeq);
+    const int last = std::min(rows, first + kStepRows);
+
+    if (first >= last) {
+        emit progress(matchCount(), true);
+        return;
+    }
+
+    // Model is modified only by this thread, so it stays intact while chunks are scanned
+    const int chunks = std::max(1, std::min(_threads, (last - first) / kMinChunkRows));
+    const int chunkRows = (last - first + chunks - 1) / chunks;
+    std::vector<std::vector<quint64>> results(static_cast<std::size_t>(chunks));
+    std::vector<std::thread> workers;
+
+    for (int i = 1; i < chunks; ++i) {
+        workers.emplace_back([this, &results, i, first, last, chunkRows] {
+            _model.select(_query, first + i * chunkRows, std::min(last, first + (i + 1) * chunkRows), results[i]);
+        });
+    }
+    _model.select(_query, first, std::min(last, first + chunkRows), results[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<int> matched;
+    for (const auto& result : results) {
+        for (quint64 seq : result) {
+            _matches.push_back(seq);
+            matched.push_back(static_cast<int>(seq - firstSeq));
+        }
+    }
+    _nextSeq = firstSeq + last;
+
+    _model.refreshFilter(std::move(matched));
+
+    const bool complete = (last == rows);
+    if (!complete) {
+        _stepTimer.start();
+    }
+
+    emit progress(matchCount(), complete);
+}
+
+void FrameSearch::restart()
+{
+    _matches.clear();
+    _firstMatch = 0;
+    _nextSeq = 0;
+    _stepTimer.start();
+}
+
+void FrameSearch::dropEvicted()
+{
+    const auto it = std::lower_bound(_matches.begin() + _firstMatch, _matches.end(), _model.seq(0));
+
+    _firstMatch = static_cast<std::size_t>(it - _matches.begin());
+
+    // Storage is compacted once most of it is evicted
+    if (_firstMatch > _matches.size() / 2) {
+        _matches.erase(_matches.begin(), _matches.begin() + _firstMatch);
+        _firstMatch = 0;
+    }
+}
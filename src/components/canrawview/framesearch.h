@@ -0,0 +1,91 @@
+#ifndef FRAMESEARCH_H
+#define FRAMESEARCH_H
+
+#include "framequery.h"
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <vector>
+
+class FrameTableModel;
+
+/**
+*   @brief  Incremental search over rows of FrameTableModel
+*
+*   Rows are scanned in steps of kStepRows, one step per event loop iteration, so that huge captures do not block
+*   GUI. Each step is split into chunks scanned by several threads at once. Matches are kept as sequence numbers,
+*   so they stay valid when old rows are evicted, and every step reports newly matched rows to the model, so that
+*   filtering proxy shows results as they come. Rows appended while search is active are scanned as well.
+*/
+class FrameSearch : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kStepRows = 1 << 20;
+    // Ranges smaller than this are not worth another thread
+    static constexpr int kMinChunkRows = 1 << 16;
+
+    explicit FrameSearch(FrameTableModel& model, QObject* parent = nullptr);
+
+    /**
+    *   @brief  Starts search, previous results are dropped. Empty query stops search.
+    */
+    void start(const FrameQuery& query);
+
+    /**
+    *   @brief  Stops search, all rows match again
+    */
+    void stop();
+
+    /**
+    *   @return true if search is active, i.e. rows are filtered
+    */
+    bool isActive() const;
+
+    /**
+    *   @return true if all rows of model have been scanned
+    */
+    bool isComplete() const;
+
+    /**
+    *   @return true if row of given sequence number matched, always true if search is not active
+    */
+    bool matches(quint64 seq) const;
+
+    /**
+    *   @return number of matching rows still present in model
+    */
+    std::size_t matchCount() const;
+
+    /**
+    *   @brief  Scans next step synchronously (normally done from event loop)
+    */
+    void step();
+
+    /**
+    *   @brief  Number of threads used for one step
+    */
+    void setThreadCount(int threads);
+
+signals:
+    /**
+    *   @brief  Emitted after every step
+    *   @param  matches number of matches so far
+    *   @param  complete true if all rows have been scanned
+    */
+    void progress(std::size_t matches, bool complete);
+
+private:
+    void restart();
+    void dropEvicted();
+
+    FrameTableModel& _model;
+    FrameQuery _query;
+    bool _active{ false };
+    quint64 _nextSeq{ 0 }; // sequence number of the first row not scanned yet
+    std::vector<quint64> _matches; // ascending, entries below _firstMatch were evicted from model
+    std::size_t _firstMatch{ 0 };
+    int _threads;
+    QTimer _stepTimer;
+};
+
+#endif // FRAMESEARCH_H
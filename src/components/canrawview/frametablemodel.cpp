@@ -0,0 +1,313 @@
+#include "frametablemodel.h"
+#include <algorithm>
+#include <hexformat.h>
+
+namespace {
+const char* const kHeaderLabels[FrameTableModel::ColumnCount]
+    = { "rowID", "timeDouble", "time", "idInt", "id", "dir", "dlc", "flags", "data" };
+} // namespace
+
+constexpr int FrameTableModel::kDefaultRetention;
+constexpr std::size_t FrameTableModel::kNoSlot;
+
+FrameTableModel::FrameTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int FrameTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _store.size();
+}
+
+int FrameTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant FrameTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (index.row() >= rowCount())) {
+        return {};
+    }
+
+    if (role == LatestRole) {
+        return isLatest(index.row());
+    }
+
+    if ((role != Qt::DisplayRole) && (role != PayloadRole)) {
+        return {};
+    }
+
+    const CaptureStore::Row row = _store.row(index.row());
+
+    if (role == PayloadRole) {
+        return QByteArray(reinterpret_cast<const char*>(row.payload.data()), row.length);
+    }
+
+    switch (index.column()) {
+    case RowId:
+        return static_cast<qulonglong>(_firstSeq + index.row());
+    case TimeDouble:
+        return row.time;
+    case Time:
+        return QString::number(row.time, 'f', 6);
+    case IdInt:
+        return static_cast<int>(row.id);
+    case Id: {
+        const FrameIdDirectory::Handle handle = _directory
+            ? _directory->find(row.id, (row.flags & CanFrameRecord::ExtendedId) != 0)
+            : FrameIdDirectory::kInvalidHandle;
+
+        return (handle != FrameIdDirectory::kInvalidHandle) ? _directory->idText(handle)
+                                                            : QString("0x" + QString::number(row.id, 16));
+    }
+    case Dir:
+        return QString((row.flags & CanFrameRecord::Tx) ? "TX" : "RX");
+    case Dlc:
+        return static_cast<int>(row.length);
+    case Flags:
+        return canFrameFlagsText(row.flags);
+    case Data:
+        return HexFormat::payloadToHex(row.payload.data(), row.length);
+    default:
+        return {};
+    }
+}
+
+QVariant FrameTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) && (section >= 0) && (section < ColumnCount)) {
+        return QString(kHeaderLabels[section]);
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void FrameTableModel::appendFrames(const CanFrameBatch& frames, const std::vector<double>& times)
+{
+    Q_ASSERT(static_cast<std::size_t>(frames.size()) == times.size());
+
+    int offset = 0;
+    int n = frames.size();
+
+    if (n == 0) {
+        return;
+    }
+
+    // Only the newest frames fit when batch is larger than retention limit
+    if (n > _retention) {
+        offset = n - _retention;
+        n = _retention;
+    }
+
+    const int count = _store.size();
+    const int evict = std::max(0, count + n - _retention);
+    if (evict > 0) {
+        beginRemoveRows(QModelIndex(), 0, evict - 1);
+        _store.dropFront(evict);
+        _firstSeq += evict;
+        _evicted += evict;
+        endRemoveRows();
+    }
+
+    // Frames that did not fit are evicted right away
+    _firstSeq += offset;
+    _evicted += offset;
+
+    const int first = _store.size();
+    const quint64 firstNewSeq = _firstSeq + first;
+    std::vector<int> superseded;
+
+    beginInsertRows(QModelIndex(), first, first + n - 1);
+    for (int i = 0; i < n; ++i) {
+        const CanFrameRecord& rec = frames[offset + i];
+
+        _store.append(rec, times[offset + i]);
+
+        quint64 previous;
+        // Only rows that were visible before this batch need to be reported
+        if (exchangeLatest(rec.id, rec.flags, firstNewSeq + i, previous) && (previous >= _firstSeq)
+            && (previous < firstNewSeq)) {
+            superseded.push_back(static_cast<int>(previous - _firstSeq));
+        }
+    }
+    endInsertRows();
+
+    // Filtering proxy re-evaluates only superseded rows
+    refreshFilter(std::move(superseded));
+}
+
+void FrameTableModel::refreshFilter(std::vector<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    for (std::size_t i = 0; i < rows.size();) {
+        std::size_t j = i;
+
+        while ((j + 1 < rows.size()) && (rows[j + 1] == rows[j] + 1)) {
+            ++j;
+        }
+
+        emit dataChanged(index(rows[i], 0), index(rows[j], ColumnCount - 1), { LatestRole });
+        i = j + 1;
+    }
+}
+
+void FrameTableModel::select(const FrameQuery& query, int first, int last, std::vector<quint64>& seqs) const
+{
+    // Blocks are decoded sequentially into local buffer, so that scanning threads do not share decoding cache
+    _store.forEach(first, last, [this, &query, &seqs](int row, const CaptureStore::Row& r) {
+        if (query.matches(r.id, r.flags, r.time, r.length, r.payload.data())) {
+            seqs.push_back(_firstSeq + row);
+        }
+    });
+}
+
+const CaptureStore& FrameTableModel::store() const
+{
+    return _store;
+}
+
+void FrameTableModel::setIdDirectory(const FrameIdDirectoryPtr& directory)
+{
+    if (directory == _directory) {
+        return;
+    }
+
+    // Pairs indexed by handles of previous directory continue in hash, the new one takes them over lazily
+    for (std::size_t slot = 0; slot < _latestByHandle.size(); ++slot) {
+        if (_latestByHandle[slot] != 0) {
+            const auto handle = static_cast<FrameIdDirectory::Handle>(slot / 2);
+            const auto flags = static_cast<quint8>((_directory->isExtended(handle) ? CanFrameRecord::ExtendedId : 0)
+                | ((slot & 1) ? CanFrameRecord::Tx : 0));
+
+            _latest.insert(canFrameKey(_directory->frameId(handle), flags), _latestByHandle[slot] - 1);
+        }
+    }
+
+    _latestByHandle.clear();
+    _directory = directory;
+}
+
+void FrameTableModel::clear()
+{
+    beginResetModel();
+    _store.clear();
+    _firstSeq = 0;
+    _evicted = 0;
+    _latest.clear();
+    _latestByHandle.clear();
+    endResetModel();
+}
+
+void FrameTableModel::setRetention(int rows)
+{
+    clear();
+    _retention = std::max(1, rows);
+}
+
+int FrameTableModel::retention() const
+{
+    return _retention;
+}
+
+quint64 FrameTableModel::evictedCount() const
+{
+    return _evicted;
+}
+
+quint64 FrameTableModel::seq(int row) const
+{
+    return _firstSeq + row;
+}
+
+double FrameTableModel::time(int row) const
+{
+    return _store.row(row).time;
+}
+
+quint32 FrameTableModel::frameId(int row) const
+{
+    return _store.row(row).id;
+}
+
+Direction FrameTableModel::direction(int row) const
+{
+    return (_store.row(row).flags & CanFrameRecord::Tx) ? Direction::TX : Direction::RX;
+}
+
+CanFrameRecord FrameTableModel::record(int row) const
+{
+    CanFrameRecord rec{};
+    const CaptureStore::Row r = _store.row(row);
+
+    rec.id = r.id;
+    rec.flags = r.flags;
+    rec.length = r.length;
+    std::copy(r.payload.begin(), r.payload.begin() + rec.length, rec.payload);
+
+    return rec;
+}
+
+bool FrameTableModel::isLatest(int row) const
+{
+    const CaptureStore::Row r = _store.row(row);
+    const std::size_t slot = latestSlot(r.id, r.flags);
+
+    if ((slot < _latestByHandle.size()) && (_latestByHandle[slot] != 0)) {
+        return _latestByHandle[slot] == seq(row) + 1;
+    }
+
+    return _latest.value(canFrameKey(r.id, r.flags)) == seq(row);
+}
+
+
+std::size_t FrameTableModel::latestSlot(quint32 id, quint8 flags) const
+{
+    const FrameIdDirectory::Handle handle = _directory
+        ? _directory->find(id, (flags & CanFrameRecord::ExtendedId) != 0)
+        : FrameIdDirectory::kInvalidHandle;
+
+    // Two slots per handle, one per direction
+    return (handle != FrameIdDirectory::kInvalidHandle) ? handle * 2 + ((flags & CanFrameRecord::Tx) ? 1 : 0)
+                                                        : kNoSlot;
+}
+
+bool FrameTableModel::exchangeLatest(quint32 id, quint8 flags, quint64 newSeq, quint64& previous)
+{
+    const quint32 key = canFrameKey(id, flags);
+    const std::size_t slot = latestSlot(id, flags);
+
+    if (slot != kNoSlot) {
+        if (slot >= _latestByHandle.size()) {
+            _latestByHandle.resize(slot + 1, 0);
+        }
+
+        quint64& latest = _latestByHandle[slot];
+        if (latest == 0) {
+            // Pair may have been seen before it got handle
+            auto it = _latest.find(key);
+            if (it != _latest.end()) {
+                latest = *it + 1;
+                _latest.erase(it);
+            }
+        }
+
+        const bool known = (latest != 0);
+        previous = latest - 1;
+        latest = newSeq + 1;
+
+        return known;
+    }
+
+    auto it = _latest.find(key);
+    if (it == _latest.end()) {
+        _latest.insert(key, newSeq);
+        return false;
+    }
+
+    previous = *it;
+    *it = newSeq;
+
+    return true;
+}
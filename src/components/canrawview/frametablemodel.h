@@ -0,0 +1,136 @@
+#ifndef FRAMETABLEMODEL_H
+#define FRAMETABLEMODEL_H
+
+#include "capturestore.h"
+#include "framequery.h"
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QHash>
+#include <canframerecord.h>
+#include <frameiddirectory.h>
+#include <vector>
+
+/**
+*   @brief  Table model of CanRawView backed by compressed capture store
+*
+*   Frames are kept in compact binary form, blocks of older frames compressed (see CaptureStore). Display strings
+*   (time, hex id, format flags, payload) are generated lazily in data(), so cost of a row does not depend on how it
+*   is presented. Once retention limit is reached the oldest rows are evicted, which keeps memory usage flat
+*   regardless of capture length.
+*
+*   When capture shows single device, newest frame of each pair is tracked in dense table indexed by handles of
+*   directory of the device (see setIdDirectory), ID strings are taken from the directory as well.
+*/
+class FrameTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+    *   @brief  Columns order
+    */
+    enum Column { RowId = 0, TimeDouble, Time, IdInt, Id, Dir, Dlc, Flags, Data, ColumnCount };
+
+    /**
+    *   @brief  Custom data roles
+    */
+    enum Role {
+        LatestRole = Qt::UserRole + 1, ///< true if row holds newest frame of its (id, direction) pair
+        PayloadRole = Qt::UserRole + 3 ///< QByteArray, raw payload painted by view without hex formatting
+    };
+
+    static constexpr int kDefaultRetention = 1000000;
+
+    explicit FrameTableModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+    *   @brief  Appends frames. Emits at most one rowsRemoved (eviction) and one rowsInserted signal. Rows
+    *           superseded by newer frame with the same id and direction are reported with dataChanged(LatestRole).
+    *   @param  frames frames to be appended
+    *   @param  times time of each frame in seconds since simulation start, same size as frames
+    */
+    void appendFrames(const CanFrameBatch& frames, const std::vector<double>& times);
+
+    /**
+    *   @brief  Removes all rows
+    */
+    void clear();
+
+    /**
+    *   @brief  Sets maximum number of rows kept in model. Current content is dropped.
+    *   @param  rows retention limit, must be greater than 0
+    */
+    void setRetention(int rows);
+
+    /**
+    *   @return maximum number of rows kept in model
+    */
+    int retention() const;
+
+    /**
+    *   @return total number of frames evicted since last clear
+    */
+    quint64 evictedCount() const;
+
+    /**
+    *   @brief  Fast accessors used by proxy models to avoid QVariant round trips
+    */
+    quint64 seq(int row) const;
+    double time(int row) const;
+    quint32 frameId(int row) const;
+    Direction direction(int row) const;
+    CanFrameRecord record(int row) const;
+
+    /**
+    *   @return true if row holds the newest frame of its (id, direction) pair
+    */
+    bool isLatest(int row) const;
+
+    /**
+    *   @brief  Collects sequence numbers of rows matching query. Columns are scanned directly. Several threads
+    *           may scan disjoint ranges at once, as long as model is not modified meanwhile.
+    *   @param  query search criteria
+    *   @param  first first row
+    *   @param  last row past the last one
+    *   @param  seqs matching sequence numbers are appended here, in ascending order
+    */
+    void select(const FrameQuery& query, int first, int last, std::vector<quint64>& seqs) const;
+
+    /**
+    *   @brief  Reports rows with dataChanged(LatestRole) in contiguous ranges, so that filtering proxy re-evaluates
+    *           them. Used when filtering input other than model itself (e.g. search result) changes.
+    *   @param  rows rows to be re-evaluated, in any order
+    */
+    void refreshFilter(std::vector<int> rows);
+
+    /**
+    *   @return frame storage, e.g. to query its memory usage
+    */
+    const CaptureStore& store() const;
+
+    /**
+    *   @brief  Indexes frames by handles of directory of the bus they come from. Frames of IDs directory does not
+    *           know are indexed by hash as without directory.
+    *   @param  directory directory of source device, nullptr if frames come from elsewhere
+    */
+    void setIdDirectory(const FrameIdDirectoryPtr& directory);
+
+private:
+    std::size_t latestSlot(quint32 id, quint8 flags) const;
+    bool exchangeLatest(quint32 id, quint8 flags, quint64 newSeq, quint64& previous);
+
+    static constexpr std::size_t kNoSlot = ~static_cast<std::size_t>(0);
+
+    CaptureStore _store;
+    int _retention{ kDefaultRetention };
+    quint64 _firstSeq{ 0 }; // sequence number (rowID) of row 0
+    quint64 _evicted{ 0 };
+    QHash<quint32, quint64> _latest; // canFrameKey -> sequence number of newest frame, pairs without handle
+    FrameIdDirectoryPtr _directory;
+    std::vector<quint64> _latestByHandle; // latestSlot -> sequence number of newest frame + 1, 0 if none
+};
+
+#endif // FRAMETABLEMODEL_H
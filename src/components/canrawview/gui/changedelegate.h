@@ -0,0 +1,62 @@
+#ifndef CHANGEDELEGATE_H
+#define CHANGEDELEGATE_H
+
+#include <QtGui/QPainter>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QStyledItemDelegate>
+
+/**
+*   @brief  Paints payload column of change-detection view with bytes changed by the last update highlighted
+*
+*   Changed bytes are read from ChangeTableModel::ChangedBytesRole, payload text is expected in "01 ab ff" form.
+*/
+struct ChangeDelegate : public QStyledItemDelegate {
+    ChangeDelegate(int changedBytesRole, QObject* parent = nullptr)
+        : QStyledItemDelegate(parent)
+        , _role(changedBytesRole)
+    {
+    }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        const quint64 changed = index.data(_role).toULongLong();
+
+        if (changed == 0) {
+            QStyledItemDelegate::paint(painter, option, index);
+            return;
+        }
+
+        QStyleOptionViewItem opt = option;
+        initStyleOption(&opt, index);
+        const QString text = opt.text;
+        opt.text.clear();
+
+        // Background and selection as usual, bytes are drawn on top of it
+        QStyle* style = opt.widget ? opt.widget->style() : QApplication::style();
+        style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+        const QRect rect = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, opt.widget).adjusted(2, 0, -2, 0);
+        const QFontMetrics& fm = opt.fontMetrics;
+
+        painter->save();
+        painter->setFont(opt.font);
+        for (int byte = 0; (byte < 64) && (byte * 3 + 2 <= text.size()); ++byte) {
+            if (changed & (1ULL << byte)) {
+                const int x = rect.left() + fm.width(text.left(byte * 3));
+                const int width = fm.width(text.mid(byte * 3, 2));
+
+                painter->fillRect(QRect(x, rect.top(), width, rect.height()), kHighlight);
+            }
+        }
+        painter->setPen(opt.palette.color(
+            (opt.state & QStyle::State_Selected) ? QPalette::HighlightedText : QPalette::Text));
+        painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter, fm.elidedText(text, opt.textElideMode, rect.width()));
+        painter->restore();
+    }
+
+private:
+    const QColor kHighlight{ 255, 200, 110 };
+    int _role;
+};
+
+#endif // CHANGEDELEGATE_H
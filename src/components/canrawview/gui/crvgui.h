@@ -1,103 +1,296 @@
 #ifndef CRVGUI_H
 #define CRVGUI_H
 
+#include "changedelegate.h"
 #include "crvguiinterface.h"
+#include "framedelegate.h"
 #include "ui_canrawview.h"
+#include <QtWidgets/QFileDialog>
+#include <functional>
 #include <memory>
+#include <vector>
 
+/**
+*   @brief  Widget implementation of CRVGuiInterface
+*
+*   Widget tree is built on first getMainWidget() call, i.e. when the view is shown for the first time. Until then
+*   callbacks, models and view state are recorded and applied in order once widgets exist, so loading project with
+*   many views does not allocate widgets that are never shown.
+*
+*   Table is tuned for autoscroll at high frame rates: cells are painted by FrameDelegate and rows have fixed
+*   height, so scrolling and appending touch visible rows only.
+*/
 struct CRVGui : public CRVGuiInterface {
 
-    CRVGui()
-        : ui(new Ui::CanRawViewPrivate)
-        , widget(new QWidget)
-    {
-        ui->setupUi(widget);
-    }
+    CRVGui() = default;
 
     virtual void setClearCbk(const clear_t& cb) override
     {
-        QObject::connect(ui->pbClear, &QPushButton::pressed, cb);
+        apply([this, cb] { QObject::connect(ui->pbClear, &QPushButton::pressed, cb); });
     }
 
     virtual void setDockUndockCbk(const dockUndock_t& cb) override
     {
-        QObject::connect(ui->pbDockUndock, &QPushButton::toggled, cb);
+        apply([this, cb] { QObject::connect(ui->pbDockUndock, &QPushButton::toggled, cb); });
     }
 
     virtual void setSectionClikedCbk(const sectionClicked_t& cb) override
     {
-        QObject::connect(ui->tv->horizontalHeader(), &QHeaderView::sectionClicked, cb);
+        apply([this, cb] { QObject::connect(ui->tv->horizontalHeader(), &QHeaderView::sectionClicked, cb); });
     }
 
     virtual void setFilterCbk(const filter_t& cb) override
     {
-        QObject::connect(ui->pbToggleFilter, &QPushButton::toggled, cb);
+        apply([this, cb] { QObject::connect(ui->pbToggleFilter, &QPushButton::toggled, cb); });
+    }
+
+    virtual void setOpenTraceCbk(const openTrace_t& cb) override
+    {
+        apply([this, cb] {
+            QObject::connect(ui->pbOpenTrace, &QPushButton::clicked, [this, cb] {
+                if (ui->pbOpenTrace->isChecked()) {
+                    const QString path = QFileDialog::getOpenFileName(
+                        widget, "Open trace", QString(), "Traces (*.cdst);;All files (*)");
+                    if (path.isEmpty()) {
+                        ui->pbOpenTrace->setChecked(false);
+                        return;
+                    }
+                    cb(path);
+                } else {
+                    // Empty path closes trace and returns to live view
+                    cb(QString());
+                }
+            });
+        });
+    }
+
+    virtual void setGoToTimeCbk(const goToTime_t& cb) override
+    {
+        apply([this, cb] {
+            QObject::connect(ui->leGoToTime, &QLineEdit::returnPressed, [this, cb] {
+                bool ok = false;
+                const double time = ui->leGoToTime->text().toDouble(&ok);
+                if (ok) {
+                    cb(time);
+                }
+            });
+        });
+    }
+
+    virtual void setIdFilterCbk(const idFilter_t& cb) override
+    {
+        apply([this, cb] {
+            QObject::connect(ui->leIdFilter, &QLineEdit::returnPressed, [this, cb] { cb(ui->leIdFilter->text()); });
+        });
+    }
+
+    virtual void setChangeModeCbk(const changeMode_t& cb) override
+    {
+        apply([this, cb] { QObject::connect(ui->pbChanges, &QPushButton::toggled, cb); });
+    }
+
+    virtual void setSearchCbk(const search_t& cb) override
+    {
+        apply([this, cb] {
+            QObject::connect(ui->leSearch, &QLineEdit::returnPressed, [this, cb] { cb(ui->leSearch->text()); });
+        });
+    }
+
+    virtual void setExportCbk(const export_t& cb) override
+    {
+        apply([this, cb] {
+            QObject::connect(ui->pbExport, &QPushButton::clicked, [this, cb] {
+                QString filter;
+                QString path = QFileDialog::getSaveFileName(widget, "Export frames", QString(),
+                    "Vector ASC (*.asc);;Vector BLF (*.blf);;candump log (*.log);;pcapng (*.pcapng)", &filter);
+                if (path.isEmpty()) {
+                    return;
+                }
+
+                // Format is chosen by suffix, take it from selected filter if user did not type one
+                const QString suffix = filter.mid(filter.indexOf("*.") + 1).remove(')');
+                if (!path.endsWith(suffix, Qt::CaseInsensitive)) {
+                    path += suffix;
+                }
+                cb(path);
+            });
+        });
+    }
+
+    virtual void setSearchStatus(const QString& status) override
+    {
+        apply([this, status] { ui->lbSearchStatus->setText(status); });
+    }
+
+    virtual void setLoadStatus(const QString& status) override
+    {
+        apply([this, status] {
+            ui->lbLoadStatus->setText(status);
+            ui->lbLoadStatus->setVisible(!status.isEmpty());
+        });
     }
 
     virtual QWidget* getMainWidget() override
     {
+        if (!widget) {
+            build();
+        }
+
         return widget;
     }
 
+    virtual bool isMainWidgetCreated() override
+    {
+        return widget != nullptr;
+    }
+
     virtual void setModel(QAbstractItemModel* model) override
     {
-        ui->tv->setModel(model);
+        apply([this, model] { ui->tv->setModel(model); });
     }
 
     virtual void initTableView(QAbstractItemModel& tvModel) override
     {
-        ui->tv->setModel(&tvModel);
-        ui->tv->horizontalHeader()->setSectionsMovable(true);
-        ui->tv->horizontalHeader()->setSortIndicator(0, Qt::AscendingOrder);
-        ui->tv->setColumnHidden(0, true);
-        ui->tv->setColumnHidden(1, true);
-        ui->tv->setColumnHidden(3, true);
+        apply([this, &tvModel] {
+            ui->tv->setModel(&tvModel);
+            ui->tv->horizontalHeader()->setSectionsMovable(true);
+            ui->tv->horizontalHeader()->setSortIndicator(0, Qt::AscendingOrder);
+            for (int column = 0; column < tvModel.columnCount(); ++column) {
+                ui->tv->setColumnHidden(column, isHiddenByDefault(column));
+            }
+        });
     }
 
     virtual bool isViewFrozen() override
     {
-        return ui->freezeBox->isChecked();
+        return widget && ui->freezeBox->isChecked();
+    }
+
+    virtual void scrollToRow(int row) override
+    {
+        auto model = widget ? ui->tv->model() : nullptr;
+
+        if (model && (row >= 0) && (row < model->rowCount())) {
+            ui->tv->scrollTo(model->index(row, 0), QAbstractItemView::PositionAtTop);
+        }
+    }
+
+    virtual void setTraceMode(bool trace) override
+    {
+        apply([this, trace] {
+            ui->pbOpenTrace->setChecked(trace);
+            ui->pbClear->setDisabled(trace);
+            ui->leGoToTime->setVisible(trace);
+            ui->leIdFilter->setVisible(trace);
+            // Search runs over live capture, trace has its own id filter
+            ui->leSearch->setVisible(!trace);
+            ui->lbSearchStatus->setVisible(!trace);
+        });
+    }
+
+    virtual void setChangeMode(bool changes) override
+    {
+        apply([this, changes] {
+            ui->pbChanges->setChecked(changes);
+            // Combined view and trace browsing apply to frame history only
+            ui->pbToggleFilter->setDisabled(changes);
+            ui->pbOpenTrace->setDisabled(changes);
+            ui->leSearch->setDisabled(changes);
+            ui->tv->setItemDelegateForColumn(kDataColumn, changes ? changeDelegate : nullptr);
+        });
     }
 
     virtual void scrollToBottom() override
     {
-        ui->tv->scrollToBottom();
+        if (widget) {
+            ui->tv->scrollToBottom();
+        }
     }
 
     virtual Qt::SortOrder getSortOrder() override
     {
-        return ui->tv->horizontalHeader()->sortIndicatorOrder();
+        return widget ? ui->tv->horizontalHeader()->sortIndicatorOrder() : Qt::AscendingOrder;
     }
 
     virtual int getSortSection() override
     {
-        return ui->tv->horizontalHeader()->sortIndicatorSection();
+        return widget ? ui->tv->horizontalHeader()->sortIndicatorSection() : 0;
     }
 
     virtual QString getClickedColumn(int ndx) override
     {
-        return ui->tv->model()->headerData(ndx, Qt::Horizontal).toString();
+        return (widget && ui->tv->model()) ? ui->tv->model()->headerData(ndx, Qt::Horizontal).toString() : QString();
     }
 
     virtual void setSorting(int sortNdx, int clickedNdx, Qt::SortOrder order) override
     {
-        ui->tv->sortByColumn(sortNdx, order);
-        ui->tv->horizontalHeader()->setSortIndicator(clickedNdx, order);
+        apply([this, sortNdx, clickedNdx, order] {
+            ui->tv->sortByColumn(sortNdx, order);
+            ui->tv->horizontalHeader()->setSortIndicator(clickedNdx, order);
+        });
     }
 
     virtual QString getWindowTitle() override
     {
-        return widget->windowTitle();
+        // Title of canrawview.ui, widget is not built just to read it
+        return widget ? widget->windowTitle() : QStringLiteral("CANrawView");
     }
 
     virtual bool isColumnHidden(int ndx) override
     {
-        return ui->tv->isColumnHidden(ndx);
+        return widget ? ui->tv->isColumnHidden(ndx) : isHiddenByDefault(ndx);
     }
 
 private:
-    Ui::CanRawViewPrivate* ui;
-    QWidget* widget;
+    static bool isHiddenByDefault(int ndx)
+    {
+        // rowID, timeDouble and idInt are used for sorting only
+        return (ndx == 0) || (ndx == 1) || (ndx == 3);
+    }
+
+    void apply(std::function<void()>&& action)
+    {
+        if (widget) {
+            action();
+        } else {
+            _pending.push_back(std::move(action));
+        }
+    }
+
+    void build()
+    {
+        ui = new Ui::CanRawViewPrivate;
+        widget = new QWidget;
+        ui->setupUi(widget);
+        // Trace browsing controls are shown only when trace is open
+        ui->leIdFilter->hide();
+        ui->leGoToTime->hide();
+        changeDelegate = new ChangeDelegate(kChangedBytesRole, widget);
+        frameDelegate = new FrameDelegate(kDataColumn, kPayloadRole, widget);
+
+        ui->tv->setItemDelegate(frameDelegate);
+        ui->tv->setWordWrap(false);
+        // Rows are never measured, their positions follow from row number
+        ui->tv->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        ui->tv->verticalHeader()->setDefaultSectionSize(FrameDelegate::rowHeight(ui->tv->fontMetrics()));
+
+        for (auto& action : _pending) {
+            action();
+        }
+        _pending.clear();
+    }
+
+    // FrameTableModel::Data, ChangeTableModel::ChangedBytesRole and FrameTableModel::PayloadRole, GUI does not
+    // depend on models
+    static constexpr int kDataColumn = 8;
+    static constexpr int kChangedBytesRole = Qt::UserRole + 2;
+    static constexpr int kPayloadRole = Qt::UserRole + 3;
+
+    Ui::CanRawViewPrivate* ui{ nullptr };
+    ChangeDelegate* changeDelegate{ nullptr };
+    FrameDelegate* frameDelegate{ nullptr };
+    QWidget* widget{ nullptr };
+    std::vector<std::function<void()>> _pending;
 };
 
 #endif // CRVGUI_H
@@ -1,6 +1,7 @@
 #ifndef CRVGUIINTERFACE_H
 #define CRVGUIINTERFACE_H
 
+#include <QtCore/QString>
 #include <Qt>
 #include <functional>
 
@@ -12,21 +13,39 @@ struct CRVGuiInterface {
     typedef std::function<void()> dockUndock_t;
     typedef std::function<void(int)> sectionClicked_t;
     typedef std::function<void()> filter_t;
+    typedef std::function<void(const QString&)> openTrace_t;
+    typedef std::function<void(double)> goToTime_t;
+    typedef std::function<void(const QString&)> idFilter_t;
+    typedef std::function<void(bool)> changeMode_t;
+    typedef std::function<void(const QString&)> search_t;
+    typedef std::function<void(const QString&)> export_t;
 
     virtual void setClearCbk(const clear_t& cb) = 0;
     virtual void setDockUndockCbk(const dockUndock_t& cb) = 0;
     virtual void setSectionClikedCbk(const sectionClicked_t& cb) = 0;
     virtual void setFilterCbk(const filter_t& cb) = 0;
+    virtual void setOpenTraceCbk(const openTrace_t& cb) = 0;
+    virtual void setGoToTimeCbk(const goToTime_t& cb) = 0;
+    virtual void setIdFilterCbk(const idFilter_t& cb) = 0;
+    virtual void setChangeModeCbk(const changeMode_t& cb) = 0;
+    virtual void setSearchCbk(const search_t& cb) = 0;
+    virtual void setExportCbk(const export_t& cb) = 0;
 
     virtual ~CRVGuiInterface()
     {
     }
 
     virtual QWidget* getMainWidget() = 0;
+    virtual bool isMainWidgetCreated() = 0;
     virtual void setModel(QAbstractItemModel* model) = 0;
     virtual void initTableView(QAbstractItemModel& tvModel) = 0;
     virtual bool isViewFrozen() = 0;
     virtual void scrollToBottom() = 0;
+    virtual void scrollToRow(int row) = 0;
+    virtual void setTraceMode(bool trace) = 0;
+    virtual void setChangeMode(bool changes) = 0;
+    virtual void setSearchStatus(const QString& status) = 0;
+    virtual void setLoadStatus(const QString& status) = 0;
     virtual Qt::SortOrder getSortOrder() = 0;
     virtual int getSortSection() = 0;
     virtual QString getClickedColumn(int ndx) = 0;
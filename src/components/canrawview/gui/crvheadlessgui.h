@@ -0,0 +1,128 @@
+#ifndef CRVHEADLESSGUI_H
+#define CRVHEADLESSGUI_H
+
+#include "crvguiinterface.h"
+
+/**
+*   @brief  No-op implementation of CRVGuiInterface for running without display. Frames are still collected in
+*           table model, nothing is presented.
+*/
+struct CRVHeadlessGui : public CRVGuiInterface {
+    void setClearCbk(const clear_t&) override
+    {
+    }
+
+    void setDockUndockCbk(const dockUndock_t&) override
+    {
+    }
+
+    void setSectionClikedCbk(const sectionClicked_t&) override
+    {
+    }
+
+    void setFilterCbk(const filter_t&) override
+    {
+    }
+
+    void setOpenTraceCbk(const openTrace_t&) override
+    {
+    }
+
+    void setGoToTimeCbk(const goToTime_t&) override
+    {
+    }
+
+    void setIdFilterCbk(const idFilter_t&) override
+    {
+    }
+
+    void setChangeModeCbk(const changeMode_t&) override
+    {
+    }
+
+    void setSearchCbk(const search_t&) override
+    {
+    }
+
+    void setExportCbk(const export_t&) override
+    {
+    }
+
+    QWidget* getMainWidget() override
+    {
+        return nullptr;
+    }
+
+    bool isMainWidgetCreated() override
+    {
+        return false;
+    }
+
+    void setModel(QAbstractItemModel*) override
+    {
+    }
+
+    void initTableView(QAbstractItemModel&) override
+    {
+    }
+
+    bool isViewFrozen() override
+    {
+        return false;
+    }
+
+    void scrollToBottom() override
+    {
+    }
+
+    void scrollToRow(int) override
+    {
+    }
+
+    void setTraceMode(bool) override
+    {
+    }
+
+    void setChangeMode(bool) override
+    {
+    }
+
+    void setSearchStatus(const QString&) override
+    {
+    }
+
+    void setLoadStatus(const QString&) override
+    {
+    }
+
+    Qt::SortOrder getSortOrder() override
+    {
+        return Qt::AscendingOrder;
+    }
+
+    int getSortSection() override
+    {
+        return 0;
+    }
+
+    QString getClickedColumn(int) override
+    {
+        return {};
+    }
+
+    void setSorting(int, int, Qt::SortOrder) override
+    {
+    }
+
+    QString getWindowTitle() override
+    {
+        return "CANrawView";
+    }
+
+    bool isColumnHidden(int) override
+    {
+        return false;
+    }
+};
+
+#endif // CRVHEADLESSGUI_H
@@ -0,0 +1,114 @@
+#ifndef FRAMEDELEGATE_H
+#define FRAMEDELEGATE_H
+
+#include <QtGui/QPainter>
+#include <QtGui/QStaticText>
+#include <QtWidgets/QStyledItemDelegate>
+#include <array>
+
+/**
+*   @brief  Paints cells of frame table directly, without item view style
+*
+*   Default delegate queries about ten roles per cell (font, alignment, colors, check state, decoration...) and lays
+*   text out for eliding. Here each cell takes single data() call. Payload column is read as raw bytes and drawn
+*   from cached static texts of all 256 byte values, other columns are drawn as single line clipped to cell. Rows
+*   have fixed height (see rowHeight), so view never measures them.
+*/
+struct FrameDelegate : public QStyledItemDelegate {
+    /**
+    *   @param  payloadColumn column painted from raw payload
+    *   @param  payloadRole role returning payload as QByteArray, models without it are painted from display text
+    */
+    FrameDelegate(int payloadColumn, int payloadRole, QObject* parent = nullptr)
+        : QStyledItemDelegate(parent)
+        , _payloadColumn(payloadColumn)
+        , _payloadRole(payloadRole)
+    {
+    }
+
+    /**
+    *   @return height of every row for given font
+    */
+    static int rowHeight(const QFontMetrics& fm)
+    {
+        return fm.height() + 2 * kMargin;
+    }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        const bool selected = option.state & QStyle::State_Selected;
+        const QRect rect = option.rect.adjusted(kMargin, 0, -kMargin, 0);
+
+        painter->save();
+        if (selected) {
+            painter->fillRect(option.rect, option.palette.highlight());
+        }
+        painter->setFont(option.font);
+        painter->setPen(option.palette.color(selected ? QPalette::HighlightedText : QPalette::Text));
+
+        const QVariant payload = (index.column() == _payloadColumn) ? index.data(_payloadRole) : QVariant();
+        if (payload.isValid()) {
+            paintPayload(painter, option, rect, payload.toByteArray());
+        } else {
+            painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, index.data().toString());
+        }
+        painter->restore();
+    }
+
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        return QSize(option.fontMetrics.width(index.data().toString()) + 2 * kMargin, rowHeight(option.fontMetrics));
+    }
+
+private:
+    void paintPayload(QPainter* painter, const QStyleOptionViewItem& option, const QRect& rect,
+        const QByteArray& payload) const
+    {
+        prepare(option);
+
+        const int y = rect.top() + (rect.height() - option.fontMetrics.height()) / 2;
+        int x = rect.left();
+
+        // Bytes that do not fit are not drawn at all instead of being clipped one by one
+        for (const char byte : payload) {
+            if (x + _byteWidth > rect.right()) {
+                break;
+            }
+            painter->drawStaticText(x, y, _bytes[static_cast<quint8>(byte)]);
+            x += _byteAdvance;
+        }
+    }
+
+    void prepare(const QStyleOptionViewItem& option) const
+    {
+        if (_prepared && (option.font == _font)) {
+            return;
+        }
+
+        _font = option.font;
+        _byteWidth = option.fontMetrics.width("00");
+        _byteAdvance = option.fontMetrics.width("00 ");
+
+        for (int value = 0; value < 256; ++value) {
+            QStaticText& text = _bytes[static_cast<std::size_t>(value)];
+
+            text.setText(QString("%1").arg(value, 2, 16, QChar('0')));
+            text.setTextFormat(Qt::PlainText);
+            text.prepare(QTransform(), _font);
+        }
+        _prepared = true;
+    }
+
+    static constexpr int kMargin = 2;
+
+    int _payloadColumn;
+    int _payloadRole;
+    // Glyph layout of hex byte values, prepared for font of view
+    mutable std::array<QStaticText, 256> _bytes;
+    mutable QFont _font;
+    mutable int _byteWidth{ 0 };
+    mutable int _byteAdvance{ 0 };
+    mutable bool _prepared{ false };
+};
+
+#endif // FRAMEDELEGATE_H
@@ -0,0 +1,299 @@
+#include "tracetablemodel.h"
+#include <algorithm>
+#include <hexformat.h>
+#include <limits>
+
+namespace {
+const char* const kHeaderLabels[FrameTableModel::ColumnCount]
+    = { "rowID", "timeDouble", "time", "idInt", "id", "dir", "dlc", "flags", "data" };
+// Records scanned between checks of cancellation flag
+const quint64 kCancelCheckInterval = 65536;
+} // namespace
+
+TraceTableModel::TraceTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , _worker(*this)
+{
+    _worker.setObjectName("TraceIndex");
+    connect(&_worker, &QThread::finished, this, &TraceTableModel::indexBuilt);
+}
+
+TraceTableModel::~TraceTableModel()
+{
+    cancelIndexing();
+}
+
+int TraceTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : _rowCount;
+}
+
+int TraceTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : FrameTableModel::ColumnCount;
+}
+
+QVariant TraceTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (index.row() >= _rowCount)) {
+        return {};
+    }
+
+    if (role == FrameTableModel::LatestRole) {
+        if (!_index) {
+            return false;
+        }
+
+        const auto& latest = _index->latest;
+        return std::binary_search(latest.begin(), latest.end(), static_cast<quint32>(recordIndex(index.row())));
+    }
+
+    if ((role != Qt::DisplayRole) && (role != FrameTableModel::PayloadRole)) {
+        return {};
+    }
+
+    // Record is read straight from mapped file
+    const CanFrameRecord& rec = record(index.row());
+
+    if (role == FrameTableModel::PayloadRole) {
+        return QByteArray(reinterpret_cast<const char*>(rec.payload), rec.length);
+    }
+    const double time = (static_cast<qint64>(rec.timestamp) - static_cast<qint64>(_firstTimestamp)) * _timeScale;
+
+    switch (index.column()) {
+    case FrameTableModel::RowId:
+        return static_cast<qulonglong>(recordIndex(index.row()) + 1);
+    case FrameTableModel::TimeDouble:
+        return time;
+    case FrameTableModel::Time:
+        return QString::number(time, 'f', 6);
+    case FrameTableModel::IdInt:
+        return static_cast<int>(rec.id);
+    case FrameTableModel::Id:
+        return QString("0x" + QString::number(rec.id, 16));
+    case FrameTableModel::Dir:
+        return QString(rec.hasFlag(CanFrameRecord::Tx) ? "TX" : "RX");
+    case FrameTableModel::Dlc:
+        return static_cast<int>(rec.length);
+    case FrameTableModel::Flags:
+        return canFrameFlagsText(rec.flags);
+    case FrameTableModel::Data:
+        return HexFormat::payloadToHex(rec.payload, rec.length);
+    default:
+        return {};
+    }
+}
+
+QVariant TraceTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) && (section >= 0)
+        && (section < FrameTableModel::ColumnCount)) {
+        return QString(kHeaderLabels[section]);
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool TraceTableModel::open(const QString& path)
+{
+    close();
+
+    beginResetModel();
+    const bool opened = _reader.open(path);
+    if (opened) {
+        _firstTimestamp = _reader.firstTimestamp();
+        updateRows();
+    }
+    endResetModel();
+
+    if (opened) {
+        _cancel = false;
+        _worker.start(QThread::LowPriority);
+    }
+
+    return opened;
+}
+
+void TraceTableModel::close()
+{
+    cancelIndexing();
+
+    beginResetModel();
+    _reader.close();
+    _index.reset();
+    _pendingIndex.reset();
+    _rows.clear();
+    _filtered = false;
+    _rowCount = 0;
+    endResetModel();
+}
+
+bool TraceTableModel::isOpen() const
+{
+    return _reader.isOpen();
+}
+
+QString TraceTableModel::path() const
+{
+    return _reader.fileName();
+}
+
+bool TraceTableModel::isIndexReady() const
+{
+    return static_cast<bool>(_index);
+}
+
+void TraceTableModel::setUniqueOnly(bool unique)
+{
+    if (_uniqueOnly == unique) {
+        return;
+    }
+
+    _uniqueOnly = unique;
+
+    beginResetModel();
+    updateRows();
+    endResetModel();
+}
+
+bool TraceTableModel::uniqueOnly() const
+{
+    return _uniqueOnly;
+}
+
+void TraceTableModel::setIdFilter(const QVector<quint32>& ids)
+{
+    _idFilter = ids;
+    std::sort(_idFilter.begin(), _idFilter.end());
+    _idFilter.erase(std::unique(_idFilter.begin(), _idFilter.end()), _idFilter.end());
+
+    beginResetModel();
+    updateRows();
+    endResetModel();
+}
+
+int TraceTableModel::rowForTime(double seconds) const
+{
+    if (_rowCount == 0) {
+        return -1;
+    }
+
+    const double offset = std::max(0.0, seconds) / _timeScale;
+    const quint64 ndx = _reader.findTimestamp(_firstTimestamp + static_cast<quint64>(offset));
+    int row;
+
+    if (_filtered) {
+        row = static_cast<int>(std::lower_bound(_rows.begin(), _rows.end(), ndx) - _rows.begin());
+    } else {
+        row = static_cast<int>(std::min<quint64>(ndx, std::numeric_limits<int>::max()));
+    }
+
+    return std::min(row, _rowCount - 1);
+}
+
+const CanFrameRecord& TraceTableModel::record(int row) const
+{
+    return *_reader.record(recordIndex(row));
+}
+
+quint64 TraceTableModel::recordIndex(int row) const
+{
+    return _filtered ? _rows[static_cast<std::size_t>(row)] : static_cast<quint64>(row);
+}
+
+void TraceTableModel::indexBuilt()
+{
+    if (_worker.isRunning() || !_pendingIndex) {
+        // Cancelled, or notification of worker that was replaced by newer one
+        return;
+    }
+
+    _index = std::move(_pendingIndex);
+
+    if (_uniqueOnly || !_idFilter.isEmpty()) {
+        beginResetModel();
+        updateRows();
+        endResetModel();
+    } else if (_rowCount > 0) {
+        // Only LatestRole changes
+        emit dataChanged(index(0, 0), index(std::max(0, _rowCount - 1), FrameTableModel::ColumnCount - 1),
+            { FrameTableModel::LatestRole });
+    }
+
+    emit indexReady();
+}
+
+
+void TraceTableModel::buildIndex()
+{
+    // Executed in worker thread. Reader is only read, mapping stays valid until worker is stopped.
+    auto built = std::make_unique<Index>();
+    const quint64 count = std::min<quint64>(_reader.recordCount(), std::numeric_limits<int>::max());
+
+    for (quint64 i = 0; i < count; ++i) {
+        if (((i % kCancelCheckInterval) == 0) && _cancel.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const CanFrameRecord* rec = _reader.record(i);
+        built->rowsOfKey[canFrameKey(rec->id, rec->flags)].push_back(static_cast<quint32>(i));
+    }
+
+    built->latest.reserve(built->rowsOfKey.size());
+    for (const auto& key : built->rowsOfKey) {
+        built->latest.push_back(key.second.back());
+    }
+    std::sort(built->latest.begin(), built->latest.end());
+
+    _pendingIndex = std::move(built);
+}
+
+void TraceTableModel::cancelIndexing()
+{
+    _cancel = true;
+    _worker.wait();
+    _pendingIndex.reset();
+}
+
+void TraceTableModel::updateRows()
+{
+    const quint64 total = std::min<quint64>(_reader.recordCount(), std::numeric_limits<int>::max());
+
+    _rows.clear();
+    _filtered = false;
+
+    if (!_index || (!_uniqueOnly && _idFilter.isEmpty())) {
+        // Filters wait for index, until then all records are shown
+        _rowCount = static_cast<int>(total);
+        return;
+    }
+
+    _filtered = true;
+
+    if (_uniqueOnly) {
+        for (auto ndx : _index->latest) {
+            if (_idFilter.isEmpty() || std::binary_search(_idFilter.begin(), _idFilter.end(),
+                                           _reader.record(ndx)->id)) {
+                _rows.push_back(ndx);
+            }
+        }
+    } else {
+        // Merge record lists of requested ids (both formats and directions)
+        for (auto id : _idFilter) {
+            const quint8 ext = CanFrameRecord::ExtendedId;
+            const quint8 tx = CanFrameRecord::Tx;
+
+            for (auto key :
+                { canFrameKey(id, 0), canFrameKey(id, tx), canFrameKey(id, ext), canFrameKey(id, ext | tx) }) {
+                auto it = _index->rowsOfKey.find(key);
+                if (it != _index->rowsOfKey.end()) {
+                    const auto mid = _rows.size();
+                    _rows.insert(_rows.end(), it->second.begin(), it->second.end());
+                    std::inplace_merge(_rows.begin(), _rows.begin() + mid, _rows.end());
+                }
+            }
+        }
+    }
+
+    _rowCount = static_cast<int>(_rows.size());
+}
@@ -0,0 +1,143 @@
+#ifndef TRACETABLEMODEL_H
+#define TRACETABLEMODEL_H
+
+#include "frametablemodel.h"
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <atomic>
+#include <memory>
+#include <tracereader.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+*   @brief  Read-only table model browsing binary trace file (see tracefile.h)
+*
+*   Trace is memory-mapped and records are decoded only when view asks for them, so opening trace of any size is
+*   instant. Per-ID index and "newest frame of each (id, direction)" list are built in background thread. Once
+*   ready, ID filter and unique view are answered from the index instead of scanning all records. Jump to time uses
+*   block index of the trace.
+*
+*   Columns are the same as in FrameTableModel.
+*/
+class TraceTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit TraceTableModel(QObject* parent = nullptr);
+    ~TraceTableModel();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+    *   @brief  Opens trace. Trace currently open is closed first. Index is built in background.
+    *   @param  path trace file path
+    *   @return false if file is not a valid trace
+    */
+    bool open(const QString& path);
+
+    /**
+    *   @brief  Closes trace, model becomes empty
+    */
+    void close();
+
+    bool isOpen() const;
+
+    /**
+    *   @return path of trace, empty if none is open
+    */
+    QString path() const;
+
+    /**
+    *   @return true if per-ID index is ready. Filters set before are applied once it is.
+    */
+    bool isIndexReady() const;
+
+    /**
+    *   @brief  Shows only the newest frame of each (id, direction) pair
+    */
+    void setUniqueOnly(bool unique);
+    bool uniqueOnly() const;
+
+    /**
+    *   @brief  Shows only frames with given ids (both directions)
+    *   @param  ids frame ids, empty to show all frames
+    */
+    void setIdFilter(const QVector<quint32>& ids);
+
+    /**
+    *   @brief  Finds row of the first frame not older than given time
+    *   @param  seconds time since first frame of trace
+    *   @return row index, rowCount() - 1 if all frames are older, -1 if model is empty
+    */
+    int rowForTime(double seconds) const;
+
+    /**
+    *   @return trace record shown in given row
+    */
+    const CanFrameRecord& record(int row) const;
+
+    /**
+    *   @return index of record (in trace) shown in given row
+    */
+    quint64 recordIndex(int row) const;
+
+signals:
+    /**
+    *   @brief  Emitted when background indexing completes
+    */
+    void indexReady();
+
+private slots:
+    void indexBuilt();
+
+private:
+    struct Index {
+        std::unordered_map<quint32, std::vector<quint32>> rowsOfKey; // canFrameKey -> record indexes
+        std::vector<quint32> latest; // record index of newest frame of each key, ascending
+    };
+
+    class IndexWorker : public QThread {
+    public:
+        explicit IndexWorker(TraceTableModel& model)
+            : _model(model)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            _model.buildIndex();
+        }
+
+    private:
+        TraceTableModel& _model;
+    };
+
+    void buildIndex();
+    void cancelIndexing();
+    void updateRows();
+
+    TraceReader _reader;
+    double _timeScale{ 1e-6 };
+    quint64 _firstTimestamp{ 0 };
+
+    // Rows shown: all records when _filtered is false, _rows otherwise
+    bool _filtered{ false };
+    std::vector<quint32> _rows;
+    int _rowCount{ 0 };
+
+    bool _uniqueOnly{ false };
+    QVector<quint32> _idFilter;
+
+    std::unique_ptr<Index> _index;
+    std::unique_ptr<Index> _pendingIndex; // written by worker only
+    std::atomic<bool> _cancel{ false };
+    IndexWorker _worker;
+};
+
+#endif // TRACETABLEMODEL_H
@@ -1,35 +1,52 @@
 #include "uniquefiltermodel.h"
+#include "framesearch.h"
+#include "frametablemodel.h"
 
 UniqueFilterModel::UniqueFilterModel(QObject* parent)
     : QSortFilterProxyModel(parent)
 {
+    // Only changes of LatestRole affect filtering
+    setFilterRole(FrameTableModel::LatestRole);
 }
 
-void UniqueFilterModel::updateFilter(int frameID, double time, QString direction)
+bool UniqueFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex&) const
 {
-    QPair<int, QString> value(frameID, direction);
+    if (nullptr == frameModel) {
+        return true;
+    }
+
+    if (!filters.isEmpty()) {
+        const CanFrameRecord rec = frameModel->record(sourceRow);
 
-    if ((!uniques.contains(value)) || (time > uniques[value])) {
-        uniques[std::move(value)] = time;
+        if (!canFiltersAccept(filters, rec.id, rec.hasFlag(CanFrameRecord::ExtendedId))) {
+            return false;
+        }
     }
 
-    invalidateFilter();
+    return ((false == filterActive) || frameModel->isLatest(sourceRow))
+        && ((nullptr == search) || search->matches(frameModel->seq(sourceRow)));
 }
 
-bool UniqueFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+void UniqueFilterModel::setSearch(const FrameSearch* frameSearch)
 {
-    const int frameID = sourceModel()->index(sourceRow, 3, sourceParent).data().toInt();
-    const double time = sourceModel()->index(sourceRow, 1, sourceParent).data().toDouble();
-    const QString direction = sourceModel()->index(sourceRow, 5, sourceParent).data().toString();
+    search = frameSearch;
+    invalidateFilter();
+}
 
-    QPair<int, QString> value(std::move(frameID), std::move(direction));
+void UniqueFilterModel::setAcceptanceFilters(const CanFilterList& acceptanceFilters)
+{
+    filters = acceptanceFilters;
+    invalidateFilter();
+}
 
-    return ((uniques[value] == time) || (false == filterActive));
+const CanFilterList& UniqueFilterModel::acceptanceFilters() const
+{
+    return filters;
 }
 
-void UniqueFilterModel::clearFilter()
+void UniqueFilterModel::refresh()
 {
-    uniques.clear();
+    invalidateFilter();
 }
 
 void UniqueFilterModel::toggleFilter()
@@ -42,3 +59,70 @@ bool UniqueFilterModel::isFilterActive()
 {
     return filterActive;
 }
+
+void UniqueFilterModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    frameModel = qobject_cast<const FrameTableModel*>(sourceModel);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+void UniqueFilterModel::setSortPaused(bool paused)
+{
+    if (paused == sortPaused) {
+        return;
+    }
+
+    sortPaused = paused;
+    if (paused) {
+        pausedColumn = sortColumn();
+        pausedOrder = sortOrder();
+        QSortFilterProxyModel::sort(-1);
+    } else {
+        sort(pausedColumn, pausedOrder);
+    }
+}
+
+bool UniqueFilterModel::isSortPaused() const
+{
+    return sortPaused;
+}
+
+void UniqueFilterModel::sort(int column, Qt::SortOrder order)
+{
+    if (sortPaused) {
+        pausedColumn = column;
+        pausedOrder = order;
+        return;
+    }
+
+    if (frameModel && (order == Qt::AscendingOrder)
+        && ((column == FrameTableModel::RowId) || (column == FrameTableModel::TimeDouble))) {
+        // Column -1 restores order of source model
+        column = -1;
+    }
+
+    QSortFilterProxyModel::sort(column, order);
+}
+
+bool UniqueFilterModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    if (frameModel) {
+        const int l = left.row();
+        const int r = right.row();
+
+        switch (left.column()) {
+        case FrameTableModel::RowId:
+            return frameModel->seq(l) < frameModel->seq(r);
+        case FrameTableModel::TimeDouble:
+        case FrameTableModel::Time:
+            return frameModel->time(l) < frameModel->time(r);
+        case FrameTableModel::IdInt:
+        case FrameTableModel::Id:
+            return frameModel->frameId(l) < frameModel->frameId(r);
+        default:
+            break;
+        }
+    }
+
+    return QSortFilterProxyModel::lessThan(left, right);
+}
@@ -2,10 +2,19 @@
 #define UNIQUEFILTERMODEL_H
 
 #include <QSortFilterProxyModel>
+#include <canfilter.h>
+
+class FrameSearch;
+class FrameTableModel;
 
 /**
 *   @brief This class provides a filter model between source model and table view, which passes through only frames with
 *          newest unique ID and direction values
+*
+*   Source model is expected to be FrameTableModel, which tracks newest frame of each (id, direction) pair and
+*   reports superseded rows with dataChanged(LatestRole). Filtering is therefore updated only for affected rows.
+*   Rows can be further restricted to results of FrameSearch, which reports its matches the same way, and to
+*   acceptance filters of view projecting capture shared with other views.
 */
 class UniqueFilterModel : public QSortFilterProxyModel {
     Q_OBJECT
@@ -13,34 +22,65 @@ public:
     explicit UniqueFilterModel(QObject* parent = 0);
 
     /**
-    *   @brief  Updates filter with unique values, on reception of each frame
-    *   @param  frameID current frame ID
-    *   @param  time elapsed time since simulation start
-    *   @param  direction TX or RX
+    *   @brief  Indicates whether filter is currently active
+    *   @return true if active, false if inactive
     */
-    void updateFilter(int frameID, double time, QString direction);
+    bool isFilterActive();
 
     /**
-    *   @brief  Clears unique values stored in filter
+    *   @brief  Caches source model as FrameTableModel to allow typed access to its columns
+    *   @param  sourceModel source model
     */
-    void clearFilter();
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
 
     /**
-    *   @brief  Indicates whether filter is currently active
-    *   @return true if active, false if inactive
+    *   @brief  Sorts model. Ascending sort by rowID or time matches order of source model, so sorting is disabled
+    *           in that case and frames appended to source model are appended to proxy without any comparison.
+    *   @param  column column to be sorted by
+    *   @param  order sort order
     */
-    bool isFilterActive();
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /**
+    *   @brief  Restricts rows to matches of search, while search is active
+    *   @param  search search over source model, nullptr to show all rows
+    */
+    void setSearch(const FrameSearch* search);
+
+    /**
+    *   @brief  Restricts rows to frames accepted by filters
+    *   @param  filters acceptance filters, empty to show all rows
+    */
+    void setAcceptanceFilters(const CanFilterList& filters);
+
+    const CanFilterList& acceptanceFilters() const;
+
+    /**
+    *   @brief  Keeps rows in order of source model while main thread is overloaded. Sort requested meanwhile is
+    *           remembered and applied on resume. Filtering is not affected.
+    *   @param  paused true to pause sorting
+    */
+    void setSortPaused(bool paused);
+
+    bool isSortPaused() const;
 
 protected:
     /**
-    *   @brief  Function iterates whole data model row by row and indicates, if currently processed row should be
-    *           displayed in table view or not
+    *   @brief  Indicates, if currently processed row should be displayed in table view or not
     *   @param  source_row currently processed model row index
     *   @param  source_parent QModelIndex pointing at source data model
     *   @return true if row is accepted by filter, false if not
     */
     bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
 
+    /**
+    *   @brief  Compares rows using raw values of FrameTableModel instead of QVariants
+    *   @param  left left index
+    *   @param  right right index
+    *   @return true if left is less than right
+    */
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
 signals:
 
 public slots:
@@ -49,8 +89,18 @@ public slots:
     */
     void toggleFilter();
 
+    /**
+    *   @brief  Re-evaluates all rows, called when search is started or stopped
+    */
+    void refresh();
+
 private:
-    QMap<QPair<int, QString>, double> uniques;
     bool filterActive = false;
+    const FrameTableModel* frameModel = nullptr;
+    const FrameSearch* search = nullptr;
+    CanFilterList filters;
+    bool sortPaused = false;
+    int pausedColumn = -1; // sort applied when sorting is resumed
+    Qt::SortOrder pausedOrder = Qt::AscendingOrder;
 };
 #endif
@@ -0,0 +1,800 @@
+#include "flowplan.h"
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <busstatistics.h>
+#include <candevice.h>
+#include <canrawsender.h>
+#include <canrawview.h>
+#include <framefilter.h>
+#include <gateway.h>
+#include <isotp.h>
+#include <log.h>
+#include <merge.h>
+#include <networkbridge.h>
+#include <signaldecoder.h>
+#include <signalplot.h>
+#include <tracelogger.h>
+#include <tracereplay.h>
+#include <trigger.h>
+#include <udsflasher.h>
+
+namespace {
+// Same conversion as done by CanDeviceModel for its output port
+void toDeviceOutput(const QVector<QCanBusFrame>& frames, Direction dir, bool status, CanFrameBatch& batch)
+{
+    toCanFrameBatch(frames, dir, batch);
+
+    if (!status) {
+        for (auto& rec : batch) {
+            rec.flags |= CanFrameRecord::TxFailed;
+        }
+    }
+}
+
+// Connects producer of frame batches to any component consuming frames of CAN device
+template <typename Producer>
+QMetaObject::Connection connectFrames(Producer* producer, void (Producer::*signal)(const CanFrameBatch&),
+    ComponentInterface& in, int inPort, const std::shared_ptr<NodeCounters>& counters)
+{
+    auto forward = [producer, signal, &counters](auto* consumer) {
+        return QObject::connect(producer, signal, consumer, [consumer, counters](const CanFrameBatch& frames) {
+            counters->measure(frames.size(), [consumer, &frames] { consumer->frameBatchReceived(frames); });
+        });
+    };
+
+    if (auto view = dynamic_cast<CanRawView*>(&in)) {
+        return forward(view);
+    } else if (auto logger = dynamic_cast<TraceLogger*>(&in)) {
+        return forward(logger);
+    } else if (auto decoder = dynamic_cast<SignalDecoder*>(&in)) {
+        return forward(decoder);
+    } else if (auto statistics = dynamic_cast<BusStatistics*>(&in)) {
+        return forward(statistics);
+    } else if (auto trigger = dynamic_cast<Trigger*>(&in)) {
+        return forward(trigger);
+    } else if (auto isoTp = dynamic_cast<IsoTp*>(&in)) {
+        return forward(isoTp);
+    } else if (auto bridge = dynamic_cast<NetworkBridge*>(&in)) {
+        return forward(bridge);
+    } else if (auto filter = dynamic_cast<FrameFilter*>(&in)) {
+        return forward(filter);
+    } else if (auto merge = dynamic_cast<Merge*>(&in)) {
+        return QObject::connect(producer, signal, merge, [merge, inPort, counters](const CanFrameBatch& frames) {
+            counters->measure(frames.size(), [merge, inPort, &frames] { merge->channelReceived(inPort, frames); });
+        });
+    }
+
+    return {};
+}
+} // namespace
+
+constexpr int FlowPlan::kMainThread;
+constexpr int FlowPlan::kAnyWorker;
+
+FlowPlan::FlowPlan()
+    : _workerCount(std::max(1, QThread::idealThreadCount() - 1))
+{
+}
+
+FlowPlan::~FlowPlan()
+{
+    clear();
+}
+
+bool FlowPlan::addEdge(
+    ComponentInterface& out, ComponentInterface& in, const EdgePolicy& policy, int inPort, int outPort)
+{
+    if (hasEdge(out, in)) {
+        return true;
+    }
+
+    // Routing runs in the thread reading source device, frames pass neither dispatcher nor main thread
+    if (auto gateway = dynamic_cast<Gateway*>(&in)) {
+        auto device = dynamic_cast<CanDevice*>(&out);
+
+        if (!device) {
+            return false;
+        }
+
+        // Another source replaces this one, so edge is undone only if gateway still routes this device
+        auto detach = [gateway, device] {
+            if (gateway->source() == device) {
+                gateway->setSource(nullptr);
+            }
+        };
+
+        gateway->setSource(device);
+        _edges.push_back({ &out, &in, {}, detach });
+
+        return true;
+    } else if (auto gateway = dynamic_cast<Gateway*>(&out)) {
+        auto device = dynamic_cast<CanDevice*>(&in);
+
+        if (!device || (outPort < 0) || (outPort >= Gateway::kMaxChannels)) {
+            return false;
+        }
+
+        auto detach = [gateway, device, outPort] {
+            if (gateway->target(outPort) == device) {
+                gateway->setTarget(outPort, nullptr);
+            }
+        };
+
+        gateway->setTarget(outPort, device);
+        _edges.push_back({ &out, &in, {}, detach });
+
+        return true;
+    }
+
+    // Types are resolved here once, dispatch below is done with direct calls only
+    if (auto device = dynamic_cast<CanDevice*>(&out)) {
+        return addDeviceEdge(*device, in, policy, inPort);
+    }
+
+    QMetaObject::Connection connection;
+    std::function<void()> detach;
+
+    if (auto decoder = dynamic_cast<SignalDecoder*>(&out)) {
+        if (auto plot = dynamic_cast<SignalPlot*>(&in)) {
+            connection = QObject::connect(decoder, &SignalDecoder::signalsDecoded, plot,
+                [decoder, plot](const SignalSampleBatch& samples) {
+                    plot->signalsReceived(samples, decoder->signalCatalog());
+                });
+        } else if (auto trigger = dynamic_cast<Trigger*>(&in)) {
+            connection = QObject::connect(decoder, &SignalDecoder::signalsDecoded, trigger,
+                [decoder, trigger](const SignalSampleBatch& samples) {
+                    trigger->signalsReceived(samples, decoder->signalCatalog());
+                });
+        }
+    } else if (auto trigger = dynamic_cast<Trigger*>(&out)) {
+        if (auto logger = dynamic_cast<TraceLogger*>(&in)) {
+            auto counters = nodeCounters(in);
+
+            connection = QObject::connect(
+                trigger, &Trigger::framesCaptured, logger, [logger, counters](const CanFrameBatch& frames) {
+                    counters->measure(frames.size(), [logger, &frames] { logger->frameBatchReceived(frames); });
+                });
+            countOutput(connection, *trigger, &Trigger::framesCaptured);
+        }
+    } else if (auto bridge = dynamic_cast<NetworkBridge*>(&out)) {
+        // Remote frames are consumed the same way as frames of local device
+        connection = connectFrames(bridge, &NetworkBridge::framesReceived, in, inPort, nodeCounters(in));
+        countOutput(connection, *bridge, &NetworkBridge::framesReceived);
+    } else if (auto merge = dynamic_cast<Merge*>(&out)) {
+        connection = connectFrames(merge, &Merge::framesMerged, in, inPort, nodeCounters(in));
+        countOutput(connection, *merge, &Merge::framesMerged);
+    } else if (auto filter = dynamic_cast<FrameFilter*>(&out)) {
+        connection = connectFrames(filter, &FrameFilter::framesFiltered, in, inPort, nodeCounters(in));
+        countOutput(connection, *filter, &FrameFilter::framesFiltered);
+    } else if (auto isoTp = dynamic_cast<IsoTp*>(&out)) {
+        if (auto device = dynamic_cast<CanDevice*>(&in)) {
+            connection = QObject::connect(isoTp, &IsoTp::sendFrames, device, &CanDevice::sendFrames);
+        } else if (auto peer = dynamic_cast<IsoTp*>(&in)) {
+            // PDU is forwarded synchronously, so peer copies it before reassembly buffer is reused
+            connection = QObject::connect(isoTp, &IsoTp::pduReceived, peer, &IsoTp::sendPdu, Qt::DirectConnection);
+        } else if (auto flasher = dynamic_cast<UdsFlasher*>(&in)) {
+            connection = QObject::connect(
+                isoTp, &IsoTp::pduReceived, flasher, &UdsFlasher::pduReceived, Qt::DirectConnection);
+        }
+    } else if (auto flasher = dynamic_cast<UdsFlasher*>(&out)) {
+        if (auto isoTp = dynamic_cast<IsoTp*>(&in)) {
+            // Request buffer is reused for the next block as soon as IsoTp copied it
+            connection
+                = QObject::connect(flasher, &UdsFlasher::sendPdu, isoTp, &IsoTp::sendPdu, Qt::DirectConnection);
+        }
+    } else if (auto device = dynamic_cast<CanDevice*>(&in)) {
+        if (auto sender = dynamic_cast<CanRawSender*>(&out)) {
+            connection = QObject::connect(sender, &CanRawSender::sendFrame, device, &CanDevice::sendFrame);
+
+            // Flood batches take the batched transmit path and are paced by confirmations of the device
+            const auto batch = QObject::connect(sender, &CanRawSender::sendFrames, device, &CanDevice::sendFrames);
+            const auto confirm
+                = QObject::connect(device, &CanDevice::frameBatchSent, sender, &CanRawSender::framesSent);
+            detach = [connection, batch, confirm] {
+                QObject::disconnect(connection);
+                QObject::disconnect(batch);
+                QObject::disconnect(confirm);
+            };
+        } else if (auto replay = dynamic_cast<TraceReplay*>(&out)) {
+            connection = QObject::connect(
+                replay, &TraceReplay::sendFrames, device, [device](const CanFrameBatch& records) {
+                    QVector<QCanBusFrame> frames;
+
+                    frames.reserve(records.size());
+                    for (const auto& rec : records) {
+                        frames.append(toQCanBusFrame(rec));
+                    }
+
+                    device->sendFrames(frames);
+                });
+        }
+    }
+
+    if (!connection) {
+        return false;
+    }
+
+    _edges.push_back({ &out, &in, connection, detach });
+    shareCaptures();
+    shareDirectories();
+
+    return true;
+}
+
+void FlowPlan::removeEdge(ComponentInterface& out, ComponentInterface& in)
+{
+    auto it = std::find_if(
+        _edges.begin(), _edges.end(), [&out, &in](const Edge& edge) { return (edge.out == &out) && (edge.in == &in); });
+
+    if (it == _edges.end()) {
+        return;
+    }
+
+    if (it->detach) {
+        it->detach();
+    } else if (it->connection) {
+        QObject::disconnect(it->connection);
+    } else {
+        removeDeviceSink(out, in);
+    }
+
+    _edges.erase(it);
+    shareCaptures();
+    shareDirectories();
+}
+
+void FlowPlan::removeComponent(ComponentInterface& component)
+{
+    _affinity.erase(&component);
+
+    std::vector<std::pair<ComponentInterface*, ComponentInterface*>> edges;
+
+    for (const auto& edge : _edges) {
+        if ((edge.out == &component) || (edge.in == &component)) {
+            edges.emplace_back(edge.out, edge.in);
+        }
+    }
+
+    for (const auto& edge : edges) {
+        removeEdge(*edge.first, *edge.second);
+    }
+
+    _assigned.erase(&component);
+    releaseNode(component);
+}
+
+void FlowPlan::clear()
+{
+    for (const auto& edge : _edges) {
+        if (edge.detach) {
+            edge.detach();
+        }
+        QObject::disconnect(edge.connection);
+    }
+    _edges.clear();
+    shareCaptures();
+    shareDirectories();
+
+    for (const auto& output : _devices) {
+        QObject::disconnect(output->received);
+        QObject::disconnect(output->sent);
+
+        for (auto& sink : output->sinks) {
+            releaseSink(*sink);
+        }
+    }
+    _devices.clear();
+
+    for (const auto& node : _nodes) {
+        QObject::disconnect(node.second.output);
+    }
+    _nodes.clear();
+
+    _affinity.clear();
+    _assigned.clear();
+}
+
+void FlowPlan::setAffinity(ComponentInterface& component, int thread)
+{
+    _affinity[&component] = thread;
+}
+
+void FlowPlan::setWorkerCount(int count)
+{
+    if (_workers.empty()) {
+        _workerCount = std::max(1, count);
+    }
+}
+
+std::size_t FlowPlan::workerCount() const
+{
+    return _workers.size();
+}
+
+void FlowPlan::flush()
+{
+    for (const auto& worker : _workers) {
+        worker->flush();
+    }
+
+    for (const auto& output : _devices) {
+        for (const auto& sink : output->sinks) {
+            if (sink->queue && !sink->worker) {
+                sink->queue->drain();
+            }
+        }
+    }
+}
+
+quint64 FlowPlan::droppedBatches() const
+{
+    quint64 dropped = _dropped;
+
+    for (const auto& output : _devices) {
+        for (const auto& sink : output->sinks) {
+            dropped += sink->queue ? sink->queue->stats().droppedBatches : 0;
+        }
+    }
+
+    return dropped;
+}
+
+std::size_t FlowPlan::mainThreadBacklog() const
+{
+    std::size_t queued = 0;
+
+    for (const auto& output : _devices) {
+        for (const auto& sink : output->sinks) {
+            queued += (sink->queue && !sink->worker) ? sink->queue->stats().queued : 0;
+        }
+    }
+
+    return queued;
+}
+
+EdgeStats FlowPlan::edgeStats(const ComponentInterface& out, const ComponentInterface& in) const
+{
+    const FrameSink* sink = findSink(out, in);
+
+    return (sink && sink->queue) ? sink->queue->stats() : EdgeStats{ 0, 0, 0 };
+}
+
+NodeStats FlowPlan::nodeStats(const ComponentInterface& component) const
+{
+    const auto node = _nodes.find(&component);
+    NodeStats stats = (node != _nodes.end()) ? node->second.counters->snapshot() : NodeStats();
+
+    for (const auto& output : _devices) {
+        for (const auto& sink : output->sinks) {
+            if ((sink->component == &component) && sink->queue) {
+                const EdgeStats edge = sink->queue->stats();
+
+                stats.queued += edge.queued;
+                stats.droppedBatches += edge.droppedBatches;
+            }
+        }
+    }
+
+    return stats;
+}
+
+std::size_t FlowPlan::edgeCount() const
+{
+    return _edges.size();
+}
+
+bool FlowPlan::hasEdge(const ComponentInterface& out, const ComponentInterface& in) const
+{
+    return std::any_of(
+        _edges.begin(), _edges.end(), [&out, &in](const Edge& edge) { return (edge.out == &out) && (edge.in == &in); });
+}
+
+bool FlowPlan::addDeviceEdge(CanDevice& device, ComponentInterface& in, const EdgePolicy& policy, int inPort)
+{
+    auto sink = std::make_unique<FrameSink>(FrameSink{ &in, {}, {}, nullptr, {}, {}, false });
+    bool workerCapable = false;
+    std::function<void()> detach;
+
+    auto bind = [&sink](auto& consumer) {
+        sink->received = [&consumer](const CanFrameBatch& frames) { consumer.frameBatchReceived(frames); };
+        sink->sent = [&consumer](bool status, const CanFrameBatch& frames) { consumer.frameBatchSent(status, frames); };
+    };
+
+    if (auto view = dynamic_cast<CanRawView*>(&in)) {
+        bind(*view);
+    } else if (auto logger = dynamic_cast<TraceLogger*>(&in)) {
+        bind(*logger);
+        workerCapable = true;
+    } else if (auto decoder = dynamic_cast<SignalDecoder*>(&in)) {
+        bind(*decoder);
+        workerCapable = true;
+    } else if (auto statistics = dynamic_cast<BusStatistics*>(&in)) {
+        // Already accounts frames in its own thread
+        bind(*statistics);
+
+        // Latency is measured by device, statistics query it on refresh
+        statistics->setTxLatencySource(&device, [&device] { return device.txLatencyStats(); });
+        detach = [this, &device, &in, statistics] {
+            statistics->setTxLatencySource(&device, {});
+            removeDeviceSink(device, in);
+        };
+    } else if (auto trigger = dynamic_cast<Trigger*>(&in)) {
+        // Captures are written by TraceLogger, which lives in main thread
+        bind(*trigger);
+    } else if (auto isoTp = dynamic_cast<IsoTp*>(&in)) {
+        // Timeouts and pacing are driven by timer and scheduler of main thread
+        bind(*isoTp);
+    } else if (auto bridge = dynamic_cast<NetworkBridge*>(&in)) {
+        // Sockets belong to main thread
+        bind(*bridge);
+    } else if (auto filter = dynamic_cast<FrameFilter*>(&in)) {
+        // Expression is pure function of frame, consumers downstream are reached through queued connections
+        bind(*filter);
+        workerCapable = true;
+    } else if (auto merge = dynamic_cast<Merge*>(&in)) {
+        // Port selects channel frames of device are tagged with
+        sink->received = [merge, inPort](const CanFrameBatch& frames) { merge->channelReceived(inPort, frames); };
+        sink->sent = [merge, inPort](bool status, const CanFrameBatch& frames) {
+            merge->channelSent(inPort, status, frames);
+        };
+    } else {
+        return false;
+    }
+
+    // Wrapped once here, so that both direct calls and queue jobs are measured
+    auto counters = nodeCounters(in);
+    sink->received = [received = std::move(sink->received), counters](const CanFrameBatch& frames) {
+        counters->measure(frames.size(), [&received, &frames] { received(frames); });
+    };
+    sink->sent = [sent = std::move(sink->sent), counters](bool status, const CanFrameBatch& frames) {
+        counters->measure(frames.size(), [&sent, status, &frames] { sent(status, frames); });
+    };
+
+    sink->worker = worker(in, workerCapable);
+    if (sink->worker || (policy.mode != EdgePolicy::Direct)) {
+        sink->queue = std::make_unique<FlowQueue>(
+            policy, [received = sink->received, sent = sink->sent](const FlowQueue::Job& job) {
+                if (job.sent) {
+                    sent(job.status, job.frames);
+                } else {
+                    received(job.frames);
+                }
+            });
+
+        if (sink->worker) {
+            sink->worker->add(*sink->queue);
+        } else {
+            sink->context = std::make_unique<QObject>();
+        }
+    }
+
+    deviceOutput(device).sinks.push_back(std::move(sink));
+    _edges.push_back({ &device, &in, {}, detach });
+    shareCaptures();
+    shareDirectories();
+
+    return true;
+}
+
+FlowPlan::DeviceOutput& FlowPlan::deviceOutput(CanDevice& device)
+{
+    for (auto& output : _devices) {
+        if (output->device == &device) {
+            return *output;
+        }
+    }
+
+    _devices.push_back(std::make_unique<DeviceOutput>());
+    DeviceOutput* output = _devices.back().get();
+
+    output->device = &device;
+    output->counters = nodeCounters(device);
+    output->directory = device.idDirectory();
+    output->received
+        = QObject::connect(&device, &CanDevice::frameBatchReceived, [output](const QVector<QCanBusFrame>& frames) {
+              withBatch(output->rx, frames, Direction::RX, true, [output](const CanFrameBatch& batch) {
+                  output->directory->update(batch);
+                  output->counters->countOut(batch.size());
+                  for (const auto& sink : output->sinks) {
+                      if (sink->queue) {
+                          deliver(*sink, { batch, false, true });
+                      } else {
+                          sink->received(batch);
+                      }
+                  }
+              });
+          });
+    output->sent = QObject::connect(
+        &device, &CanDevice::frameBatchSent, [output](bool status, const QVector<QCanBusFrame>& frames) {
+            withBatch(output->tx, frames, Direction::TX, status, [output, status](const CanFrameBatch& batch) {
+                output->directory->update(batch);
+                output->counters->countOut(batch.size());
+                for (const auto& sink : output->sinks) {
+                    if (sink->queue) {
+                        deliver(*sink, { batch, true, status });
+                    } else {
+                        sink->sent(status, batch);
+                    }
+                }
+            });
+        });
+
+    return *output;
+}
+
+void FlowPlan::shareCaptures()
+{
+    std::unordered_map<const ComponentInterface*, int> inputs;
+    std::vector<std::pair<const ComponentInterface*, std::vector<CanRawView*>>> groups;
+    std::vector<CanRawView*> sharing;
+
+    for (const auto& edge : _edges) {
+        ++inputs[edge.in];
+    }
+
+    for (const auto& edge : _edges) {
+        auto view = dynamic_cast<CanRawView*>(edge.in);
+
+        if (!view || (inputs[edge.in] != 1) || !dynamic_cast<CanDevice*>(edge.out)) {
+            continue;
+        }
+
+        auto group = std::find_if(groups.begin(), groups.end(),
+            [&edge](const std::pair<const ComponentInterface*, std::vector<CanRawView*>>& g) {
+                return g.first == edge.out;
+            });
+        if (group == groups.end()) {
+            groups.emplace_back(edge.out, std::vector<CanRawView*>());
+            group = groups.end() - 1;
+        }
+        group->second.push_back(view);
+    }
+
+    for (const auto& group : groups) {
+        if (group.second.size() > 1) {
+            sharing.insert(sharing.end(), group.second.begin(), group.second.end());
+        }
+    }
+
+    // Views are still fed by their own sinks, capture takes frames from the first view only
+    for (const auto& group : groups) {
+        const auto& views = group.second;
+
+        if (views.size() < 2) {
+            continue;
+        }
+
+        // Leader may still share capture of view now showing other device
+        CanRawView* leader = views.front();
+        for (auto other : sharing) {
+            if ((std::find(views.begin(), views.end(), other) == views.end()) && leader->sharesCapture(*other)) {
+                leader->shareCapture(nullptr);
+                break;
+            }
+        }
+
+        for (std::size_t i = 1; i < views.size(); ++i) {
+            views[i]->shareCapture(leader);
+        }
+    }
+
+    // Leaving views get their own capture, the others keep the shared one
+    for (auto view : _sharingViews) {
+        if (std::find(sharing.begin(), sharing.end(), view) == sharing.end()) {
+            view->shareCapture(nullptr);
+        }
+    }
+
+    _sharingViews = std::move(sharing);
+}
+
+void FlowPlan::shareDirectories()
+{
+    std::unordered_map<const ComponentInterface*, int> inputs;
+    std::unordered_map<ComponentInterface*, FrameIdDirectoryPtr> directories;
+
+    for (const auto& edge : _edges) {
+        ++inputs[edge.in];
+    }
+
+    for (const auto& edge : _edges) {
+        auto device = dynamic_cast<CanDevice*>(edge.out);
+
+        if (device && (inputs[edge.in] == 1)) {
+            directories.emplace(edge.in, device->idDirectory());
+        }
+    }
+
+    for (const auto& entry : _directories) {
+        if (directories.find(entry.first) == directories.end()) {
+            entry.first->setIdDirectory(nullptr);
+        }
+    }
+
+    for (const auto& entry : directories) {
+        auto it = _directories.find(entry.first);
+
+        if ((it == _directories.end()) || (it->second != entry.second)) {
+            entry.first->setIdDirectory(entry.second);
+        }
+    }
+
+    _directories = std::move(directories);
+}
+
+void FlowPlan::removeDeviceSink(const ComponentInterface& device, const ComponentInterface& in)
+{
+    auto it = std::find_if(_devices.begin(), _devices.end(),
+        [&device](const std::unique_ptr<DeviceOutput>& output) { return output->device == &device; });
+
+    if (it == _devices.end()) {
+        return;
+    }
+
+    auto& sinks = (*it)->sinks;
+    auto sink = std::find_if(sinks.begin(), sinks.end(),
+        [&in](const std::unique_ptr<FrameSink>& s) { return s->component == &in; });
+
+    if (sink != sinks.end()) {
+        releaseSink(**sink);
+        sinks.erase(sink);
+    }
+
+    if (sinks.empty()) {
+        QObject::disconnect((*it)->received);
+        QObject::disconnect((*it)->sent);
+        _devices.erase(it);
+    }
+}
+
+template <typename F>
+void FlowPlan::withBatch(
+    ReusableBatch& reusable, const QVector<QCanBusFrame>& frames, Direction dir, bool status, F&& dispatch)
+{
+    // Consumer may make device emit again while batch is being dispatched, nested call gets its own batch
+    const bool nested = reusable.busy;
+    CanFrameBatch local;
+    CanFrameBatch& batch = nested ? local : reusable.batch;
+
+    reusable.busy = true;
+    // Single conversion shared by all consumers. Consumers keeping the batch share it, next conversion then
+    // detaches instead of overwriting it.
+    toDeviceOutput(frames, dir, status, batch);
+    dispatch(static_cast<const CanFrameBatch&>(batch));
+    reusable.busy = nested;
+}
+
+template <typename Producer>
+void FlowPlan::countOutput(
+    const QMetaObject::Connection& connection, Producer& producer, void (Producer::*signal)(const CanFrameBatch&))
+{
+    if (!connection) {
+        return;
+    }
+
+    auto counters = nodeCounters(producer);
+    auto& node = _nodes[&producer];
+
+    // Single counting connection per producer, frames reaching several consumers are counted once
+    if (!node.output) {
+        node.output = QObject::connect(&producer, signal,
+            [counters](const CanFrameBatch& frames) { counters->countOut(frames.size()); });
+    }
+}
+
+std::shared_ptr<NodeCounters> FlowPlan::nodeCounters(const ComponentInterface& component)
+{
+    auto& node = _nodes[&component];
+
+    if (!node.counters) {
+        node.counters = std::make_shared<NodeCounters>();
+    }
+
+    return node.counters;
+}
+
+void FlowPlan::releaseNode(const ComponentInterface& component)
+{
+    const auto node = _nodes.find(&component);
+
+    if (node != _nodes.end()) {
+        QObject::disconnect(node->second.output);
+        _nodes.erase(node);
+    }
+}
+
+void FlowPlan::deliver(FrameSink& sink, FlowQueue::Job&& job)
+{
+    if (sink.worker) {
+        sink.worker->post(*sink.queue, std::move(job));
+        return;
+    }
+
+    FlowQueue::Offer offer;
+
+    // Consumer runs in this thread, block policy makes producer wait until it processed queued batches
+    while ((offer = sink.queue->offer(std::move(job))) == FlowQueue::Offer::Full) {
+        sink.queue->drain();
+    }
+
+    if ((offer == FlowQueue::Offer::Queued) && !sink.drainScheduled) {
+        FrameSink* target = &sink;
+
+        sink.drainScheduled = true;
+        // Context is destroyed with sink, pending drain is canceled then
+        QTimer::singleShot(0, sink.context.get(), [target] {
+            target->drainScheduled = false;
+            target->queue->drain();
+        });
+    }
+}
+
+const FlowPlan::FrameSink* FlowPlan::findSink(const ComponentInterface& device, const ComponentInterface& in) const
+{
+    for (const auto& output : _devices) {
+        if (output->device != &device) {
+            continue;
+        }
+
+        for (const auto& sink : output->sinks) {
+            if (sink->component == &in) {
+                return sink.get();
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void FlowPlan::releaseSink(FrameSink& sink)
+{
+    if (sink.worker) {
+        // Waits for worker if it is just draining the queue
+        sink.worker->remove(*sink.queue);
+        sink.worker = nullptr;
+    }
+
+    if (sink.queue) {
+        _dropped += sink.queue->stats().droppedBatches;
+    }
+}
+
+FlowWorker* FlowPlan::worker(const ComponentInterface& component, bool workerCapable)
+{
+    const auto assigned = _assigned.find(&component);
+    if (assigned != _assigned.end()) {
+        return assigned->second;
+    }
+
+    const auto affinity = _affinity.find(&component);
+    const int thread = (affinity != _affinity.end()) ? affinity->second : kMainThread;
+
+    if (thread == kMainThread) {
+        return nullptr;
+    }
+
+    if (!workerCapable) {
+        cds_warn("Component cannot run on worker thread, it stays in main thread");
+        _assigned[&component] = nullptr;
+        return nullptr;
+    }
+
+    while (static_cast<int>(_workers.size()) < _workerCount) {
+        _workers.push_back(std::make_unique<FlowWorker>(static_cast<int>(_workers.size()) + 1));
+    }
+
+    FlowWorker* selected;
+    if (thread == kAnyWorker) {
+        selected = std::min_element(_workers.begin(), _workers.end(),
+            [](const std::unique_ptr<FlowWorker>& a, const std::unique_ptr<FlowWorker>& b) {
+                return a->load() < b->load();
+            })->get();
+    } else {
+        selected = _workers[(thread - 1) % _workers.size()].get();
+    }
+
+    _assigned[&component] = selected;
+
+    return selected;
+}
@@ -0,0 +1,216 @@
+#ifndef FLOWPLAN_H
+#define FLOWPLAN_H
+
+#include "flowworker.h"
+#include "nodestats.h"
+#include <QtCore/QObject>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <frameiddirectory.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class CanDevice;
+class CanRawView;
+
+/**
+*   @brief  Execution plan of project graph
+*
+*   Edges are resolved to typed calls once, when plan is built. Every producer signal is connected to single
+*   dispatcher, which converts frames (if needed) once and calls consumers directly. While simulation runs frames
+*   therefore do not pass node data models: no NodeData allocation, no dynamic casts and no per-consumer copies
+*   happen per batch. Node graph is only used to build the plan.
+*
+*   Edges from CAN devices carry EdgePolicy. Unless policy is direct, batches pass bounded FlowQueue, consumers in
+*   main thread drain it from event loop, so a slow consumer loses its own batches (or, with block policy, holds
+*   back its producer) instead of delaying every other consumer of the device.
+*
+*   Consumers of CAN devices may be executed by pool of worker threads (see setAffinity). Device dispatcher then
+*   only posts batch to bounded lock-free queue of the edge and consumer runs in its worker. Consumer stays on the
+*   same worker for all its edges, so it is never called concurrently and batches keep their order. Signals emitted
+*   by consumer on worker reach GUI-facing nodes through queued connections, i.e. in main thread.
+*
+*   Gateway is not a consumer of dispatcher. It is attached to its devices directly and routes frames in the thread
+*   reading the source device.
+*
+*   Every node reached by frames counts frames it received and emitted and time spent processing them (see
+*   nodeStats). Counters are updated once per batch and cost two clock reads and a few relaxed increments.
+*
+*   CanRawViews fed by the same device only share capture of the first of them (see CanRawView::shareCapture), so
+*   frames are stored once. View with any other input keeps its own capture.
+*
+*   Dispatcher of device updates directory of IDs of the device (see FrameIdDirectory) with every batch before
+*   passing it on. Consumers fed by single device only get the directory (see ComponentInterface::setIdDirectory),
+*   so that they index per-ID data by its handles.
+*
+*   Components have to outlive their edges, remove them (removeComponent) before components are destroyed.
+*/
+class FlowPlan {
+public:
+    // Affinity values, numbers greater than kAnyWorker select worker explicitly (modulo worker count)
+    static constexpr int kMainThread = -1;
+    static constexpr int kAnyWorker = 0;
+
+    FlowPlan();
+    ~FlowPlan();
+
+    FlowPlan(const FlowPlan&) = delete;
+    FlowPlan& operator=(const FlowPlan&) = delete;
+
+    /**
+    *   @brief  Resolves edge between output of one component and input of another
+    *   @param  out producing component
+    *   @param  in consuming component
+    *   @param  policy flow control of edge, used by edges carrying CAN frames only
+    *   @param  inPort input port of consumer, selects channel of Merge
+    *   @param  outPort output port of producer, selects channel of Gateway
+    *   @return false if components cannot be connected, plan is not changed then
+    */
+    bool addEdge(ComponentInterface& out, ComponentInterface& in, const EdgePolicy& policy = EdgePolicy(),
+        int inPort = 0, int outPort = 0);
+
+    /**
+    *   @brief  Removes edge added with addEdge. Nothing happens if there is no such edge.
+    */
+    void removeEdge(ComponentInterface& out, ComponentInterface& in);
+
+    /**
+    *   @brief  Removes all edges of component
+    */
+    void removeComponent(ComponentInterface& component);
+
+    /**
+    *   @brief  Removes all edges and affinities
+    */
+    void clear();
+
+    /**
+    *   @brief  Selects thread consumer is executed in. Applies to edges added afterwards. Only consumers that do
+    *           not touch widgets while processing frames (trace logger, signal decoder) can run on worker, others
+    *           stay in main thread.
+    *   @param  component consuming component
+    *   @param  thread kMainThread, kAnyWorker (least loaded worker) or worker number starting from 1
+    */
+    void setAffinity(ComponentInterface& component, int thread);
+
+    /**
+    *   @brief  Sets number of workers. Takes effect if no worker was started yet.
+    *   @param  count number of workers, defaults to number of cores minus one (main thread), at least 1
+    */
+    void setWorkerCount(int count);
+
+    /**
+    *   @return number of started workers
+    */
+    std::size_t workerCount() const;
+
+    /**
+    *   @brief  Blocks until all batches posted so far were processed. Called from main thread.
+    */
+    void flush();
+
+    /**
+    *   @return number of batches dropped so far by policies of all edges
+    */
+    quint64 droppedBatches() const;
+
+    /**
+    *   @return batches waiting in queues of consumers executed in main thread, see LoadGovernor
+    */
+    std::size_t mainThreadBacklog() const;
+
+    /**
+    *   @return flow control counters of edge, zeros for edges without queue
+    */
+    EdgeStats edgeStats(const ComponentInterface& out, const ComponentInterface& in) const;
+
+    /**
+    *   @return frame path counters of component since plan was built, zeros for component without frame edges
+    */
+    NodeStats nodeStats(const ComponentInterface& component) const;
+
+    std::size_t edgeCount() const;
+
+    /**
+    *   @return true if plan has edge from out to in
+    */
+    bool hasEdge(const ComponentInterface& out, const ComponentInterface& in) const;
+
+private:
+    // Frame consumer resolved to direct calls of its slots
+    struct FrameSink {
+        ComponentInterface* component;
+        std::function<void(const CanFrameBatch&)> received;
+        std::function<void(bool, const CanFrameBatch&)> sent;
+        FlowWorker* worker; // nullptr if sink is called in main thread
+        std::unique_ptr<FlowQueue> queue; // nullptr if sink is called directly
+        std::unique_ptr<QObject> context; // drain of main thread queue is scheduled with it
+        bool drainScheduled;
+    };
+
+    // Counters are shared with the calls of the plan, so that call already queued to component removed from plan
+    // does not touch released counters
+    struct Node {
+        std::shared_ptr<NodeCounters> counters;
+        QMetaObject::Connection output; // counts frames emitted by producer
+    };
+
+    // Batch converted into by every dispatch, so that steady state dispatch does not allocate
+    struct ReusableBatch {
+        CanFrameBatch batch;
+        bool busy{ false };
+    };
+
+    // Frames of device are converted once and passed to all sinks
+    struct DeviceOutput {
+        CanDevice* device;
+        std::shared_ptr<NodeCounters> counters;
+        FrameIdDirectoryPtr directory;
+        std::vector<std::unique_ptr<FrameSink>> sinks;
+        ReusableBatch rx;
+        ReusableBatch tx;
+        QMetaObject::Connection received;
+        QMetaObject::Connection sent;
+    };
+
+    struct Edge {
+        ComponentInterface* out;
+        ComponentInterface* in;
+        QMetaObject::Connection connection; // not used by device edges, they are served by DeviceOutput
+        // Undoes edges not made of single connection (Gateway, CanRawSender, device to BusStatistics)
+        std::function<void()> detach;
+    };
+
+    bool addDeviceEdge(CanDevice& device, ComponentInterface& in, const EdgePolicy& policy, int inPort);
+    template <typename F>
+    static void withBatch(
+        ReusableBatch& reusable, const QVector<QCanBusFrame>& frames, Direction dir, bool status, F&& dispatch);
+    template <typename Producer>
+    void countOutput(const QMetaObject::Connection& connection, Producer& producer,
+        void (Producer::*signal)(const CanFrameBatch&));
+    std::shared_ptr<NodeCounters> nodeCounters(const ComponentInterface& component);
+    void releaseNode(const ComponentInterface& component);
+    static void deliver(FrameSink& sink, FlowQueue::Job&& job);
+    const FrameSink* findSink(const ComponentInterface& device, const ComponentInterface& in) const;
+    DeviceOutput& deviceOutput(CanDevice& device);
+    void removeDeviceSink(const ComponentInterface& device, const ComponentInterface& in);
+    void releaseSink(FrameSink& sink);
+    FlowWorker* worker(const ComponentInterface& component, bool workerCapable);
+    void shareCaptures();
+    void shareDirectories();
+
+    std::vector<Edge> _edges;
+    std::vector<std::unique_ptr<DeviceOutput>> _devices;
+    std::unordered_map<const ComponentInterface*, Node> _nodes;
+    std::unordered_map<const ComponentInterface*, int> _affinity;
+    std::unordered_map<const ComponentInterface*, FlowWorker*> _assigned;
+    std::vector<std::unique_ptr<FlowWorker>> _workers;
+    std::vector<CanRawView*> _sharingViews; // views made to share capture by plan
+    std::unordered_map<ComponentInterface*, FrameIdDirectoryPtr> _directories; // passed to consumers by plan
+    int _workerCount;
+    quint64 _dropped{ 0 }; // batches dropped by queues already released
+};
+
+#endif // FLOWPLAN_H
@@ -0,0 +1,138 @@
+#include "flowqueue.h"
+#include <algorithm>
+#include <log.h>
+
+namespace {
+const char* const kModeNames[] = { "direct", "block", "dropOldest", "dropNewest", "decimate" };
+} // namespace
+
+constexpr int EdgePolicy::kDefaultCapacity;
+constexpr int EdgePolicy::kDefaultDecimation;
+
+EdgePolicy EdgePolicy::fromJson(const QJsonObject& json)
+{
+    EdgePolicy policy;
+
+    if (json.contains("policy")) {
+        const QString name = json["policy"].toString();
+        const auto mode = std::find(std::begin(kModeNames), std::end(kModeNames), name);
+
+        if (mode != std::end(kModeNames)) {
+            policy.mode = static_cast<Mode>(mode - std::begin(kModeNames));
+        } else {
+            cds_warn("Unknown edge policy '{}'", name.toStdString());
+        }
+    }
+
+    if (json.contains("capacity")) {
+        const int capacity = json["capacity"].toInt();
+
+        if (capacity > 0) {
+            policy.capacity = capacity;
+        } else {
+            cds_warn("Invalid edge queue capacity {}", capacity);
+        }
+    }
+
+    if (json.contains("decimation")) {
+        const int decimation = json["decimation"].toInt();
+
+        if (decimation > 0) {
+            policy.decimation = decimation;
+        } else {
+            cds_warn("Invalid edge decimation {}", decimation);
+        }
+    }
+
+    return policy;
+}
+
+QJsonObject EdgePolicy::toJson() const
+{
+    QJsonObject json;
+
+    json["policy"] = kModeNames[mode];
+    json["capacity"] = capacity;
+    json["decimation"] = decimation;
+
+    return json;
+}
+
+FlowQueue::FlowQueue(const EdgePolicy& policy, std::function<void(const Job&)> handler)
+    : _policy(policy)
+    , _limit(static_cast<std::size_t>(policy.capacity))
+    , _jobs((policy.mode == EdgePolicy::DropOldest) ? 2 * _limit : _limit)
+    , _handler(std::move(handler))
+{
+}
+
+FlowQueue::Offer FlowQueue::offer(Job&& job)
+{
+    const std::size_t queued = _jobs.size();
+
+    ++_offered;
+
+    switch (_policy.mode) {
+    case EdgePolicy::Block:
+        if (queued >= _limit) {
+            return Offer::Full;
+        }
+        break;
+
+    case EdgePolicy::DropOldest:
+        // Excess is trimmed by consumer, push below fails only if consumer did not run at all meanwhile
+        break;
+
+    case EdgePolicy::Decimate:
+        if ((queued >= _limit / 2) && ((_offered % _policy.decimation) != 0)) {
+            drop(job);
+            return Offer::Dropped;
+        }
+        break;
+
+    case EdgePolicy::Direct:
+    case EdgePolicy::DropNewest:
+        break;
+    }
+
+    if ((queued >= _jobs.capacity()) || ((_policy.mode != EdgePolicy::DropOldest) && (queued >= _limit))
+        || !_jobs.push(std::move(job))) {
+        drop(job);
+        return Offer::Dropped;
+    }
+
+    return Offer::Queued;
+}
+
+std::size_t FlowQueue::drain()
+{
+    if (_policy.mode == EdgePolicy::DropOldest) {
+        Job job;
+
+        while ((_jobs.size() > _limit) && _jobs.pop(job)) {
+            drop(job);
+        }
+    }
+
+    return _jobs.consumeAll([this](Job&& job) {
+        // Taken out of the slot, so that batch is not kept alive by the queue
+        const Job current = std::move(job);
+        _handler(current);
+    });
+}
+
+EdgeStats FlowQueue::stats() const
+{
+    return { _droppedBatches.load(), _droppedFrames.load(), _jobs.size() };
+}
+
+const EdgePolicy& FlowQueue::policy() const
+{
+    return _policy;
+}
+
+void FlowQueue::drop(const Job& job)
+{
+    _droppedBatches.fetch_add(1, std::memory_order_relaxed);
+    _droppedFrames.fetch_add(static_cast<quint64>(job.frames.size()), std::memory_order_relaxed);
+}
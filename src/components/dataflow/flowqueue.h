@@ -0,0 +1,100 @@
+#ifndef FLOWQUEUE_H
+#define FLOWQUEUE_H
+
+#include <QtCore/QJsonObject>
+#include <atomic>
+#include <canframerecord.h>
+#include <functional>
+#include <ringbuffer.h>
+
+/**
+*   @brief  Flow control of graph edge
+*
+*   JSON keys: policy ("direct", "block", "dropOldest", "dropNewest", "decimate"), capacity (batches queued at
+*   most), decimation (every n-th batch is kept by "decimate" once queue is half full).
+*/
+struct EdgePolicy {
+    enum Mode {
+        Direct, // consumer in main thread is called inline, consumer on worker drops newest batches
+        Block, // producer waits until consumer makes room
+        DropOldest,
+        DropNewest,
+        Decimate
+    };
+
+    static constexpr int kDefaultCapacity = 1024;
+    static constexpr int kDefaultDecimation = 4;
+
+    Mode mode{ Direct };
+    int capacity{ kDefaultCapacity };
+    int decimation{ kDefaultDecimation };
+
+    /**
+    *   @brief  Reads policy. Missing keys keep default values, invalid ones are reported and ignored.
+    */
+    static EdgePolicy fromJson(const QJsonObject& json);
+    QJsonObject toJson() const;
+};
+
+/**
+*   @brief  Per edge flow control counters
+*/
+struct EdgeStats {
+    quint64 droppedBatches;
+    quint64 droppedFrames;
+    std::size_t queued; // batches waiting for consumer
+};
+
+/**
+*   @brief  Bounded lock-free queue of frame batches between dispatcher of one producer and one consumer thread
+*
+*   Producer calls offer(), consumer calls drain(). Drop-oldest cannot remove anything from producer side of SPSC
+*   queue, so storage is twice the capacity and the consumer discards the excess before processing.
+*/
+class FlowQueue {
+public:
+    struct Job {
+        CanFrameBatch frames;
+        bool sent; // frameBatchSent if true, frameBatchReceived otherwise
+        bool status;
+    };
+
+    enum class Offer {
+        Queued,
+        Dropped,
+        Full // block policy only, queue is left untouched
+    };
+
+    FlowQueue(const EdgePolicy& policy, std::function<void(const Job&)> handler);
+
+    FlowQueue(const FlowQueue&) = delete;
+    FlowQueue& operator=(const FlowQueue&) = delete;
+
+    /**
+    *   @brief  Applies policy and queues batch. Producer side only.
+    */
+    Offer offer(Job&& job);
+
+    /**
+    *   @brief  Passes queued batches to handler. Consumer side only.
+    *   @return number of processed batches
+    */
+    std::size_t drain();
+
+    EdgeStats stats() const;
+
+    const EdgePolicy& policy() const;
+
+private:
+    void drop(const Job& job);
+
+    const EdgePolicy _policy;
+    const std::size_t _limit;
+    SpscRingBuffer<Job> _jobs;
+    std::function<void(const Job&)> _handler;
+    quint64 _offered{ 0 }; // producer only
+    std::atomic<quint64> _droppedBatches{ 0 };
+    std::atomic<quint64> _droppedFrames{ 0 };
+};
+
+#endif // FLOWQUEUE_H
@@ -0,0 +1,113 @@
+#include "flowworker.h"
+#include <algorithm>
+
+FlowWorker::FlowWorker(int index)
+{
+    setObjectName(QString("FlowWorker%1").arg(index));
+    start();
+}
+
+FlowWorker::~FlowWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _quit = true;
+    }
+    _wakeup.notify_one();
+    wait();
+}
+
+void FlowWorker::add(FlowQueue& queue)
+{
+    std::lock_guard<std::mutex> lock(_queueMutex);
+
+    _queues.push_back(&queue);
+}
+
+void FlowWorker::remove(FlowQueue& queue)
+{
+    std::lock_guard<std::mutex> lock(_queueMutex);
+
+    _queues.erase(std::remove(_queues.begin(), _queues.end(), &queue), _queues.end());
+}
+
+bool FlowWorker::post(FlowQueue& queue, FlowQueue::Job&& job)
+{
+    FlowQueue::Offer offer;
+
+    while ((offer = queue.offer(std::move(job))) == FlowQueue::Offer::Full) {
+        wake();
+        QThread::yieldCurrentThread();
+    }
+
+    if (offer == FlowQueue::Offer::Dropped) {
+        return false;
+    }
+
+    wake();
+
+    return true;
+}
+
+void FlowWorker::flush()
+{
+    std::unique_lock<std::mutex> lock(_wakeMutex);
+    const quint64 request = ++_flushRequests;
+
+    _wakeup.notify_one();
+    _flushed.wait(lock, [this, request] { return (_flushDone >= request) || _quit; });
+}
+
+std::size_t FlowWorker::load() const
+{
+    std::lock_guard<std::mutex> lock(_queueMutex);
+
+    return _queues.size();
+}
+
+void FlowWorker::wake()
+{
+    // Only the first producer after worker went idle pays for notification
+    if (!_signalled.exchange(true)) {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _wakeup.notify_one();
+    }
+}
+
+void FlowWorker::run()
+{
+    for (;;) {
+        quint64 requests;
+
+        {
+            std::unique_lock<std::mutex> lock(_wakeMutex);
+
+            _wakeup.wait(
+                lock, [this] { return _quit || _signalled.load() || (_flushRequests != _flushDone); });
+            if (_quit) {
+                break;
+            }
+            requests = _flushRequests;
+        }
+
+        // Reset before draining, batch posted meanwhile sets it again and is picked up by next iteration
+        _signalled.exchange(false);
+
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+
+            for (auto queue : _queues) {
+                queue->drain();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_wakeMutex);
+            _flushDone = requests;
+        }
+        _flushed.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(_wakeMutex);
+    _flushed.notify_all();
+}
@@ -0,0 +1,61 @@
+#ifndef FLOWWORKER_H
+#define FLOWWORKER_H
+
+#include "flowqueue.h"
+#include <QtCore/QThread>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+*   @brief  Thread executing consumers assigned to it by FlowPlan
+*
+*   Each edge served by worker has its own FlowQueue written by producer thread only, so the frame path never
+*   locks. Worker sleeps while all its queues are empty. Registration of queues is cold path and is guarded by
+*   mutex, which is also held while worker drains queues, so queue removed with remove() is not used afterwards.
+*   Producers only take separate wakeup mutex, and only when worker was idle.
+*/
+class FlowWorker : public QThread {
+public:
+    explicit FlowWorker(int index);
+    ~FlowWorker();
+
+    void add(FlowQueue& queue);
+    void remove(FlowQueue& queue);
+
+    /**
+    *   @brief  Puts batch to queue and wakes worker up. Producer side of queue only. With block policy waits
+    *           until worker makes room in the queue.
+    *   @return false if batch was dropped by queue policy
+    */
+    bool post(FlowQueue& queue, FlowQueue::Job&& job);
+
+    /**
+    *   @brief  Blocks until everything posted before the call was processed
+    */
+    void flush();
+
+    /**
+    *   @return number of queues assigned to worker
+    */
+    std::size_t load() const;
+
+protected:
+    void run() override;
+
+private:
+    void wake();
+
+    mutable std::mutex _queueMutex;
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeup;
+    std::condition_variable _flushed;
+    std::vector<FlowQueue*> _queues;
+    std::atomic<bool> _signalled{ false };
+    quint64 _flushRequests{ 0 };
+    quint64 _flushDone{ 0 };
+    bool _quit{ false };
+};
+
+#endif // FLOWWORKER_H
@@ -0,0 +1,117 @@
+#include "loadgovernor.h"
+#include <algorithm>
+#include <log.h>
+#include <utility>
+
+constexpr int LoadGovernor::kSampleIntervalMs;
+constexpr int LoadGovernor::kRecoveryMs;
+
+LoadGovernor::LoadGovernor(Backlog backlog, QObject* parent)
+    : QObject(parent)
+    , _backlog(std::move(backlog))
+{
+    _timer.setInterval(kSampleIntervalMs);
+    connect(&_timer, &QTimer::timeout, this, &LoadGovernor::sample);
+}
+
+void LoadGovernor::setThresholds(const Thresholds& thresholds)
+{
+    _thresholds = thresholds;
+}
+
+void LoadGovernor::start()
+{
+    _lastOverloadMs = 0;
+    _startupSample = true;
+    _uptime.start();
+    _clock.start();
+    _timer.start();
+}
+
+void LoadGovernor::stop()
+{
+    _timer.stop();
+    setLevel(LoadLevel::Normal, "simulation stopped");
+}
+
+LoadLevel LoadGovernor::level() const
+{
+    return _level;
+}
+
+void LoadGovernor::update(qint64 lagMs, std::size_t backlog, qint64 nowMs)
+{
+    const LoadLevel wanted = target(lagMs, backlog);
+    const QString reason = QString("event loop lag %1 ms, %2 batches queued").arg(lagMs).arg(backlog);
+
+    if (wanted >= _level) {
+        _lastOverloadMs = nowMs;
+        if (wanted > _level) {
+            setLevel(wanted, reason);
+        }
+        return;
+    }
+
+    if (nowMs - _lastOverloadMs >= kRecoveryMs) {
+        // Next step down needs another calm period
+        _lastOverloadMs = nowMs;
+        setLevel(static_cast<LoadLevel>(static_cast<int>(_level) - 1), reason);
+    }
+}
+
+QString LoadGovernor::name(LoadLevel level)
+{
+    switch (level) {
+    case LoadLevel::Reduced:
+        return "reduced";
+    case LoadLevel::Sampled:
+        return "sampled";
+    default:
+        return "normal";
+    }
+}
+
+void LoadGovernor::sample()
+{
+    // Timer cannot fire before its interval, anything above it was spent by other events
+    const qint64 lagMs = std::max<qint64>(_clock.restart() - kSampleIntervalMs, 0);
+
+    // The first interval includes starting of components
+    if (_startupSample) {
+        _startupSample = false;
+        return;
+    }
+
+    update(lagMs, _backlog ? _backlog() : 0, _uptime.elapsed());
+}
+
+LoadLevel LoadGovernor::target(qint64 lagMs, std::size_t backlog) const
+{
+    if ((lagMs >= _thresholds.sampledLagMs) || (backlog >= _thresholds.sampledBacklog)) {
+        return LoadLevel::Sampled;
+    }
+
+    if ((lagMs >= _thresholds.reducedLagMs) || (backlog >= _thresholds.reducedBacklog)) {
+        return LoadLevel::Reduced;
+    }
+
+    return LoadLevel::Normal;
+}
+
+void LoadGovernor::setLevel(LoadLevel level, const QString& reason)
+{
+    if (level == _level) {
+        return;
+    }
+
+    if (level > _level) {
+        cds_warn("Main thread overloaded ({}), GUI switched to {} mode", reason.toStdString(),
+            name(level).toStdString());
+    } else {
+        cds_info("Main thread load dropped ({}), GUI switched to {} mode", reason.toStdString(),
+            name(level).toStdString());
+    }
+
+    _level = level;
+    emit levelChanged(level, reason);
+}
@@ -0,0 +1,93 @@
+#ifndef LOADGOVERNOR_H
+#define LOADGOVERNOR_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <componentinterface.h>
+#include <cstddef>
+#include <functional>
+
+/**
+*   @brief  Watches load of main thread while simulation runs and lowers LoadLevel of GUI consumers when it is
+*           overloaded
+*
+*   Main thread is sampled every kSampleIntervalMs by timer of its event loop. Lag of the timer is time event loop
+*   was kept busy, e.g. by views processing frames. Backlog is number of batches waiting in queues of consumers
+*   executed in main thread (see FlowPlan::mainThreadBacklog). Level is raised as soon as a sample exceeds
+*   threshold of higher level and lowered one step at a time after load stayed below thresholds of current level
+*   for kRecoveryMs, so that views do not flip between modes at load close to thresholds.
+*
+*   Governor only decides on level, consumers apply it (see ComponentInterface::setLoadLevel). Frame path itself
+*   is never touched, so loggers, gateways and statistics stay lossless.
+*/
+class LoadGovernor : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kSampleIntervalMs = 100;
+    static constexpr int kRecoveryMs = 3000;
+
+    struct Thresholds {
+        qint64 reducedLagMs{ 50 };
+        qint64 sampledLagMs{ 250 };
+        std::size_t reducedBacklog{ 64 };
+        std::size_t sampledBacklog{ 256 };
+    };
+
+    /**
+    *   @brief  Gives number of batches waiting for main thread
+    */
+    typedef std::function<std::size_t()> Backlog;
+
+    explicit LoadGovernor(Backlog backlog, QObject* parent = nullptr);
+
+    void setThresholds(const Thresholds& thresholds);
+
+    /**
+    *   @brief  Starts sampling at Normal level
+    */
+    void start();
+
+    /**
+    *   @brief  Stops sampling and returns to Normal level
+    */
+    void stop();
+
+    LoadLevel level() const;
+
+    /**
+    *   @brief  Evaluates one sample. Called by sampling timer, exposed for tests.
+    *   @param  lagMs lag of event loop
+    *   @param  backlog batches waiting for main thread
+    *   @param  nowMs time of sample, monotonic
+    */
+    void update(qint64 lagMs, std::size_t backlog, qint64 nowMs);
+
+    static QString name(LoadLevel level);
+
+signals:
+    /**
+    *   @brief  Emitted in main thread when level changes
+    *   @param  level new level
+    *   @param  reason load that caused the change, e.g. "event loop lag 320 ms"
+    */
+    void levelChanged(LoadLevel level, const QString& reason);
+
+private:
+    void sample();
+    LoadLevel target(qint64 lagMs, std::size_t backlog) const;
+    void setLevel(LoadLevel level, const QString& reason);
+
+    Backlog _backlog;
+    Thresholds _thresholds;
+    QTimer _timer;
+    QElapsedTimer _clock; // restarted every sample, measures lag
+    QElapsedTimer _uptime;
+    LoadLevel _level{ LoadLevel::Normal };
+    qint64 _lastOverloadMs{ 0 }; // time load last reached current level
+    bool _startupSample{ false };
+};
+
+#endif // LOADGOVERNOR_H
@@ -0,0 +1,77 @@
+#include "nodestats.h"
+#include <algorithm>
+
+NodeStats NodeStats::operator-(const NodeStats& base) const
+{
+    NodeStats result = *this;
+
+    result.framesIn -= base.framesIn;
+    result.framesOut -= base.framesOut;
+    for (int bin = 0; bin < Instrumentation::kHistogramBins; ++bin) {
+        result.frameNs.bins[bin] -= base.frameNs.bins[bin];
+    }
+    result.frameNs.count -= base.frameNs.count;
+    result.frameNs.sum -= base.frameNs.sum;
+    result.droppedBatches -= std::min(base.droppedBatches, droppedBatches);
+
+    return result;
+}
+
+QString NodeStats::toString(double seconds) const
+{
+    const double span = (seconds > 0.0) ? seconds : 1.0;
+
+    return QString("in %1/s, out %2/s\n%3 us avg, %4 us p99\nqueued %5, dropped %6")
+        .arg(framesIn / span, 0, 'f', 0)
+        .arg(framesOut / span, 0, 'f', 0)
+        .arg(frameNs.mean() / 1000.0, 0, 'f', 2)
+        .arg(frameNs.percentile(0.99) / 1000.0, 0, 'f', 2)
+        .arg(queued)
+        .arg(droppedBatches);
+}
+
+NodeCounters::NodeCounters()
+    : _framesIn(0)
+    , _framesOut(0)
+    , _ns(0)
+    , _maxNs(0)
+{
+    for (auto& bin : _bins) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+}
+
+void NodeCounters::countIn(int frames, quint64 ns)
+{
+    const auto n = static_cast<quint64>(std::max(frames, 0));
+    const quint64 perFrame = n ? ns / n : ns;
+
+    _framesIn.fetch_add(n, std::memory_order_relaxed);
+    _bins[Instrumentation::histogramBin(perFrame)].fetch_add(n, std::memory_order_relaxed);
+    _ns.fetch_add(ns, std::memory_order_relaxed);
+
+    quint64 max = _maxNs.load(std::memory_order_relaxed);
+    while ((perFrame > max) && !_maxNs.compare_exchange_weak(max, perFrame, std::memory_order_relaxed)) {
+    }
+}
+
+void NodeCounters::countOut(int frames)
+{
+    _framesOut.fetch_add(static_cast<quint64>(std::max(frames, 0)), std::memory_order_relaxed);
+}
+
+NodeStats NodeCounters::snapshot() const
+{
+    NodeStats stats;
+
+    stats.framesIn = _framesIn.load(std::memory_order_relaxed);
+    stats.framesOut = _framesOut.load(std::memory_order_relaxed);
+    for (int bin = 0; bin < Instrumentation::kHistogramBins; ++bin) {
+        stats.frameNs.bins[bin] = _bins[bin].load(std::memory_order_relaxed);
+    }
+    stats.frameNs.count = stats.framesIn;
+    stats.frameNs.sum = _ns.load(std::memory_order_relaxed);
+    stats.frameNs.max = _maxNs.load(std::memory_order_relaxed);
+
+    return stats;
+}
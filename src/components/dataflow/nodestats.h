@@ -0,0 +1,76 @@
+#ifndef NODESTATS_H
+#define NODESTATS_H
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <instrumentation.h>
+
+/**
+*   @brief  Frame path activity of one node of the plan, see FlowPlan::nodeStats
+*
+*   Counters are monotonic, subtract two snapshots to get activity in between.
+*/
+struct NodeStats {
+    quint64 framesIn{ 0 }; // frames passed to node by its inbound edges
+    quint64 framesOut{ 0 }; // frames emitted by node, counted once regardless of number of consumers
+    // Processing time per frame in nanoseconds, i.e. time spent in node slot divided by batch size, weighted by
+    // frames. Maximum cannot be subtracted, it is the maximum since plan was built.
+    Instrumentation::HistogramSnapshot frameNs;
+    std::size_t queued{ 0 }; // batches waiting in queues of inbound edges, not subtracted
+    quint64 droppedBatches{ 0 }; // dropped by policies of inbound edges
+
+    NodeStats operator-(const NodeStats& base) const;
+
+    /**
+    *   @brief  Formats rates, mean and 99th percentile of time per frame and queue counters, one group per line
+    *   @param  seconds time span of stats, difference of two snapshots
+    */
+    QString toString(double seconds) const;
+};
+
+/**
+*   @brief  Counters of one node updated by whichever thread delivers frames to it
+*
+*   Node fed by device on worker and by another node in main thread has two writers, so updates are relaxed
+*   atomic increments. They are done once per batch, not per frame.
+*/
+class NodeCounters {
+public:
+    NodeCounters();
+
+    NodeCounters(const NodeCounters&) = delete;
+    NodeCounters& operator=(const NodeCounters&) = delete;
+
+    /**
+    *   @brief  Calls process and accounts its duration as time spent on frames of the batch
+    */
+    template <typename F> void measure(int frames, F&& process)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        process();
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        countIn(frames, static_cast<quint64>(ns.count()));
+    }
+
+    void countIn(int frames, quint64 ns);
+    void countOut(int frames);
+
+    /**
+    *   @return counters, queue statistics are filled by FlowPlan
+    */
+    NodeStats snapshot() const;
+
+private:
+    std::atomic<quint64> _framesIn;
+    std::atomic<quint64> _framesOut;
+    std::atomic<quint64> _bins[Instrumentation::kHistogramBins];
+    std::atomic<quint64> _ns;
+    std::atomic<quint64> _maxNs;
+};
+
+#endif // NODESTATS_H
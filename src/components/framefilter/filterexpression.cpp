@@ -0,0 +1,880 @@
+#include "filterexpression.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <log.h>
+
+constexpr int FilterExpression::kMaxStack;
+constexpr int FilterExpression::kMaxAcceptanceFilters;
+
+namespace {
+constexpr qint64 kMaxId = 0x1fffffff;
+constexpr std::size_t kMaxInstructions = std::numeric_limits<quint16>::max();
+constexpr int kMaxNesting = 256;
+
+using Range = FilterExpression::Range;
+
+// Ids of frames subexpression may be true for. Exact set can be complemented, others are only known to be supersets.
+struct IdSet {
+    std::vector<Range> ranges; // sorted, disjoint, within 0 - kMaxId
+    bool exact;
+};
+
+IdSet anyId()
+{
+    return { { { 0, kMaxId } }, false };
+}
+
+std::vector<Range> normalize(std::vector<Range> ranges)
+{
+    std::vector<Range> result;
+
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.low < b.low; });
+
+    for (const auto& range : ranges) {
+        const Range clamped{ std::max<qint64>(range.low, 0), std::min(range.high, kMaxId) };
+
+        if (clamped.low > clamped.high) {
+            continue;
+        }
+
+        if (!result.empty() && (clamped.low <= result.back().high + 1)) {
+            result.back().high = std::max(result.back().high, clamped.high);
+        } else {
+            result.push_back(clamped);
+        }
+    }
+
+    return result;
+}
+
+IdSet unite(const IdSet& a, const IdSet& b)
+{
+    std::vector<Range> ranges = a.ranges;
+
+    ranges.insert(ranges.end(), b.ranges.begin(), b.ranges.end());
+
+    return { normalize(std::move(ranges)), a.exact && b.exact };
+}
+
+IdSet intersect(const IdSet& a, const IdSet& b)
+{
+    std::vector<Range> ranges;
+
+    for (const auto& x : a.ranges) {
+        for (const auto& y : b.ranges) {
+            const qint64 low = std::max(x.low, y.low);
+            const qint64 high = std::min(x.high, y.high);
+
+            if (low <= high) {
+                ranges.push_back({ low, high });
+            }
+        }
+    }
+
+    return { normalize(std::move(ranges)), a.exact && b.exact };
+}
+
+IdSet complement(const IdSet& a)
+{
+    if (!a.exact) {
+        return anyId();
+    }
+
+    std::vector<Range> ranges;
+    qint64 low = 0;
+
+    for (const auto& range : a.ranges) {
+        if (range.low > low) {
+            ranges.push_back({ low, range.low - 1 });
+        }
+        low = range.high + 1;
+    }
+
+    if (low <= kMaxId) {
+        ranges.push_back({ low, kMaxId });
+    }
+
+    return { ranges, true };
+}
+} // namespace
+
+class FilterExpression::Compiler {
+public:
+    Compiler(const QByteArray& text, FilterExpression& expression)
+        : _text(text)
+        , _expression(expression)
+    {
+    }
+
+    bool run(IdSet& ids)
+    {
+        Operand result;
+
+        if (!next()) {
+            return false;
+        }
+
+        if (_token.type == Token::End) {
+            ids = anyId();
+            return true;
+        }
+
+        if (!parseOr(result)) {
+            return false;
+        }
+
+        if (_token.type != Token::End) {
+            return unexpected();
+        }
+
+        ids = result.ids;
+
+        return true;
+    }
+
+    QString error() const
+    {
+        return _error;
+    }
+
+private:
+    struct Token {
+        enum Type { End, Number, Name, Symbol };
+
+        Type type;
+        QByteArray text;
+        qint64 value;
+        int pos;
+    };
+
+    struct Operand {
+        enum Kind { Value, Id, Constant };
+
+        Kind kind;
+        qint64 constant;
+        IdSet ids;
+    };
+
+    bool fail(const QString& message, int pos)
+    {
+        _error = QString("%1 at column %2").arg(message).arg(pos + 1);
+        return false;
+    }
+
+    bool unexpected()
+    {
+        if (_token.type == Token::End) {
+            return fail("Unexpected end of expression", _token.pos);
+        }
+
+        return fail(QString("Unexpected '%1'").arg(QString::fromLatin1(_token.text)), _token.pos);
+    }
+
+    bool next()
+    {
+        int pos = _pos;
+
+        while ((pos < _text.size()) && std::isspace(static_cast<uchar>(_text[pos]))) {
+            ++pos;
+        }
+
+        _token = { Token::End, {}, 0, pos };
+
+        if (pos >= _text.size()) {
+            _pos = pos;
+            return true;
+        }
+
+        const char c = _text[pos];
+        int end = pos + 1;
+
+        if (std::isdigit(static_cast<uchar>(c))) {
+            int base = 10;
+            int digits = pos;
+
+            if ((c == '0') && (end < _text.size()) && ((_text[end] | 0x20) == 'x')) {
+                base = 16;
+                digits = pos + 2;
+            } else if ((c == '0') && (end < _text.size()) && ((_text[end] | 0x20) == 'b')) {
+                base = 2;
+                digits = pos + 2;
+            }
+
+            end = digits;
+            while ((end < _text.size()) && std::isalnum(static_cast<uchar>(_text[end]))) {
+                ++end;
+            }
+
+            bool ok = false;
+            const qint64 value = _text.mid(digits, end - digits).toLongLong(&ok, base);
+
+            if (!ok || (value < 0) || (value > std::numeric_limits<quint32>::max())) {
+                return fail(QString("Invalid number '%1'").arg(QString::fromLatin1(_text.mid(pos, end - pos))), pos);
+            }
+
+            _token = { Token::Number, _text.mid(pos, end - pos), value, pos };
+        } else if (std::isalpha(static_cast<uchar>(c)) || (c == '_')) {
+            while ((end < _text.size()) && (std::isalnum(static_cast<uchar>(_text[end])) || (_text[end] == '_'))) {
+                ++end;
+            }
+
+            _token = { Token::Name, _text.mid(pos, end - pos), 0, pos };
+        } else {
+            static const char* const symbols[]
+                = { "&&", "||", "==", "!=", "<=", ">=", "<<", ">>", "..", "!", "~", "&", "|", "^", "<", ">", "(", ")",
+                      "[", "]", "," };
+            const char* found = nullptr;
+
+            for (const char* symbol : symbols) {
+                const int length = static_cast<int>(std::strlen(symbol));
+
+                if (_text.mid(pos, length) == symbol) {
+                    found = symbol;
+                    break;
+                }
+            }
+
+            if (!found) {
+                return fail(QString("Unexpected character '%1'").arg(QChar::fromLatin1(c)), pos);
+            }
+
+            end = pos + static_cast<int>(std::strlen(found));
+            _token = { Token::Symbol, found, 0, pos };
+        }
+
+        _pos = end;
+
+        return true;
+    }
+
+    bool isSymbol(const char* symbol) const
+    {
+        return (_token.type == Token::Symbol) && (_token.text == symbol);
+    }
+
+    bool expect(const char* symbol)
+    {
+        return isSymbol(symbol) ? next() : unexpected();
+    }
+
+    bool add(Instruction::Op op, int stackDelta, quint8 arg = 0, qint64 value = 0)
+    {
+        _depth += stackDelta;
+        _maxDepth = std::max(_maxDepth, _depth);
+
+        if (_maxDepth > FilterExpression::kMaxStack) {
+            return fail("Expression is nested too deep", _token.pos);
+        }
+
+        if (_expression._program.size() >= kMaxInstructions) {
+            return fail("Expression is too long", _token.pos);
+        }
+
+        _expression._program.push_back({ op, arg, 0, value });
+
+        return true;
+    }
+
+    // Logical operators evaluate right operand only if left one does not decide the result
+    template <typename Parse>
+    bool parseLogical(const char* symbol, Instruction::Op jump, bool conjunction, Operand& out, Parse parse)
+    {
+        if (!parse(out)) {
+            return false;
+        }
+
+        while (isSymbol(symbol)) {
+            if (!next()) {
+                return false;
+            }
+
+            const std::size_t at = _expression._program.size();
+            Operand right;
+
+            if (!add(jump, -1) || !parse(right) || !add(Instruction::ToBool, 0)) {
+                return false;
+            }
+
+            _expression._program[at].target = static_cast<quint16>(_expression._program.size());
+            out = { Operand::Value, 0, conjunction ? intersect(out.ids, right.ids) : unite(out.ids, right.ids) };
+        }
+
+        return true;
+    }
+
+    bool parseOr(Operand& out)
+    {
+        return parseLogical("||", Instruction::JumpIfTrue, false, out, [this](Operand& o) { return parseAnd(o); });
+    }
+
+    bool parseAnd(Operand& out)
+    {
+        return parseLogical(
+            "&&", Instruction::JumpIfFalse, true, out, [this](Operand& o) { return parseComparison(o); });
+    }
+
+    static bool comparison(const Token& token, Instruction::Op& op)
+    {
+        static const std::pair<const char*, Instruction::Op> ops[] = { { "==", Instruction::Equal },
+            { "!=", Instruction::NotEqual }, { "<", Instruction::Less }, { "<=", Instruction::LessEqual },
+            { ">", Instruction::Greater }, { ">=", Instruction::GreaterEqual } };
+
+        if (token.type != Token::Symbol) {
+            return false;
+        }
+
+        for (const auto& entry : ops) {
+            if (token.text == entry.first) {
+                op = entry.second;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Ids for which "id <op> value" holds
+    static IdSet idsOf(Instruction::Op op, qint64 value)
+    {
+        switch (op) {
+        case Instruction::Equal:
+            return { normalize({ { value, value } }), true };
+        case Instruction::NotEqual:
+            return complement({ normalize({ { value, value } }), true });
+        case Instruction::Less:
+            return { normalize({ { 0, value - 1 } }), true };
+        case Instruction::LessEqual:
+            return { normalize({ { 0, value } }), true };
+        case Instruction::Greater:
+            return { normalize({ { value + 1, kMaxId } }), true };
+        case Instruction::GreaterEqual:
+            return { normalize({ { value, kMaxId } }), true };
+        default:
+            return anyId();
+        }
+    }
+
+    // Same comparison with operands swapped, e.g. 5 < id is id > 5
+    static Instruction::Op mirror(Instruction::Op op)
+    {
+        switch (op) {
+        case Instruction::Less:
+            return Instruction::Greater;
+        case Instruction::LessEqual:
+            return Instruction::GreaterEqual;
+        case Instruction::Greater:
+            return Instruction::Less;
+        case Instruction::GreaterEqual:
+            return Instruction::LessEqual;
+        default:
+            return op;
+        }
+    }
+
+    bool parseComparison(Operand& out)
+    {
+        Instruction::Op op;
+
+        if (!parseBinary(0, out)) {
+            return false;
+        }
+
+        if ((_token.type == Token::Name) && (_token.text == "in")) {
+            std::vector<Range> set;
+
+            if (!next() || !parseSet(set)) {
+                return false;
+            }
+
+            if (!add(Instruction::InSet, 0, 0, static_cast<qint64>(_expression._sets.size()))) {
+                return false;
+            }
+
+            out = { Operand::Value, 0, (out.kind == Operand::Id) ? IdSet{ normalize(set), true } : anyId() };
+            _expression._sets.push_back(std::move(set));
+        } else if (comparison(_token, op)) {
+            Operand right;
+
+            if (!next() || !parseBinary(0, right) || !add(op, -1)) {
+                return false;
+            }
+
+            IdSet ids = anyId();
+
+            if ((out.kind == Operand::Id) && (right.kind == Operand::Constant)) {
+                ids = idsOf(op, right.constant);
+            } else if ((out.kind == Operand::Constant) && (right.kind == Operand::Id)) {
+                ids = idsOf(mirror(op), out.constant);
+            }
+
+            out = { Operand::Value, 0, ids };
+        } else {
+            return true;
+        }
+
+        if (comparison(_token, op) || ((_token.type == Token::Name) && (_token.text == "in"))) {
+            return fail("Comparisons cannot be chained", _token.pos);
+        }
+
+        return true;
+    }
+
+    bool parseSet(std::vector<Range>& set)
+    {
+        if (!expect("[")) {
+            return false;
+        }
+
+        do {
+            if (_token.type != Token::Number) {
+                return unexpected();
+            }
+
+            Range range{ _token.value, _token.value };
+            const int pos = _token.pos;
+
+            if (!next()) {
+                return false;
+            }
+
+            if (isSymbol("..")) {
+                if (!next()) {
+                    return false;
+                }
+                if (_token.type != Token::Number) {
+                    return unexpected();
+                }
+
+                range.high = _token.value;
+                if (range.high < range.low) {
+                    return fail("Empty range", pos);
+                }
+
+                if (!next()) {
+                    return false;
+                }
+            }
+
+            set.push_back(range);
+        } while (isSymbol(",") && next());
+
+        if (!_error.isEmpty() || !expect("]")) {
+            return false;
+        }
+
+        // Ranges are sorted and merged, so membership is a binary search
+        std::sort(set.begin(), set.end(), [](const Range& a, const Range& b) { return a.low < b.low; });
+
+        std::vector<Range> merged;
+        for (const auto& range : set) {
+            if (!merged.empty() && (range.low <= merged.back().high + 1)) {
+                merged.back().high = std::max(merged.back().high, range.high);
+            } else {
+                merged.push_back(range);
+            }
+        }
+        set = std::move(merged);
+
+        return true;
+    }
+
+    bool parseBinary(int level, Operand& out)
+    {
+        static const std::vector<std::pair<const char*, Instruction::Op>> levels[] = {
+            { { "|", Instruction::BitOr } },
+            { { "^", Instruction::BitXor } },
+            { { "&", Instruction::BitAnd } },
+            { { "<<", Instruction::ShiftLeft }, { ">>", Instruction::ShiftRight } },
+        };
+
+        if (level == static_cast<int>(sizeof(levels) / sizeof(levels[0]))) {
+            return parseUnary(out);
+        }
+
+        if (!parseBinary(level + 1, out)) {
+            return false;
+        }
+
+        for (;;) {
+            auto entry = std::find_if(levels[level].begin(), levels[level].end(),
+                [this](const std::pair<const char*, Instruction::Op>& e) { return isSymbol(e.first); });
+
+            if (entry == levels[level].end()) {
+                return true;
+            }
+
+            Operand right;
+
+            if (!next() || !parseBinary(level + 1, right) || !add(entry->second, -1)) {
+                return false;
+            }
+
+            out = { Operand::Value, 0, anyId() };
+        }
+    }
+
+    // Parentheses and unary operators recurse, their nesting is limited so that parsing cannot exhaust stack
+    bool parseUnary(Operand& out)
+    {
+        if (_nesting == kMaxNesting) {
+            return fail("Expression is nested too deep", _token.pos);
+        }
+
+        ++_nesting;
+        const bool ok = parseUnaryOperand(out);
+        --_nesting;
+
+        return ok;
+    }
+
+    bool parseUnaryOperand(Operand& out)
+    {
+        if (isSymbol("!")) {
+            if (!next() || !parseUnary(out) || !add(Instruction::Not, 0)) {
+                return false;
+            }
+
+            out = { Operand::Value, 0, complement(out.ids) };
+            return true;
+        }
+
+        if (isSymbol("~")) {
+            if (!next() || !parseUnary(out) || !add(Instruction::BitNot, 0)) {
+                return false;
+            }
+
+            out = { Operand::Value, 0, anyId() };
+            return true;
+        }
+
+        return parsePrimary(out);
+    }
+
+    bool constant(qint64 value, Operand& out)
+    {
+        out = { Operand::Constant, value,
+            { value ? std::vector<Range>{ { 0, kMaxId } } : std::vector<Range>{}, true } };
+
+        return add(Instruction::Push, 1, 0, value) && next();
+    }
+
+    bool load(Instruction::Op op, quint8 arg, Operand& out)
+    {
+        out = { Operand::Value, 0, anyId() };
+
+        return add(op, 1, arg) && next();
+    }
+
+    bool parsePrimary(Operand& out)
+    {
+        if (_token.type == Token::Number) {
+            return constant(_token.value, out);
+        }
+
+        if (isSymbol("(")) {
+            return next() && parseOr(out) && expect(")");
+        }
+
+        if (_token.type != Token::Name) {
+            return unexpected();
+        }
+
+        static const std::pair<const char*, quint8> flags[] = { { "dir", CanFrameRecord::Tx },
+            { "ext", CanFrameRecord::ExtendedId }, { "rtr", CanFrameRecord::Remote }, { "err", CanFrameRecord::Error },
+            { "fd", CanFrameRecord::FlexibleDataRate }, { "brs", CanFrameRecord::BitrateSwitch },
+            { "failed", CanFrameRecord::TxFailed } };
+        const QByteArray& name = _token.text;
+
+        for (const auto& flag : flags) {
+            if (name == flag.first) {
+                return load(Instruction::LoadFlag, flag.second, out);
+            }
+        }
+
+        if (name == "id") {
+            if (!load(Instruction::LoadId, 0, out)) {
+                return false;
+            }
+
+            // Used as condition id is true for any non-zero id
+            out = { Operand::Id, 0, { { { 1, kMaxId } }, true } };
+            return true;
+        } else if (name == "len") {
+            return load(Instruction::LoadLength, 0, out);
+        } else if (name == "channel") {
+            return load(Instruction::LoadChannel, 0, out);
+        } else if ((name == "RX") || (name == "false")) {
+            return constant(0, out);
+        } else if ((name == "TX") || (name == "true")) {
+            return constant(1, out);
+        } else if (name == "data") {
+            if (!next() || !expect("[")) {
+                return false;
+            }
+
+            if ((_token.type != Token::Number) || (_token.value >= CanFrameRecord::kMaxPayload)) {
+                return fail("Payload index has to be number below 64", _token.pos);
+            }
+
+            const quint8 index = static_cast<quint8>(_token.value);
+
+            if (!add(Instruction::LoadByte, 1, index) || !next() || !expect("]")) {
+                return false;
+            }
+
+            out = { Operand::Value, 0, anyId() };
+            return true;
+        }
+
+        return fail(QString("Unknown name '%1'").arg(QString::fromLatin1(name)), _token.pos);
+    }
+
+    const QByteArray _text;
+    FilterExpression& _expression;
+    Token _token{ Token::End, {}, 0, 0 };
+    QString _error;
+    int _pos{ 0 };
+    int _depth{ 0 };
+    int _maxDepth{ 0 };
+    int _nesting{ 0 };
+};
+
+bool FilterExpression::compile(const QString& text)
+{
+    _text = text;
+    _error.clear();
+    _program.clear();
+    _sets.clear();
+    _acceptanceFilters.clear();
+
+    Compiler compiler(text.toLatin1(), *this);
+    IdSet ids;
+
+    if (!compiler.run(ids)) {
+        _error = compiler.error();
+        _program.clear();
+        _sets.clear();
+
+        cds_warn("Invalid filter expression '{}': {}", text.toStdString(), _error.toStdString());
+
+        // Nothing is accepted, device does not need to receive anything either
+        auto none = makeCanFilter(0x1fffffff, 0x1fffffff);
+
+        none.format = QCanBusDevice::Filter::MatchBaseFormat;
+        _acceptanceFilters.append(none);
+
+        return false;
+    }
+
+    if ((ids.ranges.size() == 1) && (ids.ranges[0].low == 0) && (ids.ranges[0].high == kMaxId)) {
+        return true;
+    }
+
+    if (ids.ranges.empty()) {
+        auto none = makeCanFilter(0x1fffffff, 0x1fffffff);
+
+        none.format = QCanBusDevice::Filter::MatchBaseFormat;
+        _acceptanceFilters.append(none);
+
+        return true;
+    }
+
+    // Every range is split into aligned power of two blocks, each of them is one id/mask pair
+    for (const auto& range : ids.ranges) {
+        qint64 low = range.low;
+
+        while (low <= range.high) {
+            qint64 block = 1;
+
+            while (((low & (2 * block - 1)) == 0) && (low + 2 * block - 1 <= range.high)) {
+                block *= 2;
+            }
+
+            if (_acceptanceFilters.size() == kMaxAcceptanceFilters) {
+                _acceptanceFilters.clear();
+                return true;
+            }
+
+            _acceptanceFilters.append(
+                makeCanFilter(static_cast<quint32>(low), static_cast<quint32>(kMaxId & ~(block - 1))));
+            low += block;
+        }
+    }
+
+    return true;
+}
+
+QString FilterExpression::text() const
+{
+    return _text;
+}
+
+QString FilterExpression::errorString() const
+{
+    return _error;
+}
+
+bool FilterExpression::isValid() const
+{
+    return _error.isEmpty();
+}
+
+bool FilterExpression::matches(const CanFrameRecord& rec) const
+{
+    const std::size_t size = _program.size();
+
+    if (size == 0) {
+        return isValid();
+    }
+
+    qint64 stack[kMaxStack];
+    int sp = -1;
+    std::size_t pc = 0;
+
+    while (pc < size) {
+        const Instruction& ins = _program[pc++];
+
+        switch (ins.op) {
+        case Instruction::Push:
+            stack[++sp] = ins.value;
+            break;
+        case Instruction::LoadId:
+            stack[++sp] = rec.id;
+            break;
+        case Instruction::LoadLength:
+            stack[++sp] = rec.length;
+            break;
+        case Instruction::LoadChannel:
+            stack[++sp] = rec.channel;
+            break;
+        case Instruction::LoadByte:
+            // Bytes beyond length of frame are not defined
+            stack[++sp] = (ins.arg < rec.length) ? rec.payload[ins.arg] : 0;
+            break;
+        case Instruction::LoadFlag:
+            stack[++sp] = (rec.flags & ins.arg) ? 1 : 0;
+            break;
+        case Instruction::BitOr:
+            --sp;
+            stack[sp] |= stack[sp + 1];
+            break;
+        case Instruction::BitXor:
+            --sp;
+            stack[sp] ^= stack[sp + 1];
+            break;
+        case Instruction::BitAnd:
+            --sp;
+            stack[sp] &= stack[sp + 1];
+            break;
+        case Instruction::ShiftLeft:
+            --sp;
+            stack[sp] = static_cast<qint64>(static_cast<quint64>(stack[sp]) << (stack[sp + 1] & 63));
+            break;
+        case Instruction::ShiftRight:
+            --sp;
+            stack[sp] = static_cast<qint64>(static_cast<quint64>(stack[sp]) >> (stack[sp + 1] & 63));
+            break;
+        case Instruction::Equal:
+            --sp;
+            stack[sp] = stack[sp] == stack[sp + 1];
+            break;
+        case Instruction::NotEqual:
+            --sp;
+            stack[sp] = stack[sp] != stack[sp + 1];
+            break;
+        case Instruction::Less:
+            --sp;
+            stack[sp] = stack[sp] < stack[sp + 1];
+            break;
+        case Instruction::LessEqual:
+            --sp;
+            stack[sp] = stack[sp] <= stack[sp + 1];
+            break;
+        case Instruction::Greater:
+            --sp;
+            stack[sp] = stack[sp] > stack[sp + 1];
+            break;
+        case Instruction::GreaterEqual:
+            --sp;
+            stack[sp] = stack[sp] >= stack[sp + 1];
+            break;
+        case Instruction::InSet:
+            stack[sp] = contains(_sets[static_cast<std::size_t>(ins.value)], stack[sp]);
+            break;
+        case Instruction::Not:
+            stack[sp] = !stack[sp];
+            break;
+        case Instruction::BitNot:
+            stack[sp] = ~stack[sp];
+            break;
+        case Instruction::ToBool:
+            stack[sp] = stack[sp] != 0;
+            break;
+        case Instruction::JumpIfFalse:
+            if (stack[sp] == 0) {
+                pc = ins.target;
+            } else {
+                --sp;
+            }
+            break;
+        case Instruction::JumpIfTrue:
+            if (stack[sp] != 0) {
+                stack[sp] = 1;
+                pc = ins.target;
+            } else {
+                --sp;
+            }
+            break;
+        }
+    }
+
+    return stack[0] != 0;
+}
+
+CanFrameBatch FilterExpression::filter(const CanFrameBatch& frames) const
+{
+    const int size = frames.size();
+    int first = 0;
+
+    // Leading frames are not copied until the first rejected one is found
+    while ((first < size) && matches(frames[first])) {
+        ++first;
+    }
+
+    if (first == size) {
+        return frames;
+    }
+
+    CanFrameBatch result;
+
+    result.reserve(size);
+    result.append(frames.mid(0, first));
+
+    for (int i = first + 1; i < size; ++i) {
+        if (matches(frames[i])) {
+            result.append(frames[i]);
+        }
+    }
+
+    return result;
+}
+
+CanFilterList FilterExpression::acceptanceFilters() const
+{
+    return _acceptanceFilters;
+}
+
+int FilterExpression::size() const
+{
+    return static_cast<int>(_program.size());
+}
+
+bool FilterExpression::contains(const std::vector<Range>& set, qint64 value)
+{
+    auto it = std::upper_bound(
+        set.begin(), set.end(), value, [](qint64 v, const Range& range) { return v < range.low; });
+
+    return (it != set.begin()) && (value <= (it - 1)->high);
+}
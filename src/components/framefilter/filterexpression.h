@@ -0,0 +1,125 @@
+#ifndef FILTEREXPRESSION_H
+#define FILTEREXPRESSION_H
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <canfilter.h>
+#include <canframerecord.h>
+#include <vector>
+
+/**
+*   @brief  Frame filter expression compiled into bytecode of small stack machine
+*
+*   Expression is parsed once, e.g.
+*
+*       id in [0x100..0x1ff, 0x7df] && data[2] & 0x80 && dir == RX
+*
+*   Operands: id, len, channel, data[n] (payload byte, 0 beyond frame length), dir (RX or TX), flags ext, rtr, err,
+*   fd, brs and failed (transmission failed) valued 0 or 1, decimal, hexadecimal (0x) and binary (0b) numbers, true
+*   and false. Operators from the lowest precedence: ||, &&, comparisons (== != < <= > >=) and set membership
+*   (in [a, b..c]), |, ^, &, shifts (<< >>), unary ! and ~. Unlike in C, bitwise operators bind tighter than
+*   comparisons, so data[0] & 0x0f == 2 compares the masked value. && and || are evaluated lazily. Value used as
+*   condition is true if it is not zero.
+*
+*   Evaluation runs over fixed-size stack on the stack of the caller, it costs a few switch dispatches per operator
+*   and does not allocate. Filter passing all frames of batch returns the batch itself, without copy.
+*/
+class FilterExpression {
+public:
+    static constexpr int kMaxStack = 32;
+    // Device filter banks are small, ids not expressible with so many filters are filtered in software only
+    static constexpr int kMaxAcceptanceFilters = 16;
+
+    // Inclusive range of values of set
+    struct Range {
+        qint64 low;
+        qint64 high;
+    };
+
+    /**
+    *   @brief  Compiles expression, previous program is discarded
+    *   @param  text expression, empty expression accepts all frames
+    *   @return false if expression is invalid (see errorString), no frame is accepted then
+    */
+    bool compile(const QString& text);
+
+    /**
+    *   @return expression as passed to compile()
+    */
+    QString text() const;
+
+    /**
+    *   @return description of syntax error with its column, empty if expression is valid
+    */
+    QString errorString() const;
+
+    bool isValid() const;
+
+    /**
+    *   @return true if frame satisfies expression
+    */
+    bool matches(const CanFrameRecord& rec) const;
+
+    /**
+    *   @return frames satisfying expression, frames itself (shared, not copied) if all of them do
+    */
+    CanFrameBatch filter(const CanFrameBatch& frames) const;
+
+    /**
+    *   @brief  Acceptance filters derived from conditions on id. They let through every frame expression may
+    *           accept (and possibly more), so device can drop the rest before it reaches any component.
+    *   @return filters, empty list if expression does not restrict id or needs more than kMaxAcceptanceFilters
+    */
+    CanFilterList acceptanceFilters() const;
+
+    /**
+    *   @return number of instructions of compiled program
+    */
+    int size() const;
+
+private:
+    class Compiler;
+
+    struct Instruction {
+        enum Op : quint8 {
+            Push,
+            LoadId,
+            LoadLength,
+            LoadChannel,
+            LoadByte, // arg: payload index
+            LoadFlag, // arg: CanFrameRecord::Flags
+            BitOr,
+            BitXor,
+            BitAnd,
+            ShiftLeft,
+            ShiftRight,
+            Equal,
+            NotEqual,
+            Less,
+            LessEqual,
+            Greater,
+            GreaterEqual,
+            InSet, // value: index of set
+            Not,
+            BitNot,
+            ToBool,
+            JumpIfFalse, // false: keep value and jump to target, true: pop value
+            JumpIfTrue, // true: replace value with 1 and jump to target, false: pop value
+        };
+
+        Op op;
+        quint8 arg;
+        quint16 target;
+        qint64 value;
+    };
+
+    static bool contains(const std::vector<Range>& set, qint64 value);
+
+    QString _text;
+    QString _error;
+    std::vector<Instruction> _program;
+    std::vector<std::vector<Range>> _sets; // sorted, disjoint ranges
+    CanFilterList _acceptanceFilters;
+};
+
+#endif // FILTEREXPRESSION_H
@@ -0,0 +1,79 @@
+#include "framefilter.h"
+#include "framefilter_p.h"
+
+FrameFilter::FrameFilter()
+    : d_ptr(new FrameFilterPrivate(this))
+{
+}
+
+FrameFilter::~FrameFilter()
+{
+}
+
+void FrameFilter::setConfig(QJsonObject& json)
+{
+    Q_D(FrameFilter);
+
+    d->loadSettings(json);
+}
+
+QJsonObject FrameFilter::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+CanFilterList FrameFilter::acceptanceFilters() const
+{
+    return d_ptr->_expression.acceptanceFilters();
+}
+
+bool FrameFilter::isValid() const
+{
+    return d_ptr->_expression.isValid();
+}
+
+QString FrameFilter::errorString() const
+{
+    return d_ptr->_expression.errorString();
+}
+
+quint64 FrameFilter::framesPassed() const
+{
+    return d_ptr->_passed.load(std::memory_order_relaxed);
+}
+
+quint64 FrameFilter::framesRejected() const
+{
+    return d_ptr->_rejected.load(std::memory_order_relaxed);
+}
+
+void FrameFilter::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(FrameFilter);
+
+    d->process(frames);
+}
+
+void FrameFilter::frameBatchSent(bool, const CanFrameBatch& frames)
+{
+    Q_D(FrameFilter);
+
+    // Failed transmissions carry TxFailed flag, expression decides whether they pass
+    d->process(frames);
+}
+
+void FrameFilter::startSimulation()
+{
+    Q_D(FrameFilter);
+
+    d->_passed.store(0, std::memory_order_relaxed);
+    d->_rejected.store(0, std::memory_order_relaxed);
+}
+
+void FrameFilter::stopSimulation()
+{
+}
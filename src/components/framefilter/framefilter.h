@@ -0,0 +1,68 @@
+#ifndef FRAMEFILTER_H
+#define FRAMEFILTER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+
+class FrameFilterPrivate;
+
+/**
+*   @brief  Component passing on only frames satisfying filter expression (see FilterExpression)
+*
+*   Expression is compiled once, when set. Conditions on id are also turned into acceptance filters, so placed
+*   right after CAN device the filter lets device drop unwanted traffic before views, loggers and decoders
+*   downstream see it. Received and sent frames are filtered alike, output keeps their direction flags.
+*/
+class FrameFilter : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(FrameFilter)
+
+public:
+    FrameFilter();
+    ~FrameFilter();
+
+    /**
+    *   @brief  Supported keys: expression (empty expression passes all frames). Applied at once.
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @return ids expression may accept, empty list if it does not restrict id
+    */
+    CanFilterList acceptanceFilters() const override;
+
+    /**
+    *   @return false if expression has syntax error, no frame is passed then
+    */
+    bool isValid() const;
+
+    /**
+    *   @return description of syntax error, empty if expression is valid
+    */
+    QString errorString() const;
+
+    quint64 framesPassed() const;
+    quint64 framesRejected() const;
+
+signals:
+    void framesFiltered(const CanFrameBatch& frames);
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<FrameFilterPrivate> d_ptr;
+};
+
+#endif // FRAMEFILTER_H
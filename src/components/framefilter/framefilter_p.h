@@ -0,0 +1,52 @@
+#ifndef FRAMEFILTER_P_H
+#define FRAMEFILTER_P_H
+
+#include "filterexpression.h"
+#include "framefilter.h"
+#include <QtCore/QJsonObject>
+#include <atomic>
+
+class FrameFilterPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(FrameFilter)
+
+public:
+    FrameFilterPrivate(FrameFilter* q)
+        : q_ptr(q)
+    {
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["expression"] = _expression.text();
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        if (json.contains("expression")) {
+            _expression.compile(json["expression"].toString());
+        }
+    }
+
+    void process(const CanFrameBatch& frames)
+    {
+        const CanFrameBatch passed = _expression.filter(frames);
+
+        // Counters are read from main thread while filter may run on worker
+        _passed.fetch_add(static_cast<quint64>(passed.size()), std::memory_order_relaxed);
+        _rejected.fetch_add(static_cast<quint64>(frames.size() - passed.size()), std::memory_order_relaxed);
+
+        if (!passed.isEmpty()) {
+            emit q_func()->framesFiltered(passed);
+        }
+    }
+
+    FilterExpression _expression;
+    std::atomic<quint64> _passed{ 0 };
+    std::atomic<quint64> _rejected{ 0 };
+
+private:
+    FrameFilter* q_ptr;
+};
+
+#endif // FRAMEFILTER_P_H
@@ -0,0 +1,112 @@
+#include "gateway.h"
+#include "gateway_p.h"
+
+constexpr int Gateway::kMaxChannels;
+
+Gateway::Gateway()
+    : d_ptr(new GatewayPrivate(this))
+{
+}
+
+Gateway::~Gateway()
+{
+}
+
+void Gateway::setConfig(QJsonObject& json)
+{
+    Q_D(Gateway);
+
+    d->loadSettings(json);
+}
+
+QJsonObject Gateway::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+CanFilterList Gateway::acceptanceFilters() const
+{
+    if (d_ptr->_config.forwardUnmatched) {
+        return {};
+    }
+
+    CanFilterList filters = d_ptr->_config.table.forwardedIds();
+
+    if (filters.isEmpty()) {
+        // Empty list would accept everything. Standard frame never has id above 0x7ff, so this matches nothing.
+        auto none = makeCanFilter(0x1fffffff, 0x1fffffff);
+
+        none.format = QCanBusDevice::Filter::MatchBaseFormat;
+        filters.append(none);
+    }
+
+    return filters;
+}
+
+void Gateway::setSource(CanDevice* device)
+{
+    Q_D(Gateway);
+
+    d->setSource(device);
+}
+
+CanDevice* Gateway::source() const
+{
+    return d_ptr->_source;
+}
+
+void Gateway::setTarget(int channel, CanDevice* device)
+{
+    Q_D(Gateway);
+
+    if ((channel < 0) || (channel >= kMaxChannels)) {
+        cds_warn("Invalid gateway channel {}", channel);
+        return;
+    }
+
+    d->_targets[channel].store(device, std::memory_order_release);
+}
+
+CanDevice* Gateway::target(int channel) const
+{
+    if ((channel < 0) || (channel >= kMaxChannels)) {
+        return nullptr;
+    }
+
+    return d_ptr->_targets[channel].load(std::memory_order_relaxed);
+}
+
+quint64 Gateway::framesForwarded() const
+{
+    return d_ptr->_forwarded.load(std::memory_order_relaxed);
+}
+
+quint64 Gateway::framesDropped() const
+{
+    return d_ptr->_dropped.load(std::memory_order_relaxed);
+}
+
+void Gateway::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(Gateway);
+
+    d->routeRecords(frames);
+}
+
+void Gateway::startSimulation()
+{
+    Q_D(Gateway);
+
+    d->start();
+}
+
+void Gateway::stopSimulation()
+{
+    Q_D(Gateway);
+
+    d->stop();
+}
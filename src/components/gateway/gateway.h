@@ -0,0 +1,89 @@
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+
+class CanDevice;
+class GatewayPrivate;
+
+/**
+*   @brief  Component routing frames received by one CAN device to other devices
+*
+*   Every frame is looked up in routing table (see GatewayTable) and either dropped or written to device of
+*   route's channel with remapped id. In dataflow plan Gateway is attached to source device as receive tap, so
+*   routing runs in the thread reading the device (I/O thread with ioThread) and frames are written to target
+*   devices serviced by the same thread at once, without passing main thread or node graph. Time from reception
+*   to write is recorded in Instrumentation::Histogram::GatewayUs.
+*/
+class Gateway : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(Gateway)
+
+public:
+    static constexpr int kMaxChannels = 4;
+
+    Gateway();
+    ~Gateway();
+
+    /**
+    *   @brief  Supported keys: routes (see GatewayTable::compile), forwardUnmatched (frames without route are
+    *           written unchanged to channel 0 instead of being dropped). Applied on next simulation start.
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @return ids routed to targets, empty list if unmatched frames are forwarded as well
+    */
+    CanFilterList acceptanceFilters() const override;
+
+    /**
+    *   @brief  Attaches gateway to device frames are routed from
+    *   @param  device source device, nullptr to detach
+    */
+    void setSource(CanDevice* device);
+
+    /**
+    *   @return device frames are routed from, nullptr if none
+    */
+    CanDevice* source() const;
+
+    /**
+    *   @brief  Sets device frames routed to channel are written to
+    *   @param  channel output of gateway, 0 to kMaxChannels - 1
+    *   @param  device target device, nullptr to remove
+    */
+    void setTarget(int channel, CanDevice* device);
+
+    /**
+    *   @return device of channel, nullptr if none
+    */
+    CanDevice* target(int channel) const;
+
+    quint64 framesForwarded() const;
+    quint64 framesDropped() const;
+
+signals:
+    /**
+    *   @brief  Frames routed to channel, emitted for frames passed to frameBatchReceived (node graph) only
+    */
+    void framesRouted(int channel, const CanFrameBatch& frames);
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<GatewayPrivate> d_ptr;
+};
+
+#endif // GATEWAY_H
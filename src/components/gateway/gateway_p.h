@@ -0,0 +1,222 @@
+#ifndef GATEWAY_P_H
+#define GATEWAY_P_H
+
+#include "gateway.h"
+#include "gatewaytable.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <array>
+#include <atomic>
+#include <candevice.h>
+#include <instrumentation.h>
+#include <log.h>
+#include <memory>
+#include <vector>
+
+class GatewayPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(Gateway)
+
+public:
+    // Routing state of running simulation, replaced as a whole so that receive tap never sees it half updated
+    struct Plan {
+        GatewayTable table;
+        bool forwardUnmatched;
+    };
+
+    GatewayPrivate(Gateway* q)
+        : q_ptr(q)
+    {
+        for (auto& target : _targets) {
+            target.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~GatewayPrivate()
+    {
+        setSource(nullptr);
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["routes"] = _config.table.routes();
+        json["forwardUnmatched"] = _config.forwardUnmatched;
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        if (json.contains("routes")) {
+            const QJsonArray routes = json["routes"].toArray();
+            const int compiled = _config.table.compile(routes, Gateway::kMaxChannels);
+
+            if (compiled < routes.size()) {
+                cds_warn("{} of {} gateway routes could not be compiled", routes.size() - compiled, routes.size());
+            }
+        }
+
+        _config.forwardUnmatched = json["forwardUnmatched"].toBool(_config.forwardUnmatched);
+    }
+
+    void start()
+    {
+        _forwarded.store(0, std::memory_order_relaxed);
+        _dropped.store(0, std::memory_order_relaxed);
+        std::atomic_store(&_plan, std::shared_ptr<const Plan>(std::make_shared<Plan>(_config)));
+
+        cds_info("Gateway started with {} routes", _config.table.size());
+    }
+
+    void stop()
+    {
+        std::atomic_store(&_plan, std::shared_ptr<const Plan>());
+
+        cds_info("Gateway forwarded {} frames, dropped {}", _forwarded.load(std::memory_order_relaxed),
+            _dropped.load(std::memory_order_relaxed));
+    }
+
+    void setSource(CanDevice* device)
+    {
+        if (_source) {
+            _source->setReceiveTap({});
+        }
+
+        _source = device;
+
+        if (_source) {
+            _source->setReceiveTap([this](const QVector<QCanBusFrame>& frames) { route(frames); });
+        }
+    }
+
+    /**
+    *   @brief  Routes frames of source device, called in the thread reading it
+    */
+    void route(const QVector<QCanBusFrame>& frames)
+    {
+        const auto plan = std::atomic_load(&_plan);
+
+        if (!plan) {
+            return;
+        }
+
+        quint64 dropped = 0;
+
+        _times.clear();
+
+        for (const auto& frame : frames) {
+            const quint32 id = frame.frameId();
+            const bool extended = frame.hasExtendedFrameFormat();
+            const GatewayTable::Route* route = plan->table.lookup(id, extended);
+            const GatewayTable::Route unmatched{ id, 0,
+                static_cast<quint8>(GatewayTable::Route::Valid | (extended ? GatewayTable::Route::Extended : 0)) };
+
+            if (!route && plan->forwardUnmatched) {
+                route = &unmatched;
+            }
+
+            CanDevice* target = route ? _targets[route->channel].load(std::memory_order_acquire) : nullptr;
+
+            if (!route || route->drop() || !target || (frame.frameType() == QCanBusFrame::ErrorFrame)) {
+                ++dropped;
+                continue;
+            }
+
+            auto& out = _out[route->channel];
+
+            out.append(frame);
+            QCanBusFrame& routed = out.last();
+            routed.setFrameId(route->targetId);
+            routed.setExtendedFrameFormat(route->extended());
+            // Stamped again when target device confirms it
+            routed.setTimeStamp(QCanBusFrame::TimeStamp());
+
+            const QCanBusFrame::TimeStamp ts = frame.timeStamp();
+            _times.push_back(static_cast<quint64>(ts.seconds()) * 1000000 + static_cast<quint64>(ts.microSeconds()));
+        }
+
+        for (int channel = 0; channel < Gateway::kMaxChannels; ++channel) {
+            auto& out = _out[channel];
+
+            if (!out.isEmpty()) {
+                send(_targets[channel].load(std::memory_order_acquire), out);
+                out.resize(0);
+            }
+        }
+
+        const quint64 now = canTimestampNow();
+
+        for (auto received : _times) {
+            Instrumentation::record(Instrumentation::Histogram::GatewayUs, (now > received) ? now - received : 0);
+        }
+
+        Instrumentation::add(Instrumentation::Counter::GatewayFrames, _times.size());
+        _forwarded.fetch_add(_times.size(), std::memory_order_relaxed);
+        _dropped.fetch_add(dropped, std::memory_order_relaxed);
+    }
+
+    /**
+    *   @brief  Routes frames passed through node graph, results are emitted per channel
+    */
+    void routeRecords(const CanFrameBatch& records)
+    {
+        std::array<CanFrameBatch, Gateway::kMaxChannels> routed;
+        quint64 dropped = 0;
+
+        for (const auto& rec : records) {
+            const bool extended = rec.hasFlag(CanFrameRecord::ExtendedId);
+            const GatewayTable::Route* route = _config.table.lookup(rec.id, extended);
+
+            if ((!route && !_config.forwardUnmatched) || (route && route->drop())
+                || rec.hasFlag(CanFrameRecord::Error)) {
+                ++dropped;
+                continue;
+            }
+
+            const bool routedExtended = route ? route->extended() : extended;
+            CanFrameRecord out = rec;
+
+            // Routed frames are sent, timestamp and direction are set by target device
+            out.id = route ? route->targetId : rec.id;
+            out.timestamp = 0;
+            out.flags = static_cast<quint8>(
+                (rec.flags & ~(CanFrameRecord::Tx | CanFrameRecord::TxFailed | CanFrameRecord::ExtendedId))
+                | (routedExtended ? CanFrameRecord::ExtendedId : 0));
+
+            routed[route ? route->channel : 0].append(out);
+        }
+
+        _forwarded.fetch_add(static_cast<quint64>(records.size()) - dropped, std::memory_order_relaxed);
+        _dropped.fetch_add(dropped, std::memory_order_relaxed);
+
+        for (int channel = 0; channel < Gateway::kMaxChannels; ++channel) {
+            if (!routed[channel].isEmpty()) {
+                emit q_func()->framesRouted(channel, routed[channel]);
+            }
+        }
+    }
+
+    Plan _config{ GatewayTable(), false };
+    CanDevice* _source{ nullptr };
+    std::array<std::atomic<CanDevice*>, Gateway::kMaxChannels> _targets;
+    std::atomic<quint64> _forwarded{ 0 };
+    std::atomic<quint64> _dropped{ 0 };
+
+private:
+    static void send(CanDevice* target, const QVector<QCanBusFrame>& frames)
+    {
+        if (QThread::currentThread() == target->ioThread()) {
+            target->sendFrames(frames);
+        } else {
+            // Target is serviced by another thread, one hop cannot be avoided
+            QTimer::singleShot(0, target, [target, frames] { target->sendFrames(frames); });
+        }
+    }
+
+    std::shared_ptr<const Plan> _plan; // accessed with atomic_load / atomic_store only
+    // Used by receive tap only
+    std::array<QVector<QCanBusFrame>, Gateway::kMaxChannels> _out;
+    std::vector<quint64> _times;
+    Gateway* q_ptr;
+};
+
+#endif // GATEWAY_P_H
@@ -0,0 +1,145 @@
+#include "gatewaytable.h"
+#include <QtCore/QJsonObject>
+#include <log.h>
+#include <utility>
+
+constexpr int GatewayTable::kStandardIds;
+constexpr quint32 GatewayTable::kEmpty;
+
+namespace {
+constexpr quint32 kMaxExtendedId = 0x1fffffff;
+constexpr quint32 kMaxStandardId = 0x7ff;
+} // namespace
+
+GatewayTable::GatewayTable()
+    : _standard(kStandardIds, Route{ 0, 0, 0 })
+{
+}
+
+int GatewayTable::compile(const QJsonArray& routes, int channels)
+{
+    std::vector<std::pair<quint32, Route>> extended;
+
+    _routes = routes;
+    _standard.assign(kStandardIds, Route{ 0, 0, 0 });
+    _keys.clear();
+    _extended.clear();
+    _size = 0;
+
+    int compiled = 0;
+
+    for (const auto& value : routes) {
+        const QJsonObject obj = value.toObject();
+
+        if (!obj.contains("id")) {
+            cds_warn("Gateway route without id skipped");
+            continue;
+        }
+
+        const quint32 id = static_cast<quint32>(obj["id"].toDouble());
+        const bool isExtended = obj["extended"].toBool(id > kMaxStandardId);
+        const quint32 targetId = static_cast<quint32>(obj["targetId"].toDouble(id));
+        const bool targetExtended
+            = obj["targetExtended"].toBool(obj.contains("targetId") ? (targetId > kMaxStandardId) : isExtended);
+        const int channel = obj["channel"].toInt(0);
+
+        if ((id > (isExtended ? kMaxExtendedId : kMaxStandardId))
+            || (targetId > (targetExtended ? kMaxExtendedId : kMaxStandardId))) {
+            cds_warn("Gateway route {:#x} -> {:#x} has invalid id", id, targetId);
+            continue;
+        }
+
+        if ((channel < 0) || (channel >= channels)) {
+            cds_warn("Gateway route {:#x} has invalid channel {}", id, channel);
+            continue;
+        }
+
+        Route route{ targetId, static_cast<quint8>(channel), Route::Valid };
+
+        if (obj["drop"].toBool()) {
+            route.flags |= Route::Drop;
+        }
+        if (targetExtended) {
+            route.flags |= Route::Extended;
+        }
+
+        if (isExtended) {
+            extended.emplace_back(id, route);
+        } else {
+            _size += (_standard[id].flags & Route::Valid) ? 0 : 1;
+            _standard[id] = route;
+        }
+
+        ++compiled;
+    }
+
+    if (!extended.empty()) {
+        // Power of two capacity of at least twice the number of routes keeps probe sequences short
+        int bits = 1;
+        while ((std::size_t(1) << bits) < 2 * extended.size()) {
+            ++bits;
+        }
+
+        _mask = (std::size_t(1) << bits) - 1;
+        _shift = 32 - bits;
+        _keys.assign(_mask + 1, kEmpty);
+        _extended.assign(_mask + 1, Route{ 0, 0, 0 });
+
+        for (const auto& entry : extended) {
+            insertExtended(entry.first, entry.second);
+        }
+    }
+
+    return compiled;
+}
+
+QJsonArray GatewayTable::routes() const
+{
+    return _routes;
+}
+
+CanFilterList GatewayTable::forwardedIds() const
+{
+    CanFilterList filters;
+
+    for (int id = 0; id < kStandardIds; ++id) {
+        if ((_standard[id].flags & Route::Valid) && !_standard[id].drop()) {
+            auto filter = makeCanFilter(static_cast<quint32>(id), kMaxStandardId);
+
+            filter.format = QCanBusDevice::Filter::MatchBaseFormat;
+            filters.append(filter);
+        }
+    }
+
+    for (std::size_t slot = 0; slot < _keys.size(); ++slot) {
+        if ((_keys[slot] != kEmpty) && !_extended[slot].drop()) {
+            auto filter = makeCanFilter(_keys[slot], kMaxExtendedId);
+
+            filter.format = QCanBusDevice::Filter::MatchExtendedFormat;
+            filters.append(filter);
+        }
+    }
+
+    return filters;
+}
+
+int GatewayTable::size() const
+{
+    return _size;
+}
+
+void GatewayTable::insertExtended(quint32 id, const Route& route)
+{
+    std::size_t slot = hash(id);
+
+    while ((_keys[slot] != kEmpty) && (_keys[slot] != id)) {
+        slot = (slot + 1) & _mask;
+    }
+
+    if (_keys[slot] == kEmpty) {
+        ++_size;
+    }
+
+    _keys[slot] = id;
+    _extended[slot] = route;
+}
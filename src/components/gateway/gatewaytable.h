@@ -0,0 +1,117 @@
+#ifndef GATEWAYTABLE_H
+#define GATEWAYTABLE_H
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QtGlobal>
+#include <canfilter.h>
+#include <vector>
+
+/**
+*   @brief  Routing table of Gateway compiled for constant time lookup
+*
+*   Routes of standard (11-bit) ids live in dense table indexed by id. Routes of extended ids are kept in open
+*   addressing hash table sized to at most half load, so lookup is a multiplication, a mask and typically one
+*   compare. Tables are built once, lookups do not allocate.
+*/
+class GatewayTable {
+public:
+    static constexpr int kStandardIds = 0x800;
+
+    struct Route {
+        enum Flags : quint8 {
+            Valid = 0x01,
+            Drop = 0x02,
+            Extended = 0x04, // target id uses extended format
+        };
+
+        quint32 targetId;
+        quint8 channel; // output of Gateway
+        quint8 flags;
+
+        bool drop() const
+        {
+            return (flags & Drop) != 0;
+        }
+
+        bool extended() const
+        {
+            return (flags & Extended) != 0;
+        }
+    };
+
+    GatewayTable();
+
+    /**
+    *   @brief  Compiles routes, invalid entries are reported and skipped. Later route of the same id wins.
+    *
+    *   Route: { "id": 0x123, "extended": false, "targetId": 0x456, "targetExtended": false, "channel": 1,
+    *   "drop": false }. Omitted targetId keeps id, omitted extended flags follow id (above 0x7ff is extended),
+    *   omitted channel is 0.
+    *
+    *   @param  routes array of route objects
+    *   @param  channels number of Gateway outputs, routes to other channels are invalid
+    *   @return number of routes compiled
+    */
+    int compile(const QJsonArray& routes, int channels);
+
+    /**
+    *   @return routes as passed to compile()
+    */
+    QJsonArray routes() const;
+
+    /**
+    *   @return route of frame, nullptr if table has no route for it
+    */
+    const Route* lookup(quint32 id, bool extended) const
+    {
+        if (!extended) {
+            const Route& route = _standard[id & (kStandardIds - 1)];
+
+            return ((id < kStandardIds) && (route.flags & Route::Valid)) ? &route : nullptr;
+        }
+
+        if (_keys.empty()) {
+            return nullptr;
+        }
+
+        for (std::size_t slot = hash(id);; slot = (slot + 1) & _mask) {
+            if (_keys[slot] == id) {
+                return &_extended[slot];
+            }
+            if (_keys[slot] == kEmpty) {
+                return nullptr;
+            }
+        }
+    }
+
+    /**
+    *   @return filters accepting exactly the ids that are forwarded (not dropped)
+    */
+    CanFilterList forwardedIds() const;
+
+    /**
+    *   @return number of routes in table
+    */
+    int size() const;
+
+private:
+    // Extended ids have 29 bits, so this value never is a key
+    static constexpr quint32 kEmpty = 0xffffffff;
+
+    std::size_t hash(quint32 id) const
+    {
+        return static_cast<std::size_t>((id * 0x9e3779b1u) >> _shift) & _mask;
+    }
+
+    void insertExtended(quint32 id, const Route& route);
+
+    QJsonArray _routes;
+    std::vector<Route> _standard;
+    std::vector<quint32> _keys;
+    std::vector<Route> _extended;
+    std::size_t _mask{ 0 };
+    int _shift{ 0 };
+    int _size{ 0 };
+};
+
+#endif // GATEWAYTABLE_H
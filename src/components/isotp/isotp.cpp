@@ -0,0 +1,97 @@
+#include "isotp.h"
+#include "isotp_p.h"
+
+constexpr int IsoTpPrivate::kTimeoutCheckIntervalMs;
+constexpr quint32 IsoTpPrivate::kMaxBufferLength;
+
+IsoTp::IsoTp()
+    : d_ptr(new IsoTpPrivate(this))
+{
+}
+
+IsoTp::~IsoTp()
+{
+}
+
+void IsoTp::startSimulation()
+{
+    Q_D(IsoTp);
+
+    d->_timeoutTimer.start();
+}
+
+void IsoTp::stopSimulation()
+{
+    Q_D(IsoTp);
+
+    d->_timeoutTimer.stop();
+    d->cancelBlocks();
+    for (auto& channel : d->_channels) {
+        channel->reset();
+    }
+}
+
+void IsoTp::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(IsoTp);
+
+    for (const auto& rec : frames) {
+        if (auto channel = d->channelForRx(rec)) {
+            channel->receive(rec);
+        }
+    }
+}
+
+void IsoTp::frameBatchSent(bool, const CanFrameBatch&)
+{
+    // Own frames are not part of any reception
+}
+
+void IsoTp::sendPdu(const IsoTpPdu& pdu)
+{
+    Q_D(IsoTp);
+
+    auto channel = d->channelForTx(pdu.txId);
+    if (!channel) {
+        cds_warn("No ISO-TP channel transmits on 0x{:x}, PDU dropped", pdu.txId);
+        return;
+    }
+
+    channel->send(pdu.data, pdu.length);
+}
+
+void IsoTp::setConfig(QJsonObject& json)
+{
+    Q_D(IsoTp);
+
+    d->loadSettings(json);
+}
+
+QJsonObject IsoTp::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+CanFilterList IsoTp::acceptanceFilters() const
+{
+    CanFilterList filters;
+
+    for (const auto& config : d_ptr->_channelConfigs) {
+        auto filter = makeCanFilter(config.rxId, config.extendedId ? 0x1fffffff : 0x7ff);
+
+        filter.format
+            = config.extendedId ? QCanBusDevice::Filter::MatchExtendedFormat : QCanBusDevice::Filter::MatchBaseFormat;
+        filters.append(filter);
+    }
+
+    return filters;
+}
+
+int IsoTp::channelCount() const
+{
+    return static_cast<int>(d_ptr->_channels.size());
+}
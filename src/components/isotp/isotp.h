@@ -0,0 +1,86 @@
+#ifndef ISOTP_H
+#define ISOTP_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <isotppdu.h>
+
+class IsoTpPrivate;
+
+/**
+*   @brief  Component implementing ISO 15765-2 transport protocol on top of CAN device ports
+*
+*   Every configured rx/tx id pair is served by its own IsoTpChannel with preallocated reassembly buffer.
+*   Completed PDUs are emitted as views into that buffer (see IsoTpPdu), single, first and flow control frames
+*   are emitted right away and blocks of consecutive frames are paced by TxScheduler with separation time
+*   requested by receiver.
+*/
+class IsoTp : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(IsoTp)
+
+public:
+    IsoTp();
+    ~IsoTp();
+
+    /**
+    *   @brief  Supported keys: channels (array of { rxId, txId, extended }), canFd, blockSize, stMin, padding
+    *           (byte value, -1 disables padding of classic frames), maxPduLength
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @brief  Only frames of configured rx ids are needed
+    *   @see ComponentInterface
+    */
+    CanFilterList acceptanceFilters() const override;
+
+    /**
+    *   @return number of configured channels
+    */
+    int channelCount() const;
+
+signals:
+    /**
+    *   @brief  Frames to be sent by CAN device
+    */
+    void sendFrames(const QVector<QCanBusFrame>& frames);
+
+    /**
+    *   @brief  Emitted when PDU was reassembled. Data is valid only until handler returns, see IsoTpPdu.
+    */
+    void pduReceived(const IsoTpPdu& pdu);
+
+    /**
+    *   @brief  Emitted when transfer of channel was aborted
+    *   @param  rxId rx id of channel
+    *   @param  error reason
+    */
+    void transferFailed(quint32 rxId, IsoTpError error);
+
+public slots:
+    /**
+    *   @brief  Sends PDU with channel selected by pdu.txId. Data is copied before the call returns.
+    */
+    void sendPdu(const IsoTpPdu& pdu);
+
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<IsoTpPrivate> d_ptr;
+};
+
+#endif // ISOTP_H
@@ -0,0 +1,239 @@
+#ifndef ISOTP_P_H
+#define ISOTP_P_H
+
+#include "isotp.h"
+#include "isotpchannel.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <log.h>
+#include <memory>
+#include <txscheduler.h>
+#include <unordered_map>
+#include <vector>
+
+class IsoTpPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(IsoTp)
+
+public:
+    // Timeouts are around a second, so coarse timer is good enough for them
+    static constexpr int kTimeoutCheckIntervalMs = 50;
+    // Reassembly buffers are preallocated for every channel, so their size is limited
+    static constexpr quint32 kMaxBufferLength = 16 * 1024 * 1024;
+
+    IsoTpPrivate(IsoTp* q)
+        : q_ptr(q)
+    {
+        _channelConfigs.push_back(IsoTpChannelConfig());
+        buildChannels();
+
+        connect(&_scheduler, &TxScheduler::framesDue, this, [this](const QVector<QCanBusFrame>& frames) {
+            emit q_func()->sendFrames(frames);
+            framesSent(frames);
+        });
+
+        _timeoutTimer.setInterval(kTimeoutCheckIntervalMs);
+        connect(&_timeoutTimer, &QTimer::timeout, this, [this] {
+            const quint64 now = canTimestampNow();
+
+            for (auto& channel : _channels) {
+                channel->expire(now);
+            }
+        });
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        const IsoTpChannelConfig& config = _channelConfigs.front();
+        QJsonArray channels;
+
+        for (const auto& channel : _channelConfigs) {
+            QJsonObject obj;
+
+            obj["rxId"] = static_cast<double>(channel.rxId);
+            obj["txId"] = static_cast<double>(channel.txId);
+            obj["extended"] = channel.extendedId;
+            channels.append(obj);
+        }
+
+        json["channels"] = channels;
+        json["canFd"] = config.canFd;
+        json["blockSize"] = static_cast<int>(config.blockSize);
+        json["stMin"] = static_cast<int>(config.stMin);
+        json["padding"] = config.padding;
+        json["maxPduLength"] = static_cast<double>(config.maxPduLength);
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        IsoTpChannelConfig common = _channelConfigs.front();
+
+        const auto readByte = [&json](const QString& name, int min, int& value) {
+            if (json.contains(name)) {
+                const int v = json[name].toInt(min - 1);
+
+                if ((v >= min) && (v <= 0xff)) {
+                    value = v;
+                } else {
+                    cds_warn("Invalid {} '{}', keeping {}", name.toStdString(), v, value);
+                }
+            }
+        };
+
+        int blockSize = common.blockSize;
+        int stMin = common.stMin;
+        readByte("blockSize", 0, blockSize);
+        readByte("stMin", 0, stMin);
+        readByte("padding", -1, common.padding);
+        common.blockSize = static_cast<quint8>(blockSize);
+        common.stMin = static_cast<quint8>(stMin);
+        common.canFd = json["canFd"].toBool(common.canFd);
+
+        if (json.contains("maxPduLength")) {
+            const double length = json["maxPduLength"].toDouble();
+
+            if ((length >= 1) && (length <= kMaxBufferLength)) {
+                common.maxPduLength = static_cast<quint32>(length);
+            } else {
+                cds_warn("Invalid maxPduLength '{}', keeping {}", length, common.maxPduLength);
+            }
+        }
+
+        std::vector<IsoTpChannelConfig> configs;
+        if (json.contains("channels")) {
+            for (const auto& item : json["channels"].toArray()) {
+                const QJsonObject obj = item.toObject();
+                IsoTpChannelConfig config = common;
+
+                config.rxId = static_cast<quint32>(obj["rxId"].toDouble(common.rxId));
+                config.txId = static_cast<quint32>(obj["txId"].toDouble(common.txId));
+                config.extendedId = obj["extended"].toBool(false);
+                configs.push_back(config);
+            }
+        } else {
+            for (const auto& channel : _channelConfigs) {
+                IsoTpChannelConfig config = common;
+
+                config.rxId = channel.rxId;
+                config.txId = channel.txId;
+                config.extendedId = channel.extendedId;
+                configs.push_back(config);
+            }
+        }
+
+        if (configs.empty()) {
+            cds_warn("No ISO-TP channels configured, keeping previous ones");
+            return;
+        }
+
+        _channelConfigs = std::move(configs);
+        buildChannels();
+    }
+
+    /**
+    *   @brief  Recreates channels from _channelConfigs, transfers in progress are dropped
+    */
+    void buildChannels()
+    {
+        cancelBlocks();
+        _channels.clear();
+        _byRxId.clear();
+        _blocks.assign(_channelConfigs.size(), TxScheduler::kInvalidEntry);
+        _blockFrames.assign(_channelConfigs.size(), 0);
+
+        for (std::size_t i = 0; i < _channelConfigs.size(); ++i) {
+            const IsoTpChannelConfig& config = _channelConfigs[i];
+            IsoTpChannel::Callbacks callbacks;
+
+            callbacks.sendFrame = [this](const QCanBusFrame& frame) { emit q_func()->sendFrames({ frame }); };
+            callbacks.sendBlock = [this, i](const QVector<QCanBusFrame>& frames, std::chrono::microseconds st) {
+                _blocks[i] = _scheduler.addSequence(frames, st);
+                _blockFrames[i] = frames.size();
+            };
+            callbacks.pduReceived = [this](const IsoTpPdu& pdu) { emit q_func()->pduReceived(pdu); };
+            callbacks.failed = [this, rxId = config.rxId](IsoTpError error) {
+                cds_warn("ISO-TP transfer on 0x{:x} failed ({})", rxId, static_cast<int>(error));
+                emit q_func()->transferFailed(rxId, error);
+            };
+
+            if (!_byRxId.emplace(key(config.rxId, config.extendedId), i).second) {
+                cds_warn("ISO-TP rx id 0x{:x} used by more than one channel, only the first one receives",
+                    config.rxId);
+            }
+            _channels.push_back(std::make_unique<IsoTpChannel>(config, callbacks));
+        }
+    }
+
+    /**
+    *   @brief  Stops pacing of consecutive frames not sent yet
+    */
+    void cancelBlocks()
+    {
+        for (auto& entry : _blocks) {
+            _scheduler.remove(entry);
+            entry = TxScheduler::kInvalidEntry;
+        }
+        std::fill(_blockFrames.begin(), _blockFrames.end(), 0);
+    }
+
+    /**
+    *   @brief  Counts paced consecutive frames that were emitted, channel is told when its whole block went out.
+    *           Frames of one block are delivered in order and channel has one block in flight at most.
+    */
+    void framesSent(const QVector<QCanBusFrame>& frames)
+    {
+        for (const auto& frame : frames) {
+            for (std::size_t i = 0; i < _channelConfigs.size(); ++i) {
+                const IsoTpChannelConfig& config = _channelConfigs[i];
+
+                if ((_blockFrames[i] > 0) && (frame.frameId() == config.txId)
+                    && (frame.hasExtendedFrameFormat() == config.extendedId)) {
+                    if (--_blockFrames[i] == 0) {
+                        _blocks[i] = TxScheduler::kInvalidEntry;
+                        _channels[i]->blockSent();
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    IsoTpChannel* channelForRx(const CanFrameRecord& rec) const
+    {
+        const auto it = _byRxId.find(key(rec.id, rec.hasFlag(CanFrameRecord::ExtendedId)));
+
+        return (it != _byRxId.end()) ? _channels[it->second].get() : nullptr;
+    }
+
+    IsoTpChannel* channelForTx(quint32 txId) const
+    {
+        for (const auto& channel : _channels) {
+            if (channel->config().txId == txId) {
+                return channel.get();
+            }
+        }
+
+        return nullptr;
+    }
+
+    static quint32 key(quint32 id, bool extended)
+    {
+        // Same flag as CAN_EFF_FLAG, base and extended id spaces are distinct
+        return extended ? (id | 0x80000000U) : id;
+    }
+
+    std::vector<IsoTpChannelConfig> _channelConfigs; // front() holds parameters common to all channels
+    std::vector<std::unique_ptr<IsoTpChannel>> _channels;
+    std::unordered_map<quint32, std::size_t> _byRxId;
+    std::vector<TxScheduler::EntryId> _blocks; // block of consecutive frames being paced, per channel
+    std::vector<int> _blockFrames; // frames of paced block not emitted yet, per channel
+    TxScheduler _scheduler;
+    QTimer _timeoutTimer;
+
+private:
+    IsoTp* q_ptr;
+};
+
+#endif // ISOTP_P_H
@@ -0,0 +1,401 @@
+#include "isotpchannel.h"
+#include <algorithm>
+#include <cstring>
+
+constexpr quint64 IsoTpChannel::kTimeoutUs;
+constexpr quint32 IsoTpChannel::kMaxShortPduLength;
+
+namespace {
+// Longest PDU fitting into single frame with given TX_DL
+quint32 singleFrameCapacity(int dataLength)
+{
+    return (dataLength > 8) ? static_cast<quint32>(dataLength - 2) : 7;
+}
+
+void appendLength32(QByteArray& payload, quint32 length)
+{
+    payload.append(static_cast<char>(length >> 24));
+    payload.append(static_cast<char>(length >> 16));
+    payload.append(static_cast<char>(length >> 8));
+    payload.append(static_cast<char>(length));
+}
+} // namespace
+
+IsoTpChannel::IsoTpChannel(const IsoTpChannelConfig& config, const Callbacks& callbacks)
+    : _config(config)
+    , _callbacks(callbacks)
+    , _txDataLength(config.canFd ? CanFrameRecord::kMaxPayload : 8)
+    , _rxBuffer(config.maxPduLength)
+{
+    _txBuffer.reserve(std::min(config.maxPduLength, kMaxShortPduLength));
+}
+
+const IsoTpChannelConfig& IsoTpChannel::config() const
+{
+    return _config;
+}
+
+bool IsoTpChannel::send(const quint8* data, quint32 length)
+{
+    if (isSending()) {
+        fail(IsoTpError::Busy);
+        return false;
+    }
+
+    // Long first frame form carries 32 bit length, classic frames are limited by 12 bit one
+    const quint32 maxLength = _config.canFd ? 0xffffffff : kMaxShortPduLength;
+    if ((length == 0) || (length > maxLength)) {
+        fail(IsoTpError::Overflow);
+        return false;
+    }
+
+    QByteArray payload;
+    payload.reserve(_txDataLength);
+
+    if (length <= singleFrameCapacity(_txDataLength)) {
+        if (length <= 7) {
+            payload.append(static_cast<char>((SingleFrame << 4) | length));
+        } else {
+            // CAN FD escape sequence, length in the second byte
+            payload.append(static_cast<char>(SingleFrame << 4));
+            payload.append(static_cast<char>(length));
+        }
+        payload.append(reinterpret_cast<const char*>(data), static_cast<int>(length));
+        _callbacks.sendFrame(makeFrame(payload));
+
+        return true;
+    }
+
+    if (length <= kMaxShortPduLength) {
+        payload.append(static_cast<char>((FirstFrame << 4) | (length >> 8)));
+        payload.append(static_cast<char>(length));
+    } else {
+        payload.append(static_cast<char>(FirstFrame << 4));
+        payload.append('\0');
+        appendLength32(payload, length);
+    }
+
+    _txBuffer.assign(data, data + length);
+    _txOffset = static_cast<quint32>(_txDataLength - payload.size());
+    payload.append(reinterpret_cast<const char*>(data), static_cast<int>(_txOffset));
+    _txSequence = 1;
+    _waitingForFlowControl = true;
+    _txDeadline = canTimestampNow() + kTimeoutUs;
+    _callbacks.sendFrame(makeFrame(payload));
+
+    return true;
+}
+
+bool IsoTpChannel::receive(const CanFrameRecord& rec)
+{
+    if ((rec.id != _config.rxId) || (rec.hasFlag(CanFrameRecord::ExtendedId) != _config.extendedId)
+        || (rec.direction() != Direction::RX) || rec.hasFlag(CanFrameRecord::Remote)
+        || rec.hasFlag(CanFrameRecord::Error)) {
+        return false;
+    }
+
+    if (rec.length == 0) {
+        fail(IsoTpError::InvalidFrame);
+        return true;
+    }
+
+    switch (rec.payload[0] >> 4) {
+    case SingleFrame:
+        receiveSingle(rec);
+        break;
+
+    case FirstFrame:
+        receiveFirst(rec);
+        break;
+
+    case ConsecutiveFrame:
+        receiveConsecutive(rec);
+        break;
+
+    case FlowControl:
+        receiveFlowControl(rec);
+        break;
+
+    default:
+        // Reserved PCI types are ignored
+        break;
+    }
+
+    return true;
+}
+
+void IsoTpChannel::expire(quint64 now)
+{
+    if (_receiving && (now > _rxDeadline)) {
+        _receiving = false;
+        fail(IsoTpError::ConsecutiveFrameTimeout);
+    }
+
+    if (_waitingForFlowControl && (now > _txDeadline)) {
+        _waitingForFlowControl = false;
+        _txBuffer.clear();
+        fail(IsoTpError::FlowControlTimeout);
+    }
+}
+
+void IsoTpChannel::reset()
+{
+    _receiving = false;
+    _waitingForFlowControl = false;
+    _blockPending = false;
+    _txBuffer.clear();
+}
+
+void IsoTpChannel::blockSent()
+{
+    _blockPending = false;
+}
+
+bool IsoTpChannel::isSending() const
+{
+    // Next PDU must not overtake consecutive frames still waiting in scheduler of owner
+    return _waitingForFlowControl || _blockPending;
+}
+
+bool IsoTpChannel::isReceiving() const
+{
+    return _receiving;
+}
+
+std::chrono::microseconds IsoTpChannel::separationTime(quint8 stMin)
+{
+    if (stMin <= 0x7f) {
+        return std::chrono::milliseconds(stMin);
+    }
+
+    if ((stMin >= 0xf1) && (stMin <= 0xf9)) {
+        return std::chrono::microseconds((stMin - 0xf0) * 100);
+    }
+
+    // Reserved values are to be treated as the longest separation
+    return std::chrono::milliseconds(0x7f);
+}
+
+void IsoTpChannel::receiveSingle(const CanFrameRecord& rec)
+{
+    quint32 length = rec.payload[0] & 0x0f;
+    int offset = 1;
+
+    if ((length == 0) && (rec.length > 8)) {
+        length = rec.payload[1];
+        offset = 2;
+    }
+
+    if ((length == 0) || (length > static_cast<quint32>(rec.length - offset))) {
+        fail(IsoTpError::InvalidFrame);
+        return;
+    }
+
+    if (_receiving) {
+        // New message terminates the one being received
+        _receiving = false;
+        fail(IsoTpError::UnexpectedFrame);
+    }
+
+    if (length > _rxBuffer.size()) {
+        fail(IsoTpError::Overflow);
+        return;
+    }
+
+    std::memcpy(_rxBuffer.data(), rec.payload + offset, length);
+    _rxLength = length;
+    deliver(rec.timestamp);
+}
+
+void IsoTpChannel::receiveFirst(const CanFrameRecord& rec)
+{
+    quint32 length = (static_cast<quint32>(rec.payload[0] & 0x0f) << 8) | rec.payload[1];
+    int offset = 2;
+
+    if (rec.length < 8) {
+        fail(IsoTpError::InvalidFrame);
+        return;
+    }
+
+    if (length == 0) {
+        length = (static_cast<quint32>(rec.payload[2]) << 24) | (static_cast<quint32>(rec.payload[3]) << 16)
+            | (static_cast<quint32>(rec.payload[4]) << 8) | rec.payload[5];
+        offset = 6;
+    }
+
+    const quint32 available = static_cast<quint32>(rec.length - offset);
+    if (length <= available) {
+        // Would have fit into single frame
+        fail(IsoTpError::InvalidFrame);
+        return;
+    }
+
+    if (_receiving) {
+        _receiving = false;
+        fail(IsoTpError::UnexpectedFrame);
+    }
+
+    if (length > _rxBuffer.size()) {
+        sendFlowControl(Overflow);
+        fail(IsoTpError::Overflow);
+        return;
+    }
+
+    std::memcpy(_rxBuffer.data(), rec.payload + offset, available);
+    _rxLength = length;
+    _rxOffset = available;
+    _rxSequence = 1;
+    _rxBlockCount = 0;
+    _receiving = true;
+    _rxDeadline = canTimestampNow() + kTimeoutUs;
+    sendFlowControl(ContinueToSend);
+}
+
+void IsoTpChannel::receiveConsecutive(const CanFrameRecord& rec)
+{
+    if (!_receiving) {
+        // Not addressed to us or left from aborted transfer
+        return;
+    }
+
+    if ((rec.payload[0] & 0x0f) != _rxSequence) {
+        _receiving = false;
+        fail(IsoTpError::WrongSequence);
+        return;
+    }
+
+    const quint32 length = std::min(_rxLength - _rxOffset, static_cast<quint32>(rec.length - 1));
+
+    std::memcpy(_rxBuffer.data() + _rxOffset, rec.payload + 1, length);
+    _rxOffset += length;
+
+    if (_rxOffset == _rxLength) {
+        _receiving = false;
+        deliver(rec.timestamp);
+        return;
+    }
+
+    _rxSequence = (_rxSequence + 1) & 0x0f;
+    _rxDeadline = canTimestampNow() + kTimeoutUs;
+
+    if ((_config.blockSize > 0) && (++_rxBlockCount == _config.blockSize)) {
+        _rxBlockCount = 0;
+        sendFlowControl(ContinueToSend);
+    }
+}
+
+void IsoTpChannel::receiveFlowControl(const CanFrameRecord& rec)
+{
+    if (!_waitingForFlowControl) {
+        return;
+    }
+
+    if (rec.length < 3) {
+        fail(IsoTpError::InvalidFrame);
+        return;
+    }
+
+    switch (rec.payload[0] & 0x0f) {
+    case ContinueToSend:
+        sendNextBlock(rec.payload[1], separationTime(rec.payload[2]));
+        break;
+
+    case Wait:
+        _txDeadline = canTimestampNow() + kTimeoutUs;
+        break;
+
+    case Overflow:
+        _waitingForFlowControl = false;
+        _txBuffer.clear();
+        fail(IsoTpError::Overflow);
+        break;
+
+    default:
+        _waitingForFlowControl = false;
+        _txBuffer.clear();
+        fail(IsoTpError::InvalidFrame);
+        break;
+    }
+}
+
+void IsoTpChannel::sendFlowControl(FlowStatus status)
+{
+    QByteArray payload;
+
+    payload.append(static_cast<char>((FlowControl << 4) | status));
+    payload.append(static_cast<char>(_config.blockSize));
+    payload.append(static_cast<char>(_config.stMin));
+    _callbacks.sendFrame(makeFrame(payload));
+}
+
+void IsoTpChannel::sendNextBlock(int blockSize, std::chrono::microseconds separation)
+{
+    const quint32 total = static_cast<quint32>(_txBuffer.size());
+    const quint32 chunk = static_cast<quint32>(_txDataLength - 1);
+    QVector<QCanBusFrame> block;
+
+    while ((_txOffset < total) && ((blockSize == 0) || (block.size() < blockSize))) {
+        const quint32 length = std::min(chunk, total - _txOffset);
+        QByteArray payload;
+
+        payload.reserve(_txDataLength);
+        payload.append(static_cast<char>((ConsecutiveFrame << 4) | _txSequence));
+        payload.append(reinterpret_cast<const char*>(_txBuffer.data() + _txOffset), static_cast<int>(length));
+        block.append(makeFrame(payload));
+
+        _txOffset += length;
+        _txSequence = (_txSequence + 1) & 0x0f;
+    }
+
+    if (_txOffset == total) {
+        _waitingForFlowControl = false;
+        _txBuffer.clear();
+    } else {
+        // Receiver answers after the whole block, which takes at least block separation to be sent
+        _txDeadline = canTimestampNow() + kTimeoutUs
+            + static_cast<quint64>(separation.count()) * static_cast<quint64>(block.size());
+    }
+
+    _blockPending = !block.isEmpty();
+    _callbacks.sendBlock(block, separation);
+}
+
+void IsoTpChannel::deliver(quint64 timestamp)
+{
+    if (_callbacks.pduReceived) {
+        _callbacks.pduReceived(IsoTpPdu{ _config.rxId, _config.txId, _rxBuffer.data(), _rxLength, timestamp });
+    }
+}
+
+void IsoTpChannel::fail(IsoTpError error)
+{
+    if (_callbacks.failed) {
+        _callbacks.failed(error);
+    }
+}
+
+QCanBusFrame IsoTpChannel::makeFrame(QByteArray& payload) const
+{
+    const char padding = static_cast<char>((_config.padding >= 0) ? _config.padding : 0xcc);
+    int length = payload.size();
+
+    if ((_config.padding >= 0) && (length < 8)) {
+        length = 8;
+    }
+    if (_config.canFd) {
+        // FD frames carry only DLC step lengths, padding is mandatory there
+        length = canFdLength(length);
+    }
+    payload.append(QByteArray(length - payload.size(), padding));
+
+    QCanBusFrame frame(_config.txId, payload);
+    frame.setExtendedFrameFormat(_config.extendedId);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    frame.setFlexibleDataRateFormat(_config.canFd);
+#endif
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    frame.setBitrateSwitch(_config.canFd);
+#endif
+
+    return frame;
+}
@@ -0,0 +1,133 @@
+#ifndef ISOTPCHANNEL_H
+#define ISOTPCHANNEL_H
+
+#include <QtCore/QVector>
+#include <QtSerialBus/QCanBusFrame>
+#include <canframerecord.h>
+#include <chrono>
+#include <functional>
+#include <isotppdu.h>
+#include <vector>
+
+/**
+*   @brief  Parameters of ISO-TP channel (normal addressing)
+*/
+struct IsoTpChannelConfig {
+    quint32 rxId{ 0x7e8 };
+    quint32 txId{ 0x7e0 };
+    bool extendedId{ false };
+    bool canFd{ false }; // transmit with CAN FD frames, TX_DL 64
+    quint8 blockSize{ 0 }; // BS announced to sender, 0 lets it send all consecutive frames at once
+    quint8 stMin{ 0 }; // STmin announced to sender, raw ISO 15765-2 encoding
+    int padding{ 0xcc }; // value of unused bytes of classic frames, -1 sends frames of minimal length
+    quint32 maxPduLength{ 4095 }; // size of reassembly buffer, above 4095 requires long first frame form
+};
+
+/**
+*   @brief  Segmentation and reassembly of ISO-TP messages of single rx/tx id pair
+*
+*   Reassembly buffer of maxPduLength bytes is allocated with the channel, consecutive frames are copied straight
+*   to their place in it and completed PDU is handed out as a view (see IsoTpPdu). Received single, first and
+*   consecutive frames are answered with flow control frames according to blockSize.
+*
+*   Segmented transmission waits for flow control of receiver and then passes whole block of consecutive frames
+*   together with separation time requested by receiver, so pacing is left to precise scheduler of the owner.
+*   Owner reports with blockSent when the last frame of block went out, channel is busy until then.
+*   Frames are exchanged through callbacks, channel itself has no timers. Timeouts are checked with expire,
+*   which owner calls periodically.
+*/
+class IsoTpChannel {
+public:
+    // N_Bs and N_Cr of ISO 15765-2
+    static constexpr quint64 kTimeoutUs = 1000000;
+    static constexpr quint32 kMaxShortPduLength = 4095;
+
+    struct Callbacks {
+        std::function<void(const QCanBusFrame&)> sendFrame; // single, first and flow control frames
+        // Consecutive frames of one block, to be sent at least separation apart
+        std::function<void(const QVector<QCanBusFrame>&, std::chrono::microseconds separation)> sendBlock;
+        std::function<void(const IsoTpPdu&)> pduReceived;
+        std::function<void(IsoTpError)> failed;
+    };
+
+    IsoTpChannel(const IsoTpChannelConfig& config, const Callbacks& callbacks);
+
+    const IsoTpChannelConfig& config() const;
+
+    /**
+    *   @brief  Starts transmission of PDU
+    *   @param  data PDU bytes, copied to transmit buffer
+    *   @param  length PDU length in bytes
+    *   @return false if previous PDU is still being sent or PDU is empty or too long
+    */
+    bool send(const quint8* data, quint32 length);
+
+    /**
+    *   @brief  Handles frame received on rxId (data and flow control of both directions)
+    *   @return false if frame does not belong to channel
+    */
+    bool receive(const CanFrameRecord& rec);
+
+    /**
+    *   @brief  Aborts transfers that waited for peer longer than kTimeoutUs
+    *   @param  now current time, see canTimestampNow
+    */
+    void expire(quint64 now);
+
+    /**
+    *   @brief  Drops transfers in progress in both directions, nothing is reported
+    */
+    void reset();
+
+    /**
+    *   @brief  Reports that the last frame of block passed to sendBlock callback was emitted. Called by owner, may
+    *           be called from the callback itself if frames are emitted right away.
+    */
+    void blockSent();
+
+    /**
+    *   @return true while PDU waits for flow control or its consecutive frames are still being paced
+    */
+    bool isSending() const;
+    bool isReceiving() const;
+
+    /**
+    *   @brief  Time between consecutive frames encoded by STmin byte of flow control frame
+    */
+    static std::chrono::microseconds separationTime(quint8 stMin);
+
+private:
+    enum FrameType { SingleFrame = 0, FirstFrame = 1, ConsecutiveFrame = 2, FlowControl = 3 };
+    enum FlowStatus { ContinueToSend = 0, Wait = 1, Overflow = 2 };
+
+    void receiveSingle(const CanFrameRecord& rec);
+    void receiveFirst(const CanFrameRecord& rec);
+    void receiveConsecutive(const CanFrameRecord& rec);
+    void receiveFlowControl(const CanFrameRecord& rec);
+    void sendFlowControl(FlowStatus status);
+    void sendNextBlock(int blockSize, std::chrono::microseconds separation);
+    void deliver(quint64 timestamp);
+    void fail(IsoTpError error);
+    QCanBusFrame makeFrame(QByteArray& payload) const;
+
+    const IsoTpChannelConfig _config;
+    const Callbacks _callbacks;
+    const int _txDataLength; // TX_DL, 8 or 64
+
+    std::vector<quint8> _rxBuffer;
+    quint32 _rxLength{ 0 };
+    quint32 _rxOffset{ 0 };
+    quint8 _rxSequence{ 0 };
+    int _rxBlockCount{ 0 };
+    bool _receiving{ false };
+    quint64 _rxDeadline{ 0 };
+
+    std::vector<quint8> _txBuffer;
+    quint32 _txOffset{ 0 };
+    quint8 _txSequence{ 0 };
+    bool _waitingForFlowControl{ false };
+    bool _blockPending{ false }; // block passed to sendBlock was not reported sent yet
+    quint64 _txDeadline{ 0 };
+};
+
+#endif // ISOTPCHANNEL_H
@@ -0,0 +1,78 @@
+#include "merge.h"
+#include "merge_p.h"
+
+constexpr int Merge::kMaxChannels;
+constexpr double Merge::kDefaultReorderWindow;
+
+Merge::Merge()
+    : d_ptr(new MergePrivate(this))
+{
+}
+
+Merge::~Merge()
+{
+}
+
+void Merge::setConfig(QJsonObject& json)
+{
+    Q_D(Merge);
+
+    d->loadSettings(json);
+}
+
+QJsonObject Merge::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+int Merge::pendingFrames() const
+{
+    return d_ptr->pending();
+}
+
+quint64 Merge::lateFrames() const
+{
+    return d_ptr->late();
+}
+
+void Merge::channelReceived(int channel, const CanFrameBatch& frames)
+{
+    Q_D(Merge);
+
+    d->push(channel, frames);
+}
+
+void Merge::channelSent(int channel, bool status, const CanFrameBatch& frames)
+{
+    Q_D(Merge);
+
+    if (status) {
+        d->push(channel, frames);
+    }
+}
+
+void Merge::flush()
+{
+    Q_D(Merge);
+
+    d->release(true);
+}
+
+void Merge::startSimulation()
+{
+    Q_D(Merge);
+
+    d->reset();
+}
+
+void Merge::stopSimulation()
+{
+    Q_D(Merge);
+
+    d->release(true);
+    d->reset();
+}
@@ -0,0 +1,77 @@
+#ifndef MERGE_H
+#define MERGE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+
+class MergePrivate;
+
+/**
+*   @brief  Component merging frames of several channels into one stream ordered by timestamp
+*
+*   Every input is a channel, its frames are tagged with channel number (CanFrameRecord::channel, input index
+*   plus one) and queued. Frames are released by k-way heap merge of channel queues: the oldest queued frame goes
+*   first once every active channel has a frame queued (nothing older can arrive then) or once it is older than
+*   the newest frame seen by more than reorder window. Order of frames within channel is kept. Frames still
+*   queued when channels go quiet are released after reorder window of wall clock.
+*/
+class Merge : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(Merge)
+
+public:
+    static constexpr int kMaxChannels = 8;
+    static constexpr double kDefaultReorderWindow = 0.01;
+
+    Merge();
+    ~Merge();
+
+    /**
+    *   @brief  Supported keys: reorderWindow (seconds)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @return number of frames waiting for other channels
+    */
+    int pendingFrames() const;
+
+    /**
+    *   @return number of frames released after newer frame of other channel, i.e. arrived later than reorder window
+    */
+    quint64 lateFrames() const;
+
+signals:
+    /**
+    *   @brief  Frames of all channels in timestamp order
+    */
+    void framesMerged(const CanFrameBatch& frames);
+
+public slots:
+    /**
+    *   @param  channel input index, 0 to kMaxChannels - 1
+    */
+    void channelReceived(int channel, const CanFrameBatch& frames);
+    void channelSent(int channel, bool status, const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Releases all queued frames regardless of reorder window
+    */
+    void flush();
+
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<MergePrivate> d_ptr;
+};
+
+#endif // MERGE_H
@@ -0,0 +1,183 @@
+#ifndef MERGE_P_H
+#define MERGE_P_H
+
+#include "merge.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <log.h>
+#include <vector>
+
+class MergePrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(Merge)
+
+public:
+    MergePrivate(Merge* q)
+        : q_ptr(q)
+    {
+        _idleTimer.setSingleShot(true);
+        connect(&_idleTimer, &QTimer::timeout, this, [this] { release(true); });
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["reorderWindow"] = _windowUs / 1000000.0;
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        if (json.contains("reorderWindow")) {
+            const double seconds = json["reorderWindow"].toDouble(-1.0);
+
+            if (seconds >= 0.0) {
+                _windowUs = static_cast<quint64>(seconds * 1000000.0);
+            } else {
+                cds_warn("Invalid reorderWindow '{}', keeping {} s", seconds, _windowUs / 1000000.0);
+            }
+        }
+    }
+
+    void reset()
+    {
+        for (auto& queue : _queues) {
+            queue.clear();
+        }
+        _heap.clear();
+        _active = 0;
+        _queued = 0;
+        _pending = 0;
+        _newest = 0;
+        _lastReleased = 0;
+        _late = 0;
+        _idleTimer.stop();
+    }
+
+    void push(int channel, const CanFrameBatch& frames)
+    {
+        if ((channel < 0) || (channel >= Merge::kMaxChannels)) {
+            cds_warn("Invalid merge channel {}", channel);
+            return;
+        }
+
+        if (frames.isEmpty()) {
+            return;
+        }
+
+        auto& queue = _queues[static_cast<std::size_t>(channel)];
+        const bool wasEmpty = queue.empty();
+        const quint32 mask = 1u << channel;
+
+        for (const auto& rec : frames) {
+            queue.push_back(rec);
+            queue.back().channel = static_cast<quint16>(channel + 1);
+            _newest = std::max(_newest, rec.timestamp);
+        }
+
+        _pending += frames.size();
+        _active |= mask;
+        if (wasEmpty) {
+            _queued |= mask;
+            pushHead(channel);
+        }
+
+        release(false);
+
+        // Quiet channel would hold frames of the others forever
+        if (_pending > 0) {
+            _idleTimer.start(static_cast<int>(std::max<quint64>(_windowUs / 1000, 1)));
+        }
+    }
+
+    void release(bool all)
+    {
+        CanFrameBatch merged;
+
+        merged.reserve(_pending);
+
+        while (!_heap.empty()) {
+            const Head head = _heap.front();
+
+            // Heads of all active channels are known, so oldest of them is the oldest frame that can still come
+            if (!all && (_queued != _active) && (head.timestamp + _windowUs > _newest)) {
+                break;
+            }
+
+            std::pop_heap(_heap.begin(), _heap.end(), Later());
+            _heap.pop_back();
+
+            auto& queue = _queues[static_cast<std::size_t>(head.channel)];
+            const CanFrameRecord& rec = queue.front();
+
+            if (rec.timestamp < _lastReleased) {
+                ++_late;
+            } else {
+                _lastReleased = rec.timestamp;
+            }
+
+            merged.append(rec);
+            queue.pop_front();
+            --_pending;
+
+            if (queue.empty()) {
+                _queued &= ~(1u << head.channel);
+            } else {
+                pushHead(head.channel);
+            }
+        }
+
+        if (_pending == 0) {
+            _idleTimer.stop();
+        }
+
+        if (!merged.isEmpty()) {
+            emit q_func()->framesMerged(merged);
+        }
+    }
+
+    int pending() const
+    {
+        return _pending;
+    }
+
+    quint64 late() const
+    {
+        return _late;
+    }
+
+private:
+    struct Head {
+        quint64 timestamp;
+        int channel;
+    };
+
+    // Min-heap by timestamp, ties are resolved by channel to keep output deterministic
+    struct Later {
+        bool operator()(const Head& a, const Head& b) const
+        {
+            return (a.timestamp != b.timestamp) ? (a.timestamp > b.timestamp) : (a.channel > b.channel);
+        }
+    };
+
+    void pushHead(int channel)
+    {
+        _heap.push_back({ _queues[static_cast<std::size_t>(channel)].front().timestamp, channel });
+        std::push_heap(_heap.begin(), _heap.end(), Later());
+    }
+
+    std::array<std::deque<CanFrameRecord>, Merge::kMaxChannels> _queues;
+    std::vector<Head> _heap; // one entry per non-empty channel queue
+    quint32 _active{ 0 }; // channels that delivered frames since start
+    quint32 _queued{ 0 }; // channels with frames queued
+    int _pending{ 0 };
+    quint64 _newest{ 0 };
+    quint64 _lastReleased{ 0 };
+    quint64 _late{ 0 };
+    quint64 _windowUs{ static_cast<quint64>(Merge::kDefaultReorderWindow * 1000000.0) };
+    QTimer _idleTimer;
+    Merge* q_ptr;
+};
+
+#endif // MERGE_P_H
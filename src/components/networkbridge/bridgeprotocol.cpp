@@ -0,0 +1,243 @@
+#include "bridgeprotocol.h"
+#include <QtCore/QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#ifdef CDS_WITH_LZ4
+#include <lz4.h>
+#endif
+
+namespace BridgeProtocol {
+
+namespace {
+    void writeHeader(char* data, const Header& header)
+    {
+        Header le;
+
+        le.magic = qToLittleEndian(header.magic);
+        le.version = header.version;
+        le.flags = header.flags;
+        le.count = qToLittleEndian(header.count);
+        le.sequence = qToLittleEndian(header.sequence);
+        le.payloadSize = qToLittleEndian(header.payloadSize);
+        le.source = qToLittleEndian(header.source);
+        le.uncompressedSize = qToLittleEndian(header.uncompressedSize);
+        le.baseTimestamp = qToLittleEndian(header.baseTimestamp);
+        le.sendTimestamp = qToLittleEndian(header.sendTimestamp);
+
+        std::memcpy(data, &le, sizeof(le));
+    }
+} // namespace
+
+bool compressionSupported()
+{
+#ifdef CDS_WITH_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+Encoder::Encoder(int maxSize, bool compress)
+    : _maxSize(std::max(maxSize, kHeaderSize + kMaxFrameSize))
+    , _compress(compress && compressionSupported())
+{
+    _buffer.resize(_maxSize);
+}
+
+bool Encoder::append(const CanFrameRecord& rec)
+{
+    const int length = std::min<int>(rec.length, CanFrameRecord::kMaxPayload);
+
+    if ((_size + kFrameHeaderSize + length > _maxSize) || (_count == std::numeric_limits<quint16>::max())) {
+        return false;
+    }
+
+    if (_count == 0) {
+        // Buffer was shrunk to batch size by finish(), capacity is kept
+        _buffer.resize(_maxSize);
+        _baseTimestamp = rec.timestamp;
+    }
+
+    // Frames of one batch are microseconds apart, offset is clamped only for badly out of order records
+    const qint64 offset = qBound<qint64>(std::numeric_limits<qint32>::min(),
+        static_cast<qint64>(rec.timestamp - _baseTimestamp), std::numeric_limits<qint32>::max());
+    uchar* out = reinterpret_cast<uchar*>(_buffer.data()) + _size;
+
+    qToLittleEndian<qint32>(static_cast<qint32>(offset), out);
+    qToLittleEndian<quint32>(rec.id, out + 4);
+    out[8] = rec.flags;
+    out[9] = static_cast<uchar>(length);
+    std::memcpy(out + kFrameHeaderSize, rec.payload, static_cast<std::size_t>(length));
+
+    _size += kFrameHeaderSize + length;
+    ++_count;
+
+    return true;
+}
+
+bool Encoder::isEmpty() const
+{
+    return _count == 0;
+}
+
+const QByteArray& Encoder::finish(quint32 sequence, quint32 source, quint64 sendTimestamp)
+{
+    const int payloadSize = _size - kHeaderSize;
+    Header header{};
+
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.count = _count;
+    header.sequence = sequence;
+    header.payloadSize = static_cast<quint32>(payloadSize);
+    header.source = source;
+    header.uncompressedSize = static_cast<quint32>(payloadSize);
+    header.baseTimestamp = _baseTimestamp;
+    header.sendTimestamp = sendTimestamp;
+
+    _size = kHeaderSize;
+    _count = 0;
+
+#ifdef CDS_WITH_LZ4
+    if (_compress && (payloadSize > 0)) {
+        const int bound = LZ4_compressBound(payloadSize);
+
+        _compressed.resize(kHeaderSize + bound);
+        const int compressed = LZ4_compress_default(
+            _buffer.constData() + kHeaderSize, _compressed.data() + kHeaderSize, payloadSize, bound);
+
+        // Short batches of random payload do not compress, they are sent as they are
+        if ((compressed > 0) && (compressed < payloadSize)) {
+            header.flags |= Compressed;
+            header.payloadSize = static_cast<quint32>(compressed);
+            writeHeader(_compressed.data(), header);
+            _compressed.resize(kHeaderSize + compressed);
+
+            return _compressed;
+        }
+    }
+#endif
+
+    writeHeader(_buffer.data(), header);
+    _buffer.resize(kHeaderSize + payloadSize);
+
+    return _buffer;
+}
+
+bool readHeader(const char* data, Header& header)
+{
+    std::memcpy(&header, data, sizeof(header));
+
+    header.magic = qFromLittleEndian(header.magic);
+    header.count = qFromLittleEndian(header.count);
+    header.sequence = qFromLittleEndian(header.sequence);
+    header.payloadSize = qFromLittleEndian(header.payloadSize);
+    header.source = qFromLittleEndian(header.source);
+    header.uncompressedSize = qFromLittleEndian(header.uncompressedSize);
+    header.baseTimestamp = qFromLittleEndian(header.baseTimestamp);
+    header.sendTimestamp = qFromLittleEndian(header.sendTimestamp);
+
+    return (header.magic == kMagic) && (header.version == kVersion)
+        && (header.uncompressedSize <= static_cast<quint32>(header.count) * kMaxFrameSize);
+}
+
+bool decode(const char* data, const Header& header, CanFrameBatch& records, QByteArray& scratch)
+{
+    const uchar* in = reinterpret_cast<const uchar*>(data) + kHeaderSize;
+    int size = static_cast<int>(header.payloadSize);
+
+    if (header.flags & Compressed) {
+#ifdef CDS_WITH_LZ4
+        const int uncompressedSize = static_cast<int>(header.uncompressedSize);
+
+        scratch.resize(uncompressedSize);
+        if (LZ4_decompress_safe(reinterpret_cast<const char*>(in), scratch.data(), size, uncompressedSize)
+            != uncompressedSize) {
+            return false;
+        }
+
+        in = reinterpret_cast<const uchar*>(scratch.constData());
+        size = uncompressedSize;
+#else
+        Q_UNUSED(scratch);
+        return false;
+#endif
+    }
+
+    const uchar* end = in + size;
+    const int first = records.size();
+
+    // Records are value-initialized, so unused payload bytes stay zero
+    records.resize(first + header.count);
+    CanFrameRecord* out = records.data() + first;
+
+    for (int i = 0; i < header.count; ++i, ++out) {
+        if ((end - in < kFrameHeaderSize) || (in[9] > CanFrameRecord::kMaxPayload)
+            || (end - in < kFrameHeaderSize + in[9])) {
+            records.resize(first);
+            return false;
+        }
+
+        const qint64 offset = qFromLittleEndian<qint32>(in);
+
+        out->timestamp = header.baseTimestamp + static_cast<quint64>(offset);
+        out->id = qFromLittleEndian<quint32>(in + 4);
+        out->flags = in[8];
+        out->length = in[9];
+        std::memcpy(out->payload, in + kFrameHeaderSize, out->length);
+
+        in += kFrameHeaderSize + out->length;
+    }
+
+    if (in != end) {
+        records.resize(first);
+        return false;
+    }
+
+    return true;
+}
+
+bool SequenceTracker::update(quint32 source, quint32 sequence)
+{
+    if (!_started || (source != _source)) {
+        // First batch or sender restarted, nothing can be said about batches sent before
+        _started = true;
+        _source = source;
+        _expected = sequence + 1;
+        return true;
+    }
+
+    const qint32 diff = static_cast<qint32>(sequence - _expected);
+
+    if (diff >= 0) {
+        _lost += static_cast<quint64>(diff);
+        _expected = sequence + 1;
+        return true;
+    }
+
+    // Late batch was counted as lost when a newer one arrived
+    ++_reordered;
+    if (_lost > 0) {
+        --_lost;
+    }
+
+    return false;
+}
+
+void SequenceTracker::reset()
+{
+    *this = SequenceTracker();
+}
+
+quint64 SequenceTracker::lost() const
+{
+    return _lost;
+}
+
+quint64 SequenceTracker::reordered() const
+{
+    return _reordered;
+}
+
+} // namespace BridgeProtocol
@@ -0,0 +1,138 @@
+#ifndef BRIDGEPROTOCOL_H
+#define BRIDGEPROTOCOL_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QtGlobal>
+#include <canframerecord.h>
+#include <type_traits>
+
+/**
+*   @brief  Wire format of NetworkBridge
+*
+*   Every datagram (UDP) or message (TCP stream) carries batch of frames:
+*
+*       Header
+*       Frame[count]            <- LZ4 compressed as a whole if Compressed flag is set
+*
+*   Frame is encoded as 32-bit time offset from Header::baseTimestamp, 32-bit id, flags and length bytes followed
+*   by length bytes of payload, i.e. 10 bytes plus payload. Header carries per-sender sequence number, so that
+*   receiver can count lost and reordered batches, and wall clock of sender at send time, so that one-way latency
+*   can be estimated when clocks of hosts are synchronized (NTP, PTP).
+*
+*   All integers are little endian.
+*/
+namespace BridgeProtocol {
+
+constexpr quint32 kMagic = 0x424e4443; // "CDNB"
+constexpr quint8 kVersion = 1;
+constexpr int kFrameHeaderSize = 10;
+constexpr int kMaxFrameSize = kFrameHeaderSize + CanFrameRecord::kMaxPayload;
+
+enum Flags : quint8 { Compressed = 0x01 };
+
+struct Header {
+    quint32 magic;
+    quint8 version;
+    quint8 flags;
+    quint16 count; // number of frames
+    quint32 sequence;
+    quint32 payloadSize; // bytes following header, as sent (i.e. compressed size if compressed)
+    quint32 source; // random id of sender instance, changes when sender restarts
+    quint32 uncompressedSize; // size of encoded frames
+    quint64 baseTimestamp; // timestamp of the first frame, microseconds
+    quint64 sendTimestamp; // wall clock of sender when batch was sent, microseconds since epoch
+};
+
+constexpr int kHeaderSize = sizeof(Header);
+
+static_assert(std::is_trivially_copyable<Header>::value, "Header must be trivially copyable");
+static_assert(sizeof(Header) == 40, "Unexpected Header layout");
+
+/**
+*   @return true if LZ4 support was compiled in
+*/
+bool compressionSupported();
+
+/**
+*   @brief  Builds batches of frames in preallocated buffer
+*/
+class Encoder {
+public:
+    /**
+    *   @param  maxSize maximum size of batch including header
+    *   @param  compress compress batches with LZ4 if it makes them smaller (ignored if not supported)
+    */
+    Encoder(int maxSize, bool compress);
+
+    /**
+    *   @brief  Adds frame to current batch
+    *   @return false if batch has no room for frame, finish() it and try again
+    */
+    bool append(const CanFrameRecord& rec);
+
+    bool isEmpty() const;
+
+    /**
+    *   @brief  Completes current batch, next append() starts a new one
+    *   @param  sequence sequence number of batch
+    *   @param  source sender id
+    *   @param  sendTimestamp wall clock, microseconds since epoch
+    *   @return encoded batch, valid until next call of append() or finish()
+    */
+    const QByteArray& finish(quint32 sequence, quint32 source, quint64 sendTimestamp);
+
+private:
+    QByteArray _buffer;
+    QByteArray _compressed;
+    const int _maxSize;
+    const bool _compress;
+    int _size{ kHeaderSize };
+    quint16 _count{ 0 };
+    quint64 _baseTimestamp{ 0 };
+};
+
+/**
+*   @brief  Checks header of received data
+*   @param  data received bytes, at least kHeaderSize
+*   @param  header set to header in host byte order
+*   @return false if data does not start with valid header
+*/
+bool readHeader(const char* data, Header& header);
+
+/**
+*   @brief  Decodes batch and appends its frames to records
+*   @param  data complete batch, i.e. kHeaderSize + header.payloadSize bytes
+*   @param  header header read with readHeader()
+*   @param  records decoded frames are appended here
+*   @param  scratch buffer reused for decompression
+*   @return false if batch is malformed, records are not changed then
+*/
+bool decode(const char* data, const Header& header, CanFrameBatch& records, QByteArray& scratch);
+
+/**
+*   @brief  Counts lost and reordered batches from sequence numbers
+*/
+class SequenceTracker {
+public:
+    /**
+    *   @brief  Accounts received batch
+    *   @return false if batch is older than already received ones (late or duplicate)
+    */
+    bool update(quint32 source, quint32 sequence);
+
+    void reset();
+
+    quint64 lost() const;
+    quint64 reordered() const;
+
+private:
+    bool _started{ false };
+    quint32 _source{ 0 };
+    quint32 _expected{ 0 };
+    quint64 _lost{ 0 };
+    quint64 _reordered{ 0 };
+};
+
+} // namespace BridgeProtocol
+
+#endif // BRIDGEPROTOCOL_H
@@ -0,0 +1,85 @@
+#include "networkbridge.h"
+#include "networkbridge_p.h"
+
+constexpr int NetworkBridge::kDefaultMaxDatagramSize;
+constexpr int NetworkBridge::kMaxMessageSize;
+constexpr double NetworkBridge::kDefaultStatsInterval;
+constexpr qint64 NetworkBridgePrivate::kMaxTcpBacklog;
+constexpr int NetworkBridgePrivate::kReconnectIntervalMs;
+
+NetworkBridge::NetworkBridge()
+    : d_ptr(new NetworkBridgePrivate(this))
+{
+}
+
+NetworkBridge::~NetworkBridge()
+{
+}
+
+void NetworkBridge::setConfig(QJsonObject& json)
+{
+    Q_D(NetworkBridge);
+
+    d->loadSettings(json);
+}
+
+QJsonObject NetworkBridge::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+NetworkBridge::Stats NetworkBridge::stats() const
+{
+    return d_ptr->stats();
+}
+
+quint16 NetworkBridge::localPort() const
+{
+    return d_ptr->localPort();
+}
+
+bool NetworkBridge::compressionSupported()
+{
+    return BridgeProtocol::compressionSupported();
+}
+
+void NetworkBridge::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(NetworkBridge);
+
+    d->queue(frames);
+}
+
+void NetworkBridge::frameBatchSent(bool status, const CanFrameBatch& frames)
+{
+    Q_D(NetworkBridge);
+
+    if (status) {
+        d->queue(frames);
+    }
+}
+
+void NetworkBridge::flush()
+{
+    Q_D(NetworkBridge);
+
+    d->flush();
+}
+
+void NetworkBridge::startSimulation()
+{
+    Q_D(NetworkBridge);
+
+    d->start();
+}
+
+void NetworkBridge::stopSimulation()
+{
+    Q_D(NetworkBridge);
+
+    d->stop();
+}
@@ -0,0 +1,102 @@
+#ifndef NETWORKBRIDGE_H
+#define NETWORKBRIDGE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+
+class NetworkBridgePrivate;
+
+/**
+*   @brief  Component passing frames between CANdevStudio instances running on different hosts
+*
+*   Input takes frames the same way as views and loggers do (e.g. from CAN device) and forwards them to remote
+*   bridge. Frames received from remote bridge are emitted with their original timestamps and direction flags,
+*   so output can be consumed as if it were local CAN device. Frames are batched many per datagram or TCP message
+*   in compact binary form (see BridgeProtocol), optionally LZ4 compressed. Lost and reordered batches and
+*   one-way latency are accounted and logged.
+*/
+class NetworkBridge : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(NetworkBridge)
+
+public:
+    // Fits in single Ethernet frame together with IP and UDP headers
+    static constexpr int kDefaultMaxDatagramSize = 1400;
+    static constexpr int kMaxMessageSize = 65000;
+    static constexpr double kDefaultStatsInterval = 10.0;
+
+    enum class Transport { Udp, Tcp };
+
+    struct Stats {
+        quint64 framesSent;
+        quint64 framesReceived;
+        quint64 framesDropped; // not sent, e.g. TCP peer not connected or not keeping up
+        quint64 batchesSent;
+        quint64 batchesReceived;
+        quint64 batchesLost;
+        quint64 batchesReordered;
+        quint64 bytesSent;
+        quint64 bytesReceived;
+        quint64 decodeErrors;
+        qint64 latencyMinUs; // one-way, meaningful only if clocks of hosts are synchronized
+        qint64 latencyMaxUs;
+        double latencyAvgUs;
+    };
+
+    NetworkBridge();
+    ~NetworkBridge();
+
+    /**
+    *   @brief  Supported keys: transport ("udp" or "tcp"), localPort (port to listen on, 0 for any free port),
+    *           remoteHost, remotePort (peer frames are sent to), maxDatagramSize (bytes), compression (LZ4, if
+    *           compiled in), statsInterval (seconds between statistics logs, 0 for none). With TCP bridge connects
+    *           to remote host if one is set and accepts connection on local port otherwise.
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @return statistics since simulation start
+    */
+    Stats stats() const;
+
+    /**
+    *   @return port bridge listens on while simulation runs, 0 if none
+    */
+    quint16 localPort() const;
+
+    /**
+    *   @return true if LZ4 compression is supported by this build
+    */
+    static bool compressionSupported();
+
+signals:
+    /**
+    *   @brief  Frames received from remote bridge, direction flags of remote device are kept
+    */
+    void framesReceived(const CanFrameBatch& frames);
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Sends frames batched so far, done automatically once control returns to event loop
+    */
+    void flush();
+
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<NetworkBridgePrivate> d_ptr;
+};
+
+#endif // NETWORKBRIDGE_H
@@ -0,0 +1,469 @@
+#ifndef NETWORKBRIDGE_P_H
+#define NETWORKBRIDGE_P_H
+
+#include "bridgeprotocol.h"
+#include "networkbridge.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtNetwork/QHostInfo>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QUdpSocket>
+#include <algorithm>
+#include <limits>
+#include <log.h>
+#include <memory>
+#include <random>
+
+class NetworkBridgePrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(NetworkBridge)
+
+public:
+    // Data queued in TCP socket beyond this means that peer or network is not keeping up, new frames are dropped
+    static constexpr qint64 kMaxTcpBacklog = 4 * 1024 * 1024;
+    static constexpr int kReconnectIntervalMs = 1000;
+
+    NetworkBridgePrivate(NetworkBridge* q)
+        : q_ptr(q)
+    {
+        connect(&_udp, &QUdpSocket::readyRead, this, &NetworkBridgePrivate::readDatagrams);
+        connect(&_server, &QTcpServer::newConnection, this, &NetworkBridgePrivate::acceptConnection);
+        connect(&_statsTimer, &QTimer::timeout, this, &NetworkBridgePrivate::logStats);
+
+        _reconnectTimer.setSingleShot(true);
+        _reconnectTimer.setInterval(kReconnectIntervalMs);
+        connect(&_reconnectTimer, &QTimer::timeout, this, &NetworkBridgePrivate::connectToPeer);
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["transport"] = (_transport == NetworkBridge::Transport::Tcp) ? "tcp" : "udp";
+        json["localPort"] = _localPort;
+        json["remoteHost"] = _remoteHost;
+        json["remotePort"] = _remotePort;
+        json["maxDatagramSize"] = _maxDatagramSize;
+        json["compression"] = _compression;
+        json["statsInterval"] = _statsInterval;
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        if (json.contains("transport")) {
+            const QString transport = json["transport"].toString().toLower();
+
+            if ((transport == "udp") || (transport == "tcp")) {
+                _transport = (transport == "tcp") ? NetworkBridge::Transport::Tcp : NetworkBridge::Transport::Udp;
+            } else {
+                cds_warn("Invalid transport '{}', expected udp or tcp", transport.toStdString());
+            }
+        }
+
+        _localPort = port(json, "localPort", _localPort);
+        _remotePort = port(json, "remotePort", _remotePort);
+        _remoteHost = json["remoteHost"].toString(_remoteHost);
+
+        if (json.contains("maxDatagramSize")) {
+            const int size = json["maxDatagramSize"].toInt(-1);
+            const int minSize = BridgeProtocol::kHeaderSize + BridgeProtocol::kMaxFrameSize;
+
+            if ((size >= minSize) && (size <= NetworkBridge::kMaxMessageSize)) {
+                _maxDatagramSize = size;
+            } else {
+                cds_warn("Invalid maxDatagramSize '{}', expected {}-{}", size, minSize, NetworkBridge::kMaxMessageSize);
+            }
+        }
+
+        _compression = json["compression"].toBool(_compression);
+
+        if (json.contains("statsInterval")) {
+            const double interval = json["statsInterval"].toDouble(-1.0);
+
+            if (interval >= 0.0) {
+                _statsInterval = interval;
+            } else {
+                cds_warn("Invalid statsInterval '{}', keeping {} s", interval, _statsInterval);
+            }
+        }
+    }
+
+    void start()
+    {
+        stop();
+
+        _stats = NetworkBridge::Stats{};
+        _stats.latencyMinUs = std::numeric_limits<qint64>::max();
+        _stats.latencyMaxUs = std::numeric_limits<qint64>::min();
+        _latencySum = 0.0;
+        _tracker.reset();
+        _sequence = 0;
+        _source = std::random_device()();
+        _pendingFrames = 0;
+        _streamBuffer.clear();
+
+        if (_compression && !BridgeProtocol::compressionSupported()) {
+            cds_warn("LZ4 compression is not supported by this build, frames are sent uncompressed");
+        }
+
+        // Stream is not limited by datagram size, bigger batches mean fewer system calls
+        _encoder.reset(new BridgeProtocol::Encoder(
+            (_transport == NetworkBridge::Transport::Tcp) ? NetworkBridge::kMaxMessageSize : _maxDatagramSize,
+            _compression));
+
+        _remoteAddress = resolve(_remoteHost);
+
+        if (_transport == NetworkBridge::Transport::Udp) {
+            if (!_udp.bind(QHostAddress::Any, _localPort)) {
+                cds_error("Failed to bind UDP port {}: {}", _localPort, _udp.errorString().toStdString());
+            }
+        } else if (!_remoteHost.isEmpty()) {
+            connectToPeer();
+        } else if (!_server.listen(QHostAddress::Any, _localPort)) {
+            cds_error("Failed to listen on TCP port {}: {}", _localPort, _server.errorString().toStdString());
+        }
+
+        if (_statsInterval > 0.0) {
+            _statsTimer.start(static_cast<int>(_statsInterval * 1000));
+        }
+
+        _running = true;
+    }
+
+    void stop()
+    {
+        if (!_running) {
+            return;
+        }
+
+        sendBatch();
+        logStats();
+
+        _running = false;
+        _statsTimer.stop();
+        _reconnectTimer.stop();
+        _udp.close();
+        _server.close();
+        dropPeer();
+    }
+
+    void queue(const CanFrameBatch& frames)
+    {
+        if (!_running) {
+            return;
+        }
+
+        for (const auto& rec : frames) {
+            if (!_encoder->append(rec)) {
+                sendBatch();
+                _encoder->append(rec);
+            }
+            ++_pendingFrames;
+        }
+
+        // Everything queued until control returns to event loop goes in as few batches as possible
+        if (!_flushPending && !_encoder->isEmpty()) {
+            _flushPending = true;
+            QMetaObject::invokeMethod(q_func(), "flush", Qt::QueuedConnection);
+        }
+    }
+
+    void flush()
+    {
+        _flushPending = false;
+        sendBatch();
+    }
+
+    quint16 localPort() const
+    {
+        if (!_running) {
+            return 0;
+        }
+
+        return (_transport == NetworkBridge::Transport::Udp) ? _udp.localPort() : _server.serverPort();
+    }
+
+    NetworkBridge::Stats stats() const
+    {
+        NetworkBridge::Stats stats = _stats;
+        const quint64 received = _stats.batchesReceived;
+
+        stats.batchesLost = _tracker.lost();
+        stats.batchesReordered = _tracker.reordered();
+        stats.latencyAvgUs = received ? _latencySum / received : 0.0;
+        if (received == 0) {
+            stats.latencyMinUs = 0;
+            stats.latencyMaxUs = 0;
+        }
+
+        return stats;
+    }
+
+private slots:
+    void readDatagrams()
+    {
+        CanFrameBatch frames;
+
+        while (_udp.hasPendingDatagrams()) {
+            _rxBuffer.resize(static_cast<int>(std::max<qint64>(_udp.pendingDatagramSize(), 0)));
+
+            const qint64 size = _udp.readDatagram(_rxBuffer.data(), _rxBuffer.size());
+            BridgeProtocol::Header header;
+
+            if (size < 0) {
+                break;
+            }
+
+            if ((size < BridgeProtocol::kHeaderSize) || !BridgeProtocol::readHeader(_rxBuffer.constData(), header)
+                || (BridgeProtocol::kHeaderSize + header.payloadSize != static_cast<quint64>(size))) {
+                ++_stats.decodeErrors;
+                continue;
+            }
+
+            handleBatch(_rxBuffer.constData(), header, frames);
+        }
+
+        deliver(frames);
+    }
+
+    void readStream()
+    {
+        if (!_peer) {
+            return;
+        }
+
+        CanFrameBatch frames;
+        int offset = 0;
+
+        _streamBuffer.append(_peer->readAll());
+
+        while (_streamBuffer.size() - offset >= BridgeProtocol::kHeaderSize) {
+            BridgeProtocol::Header header;
+            const char* data = _streamBuffer.constData() + offset;
+
+            if (!BridgeProtocol::readHeader(data, header)
+                || (header.payloadSize > static_cast<quint32>(NetworkBridge::kMaxMessageSize))) {
+                // Message boundaries are lost, stream cannot be resynchronized
+                ++_stats.decodeErrors;
+                cds_error("Invalid data received from bridge peer, closing connection");
+                _streamBuffer.clear();
+                _peer->abort();
+                deliver(frames);
+                return;
+            }
+
+            const int size = BridgeProtocol::kHeaderSize + static_cast<int>(header.payloadSize);
+            if (_streamBuffer.size() - offset < size) {
+                break;
+            }
+
+            handleBatch(data, header, frames);
+            offset += size;
+        }
+
+        _streamBuffer.remove(0, offset);
+        deliver(frames);
+    }
+
+    void acceptConnection()
+    {
+        while (QTcpSocket* socket = _server.nextPendingConnection()) {
+            if (_peer) {
+                cds_warn("Bridge peer {} replaced by {}", _peer->peerAddress().toString().toStdString(),
+                    socket->peerAddress().toString().toStdString());
+            }
+
+            dropPeer();
+            setPeer(socket);
+            cds_info("Bridge peer {} connected", socket->peerAddress().toString().toStdString());
+        }
+    }
+
+    void connectToPeer()
+    {
+        dropPeer();
+
+        auto socket = new QTcpSocket(this);
+        setPeer(socket);
+        socket->connectToHost(_remoteAddress, _remotePort);
+    }
+
+    void peerDisconnected()
+    {
+        _streamBuffer.clear();
+
+        // Client keeps trying, server waits for the next connection
+        if (_running && !_remoteHost.isEmpty()) {
+            _reconnectTimer.start();
+        }
+    }
+
+    void logStats()
+    {
+        const NetworkBridge::Stats s = stats();
+
+        cds_info("Network bridge: sent {} frames in {} batches ({} dropped), received {} frames in {} batches, "
+                 "{} lost, {} reordered, {} invalid, latency min/avg/max {:.3f}/{:.3f}/{:.3f} ms",
+            s.framesSent, s.batchesSent, s.framesDropped, s.framesReceived, s.batchesReceived, s.batchesLost,
+            s.batchesReordered, s.decodeErrors, s.latencyMinUs / 1000.0, s.latencyAvgUs / 1000.0,
+            s.latencyMaxUs / 1000.0);
+    }
+
+private:
+    static quint16 port(const QJsonObject& json, const char* key, quint16 current)
+    {
+        if (!json.contains(key)) {
+            return current;
+        }
+
+        const int value = json[key].toInt(-1);
+        if ((value < 0) || (value > std::numeric_limits<quint16>::max())) {
+            cds_warn("Invalid {} '{}', keeping {}", key, value, current);
+            return current;
+        }
+
+        return static_cast<quint16>(value);
+    }
+
+    static QHostAddress resolve(const QString& host)
+    {
+        if (host.isEmpty()) {
+            return {};
+        }
+
+        QHostAddress address(host);
+        if (!address.isNull()) {
+            return address;
+        }
+
+        // Resolved once per simulation start, lookup does not happen on frame path
+        const QList<QHostAddress> addresses = QHostInfo::fromName(host).addresses();
+        if (addresses.isEmpty()) {
+            cds_error("Failed to resolve bridge peer '{}'", host.toStdString());
+            return {};
+        }
+
+        return addresses.front();
+    }
+
+    void setPeer(QTcpSocket* socket)
+    {
+        _peer = socket;
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::readyRead, this, &NetworkBridgePrivate::readStream);
+        connect(socket, &QTcpSocket::disconnected, this, &NetworkBridgePrivate::peerDisconnected);
+        connect(socket, static_cast<void (QAbstractSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error),
+            this, [this, socket](QAbstractSocket::SocketError) {
+                if ((socket == _peer) && (socket->state() == QAbstractSocket::UnconnectedState)) {
+                    peerDisconnected();
+                }
+            });
+    }
+
+    void dropPeer()
+    {
+        if (_peer) {
+            QTcpSocket* socket = _peer;
+
+            _peer = nullptr;
+            socket->disconnect(this);
+            socket->abort();
+            socket->deleteLater();
+        }
+    }
+
+    void sendBatch()
+    {
+        if (!_encoder || _encoder->isEmpty()) {
+            return;
+        }
+
+        const quint64 frames = _pendingFrames;
+        const QByteArray& batch = _encoder->finish(_sequence, _source, canTimestampNow());
+
+        _pendingFrames = 0;
+
+        if (!write(batch)) {
+            _stats.framesDropped += frames;
+            return;
+        }
+
+        ++_sequence;
+        ++_stats.batchesSent;
+        _stats.framesSent += frames;
+        _stats.bytesSent += static_cast<quint64>(batch.size());
+    }
+
+    bool write(const QByteArray& batch)
+    {
+        if (_transport == NetworkBridge::Transport::Udp) {
+            return !_remoteAddress.isNull() && (_udp.writeDatagram(batch, _remoteAddress, _remotePort) == batch.size());
+        }
+
+        if (!_peer || (_peer->state() != QAbstractSocket::ConnectedState) || (_peer->bytesToWrite() > kMaxTcpBacklog)) {
+            return false;
+        }
+
+        return _peer->write(batch) == batch.size();
+    }
+
+    void handleBatch(const char* data, const BridgeProtocol::Header& header, CanFrameBatch& frames)
+    {
+        if (!BridgeProtocol::decode(data, header, frames, _scratch)) {
+            ++_stats.decodeErrors;
+            return;
+        }
+
+        const qint64 latency = static_cast<qint64>(canTimestampNow() - header.sendTimestamp);
+
+        _tracker.update(header.source, header.sequence);
+        ++_stats.batchesReceived;
+        _stats.framesReceived += header.count;
+        _stats.bytesReceived += static_cast<quint64>(BridgeProtocol::kHeaderSize) + header.payloadSize;
+        _stats.latencyMinUs = std::min(_stats.latencyMinUs, latency);
+        _stats.latencyMaxUs = std::max(_stats.latencyMaxUs, latency);
+        _latencySum += static_cast<double>(latency);
+    }
+
+    void deliver(const CanFrameBatch& frames)
+    {
+        if (!frames.isEmpty()) {
+            emit q_func()->framesReceived(frames);
+        }
+    }
+
+public:
+    NetworkBridge::Transport _transport{ NetworkBridge::Transport::Udp };
+    quint16 _localPort{ 0 };
+    QString _remoteHost;
+    quint16 _remotePort{ 0 };
+    int _maxDatagramSize{ NetworkBridge::kDefaultMaxDatagramSize };
+    bool _compression{ false };
+    double _statsInterval{ NetworkBridge::kDefaultStatsInterval };
+
+private:
+    bool _running{ false };
+    QUdpSocket _udp;
+    QTcpServer _server;
+    QPointer<QTcpSocket> _peer;
+    QHostAddress _remoteAddress;
+    QTimer _statsTimer;
+    QTimer _reconnectTimer;
+
+    std::unique_ptr<BridgeProtocol::Encoder> _encoder;
+    quint64 _pendingFrames{ 0 }; // frames in batch being built
+    bool _flushPending{ false };
+    quint32 _sequence{ 0 };
+    quint32 _source{ 0 };
+
+    QByteArray _rxBuffer;
+    QByteArray _streamBuffer;
+    QByteArray _scratch;
+    BridgeProtocol::SequenceTracker _tracker;
+    NetworkBridge::Stats _stats{};
+    double _latencySum{ 0.0 };
+
+    NetworkBridge* q_ptr;
+};
+
+#endif // NETWORKBRIDGE_P_H
@@ -0,0 +1,49 @@
+#include "busstatisticsmodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+
+BusStatisticsModel::BusStatisticsModel()
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "BusStatistics Node";
+    _name = "BusStatisticsModel";
+    _modelName = "Bus statistics";
+
+    connect(this, &BusStatisticsModel::frameBatchSent, &_component, &BusStatistics::frameBatchSent);
+    connect(this, &BusStatisticsModel::frameBatchReceived, &_component, &BusStatistics::frameBatchReceived);
+}
+
+unsigned int BusStatisticsModel::nPorts(PortType portType) const
+{
+    return (PortType::In == portType) ? 1 : 0;
+}
+
+NodeDataType BusStatisticsModel::dataType(PortType, PortIndex) const
+{
+    return CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> BusStatisticsModel::outData(PortIndex)
+{
+    return std::make_shared<CanRawViewDataIn>();
+}
+
+void BusStatisticsModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (nodeData) {
+        auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+        assert(nullptr != d);
+
+        if (d->direction() == Direction::TX) {
+            emit frameBatchSent(d->status(), d->records());
+        } else {
+            emit frameBatchReceived(d->records());
+        }
+    } else {
+        cds_warn("Incorrect nodeData");
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef BUSSTATISTICSMODEL_H
+#define BUSSTATISTICSMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <busstatistics.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+/**
+*   @brief The class provides node graphical representation of BusStatistics
+*/
+class BusStatisticsModel : public ComponentModel<BusStatistics, BusStatisticsModel> {
+    Q_OBJECT
+
+public:
+    BusStatisticsModel();
+    virtual ~BusStatisticsModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 if port in, 0 if any other type
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return same type as CanRawView input, so statistics can be connected wherever raw view can
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation, not used in this class
+    *   @param  port id
+    *   @return
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes frames to BusStatistics
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    /**
+    *   @brief  Emits signal once per received batch of CAN frames
+    *   @param frames Received frames
+    */
+    void frameBatchReceived(const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Emits signal once per transmitted batch of CAN frames
+    *   @param status true if frames have been sent successfuly
+    *   @param frames Transmitted frames
+    */
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+};
+
+#endif // BUSSTATISTICSMODEL_H
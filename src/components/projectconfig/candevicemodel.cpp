@@ -1,7 +1,8 @@
 #include "candevicemodel.h"
 #include <assert.h>
-#include <datamodeltypes/candevicedata.h>
+#include <datamodeltypes/nodedatacast.h>
 #include <log.h>
+#include <poolallocator.h>
 
 CanDeviceModel::CanDeviceModel()
 {
@@ -9,15 +10,14 @@ CanDeviceModel::CanDeviceModel()
     _label->setFixedSize(75, 25);
     _label->setAttribute(Qt::WA_TranslucentBackground);
 
-    connect(&_component, &CanDevice::frameSent, this, &CanDeviceModel::frameSent);
-    connect(&_component, &CanDevice::frameReceived, this, &CanDeviceModel::frameReceived);
+    connect(&_component, &CanDevice::frameBatchSent, this, &CanDeviceModel::frameBatchSent);
+    connect(&_component, &CanDevice::frameBatchReceived, this, &CanDeviceModel::frameBatchReceived);
     connect(this, &CanDeviceModel::sendFrame, &_component, &CanDevice::sendFrame);
+    connect(this, &CanDeviceModel::sendFrames, &_component, &CanDevice::sendFrames);
 
     _caption = "CanDevice Node";
     _name = "CanDeviceModel";
     _modelName = "CAN device";
-
-    _component.init("socketcan", "can0"); // TODO
 }
 
 unsigned int CanDeviceModel::nPorts(PortType portType) const
@@ -29,20 +29,83 @@ unsigned int CanDeviceModel::nPorts(PortType portType) const
 
 void CanDeviceModel::frameOnQueue()
 {
-    std::tie(_frame, _direction, _status) = _frameQueue.takeFirst();
-    emit dataUpdated(0); // Data ready on port 0
+    _flushPending = false;
+
+    while (!_frameQueue.empty()) {
+        // Group consecutive frames of the same kind (RX, TX ok, TX failed)
+        const quint8 kind = _frameQueue.front().flags & (CanFrameRecord::Tx | CanFrameRecord::TxFailed);
+        CanFrameBatch batch;
+        CanFrameRecord rec;
+
+        batch.reserve(static_cast<int>(_frameQueue.size()));
+        while (!_frameQueue.empty()
+            && ((_frameQueue.front().flags & (CanFrameRecord::Tx | CanFrameRecord::TxFailed)) == kind)) {
+            _frameQueue.pop(rec);
+            batch.append(rec);
+        }
+
+        const Direction direction = (kind & CanFrameRecord::Tx) ? Direction::TX : Direction::RX;
+        const bool status = (direction == Direction::TX) && !(kind & CanFrameRecord::TxFailed);
+
+        _nodeData = Pool::makeShared<CanDeviceDataOut>(batch, direction, status);
+        emit dataUpdated(0); // Data ready on port 0
+    }
+}
+
+void CanDeviceModel::queueFrames(const QVector<QCanBusFrame>& frames, Direction direction, bool status)
+{
+    if (_flowPlanActive) {
+        // All consumers are called directly by FlowPlan
+        return;
+    }
+
+    for (const auto& frame : frames) {
+        auto rec = toCanFrameRecord(frame, direction);
+
+        if ((direction == Direction::TX) && !status) {
+            rec.flags |= CanFrameRecord::TxFailed;
+        }
+
+        if (!_frameQueue.pushOverwrite(rec)) {
+            ++_droppedFrames;
+        }
+    }
+
+    // Coalesce notifications. Everything queued until control returns to event loop is propagated at once.
+    if (!_flushPending) {
+        _flushPending = true;
+        QMetaObject::invokeMethod(this, "frameOnQueue", Qt::QueuedConnection);
+    }
+}
+
+void CanDeviceModel::setAcceptanceFilters(const CanFilterList& filters)
+{
+    _component.setAcceptanceFilters(filters);
+}
+
+quint64 CanDeviceModel::droppedFrames() const
+{
+    return _droppedFrames;
 }
 
 void CanDeviceModel::frameReceived(const QCanBusFrame& frame)
 {
-    _frameQueue.push_back(std::make_tuple(frame, Direction::RX, false));
-    frameOnQueue();
+    frameBatchReceived({ frame });
 }
 
 void CanDeviceModel::frameSent(bool status, const QCanBusFrame& frame)
 {
-    _frameQueue.push_back(std::make_tuple(frame, Direction::TX, status));
-    frameOnQueue();
+    frameBatchSent(status, { frame });
+}
+
+void CanDeviceModel::frameBatchReceived(const QVector<QCanBusFrame>& frames)
+{
+    queueFrames(frames, Direction::RX, false);
+}
+
+void CanDeviceModel::frameBatchSent(bool status, const QVector<QCanBusFrame>& frames)
+{
+    queueFrames(frames, Direction::TX, status);
 }
 
 NodeDataType CanDeviceModel::dataType(PortType portType, PortIndex) const
@@ -54,15 +117,29 @@ NodeDataType CanDeviceModel::dataType(PortType portType, PortIndex) const
 
 std::shared_ptr<NodeData> CanDeviceModel::outData(PortIndex)
 {
-    return std::make_shared<CanDeviceDataOut>(_frame, _direction, _status);
+    return _nodeData;
 }
 
 void CanDeviceModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
 {
     if (nodeData) {
-        auto d = std::dynamic_pointer_cast<CanDeviceDataIn>(nodeData);
+        auto d = nodeDataCast<CanDeviceDataIn>(nodeData);
         assert(nullptr != d);
-        emit sendFrame(d->frame());
+        const auto& records = d->records();
+
+        if (records.size() == 1) {
+            emit sendFrame(d->frame());
+        } else if (!records.isEmpty()) {
+            // Batches (e.g. trace replay) go to device in one call
+            QVector<QCanBusFrame> frames;
+
+            frames.reserve(records.size());
+            for (const auto& rec : records) {
+                frames.append(toQCanBusFrame(rec));
+            }
+
+            emit sendFrames(frames);
+        }
     } else {
         cds_warn("Incorrect nodeData");
     }
@@ -5,14 +5,14 @@
 #include <QtCore/QObject>
 #include <QtSerialBus/QCanBusFrame>
 #include <candevice.h>
+#include <datamodeltypes/candevicedata.h>
+#include <ringbuffer.h>
 
 using QtNodes::PortType;
 using QtNodes::PortIndex;
 using QtNodes::NodeData;
 using QtNodes::NodeDataType;
 
-enum class Direction;
-
 /**
 *   @brief The class provides node graphical representation of CanDevice
 */
@@ -52,11 +52,23 @@ public:
     void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
 
     /**
-    *   @brief Used to send frames that were put in queue
+    *   @brief  Sets acceptance filters requested by nodes consuming frames of this device
+    *   @param  filters union of consumers' filters, empty list to receive all frames
     */
-    void frameOnQueue();
+    void setAcceptanceFilters(const CanFilterList& filters);
+
+    /**
+    *   @brief  Number of frames dropped because queue was full
+    *   @return drop counter
+    */
+    quint64 droppedFrames() const;
 
 public slots:
+    /**
+    *   @brief Used to send frames that were put in queue. All frames queued since last call are propagated in one
+    *          pass (one dataUpdated per group of frames sharing direction and status).
+    */
+    void frameOnQueue();
 
     /**
     *   @brief  Callback, called when CanDevice emits signal frameReceived
@@ -71,6 +83,19 @@ public slots:
     */
     void frameSent(bool status, const QCanBusFrame& frame);
 
+    /**
+    *   @brief  Callback, called when CanDevice emits signal frameBatchReceived
+    *   @param  frames received frames
+    */
+    void frameBatchReceived(const QVector<QCanBusFrame>& frames);
+
+    /**
+    *   @brief  Callback, called when CanDevice emits signal frameBatchSent
+    *   @param  status indicating if sending frames was successful
+    *   @param  frames sent frames
+    */
+    void frameBatchSent(bool status, const QVector<QCanBusFrame>& frames);
+
 signals:
     /**
     *   @brief  Used to send a frame
@@ -78,12 +103,21 @@ signals:
     */
     void sendFrame(const QCanBusFrame& frame);
 
+    /**
+    *   @brief  Used to send batch of frames
+    *   @param  frames Frames to be sent, in transmission order
+    */
+    void sendFrames(const QVector<QCanBusFrame>& frames);
+
 private:
-    std::shared_ptr<NodeData> _nodeData;
-    QVector<std::tuple<QCanBusFrame, Direction, bool>> _frameQueue;
-    bool _status;
-    Direction _direction;
-    QCanBusFrame _frame;
+    void queueFrames(const QVector<QCanBusFrame>& frames, Direction direction, bool status);
+
+    static constexpr std::size_t kFrameQueueCapacity = 16384;
+
+    std::shared_ptr<CanDeviceDataOut> _nodeData{ std::make_shared<CanDeviceDataOut>() };
+    RingBuffer<CanFrameRecord> _frameQueue{ kFrameQueueCapacity };
+    bool _flushPending{ false };
+    quint64 _droppedFrames{ 0 };
 };
 
 #endif // CANDEVICEMODEL_H
@@ -1,5 +1,6 @@
 #include "canrawsendermodel.h"
 #include <datamodeltypes/canrawsenderdata.h>
+#include <poolallocator.h>
 
 CanRawSenderModel::CanRawSenderModel()
 {
@@ -7,9 +8,6 @@ CanRawSenderModel::CanRawSenderModel()
     _label->setFixedSize(75, 25);
     _label->setAttribute(Qt::WA_TranslucentBackground);
 
-    QWidget* crsWidget = _component.getMainWidget();
-    crsWidget->setWindowTitle("CANrawSender");
-
     connect(&_component, &CanRawSender::sendFrame, this, &CanRawSenderModel::sendFrame);
 
     _caption = "CanRawSender Node";
@@ -24,12 +22,16 @@ NodeDataType CanRawSenderModel::dataType(PortType, PortIndex) const
 
 std::shared_ptr<NodeData> CanRawSenderModel::outData(PortIndex)
 {
-    return std::make_shared<CanRawSenderDataOut>(_frame);
+    return Pool::makeShared<CanRawSenderDataOut>(_frame);
 }
 
 void CanRawSenderModel::sendFrame(const QCanBusFrame& frame)
 {
     // TODO: Check if we don't need queue here. If different threads will operate on _frame we may loose data
+    if (_flowPlanActive) {
+        return;
+    }
+
     _frame = frame;
     emit dataUpdated(0); // Data ready on port 0
 }
@@ -1,5 +1,7 @@
 #include "canrawviewmodel.h"
+#include <QtCore/QMetaMethod>
 #include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
 #include <log.h>
 
 CanRawViewModel::CanRawViewModel()
@@ -12,9 +14,8 @@ CanRawViewModel::CanRawViewModel()
     _name = "CanRawViewModel";
     _modelName = "Raw view";
 
-    _component.getMainWidget()->setWindowTitle("CANrawView");
-    connect(this, &CanRawViewModel::frameSent, &_component, &CanRawView::frameSent);
-    connect(this, &CanRawViewModel::frameReceived, &_component, &CanRawView::frameReceived);
+    connect(this, &CanRawViewModel::frameBatchSent, &_component, &CanRawView::frameBatchSent);
+    connect(this, &CanRawViewModel::frameBatchReceived, &_component, &CanRawView::frameBatchReceived);
 }
 
 unsigned int CanRawViewModel::nPorts(PortType portType) const
@@ -35,12 +36,27 @@ std::shared_ptr<NodeData> CanRawViewModel::outData(PortIndex)
 void CanRawViewModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
 {
     if (nodeData) {
-        auto d = std::dynamic_pointer_cast<CanRawViewDataIn>(nodeData);
+        auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
         assert(nullptr != d);
+        // Per-frame signals are kept for compatibility. Skip them when nobody listens.
+        static const QMetaMethod frameSentSignal = QMetaMethod::fromSignal(&CanRawViewModel::frameSent);
+        static const QMetaMethod frameReceivedSignal = QMetaMethod::fromSignal(&CanRawViewModel::frameReceived);
+        const auto& records = d->records();
+
         if (d->direction() == Direction::TX) {
-            emit frameSent(d->status(), d->frame());
+            emit frameBatchSent(d->status(), records);
+            if (isSignalConnected(frameSentSignal)) {
+                for (const auto& rec : records) {
+                    emit frameSent(d->status(), toQCanBusFrame(rec));
+                }
+            }
         } else if (d->direction() == Direction::RX) {
-            emit frameReceived(d->frame());
+            emit frameBatchReceived(records);
+            if (isSignalConnected(frameReceivedSignal)) {
+                for (const auto& rec : records) {
+                    emit frameReceived(toQCanBusFrame(rec));
+                }
+            }
         } else {
             cds_warn("Incorrect direction");
         }
@@ -63,6 +63,19 @@ signals:
     */
     void frameSent(bool status, const QCanBusFrame& frame);
 
+    /**
+    *   @brief  Emits signal once per received batch of CAN frames
+    *   @param frames Received frames
+    */
+    void frameBatchReceived(const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Emits signal once per transmitted batch of CAN frames
+    *   @param status true if frames have been sent successfuly
+    *   @param frames Transmitted frames
+    */
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+
 private:
     QCanBusFrame _frame;
 };
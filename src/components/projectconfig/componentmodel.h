@@ -1,23 +1,67 @@
 #ifndef COMPONENTMODEL_H
 #define COMPONENTMODEL_H
 
+#include <QtCore/QJsonObject>
 #include <QtCore/QObject>
+#include <QtCore/QStringList>
 #include <QtWidgets/QLabel>
+#include <componentinterface.h>
+#include <flowplan.h>
 #include <functional>
 #include <nodes/NodeDataModel>
 
-struct ComponentInterface;
+// Model JSON key telling restore() that configuration comes later, see ComponentModelInterface::restoreLater
+const char kDeferredRestoreKey[] = "deferredRestore";
 
 struct ComponentModelInterface {
     virtual ~ComponentModelInterface() = default;
     virtual ComponentInterface& getComponent() = 0;
+
+    /**
+    *   @brief  Data of active model is delivered by FlowPlan, model does not propagate it through node graph
+    *   @param  active true when project dataflow plan is in use
+    */
+    virtual void setFlowPlanActive(bool active) = 0;
+
+    /**
+    *   @return thread component should be executed in, see FlowPlan::setAffinity
+    */
+    virtual int threadAffinity() const = 0;
+
+    /**
+    *   @brief  Shows frame path activity in embedded label of node
+    *   @param  stats activity over last interval, difference of two FlowPlan::nodeStats snapshots
+    *   @param  seconds length of interval
+    *   @return true if label was resized, i.e. node geometry has to be updated
+    */
+    virtual bool showNodeStats(const NodeStats& stats, double seconds) = 0;
+
+    /**
+    *   @brief  Restores label shown before showNodeStats
+    *   @return true if label was resized
+    */
+    virtual bool hideNodeStats() = 0;
+
+    /**
+    *   @brief  Restores configuration when component is first needed (getComponent, save) instead of right away.
+    *           Used for nodes restored with kDeferredRestoreKey, so that loading big project does not parse and
+    *           apply configuration of nodes that are not used.
+    *   @param  config returns model JSON to be passed to restore()
+    */
+    virtual void restoreLater(std::function<QJsonObject()> config) = 0;
 };
 
 template <typename C, typename Derived>
 class ComponentModel : public QtNodes::NodeDataModel, public ComponentModelInterface {
 
 public:
-    ComponentModel() = default;
+    ComponentModel()
+    {
+        // Node properties edited with PropertyEditorDialog
+        setProperty("exposedProperties", QStringList{ kThreadAffinityKey });
+        setProperty(kThreadAffinityKey, FlowPlan::kMainThread);
+    }
+
     virtual ~ComponentModel() = default;
 
     /**
@@ -53,11 +97,41 @@ public:
      */
     virtual QJsonObject save() const override
     {
+        // Configuration that was not restored yet is still the saved one
+        if (_pendingRestore) {
+            return _pendingRestore();
+        }
+
         QJsonObject json = _component.getConfig();
         json["name"] = name();
+        const int affinity = threadAffinity();
+        if (affinity != FlowPlan::kMainThread) {
+            json[kThreadAffinityKey] = affinity;
+        }
         return json;
     }
 
+    /**
+     * @brief Restores node properties saved with save()
+     * @param json json object
+     */
+    virtual void restore(const QJsonObject& json) override
+    {
+        _pendingRestore = nullptr;
+        if (json[kDeferredRestoreKey].toBool()) {
+            return;
+        }
+
+        QJsonObject config = json;
+        _component.setConfig(config);
+        setProperty(kThreadAffinityKey, json[kThreadAffinityKey].toInt(FlowPlan::kMainThread));
+
+        if (json.contains(kSideDataKey)) {
+            // Path is resolved against project location by ProjectConfig
+            _component.loadSideData(json[kSideDataKey].toString());
+        }
+    }
+
     /**
     *   @brief  Used to get model name
     *   @return Model name
@@ -91,16 +165,103 @@ public:
     */
     virtual ComponentInterface& getComponent() override
     {
+        if (_pendingRestore) {
+            const auto config = std::move(_pendingRestore);
+            restore(config());
+        }
+
         return _component;
     }
 
+    /**
+    *   @brief  Enables or disables data propagation through node graph
+    *   @param  active true if all outgoing connections of node are served by FlowPlan
+    */
+    virtual void setFlowPlanActive(bool active) override
+    {
+        _flowPlanActive = active;
+    }
+
+    /**
+    *   @brief  Thread affinity is a node property stored in project under kThreadAffinityKey and edited as
+    *           "thread" property of model. Affinity of node not restored yet is read from its pending configuration.
+    *   @return FlowPlan::kMainThread, FlowPlan::kAnyWorker or worker number
+    */
+    virtual int threadAffinity() const override
+    {
+        if (_pendingRestore) {
+            return _pendingRestore()[kThreadAffinityKey].toInt(FlowPlan::kMainThread);
+        }
+
+        // Property editor may set it as text
+        bool ok = false;
+        const int affinity = property(kThreadAffinityKey).toInt(&ok);
+
+        return ok ? affinity : FlowPlan::kMainThread;
+    }
+
+    /**
+    *   @brief  Label grows to fit statistics while they are shown
+    *   @see ComponentModelInterface
+    */
+    virtual bool showNodeStats(const NodeStats& stats, double seconds) override
+    {
+        const bool resized = !_statsShown;
+
+        if (resized) {
+            _labelText = _label->text();
+            _labelSize = _label->size();
+            _label->setFixedSize(kStatsLabelWidth, kStatsLabelHeight);
+            _statsShown = true;
+        }
+
+        _label->setText(stats.toString(seconds));
+
+        return resized;
+    }
+
+    /**
+    *   @see ComponentModelInterface
+    */
+    virtual bool hideNodeStats() override
+    {
+        if (!_statsShown) {
+            return false;
+        }
+
+        _label->setText(_labelText);
+        _label->setFixedSize(_labelSize);
+        _statsShown = false;
+
+        return true;
+    }
+
+    /**
+    *   @see ComponentModelInterface
+    */
+    virtual void restoreLater(std::function<QJsonObject()> config) override
+    {
+        _pendingRestore = std::move(config);
+    }
+
 protected:
+    // Fits three lines of NodeStats::toString
+    static constexpr int kStatsLabelWidth = 150;
+    static constexpr int kStatsLabelHeight = 50;
+
     C _component;
     QLabel* _label{ new QLabel };
     QString _caption;
     QString _name;
     QString _modelName;
     bool _resizable{ false };
+    bool _flowPlanActive{ false };
+
+private:
+    bool _statsShown{ false };
+    QString _labelText;
+    QSize _labelSize;
+    std::function<QJsonObject()> _pendingRestore;
 };
 
 #endif // COMPONENTMODEL_H
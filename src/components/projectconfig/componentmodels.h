@@ -0,0 +1,44 @@
+#ifndef COMPONENTMODELS_H
+#define COMPONENTMODELS_H
+
+#include "busstatisticsmodel.h"
+#include "candevicemodel.h"
+#include "canrawsendermodel.h"
+#include "canrawviewmodel.h"
+#include "framefiltermodel.h"
+#include "gatewaymodel.h"
+#include "isotpmodel.h"
+#include "mergemodel.h"
+#include "networkbridgemodel.h"
+#include "signaldecodermodel.h"
+#include "signalplotmodel.h"
+#include "traceloggermodel.h"
+#include "tracereplaymodel.h"
+#include "triggermodel.h"
+#include "udsflashermodel.h"
+#include <visitor.h>
+
+/**
+*   @brief  Compile-time tags of all node models available in project. Models are registered in scene in this
+*           order and node callbacks dispatch on these tags instead of RTTI cross casts, see TypeTags.
+*/
+using ComponentModels = TypeTags<CanDeviceModel, CanRawSenderModel, CanRawViewModel, TraceLoggerModel,
+    TraceReplayModel, SignalDecoderModel, SignalPlotModel, BusStatisticsModel, IsoTpModel, UdsFlasherModel,
+    TriggerModel, NetworkBridgeModel, MergeModel, GatewayModel, FrameFilterModel>;
+
+/**
+*   @brief  Resolves node model to its component side
+*   @return nullptr if model is not one of ComponentModels
+*/
+inline ComponentModelInterface* componentModel(QtNodes::NodeDataModel* model)
+{
+    ComponentModelInterface* iface = nullptr;
+
+    if (model) {
+        ComponentModels::dispatch(*model, [&iface](ComponentModelInterface& m) { iface = &m; });
+    }
+
+    return iface;
+}
+
+#endif // COMPONENTMODELS_H
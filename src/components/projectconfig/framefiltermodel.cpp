@@ -0,0 +1,70 @@
+#include "framefiltermodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+#include <poolallocator.h>
+
+FrameFilterModel::FrameFilterModel()
+    : _frames(std::make_shared<CanDeviceDataOut>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "Filter Node";
+    _name = "FrameFilterModel";
+    _modelName = "Filter";
+
+    connect(this, &FrameFilterModel::frameBatchSent, &_component, &FrameFilter::frameBatchSent);
+    connect(this, &FrameFilterModel::frameBatchReceived, &_component, &FrameFilter::frameBatchReceived);
+    connect(&_component, &FrameFilter::framesFiltered, this, &FrameFilterModel::framesFiltered);
+}
+
+unsigned int FrameFilterModel::nPorts(PortType portType) const
+{
+    switch (portType) {
+    case PortType::In:
+    case PortType::Out:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+NodeDataType FrameFilterModel::dataType(PortType, PortIndex) const
+{
+    return CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> FrameFilterModel::outData(PortIndex)
+{
+    return _frames;
+}
+
+void FrameFilterModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (!nodeData) {
+        cds_warn("Incorrect nodeData");
+        return;
+    }
+
+    auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+    assert(nullptr != d);
+
+    if (d->direction() == Direction::TX) {
+        emit frameBatchSent(d->status(), d->records());
+    } else {
+        emit frameBatchReceived(d->records());
+    }
+}
+
+void FrameFilterModel::framesFiltered(const CanFrameBatch& frames)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    // Passed frames keep their direction flags
+    _frames = Pool::makeShared<CanDeviceDataOut>(frames, Direction::RX, true);
+    emit dataUpdated(0); // Data ready on port 0
+}
@@ -0,0 +1,72 @@
+#include "gatewaymodel.h"
+#include <datamodeltypes/candevicedata.h>
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+#include <poolallocator.h>
+
+GatewayModel::GatewayModel()
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "Gateway";
+    _name = "GatewayModel";
+    _modelName = "Gateway";
+
+    for (auto& frames : _frames) {
+        frames = std::make_shared<CanDeviceDataIn>();
+    }
+
+    connect(this, &GatewayModel::frameBatchReceived, &_component, &Gateway::frameBatchReceived);
+    connect(&_component, &Gateway::framesRouted, this, &GatewayModel::framesRouted);
+}
+
+unsigned int GatewayModel::nPorts(PortType portType) const
+{
+    switch (portType) {
+    case PortType::In:
+        return 1;
+    case PortType::Out:
+        return Gateway::kMaxChannels;
+    default:
+        return 0;
+    }
+}
+
+NodeDataType GatewayModel::dataType(PortType portType, PortIndex) const
+{
+    return (PortType::Out == portType) ? CanDeviceDataIn{}.type() : CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> GatewayModel::outData(PortIndex port)
+{
+    return _frames[static_cast<std::size_t>(port)];
+}
+
+void GatewayModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (!nodeData) {
+        cds_warn("Incorrect nodeData");
+        return;
+    }
+
+    auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+    assert(nullptr != d);
+
+    // Only received frames are routed, frames sent by source device are its own traffic
+    if (d->direction() == Direction::RX) {
+        emit frameBatchReceived(d->records());
+    }
+}
+
+void GatewayModel::framesRouted(int channel, const CanFrameBatch& frames)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    _frames[static_cast<std::size_t>(channel)] = Pool::makeShared<CanDeviceDataIn>(frames);
+    emit dataUpdated(channel);
+}
@@ -0,0 +1,68 @@
+#ifndef GATEWAYMODEL_H
+#define GATEWAYMODEL_H
+
+#include "componentmodel.h"
+#include <array>
+#include <canframerecord.h>
+#include <gateway.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class CanDeviceDataIn;
+
+/**
+*   @brief The class provides node graphical representation of Gateway
+*/
+class GatewayModel : public ComponentModel<Gateway, GatewayModel> {
+    Q_OBJECT
+
+public:
+    GatewayModel();
+    virtual ~GatewayModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 for in port, Gateway::kMaxChannels for out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return received frames on input, frames to be sent on outputs
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id, i.e. channel
+    *   @return frames routed to channel
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes received frames to Gateway
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    void frameBatchReceived(const CanFrameBatch& frames);
+
+public slots:
+    /**
+    *   @brief  Callback, called when Gateway routes frames passed through node graph
+    */
+    void framesRouted(int channel, const CanFrameBatch& frames);
+
+private:
+    std::array<std::shared_ptr<CanDeviceDataIn>, Gateway::kMaxChannels> _frames;
+};
+
+#endif // GATEWAYMODEL_H
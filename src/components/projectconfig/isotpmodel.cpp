@@ -0,0 +1,94 @@
+#include "isotpmodel.h"
+#include <datamodeltypes/canrawsenderdata.h>
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/isotpdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+#include <poolallocator.h>
+
+constexpr PortIndex IsoTpModel::kFramePort;
+constexpr PortIndex IsoTpModel::kPduPort;
+
+IsoTpModel::IsoTpModel()
+    : _frames(std::make_shared<CanRawSenderDataOut>())
+    , _pdu(std::make_shared<IsoTpData>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "IsoTp Node";
+    _name = "IsoTpModel";
+    _modelName = "ISO-TP";
+
+    connect(this, &IsoTpModel::frameBatchSent, &_component, &IsoTp::frameBatchSent);
+    connect(this, &IsoTpModel::frameBatchReceived, &_component, &IsoTp::frameBatchReceived);
+    connect(this, &IsoTpModel::sendPdu, &_component, &IsoTp::sendPdu);
+    connect(&_component, &IsoTp::sendFrames, this, &IsoTpModel::sendFrames);
+    connect(&_component, &IsoTp::pduReceived, this, &IsoTpModel::pduReceived);
+}
+
+unsigned int IsoTpModel::nPorts(PortType portType) const
+{
+    return (PortType::None != portType) ? 2 : 0;
+}
+
+NodeDataType IsoTpModel::dataType(PortType portType, PortIndex portIndex) const
+{
+    if (portIndex == kPduPort) {
+        return IsoTpData().type();
+    }
+
+    return (PortType::In == portType) ? CanRawViewDataIn().type() : CanRawSenderDataOut().type();
+}
+
+std::shared_ptr<NodeData> IsoTpModel::outData(PortIndex port)
+{
+    if (port == kPduPort) {
+        return _pdu;
+    }
+
+    return _frames;
+}
+
+void IsoTpModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex port)
+{
+    if (!nodeData) {
+        cds_warn("Incorrect nodeData");
+        return;
+    }
+
+    if (port == kPduPort) {
+        emit sendPdu(nodeDataCast<IsoTpData>(nodeData)->pdu());
+        return;
+    }
+
+    auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+    assert(nullptr != d);
+
+    if (d->direction() == Direction::TX) {
+        emit frameBatchSent(d->status(), d->records());
+    } else {
+        emit frameBatchReceived(d->records());
+    }
+}
+
+void IsoTpModel::sendFrames(const QVector<QCanBusFrame>& frames)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    _frames = Pool::makeShared<CanRawSenderDataOut>(toCanFrameBatch(frames, Direction::TX));
+    emit dataUpdated(kFramePort);
+}
+
+void IsoTpModel::pduReceived(const IsoTpPdu& pdu)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    _pdu = Pool::makeShared<IsoTpData>(pdu);
+    emit dataUpdated(kPduPort);
+}
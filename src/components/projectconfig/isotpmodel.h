@@ -0,0 +1,80 @@
+#ifndef ISOTPMODEL_H
+#define ISOTPMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <isotp.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class CanDeviceDataIn;
+class IsoTpData;
+
+/**
+*   @brief The class provides node graphical representation of IsoTp
+*/
+class IsoTpModel : public ComponentModel<IsoTp, IsoTpModel> {
+    Q_OBJECT
+
+public:
+    // Port 0 carries CAN frames, port 1 ISO-TP messages, in both directions
+    static constexpr PortIndex kFramePort = 0;
+    static constexpr PortIndex kPduPort = 1;
+
+    IsoTpModel();
+    virtual ~IsoTpModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 2 for both in and out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return frames from and to CanDevice on kFramePort, IsoTpData on kPduPort
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return frames to be sent or last received PDU
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes frames or PDUs to IsoTp
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void sendPdu(const IsoTpPdu& pdu);
+
+public slots:
+    /**
+    *   @brief  Callback, called when IsoTp emits frames to be sent
+    */
+    void sendFrames(const QVector<QCanBusFrame>& frames);
+
+    /**
+    *   @brief  Callback, called when IsoTp reassembled PDU. Propagated synchronously, so view stays valid.
+    */
+    void pduReceived(const IsoTpPdu& pdu);
+
+private:
+    std::shared_ptr<CanDeviceDataIn> _frames;
+    std::shared_ptr<IsoTpData> _pdu;
+};
+
+#endif // ISOTPMODEL_H
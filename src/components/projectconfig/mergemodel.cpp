@@ -0,0 +1,71 @@
+#include "mergemodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+#include <poolallocator.h>
+
+MergeModel::MergeModel()
+    : _frames(std::make_shared<CanDeviceDataOut>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "Merge Node";
+    _name = "MergeModel";
+    _modelName = "Merge";
+
+    connect(this, &MergeModel::channelSent, &_component, &Merge::channelSent);
+    connect(this, &MergeModel::channelReceived, &_component, &Merge::channelReceived);
+    connect(&_component, &Merge::framesMerged, this, &MergeModel::framesMerged);
+}
+
+unsigned int MergeModel::nPorts(PortType portType) const
+{
+    switch (portType) {
+    case PortType::In:
+        return Merge::kMaxChannels;
+    case PortType::Out:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+NodeDataType MergeModel::dataType(PortType, PortIndex) const
+{
+    return CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> MergeModel::outData(PortIndex)
+{
+    return _frames;
+}
+
+void MergeModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex port)
+{
+    if (!nodeData) {
+        cds_warn("Incorrect nodeData");
+        return;
+    }
+
+    auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+    assert(nullptr != d);
+
+    if (d->direction() == Direction::TX) {
+        emit channelSent(port, d->status(), d->records());
+    } else {
+        emit channelReceived(port, d->records());
+    }
+}
+
+void MergeModel::framesMerged(const CanFrameBatch& frames)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    // Merged frames keep their direction flags and carry channel tags
+    _frames = Pool::makeShared<CanDeviceDataOut>(frames, Direction::RX, true);
+    emit dataUpdated(0); // Data ready on port 0
+}
@@ -0,0 +1,68 @@
+#ifndef MERGEMODEL_H
+#define MERGEMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <merge.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class CanDeviceDataOut;
+
+/**
+*   @brief The class provides node graphical representation of Merge
+*/
+class MergeModel : public ComponentModel<Merge, MergeModel> {
+    Q_OBJECT
+
+public:
+    MergeModel();
+    virtual ~MergeModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return Merge::kMaxChannels for in port, 1 for out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return frames on all ports
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return merged frames
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, port index selects channel
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    void channelReceived(int channel, const CanFrameBatch& frames);
+    void channelSent(int channel, bool status, const CanFrameBatch& frames);
+
+public slots:
+    /**
+    *   @brief  Callback, called when Merge releases frames
+    */
+    void framesMerged(const CanFrameBatch& frames);
+
+private:
+    std::shared_ptr<CanDeviceDataOut> _frames;
+};
+
+#endif // MERGEMODEL_H
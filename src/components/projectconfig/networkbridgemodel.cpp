@@ -0,0 +1,70 @@
+#include "networkbridgemodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+#include <poolallocator.h>
+
+NetworkBridgeModel::NetworkBridgeModel()
+    : _frames(std::make_shared<CanDeviceDataOut>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "Network Bridge";
+    _name = "NetworkBridgeModel";
+    _modelName = "Network Bridge";
+
+    connect(this, &NetworkBridgeModel::frameBatchSent, &_component, &NetworkBridge::frameBatchSent);
+    connect(this, &NetworkBridgeModel::frameBatchReceived, &_component, &NetworkBridge::frameBatchReceived);
+    connect(&_component, &NetworkBridge::framesReceived, this, &NetworkBridgeModel::framesReceived);
+}
+
+unsigned int NetworkBridgeModel::nPorts(PortType portType) const
+{
+    switch (portType) {
+    case PortType::In:
+    case PortType::Out:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+NodeDataType NetworkBridgeModel::dataType(PortType, PortIndex) const
+{
+    return CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> NetworkBridgeModel::outData(PortIndex)
+{
+    return _frames;
+}
+
+void NetworkBridgeModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (!nodeData) {
+        cds_warn("Incorrect nodeData");
+        return;
+    }
+
+    auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+    assert(nullptr != d);
+
+    if (d->direction() == Direction::TX) {
+        emit frameBatchSent(d->status(), d->records());
+    } else {
+        emit frameBatchReceived(d->records());
+    }
+}
+
+void NetworkBridgeModel::framesReceived(const CanFrameBatch& frames)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    // Remote frames keep their direction flags, consumers see them as if they came from local device
+    _frames = Pool::makeShared<CanDeviceDataOut>(frames, Direction::RX, true);
+    emit dataUpdated(0); // Data ready on port 0
+}
@@ -0,0 +1,68 @@
+#ifndef NETWORKBRIDGEMODEL_H
+#define NETWORKBRIDGEMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <networkbridge.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class CanDeviceDataOut;
+
+/**
+*   @brief The class provides node graphical representation of NetworkBridge
+*/
+class NetworkBridgeModel : public ComponentModel<NetworkBridge, NetworkBridgeModel> {
+    Q_OBJECT
+
+public:
+    NetworkBridgeModel();
+    virtual ~NetworkBridgeModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 for in port, 1 for out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return frames on both ports
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return frames received from remote bridge
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes frames to NetworkBridge
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+
+public slots:
+    /**
+    *   @brief  Callback, called when NetworkBridge receives frames from remote bridge
+    */
+    void framesReceived(const CanFrameBatch& frames);
+
+private:
+    std::shared_ptr<CanDeviceDataOut> _frames;
+};
+
+#endif // NETWORKBRIDGEMODEL_H
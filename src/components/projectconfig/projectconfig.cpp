@@ -2,6 +2,8 @@
 #include "projectconfig_p.h"
 #include <QCloseEvent>
 
+constexpr int ProjectConfigPrivate::kNodeStatsIntervalMs;
+
 ProjectConfig::ProjectConfig()
     : d_ptr(new ProjectConfigPrivate(this))
 {
@@ -37,16 +39,16 @@ void ProjectConfig::closeEvent(QCloseEvent* e)
     e->ignore();
 }
 
-QByteArray ProjectConfig::save()
+void ProjectConfig::save(const QString& path, ProjectWriter::Format format)
 {
     Q_D(ProjectConfig);
-    return d->save();
+    d->save(path, format);
 }
 
-void ProjectConfig::load(const QByteArray& data)
+bool ProjectConfig::load(const QString& path)
 {
     Q_D(ProjectConfig);
-    return d->load(data);
+    return d->load(path);
 }
 
 void ProjectConfig::clearGraphView()
@@ -54,3 +56,21 @@ void ProjectConfig::clearGraphView()
     Q_D(ProjectConfig);
     return d->clearGraphView();
 }
+
+void ProjectConfig::setNodeStatsVisible(bool visible)
+{
+    Q_D(ProjectConfig);
+    d->setNodeStatsVisible(visible);
+}
+
+void ProjectConfig::setVirtualTime(bool enabled)
+{
+    Q_D(ProjectConfig);
+    d->setVirtualTime(enabled);
+}
+
+QObject* ProjectConfig::selectedNodeProperties()
+{
+    Q_D(ProjectConfig);
+    return d->selectedNodeProperties();
+}
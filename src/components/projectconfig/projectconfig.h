@@ -1,7 +1,9 @@
 #ifndef PROJECTCONFIG_H
 #define PROJECTCONFIG_H
 
+#include "projectwriter.h"
 #include <QtWidgets/QWidget>
+#include <componentinterface.h>
 
 namespace QtNodes {
 class Node;
@@ -17,15 +19,53 @@ public:
     explicit ProjectConfig();
     ~ProjectConfig();
     void closeEvent(QCloseEvent* e);
-    QByteArray save();
-    void load(const QByteArray& data);
+
+    /**
+    *   @brief  Saves project in background, projectSaved is emitted when done
+    *   @param  path project file path
+    *   @param  format encoding of project file, JSON is meant for export and hand editing
+    */
+    void save(const QString& path, ProjectWriter::Format format = ProjectWriter::Format::Binary);
+
+    /**
+    *   @brief  Loads project into current scene. Encoding is detected, load time is logged.
+    *   @param  path project file path
+    *   @return false if file is not a valid project
+    */
+    bool load(const QString& path);
     void clearGraphView();
 
+    /**
+    *   @brief  Shows live frame rates, processing time per frame and queue counters in nodes of the scene
+    */
+    void setNodeStatsVisible(bool visible);
+
+    /**
+    *   @brief  Runs next simulation on virtual clock, see SimClock. Replayed and synthetic traffic is then generated
+    *           as fast as it is processed instead of at its real rate.
+    */
+    void setVirtualTime(bool enabled);
+
+    /**
+    *   @brief  Properties of node, e.g. thread affinity, are edited with PropertyEditorDialog. Thread affinity
+    *           applies on next simulation start.
+    *   @return property source of the selected node, nullptr unless exactly one node is selected
+    */
+    QObject* selectedNodeProperties();
+
 signals:
     void handleDock(QWidget* component);
     void componentWidgetCreated(QWidget* component);
     void stopSimulation();
     void startSimulation();
+    void projectSaved(const QString& path, bool status);
+
+    /**
+    *   @brief  Emitted when views were switched to degraded mode or back, see LoadGovernor
+    *   @param  level new load level
+    *   @param  reason load that caused the change
+    */
+    void loadLevelChanged(LoadLevel level, const QString& reason);
 
 private slots:
     void nodeCreatedCallback(QtNodes::Node& node);
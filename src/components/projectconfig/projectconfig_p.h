@@ -1,16 +1,31 @@
 #ifndef PROJECTCONFIG_P_H
 #define PROJECTCONFIG_P_H
 
-#include "canrawsendermodel.h"
-#include "canrawviewmodel.h"
+#include "componentmodels.h"
 #include "flowviewwrapper.h"
 #include "modeltoolbutton.h"
+#include "projectwriter.h"
 #include "ui_projectconfig.h"
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
 #include <QtWidgets/QPushButton>
+#include <algorithm>
+#include <flowplan.h>
+#include <loadgovernor.h>
 #include <log.h>
-#include <modelvisitor.h> // apply_model_visitor
+#include <memory>
+#include <nodes/Connection>
 #include <nodes/Node>
-#include <projectconfig/candevicemodel.h>
+#include <projectfile.h>
+#include <simclock.h>
+#include <unordered_map>
 
 namespace Ui {
 class ProjectConfigPrivate;
@@ -21,20 +36,37 @@ class ProjectConfigPrivate : public QWidget {
     Q_DECLARE_PUBLIC(ProjectConfig)
 
 public:
+    // A few updates per second are readable and keep cost of sampling negligible
+    static constexpr int kNodeStatsIntervalMs = 250;
+
     ProjectConfigPrivate(ProjectConfig* q)
-        : _graphView(new FlowViewWrapper(&_graphScene))
+        : _governor([this] { return _flowPlan.mainThreadBacklog(); })
+        , _graphView(new FlowViewWrapper(&_graphScene))
         , _ui(std::make_unique<Ui::ProjectConfigPrivate>())
         , q_ptr(q)
     {
         auto& modelRegistry = _graphScene.registry();
-        modelRegistry.registerModel<CanDeviceModel>();
-        modelRegistry.registerModel<CanRawSenderModel>();
-        modelRegistry.registerModel<CanRawViewModel>();
+        ComponentModels::for_each([&modelRegistry](auto model) {
+            modelRegistry.registerModel<typename decltype(model)::type>();
+        });
 
         connect(&_graphScene, &QtNodes::FlowScene::nodeCreated, this, &ProjectConfigPrivate::nodeCreatedCallback);
         connect(&_graphScene, &QtNodes::FlowScene::nodeDeleted, this, &ProjectConfigPrivate::nodeDeletedCallback);
         connect(&_graphScene, &QtNodes::FlowScene::nodeDoubleClicked, this,
             &ProjectConfigPrivate::nodeDoubleClickedCallback);
+        connect(&_graphScene, &QtNodes::FlowScene::connectionCreated, this,
+            &ProjectConfigPrivate::connectionCreatedCallback);
+        connect(&_graphScene, &QtNodes::FlowScene::connectionDeleted, this,
+            &ProjectConfigPrivate::connectionDeletedCallback);
+        // Connected before any component, so that plan and filters are ready when devices start
+        connect(q, &ProjectConfig::startSimulation, this, &ProjectConfigPrivate::buildFlowPlan);
+        connect(q, &ProjectConfig::startSimulation, this, &ProjectConfigPrivate::updateAcceptanceFilters);
+        connect(q, &ProjectConfig::stopSimulation, this, &ProjectConfigPrivate::stopFlowPlan);
+        connect(&_writer, &ProjectWriter::saved, q, &ProjectConfig::projectSaved);
+        connect(&_statsTimer, &QTimer::timeout, this, &ProjectConfigPrivate::refreshNodeStats);
+        connect(&_governor, &LoadGovernor::levelChanged, this, &ProjectConfigPrivate::applyLoadLevel);
+
+        _statsTimer.setInterval(kNodeStatsIntervalMs);
 
         _ui->setupUi(this);
         _ui->layout->addWidget(_graphView);
@@ -44,18 +76,138 @@ public:
     {
     }
 
-    QByteArray save() const
+    /**
+    *   @brief  Takes snapshot of the scene and writes it in worker thread. Bulky component state goes to side
+    *           files, see ProjectWriter.
+    *   @param  path project file path
+    *   @param  format encoding of project file
+    */
+    void save(const QString& path, ProjectWriter::Format format)
     {
-        return _graphScene.saveToMemory();
+        ProjectWriter::Project project;
+        const QString sideDir = ProjectWriter::sideDataDir(path);
+
+        project.format = format;
+        for (const auto& node : _graphScene.nodes()) {
+            QJsonObject json = node.second->save();
+            auto iface = componentModel(node.second->nodeDataModel());
+            // Component whose configuration was not restored yet loads its side data here
+            auto side = iface ? iface->getComponent().sideData() : ComponentSideData();
+
+            if (side.write) {
+                const QString name = sideDir + "/" + node.first.toString().remove('{').remove('}') + side.suffix;
+                QJsonObject model = json["model"].toObject();
+
+                model[kSideDataKey] = name;
+                json["model"] = std::move(model);
+                project.sideFiles.emplace_back(name, std::move(side.write));
+            }
+
+            project.nodes.push_back(std::move(json));
+        }
+
+        for (const auto& conn : _graphScene.connections()) {
+            QJsonObject json = conn.second->save();
+
+            if (!json.isEmpty()) {
+                if (_edgePolicies.contains(conn.first)) {
+                    json["queue"] = _edgePolicies[conn.first].toJson();
+                }
+                project.connections.push_back(std::move(json));
+            }
+        }
+
+        _writer.save(path, std::move(project));
     }
 
-    void load(const QByteArray& data)
+    /**
+    *   @brief  Restores scene saved with save(). Side file references are resolved against project location.
+    *           Configuration of nodes of binary project is restored when node is first used, see
+    *           ComponentModelInterface::restoreLater.
+    *   @param  path project file path
+    *   @return false if file is not a valid project
+    */
+    bool load(const QString& path)
     {
-        return _graphScene.loadFromMemory(data);
+        QElapsedTimer timer;
+        timer.start();
+
+        // Project may be still being written
+        _writer.wait();
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            cds_error("Could not open project file '{}'", path.toStdString());
+            return false;
+        }
+
+        const QByteArray data = file.readAll();
+        const QDir projectDir = QFileInfo(path).absoluteDir();
+        const bool binary = ProjectFile::isBinary(data);
+        QSet<QString> restored;
+
+        if (binary) {
+            auto doc = std::make_shared<ProjectFile::Document>();
+            QString error;
+
+            if (!ProjectFile::read(data, *doc, error)) {
+                cds_error("Invalid project file '{}': {}", path.toStdString(), error.toStdString());
+                return false;
+            }
+
+            for (std::size_t i = 0; i < doc->nodes.size(); ++i) {
+                const ProjectFile::Node& node = doc->nodes[i];
+                QJsonObject json = node.scene;
+
+                json["id"] = node.id;
+                json["model"] = QJsonObject{ { "name", node.model }, { kDeferredRestoreKey, true } };
+
+                // Document stays in memory until all nodes restored their configuration
+                auto config = [doc, i, projectDir] { return resolveSideData(doc->model(doc->nodes[i]), projectDir); };
+                if (restoreNode(json, std::move(config))) {
+                    restored.insert(node.id);
+                }
+            }
+
+            restoreConnections(doc->connections, restored);
+        } else {
+            QJsonParseError error;
+            const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+            if (!doc.isObject()) {
+                cds_error("Invalid project file '{}': {}", path.toStdString(), error.errorString().toStdString());
+                return false;
+            }
+
+            const QJsonObject root = doc.object();
+            std::vector<QJsonObject> connections;
+
+            for (const auto& value : root["nodes"].toArray()) {
+                QJsonObject json = value.toObject();
+
+                json["model"] = resolveSideData(json["model"].toObject(), projectDir);
+                if (restoreNode(json, nullptr)) {
+                    restored.insert(json["id"].toString());
+                }
+            }
+
+            for (const auto& value : root["connections"].toArray()) {
+                connections.push_back(value.toObject());
+            }
+            restoreConnections(connections, restored);
+        }
+
+        cds_info("Project '{}' ({}) with {} nodes loaded in {} ms", path.toStdString(), binary ? "binary" : "JSON",
+            restored.size(), timer.elapsed());
+
+        return true;
     }
 
     void clearGraphView()
     {
+        _flowPlan.clear();
+        _edgePolicies.clear();
+        _planConnections.clear();
+        _lastNodeStats.clear();
         return _graphScene.clearScene();
     };
 
@@ -64,10 +216,17 @@ public:
         auto dataModel = node.nodeDataModel();
         assert(nullptr != dataModel);
 
-        auto iface = dynamic_cast<ComponentModelInterface*>(dataModel);
+        auto iface = componentModel(dataModel);
         auto& component = iface->getComponent();
 
         handleWidgetCreation(component);
+
+        // Node added to running simulation joins it, the others keep running
+        if (_simulationStarted) {
+            iface->setFlowPlanActive(true);
+            _flowPlan.setAffinity(component, iface->threadAffinity());
+            component.startSimulation();
+        }
     }
 
     void nodeDeletedCallback(QtNodes::Node& node)
@@ -75,10 +234,20 @@ public:
         auto dataModel = node.nodeDataModel();
         assert(nullptr != dataModel);
 
-        auto iface = dynamic_cast<ComponentModelInterface*>(dataModel);
+        auto iface = componentModel(dataModel);
         auto& component = iface->getComponent();
 
-        handleWidgetDeletion(component.getMainWidget());
+        _flowPlan.removeComponent(component);
+        _lastNodeStats.erase(&component);
+        if (_simulationStarted) {
+            component.stopSimulation();
+            updateAcceptanceFilters();
+        }
+
+        // Widget that was never shown does not have to be built just to be closed
+        if (component.mainWidgetCreated()) {
+            handleWidgetDeletion(component.getMainWidget());
+        }
     }
 
     void nodeDoubleClickedCallback(QtNodes::Node& node)
@@ -86,13 +255,385 @@ public:
         auto dataModel = node.nodeDataModel();
         assert(nullptr != dataModel);
 
-        auto iface = dynamic_cast<ComponentModelInterface*>(dataModel);
+        auto iface = componentModel(dataModel);
         auto& component = iface->getComponent();
 
         handleWidgetShowing(component.getMainWidget(), component.mainWidgetDocked());
     }
 
+    void connectionCreatedCallback(const QtNodes::Connection& conn)
+    {
+        // Connection dragged from port is complete only after it is dropped on another one
+        connect(&conn, &QtNodes::Connection::connectionCompleted, this, &ProjectConfigPrivate::addFlowEdge,
+            Qt::UniqueConnection);
+
+        if (conn.getNode(PortType::In) && conn.getNode(PortType::Out)) {
+            addFlowEdge(conn);
+        }
+    }
+
+    void connectionDeletedCallback(const QtNodes::Connection& conn)
+    {
+        auto out = componentOf(conn.getNode(PortType::Out));
+        auto in = componentOf(conn.getNode(PortType::In));
+
+        if (out && in) {
+            _flowPlan.removeEdge(*out, *in);
+            _planConnections.remove(conn.id());
+            if (_simulationStarted) {
+                updateAcceptanceFilters();
+            }
+        }
+        _edgePolicies.remove(conn.id());
+    }
+
+    /**
+    *   @brief  Resolves scene connections to FlowPlan. From now on frames are passed by the plan and data models
+    *           stop propagating them through the scene, except those with connections plan does not support.
+    */
+    void buildFlowPlan()
+    {
+        // Simulated sources pick their pacing when they start
+        SimClock::instance().start(_virtualTime ? SimClock::Mode::Virtual : SimClock::Mode::RealTime);
+        if (_virtualTime) {
+            cds_info("Simulation runs in virtual time");
+        }
+
+        _flowPlan.clear();
+        _simulationStarted = true;
+
+        _planConnections.clear();
+        _graphScene.iterateOverNodes([this](QtNodes::Node* node) {
+            auto iface = componentModel(node->nodeDataModel());
+
+            if (iface) {
+                // Deferred configuration holding affinity is restored first
+                auto& component = iface->getComponent();
+
+                _flowPlan.setAffinity(component, iface->threadAffinity());
+            }
+        });
+
+        // Affinities apply to edges added afterwards
+        _graphScene.iterateOverNodes([this](QtNodes::Node* node) { resolveOutputs(*node); });
+
+        cds_info("Dataflow plan built with {} edges, {} worker threads", _flowPlan.edgeCount(),
+            _flowPlan.workerCount());
+
+        _governor.start();
+
+        // Counters start from zero with the new plan
+        _lastNodeStats.clear();
+        _statsClock.start();
+        if (_nodeStatsVisible) {
+            _statsTimer.start();
+        }
+    }
+
+    /**
+    *   @brief  Lets queued batches be processed before components stop, reports connections that dropped some
+    */
+    void stopFlowPlan()
+    {
+        _simulationStarted = false;
+        SimClock::instance().stop();
+        _flowPlan.flush();
+        _governor.stop();
+
+        // Scene propagation is restored once components stopped, they are stopped after this slot
+        QTimer::singleShot(0, this, [this] {
+            if (_simulationStarted) {
+                return;
+            }
+
+            _planConnections.clear();
+            _graphScene.iterateOverNodes([](QtNodes::Node* node) {
+                auto iface = componentModel(node->nodeDataModel());
+
+                if (iface) {
+                    iface->setFlowPlanActive(false);
+                }
+            });
+        });
+
+        // Labels keep activity of the last interval
+        if (_statsTimer.isActive()) {
+            _statsTimer.stop();
+            refreshNodeStats();
+        }
+
+        for (const auto& conn : _graphScene.connections()) {
+            auto outNode = conn.second->getNode(PortType::Out);
+            auto inNode = conn.second->getNode(PortType::In);
+            auto out = componentOf(outNode);
+            auto in = componentOf(inNode);
+            const EdgeStats stats = (out && in) ? _flowPlan.edgeStats(*out, *in) : EdgeStats{ 0, 0, 0 };
+
+            if (stats.droppedBatches > 0) {
+                cds_warn("Connection '{}' -> '{}' dropped {} batches ({} frames)",
+                    outNode->nodeDataModel()->name().toStdString(), inNode->nodeDataModel()->name().toStdString(),
+                    stats.droppedBatches, stats.droppedFrames);
+            }
+        }
+    }
+
+    /**
+    *   @brief  Collects acceptance filters of nodes connected to each CAN device and passes their union to the
+    *           device, so that unwanted frames are discarded by backend
+    */
+    void updateAcceptanceFilters()
+    {
+        _graphScene.iterateOverNodes([](QtNodes::Node* node) {
+            auto deviceModel = ComponentModels::cast<CanDeviceModel>(node->nodeDataModel());
+
+            if (!deviceModel) {
+                return;
+            }
+
+            QVector<CanFilterList> consumers;
+            for (const auto& conn : node->nodeState().connections(PortType::Out, 0)) {
+                auto consumer = conn.second->getNode(PortType::In);
+
+                if (!consumer) {
+                    continue;
+                }
+
+                // Consumer that cannot tell what it needs gets every frame
+                auto iface = componentModel(consumer->nodeDataModel());
+                consumers.append(iface ? iface->getComponent().acceptanceFilters() : CanFilterList());
+            }
+
+            deviceModel->setAcceptanceFilters(mergeCanFilters(consumers));
+        });
+    }
+
+    void setVirtualTime(bool enabled)
+    {
+        _virtualTime = enabled;
+    }
+
+    QObject* selectedNodeProperties()
+    {
+        const auto nodes = _graphScene.selectedNodes();
+
+        if (nodes.size() != 1) {
+            return nullptr;
+        }
+
+        auto dataModel = nodes.front()->nodeDataModel();
+        // Deferred configuration is applied first, it would overwrite edited properties later
+        componentModel(dataModel)->getComponent();
+
+        return dataModel;
+    }
+
+    /**
+    *   @brief  Shows or hides live frame path statistics in labels of nodes. They are sampled from FlowPlan
+    *           every kNodeStatsIntervalMs while simulation runs.
+    */
+    void setNodeStatsVisible(bool visible)
+    {
+        _nodeStatsVisible = visible;
+
+        if (visible) {
+            _statsClock.start();
+            refreshNodeStats();
+            if (_simulationStarted) {
+                _statsTimer.start();
+            }
+            return;
+        }
+
+        _statsTimer.stop();
+        _graphScene.iterateOverNodes([](QtNodes::Node* node) {
+            auto iface = componentModel(node->nodeDataModel());
+
+            if (iface && iface->hideNodeStats()) {
+                updateNodeGeometry(*node);
+            }
+        });
+    }
+
+    void refreshNodeStats()
+    {
+        // Timer may fire late, rates are computed over time actually passed
+        const double seconds = std::max<qint64>(_statsClock.restart(), 1) / 1000.0;
+
+        _graphScene.iterateOverNodes([this, seconds](QtNodes::Node* node) {
+            auto iface = componentModel(node->nodeDataModel());
+
+            if (!iface) {
+                return;
+            }
+
+            const auto& component = iface->getComponent();
+            const NodeStats stats = _flowPlan.nodeStats(component);
+            auto& last = _lastNodeStats[&component];
+
+            if (iface->showNodeStats(stats - last, seconds)) {
+                updateNodeGeometry(*node);
+            }
+            last = stats;
+        });
+    }
+
+    /**
+    *   @brief  Passes load level to all components, only those displaying frames react to it
+    */
+    void applyLoadLevel(LoadLevel level, const QString& reason)
+    {
+        Q_Q(ProjectConfig);
+
+        _graphScene.iterateOverNodes([level](QtNodes::Node* node) {
+            auto iface = componentModel(node->nodeDataModel());
+
+            if (iface) {
+                iface->getComponent().setLoadLevel(level);
+            }
+        });
+
+        emit q->loadLevelChanged(level, reason);
+    }
+
 private:
+    static QJsonObject resolveSideData(QJsonObject model, const QDir& projectDir)
+    {
+        if (model.contains(kSideDataKey)) {
+            model[kSideDataKey] = projectDir.absoluteFilePath(model[kSideDataKey].toString());
+        }
+
+        return model;
+    }
+
+    /**
+    *   @param  json node JSON
+    *   @param  config configuration restored later, empty if model of json is complete
+    *   @return false if node could not be restored
+    */
+    bool restoreNode(const QJsonObject& json, std::function<QJsonObject()> config)
+    {
+        try {
+            QtNodes::Node& node = _graphScene.restoreNode(json);
+            auto iface = componentModel(node.nodeDataModel());
+
+            if (iface && config) {
+                iface->restoreLater(std::move(config));
+            }
+        } catch (const std::exception& e) {
+            cds_error("Failed to restore node: {}", e.what());
+            return false;
+        }
+
+        return true;
+    }
+
+    void restoreConnections(const std::vector<QJsonObject>& connections, const QSet<QString>& restored)
+    {
+        for (const auto& json : connections) {
+            // Connection would refer to non-existing node otherwise
+            if (restored.contains(json["in_id"].toString()) && restored.contains(json["out_id"].toString())) {
+                auto conn = _graphScene.restoreConnection(json);
+
+                if (conn && json.contains("queue")) {
+                    _edgePolicies.insert(conn->id(), EdgePolicy::fromJson(json["queue"].toObject()));
+                }
+            }
+        }
+    }
+
+    static void updateNodeGeometry(QtNodes::Node& node)
+    {
+        node.nodeGeometry().recalculateSize();
+        node.nodeGraphicsObject().setGeometryChanged();
+        node.nodeGraphicsObject().moveConnections();
+        node.nodeGraphicsObject().update();
+    }
+
+    static ComponentInterface* componentOf(QtNodes::Node* node)
+    {
+        auto iface = node ? componentModel(node->nodeDataModel()) : nullptr;
+
+        return iface ? &iface->getComponent() : nullptr;
+    }
+
+    /**
+    *   @brief  Adds scene connection to running plan. Edits made while simulation runs touch only the edges and
+    *           nodes they change, so captures and open devices of the rest of the graph survive them.
+    */
+    void addFlowEdge(const QtNodes::Connection& conn)
+    {
+        // Plan is built when simulation starts, until then edges are only collected by scene
+        if (!_simulationStarted) {
+            return;
+        }
+
+        auto outNode = conn.getNode(PortType::Out);
+
+        if (!outNode || !componentOf(conn.getNode(PortType::In))) {
+            return;
+        }
+
+        resolveOutputs(*outNode);
+
+        // Consumer added while running may need frames device filtered out so far
+        updateAcceptanceFilters();
+    }
+
+    /**
+    *   @brief  Resolves outgoing connections of node to plan edges. Node whose connections are all resolved stops
+    *           propagating data through the scene. If any of them is not supported by the plan, all of them stay
+    *           on the scene path, so that no consumer of the node misses data or gets it twice.
+    */
+    void resolveOutputs(QtNodes::Node& node)
+    {
+        auto iface = componentModel(node.nodeDataModel());
+
+        if (!iface) {
+            return;
+        }
+
+        auto& out = iface->getComponent();
+        std::vector<std::pair<QUuid, ComponentInterface*>> resolved;
+        bool supported = true;
+
+        for (unsigned int port = 0; port < node.nodeDataModel()->nPorts(PortType::Out); ++port) {
+            for (const auto& entry : node.nodeState().connections(PortType::Out, static_cast<PortIndex>(port))) {
+                const QtNodes::Connection& conn = *entry.second;
+                auto inNode = conn.getNode(PortType::In);
+                auto in = componentOf(inNode);
+
+                // Connection still being dragged
+                if (!in) {
+                    continue;
+                }
+
+                if (!_planConnections.contains(conn.id())) {
+                    if (!_flowPlan.addEdge(out, *in, _edgePolicies.value(conn.id()),
+                            conn.getPortIndex(PortType::In), conn.getPortIndex(PortType::Out))) {
+                        cds_warn("Connection '{}' -> '{}' is not supported by dataflow plan, output of '{}' is "
+                                 "passed through node graph",
+                            node.nodeDataModel()->name().toStdString(), inNode->nodeDataModel()->name().toStdString(),
+                            node.nodeDataModel()->name().toStdString());
+                        supported = false;
+                        continue;
+                    }
+                    _planConnections.insert(conn.id());
+                }
+
+                resolved.emplace_back(conn.id(), in);
+            }
+        }
+
+        if (!supported) {
+            for (const auto& edge : resolved) {
+                _flowPlan.removeEdge(out, *edge.second);
+                _planConnections.remove(edge.first);
+            }
+        }
+
+        iface->setFlowPlanActive(supported);
+    }
+
     void handleWidgetDeletion(QWidget* widget)
     {
         if (!widget)
@@ -133,13 +674,25 @@ private:
     {
         Q_Q(ProjectConfig);
 
-        QWidget* widget = view.getMainWidget();
         connect(q, &ProjectConfig::startSimulation, std::bind(&ComponentInterface::startSimulation, &view));
         connect(q, &ProjectConfig::stopSimulation, std::bind(&ComponentInterface::stopSimulation, &view));
-        view.setDockUndockClbk([widget, q] { emit q->handleDock(widget); });
+        // Main widget is built when node is shown for the first time, dock request can only come from there
+        view.setDockUndockClbk([&view, q] { emit q->handleDock(view.getMainWidget()); });
     }
 
+    // Declared before scene, nodes deleted by scene destructor still remove their edges
+    FlowPlan _flowPlan;
+    LoadGovernor _governor; // samples backlog of the plan
+    QHash<QUuid, EdgePolicy> _edgePolicies; // connections with flow control other than default
+    QSet<QUuid> _planConnections; // scene connections resolved to edges of running plan
+    bool _simulationStarted{ false };
+    bool _nodeStatsVisible{ false };
+    bool _virtualTime{ false }; // applied when simulation starts
+    QTimer _statsTimer;
+    QElapsedTimer _statsClock;
+    std::unordered_map<const ComponentInterface*, NodeStats> _lastNodeStats; // snapshots of previous refresh
     QtNodes::FlowScene _graphScene;
+    ProjectWriter _writer;
     FlowViewWrapper* _graphView;
     std::unique_ptr<Ui::ProjectConfigPrivate> _ui;
     ProjectConfig* q_ptr;
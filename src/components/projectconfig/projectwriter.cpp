@@ -0,0 +1,131 @@
+#include "projectwriter.h"
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <log.h>
+#include <projectfile.h>
+
+namespace {
+void writeArray(QSaveFile& file, const char* name, const std::vector<QJsonObject>& items, bool last)
+{
+    file.write("    \"");
+    file.write(name);
+    file.write("\": [\n");
+
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        // One compact object per line, nothing but the current item is serialized at a time
+        file.write("        ");
+        file.write(QJsonDocument(items[i]).toJson(QJsonDocument::Compact));
+        file.write((i + 1 < items.size()) ? ",\n" : "\n");
+    }
+
+    // Write errors are reported by commit()
+    file.write(last ? "    ]\n" : "    ],\n");
+}
+} // namespace
+
+ProjectWriter::~ProjectWriter()
+{
+    wait();
+}
+
+void ProjectWriter::save(const QString& path, Project&& project)
+{
+    wait();
+
+    _path = path;
+    _project = std::move(project);
+
+    start(QThread::LowPriority);
+}
+
+bool ProjectWriter::write(const QString& path, const Project& project)
+{
+    const bool sideFilesOk = writeSideFiles(path, project);
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        cds_error("Failed to create project file '{}': {}", path.toStdString(), file.errorString().toStdString());
+        return false;
+    }
+
+    if (project.format == Format::Binary) {
+        ProjectFile::write(file, project.nodes, project.connections);
+    } else {
+        file.write("{\n");
+        writeArray(file, "connections", project.connections, false);
+        writeArray(file, "nodes", project.nodes, true);
+        file.write("}\n");
+    }
+
+    // File is replaced only if everything was written
+    if (!file.commit()) {
+        cds_error("Failed to write project file '{}': {}", path.toStdString(), file.errorString().toStdString());
+        return false;
+    }
+
+    return sideFilesOk;
+}
+
+QString ProjectWriter::sideDataDir(const QString& path)
+{
+    return QFileInfo(path).completeBaseName() + "_data";
+}
+
+void ProjectWriter::run()
+{
+    const bool status = write(_path, _project);
+
+    // Release snapshot right away, it may be big
+    _project = Project();
+
+    emit saved(_path, status);
+}
+
+bool ProjectWriter::writeSideFiles(const QString& path, const Project& project)
+{
+    const QDir projectDir = QFileInfo(path).absoluteDir();
+    const QString sideDir = projectDir.absoluteFilePath(sideDataDir(path));
+    QSet<QString> written;
+    bool status = true;
+
+    if (!project.sideFiles.empty() && !projectDir.mkpath(sideDir)) {
+        cds_error("Failed to create directory '{}'", sideDir.toStdString());
+        return false;
+    }
+
+    for (const auto& sideFile : project.sideFiles) {
+        const QString target = projectDir.absoluteFilePath(sideFile.first);
+        const QString tmp = target + ".tmp";
+
+        // Previous file may be still in use (e.g. mapped by trace view), so it is replaced only once new one is
+        // complete
+        QFile::remove(tmp);
+        if (!sideFile.second(tmp) || (QFile::exists(target) && !QFile::remove(target))
+            || !QFile::rename(tmp, target)) {
+            cds_error("Failed to write side file '{}'", target.toStdString());
+            QFile::remove(tmp);
+            status = false;
+        }
+
+        written.insert(QFileInfo(target).fileName());
+    }
+
+    // Remove files of components that no longer exist
+    QDir dir(sideDir);
+    if (dir.exists()) {
+        for (const auto& name : dir.entryList(QDir::Files)) {
+            if (!written.contains(name)) {
+                dir.remove(name);
+            }
+        }
+
+        if (project.sideFiles.empty()) {
+            projectDir.rmdir(sideDir);
+        }
+    }
+
+    return status;
+}
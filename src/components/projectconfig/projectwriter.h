@@ -0,0 +1,78 @@
+#ifndef PROJECTWRITER_H
+#define PROJECTWRITER_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+*   @brief  Writes project file in worker thread
+*
+*   Scene JSON is streamed to the file node by node instead of being built as one document in memory. Bulky
+*   component state (see ComponentSideData) goes to side files in "<project>_data" directory next to the project
+*   file. Side files are written first, so project file never references missing ones. JSON layout of project file
+*   is the same as produced by FlowScene::saveToMemory(), binary one is described in ProjectFile.
+*/
+class ProjectWriter : public QThread {
+    Q_OBJECT
+
+public:
+    typedef std::function<bool(const QString& path)> SideFileWriter;
+
+    enum class Format {
+        Json, // scene JSON, e.g. for export
+        Binary // see ProjectFile, loads faster
+    };
+
+    struct Project {
+        Format format{ Format::Json };
+        std::vector<QJsonObject> nodes;
+        std::vector<QJsonObject> connections;
+        // Side file path relative to project directory and job writing it
+        std::vector<std::pair<QString, SideFileWriter>> sideFiles;
+    };
+
+    ProjectWriter() = default;
+    ~ProjectWriter();
+
+    /**
+    *   @brief  Starts writing project in worker thread. Waits for previous save to complete first.
+    *   @param  path project file path
+    *   @param  project snapshot of project, taken in GUI thread
+    */
+    void save(const QString& path, Project&& project);
+
+    /**
+    *   @brief  Writes project synchronously from calling thread
+    *   @param  path project file path
+    *   @param  project snapshot of project
+    *   @return false if project file or any of side files could not be written
+    */
+    static bool write(const QString& path, const Project& project);
+
+    /**
+    *   @param  path project file path
+    *   @return name of side files directory, relative to project directory
+    */
+    static QString sideDataDir(const QString& path);
+
+signals:
+    /**
+    *   @brief  Emitted from worker thread when save started with save() completes
+    */
+    void saved(const QString& path, bool status);
+
+protected:
+    void run() override;
+
+private:
+    static bool writeSideFiles(const QString& path, const Project& project);
+
+    QString _path;
+    Project _project;
+};
+
+#endif // PROJECTWRITER_H
@@ -0,0 +1,63 @@
+#include "signaldecodermodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <datamodeltypes/signaldata.h>
+#include <log.h>
+#include <poolallocator.h>
+
+SignalDecoderModel::SignalDecoderModel()
+    : _nodeData(std::make_shared<SignalData>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "SignalDecoder Node";
+    _name = "SignalDecoderModel";
+    _modelName = "Signal decoder";
+
+    connect(this, &SignalDecoderModel::frameBatchSent, &_component, &SignalDecoder::frameBatchSent);
+    connect(this, &SignalDecoderModel::frameBatchReceived, &_component, &SignalDecoder::frameBatchReceived);
+    connect(&_component, &SignalDecoder::signalsDecoded, this, &SignalDecoderModel::signalsDecoded);
+}
+
+unsigned int SignalDecoderModel::nPorts(PortType) const
+{
+    return 1;
+}
+
+NodeDataType SignalDecoderModel::dataType(PortType portType, PortIndex) const
+{
+    return (PortType::In == portType) ? CanRawViewDataIn().type() : SignalData().type();
+}
+
+std::shared_ptr<NodeData> SignalDecoderModel::outData(PortIndex)
+{
+    return _nodeData;
+}
+
+void SignalDecoderModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (nodeData) {
+        auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+        assert(nullptr != d);
+
+        if (d->direction() == Direction::TX) {
+            emit frameBatchSent(d->status(), d->records());
+        } else {
+            emit frameBatchReceived(d->records());
+        }
+    } else {
+        cds_warn("Incorrect nodeData");
+    }
+}
+
+void SignalDecoderModel::signalsDecoded(const SignalSampleBatch& samples)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    _nodeData = Pool::makeShared<SignalData>(samples, _component.signalCatalog());
+    emit dataUpdated(0); // Data ready on port 0
+}
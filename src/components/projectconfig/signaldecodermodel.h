@@ -0,0 +1,79 @@
+#ifndef SIGNALDECODERMODEL_H
+#define SIGNALDECODERMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <signaldecoder.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class SignalData;
+
+/**
+*   @brief The class provides node graphical representation of SignalDecoder
+*/
+class SignalDecoderModel : public ComponentModel<SignalDecoder, SignalDecoderModel> {
+    Q_OBJECT
+
+public:
+    SignalDecoderModel();
+    virtual ~SignalDecoderModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 for both in and out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return CanRawView input type for in port (frames), SignalData type for out port (decoded values)
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return samples decoded from last batch of frames
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes frames to SignalDecoder
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    /**
+    *   @brief  Emits signal once per received batch of CAN frames
+    *   @param frames Received frames
+    */
+    void frameBatchReceived(const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Emits signal once per transmitted batch of CAN frames
+    *   @param status true if frames have been sent successfuly
+    *   @param frames Transmitted frames
+    */
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+
+public slots:
+    /**
+    *   @brief  Callback, called when SignalDecoder emits signal signalsDecoded
+    *   @param  samples decoded values
+    */
+    void signalsDecoded(const SignalSampleBatch& samples);
+
+private:
+    std::shared_ptr<SignalData> _nodeData;
+};
+
+#endif // SIGNALDECODERMODEL_H
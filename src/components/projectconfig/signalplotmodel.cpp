@@ -0,0 +1,44 @@
+#include "signalplotmodel.h"
+#include <datamodeltypes/nodedatacast.h>
+#include <datamodeltypes/signaldata.h>
+#include <log.h>
+
+SignalPlotModel::SignalPlotModel()
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "SignalPlot Node";
+    _name = "SignalPlotModel";
+    _modelName = "Signal plot";
+
+    connect(this, &SignalPlotModel::signalsReceived, &_component, &SignalPlot::signalsReceived);
+}
+
+unsigned int SignalPlotModel::nPorts(PortType portType) const
+{
+    return (PortType::In == portType) ? 1 : 0;
+}
+
+NodeDataType SignalPlotModel::dataType(PortType, PortIndex) const
+{
+    return SignalData().type();
+}
+
+std::shared_ptr<NodeData> SignalPlotModel::outData(PortIndex)
+{
+    return std::make_shared<SignalData>();
+}
+
+void SignalPlotModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (nodeData) {
+        auto d = nodeDataCast<SignalData>(nodeData);
+        assert(nullptr != d);
+
+        emit signalsReceived(d->samples(), d->catalog());
+    } else {
+        cds_warn("Incorrect nodeData");
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef SIGNALPLOTMODEL_H
+#define SIGNALPLOTMODEL_H
+
+#include "componentmodel.h"
+#include <signalplot.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+/**
+*   @brief The class provides node graphical representation of SignalPlot
+*/
+class SignalPlotModel : public ComponentModel<SignalPlot, SignalPlotModel> {
+    Q_OBJECT
+
+public:
+    SignalPlotModel();
+    virtual ~SignalPlotModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 if port in, 0 if any other type
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return SignalData type, so plot can be connected to SignalDecoder
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation, not used in this class
+    *   @param  port id
+    *   @return
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes samples to SignalPlot
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    /**
+    *   @brief  Emits signal once per received batch of samples
+    *   @param  samples decoded values
+    *   @param  catalog description of signals samples refer to
+    */
+    void signalsReceived(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog);
+};
+
+#endif // SIGNALPLOTMODEL_H
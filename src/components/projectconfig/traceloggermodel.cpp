@@ -0,0 +1,49 @@
+#include "traceloggermodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+
+TraceLoggerModel::TraceLoggerModel()
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "TraceLogger Node";
+    _name = "TraceLoggerModel";
+    _modelName = "Trace logger";
+
+    connect(this, &TraceLoggerModel::frameBatchSent, &_component, &TraceLogger::frameBatchSent);
+    connect(this, &TraceLoggerModel::frameBatchReceived, &_component, &TraceLogger::frameBatchReceived);
+}
+
+unsigned int TraceLoggerModel::nPorts(PortType portType) const
+{
+    return (PortType::In == portType) ? 1 : 0;
+}
+
+NodeDataType TraceLoggerModel::dataType(PortType, PortIndex) const
+{
+    return CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> TraceLoggerModel::outData(PortIndex)
+{
+    return std::make_shared<CanRawViewDataIn>();
+}
+
+void TraceLoggerModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (nodeData) {
+        auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+        assert(nullptr != d);
+
+        if (d->direction() == Direction::TX) {
+            emit frameBatchSent(d->status(), d->records());
+        } else {
+            emit frameBatchReceived(d->records());
+        }
+    } else {
+        cds_warn("Incorrect nodeData");
+    }
+}
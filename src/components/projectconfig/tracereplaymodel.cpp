@@ -0,0 +1,43 @@
+#include "tracereplaymodel.h"
+#include <datamodeltypes/canrawsenderdata.h>
+#include <poolallocator.h>
+
+TraceReplayModel::TraceReplayModel()
+    : _nodeData(std::make_shared<CanRawSenderDataOut>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    connect(&_component, &TraceReplay::sendFrames, this, &TraceReplayModel::sendFrames);
+
+    _caption = "TraceReplay Node";
+    _name = "TraceReplayModel";
+    _modelName = "Trace replay";
+}
+
+NodeDataType TraceReplayModel::dataType(PortType, PortIndex) const
+{
+    return CanRawSenderDataOut().type();
+}
+
+std::shared_ptr<NodeData> TraceReplayModel::outData(PortIndex)
+{
+    return _nodeData;
+}
+
+void TraceReplayModel::sendFrames(const CanFrameBatch& frames)
+{
+    // Whole batch is propagated at once, CanDeviceModel passes it to CanDevice::sendFrames
+    if (_flowPlanActive) {
+        return;
+    }
+
+    _nodeData = Pool::makeShared<CanRawSenderDataOut>(frames);
+    emit dataUpdated(0); // Data ready on port 0
+}
+
+unsigned int TraceReplayModel::nPorts(PortType portType) const
+{
+    return (PortType::Out == portType) ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+#ifndef TRACEREPLAYMODEL_H
+#define TRACEREPLAYMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <tracereplay.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class CanDeviceDataIn;
+
+/**
+*   @brief The class provides node graphical representation of TraceReplay
+*/
+class TraceReplayModel : public ComponentModel<TraceReplay, TraceReplayModel> {
+    Q_OBJECT
+
+public:
+    TraceReplayModel();
+    virtual ~TraceReplayModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 if port out, 0 if any other type
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return same type as CanRawSender output, so replay can feed CAN device
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return batch of frames due in last replay tick
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, not used in this class
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData>, PortIndex) override{};
+
+public slots:
+    /**
+    *   @brief  Callback, called when TraceReplay emits signal sendFrames
+    *   @param  frames frames to be sent
+    */
+    void sendFrames(const CanFrameBatch& frames);
+
+private:
+    std::shared_ptr<CanDeviceDataIn> _nodeData;
+};
+
+#endif // TRACEREPLAYMODEL_H
@@ -0,0 +1,88 @@
+#include "triggermodel.h"
+#include <datamodeltypes/canrawviewdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <datamodeltypes/signaldata.h>
+#include <log.h>
+#include <poolallocator.h>
+
+constexpr PortIndex TriggerModel::kFramePort;
+constexpr PortIndex TriggerModel::kSignalPort;
+
+TriggerModel::TriggerModel()
+    : _frames(std::make_shared<CanDeviceDataOut>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "Trigger Node";
+    _name = "TriggerModel";
+    _modelName = "Trigger";
+
+    connect(this, &TriggerModel::frameBatchSent, &_component, &Trigger::frameBatchSent);
+    connect(this, &TriggerModel::frameBatchReceived, &_component, &Trigger::frameBatchReceived);
+    connect(this, &TriggerModel::signalsReceived, &_component, &Trigger::signalsReceived);
+    connect(&_component, &Trigger::framesCaptured, this, &TriggerModel::framesCaptured);
+}
+
+unsigned int TriggerModel::nPorts(PortType portType) const
+{
+    switch (portType) {
+    case PortType::In:
+        return 2;
+    case PortType::Out:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+NodeDataType TriggerModel::dataType(PortType portType, PortIndex portIndex) const
+{
+    if ((PortType::In == portType) && (portIndex == kSignalPort)) {
+        return SignalData().type();
+    }
+
+    return CanRawViewDataIn().type();
+}
+
+std::shared_ptr<NodeData> TriggerModel::outData(PortIndex)
+{
+    return _frames;
+}
+
+void TriggerModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex port)
+{
+    if (!nodeData) {
+        cds_warn("Incorrect nodeData");
+        return;
+    }
+
+    if (port == kSignalPort) {
+        auto d = nodeDataCast<SignalData>(nodeData);
+        assert(nullptr != d);
+
+        emit signalsReceived(d->samples(), d->catalog());
+        return;
+    }
+
+    auto d = nodeDataCast<CanRawViewDataIn>(nodeData);
+    assert(nullptr != d);
+
+    if (d->direction() == Direction::TX) {
+        emit frameBatchSent(d->status(), d->records());
+    } else {
+        emit frameBatchReceived(d->records());
+    }
+}
+
+void TriggerModel::framesCaptured(const CanFrameBatch& frames)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    // Captured frames keep their direction flags, TraceLogger writes them as they are
+    _frames = Pool::makeShared<CanDeviceDataOut>(frames, Direction::RX, true);
+    emit dataUpdated(0); // Data ready on port 0
+}
@@ -0,0 +1,73 @@
+#ifndef TRIGGERMODEL_H
+#define TRIGGERMODEL_H
+
+#include "componentmodel.h"
+#include <canframerecord.h>
+#include <trigger.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class CanDeviceDataOut;
+
+/**
+*   @brief The class provides node graphical representation of Trigger
+*/
+class TriggerModel : public ComponentModel<Trigger, TriggerModel> {
+    Q_OBJECT
+
+public:
+    // Input port 0 carries frames, port 1 decoded signals
+    static constexpr PortIndex kFramePort = 0;
+    static constexpr PortIndex kSignalPort = 1;
+
+    TriggerModel();
+    virtual ~TriggerModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 2 for in port, 1 for out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return frames on kFramePort and output, SignalData on kSignalPort
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return captured frames
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes frames or samples to Trigger
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void signalsReceived(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog);
+
+public slots:
+    /**
+    *   @brief  Callback, called when Trigger emits captured frames
+    */
+    void framesCaptured(const CanFrameBatch& frames);
+
+private:
+    std::shared_ptr<CanDeviceDataOut> _frames;
+};
+
+#endif // TRIGGERMODEL_H
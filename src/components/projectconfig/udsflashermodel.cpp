@@ -0,0 +1,54 @@
+#include "udsflashermodel.h"
+#include <datamodeltypes/isotpdata.h>
+#include <datamodeltypes/nodedatacast.h>
+#include <log.h>
+#include <poolallocator.h>
+
+UdsFlasherModel::UdsFlasherModel()
+    : _pdu(std::make_shared<IsoTpData>())
+{
+    _label->setAlignment(Qt::AlignVCenter | Qt::AlignHCenter);
+    _label->setFixedSize(75, 25);
+    _label->setAttribute(Qt::WA_TranslucentBackground);
+
+    _caption = "UdsFlasher Node";
+    _name = "UdsFlasherModel";
+    _modelName = "UDS flasher";
+
+    connect(this, &UdsFlasherModel::pduReceived, &_component, &UdsFlasher::pduReceived);
+    connect(&_component, &UdsFlasher::sendPdu, this, &UdsFlasherModel::sendPdu);
+}
+
+unsigned int UdsFlasherModel::nPorts(PortType portType) const
+{
+    return (PortType::None != portType) ? 1 : 0;
+}
+
+NodeDataType UdsFlasherModel::dataType(PortType, PortIndex) const
+{
+    return IsoTpData().type();
+}
+
+std::shared_ptr<NodeData> UdsFlasherModel::outData(PortIndex)
+{
+    return _pdu;
+}
+
+void UdsFlasherModel::setInData(std::shared_ptr<NodeData> nodeData, PortIndex)
+{
+    if (nodeData) {
+        emit pduReceived(nodeDataCast<IsoTpData>(nodeData)->pdu());
+    } else {
+        cds_warn("Incorrect nodeData");
+    }
+}
+
+void UdsFlasherModel::sendPdu(const IsoTpPdu& pdu)
+{
+    if (_flowPlanActive) {
+        return;
+    }
+
+    _pdu = Pool::makeShared<IsoTpData>(pdu);
+    emit dataUpdated(0); // Data ready on port 0
+}
@@ -0,0 +1,66 @@
+#ifndef UDSFLASHERMODEL_H
+#define UDSFLASHERMODEL_H
+
+#include "componentmodel.h"
+#include <udsflasher.h>
+
+using QtNodes::PortType;
+using QtNodes::PortIndex;
+using QtNodes::NodeData;
+using QtNodes::NodeDataType;
+
+class IsoTpData;
+
+/**
+*   @brief The class provides node graphical representation of UdsFlasher
+*/
+class UdsFlasherModel : public ComponentModel<UdsFlasher, UdsFlasherModel> {
+    Q_OBJECT
+
+public:
+    UdsFlasherModel();
+    virtual ~UdsFlasherModel() = default;
+
+    /**
+    *   @brief  Used to get number of ports of each type used by model
+    *   @param  type of port
+    *   @return 1 for both in and out port
+    */
+    unsigned int nPorts(PortType portType) const override;
+
+    /**
+    *   @brief  Used to get data type of each port
+    *   @param  type of port
+    *   @patam  port id
+    *   @return IsoTpData for both ports, requests go out and responses come in
+    */
+    NodeDataType dataType(PortType portType, PortIndex portIndex) const override;
+
+    /**
+    *   @brief  Sets output data for propagation
+    *   @param  port id
+    *   @return last request
+    */
+    std::shared_ptr<NodeData> outData(PortIndex port) override;
+
+    /**
+    *   @brief  Handles data on input port, passes responses to UdsFlasher
+    *   @param  data on port
+    *   @param  port id
+    */
+    void setInData(std::shared_ptr<NodeData> nodeData, PortIndex port) override;
+
+signals:
+    void pduReceived(const IsoTpPdu& pdu);
+
+public slots:
+    /**
+    *   @brief  Callback, called when UdsFlasher emits request. Propagated synchronously, so view stays valid.
+    */
+    void sendPdu(const IsoTpPdu& pdu);
+
+private:
+    std::shared_ptr<IsoTpData> _pdu;
+};
+
+#endif // UDSFLASHERMODEL_H
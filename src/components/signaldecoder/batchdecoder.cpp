@@ -0,0 +1,312 @@
+#include "batchdecoder.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define CDS_HAVE_SSE2
+#include <emmintrin.h>
+// AVX2 kernel is built with function level target, so the rest of code keeps baseline instruction set
+#if defined(__GNUC__)
+#define CDS_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__)
+#define CDS_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+constexpr std::size_t kRowSize = DecodePlan::kPaddedPayload;
+constexpr std::size_t kChunkRows = 256;
+// Vector kernels convert integers to double by adding exponent bits, which is exact up to 52 bits
+constexpr int kMaxVectorBits = 52;
+constexpr quint64 kExponentBits = 0x4330000000000000ULL; // 2^52 as double
+constexpr double kExponentValue = 4503599627370496.0;
+
+typedef void (*KernelFn)(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out);
+
+template <bool BigEndian> inline quint64 loadWord(const uchar* p)
+{
+    quint64 word;
+
+    std::memcpy(&word, p, sizeof(word));
+    word = qFromLittleEndian(word);
+
+    return BigEndian ? qbswap(word) : word;
+}
+
+void scalarKernel(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = DecodePlan::physical(plan, DecodePlan::extract(plan, rows + i * kRowSize));
+    }
+}
+
+#ifdef CDS_HAVE_SSE2
+template <bool BigEndian> void sse2Rows(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out)
+{
+    const __m128i shift = _mm_cvtsi32_si128(plan.shift);
+    const __m128i hiShift = _mm_cvtsi32_si128(63 - plan.shift);
+    const __m128i mask = _mm_set1_epi64x(static_cast<qint64>(plan.mask));
+    const __m128i signBit = _mm_set1_epi64x(static_cast<qint64>(plan.signBit));
+    const __m128i exponent = _mm_set1_epi64x(static_cast<qint64>(kExponentBits));
+    const __m128d bias = _mm_set1_pd(kExponentValue + static_cast<double>(plan.signBit));
+    const __m128d factor = _mm_set1_pd(plan.factor);
+    const __m128d offset = _mm_set1_pd(plan.offset);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        const uchar* r0 = rows + i * kRowSize;
+        const uchar* r1 = r0 + kRowSize;
+        const __m128i lo = _mm_set_epi64x(static_cast<qint64>(loadWord<BigEndian>(r1 + plan.loOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r0 + plan.loOffset)));
+        const __m128i hi = _mm_set_epi64x(static_cast<qint64>(loadWord<BigEndian>(r1 + plan.hiOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r0 + plan.hiOffset)));
+
+        __m128i raw = _mm_or_si128(_mm_srl_epi64(lo, shift), _mm_sll_epi64(_mm_slli_epi64(hi, 1), hiShift));
+        // Flipping sign bit maps signed range onto unsigned one, bias removes the offset again
+        raw = _mm_or_si128(_mm_xor_si128(_mm_and_si128(raw, mask), signBit), exponent);
+        const __m128d value = _mm_sub_pd(_mm_castsi128_pd(raw), bias);
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_mul_pd(value, factor), offset));
+    }
+
+    scalarKernel(plan, rows + i * kRowSize, count - i, out + i);
+}
+
+void sse2Kernel(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out)
+{
+    plan.bigEndian ? sse2Rows<true>(plan, rows, count, out) : sse2Rows<false>(plan, rows, count, out);
+}
+#endif
+
+#ifdef CDS_HAVE_AVX2
+template <bool BigEndian>
+__attribute__((target("avx2"))) void avx2Rows(const SignalPlan& plan, const uchar* rows, std::size_t count,
+    double* out)
+{
+    const __m128i shift = _mm_cvtsi32_si128(plan.shift);
+    const __m128i hiShift = _mm_cvtsi32_si128(63 - plan.shift);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<qint64>(plan.mask));
+    const __m256i signBit = _mm256_set1_epi64x(static_cast<qint64>(plan.signBit));
+    const __m256i exponent = _mm256_set1_epi64x(static_cast<qint64>(kExponentBits));
+    const __m256d bias = _mm256_set1_pd(kExponentValue + static_cast<double>(plan.signBit));
+    const __m256d factor = _mm256_set1_pd(plan.factor);
+    const __m256d offset = _mm256_set1_pd(plan.offset);
+    std::size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        const uchar* r = rows + i * kRowSize;
+        const __m256i lo = _mm256_set_epi64x(static_cast<qint64>(loadWord<BigEndian>(r + 3 * kRowSize + plan.loOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r + 2 * kRowSize + plan.loOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r + kRowSize + plan.loOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r + plan.loOffset)));
+        const __m256i hi = _mm256_set_epi64x(static_cast<qint64>(loadWord<BigEndian>(r + 3 * kRowSize + plan.hiOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r + 2 * kRowSize + plan.hiOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r + kRowSize + plan.hiOffset)),
+            static_cast<qint64>(loadWord<BigEndian>(r + plan.hiOffset)));
+
+        __m256i raw
+            = _mm256_or_si256(_mm256_srl_epi64(lo, shift), _mm256_sll_epi64(_mm256_slli_epi64(hi, 1), hiShift));
+        raw = _mm256_or_si256(_mm256_xor_si256(_mm256_and_si256(raw, mask), signBit), exponent);
+        const __m256d value = _mm256_sub_pd(_mm256_castsi256_pd(raw), bias);
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(value, factor), offset));
+    }
+
+    scalarKernel(plan, rows + i * kRowSize, count - i, out + i);
+}
+
+void avx2Kernel(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out)
+{
+    plan.bigEndian ? avx2Rows<true>(plan, rows, count, out) : avx2Rows<false>(plan, rows, count, out);
+}
+#endif
+
+#ifdef CDS_HAVE_NEON
+template <bool BigEndian> void neonRows(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out)
+{
+    // NEON shifts right by shifting left with negative count
+    const int64x2_t shift = vdupq_n_s64(-static_cast<qint64>(plan.shift));
+    const int64x2_t hiShift = vdupq_n_s64(63 - plan.shift);
+    const uint64x2_t mask = vdupq_n_u64(plan.mask);
+    const uint64x2_t signBit = vdupq_n_u64(plan.signBit);
+    const uint64x2_t exponent = vdupq_n_u64(kExponentBits);
+    const float64x2_t bias = vdupq_n_f64(kExponentValue + static_cast<double>(plan.signBit));
+    const float64x2_t factor = vdupq_n_f64(plan.factor);
+    const float64x2_t offset = vdupq_n_f64(plan.offset);
+    std::size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        const uchar* r0 = rows + i * kRowSize;
+        const uchar* r1 = r0 + kRowSize;
+        const uint64x2_t lo = vcombine_u64(vcreate_u64(loadWord<BigEndian>(r0 + plan.loOffset)),
+            vcreate_u64(loadWord<BigEndian>(r1 + plan.loOffset)));
+        const uint64x2_t hi = vcombine_u64(vcreate_u64(loadWord<BigEndian>(r0 + plan.hiOffset)),
+            vcreate_u64(loadWord<BigEndian>(r1 + plan.hiOffset)));
+
+        uint64x2_t raw = vorrq_u64(vshlq_u64(lo, shift), vshlq_u64(vshlq_n_u64(hi, 1), hiShift));
+        raw = vorrq_u64(veorq_u64(vandq_u64(raw, mask), signBit), exponent);
+        const float64x2_t value = vsubq_f64(vreinterpretq_f64_u64(raw), bias);
+        vst1q_f64(out + i, vaddq_f64(vmulq_f64(value, factor), offset));
+    }
+
+    scalarKernel(plan, rows + i * kRowSize, count - i, out + i);
+}
+
+void neonKernel(const SignalPlan& plan, const uchar* rows, std::size_t count, double* out)
+{
+    plan.bigEndian ? neonRows<true>(plan, rows, count, out) : neonRows<false>(plan, rows, count, out);
+}
+#endif
+
+KernelFn kernelFunction(BatchDecoder::Kernel kernel)
+{
+    switch (kernel) {
+#ifdef CDS_HAVE_SSE2
+    case BatchDecoder::Kernel::Sse2:
+        return sse2Kernel;
+#endif
+#ifdef CDS_HAVE_AVX2
+    case BatchDecoder::Kernel::Avx2:
+        return avx2Kernel;
+#endif
+#ifdef CDS_HAVE_NEON
+    case BatchDecoder::Kernel::Neon:
+        return neonKernel;
+#endif
+    default:
+        return scalarKernel;
+    }
+}
+
+bool isVectorizable(const SignalPlan& plan)
+{
+    return (plan.mask >> kMaxVectorBits) == 0;
+}
+} // namespace
+
+namespace BatchDecoder {
+bool isSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+#ifdef CDS_HAVE_SSE2
+    case Kernel::Sse2:
+        return true;
+#endif
+#ifdef CDS_HAVE_AVX2
+    case Kernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef CDS_HAVE_NEON
+    case Kernel::Neon:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+Kernel bestKernel()
+{
+    static const Kernel best = [] {
+        for (auto kernel : { Kernel::Avx2, Kernel::Sse2, Kernel::Neon }) {
+            if (isSupported(kernel)) {
+                return kernel;
+            }
+        }
+
+        return Kernel::Scalar;
+    }();
+
+    return best;
+}
+
+const char* kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Sse2:
+        return "SSE2";
+    case Kernel::Avx2:
+        return "AVX2";
+    case Kernel::Neon:
+        return "NEON";
+    default:
+        return "scalar";
+    }
+}
+
+bool decode(const DecodePlan& plan, const CanFrameRecord* records, std::size_t count, SignalColumns& columns,
+    Kernel kernel)
+{
+    columns.timestamps.clear();
+    columns.signalIds.clear();
+    columns.values.clear();
+
+    if (count == 0) {
+        return true;
+    }
+
+    const CanFrameRecord& first = records[0];
+    const bool extended = first.hasFlag(CanFrameRecord::ExtendedId);
+    const MessagePlan* msg = plan.find(first.id, extended);
+    if (!msg) {
+        return false;
+    }
+
+    const KernelFn vectorKernel = kernelFunction(isSupported(kernel) ? kernel : bestKernel());
+    const SignalPlan* plans = plan.signalPlans().data() + msg->firstSignal;
+    const double absent = std::numeric_limits<double>::quiet_NaN();
+
+    columns.timestamps.resize(count);
+    columns.values.resize(msg->signalCount, std::vector<double>(count));
+    for (quint32 s = 0; s < msg->signalCount; ++s) {
+        columns.signalIds.push_back(plans[s].signal);
+    }
+
+    std::vector<uchar> rows(kChunkRows * kRowSize);
+    std::vector<int> lengths(kChunkRows);
+    std::vector<qint64> mux(kChunkRows, -1);
+
+    for (std::size_t start = 0; start < count; start += kChunkRows) {
+        const std::size_t n = std::min(kChunkRows, count - start);
+
+        for (std::size_t r = 0; r < n; ++r) {
+            const CanFrameRecord& rec = records[start + r];
+            const bool match = (rec.id == first.id) && (rec.hasFlag(CanFrameRecord::ExtendedId) == extended)
+                && !(rec.flags & (CanFrameRecord::Remote | CanFrameRecord::Error));
+            uchar* row = rows.data() + r * kRowSize;
+
+            // Frames of other messages get no payload and zero length, so no signal is present in them
+            lengths[r] = match ? qMin<int>(rec.length, CanFrameRecord::kMaxPayload) : 0;
+            std::memset(row, 0, kRowSize);
+            std::memcpy(row + DecodePlan::kPadding, rec.payload, lengths[r]);
+            columns.timestamps[start + r] = rec.timestamp;
+        }
+
+        if (msg->muxSignal >= 0) {
+            const SignalPlan& muxPlan = plan.signalPlans()[msg->muxSignal];
+
+            for (std::size_t r = 0; r < n; ++r) {
+                mux[r] = static_cast<qint64>(DecodePlan::extract(muxPlan, rows.data() + r * kRowSize));
+            }
+        }
+
+        for (quint32 s = 0; s < msg->signalCount; ++s) {
+            const SignalPlan& sig = plans[s];
+            double* out = columns.values[s].data() + start;
+
+            (isVectorizable(sig) ? vectorKernel : scalarKernel)(sig, rows.data(), n, out);
+
+            for (std::size_t r = 0; r < n; ++r) {
+                const bool present = (lengths[r] >= sig.minLength) & ((sig.muxValue < 0) | (sig.muxValue == mux[r]));
+                out[r] = present ? out[r] : absent;
+            }
+        }
+    }
+
+    return true;
+}
+} // namespace BatchDecoder
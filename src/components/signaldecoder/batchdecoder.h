@@ -0,0 +1,51 @@
+#ifndef BATCHDECODER_H
+#define BATCHDECODER_H
+
+#include "decodeplan.h"
+#include <vector>
+
+/**
+*   @brief  Signals of one message decoded from many frames, one column per signal
+*/
+struct SignalColumns {
+    std::vector<quint64> timestamps; // one per decoded frame
+    std::vector<quint32> signalIds; // index in SignalCatalog of each column
+    std::vector<std::vector<double>> values; // values[column][frame], NaN where signal is not present in frame
+};
+
+/**
+*   @brief  Decoding of recorded traces, signal by signal across whole batch of frames
+*
+*   Frames are packed into zero padded rows in chunks. Each signal is then extracted from all rows of the chunk by
+*   vector kernel, so per frame overhead of DecodePlan::decode (lookup, dispatch over signals) is paid once per
+*   batch. Kernel is selected at runtime from instruction sets supported by CPU.
+*/
+namespace BatchDecoder {
+enum class Kernel { Scalar, Sse2, Avx2, Neon };
+
+/**
+*   @return fastest kernel supported by build and CPU
+*/
+Kernel bestKernel();
+
+/**
+*   @return true if kernel is compiled in and supported by CPU
+*/
+bool isSupported(Kernel kernel);
+
+const char* kernelName(Kernel kernel);
+
+/**
+*   @brief  Decodes frames of single message
+*   @param  plan decoding tables
+*   @param  records frames, message is selected by the first one. Frames with other ID get NaN in all columns.
+*   @param  count number of frames
+*   @param  columns decoded signals, previous contents are replaced
+*   @param  kernel kernel to be used, falls back to bestKernel() if not supported
+*   @return false if message of first frame is not known (columns are emptied)
+*/
+bool decode(const DecodePlan& plan, const CanFrameRecord* records, std::size_t count, SignalColumns& columns,
+    Kernel kernel = bestKernel());
+} // namespace BatchDecoder
+
+#endif // BATCHDECODER_H
@@ -0,0 +1,139 @@
+#include "dbcparser.h"
+#include <QtCore/QFile>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStringList>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+const quint32 kExtendedIdFlag = 0x80000000U;
+const quint32 kExtendedIdMask = 0x1fffffffU;
+// Container of signals not assigned to any message, generated by most DBC editors
+const char kIndependentSignalsMessage[] = "VECTOR__INDEPENDENT_SIG_MSG";
+
+bool parseMessage(const QRegularExpressionMatch& match, DbcMessage& message)
+{
+    bool idOk = false;
+    bool lengthOk = false;
+    const quint32 id = match.captured(1).toUInt(&idOk);
+
+    message.extended = (id & kExtendedIdFlag) != 0;
+    message.id = id & kExtendedIdMask;
+    message.name = match.captured(2);
+    message.length = match.captured(3).toInt(&lengthOk);
+
+    return idOk && lengthOk;
+}
+
+bool parseSignal(const QRegularExpressionMatch& match, DbcSignal& signal)
+{
+    bool ok[7] = {};
+    const QString mux = match.captured(2);
+
+    signal.name = match.captured(1);
+    signal.startBit = static_cast<quint16>(match.captured(3).toUInt(&ok[0]));
+    signal.length = static_cast<quint8>(match.captured(4).toUInt(&ok[1]));
+    signal.bigEndian = match.captured(5) == "0";
+    signal.isSigned = match.captured(6) == "-";
+    signal.factor = match.captured(7).toDouble(&ok[2]);
+    signal.offset = match.captured(8).toDouble(&ok[3]);
+    signal.minimum = match.captured(9).toDouble(&ok[4]);
+    signal.maximum = match.captured(10).toDouble(&ok[5]);
+    signal.unit = match.captured(11);
+    ok[6] = true;
+
+    if (mux == "M") {
+        signal.mux = DbcSignal::Mux::Multiplexer;
+    } else if (mux.startsWith('m')) {
+        // Extended multiplexing (m<n>M) is read as plain multiplexed signal
+        signal.mux = DbcSignal::Mux::Multiplexed;
+        signal.muxValue = mux.mid(1, mux.endsWith('M') ? mux.size() - 2 : -1).toUInt(&ok[6]);
+    }
+
+    return std::all_of(std::begin(ok), std::end(ok), [](bool b) { return b; });
+}
+} // namespace
+
+namespace DbcParser {
+bool parse(const QString& text, std::vector<DbcMessage>& messages, QString& error)
+{
+    static const QRegularExpression messageRe(R"(^\s*BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+))");
+    static const QRegularExpression signalRe(R"(^\s*SG_\s+(\w+)\s*(M|m\d+M?)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*)"
+                                             R"(\(\s*([^,\s]+)\s*,\s*([^)\s]+)\s*\)\s*)"
+                                             R"(\[\s*([^|\s]+)\s*\|\s*([^\]\s]+)\s*\]\s*"([^"]*)")");
+    // Attributes usually follow all message definitions
+    static const QRegularExpression cycleTimeDefaultRe(R"(^\s*BA_DEF_DEF_\s+"GenMsgCycleTime"\s+(\d+)\s*;)");
+    static const QRegularExpression cycleTimeRe(R"(^\s*BA_\s+"GenMsgCycleTime"\s+BO_\s+(\d+)\s+(\d+)\s*;)");
+    const QStringList lines = text.split('\n');
+    bool skipSignals = true;
+    int defaultCycleTime = 0;
+    std::unordered_map<quint32, int> cycleTimes;
+
+    messages.clear();
+
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString& line = lines[i];
+
+        if (line.trimmed().startsWith("BO_ ")) {
+            const auto match = messageRe.match(line);
+            DbcMessage message;
+
+            if (!match.hasMatch() || !parseMessage(match, message)) {
+                error = QString("Malformed message definition at line %1").arg(i + 1);
+                return false;
+            }
+
+            skipSignals = (message.name == kIndependentSignalsMessage);
+            if (!skipSignals) {
+                messages.push_back(message);
+            }
+        } else if (line.trimmed().startsWith("SG_ ")) {
+            const auto match = signalRe.match(line);
+            DbcSignal signal;
+
+            if (!match.hasMatch() || !parseSignal(match, signal)) {
+                error = QString("Malformed signal definition at line %1").arg(i + 1);
+                return false;
+            }
+
+            if (skipSignals) {
+                continue;
+            }
+
+            messages.back().signalList.push_back(signal);
+        } else if (line.trimmed().startsWith("BA_")) {
+            const auto match = cycleTimeRe.match(line);
+
+            if (match.hasMatch()) {
+                cycleTimes[match.captured(1).toUInt()] = match.captured(2).toInt();
+            } else {
+                const auto defaultMatch = cycleTimeDefaultRe.match(line);
+
+                if (defaultMatch.hasMatch()) {
+                    defaultCycleTime = defaultMatch.captured(1).toInt();
+                }
+            }
+        }
+    }
+
+    for (auto& message : messages) {
+        const auto it = cycleTimes.find(message.extended ? (message.id | kExtendedIdFlag) : message.id);
+        message.cycleTime = (it != cycleTimes.end()) ? it->second : defaultCycleTime;
+    }
+
+    return true;
+}
+
+bool load(const QString& path, std::vector<DbcMessage>& messages, QString& error)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = file.errorString();
+        return false;
+    }
+
+    // DBC files are commonly written in Windows-1252, Latin-1 covers names and units good enough
+    return parse(QString::fromLatin1(file.readAll()), messages, error);
+}
+} // namespace DbcParser
@@ -0,0 +1,61 @@
+#ifndef DBCPARSER_H
+#define DBCPARSER_H
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <vector>
+
+/**
+*   @brief  Signal definition (SG_ line) of DBC file
+*/
+struct DbcSignal {
+    enum class Mux { None, Multiplexer, Multiplexed };
+
+    QString name;
+    quint16 startBit{ 0 }; // LSB for little endian (Intel), MSB for big endian (Motorola) signals
+    quint8 length{ 0 };
+    bool bigEndian{ false };
+    bool isSigned{ false };
+    double factor{ 1.0 };
+    double offset{ 0.0 };
+    double minimum{ 0.0 };
+    double maximum{ 0.0 };
+    QString unit;
+    Mux mux{ Mux::None };
+    quint32 muxValue{ 0 }; // multiplexer value the signal is present for, Multiplexed signals only
+};
+
+/**
+*   @brief  Message definition (BO_ line) of DBC file
+*/
+struct DbcMessage {
+    quint32 id{ 0 };
+    bool extended{ false };
+    QString name;
+    int length{ 0 };
+    int cycleTime{ 0 }; // GenMsgCycleTime attribute in ms, 0 for messages not sent cyclically
+    std::vector<DbcSignal> signalList;
+};
+
+/**
+*   @brief  Minimal DBC reader. Only messages, signals and cycle time attribute of messages are read, other sections
+*           (comments, other attributes, value tables, ...) are skipped.
+*/
+namespace DbcParser {
+/**
+*   @brief  Parses DBC document
+*   @param  text file contents
+*   @param  messages parsed messages
+*   @param  error description of first malformed line, set if false is returned
+*   @return false if document is malformed
+*/
+bool parse(const QString& text, std::vector<DbcMessage>& messages, QString& error);
+
+/**
+*   @brief  Reads and parses DBC file
+*   @see    parse
+*/
+bool load(const QString& path, std::vector<DbcMessage>& messages, QString& error);
+} // namespace DbcParser
+
+#endif // DBCPARSER_H
@@ -0,0 +1,195 @@
+#include "decodeplan.h"
+#include <algorithm>
+#include <log.h>
+
+constexpr int DecodePlan::kPadding;
+constexpr int DecodePlan::kPaddedPayload;
+constexpr quint16 DecodePlan::kNoMessage;
+constexpr int DecodePlan::kStandardIds;
+
+namespace {
+bool compileSignal(const DbcSignal& signal, SignalPlan& plan)
+{
+    const int length = signal.length;
+    int lsbByte;
+    int lsbBit;
+
+    if ((length < 1) || (length > 64)) {
+        return false;
+    }
+
+    if (signal.bigEndian) {
+        // Start bit is MSB. Bits are counted from MSB of first byte to find LSB of the signal.
+        const int lsbPos = (signal.startBit / 8) * 8 + (7 - signal.startBit % 8) + length - 1;
+
+        lsbByte = lsbPos / 8;
+        lsbBit = 7 - lsbPos % 8;
+        plan.minLength = static_cast<quint8>(lsbByte + 1);
+        // Word ending at LSB byte, previous 8 bytes are more significant
+        plan.loOffset = static_cast<qint16>(DecodePlan::kPadding + lsbByte - 7);
+        plan.hiOffset = static_cast<qint16>(plan.loOffset - 8);
+    } else {
+        const int msbPos = signal.startBit + length - 1;
+
+        lsbByte = signal.startBit / 8;
+        lsbBit = signal.startBit % 8;
+        plan.minLength = static_cast<quint8>(msbPos / 8 + 1);
+        plan.loOffset = static_cast<qint16>(DecodePlan::kPadding + lsbByte);
+        plan.hiOffset = static_cast<qint16>(plan.loOffset + 8);
+    }
+
+    if ((lsbByte >= CanFrameRecord::kMaxPayload) || (plan.minLength > CanFrameRecord::kMaxPayload)) {
+        return false;
+    }
+
+    plan.shift = static_cast<quint8>(lsbBit);
+    plan.bigEndian = signal.bigEndian ? 1 : 0;
+    plan.isSigned = signal.isSigned ? 1 : 0;
+    plan.muxValue = (signal.mux == DbcSignal::Mux::Multiplexed) ? static_cast<qint32>(signal.muxValue) : -1;
+    plan.mask = (length == 64) ? ~0ULL : ((1ULL << length) - 1);
+    plan.signBit = signal.isSigned ? (1ULL << (length - 1)) : 0;
+    plan.factor = signal.factor;
+    plan.offset = signal.offset;
+
+    return true;
+}
+} // namespace
+
+DecodePlan::DecodePlan(const std::vector<DbcMessage>& messages)
+{
+    SignalCatalog catalog;
+
+    for (const auto& message : messages) {
+        if (_messages.size() >= kNoMessage) {
+            cds_warn("Too many messages, '{}' and following ones are not decoded", message.name.toStdString());
+            break;
+        }
+
+        if (message.extended ? (find(message.id, true) != nullptr)
+                             : ((message.id >= kStandardIds) || (find(message.id, false) != nullptr))) {
+            cds_warn("Message '{}' has invalid or duplicated ID {:#x}", message.name.toStdString(), message.id);
+            continue;
+        }
+
+        addMessage(message, catalog);
+    }
+
+    _catalog = std::make_shared<const SignalCatalog>(std::move(catalog));
+}
+
+void DecodePlan::addMessage(const DbcMessage& message, SignalCatalog& catalog)
+{
+    MessagePlan msg{ static_cast<quint32>(_signals.size()), 0, -1 };
+
+    for (const auto& signal : message.signalList) {
+        SignalPlan plan;
+
+        if (!compileSignal(signal, plan)) {
+            cds_warn("Signal '{}' of '{}' does not fit into frame, skipped", signal.name.toStdString(),
+                message.name.toStdString());
+            continue;
+        }
+
+        if (signal.mux == DbcSignal::Mux::Multiplexer) {
+            msg.muxSignal = static_cast<qint32>(_signals.size());
+        }
+
+        plan.signal = static_cast<quint32>(catalog.size());
+        catalog.push_back({ message.name, signal.name, signal.unit, message.id, message.extended, signal.minimum,
+            signal.maximum });
+        _signals.push_back(plan);
+        ++msg.signalCount;
+    }
+
+    const auto index = static_cast<quint16>(_messages.size());
+    if (message.extended) {
+        const std::pair<quint32, quint16> entry{ message.id, index };
+        _extendedLookup.insert(std::lower_bound(_extendedLookup.begin(), _extendedLookup.end(), entry), entry);
+    } else {
+        _standardLookup[message.id] = index;
+    }
+
+    _messages.push_back(msg);
+    _maxSignals = std::max<std::size_t>(_maxSignals, msg.signalCount);
+}
+
+const SignalCatalogPtr& DecodePlan::catalog() const
+{
+    return _catalog;
+}
+
+std::size_t DecodePlan::messageCount() const
+{
+    return _messages.size();
+}
+
+std::size_t DecodePlan::maxSignalsPerMessage() const
+{
+    return _maxSignals;
+}
+
+std::vector<std::pair<quint32, bool>> DecodePlan::messageIds() const
+{
+    std::vector<std::pair<quint32, bool>> ids;
+
+    for (int id = 0; id < kStandardIds; ++id) {
+        if (_standardLookup[id] != kNoMessage) {
+            ids.emplace_back(id, false);
+        }
+    }
+
+    for (const auto& entry : _extendedLookup) {
+        ids.emplace_back(entry.first, true);
+    }
+
+    return ids;
+}
+
+const MessagePlan* DecodePlan::find(quint32 id, bool extended) const
+{
+    if (!extended) {
+        const quint16 index = (id < kStandardIds) ? _standardLookup[id] : kNoMessage;
+
+        return (index != kNoMessage) ? &_messages[index] : nullptr;
+    }
+
+    const std::pair<quint32, quint16> key{ id, 0 };
+    const auto it = std::lower_bound(_extendedLookup.begin(), _extendedLookup.end(), key);
+
+    return ((it != _extendedLookup.end()) && (it->first == id)) ? &_messages[it->second] : nullptr;
+}
+
+const std::vector<SignalPlan>& DecodePlan::signalPlans() const
+{
+    return _signals;
+}
+
+std::size_t DecodePlan::decode(const CanFrameRecord& rec, SignalSample* out) const
+{
+    if (rec.flags & (CanFrameRecord::Remote | CanFrameRecord::Error)) {
+        return 0;
+    }
+
+    const MessagePlan* msg = find(rec.id, rec.hasFlag(CanFrameRecord::ExtendedId));
+    if (!msg) {
+        return 0;
+    }
+
+    uchar padded[kPaddedPayload] = {};
+    std::memcpy(padded + kPadding, rec.payload, qMin<int>(rec.length, CanFrameRecord::kMaxPayload));
+
+    const SignalPlan* plans = _signals.data() + msg->firstSignal;
+    const qint64 mux = (msg->muxSignal >= 0) ? static_cast<qint64>(extract(_signals[msg->muxSignal], padded)) : -1;
+    std::size_t count = 0;
+
+    for (quint32 i = 0; i < msg->signalCount; ++i) {
+        const SignalPlan& plan = plans[i];
+        const bool present = (rec.length >= plan.minLength) & ((plan.muxValue < 0) | (plan.muxValue == mux));
+
+        // Sample is always written and kept only if signal is present, so loop has no data dependent branches
+        out[count] = SignalSample{ rec.timestamp, plan.signal, 0, physical(plan, extract(plan, padded)) };
+        count += present ? 1 : 0;
+    }
+
+    return count;
+}
@@ -0,0 +1,147 @@
+#ifndef DECODEPLAN_H
+#define DECODEPLAN_H
+
+#include "dbcparser.h"
+#include <QtCore/QtEndian>
+#include <canframerecord.h>
+#include <cstring>
+#include <signalsample.h>
+#include <vector>
+
+/**
+*   @brief  Precomputed extraction of one signal
+*
+*   Signal is taken from two consecutive 64-bit words of zero padded payload, so any signal up to 64 bits long is
+*   extracted with the same funnel shift whatever its position and byte order.
+*/
+struct SignalPlan {
+    qint16 loOffset; // offset of less significant word in padded payload
+    qint16 hiOffset; // offset of more significant word
+    quint8 shift; // position of signal LSB in less significant word
+    quint8 bigEndian; // words are byte swapped on load
+    quint8 isSigned;
+    quint8 minLength; // payload bytes needed for signal to be present
+    qint32 muxValue; // multiplexer value signal is present for, -1 if signal is not multiplexed
+    quint32 signal; // index in SignalCatalog
+    quint64 mask;
+    quint64 signBit; // sign bit for signed signals, 0 for unsigned
+    double factor;
+    double offset;
+};
+
+/**
+*   @brief  Range of SignalPlan array used by one message
+*/
+struct MessagePlan {
+    quint32 firstSignal;
+    quint32 signalCount;
+    qint32 muxSignal; // index of multiplexer in SignalPlan array, -1 if message is not multiplexed
+};
+
+/**
+*   @brief  Decoding tables compiled from DBC messages
+*
+*   Plans of all signals are stored in one flat array, so decoding a frame walks contiguous memory. Standard IDs
+*   map to messages in a direct table, extended IDs in sorted array, no strings nor maps are touched per frame.
+*/
+class DecodePlan {
+public:
+    static constexpr int kPadding = 16; // bytes of zeros around payload, see SignalPlan
+    static constexpr int kPaddedPayload = CanFrameRecord::kMaxPayload + 2 * kPadding;
+
+    DecodePlan() = default;
+
+    /**
+    *   @brief  Builds plans for given messages. Signals that do not fit into CAN FD payload are skipped.
+    *   @param  messages DBC messages
+    */
+    explicit DecodePlan(const std::vector<DbcMessage>& messages);
+
+    /**
+    *   @return description of signals, indexed by SignalSample::signal
+    */
+    const SignalCatalogPtr& catalog() const;
+
+    /**
+    *   @return number of messages that can be decoded
+    */
+    std::size_t messageCount() const;
+
+    /**
+    *   @return upper bound of samples produced by decode for single frame
+    */
+    std::size_t maxSignalsPerMessage() const;
+
+    /**
+    *   @return ID and format of every decodable message
+    */
+    std::vector<std::pair<quint32, bool>> messageIds() const;
+
+    /**
+    *   @param  id frame ID
+    *   @param  extended true for 29-bit ID
+    *   @return plan of message, nullptr if message is not known
+    */
+    const MessagePlan* find(quint32 id, bool extended) const;
+
+    /**
+    *   @brief  All signal plans, indexed by MessagePlan::firstSignal
+    */
+    const std::vector<SignalPlan>& signalPlans() const;
+
+    /**
+    *   @brief  Decodes signals present in frame
+    *   @param  rec frame
+    *   @param  out output array of at least maxSignalsPerMessage() elements
+    *   @return number of samples written to out
+    */
+    std::size_t decode(const CanFrameRecord& rec, SignalSample* out) const;
+
+    /**
+    *   @brief  Extracts raw value. Inline as it is the innermost loop of decoding.
+    *   @param  padded payload with kPadding zero bytes on both sides
+    */
+    static quint64 extract(const SignalPlan& plan, const uchar* padded)
+    {
+        quint64 lo;
+        quint64 hi;
+
+        std::memcpy(&lo, padded + plan.loOffset, sizeof(lo));
+        std::memcpy(&hi, padded + plan.hiOffset, sizeof(hi));
+        lo = qFromLittleEndian(lo);
+        hi = qFromLittleEndian(hi);
+        lo = plan.bigEndian ? qbswap(lo) : lo;
+        hi = plan.bigEndian ? qbswap(hi) : hi;
+
+        // hi is shifted in two steps, so that shift == 0 does not shift by 64 (undefined)
+        const quint64 raw = ((lo >> plan.shift) | ((hi << 1) << (63 - plan.shift))) & plan.mask;
+
+        // Sign extension, no-op for unsigned signals (signBit == 0)
+        return (raw ^ plan.signBit) - plan.signBit;
+    }
+
+    /**
+    *   @brief  Converts raw value to physical one
+    */
+    static double physical(const SignalPlan& plan, quint64 raw)
+    {
+        const double value = plan.isSigned ? static_cast<double>(static_cast<qint64>(raw)) : static_cast<double>(raw);
+
+        return value * plan.factor + plan.offset;
+    }
+
+private:
+    void addMessage(const DbcMessage& message, SignalCatalog& catalog);
+
+    static constexpr quint16 kNoMessage = 0xffff;
+    static constexpr int kStandardIds = 0x800;
+
+    std::vector<SignalPlan> _signals;
+    std::vector<MessagePlan> _messages;
+    std::vector<quint16> _standardLookup = std::vector<quint16>(kStandardIds, kNoMessage);
+    std::vector<std::pair<quint32, quint16>> _extendedLookup; // sorted by ID
+    SignalCatalogPtr _catalog = std::make_shared<const SignalCatalog>();
+    std::size_t _maxSignals{ 0 };
+};
+
+#endif // DECODEPLAN_H
@@ -0,0 +1,404 @@
+#include "signalanalysis.h"
+#include "dbcparser.h"
+#include "decodeplan.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStringList>
+#include <algorithm>
+#include <cmath>
+#include <log.h>
+#include <thread>
+#include <tracereader.h>
+
+constexpr quint64 SignalAnalysis::kPartitionRecords;
+constexpr int SignalAnalysis::kDefaultHistogramBins;
+
+namespace {
+constexpr quint32 kCacheMagic = 0x41534443; // "CDSA"
+constexpr quint32 kCacheVersion = 1;
+
+/**
+*   @brief  Consecutive trace blocks analyzed by one thread
+*/
+struct Partition {
+    std::size_t firstBlock;
+    std::size_t blockCount;
+    quint64 records;
+};
+
+std::vector<Partition> partitions(const TraceReader& reader, quint64 partitionRecords)
+{
+    std::vector<Partition> result;
+    const auto& blocks = reader.blocks();
+
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        if (result.empty() || (result.back().records >= partitionRecords)) {
+            result.push_back({ i, 0, 0 });
+        }
+
+        ++result.back().blockCount;
+        result.back().records += blocks[i].count;
+    }
+
+    return result;
+}
+
+/**
+*   @brief  Creates empty aggregates of all signals. Histogram spans range given by DBC, or all raw values of signal
+*           if DBC does not give any.
+*/
+std::vector<SignalAggregate> emptyAggregates(const DecodePlan& plan, const SignalAnalysis::Options& options)
+{
+    const SignalCatalog& catalog = *plan.catalog();
+    std::vector<SignalAggregate> aggregates(catalog.size());
+
+    for (const auto& signal : plan.signalPlans()) {
+        const SignalInfo& info = catalog[signal.signal];
+        const QString key = info.message + QLatin1Char('.') + info.name;
+        double low = info.minimum;
+        double high = info.maximum;
+
+        if (!(high > low)) {
+            const double rawLow = signal.isSigned ? -static_cast<double>(signal.signBit) : 0.0;
+            const double rawHigh = signal.isSigned ? static_cast<double>(signal.signBit - 1)
+                                                   : static_cast<double>(signal.mask);
+
+            low = std::min(rawLow * signal.factor, rawHigh * signal.factor) + signal.offset;
+            high = std::max(rawLow * signal.factor, rawHigh * signal.factor) + signal.offset;
+        }
+
+        aggregates[signal.signal] = SignalAggregate(low, high, std::max(0, options.histogramBins),
+            options.thresholds.value(key, std::numeric_limits<double>::quiet_NaN()));
+    }
+
+    return aggregates;
+}
+
+void aggregate(const DecodePlan& plan, const TraceReader& reader, const Partition& partition,
+    std::vector<SignalAggregate>& aggregates)
+{
+    std::vector<SignalSample> samples(plan.maxSignalsPerMessage());
+
+    for (std::size_t b = partition.firstBlock; b < partition.firstBlock + partition.blockCount; ++b) {
+        const TraceReader::Block& block = reader.blocks()[b];
+        const CanFrameRecord* records = reader.record(block.firstRecord);
+
+        for (quint32 i = 0; i < block.count; ++i) {
+            // Values of failed transmissions never appeared on the bus
+            if (records[i].flags & CanFrameRecord::TxFailed) {
+                continue;
+            }
+
+            const std::size_t count = plan.decode(records[i], samples.data());
+            for (std::size_t s = 0; s < count; ++s) {
+                aggregates[samples[s].signal].add(samples[s].timestamp, samples[s].value);
+            }
+        }
+    }
+}
+
+/**
+*   @brief  Identifies trace, DBC and options report was made for
+*/
+QByteArray cacheKey(const QString& tracePath, const QString& dbcPath, const SignalAnalysis::Options& options)
+{
+    const QFileInfo trace(tracePath);
+    QCryptographicHash dbc(QCryptographicHash::Sha1);
+    QFile dbcFile(dbcPath);
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+
+    if (dbcFile.open(QIODevice::ReadOnly)) {
+        dbc.addData(&dbcFile);
+    }
+
+    out << kCacheVersion << static_cast<quint64>(trace.size()) << trace.lastModified().toMSecsSinceEpoch()
+        << dbc.result() << options.histogramBins;
+
+    QStringList keys = options.thresholds.keys();
+    keys.sort();
+    for (const auto& key : keys) {
+        out << key << options.thresholds.value(key);
+    }
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QDataStream& operator<<(QDataStream& out, const SignalAggregate& a)
+{
+    out << a.count << a.minimum << a.maximum << a.sum << a.low << a.high << a.threshold << a.aboveUs
+        << a.firstTimestamp << a.lastTimestamp << a.lastValue << static_cast<quint32>(a.histogram.size());
+    for (quint64 bin : a.histogram) {
+        out << bin;
+    }
+
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, SignalAggregate& a)
+{
+    quint32 bins = 0;
+
+    in >> a.count >> a.minimum >> a.maximum >> a.sum >> a.low >> a.high >> a.threshold >> a.aboveUs
+        >> a.firstTimestamp >> a.lastTimestamp >> a.lastValue >> bins;
+
+    // Corrupted count must not allocate the world
+    if ((in.status() != QDataStream::Ok) || (bins > (1U << 20))) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return in;
+    }
+
+    a.histogram.resize(bins);
+    for (auto& bin : a.histogram) {
+        in >> bin;
+    }
+
+    return in;
+}
+
+bool loadCache(const QString& path, const QByteArray& key, SignalAnalysis::Report& report)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    QByteArray cachedKey;
+    quint32 count = 0;
+
+    in >> magic >> cachedKey >> report.records >> report.firstTimestamp >> report.lastTimestamp >> count;
+    if ((magic != kCacheMagic) || (cachedKey != key) || (count != report.catalog->size())) {
+        return false;
+    }
+
+    report.aggregates.resize(count);
+    for (auto& aggregate : report.aggregates) {
+        in >> aggregate;
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+void saveCache(const QString& path, const QByteArray& key, const SignalAnalysis::Report& report)
+{
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        cds_warn("Failed to create analysis cache '{}': {}", path.toStdString(), file.errorString().toStdString());
+        return;
+    }
+
+    QDataStream out(&file);
+    out << kCacheMagic << key << report.records << report.firstTimestamp << report.lastTimestamp
+        << static_cast<quint32>(report.aggregates.size());
+    for (const auto& aggregate : report.aggregates) {
+        out << aggregate;
+    }
+
+    if (!file.commit()) {
+        cds_warn("Failed to write analysis cache '{}': {}", path.toStdString(), file.errorString().toStdString());
+    }
+}
+} // namespace
+
+SignalAggregate::SignalAggregate(double rangeLow, double rangeHigh, int bins, double thresholdValue)
+    : low(rangeLow)
+    , high(rangeHigh)
+    , threshold(thresholdValue)
+    , histogram(static_cast<std::size_t>(bins), 0)
+{
+}
+
+void SignalAggregate::add(quint64 timestamp, double value)
+{
+    if (count == 0) {
+        firstTimestamp = timestamp;
+    } else if ((lastValue > threshold) && (timestamp > lastTimestamp)) {
+        aboveUs += timestamp - lastTimestamp;
+    }
+
+    ++count;
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+    sum += value;
+    lastTimestamp = timestamp;
+    lastValue = value;
+
+    if (!histogram.empty()) {
+        const double bins = static_cast<double>(histogram.size());
+        const double pos = (high > low) ? std::floor((value - low) / (high - low) * bins) : 0.0;
+
+        ++histogram[static_cast<std::size_t>(std::min(std::max(pos, 0.0), bins - 1))];
+    }
+}
+
+void SignalAggregate::merge(const SignalAggregate& next)
+{
+    if (next.count == 0) {
+        return;
+    }
+
+    if (count == 0) {
+        firstTimestamp = next.firstTimestamp;
+    } else if ((lastValue > threshold) && (next.firstTimestamp > lastTimestamp)) {
+        // Value held from the last sample of this part to the first one of the next
+        aboveUs += next.firstTimestamp - lastTimestamp;
+    }
+
+    count += next.count;
+    minimum = std::min(minimum, next.minimum);
+    maximum = std::max(maximum, next.maximum);
+    sum += next.sum;
+    aboveUs += next.aboveUs;
+    lastTimestamp = next.lastTimestamp;
+    lastValue = next.lastValue;
+
+    for (std::size_t i = 0; i < std::min(histogram.size(), next.histogram.size()); ++i) {
+        histogram[i] += next.histogram[i];
+    }
+}
+
+double SignalAggregate::mean() const
+{
+    return count ? sum / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+}
+
+SignalAnalysis::~SignalAnalysis()
+{
+    wait();
+}
+
+void SignalAnalysis::analyzeAsync(const QString& tracePath, const QString& dbcPath, const Options& options)
+{
+    wait();
+
+    _tracePath = tracePath;
+    _dbcPath = dbcPath;
+    _options = options;
+
+    start(QThread::LowPriority);
+}
+
+SignalAnalysis::Report SignalAnalysis::report() const
+{
+    QMutexLocker lock(&_mutex);
+
+    return _report;
+}
+
+bool SignalAnalysis::analyze(const QString& tracePath, const QString& dbcPath, const Options& options,
+    Report& report, const Progress& progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<DbcMessage> messages;
+    QString error;
+
+    if (!DbcParser::load(dbcPath, messages, error)) {
+        cds_error("Failed to load DBC '{}': {}", dbcPath.toStdString(), error.toStdString());
+        return false;
+    }
+
+    TraceReader reader;
+    if (!reader.open(tracePath)) {
+        cds_error("Failed to open trace '{}'", tracePath.toStdString());
+        return false;
+    }
+
+    const DecodePlan plan(messages);
+    const QByteArray key = cacheKey(tracePath, dbcPath, options);
+    const quint64 total = reader.recordCount();
+
+    report = Report();
+    report.catalog = plan.catalog();
+
+    // Trace still being written changes under the key, so it is never cached
+    const bool cacheable = options.useCache && reader.isComplete();
+    if (cacheable && loadCache(cachePath(tracePath), key, report)) {
+        report.cached = true;
+
+        if (progress) {
+            progress(total, total);
+        }
+
+        cds_info("Signal analysis of '{}' read from cache", tracePath.toStdString());
+        return true;
+    }
+
+    const std::vector<Partition> parts = partitions(reader, options.partitionRecords);
+    const std::vector<SignalAggregate> empty = emptyAggregates(plan, options);
+    const std::size_t threads
+        = static_cast<std::size_t>((options.threads > 0) ? options.threads : std::max(1, QThread::idealThreadCount()));
+    quint64 done = 0;
+
+    report.aggregates = empty;
+    report.records = total;
+    report.firstTimestamp = reader.firstTimestamp();
+    report.lastTimestamp = reader.lastTimestamp();
+
+    for (std::size_t next = 0; next < parts.size();) {
+        const std::size_t round = std::min(threads, parts.size() - next);
+        std::vector<std::vector<SignalAggregate>> partial(round, empty);
+        std::vector<std::thread> workers;
+
+        for (std::size_t i = 1; i < round; ++i) {
+            workers.emplace_back(
+                [&plan, &reader, &parts, &partial, next, i] { aggregate(plan, reader, parts[next + i], partial[i]); });
+        }
+        aggregate(plan, reader, parts[next], partial[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        // Partitions follow each other in time, so they are merged in order
+        for (std::size_t i = 0; i < round; ++i) {
+            for (std::size_t s = 0; s < report.aggregates.size(); ++s) {
+                report.aggregates[s].merge(partial[i][s]);
+            }
+            done += parts[next + i].records;
+        }
+        next += round;
+
+        if (progress) {
+            progress(done, total);
+        }
+    }
+
+    if (cacheable) {
+        saveCache(cachePath(tracePath), key, report);
+    }
+
+    cds_info("Signal analysis of '{}' done in {} ms, {} records, {} signals", tracePath.toStdString(), timer.elapsed(),
+        total, report.aggregates.size());
+
+    return true;
+}
+
+QString SignalAnalysis::cachePath(const QString& tracePath)
+{
+    return tracePath + QStringLiteral(".analysis");
+}
+
+void SignalAnalysis::run()
+{
+    Report result;
+    const bool status = analyze(
+        _tracePath, _dbcPath, _options, result, [this](quint64 done, quint64 total) { emit progress(done, total); });
+
+    {
+        QMutexLocker lock(&_mutex);
+        _report = std::move(result);
+    }
+
+    emit analyzed(_tracePath, status);
+}
@@ -0,0 +1,155 @@
+#ifndef SIGNALANALYSIS_H
+#define SIGNALANALYSIS_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <functional>
+#include <limits>
+#include <signalsample.h>
+#include <vector>
+
+/**
+*   @brief  Statistics of one signal over part of trace, partial aggregates of consecutive parts are merged
+*
+*   Signal holds its value until the next sample, so time above threshold is the sum of intervals starting with
+*   sample above threshold. Interval of the last sample is not known and not counted. Histogram has equal bins over
+*   [low, high], values outside the range are counted in the first or last bin.
+*/
+struct SignalAggregate {
+    SignalAggregate() = default;
+
+    /**
+    *   @param  rangeLow low end of histogram range
+    *   @param  rangeHigh high end of histogram range
+    *   @param  bins number of histogram bins, 0 for no histogram
+    *   @param  thresholdValue threshold, NaN if time above threshold is not measured
+    */
+    SignalAggregate(double rangeLow, double rangeHigh, int bins, double thresholdValue);
+
+    void add(quint64 timestamp, double value);
+
+    /**
+    *   @brief  Adds aggregate of part of trace following the one of this aggregate
+    *   @param  next aggregate of the same signal with the same range and threshold
+    */
+    void merge(const SignalAggregate& next);
+
+    /**
+    *   @return mean value, NaN if there are no samples
+    */
+    double mean() const;
+
+    quint64 count{ 0 };
+    double minimum{ std::numeric_limits<double>::infinity() };
+    double maximum{ -std::numeric_limits<double>::infinity() };
+    double sum{ 0 };
+    double low{ 0 };
+    double high{ 0 };
+    double threshold{ std::numeric_limits<double>::quiet_NaN() };
+    quint64 aboveUs{ 0 }; // time above threshold in microseconds
+    quint64 firstTimestamp{ 0 };
+    quint64 lastTimestamp{ 0 };
+    double lastValue{ 0 };
+    std::vector<quint64> histogram;
+};
+
+/**
+*   @brief  Offline analysis of recorded trace (.cdst) with DBC database
+*
+*   Trace is partitioned into time ranges of consecutive trace blocks, Options::partitionRecords records each at
+*   least. Each round of partitions is decoded by several threads at once (see DecodePlan), every thread aggregating
+*   its partition separately. Partial aggregates are merged in time order after the round and progress is reported.
+*   Records are read straight from mapped trace, nothing is copied.
+*
+*   Report of complete trace is cached next to it (see cachePath) and reused while the trace, the DBC and the
+*   options stay the same, so opening the same report again does not decode anything.
+*/
+class SignalAnalysis : public QThread {
+    Q_OBJECT
+
+public:
+    static constexpr quint64 kPartitionRecords = 1 << 18;
+    static constexpr int kDefaultHistogramBins = 32;
+
+    struct Options {
+        int histogramBins{ kDefaultHistogramBins };
+        QHash<QString, double> thresholds; // thresholds of signals given as "Message.Signal"
+        int threads{ 0 }; // decoding threads, 0 for QThread::idealThreadCount()
+        quint64 partitionRecords{ kPartitionRecords };
+        bool useCache{ true };
+    };
+
+    struct Report {
+        SignalCatalogPtr catalog;
+        std::vector<SignalAggregate> aggregates; // indexed like catalog
+        quint64 records{ 0 };
+        quint64 firstTimestamp{ 0 };
+        quint64 lastTimestamp{ 0 };
+        bool cached{ false }; // report was read from cache
+    };
+
+    /**
+    *   @brief  Reports progress. Called from analyzing thread.
+    *   @param  done number of records analyzed
+    *   @param  total number of records of trace
+    */
+    typedef std::function<void(quint64 done, quint64 total)> Progress;
+
+    SignalAnalysis() = default;
+    ~SignalAnalysis();
+
+    /**
+    *   @brief  Starts analysis in worker thread. Waits for previous analysis to complete first.
+    *   @param  tracePath trace to be analyzed
+    *   @param  dbcPath DBC database
+    *   @param  options analysis options
+    */
+    void analyzeAsync(const QString& tracePath, const QString& dbcPath, const Options& options);
+
+    /**
+    *   @return report of the last analysis started with analyzeAsync(), valid once analyzed() was emitted
+    */
+    Report report() const;
+
+    /**
+    *   @brief  Analyzes trace synchronously from calling thread
+    *   @param  tracePath trace to be analyzed
+    *   @param  dbcPath DBC database
+    *   @param  options analysis options
+    *   @param  report result
+    *   @param  progress progress callback, may be empty
+    *   @return false if trace or DBC could not be loaded
+    */
+    static bool analyze(const QString& tracePath, const QString& dbcPath, const Options& options, Report& report,
+        const Progress& progress = Progress());
+
+    /**
+    *   @return path of cached report of trace
+    */
+    static QString cachePath(const QString& tracePath);
+
+signals:
+    /**
+    *   @brief  Emitted from worker thread after every round of partitions, see Progress
+    */
+    void progress(quint64 done, quint64 total);
+
+    /**
+    *   @brief  Emitted from worker thread when analysis started with analyzeAsync() completes
+    */
+    void analyzed(const QString& tracePath, bool status);
+
+protected:
+    void run() override;
+
+private:
+    QString _tracePath;
+    QString _dbcPath;
+    Options _options;
+    mutable QMutex _mutex;
+    Report _report;
+};
+
+#endif // SIGNALANALYSIS_H
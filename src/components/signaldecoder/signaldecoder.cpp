@@ -0,0 +1,93 @@
+#include "signaldecoder.h"
+#include "batchdecoder.h"
+#include "signaldecoder_p.h"
+
+SignalDecoder::SignalDecoder()
+    : d_ptr(new SignalDecoderPrivate())
+{
+}
+
+SignalDecoder::~SignalDecoder()
+{
+}
+
+void SignalDecoder::startSimulation()
+{
+}
+
+void SignalDecoder::stopSimulation()
+{
+}
+
+void SignalDecoder::frameBatchReceived(const CanFrameBatch& frames)
+{
+    d_ptr->process(*this, frames);
+}
+
+void SignalDecoder::frameBatchSent(bool status, const CanFrameBatch& frames)
+{
+    // Values of failed transmissions never appeared on the bus
+    if (status) {
+        d_ptr->process(*this, frames);
+    }
+}
+
+void SignalDecoder::setConfig(QJsonObject& json)
+{
+    Q_D(SignalDecoder);
+
+    if (json.contains("file")) {
+        d->loadDatabase(json["file"].toString());
+    }
+}
+
+QJsonObject SignalDecoder::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+CanFilterList SignalDecoder::acceptanceFilters() const
+{
+    CanFilterList filters;
+
+    for (const auto& id : d_ptr->_plan.messageIds()) {
+        auto filter = makeCanFilter(id.first, id.second ? 0x1fffffff : 0x7ff);
+
+        filter.format = id.second ? QCanBusDevice::Filter::MatchExtendedFormat : QCanBusDevice::Filter::MatchBaseFormat;
+        filters.append(filter);
+    }
+
+    return filters;
+}
+
+void SignalDecoder::setIdDirectory(const std::shared_ptr<FrameIdDirectory>& directory)
+{
+    Q_D(SignalDecoder);
+
+    d->_idDirectory = directory;
+    d->nameMessages();
+}
+
+SignalCatalogPtr SignalDecoder::signalCatalog() const
+{
+    return d_ptr->_plan.catalog();
+}
+
+std::size_t SignalDecoder::messageCount() const
+{
+    return d_ptr->_plan.messageCount();
+}
+
+SignalSampleBatch SignalDecoder::decode(const CanFrameBatch& frames) const
+{
+    return d_ptr->decode(frames);
+}
+
+bool SignalDecoder::decodeColumns(const CanFrameRecord* records, std::size_t count, SignalColumns& columns) const
+{
+    return BatchDecoder::decode(d_ptr->_plan, records, count, columns);
+}
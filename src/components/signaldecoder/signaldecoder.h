@@ -0,0 +1,91 @@
+#ifndef SIGNALDECODER_H
+#define SIGNALDECODER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <signalsample.h>
+
+struct SignalColumns;
+
+class SignalDecoderPrivate;
+
+/**
+*   @brief  Component converting frames to physical signal values using DBC database
+*
+*   DBC is compiled to decoding tables (see DecodePlan) when it is loaded, decoding of each frame is then table
+*   lookup and a few integer operations per signal.
+*/
+class SignalDecoder : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(SignalDecoder)
+
+public:
+    SignalDecoder();
+    ~SignalDecoder();
+
+    /**
+    *   @brief  Supported keys: file (DBC path)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @brief  Only messages defined in DBC are needed, so device does not have to deliver the rest
+    *   @see ComponentInterface
+    */
+    CanFilterList acceptanceFilters() const override;
+
+    /**
+    *   @brief  IDs of messages of DBC are named in directory of the bus
+    *   @see ComponentInterface
+    */
+    void setIdDirectory(const std::shared_ptr<FrameIdDirectory>& directory) override;
+
+    /**
+    *   @return signals of loaded DBC, indexed by SignalSample::signal
+    */
+    SignalCatalogPtr signalCatalog() const;
+
+    /**
+    *   @return number of messages of loaded DBC, 0 if DBC could not be loaded
+    */
+    std::size_t messageCount() const;
+
+    /**
+    *   @brief  Decodes frames synchronously
+    *   @param  frames frames to be decoded
+    *   @return samples of all signals present in frames, in frame order
+    */
+    SignalSampleBatch decode(const CanFrameBatch& frames) const;
+
+    /**
+    *   @brief  Decodes recorded frames of single message into columns, meant for trace analysis and export
+    *   @see    BatchDecoder::decode
+    */
+    bool decodeColumns(const CanFrameRecord* records, std::size_t count, SignalColumns& columns) const;
+
+signals:
+    /**
+    *   @brief  Emitted once per batch of frames carrying at least one known signal
+    *   @param  samples decoded values
+    */
+    void signalsDecoded(const SignalSampleBatch& samples);
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<SignalDecoderPrivate> d_ptr;
+};
+
+#endif // SIGNALDECODER_H
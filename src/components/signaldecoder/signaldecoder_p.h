@@ -0,0 +1,96 @@
+#ifndef SIGNALDECODER_P_H
+#define SIGNALDECODER_P_H
+
+#include "dbcparser.h"
+#include "decodeplan.h"
+#include "signaldecoder.h"
+#include <QtCore/QJsonObject>
+#include <frameiddirectory.h>
+#include <log.h>
+
+class SignalDecoderPrivate {
+public:
+    void saveSettings(QJsonObject& json) const
+    {
+        json["file"] = _file;
+    }
+
+    /**
+    *   @brief  Loads and compiles DBC, previous tables are dropped even if loading fails
+    */
+    void loadDatabase(const QString& path)
+    {
+        std::vector<DbcMessage> messages;
+        QString error;
+
+        _file = path;
+        _plan = DecodePlan();
+
+        if (path.isEmpty()) {
+            return;
+        }
+
+        if (!DbcParser::load(path, messages, error)) {
+            cds_error("Failed to load DBC '{}': {}", path.toStdString(), error.toStdString());
+            return;
+        }
+
+        _plan = DecodePlan(messages);
+        cds_info("DBC '{}' loaded, {} messages, {} signals", path.toStdString(), _plan.messageCount(),
+            _plan.catalog()->size());
+        nameMessages();
+    }
+
+    /**
+    *   @brief  Names IDs of bus after messages of loaded DBC, so that other consumers of the bus show them
+    */
+    void nameMessages()
+    {
+        if (!_idDirectory) {
+            return;
+        }
+
+        for (const auto& signal : *_plan.catalog()) {
+            const FrameIdDirectory::Handle handle = _idDirectory->intern(signal.frameId, signal.extended);
+
+            if (handle != FrameIdDirectory::kInvalidHandle) {
+                _idDirectory->setMessageName(handle, signal.message);
+            }
+        }
+    }
+
+    SignalSampleBatch decode(const CanFrameBatch& frames) const
+    {
+        SignalSampleBatch samples;
+        const std::size_t maxSignals = _plan.maxSignalsPerMessage();
+
+        if (maxSignals == 0) {
+            return samples;
+        }
+
+        // Sized for the worst case, so that decode writes straight into batch and is trimmed once at the end
+        samples.resize(static_cast<int>(frames.size() * maxSignals));
+        SignalSample* out = samples.data();
+        for (const auto& rec : frames) {
+            out += _plan.decode(rec, out);
+        }
+        samples.resize(static_cast<int>(out - samples.constData()));
+
+        return samples;
+    }
+
+    void process(SignalDecoder& q, const CanFrameBatch& frames) const
+    {
+        const SignalSampleBatch samples = decode(frames);
+
+        if (!samples.isEmpty()) {
+            emit q.signalsDecoded(samples);
+        }
+    }
+
+    QString _file;
+    DecodePlan _plan;
+    FrameIdDirectoryPtr _idDirectory; // directory of bus decoder is fed from, see FlowPlan
+};
+
+#endif // SIGNALDECODER_P_H
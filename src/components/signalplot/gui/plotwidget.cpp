@@ -0,0 +1,158 @@
+#include "plotwidget.h"
+#include <QtGui/QMouseEvent>
+#include <QtGui/QPainter>
+#include <QtGui/QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const double kMinSpan = 1e-4;
+const double kMaxSpan = 1e7;
+const double kDefaultSpan = 10.0;
+const int kMarginLeft = 60;
+const int kMargin = 10;
+const int kMarginBottom = 20;
+
+QColor curveColor(std::size_t index)
+{
+    static const Qt::GlobalColor colors[]
+        = { Qt::blue, Qt::red, Qt::darkGreen, Qt::magenta, Qt::darkCyan, Qt::darkYellow, Qt::black, Qt::darkRed };
+
+    return colors[index % (sizeof(colors) / sizeof(colors[0]))];
+}
+} // namespace
+
+PlotWidget::PlotWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    setMinimumSize(200, 100);
+    setAutoFillBackground(true);
+    setBackgroundRole(QPalette::Base);
+}
+
+void PlotWidget::setEnvelopeCbk(const SPGuiInterface::envelope_t& cb)
+{
+    _envelope = cb;
+}
+
+void PlotWidget::setDataDuration(double duration)
+{
+    _duration = duration;
+}
+
+QRect PlotWidget::plotArea() const
+{
+    return rect().adjusted(kMarginLeft, kMargin, -kMargin, -kMarginBottom);
+}
+
+double PlotWidget::viewFrom() const
+{
+    return _follow ? std::max(0.0, _duration - _span) : _from;
+}
+
+void PlotWidget::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    const QRect area = plotArea();
+    const double from = viewFrom();
+
+    if (!_envelope || (area.width() <= 0) || (area.height() <= 0)) {
+        return;
+    }
+
+    _envelope(from, from + _span, area.width(), _curves);
+
+    double yMin = std::numeric_limits<double>::max();
+    double yMax = std::numeric_limits<double>::lowest();
+    for (const auto& curve : _curves) {
+        for (const auto& column : curve.columns) {
+            if (column.isValid()) {
+                yMin = std::min(yMin, column.min);
+                yMax = std::max(yMax, column.max);
+            }
+        }
+    }
+
+    if (yMin > yMax) {
+        yMin = 0.0;
+        yMax = 1.0;
+    } else if (yMin == yMax) {
+        yMin -= 1.0;
+        yMax += 1.0;
+    }
+
+    const double yScale = area.height() / (yMax - yMin);
+    const auto toY = [&](double value) { return area.bottom() - (value - yMin) * yScale; };
+
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawRect(area);
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(QRect(0, area.top(), kMarginLeft - 4, 20), Qt::AlignRight | Qt::AlignTop, QString::number(yMax));
+    painter.drawText(
+        QRect(0, area.bottom() - 20, kMarginLeft - 4, 20), Qt::AlignRight | Qt::AlignBottom, QString::number(yMin));
+    painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), kMarginBottom - 2), Qt::AlignLeft,
+        QString("%1 s").arg(from, 0, 'f', 3));
+    painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), kMarginBottom - 2), Qt::AlignRight,
+        QString("%1 s").arg(from + _span, 0, 'f', 3));
+
+    painter.setClipRect(area);
+    for (std::size_t i = 0; i < _curves.size(); ++i) {
+        const auto& columns = _curves[i].columns;
+        QPolygonF line;
+
+        // Every column contributes its min and max, which draws both the spread within the column and the
+        // connection to the next one
+        line.reserve(static_cast<int>(columns.size() * 2));
+        for (std::size_t x = 0; x < columns.size(); ++x) {
+            if (columns[x].isValid()) {
+                line.append(QPointF(area.left() + x, toY(columns[x].min)));
+                line.append(QPointF(area.left() + x, toY(columns[x].max)));
+            }
+        }
+
+        painter.setPen(curveColor(i));
+        painter.drawPolyline(line);
+        painter.drawText(area.left() + 4, area.top() + 14 * static_cast<int>(i + 1), _curves[i].label);
+    }
+}
+
+void PlotWidget::wheelEvent(QWheelEvent* event)
+{
+    const QRect area = plotArea();
+    const double from = viewFrom();
+    const double x = event->pos().x() - area.left();
+    const double ratio = (area.width() > 0) ? qBound(0.0, x / area.width(), 1.0) : 0.5;
+    const double anchor = from + ratio * _span;
+    const double span = qBound(kMinSpan, _span * std::pow(1.25, -event->angleDelta().y() / 120.0), kMaxSpan);
+
+    _from = std::max(0.0, anchor - ratio * span);
+    _span = span;
+    _follow = false;
+    update();
+}
+
+void PlotWidget::mousePressEvent(QMouseEvent* event)
+{
+    _dragStart = event->pos();
+    _dragFrom = viewFrom();
+}
+
+void PlotWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    const int width = plotArea().width();
+
+    if ((event->buttons() & Qt::LeftButton) && (width > 0)) {
+        _from = std::max(0.0, _dragFrom - (event->pos().x() - _dragStart.x()) * _span / width);
+        _follow = false;
+        update();
+    }
+}
+
+void PlotWidget::mouseDoubleClickEvent(QMouseEvent*)
+{
+    _follow = true;
+    // Whole data fits into view
+    _span = (_duration > 0.0) ? qBound(kMinSpan, _duration, kMaxSpan) : kDefaultSpan;
+    update();
+}
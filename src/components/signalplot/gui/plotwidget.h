@@ -0,0 +1,42 @@
+#ifndef PLOTWIDGET_H
+#define PLOTWIDGET_H
+
+#include "spguiinterface.h"
+#include <QtCore/QPoint>
+#include <QtWidgets/QWidget>
+
+/**
+*   @brief  Custom painted time plot. Only envelopes reduced to one entry per pixel column are drawn, so painting
+*           cost depends on widget width, not on number of samples.
+*
+*   Mouse wheel zooms around cursor, dragging pans. Double click returns to following end of data.
+*/
+class PlotWidget : public QWidget {
+public:
+    explicit PlotWidget(QWidget* parent = nullptr);
+
+    void setEnvelopeCbk(const SPGuiInterface::envelope_t& cb);
+    void setDataDuration(double duration);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private:
+    QRect plotArea() const;
+    double viewFrom() const;
+
+    SPGuiInterface::envelope_t _envelope;
+    std::vector<PlotCurve> _curves;
+    double _duration{ 0.0 };
+    double _from{ 0.0 };
+    double _span{ 10.0 };
+    bool _follow{ true };
+    QPoint _dragStart;
+    double _dragFrom{ 0.0 };
+};
+
+#endif // PLOTWIDGET_H
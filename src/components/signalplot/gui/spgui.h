@@ -0,0 +1,100 @@
+#ifndef SPGUI_H
+#define SPGUI_H
+
+#include "plotwidget.h"
+#include "spguiinterface.h"
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QVBoxLayout>
+#include <functional>
+#include <vector>
+
+/**
+*   @brief  Widget implementation of SPGuiInterface
+*
+*   As with CRVGui, widgets are built on first getMainWidget() call and calls made before are recorded.
+*/
+struct SPGui : public SPGuiInterface {
+
+    SPGui() = default;
+
+    virtual void setDockUndockCbk(const dockUndock_t& cb) override
+    {
+        apply([this, cb] { QObject::connect(_pbDockUndock, &QPushButton::toggled, cb); });
+    }
+
+    virtual void setEnvelopeCbk(const envelope_t& cb) override
+    {
+        apply([this, cb] { _plot->setEnvelopeCbk(cb); });
+    }
+
+    virtual QWidget* getMainWidget() override
+    {
+        if (!_widget) {
+            build();
+        }
+
+        return _widget;
+    }
+
+    virtual bool isMainWidgetCreated() override
+    {
+        return _widget != nullptr;
+    }
+
+    virtual void setDataDuration(double duration) override
+    {
+        if (_widget) {
+            _plot->setDataDuration(duration);
+        }
+    }
+
+    virtual void refresh() override
+    {
+        if (_widget && _widget->isVisible()) {
+            _plot->update();
+        }
+    }
+
+private:
+    void apply(std::function<void()>&& action)
+    {
+        if (_widget) {
+            action();
+        } else {
+            _pending.push_back(std::move(action));
+        }
+    }
+
+    void build()
+    {
+        _widget = new QWidget;
+        _widget->setWindowTitle("SignalPlot");
+        _widget->resize(600, 300);
+
+        auto layout = new QVBoxLayout(_widget);
+        auto toolbar = new QHBoxLayout;
+        _pbDockUndock = new QPushButton("Undock");
+        _pbDockUndock->setCheckable(true);
+        toolbar->addWidget(new QLabel("Wheel to zoom, drag to pan, double click to follow"));
+        toolbar->addStretch();
+        toolbar->addWidget(_pbDockUndock);
+        layout->addLayout(toolbar);
+
+        _plot = new PlotWidget;
+        layout->addWidget(_plot, 1);
+
+        for (auto& action : _pending) {
+            action();
+        }
+        _pending.clear();
+    }
+
+    QWidget* _widget{ nullptr };
+    QPushButton* _pbDockUndock{ nullptr };
+    PlotWidget* _plot{ nullptr };
+    std::vector<std::function<void()>> _pending;
+};
+
+#endif // SPGUI_H
@@ -0,0 +1,47 @@
+#ifndef SPGUIINTERFACE_H
+#define SPGUIINTERFACE_H
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <functional>
+#include <sampleseries.h>
+#include <vector>
+
+class QWidget;
+
+/**
+*   @brief  Curve of one signal reduced to pixel columns
+*/
+struct PlotCurve {
+    QString label;
+    std::vector<EnvelopeColumn> columns;
+};
+
+struct SPGuiInterface {
+    typedef std::function<void()> dockUndock_t;
+    // Fills curves with envelopes of all plotted signals for given time range (seconds since start of simulation)
+    typedef std::function<void(double from, double to, int columns, std::vector<PlotCurve>& curves)> envelope_t;
+
+    virtual void setDockUndockCbk(const dockUndock_t& cb) = 0;
+    virtual void setEnvelopeCbk(const envelope_t& cb) = 0;
+
+    virtual ~SPGuiInterface()
+    {
+    }
+
+    virtual QWidget* getMainWidget() = 0;
+    virtual bool isMainWidgetCreated() = 0;
+
+    /**
+    *   @brief  Informs plot about time range of data. Plot follows the end of data unless user zoomed or panned.
+    *   @param  duration seconds from start of simulation to the last sample
+    */
+    virtual void setDataDuration(double duration) = 0;
+
+    /**
+    *   @brief  Schedules repaint, plot queries envelopes again
+    */
+    virtual void refresh() = 0;
+};
+
+#endif // SPGUIINTERFACE_H
@@ -0,0 +1,37 @@
+#ifndef SPHEADLESSGUI_H
+#define SPHEADLESSGUI_H
+
+#include "spguiinterface.h"
+
+/**
+*   @brief  No-op implementation of SPGuiInterface for running without display. Samples are still collected.
+*/
+struct SPHeadlessGui : public SPGuiInterface {
+    void setDockUndockCbk(const dockUndock_t&) override
+    {
+    }
+
+    void setEnvelopeCbk(const envelope_t&) override
+    {
+    }
+
+    QWidget* getMainWidget() override
+    {
+        return nullptr;
+    }
+
+    bool isMainWidgetCreated() override
+    {
+        return false;
+    }
+
+    void setDataDuration(double) override
+    {
+    }
+
+    void refresh() override
+    {
+    }
+};
+
+#endif // SPHEADLESSGUI_H
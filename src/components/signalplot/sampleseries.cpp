@@ -0,0 +1,198 @@
+#include "sampleseries.h"
+#include <algorithm>
+#include <limits>
+
+constexpr std::size_t SampleSeries::kChunkSamples;
+constexpr std::size_t SampleSeries::kFanout;
+
+struct SampleSeries::Query {
+    quint64 from;
+    quint64 span;
+    int columns;
+    std::vector<EnvelopeColumn>& out;
+
+    int column(quint64 timestamp) const
+    {
+        const auto column = static_cast<int>((timestamp - from) * static_cast<double>(columns) / span);
+
+        return std::min(std::max(column, 0), columns - 1);
+    }
+
+    void add(quint64 timestamp, double min, double max)
+    {
+        auto& col = out[column(timestamp)];
+
+        col.min = std::min(col.min, min);
+        col.max = std::max(col.max, max);
+    }
+};
+
+void SampleSeries::append(quint64 timestamp, double value)
+{
+    if ((_size % kChunkSamples) == 0) {
+        _chunks.emplace_back();
+        _chunks.back().timestamps.reserve(kChunkSamples);
+        _chunks.back().values.reserve(kChunkSamples);
+    }
+
+    Chunk& chunk = _chunks.back();
+    // Binary search over timestamps relies on them being ordered
+    chunk.timestamps.push_back(_size ? std::max(timestamp, timestampAt(_size - 1)) : timestamp);
+    chunk.values.push_back(value);
+
+    const std::size_t index = _size++;
+
+    for (std::size_t level = 0; level < _levels.size(); ++level) {
+        auto& buckets = _levels[level];
+        const std::size_t bucket = index / bucketSize(level);
+
+        if (bucket == buckets.size()) {
+            buckets.push_back({ value, value });
+        } else {
+            buckets[bucket].min = std::min(buckets[bucket].min, value);
+            buckets[bucket].max = std::max(buckets[bucket].max, value);
+        }
+    }
+
+    // New level is added once the top one has more than one bucket, it is built from buckets below it
+    const std::size_t top = _levels.size();
+    if (_size > bucketSize(top)) {
+        Bucket merged{ std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() };
+
+        for (std::size_t i = 0; i < kFanout; ++i) {
+            const Bucket part = (top == 0) ? Bucket{ valueAt(i), valueAt(i) } : _levels[top - 1][i];
+
+            merged.min = std::min(merged.min, part.min);
+            merged.max = std::max(merged.max, part.max);
+        }
+
+        _levels.push_back({ merged, { value, value } });
+    }
+}
+
+void SampleSeries::clear()
+{
+    _chunks.clear();
+    _levels.clear();
+    _size = 0;
+}
+
+std::size_t SampleSeries::size() const
+{
+    return _size;
+}
+
+bool SampleSeries::isEmpty() const
+{
+    return _size == 0;
+}
+
+quint64 SampleSeries::timestampAt(std::size_t index) const
+{
+    return _chunks[index / kChunkSamples].timestamps[index % kChunkSamples];
+}
+
+double SampleSeries::valueAt(std::size_t index) const
+{
+    return _chunks[index / kChunkSamples].values[index % kChunkSamples];
+}
+
+std::size_t SampleSeries::levelCount() const
+{
+    return _levels.size();
+}
+
+void SampleSeries::envelope(quint64 from, quint64 to, int columns, std::vector<EnvelopeColumn>& out) const
+{
+    out.assign(std::max(columns, 0),
+        EnvelopeColumn{ std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() });
+
+    if ((columns <= 0) || (to < from) || isEmpty()) {
+        return;
+    }
+
+    const std::size_t begin = lowerBound(from);
+    const std::size_t end = (to == std::numeric_limits<quint64>::max()) ? _size : lowerBound(to + 1);
+    const std::size_t perColumn = (end - begin) / static_cast<std::size_t>(columns);
+    int level = -1;
+
+    // Coarsest level that still has at least one bucket per column
+    while ((level + 1 < static_cast<int>(_levels.size())) && (bucketSize(level + 1) <= perColumn)) {
+        ++level;
+    }
+
+    Query query{ from, to - from + 1, columns, out };
+    accumulate(query, level, begin, end);
+}
+
+std::size_t SampleSeries::bucketSize(std::size_t level)
+{
+    std::size_t size = kFanout;
+
+    for (std::size_t i = 0; i < level; ++i) {
+        size *= kFanout;
+    }
+
+    return size;
+}
+
+std::size_t SampleSeries::lowerBound(quint64 timestamp) const
+{
+    std::size_t first = 0;
+    std::size_t count = _size;
+
+    while (count > 0) {
+        const std::size_t step = count / 2;
+
+        if (timestampAt(first + step) < timestamp) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+void SampleSeries::accumulate(Query& query, int level, std::size_t begin, std::size_t end) const
+{
+    if (begin >= end) {
+        return;
+    }
+
+    if (level < 0) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const double value = valueAt(i);
+            query.add(timestampAt(i), value, value);
+        }
+        return;
+    }
+
+    // Only buckets lying completely inside of range are used, edges are taken from finer levels
+    const std::size_t size = bucketSize(level);
+    const std::size_t firstBucket = (begin + size - 1) / size;
+    const std::size_t lastBucket = end / size;
+
+    if (firstBucket >= lastBucket) {
+        accumulate(query, level - 1, begin, end);
+        return;
+    }
+
+    accumulate(query, level - 1, begin, firstBucket * size);
+
+    const auto& buckets = _levels[level];
+    for (std::size_t b = firstBucket; b < lastBucket; ++b) {
+        const std::size_t first = b * size;
+        const std::size_t last = first + size - 1;
+
+        // Bucket crossing column boundary (e.g. gap in data) is split on finer levels, so envelope stays exact
+        if (query.column(timestampAt(first)) != query.column(timestampAt(last))) {
+            accumulate(query, level - 1, first, last + 1);
+        } else {
+            query.add(timestampAt(first), buckets[b].min, buckets[b].max);
+        }
+    }
+
+    accumulate(query, level - 1, lastBucket * size, end);
+}
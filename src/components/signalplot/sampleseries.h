@@ -0,0 +1,84 @@
+#ifndef SAMPLESERIES_H
+#define SAMPLESERIES_H
+
+#include <QtCore/QtGlobal>
+#include <vector>
+
+/**
+*   @brief  Value range of samples falling into one pixel column
+*/
+struct EnvelopeColumn {
+    double min;
+    double max;
+
+    bool isValid() const
+    {
+        return min <= max;
+    }
+};
+
+/**
+*   @brief  Time series of one signal with min/max level of detail pyramid
+*
+*   Samples are stored in fixed size chunks of separate timestamp and value arrays, so growing series never moves
+*   stored samples. Level k of pyramid holds min/max of every kFanout^(k+1) consecutive samples and is updated on
+*   append. Envelope of any time range is assembled from the coarsest level that still gives at least one bucket
+*   per column, so query cost depends on number of columns, not on number of samples.
+*/
+class SampleSeries {
+public:
+    static constexpr std::size_t kChunkSamples = 4096;
+    static constexpr std::size_t kFanout = 16;
+
+    /**
+    *   @brief  Appends sample. Samples are expected in time order, older timestamp is stored as the last one.
+    *   @param  timestamp microseconds
+    *   @param  value physical value
+    */
+    void append(quint64 timestamp, double value);
+
+    void clear();
+
+    std::size_t size() const;
+    bool isEmpty() const;
+
+    quint64 timestampAt(std::size_t index) const;
+    double valueAt(std::size_t index) const;
+
+    /**
+    *   @return number of pyramid levels above raw samples
+    */
+    std::size_t levelCount() const;
+
+    /**
+    *   @brief  Computes min/max of samples per column
+    *   @param  from first timestamp of range, mapped to column 0
+    *   @param  to last timestamp of range, mapped to last column
+    *   @param  columns number of columns
+    *   @param  out columns, invalid for columns with no samples
+    */
+    void envelope(quint64 from, quint64 to, int columns, std::vector<EnvelopeColumn>& out) const;
+
+private:
+    struct Chunk {
+        std::vector<quint64> timestamps;
+        std::vector<double> values;
+    };
+
+    struct Bucket {
+        double min;
+        double max;
+    };
+
+    struct Query;
+
+    static std::size_t bucketSize(std::size_t level);
+    std::size_t lowerBound(quint64 timestamp) const;
+    void accumulate(Query& query, int level, std::size_t begin, std::size_t end) const;
+
+    std::vector<Chunk> _chunks;
+    std::vector<std::vector<Bucket>> _levels;
+    std::size_t _size{ 0 };
+};
+
+#endif // SAMPLESERIES_H
@@ -0,0 +1,109 @@
+#include "signalplot.h"
+#include "signalplot_p.h"
+#include <algorithm>
+
+constexpr int SignalPlot::kRefreshIntervalMs;
+
+SignalPlot::SignalPlot()
+    : d_ptr(new SignalPlotPrivate(this))
+{
+}
+
+SignalPlot::SignalPlot(SignalPlotCtx&& ctx)
+    : d_ptr(new SignalPlotPrivate(this, std::move(ctx)))
+{
+}
+
+SignalPlot::~SignalPlot()
+{
+}
+
+void SignalPlot::startSimulation()
+{
+    Q_D(SignalPlot);
+
+    d->resetSeries();
+    d->_lastTimestamp = 0;
+    d->_refreshTimer.start();
+}
+
+void SignalPlot::stopSimulation()
+{
+    Q_D(SignalPlot);
+
+    d->_refreshTimer.stop();
+    // Samples received since last tick
+    d->refresh();
+}
+
+void SignalPlot::signalsReceived(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog)
+{
+    Q_D(SignalPlot);
+
+    d->addSamples(samples, catalog);
+}
+
+QWidget* SignalPlot::getMainWidget()
+{
+    Q_D(SignalPlot);
+
+    return d->_ui.getMainWidget();
+}
+
+bool SignalPlot::mainWidgetCreated() const
+{
+    return d_ptr->_ui.isMainWidgetCreated();
+}
+
+void SignalPlot::setConfig(QJsonObject& json)
+{
+    Q_D(SignalPlot);
+
+    if (json.contains("signals")) {
+        QStringList selected;
+
+        for (const auto& name : json["signals"].toArray()) {
+            selected.append(name.toString());
+        }
+
+        d->setSelection(selected);
+    }
+}
+
+QJsonObject SignalPlot::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+void SignalPlot::setDockUndockClbk(const std::function<void()>& cb)
+{
+    Q_D(SignalPlot);
+
+    d->_ui.setDockUndockCbk(cb);
+}
+
+bool SignalPlot::mainWidgetDocked() const
+{
+    return d_ptr->docked;
+}
+
+std::size_t SignalPlot::seriesCount() const
+{
+    return std::count_if(
+        d_ptr->_series.begin(), d_ptr->_series.end(), [](const auto& series) { return series != nullptr; });
+}
+
+const SampleSeries* SignalPlot::series(const QString& name) const
+{
+    for (std::size_t i = 0; i < d_ptr->_series.size(); ++i) {
+        if (d_ptr->_series[i] && (SignalPlotPrivate::signalName((*d_ptr->_catalog)[i]) == name)) {
+            return d_ptr->_series[i].get();
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,87 @@
+#ifndef SIGNALPLOT_H
+#define SIGNALPLOT_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <componentinterface.h>
+#include <context.h>
+#include <signalsample.h>
+
+class SignalPlotPrivate;
+class SampleSeries;
+class QWidget;
+
+/**
+*   @brief  Component plotting decoded signals (see SignalDecoder) over time
+*
+*   Samples of each signal are kept in SampleSeries with min/max pyramid, plot draws about one point per pixel
+*   column whatever the number of samples in view.
+*/
+class SignalPlot : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(SignalPlot)
+
+public:
+    static constexpr int kRefreshIntervalMs = 50;
+
+    SignalPlot();
+    explicit SignalPlot(SignalPlotCtx&& ctx);
+    ~SignalPlot();
+
+    /**
+    *   @see ComponentInterface
+    */
+    QWidget* getMainWidget() override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    bool mainWidgetCreated() const override;
+
+    /**
+    *   @brief  Supported keys: signals (array of "Message.Signal" names to be plotted, all signals if empty)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    void setDockUndockClbk(const std::function<void()>& cb) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    bool mainWidgetDocked() const override;
+
+    /**
+    *   @return number of signals with at least one sample
+    */
+    std::size_t seriesCount() const;
+
+    /**
+    *   @param  name "Message.Signal"
+    *   @return samples of signal, nullptr if no sample of the signal was received
+    */
+    const SampleSeries* series(const QString& name) const;
+
+public slots:
+    /**
+    *   @brief  Stores samples of plotted signals. Series are reset when catalog changes (e.g. DBC reloaded).
+    *   @param  samples decoded values
+    *   @param  catalog description of signals samples refer to
+    */
+    void signalsReceived(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<SignalPlotPrivate> d_ptr;
+};
+
+#endif // SIGNALPLOT_H
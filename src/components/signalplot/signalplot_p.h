@@ -0,0 +1,138 @@
+#ifndef SIGNALPLOT_P_H
+#define SIGNALPLOT_P_H
+
+#include "gui/spgui.h"
+#include "sampleseries.h"
+#include "signalplot.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class SignalPlotPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(SignalPlot)
+
+public:
+    SignalPlotPrivate(SignalPlot* q, SignalPlotCtx&& ctx = SignalPlotCtx(new SPGui))
+        : _ctx(std::move(ctx))
+        , _ui(_ctx.get<SPGuiInterface>())
+        , q_ptr(q)
+    {
+        using namespace std::placeholders;
+
+        _ui.setEnvelopeCbk(std::bind(&SignalPlotPrivate::envelope, this, _1, _2, _3, _4));
+        _ui.setDockUndockCbk([this] { docked = !docked; });
+
+        _refreshTimer.setInterval(SignalPlot::kRefreshIntervalMs);
+        connect(&_refreshTimer, &QTimer::timeout, this, &SignalPlotPrivate::refresh);
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["signals"] = QJsonArray::fromStringList(_selected);
+    }
+
+    static QString signalName(const SignalInfo& info)
+    {
+        return info.message + "." + info.name;
+    }
+
+    void setSelection(const QStringList& selected)
+    {
+        _selected = selected;
+        resetSeries();
+    }
+
+    void resetSeries()
+    {
+        const std::size_t count = _catalog ? _catalog->size() : 0;
+
+        _series.clear();
+        _series.resize(count);
+        _plotted.assign(count, false);
+        for (std::size_t i = 0; i < count; ++i) {
+            _plotted[i] = _selected.isEmpty() || _selected.contains(signalName((*_catalog)[i]));
+        }
+        _timeBaseSet = false;
+        _dirty = true;
+    }
+
+    void addSamples(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog)
+    {
+        if (catalog != _catalog) {
+            _catalog = catalog;
+            resetSeries();
+        }
+
+        for (const auto& sample : samples) {
+            if ((sample.signal >= _plotted.size()) || !_plotted[sample.signal]) {
+                continue;
+            }
+
+            auto& series = _series[sample.signal];
+            if (!series) {
+                series = std::make_unique<SampleSeries>();
+            }
+
+            if (!_timeBaseSet) {
+                _timeBase = sample.timestamp;
+                _timeBaseSet = true;
+            }
+
+            series->append(sample.timestamp, sample.value);
+            _lastTimestamp = std::max(_lastTimestamp, sample.timestamp);
+        }
+
+        _dirty = _dirty || !samples.isEmpty();
+    }
+
+    void envelope(double from, double to, int columns, std::vector<PlotCurve>& curves) const
+    {
+        const auto toTimestamp = [this](double seconds) {
+            return _timeBase + static_cast<quint64>(std::max(0.0, seconds) * 1000000.0);
+        };
+
+        curves.resize(0);
+        for (std::size_t i = 0; i < _series.size(); ++i) {
+            if (_series[i]) {
+                const SignalInfo& info = (*_catalog)[i];
+
+                curves.push_back({ info.unit.isEmpty() ? signalName(info)
+                                                       : QString("%1 [%2]").arg(signalName(info), info.unit),
+                    {} });
+                _series[i]->envelope(toTimestamp(from), toTimestamp(to), columns, curves.back().columns);
+            }
+        }
+    }
+
+    void refresh()
+    {
+        if (_dirty) {
+            _dirty = false;
+            _ui.setDataDuration(_timeBaseSet ? (_lastTimestamp - _timeBase) / 1000000.0 : 0.0);
+            _ui.refresh();
+        }
+    }
+
+    SignalPlotCtx _ctx;
+    SPGuiInterface& _ui;
+    bool docked{ true };
+    QStringList _selected;
+    SignalCatalogPtr _catalog;
+    std::vector<std::unique_ptr<SampleSeries>> _series; // indexed by catalog index, created on first sample
+    std::vector<bool> _plotted;
+    quint64 _timeBase{ 0 };
+    quint64 _lastTimestamp{ 0 };
+    bool _timeBaseSet{ false };
+    bool _dirty{ false };
+    QTimer _refreshTimer;
+
+private:
+    SignalPlot* q_ptr;
+};
+
+#endif // SIGNALPLOT_P_H
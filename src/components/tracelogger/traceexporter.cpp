@@ -0,0 +1,767 @@
+#include "traceexporter.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QLocale>
+#include <QtCore/QtEndian>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <hexformat.h>
+#include <log.h>
+#include <thread>
+#include <tracereader.h>
+#include <type_traits>
+#include <vector>
+
+constexpr int TraceExporter::kChunkRecords;
+constexpr int TraceExporter::kBlfContainerSize;
+
+namespace {
+// SocketCAN can_id flags, see linux/can.h
+constexpr quint32 kCanEffFlag = 0x80000000U;
+constexpr quint32 kCanRtrFlag = 0x40000000U;
+constexpr quint32 kCanErrFlag = 0x20000000U;
+
+// SocketCAN CAN FD frame flags
+constexpr quint8 kCanFdBrs = 0x01;
+constexpr quint8 kCanFdEsi = 0x02;
+constexpr quint8 kCanFdFdf = 0x04;
+
+namespace Pcapng {
+    constexpr quint32 kSectionHeaderBlock = 0x0A0D0D0A;
+    constexpr quint32 kInterfaceDescriptionBlock = 1;
+    constexpr quint32 kEnhancedPacketBlock = 6;
+    constexpr quint32 kByteOrderMagic = 0x1A2B3C4D;
+    constexpr quint16 kLinkTypeCanSocketCan = 227;
+
+    constexpr quint16 kOptEnd = 0;
+    constexpr quint16 kOptShbUserAppl = 4;
+    constexpr quint16 kOptIfName = 2;
+    constexpr quint16 kOptIfTsResol = 9;
+    constexpr quint16 kOptEpbFlags = 2;
+
+    constexpr quint32 kEpbInbound = 1;
+    constexpr quint32 kEpbOutbound = 2;
+
+    constexpr int kCanMtu = 16;
+    constexpr int kCanFdMtu = 72;
+} // namespace Pcapng
+
+namespace Blf {
+    constexpr quint32 kFileSignature = 0x47474F4C; // "LOGG"
+    constexpr quint32 kObjectSignature = 0x4A424F4C; // "LOBJ"
+
+    enum ObjectType : quint32 { CanMessage = 1, LogContainer = 10, CanErrorExt = 73, CanFdMessage64 = 101 };
+
+    constexpr quint32 kTimeOneNans = 0x00000002;
+    constexpr quint16 kZlibDeflate = 2;
+
+    constexpr quint8 kCanMsgTx = 0x01;
+    constexpr quint8 kCanMsgRemote = 0x80;
+    constexpr quint32 kCanMsgExt = 0x80000000U;
+
+    constexpr quint32 kFdEdl = 0x1000;
+    constexpr quint32 kFdBrs = 0x2000;
+    constexpr quint32 kFdEsi = 0x4000;
+
+    struct SystemTime {
+        quint16 year;
+        quint16 month;
+        quint16 dayOfWeek;
+        quint16 day;
+        quint16 hour;
+        quint16 minute;
+        quint16 second;
+        quint16 milliseconds;
+    };
+
+    struct FileHeader {
+        quint32 signature;
+        quint32 headerSize;
+        quint8 applicationId;
+        quint8 applicationMajor;
+        quint8 applicationMinor;
+        quint8 applicationBuild;
+        quint8 binLogMajor;
+        quint8 binLogMinor;
+        quint8 binLogBuild;
+        quint8 binLogPatch;
+        quint64 fileSize;
+        quint64 uncompressedSize;
+        quint32 objectCount;
+        quint32 objectsRead;
+        SystemTime start;
+        SystemTime stop;
+        quint8 reserved[72];
+    };
+
+    struct ObjectHeaderBase {
+        quint32 signature;
+        quint16 headerSize;
+        quint16 headerVersion;
+        quint32 objectSize;
+        quint32 objectType;
+    };
+
+    struct ObjectHeader {
+        ObjectHeaderBase base;
+        quint32 flags;
+        quint16 clientIndex;
+        quint16 objectVersion;
+        quint64 timestamp;
+    };
+
+    struct LogContainer {
+        ObjectHeaderBase base;
+        quint16 compression;
+        quint8 reserved[6];
+        quint32 uncompressedSize;
+        quint32 reserved2;
+    };
+
+    struct CanMessage {
+        ObjectHeader header;
+        quint16 channel;
+        quint8 flags;
+        quint8 dlc;
+        quint32 id;
+        quint8 data[8];
+    };
+
+    struct CanFdMessage64 {
+        ObjectHeader header;
+        quint8 channel;
+        quint8 dlc;
+        quint8 validBytes;
+        quint8 txCount;
+        quint32 id;
+        quint32 frameLength;
+        quint32 flags;
+        quint32 btrCfgArb;
+        quint32 btrCfgData;
+        quint32 timeOffsetBrsNs;
+        quint32 timeOffsetCrcDelNs;
+        quint16 bitCount;
+        quint8 dir;
+        quint8 extDataOffset;
+        quint32 crc;
+        quint8 data[CanFrameRecord::kMaxPayload];
+    };
+
+    struct CanErrorExt {
+        ObjectHeader header;
+        quint16 channel;
+        quint16 length;
+        quint32 flags;
+        quint8 ecc;
+        quint8 position;
+        quint8 dlc;
+        quint8 reserved;
+        quint32 frameLengthNs;
+        quint32 id;
+        quint16 flagsExt;
+        quint16 reserved2;
+        quint8 data[8];
+    };
+
+    static_assert(sizeof(FileHeader) == 144, "Unexpected BLF FileHeader layout");
+    static_assert(sizeof(ObjectHeader) == 32, "Unexpected BLF ObjectHeader layout");
+    static_assert(sizeof(LogContainer) == 32, "Unexpected BLF LogContainer layout");
+    static_assert(sizeof(CanMessage) == 48, "Unexpected BLF CanMessage layout");
+    static_assert(sizeof(CanFdMessage64) == 136, "Unexpected BLF CanFdMessage64 layout");
+    static_assert(sizeof(CanErrorExt) == 64, "Unexpected BLF CanErrorExt layout");
+} // namespace Blf
+
+struct Chunk {
+    QByteArray data;
+    quint32 objects{ 0 }; // BLF objects in containers
+    quint64 uncompressedSize{ 0 }; // BLF containers before compression
+    quint64 lastTimestamp{ 0 };
+};
+
+int canFdDlc(int length)
+{
+    static const int dlcs[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+    // Lengths between DLC steps come from malformed records only, they get the next bigger DLC
+    return static_cast<int>(std::lower_bound(std::begin(dlcs), std::end(dlcs), length) - std::begin(dlcs)) & 0x0f;
+}
+
+template <typename T> void append(QByteArray& out, const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be appended");
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendPadding(QByteArray& out, int size)
+{
+    out.append(static_cast<int>((4 - (size & 3)) & 3), '\0');
+}
+
+/**
+*   @brief  Formats records of one format. Stateless once constructed, so chunks can be formatted concurrently.
+*/
+class Formatter {
+public:
+    Formatter(const TraceExporter::Options& options, quint64 startTimestamp)
+        : _options(options)
+        , _start(startTimestamp)
+        , _interfaceName(options.interfaceName.toLatin1())
+    {
+    }
+
+    QByteArray header() const
+    {
+        switch (_options.format) {
+        case TraceExporter::Format::Asc: {
+            const QByteArray date = ascDate();
+            return "date " + date + "\nbase hex  timestamps absolute\ninternal events logged\n// version 9.0.0\n"
+                + "Begin Triggerblock " + date + "\n   0.000000 Start of measurement\n";
+        }
+
+        case TraceExporter::Format::Blf:
+            // Placeholder, rewritten when totals are known
+            return blfHeader(0, 0, 0, _start);
+
+        case TraceExporter::Format::Pcapng:
+            return pcapngHeader();
+
+        case TraceExporter::Format::Candump:
+            break;
+        }
+
+        return {};
+    }
+
+    QByteArray footer() const
+    {
+        return (_options.format == TraceExporter::Format::Asc) ? QByteArray("End TriggerBlock\n") : QByteArray();
+    }
+
+    void format(const CanFrameBatch& records, Chunk& chunk) const
+    {
+        switch (_options.format) {
+        case TraceExporter::Format::Asc:
+            chunk.data.reserve(records.size() * 64);
+            for (const auto& rec : records) {
+                formatAsc(rec, chunk.data);
+            }
+            break;
+
+        case TraceExporter::Format::Candump:
+            chunk.data.reserve(records.size() * 48);
+            for (const auto& rec : records) {
+                formatCandump(rec, chunk.data);
+            }
+            break;
+
+        case TraceExporter::Format::Pcapng:
+            chunk.data.reserve(records.size() * (44 + Pcapng::kCanMtu));
+            for (const auto& rec : records) {
+                formatPcapng(rec, chunk.data);
+            }
+            break;
+
+        case TraceExporter::Format::Blf:
+            formatBlf(records, chunk);
+            break;
+        }
+
+        for (const auto& rec : records) {
+            chunk.lastTimestamp = std::max(chunk.lastTimestamp, rec.timestamp);
+        }
+    }
+
+    QByteArray blfHeader(quint64 fileSize, quint64 uncompressedSize, quint32 objects, quint64 lastTimestamp) const
+    {
+        Blf::FileHeader header{};
+
+        header.signature = qToLittleEndian(Blf::kFileSignature);
+        header.headerSize = qToLittleEndian<quint32>(sizeof(header));
+        header.applicationId = 5;
+        header.binLogMajor = 2;
+        header.binLogMinor = 6;
+        header.binLogBuild = 8;
+        header.binLogPatch = 1;
+        header.fileSize = qToLittleEndian(fileSize);
+        header.uncompressedSize = qToLittleEndian(uncompressedSize);
+        header.objectCount = qToLittleEndian(objects);
+        header.objectsRead = qToLittleEndian(objects);
+        header.start = systemTime(_start);
+        header.stop = systemTime(lastTimestamp);
+
+        QByteArray out;
+        append(out, header);
+        return out;
+    }
+
+private:
+    QByteArray ascDate() const
+    {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(_start / 1000));
+
+        // e.g. "Wed Oct 14 01:17:35.000 pm 2026", "ap" switches hours to 12-hour clock
+        return QLocale::c().toString(time, "ddd MMM dd hh:mm:ss.zzz ap yyyy").toLatin1();
+    }
+
+    static Blf::SystemTime systemTime(quint64 timestamp)
+    {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(timestamp / 1000));
+        const QDate date = time.date();
+        const QTime clock = time.time();
+        Blf::SystemTime st;
+
+        st.year = qToLittleEndian<quint16>(date.year());
+        st.month = qToLittleEndian<quint16>(date.month());
+        st.dayOfWeek = qToLittleEndian<quint16>(date.dayOfWeek() % 7); // Sunday is 0
+        st.day = qToLittleEndian<quint16>(date.day());
+        st.hour = qToLittleEndian<quint16>(clock.hour());
+        st.minute = qToLittleEndian<quint16>(clock.minute());
+        st.second = qToLittleEndian<quint16>(clock.second());
+        st.milliseconds = qToLittleEndian<quint16>(clock.msec());
+
+        return st;
+    }
+
+    // Time since start of export, records older than the first one are clamped
+    quint64 relativeUs(const CanFrameRecord& rec) const
+    {
+        return (rec.timestamp > _start) ? rec.timestamp - _start : 0;
+    }
+
+    int channelOf(const CanFrameRecord& rec) const
+    {
+        return rec.channel ? rec.channel : _options.channel;
+    }
+
+    void formatAsc(const CanFrameRecord& rec, QByteArray& out) const
+    {
+        char line[512];
+        const quint64 time = relativeUs(rec);
+        const int length = std::min<int>(rec.length, CanFrameRecord::kMaxPayload);
+        const int classicLength = std::min(length, 8);
+        const char* dir = rec.hasFlag(CanFrameRecord::Tx) ? "Tx" : "Rx";
+        char id[16];
+        int size = std::snprintf(line, sizeof(line), "%4llu.%06llu ", static_cast<unsigned long long>(time / 1000000),
+            static_cast<unsigned long long>(time % 1000000));
+
+        std::snprintf(id, sizeof(id), rec.hasFlag(CanFrameRecord::ExtendedId) ? "%Xx" : "%X", rec.id);
+
+        if (rec.hasFlag(CanFrameRecord::Error)) {
+            size += std::snprintf(line + size, sizeof(line) - size, "%d  ErrorFrame", channelOf(rec));
+        } else if (rec.hasFlag(CanFrameRecord::FlexibleDataRate)) {
+            const quint32 flags = Blf::kFdEdl | (rec.hasFlag(CanFrameRecord::BitrateSwitch) ? Blf::kFdBrs : 0)
+                | (rec.hasFlag(CanFrameRecord::ErrorStateIndicator) ? Blf::kFdEsi : 0);
+
+            size += std::snprintf(line + size, sizeof(line) - size, "CANFD %3d %-4s %8s %32s %d %d %x %2d ",
+                channelOf(rec), dir, id, "", rec.hasFlag(CanFrameRecord::BitrateSwitch) ? 1 : 0,
+                rec.hasFlag(CanFrameRecord::ErrorStateIndicator) ? 1 : 0, canFdDlc(length), length);
+            size = static_cast<int>(HexFormat::appendUpperHex(line + size, rec.payload, length, ' ') - line);
+            size += std::snprintf(
+                line + size, sizeof(line) - size, " %8d %4d %8X %8d %8d %8d %8d %8d", 0, 0, flags, 0, 0, 0, 0, 0);
+        } else if (rec.hasFlag(CanFrameRecord::Remote)) {
+            size += std::snprintf(
+                line + size, sizeof(line) - size, "%d  %-15s %-4s r %x", channelOf(rec), id, dir, classicLength);
+        } else {
+            size += std::snprintf(
+                line + size, sizeof(line) - size, "%d  %-15s %-4s d %x ", channelOf(rec), id, dir, classicLength);
+            size = static_cast<int>(HexFormat::appendUpperHex(line + size, rec.payload, classicLength, ' ') - line);
+        }
+
+        line[size++] = '\n';
+        out.append(line, size);
+    }
+
+    void formatCandump(const CanFrameRecord& rec, QByteArray& out) const
+    {
+        char line[256];
+        const int length = std::min<int>(rec.length, CanFrameRecord::kMaxPayload);
+        int size = std::snprintf(line, sizeof(line), "(%llu.%06llu) %s ",
+            static_cast<unsigned long long>(rec.timestamp / 1000000),
+            static_cast<unsigned long long>(rec.timestamp % 1000000), _interfaceName.constData());
+
+        if (rec.hasFlag(CanFrameRecord::Error)) {
+            size += std::snprintf(line + size, sizeof(line) - size, "%08X#", (rec.id & 0x1fffffff) | kCanErrFlag);
+        } else if (rec.hasFlag(CanFrameRecord::ExtendedId)) {
+            size += std::snprintf(line + size, sizeof(line) - size, "%08X#", rec.id & 0x1fffffff);
+        } else {
+            size += std::snprintf(line + size, sizeof(line) - size, "%03X#", rec.id & 0x7ff);
+        }
+
+        if (rec.hasFlag(CanFrameRecord::FlexibleDataRate)) {
+            const int flags = (rec.hasFlag(CanFrameRecord::BitrateSwitch) ? kCanFdBrs : 0)
+                | (rec.hasFlag(CanFrameRecord::ErrorStateIndicator) ? kCanFdEsi : 0);
+
+            size += std::snprintf(line + size, sizeof(line) - size, "#%X", flags);
+            size = static_cast<int>(HexFormat::appendUpperHex(line + size, rec.payload, length) - line);
+        } else if (rec.hasFlag(CanFrameRecord::Remote)) {
+            line[size++] = 'R';
+            if (length > 0) {
+                size += std::snprintf(line + size, sizeof(line) - size, "%d", std::min(length, 8));
+            }
+        } else {
+            size = static_cast<int>(HexFormat::appendUpperHex(line + size, rec.payload, std::min(length, 8)) - line);
+        }
+
+        line[size++] = '\n';
+        out.append(line, size);
+    }
+
+    QByteArray pcapngHeader() const
+    {
+        QByteArray out;
+        const QByteArray application = "CANdevStudio";
+
+        // Section header block
+        const quint32 shbLength = 28 + 4 + ((application.size() + 3) & ~3) + 4;
+        append(out, Pcapng::kSectionHeaderBlock);
+        append(out, shbLength);
+        append(out, Pcapng::kByteOrderMagic);
+        append<quint16>(out, 1);
+        append<quint16>(out, 0);
+        append<qint64>(out, -1); // section length not specified
+        appendOption(out, Pcapng::kOptShbUserAppl, application);
+        appendOption(out, Pcapng::kOptEnd, QByteArray());
+        append(out, shbLength);
+
+        // Interface description block, timestamps are in microseconds
+        const QByteArray tsResol(1, 6);
+        const quint32 idbLength = 20 + 4 + ((_interfaceName.size() + 3) & ~3) + 8 + 4;
+        append(out, Pcapng::kInterfaceDescriptionBlock);
+        append(out, idbLength);
+        append(out, Pcapng::kLinkTypeCanSocketCan);
+        append<quint16>(out, 0);
+        append<quint32>(out, Pcapng::kCanFdMtu); // snap length
+        appendOption(out, Pcapng::kOptIfName, _interfaceName);
+        appendOption(out, Pcapng::kOptIfTsResol, tsResol);
+        appendOption(out, Pcapng::kOptEnd, QByteArray());
+        append(out, idbLength);
+
+        return out;
+    }
+
+    static void appendOption(QByteArray& out, quint16 code, const QByteArray& value)
+    {
+        append(out, code);
+        append<quint16>(out, static_cast<quint16>(value.size()));
+        out.append(value);
+        appendPadding(out, value.size());
+    }
+
+    void formatPcapng(const CanFrameRecord& rec, QByteArray& out) const
+    {
+        const bool fd = rec.hasFlag(CanFrameRecord::FlexibleDataRate);
+        const int mtu = fd ? Pcapng::kCanFdMtu : Pcapng::kCanMtu;
+        const int length = std::min<int>(rec.length, fd ? CanFrameRecord::kMaxPayload : 8);
+        const quint32 blockLength = 32 + mtu + 8 + 4;
+        quint32 canId = rec.id & (rec.hasFlag(CanFrameRecord::ExtendedId) ? 0x1fffffff : 0x7ff);
+
+        if (rec.hasFlag(CanFrameRecord::ExtendedId)) {
+            canId |= kCanEffFlag;
+        }
+        if (rec.hasFlag(CanFrameRecord::Remote)) {
+            canId |= kCanRtrFlag;
+        }
+        if (rec.hasFlag(CanFrameRecord::Error)) {
+            canId |= kCanErrFlag;
+        }
+
+        append(out, Pcapng::kEnhancedPacketBlock);
+        append(out, blockLength);
+        append<quint32>(out, 0); // interface
+        append<quint32>(out, static_cast<quint32>(rec.timestamp >> 32));
+        append<quint32>(out, static_cast<quint32>(rec.timestamp));
+        append<quint32>(out, mtu); // captured length
+        append<quint32>(out, mtu); // original length
+
+        // SocketCAN frame, can_id is big endian regardless of section byte order
+        quint8 frame[Pcapng::kCanFdMtu] = {};
+        qToBigEndian(canId, frame);
+        frame[4] = static_cast<quint8>(length);
+        if (fd) {
+            frame[5] = kCanFdFdf | (rec.hasFlag(CanFrameRecord::BitrateSwitch) ? kCanFdBrs : 0)
+                | (rec.hasFlag(CanFrameRecord::ErrorStateIndicator) ? kCanFdEsi : 0);
+        }
+        if (!rec.hasFlag(CanFrameRecord::Remote)) {
+            std::memcpy(frame + 8, rec.payload, static_cast<std::size_t>(length));
+        }
+        out.append(reinterpret_cast<const char*>(frame), mtu);
+
+        append(out, Pcapng::kOptEpbFlags);
+        append<quint16>(out, 4);
+        append<quint32>(out, rec.hasFlag(CanFrameRecord::Tx) ? Pcapng::kEpbOutbound : Pcapng::kEpbInbound);
+        append(out, Pcapng::kOptEnd);
+        append<quint16>(out, 0);
+        append(out, blockLength);
+    }
+
+    Blf::ObjectHeader blfObjectHeader(const CanFrameRecord& rec, Blf::ObjectType type, quint32 size) const
+    {
+        Blf::ObjectHeader header{};
+
+        header.base.signature = qToLittleEndian(Blf::kObjectSignature);
+        header.base.headerSize = qToLittleEndian<quint16>(sizeof(Blf::ObjectHeader));
+        header.base.headerVersion = qToLittleEndian<quint16>(1);
+        header.base.objectSize = qToLittleEndian(size);
+        header.base.objectType = qToLittleEndian<quint32>(type);
+        header.flags = qToLittleEndian(Blf::kTimeOneNans);
+        header.timestamp = qToLittleEndian(relativeUs(rec) * 1000);
+
+        return header;
+    }
+
+    void formatBlf(const CanFrameBatch& records, Chunk& chunk) const
+    {
+        QByteArray objects;
+        objects.reserve(TraceExporter::kBlfContainerSize);
+
+        for (const auto& rec : records) {
+            // Containers hold whole objects, the largest one always fits into an empty container
+            if (objects.size() + static_cast<int>(sizeof(Blf::CanFdMessage64)) > TraceExporter::kBlfContainerSize) {
+                appendBlfContainer(objects, chunk);
+                objects.resize(0);
+            }
+
+            appendBlfObject(rec, objects);
+            ++chunk.objects;
+        }
+
+        if (!objects.isEmpty()) {
+            appendBlfContainer(objects, chunk);
+        }
+    }
+
+    void appendBlfObject(const CanFrameRecord& rec, QByteArray& out) const
+    {
+        const int length = std::min<int>(rec.length, CanFrameRecord::kMaxPayload);
+        const quint32 id = rec.id | (rec.hasFlag(CanFrameRecord::ExtendedId) ? Blf::kCanMsgExt : 0);
+
+        // All objects are multiples of 4 bytes, so no padding follows them
+        if (rec.hasFlag(CanFrameRecord::Error)) {
+            Blf::CanErrorExt obj{};
+
+            obj.header = blfObjectHeader(rec, Blf::CanErrorExt, sizeof(obj));
+            obj.channel = qToLittleEndian<quint16>(channelOf(rec));
+            obj.length = qToLittleEndian<quint16>(std::min(length, 8));
+            obj.dlc = static_cast<quint8>(std::min(length, 8));
+            obj.id = qToLittleEndian(id);
+            std::memcpy(obj.data, rec.payload, std::min<std::size_t>(length, sizeof(obj.data)));
+            append(out, obj);
+        } else if (rec.hasFlag(CanFrameRecord::FlexibleDataRate)) {
+            Blf::CanFdMessage64 obj{};
+            const quint32 flags = Blf::kFdEdl | (rec.hasFlag(CanFrameRecord::BitrateSwitch) ? Blf::kFdBrs : 0)
+                | (rec.hasFlag(CanFrameRecord::ErrorStateIndicator) ? Blf::kFdEsi : 0);
+
+            obj.header = blfObjectHeader(rec, Blf::CanFdMessage64, sizeof(obj));
+            obj.channel = static_cast<quint8>(channelOf(rec));
+            obj.dlc = static_cast<quint8>(canFdDlc(length));
+            obj.validBytes = static_cast<quint8>(length);
+            obj.id = qToLittleEndian(id);
+            obj.flags = qToLittleEndian(flags);
+            obj.dir = rec.hasFlag(CanFrameRecord::Tx) ? 1 : 0;
+            std::memcpy(obj.data, rec.payload, static_cast<std::size_t>(length));
+            append(out, obj);
+        } else {
+            Blf::CanMessage obj{};
+            const bool remote = rec.hasFlag(CanFrameRecord::Remote);
+
+            obj.header = blfObjectHeader(rec, Blf::CanMessage, sizeof(obj));
+            obj.channel = qToLittleEndian<quint16>(channelOf(rec));
+            obj.flags = (rec.hasFlag(CanFrameRecord::Tx) ? Blf::kCanMsgTx : 0) | (remote ? Blf::kCanMsgRemote : 0);
+            obj.dlc = static_cast<quint8>(std::min(length, 8));
+            obj.id = qToLittleEndian(id);
+            if (!remote) {
+                std::memcpy(obj.data, rec.payload, std::min<std::size_t>(length, sizeof(obj.data)));
+            }
+            append(out, obj);
+        }
+    }
+
+    static void appendBlfContainer(const QByteArray& objects, Chunk& chunk)
+    {
+        // qCompress output is zlib stream prefixed with big endian uncompressed size
+        const QByteArray compressed = qCompress(objects, 6);
+        const int dataSize = compressed.size() - 4;
+        const quint32 size = sizeof(Blf::LogContainer) + dataSize;
+        Blf::LogContainer container{};
+
+        container.base.signature = qToLittleEndian(Blf::kObjectSignature);
+        container.base.headerSize = qToLittleEndian<quint16>(sizeof(Blf::ObjectHeaderBase));
+        container.base.headerVersion = qToLittleEndian<quint16>(1);
+        container.base.objectSize = qToLittleEndian(size);
+        container.base.objectType = qToLittleEndian<quint32>(Blf::LogContainer);
+        container.compression = qToLittleEndian(Blf::kZlibDeflate);
+        container.uncompressedSize = qToLittleEndian<quint32>(objects.size());
+
+        append(chunk.data, container);
+        chunk.data.append(compressed.constData() + 4, dataSize);
+        // BLF readers skip (object size % 4) bytes after every object
+        chunk.data.append(static_cast<int>(size % 4), '\0');
+        chunk.uncompressedSize += sizeof(Blf::LogContainer) + objects.size();
+    }
+
+    const TraceExporter::Options _options;
+    const quint64 _start;
+    const QByteArray _interfaceName;
+};
+
+bool writeAll(QFile& file, const QByteArray& data)
+{
+    return file.write(data) == data.size();
+}
+} // namespace
+
+TraceExporter::~TraceExporter()
+{
+    wait();
+}
+
+void TraceExporter::exportAsync(const QString& path, const CanFrameBatch& records, const Options& options)
+{
+    startJob(path, [path, records, options] { return exportRecords(path, records, options); });
+}
+
+void TraceExporter::exportAsync(const QString& path, const QString& tracePath, const Options& options)
+{
+    startJob(path, [path, tracePath, options] { return exportTrace(path, tracePath, options); });
+}
+
+bool TraceExporter::exportRecords(const QString& path, quint64 count, const Source& source, const Options& options)
+{
+    // Chunks are written with single large writes, another buffering layer would only copy them
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        cds_error("Failed to create export file '{}': {}", path.toStdString(), file.errorString().toStdString());
+        return false;
+    }
+
+    const CanFrameBatch first = count ? source(0, 1) : CanFrameBatch();
+    const quint64 start = first.isEmpty() ? canTimestampNow() : first.front().timestamp;
+    const Formatter formatter(options, start);
+    const std::size_t threads
+        = static_cast<std::size_t>((options.threads > 0) ? options.threads : std::max(1, QThread::idealThreadCount()));
+
+    const QByteArray header = formatter.header();
+    bool ok = writeAll(file, header);
+    quint64 uncompressedSize = static_cast<quint64>(header.size());
+    quint32 objects = 0;
+    quint64 lastTimestamp = start;
+
+    std::vector<Chunk> ready;
+    quint64 next = 0;
+
+    while (ok && ((next < count) || !ready.empty())) {
+        std::vector<CanFrameBatch> batches;
+
+        while ((batches.size() < threads) && (next < count)) {
+            const int size = static_cast<int>(std::min<quint64>(kChunkRecords, count - next));
+
+            batches.push_back(source(next, size));
+            next += static_cast<quint64>(size);
+
+            if (batches.back().size() < size) {
+                cds_warn("Export source ended at record {} of {}", next - size + batches.back().size(), count);
+                next = count;
+            }
+        }
+
+        std::vector<Chunk> formatted(batches.size());
+        std::vector<std::thread> workers;
+
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            workers.emplace_back([&formatter, &batches, &formatted, i] { formatter.format(batches[i], formatted[i]); });
+        }
+
+        // Previous round is written in order while this one is being formatted
+        for (const auto& chunk : ready) {
+            if (!writeAll(file, chunk.data)) {
+                ok = false;
+                break;
+            }
+
+            uncompressedSize += chunk.uncompressedSize;
+            objects += chunk.objects;
+            lastTimestamp = std::max(lastTimestamp, chunk.lastTimestamp);
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        ready = std::move(formatted);
+    }
+
+    ok = ok && writeAll(file, formatter.footer());
+
+    if (ok && (options.format == Format::Blf)) {
+        const quint64 fileSize = static_cast<quint64>(file.size());
+
+        ok = file.seek(0) && writeAll(file, formatter.blfHeader(fileSize, uncompressedSize, objects, lastTimestamp));
+    }
+
+    if (!ok) {
+        cds_error("Failed to write export file '{}': {}", path.toStdString(), file.errorString().toStdString());
+    }
+
+    return ok;
+}
+
+bool TraceExporter::exportRecords(const QString& path, const CanFrameBatch& records, const Options& options)
+{
+    return exportRecords(path, static_cast<quint64>(records.size()),
+        [&records](quint64 first, int count) { return records.mid(static_cast<int>(first), count); }, options);
+}
+
+bool TraceExporter::exportTrace(const QString& path, const QString& tracePath, const Options& options)
+{
+    TraceReader reader;
+
+    if (!reader.open(tracePath)) {
+        cds_error("Failed to open trace '{}'", tracePath.toStdString());
+        return false;
+    }
+
+    return exportRecords(path, reader.recordCount(),
+        [&reader](quint64 first, int count) { return reader.records(first, static_cast<quint64>(count)); }, options);
+}
+
+bool TraceExporter::formatFromPath(const QString& path, Format& format)
+{
+    static const struct {
+        const char* suffix;
+        Format format;
+    } formats[] = { { "asc", Format::Asc }, { "blf", Format::Blf }, { "log", Format::Candump },
+        { "pcapng", Format::Pcapng } };
+
+    const QString suffix = QFileInfo(path).suffix().toLower();
+
+    for (const auto& f : formats) {
+        if (suffix == QLatin1String(f.suffix)) {
+            format = f.format;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TraceExporter::run()
+{
+    const bool status = _job();
+
+    // Release snapshot right away, it may be big
+    _job = nullptr;
+
+    emit exported(_path, status);
+}
+
+void TraceExporter::startJob(const QString& path, std::function<bool()>&& job)
+{
+    wait();
+
+    _path = path;
+    _job = std::move(job);
+
+    start(QThread::LowPriority);
+}
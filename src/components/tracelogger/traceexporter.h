@@ -0,0 +1,106 @@
+#ifndef TRACEEXPORTER_H
+#define TRACEEXPORTER_H
+
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <canframerecord.h>
+#include <functional>
+
+/**
+*   @brief  Exports frame records to formats of other CAN tools
+*
+*   Supported formats are Vector ASC, Vector BLF (zlib compressed log containers), candump log and pcapng with
+*   SocketCAN link type. Records are fetched from source in chunks of kChunkRecords. Each round of chunks is
+*   formatted by several threads at once into separate buffers, while buffers of the previous round are written
+*   in order with one large write per chunk. At most two rounds are held in memory, whatever the size of export.
+*/
+class TraceExporter : public QThread {
+    Q_OBJECT
+
+public:
+    enum class Format { Asc, Blf, Candump, Pcapng };
+
+    static constexpr int kChunkRecords = 16384;
+    // Uncompressed size of BLF log container, the same as used by Vector tools
+    static constexpr int kBlfContainerSize = 128 * 1024;
+
+    struct Options {
+        Format format{ Format::Asc };
+        int channel{ 1 }; // ASC and BLF channel number of records not tagged with channel
+        QString interfaceName{ "can0" }; // candump and pcapng interface name
+        int threads{ 0 }; // formatting threads, 0 for QThread::idealThreadCount()
+    };
+
+    /**
+    *   @brief  Provides records for export. Called from exporting thread only.
+    *   @param  first index of the first record
+    *   @param  count number of records
+    *   @return copy of records
+    */
+    typedef std::function<CanFrameBatch(quint64 first, int count)> Source;
+
+    TraceExporter() = default;
+    ~TraceExporter();
+
+    /**
+    *   @brief  Starts exporting snapshot of records in worker thread. Waits for previous export to complete first.
+    *   @param  path output file path, existing file is overwritten
+    *   @param  records records to be exported
+    *   @param  options export options
+    */
+    void exportAsync(const QString& path, const CanFrameBatch& records, const Options& options);
+
+    /**
+    *   @brief  Starts exporting binary trace (.cdst) in worker thread. Waits for previous export to complete first.
+    *   @param  path output file path, existing file is overwritten
+    *   @param  tracePath trace to be exported
+    *   @param  options export options
+    */
+    void exportAsync(const QString& path, const QString& tracePath, const Options& options);
+
+    /**
+    *   @brief  Exports records synchronously from calling thread
+    *   @param  path output file path, existing file is overwritten
+    *   @param  count number of records
+    *   @param  source source of records
+    *   @param  options export options
+    *   @return false on I/O error
+    */
+    static bool exportRecords(const QString& path, quint64 count, const Source& source, const Options& options);
+
+    /**
+    *   @brief  Exports snapshot of records synchronously from calling thread
+    */
+    static bool exportRecords(const QString& path, const CanFrameBatch& records, const Options& options);
+
+    /**
+    *   @brief  Exports binary trace (.cdst) synchronously from calling thread
+    *   @return false if trace could not be opened or on I/O error
+    */
+    static bool exportTrace(const QString& path, const QString& tracePath, const Options& options);
+
+    /**
+    *   @brief  Guesses format from file suffix: .asc, .blf, .log (candump) and .pcapng
+    *   @param  path file path
+    *   @param  format set to guessed format
+    *   @return false if suffix is not known
+    */
+    static bool formatFromPath(const QString& path, Format& format);
+
+signals:
+    /**
+    *   @brief  Emitted from worker thread when export started with exportAsync() completes
+    */
+    void exported(const QString& path, bool status);
+
+protected:
+    void run() override;
+
+private:
+    void startJob(const QString& path, std::function<bool()>&& job);
+
+    QString _path;
+    std::function<bool()> _job;
+};
+
+#endif // TRACEEXPORTER_H
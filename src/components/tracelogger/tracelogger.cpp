@@ -0,0 +1,99 @@
+#include "tracelogger.h"
+#include "tracelogger_p.h"
+#include <log.h>
+
+TraceLogger::TraceLogger()
+    : d_ptr(new TraceLoggerPrivate())
+{
+}
+
+TraceLogger::~TraceLogger()
+{
+}
+
+void TraceLogger::startSimulation()
+{
+    Q_D(TraceLogger);
+
+    d->_tracePath = d->nextTracePath();
+    d->_simStarted = d->_writer.open(d->_tracePath, d->_flushInterval);
+
+    if (d->_simStarted) {
+        cds_info("Trace logging to '{}' started", d->_tracePath.toStdString());
+    }
+}
+
+void TraceLogger::stopSimulation()
+{
+    Q_D(TraceLogger);
+
+    if (!d->_simStarted) {
+        return;
+    }
+
+    d->_simStarted = false;
+    d->_writer.close();
+    cds_info("Trace '{}' closed, {} frames written", d->_tracePath.toStdString(), d->_writer.recordsWritten());
+}
+
+void TraceLogger::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(TraceLogger);
+
+    if (d->_simStarted) {
+        d->_writer.append(frames);
+    }
+}
+
+void TraceLogger::frameBatchSent(bool status, const CanFrameBatch& frames)
+{
+    Q_D(TraceLogger);
+
+    if (!d->_simStarted) {
+        return;
+    }
+
+    if (status) {
+        d->_writer.append(frames);
+        return;
+    }
+
+    // Failed transmissions are kept in trace, marked as such
+    CanFrameBatch failed = frames;
+    for (auto& rec : failed) {
+        rec.flags |= CanFrameRecord::TxFailed;
+    }
+    d->_writer.append(failed);
+}
+
+void TraceLogger::setConfig(QJsonObject& json)
+{
+    Q_D(TraceLogger);
+
+    if (json.contains("file")) {
+        d->_file = json["file"].toString();
+    }
+
+    if (json.contains("flushInterval")) {
+        d->_flushInterval = json["flushInterval"].toInt(TraceWriter::kDefaultFlushIntervalMs);
+    }
+}
+
+QJsonObject TraceLogger::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+QString TraceLogger::tracePath() const
+{
+    return d_ptr->_tracePath;
+}
+
+quint64 TraceLogger::framesWritten() const
+{
+    return d_ptr->_writer.recordsWritten();
+}
@@ -0,0 +1,57 @@
+#ifndef TRACELOGGER_H
+#define TRACELOGGER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+
+class TraceLoggerPrivate;
+
+/**
+*   @brief  Component writing all frames passed to it into binary trace file (see tracefile.h)
+*
+*   Trace is created on simulation start and finalized on simulation stop. Disk writes are done by background
+*   thread, so logging does not block the thread delivering frames.
+*/
+class TraceLogger : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(TraceLogger)
+
+public:
+    TraceLogger();
+    ~TraceLogger();
+
+    /**
+    *   @brief  Supported keys: file (trace path, by default trace_<date>_<time>.cdst in current directory),
+    *           flushInterval (ms)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @return path of trace currently written (or last written), empty if none
+    */
+    QString tracePath() const;
+
+    /**
+    *   @return number of frames written to current (or last) trace
+    */
+    quint64 framesWritten() const;
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<TraceLoggerPrivate> d_ptr;
+};
+
+#endif // TRACELOGGER_H
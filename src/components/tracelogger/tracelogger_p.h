@@ -0,0 +1,36 @@
+#ifndef TRACELOGGER_P_H
+#define TRACELOGGER_P_H
+
+#include "tracelogger.h"
+#include "tracewriter.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QJsonObject>
+
+class TraceLoggerPrivate {
+public:
+    /**
+    *   @brief  Path of next trace. Every simulation run gets its own file unless path is configured.
+    */
+    QString nextTracePath() const
+    {
+        if (!_file.isEmpty()) {
+            return _file;
+        }
+
+        return QString("trace_%1.cdst").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["file"] = _file;
+        json["flushInterval"] = _flushInterval;
+    }
+
+    TraceWriter _writer;
+    QString _file;
+    QString _tracePath;
+    int _flushInterval{ TraceWriter::kDefaultFlushIntervalMs };
+    bool _simStarted{ false };
+};
+
+#endif // TRACELOGGER_P_H
@@ -0,0 +1,274 @@
+#include "tracewriter.h"
+#include <algorithm>
+#include <log.h>
+
+constexpr int TraceWriter::kBlockRecords;
+constexpr std::size_t TraceWriter::kMaxBufferedRecords;
+constexpr int TraceWriter::kDefaultFlushIntervalMs;
+
+TraceWriter::TraceWriter()
+    : _worker(*this)
+{
+    _worker.setObjectName("TraceWriter");
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+bool TraceWriter::open(const QString& path, int flushIntervalMs)
+{
+    close();
+
+    if (!createFile(path)) {
+        return false;
+    }
+
+    _flushInterval = std::chrono::milliseconds(std::max(1, flushIntervalMs));
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _front.clear();
+        _front.reserve(kBlockRecords);
+        _quit = false;
+    }
+
+    _worker.start(QThread::LowPriority);
+
+    return true;
+}
+
+void TraceWriter::close()
+{
+    if (!_worker.isRunning()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+
+    _cv.notify_one();
+    _worker.wait();
+
+    // Writer thread is stopped, remaining data can be written from here
+    writeRecords(_front.data(), _front.size());
+    _front.clear();
+    writeIndexBlock();
+    writeTrailer();
+    _file.close();
+
+    if (_dropped > 0) {
+        cds_warn("Trace writer dropped {} records", _dropped.load());
+    }
+}
+
+bool TraceWriter::isOpen() const
+{
+    return _file.isOpen();
+}
+
+void TraceWriter::append(const CanFrameBatch& records)
+{
+    bool notify = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const std::size_t room = (_front.size() < kMaxBufferedRecords) ? kMaxBufferedRecords - _front.size() : 0;
+        const std::size_t count = std::min<std::size_t>(room, records.size());
+
+        _front.insert(_front.end(), records.constBegin(), records.constBegin() + count);
+        _dropped += records.size() - count;
+        notify = _front.size() >= static_cast<std::size_t>(kBlockRecords);
+    }
+
+    if (notify) {
+        _cv.notify_one();
+    }
+}
+
+quint64 TraceWriter::recordsWritten() const
+{
+    return _written.load(std::memory_order_relaxed);
+}
+
+quint64 TraceWriter::recordsDropped() const
+{
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+bool TraceWriter::writeTrace(const QString& path, const CanFrameBatch& records)
+{
+    TraceWriter writer;
+
+    if (!writer.createFile(path)) {
+        return false;
+    }
+
+    // Writer thread is not started, everything is written from here
+    writer.writeRecords(records.constData(), static_cast<std::size_t>(records.size()));
+    writer.writeIndexBlock();
+    writer.writeTrailer();
+    writer._file.close();
+
+    return !writer._ioError;
+}
+
+bool TraceWriter::createFile(const QString& path)
+{
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cds_error("Failed to create trace file '{}': {}", path.toStdString(), _file.errorString().toStdString());
+        return false;
+    }
+
+    TraceFile::FileHeader header{};
+    header.magic = TraceFile::kFileMagic;
+    header.version = TraceFile::kVersion;
+    header.headerSize = sizeof(TraceFile::FileHeader);
+    header.recordSize = sizeof(CanFrameRecord);
+    header.startTimestamp = canTimestampNow();
+
+    _offset = 0;
+    _lastIndexOffset = 0;
+    _endTimestamp = header.startTimestamp;
+    _ioError = false;
+    _pendingIndex.clear();
+    _written = 0;
+    _dropped = 0;
+
+    if (!write(&header, sizeof(header))) {
+        _file.close();
+        return false;
+    }
+
+    return true;
+}
+
+void TraceWriter::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_quit) {
+        _cv.wait_for(lock, _flushInterval,
+            [this] { return _quit || (_front.size() >= static_cast<std::size_t>(kBlockRecords)); });
+
+        if (_quit) {
+            // Rest is written by close()
+            break;
+        }
+
+        if (_front.empty()) {
+            continue;
+        }
+
+        // Double buffering: producer keeps appending to the other buffer while this one is written
+        _back.clear();
+        _back.swap(_front);
+        lock.unlock();
+
+        writeRecords(_back.data(), _back.size());
+
+        lock.lock();
+    }
+}
+
+void TraceWriter::writeRecords(const CanFrameRecord* records, std::size_t count)
+{
+    for (std::size_t pos = 0; pos < count; pos += kBlockRecords) {
+        writeDataBlock(records + pos, static_cast<int>(std::min<std::size_t>(kBlockRecords, count - pos)));
+    }
+
+    if (_file.isOpen() && !_ioError) {
+        _file.flush();
+    }
+}
+
+void TraceWriter::writeDataBlock(const CanFrameRecord* records, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    TraceFile::BlockHeader header{};
+    header.magic = TraceFile::kBlockMagic;
+    header.kind = TraceFile::DataBlock;
+    header.count = static_cast<quint32>(count);
+    header.minTimestamp = records[0].timestamp;
+    header.maxTimestamp = records[0].timestamp;
+    header.link = _written;
+
+    for (int i = 1; i < count; ++i) {
+        header.minTimestamp = std::min(header.minTimestamp, records[i].timestamp);
+        header.maxTimestamp = std::max(header.maxTimestamp, records[i].timestamp);
+    }
+
+    const quint64 offset = _offset;
+    if (!write(&header, sizeof(header)) || !write(records, static_cast<qint64>(count) * sizeof(CanFrameRecord))) {
+        return;
+    }
+
+    _pendingIndex.push_back(TraceFile::IndexEntry{
+        offset, header.link, header.count, 0, header.minTimestamp, header.maxTimestamp });
+    _written += count;
+    _endTimestamp = std::max(_endTimestamp, header.maxTimestamp);
+
+    if (_pendingIndex.size() >= static_cast<std::size_t>(TraceFile::kIndexInterval)) {
+        writeIndexBlock();
+    }
+}
+
+void TraceWriter::writeIndexBlock()
+{
+    if (_pendingIndex.empty()) {
+        return;
+    }
+
+    TraceFile::BlockHeader header{};
+    header.magic = TraceFile::kBlockMagic;
+    header.kind = TraceFile::IndexBlock;
+    header.count = static_cast<quint32>(_pendingIndex.size());
+    header.minTimestamp = _pendingIndex.front().minTimestamp;
+    header.maxTimestamp = _pendingIndex.front().maxTimestamp;
+    header.link = _lastIndexOffset;
+
+    for (const auto& entry : _pendingIndex) {
+        header.minTimestamp = std::min(header.minTimestamp, entry.minTimestamp);
+        header.maxTimestamp = std::max(header.maxTimestamp, entry.maxTimestamp);
+    }
+
+    const quint64 offset = _offset;
+    if (write(&header, sizeof(header))
+        && write(_pendingIndex.data(), static_cast<qint64>(_pendingIndex.size()) * sizeof(TraceFile::IndexEntry))) {
+        _lastIndexOffset = offset;
+    }
+
+    _pendingIndex.clear();
+}
+
+void TraceWriter::writeTrailer()
+{
+    TraceFile::FileTrailer trailer{ TraceFile::kTrailerMagic, _lastIndexOffset, _written, _endTimestamp };
+
+    write(&trailer, sizeof(trailer));
+}
+
+bool TraceWriter::write(const void* data, qint64 size)
+{
+    if (_ioError) {
+        return false;
+    }
+
+    if (_file.write(static_cast<const char*>(data), size) != size) {
+        cds_error("Failed to write trace file: {}", _file.errorString().toStdString());
+        _ioError = true;
+        return false;
+    }
+
+    _offset += static_cast<quint64>(size);
+
+    return true;
+}
@@ -0,0 +1,120 @@
+#ifndef TRACEWRITER_H
+#define TRACEWRITER_H
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <atomic>
+#include <canframerecord.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <tracefile.h>
+#include <vector>
+
+/**
+*   @brief  Streams frame records to binary trace file (see tracefile.h) from background thread
+*
+*   Producer appends records to front buffer under short lock. Writer thread swaps front and back buffers and
+*   writes back buffer without holding the lock, so producer is never blocked by disk I/O. Data is flushed when
+*   block is full or flush interval elapses, whichever comes first.
+*/
+class TraceWriter {
+public:
+    static constexpr int kBlockRecords = 4096;
+    // Records kept in memory while disk is not keeping up. ~80 MB, newer records are dropped above the limit.
+    static constexpr std::size_t kMaxBufferedRecords = 1024 * 1024;
+    static constexpr int kDefaultFlushIntervalMs = 200;
+
+    TraceWriter();
+    ~TraceWriter();
+
+    /**
+    *   @brief  Creates trace file and starts writer thread. Trace currently open is closed first.
+    *   @param  path file path, existing file is overwritten
+    *   @param  flushIntervalMs maximum time records stay in memory
+    *   @return false if file could not be created
+    */
+    bool open(const QString& path, int flushIntervalMs = kDefaultFlushIntervalMs);
+
+    /**
+    *   @brief  Writes buffered records, index and trailer and closes file
+    */
+    void close();
+
+    /**
+    *   @return true if trace is open
+    */
+    bool isOpen() const;
+
+    /**
+    *   @brief  Queues records for writing. Thread safe, never blocks on I/O.
+    *   @param  records records to be written
+    */
+    void append(const CanFrameBatch& records);
+
+    /**
+    *   @return number of records written to file
+    */
+    quint64 recordsWritten() const;
+
+    /**
+    *   @return number of records dropped because writer was not keeping up
+    */
+    quint64 recordsDropped() const;
+
+    /**
+    *   @brief  Writes complete trace synchronously from calling thread. Meant for snapshots, e.g. view contents.
+    *   @param  path file path, existing file is overwritten
+    *   @param  records records to be written
+    *   @return false on I/O error
+    */
+    static bool writeTrace(const QString& path, const CanFrameBatch& records);
+
+private:
+    class Worker : public QThread {
+    public:
+        explicit Worker(TraceWriter& writer)
+            : _writer(writer)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            _writer.run();
+        }
+
+    private:
+        TraceWriter& _writer;
+    };
+
+    bool createFile(const QString& path);
+    void run();
+    void writeRecords(const CanFrameRecord* records, std::size_t count);
+    void writeDataBlock(const CanFrameRecord* records, int count);
+    void writeIndexBlock();
+    void writeTrailer();
+    bool write(const void* data, qint64 size);
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::vector<CanFrameRecord> _front;
+    bool _quit{ false };
+
+    // Accessed by writer thread only while it is running
+    QFile _file;
+    std::vector<CanFrameRecord> _back;
+    std::vector<TraceFile::IndexEntry> _pendingIndex;
+    quint64 _offset{ 0 };
+    quint64 _lastIndexOffset{ 0 };
+    quint64 _endTimestamp{ 0 };
+    std::chrono::milliseconds _flushInterval{ kDefaultFlushIntervalMs };
+    bool _ioError{ false };
+
+    std::atomic<quint64> _written{ 0 };
+    std::atomic<quint64> _dropped{ 0 };
+    Worker _worker;
+};
+
+#endif // TRACEWRITER_H
@@ -0,0 +1,122 @@
+#include "tracereplay.h"
+#include "tracereplay_p.h"
+
+constexpr int TraceReplay::kTickIntervalMs;
+constexpr int TraceReplay::kMaxBatchRecords;
+
+TraceReplay::TraceReplay()
+    : d_ptr(new TraceReplayPrivate(this))
+{
+}
+
+TraceReplay::~TraceReplay()
+{
+}
+
+void TraceReplay::startSimulation()
+{
+    Q_D(TraceReplay);
+
+    if (d->_file.isEmpty() || !d->openTrace()) {
+        return;
+    }
+
+    d->pause();
+    {
+        std::lock_guard<std::mutex> lock(d->_jitterMutex);
+        d->_jitter = Instrumentation::HistogramSnapshot();
+    }
+
+    if (d->_position >= d->_reader.recordCount()) {
+        d->_position = 0;
+    }
+
+    d->rebase(d->_position);
+    d->play();
+}
+
+void TraceReplay::stopSimulation()
+{
+    Q_D(TraceReplay);
+
+    const bool playing = d->isPlaying();
+
+    d->pause();
+    if (playing) {
+        d->reportJitter();
+    }
+}
+
+bool TraceReplay::seek(quint64 offsetUs)
+{
+    Q_D(TraceReplay);
+
+    if (!d->openTrace()) {
+        return false;
+    }
+
+    // Replay thread keeps its own time base, it is restarted from new position
+    const bool precise = d->_worker.isRunning();
+    if (precise) {
+        d->pause();
+    }
+
+    d->rebase(d->_reader.findTimestamp(d->_reader.firstTimestamp() + offsetUs));
+
+    if (precise) {
+        d->play();
+    }
+
+    return true;
+}
+
+quint64 TraceReplay::recordCount() const
+{
+    return d_ptr->_reader.recordCount();
+}
+
+quint64 TraceReplay::position() const
+{
+    return d_ptr->_position;
+}
+
+bool TraceReplay::isPlaying() const
+{
+    return d_ptr->isPlaying();
+}
+
+Instrumentation::HistogramSnapshot TraceReplay::releaseJitter() const
+{
+    return d_ptr->releaseJitter();
+}
+
+void TraceReplay::setConfig(QJsonObject& json)
+{
+    Q_D(TraceReplay);
+
+    if (json.contains("file")) {
+        d->_file = json["file"].toString();
+    }
+
+    if (json.contains("speed")) {
+        const double speed = json["speed"].toDouble(1.0);
+        d->_speed = (speed > 0.0) ? speed : 1.0;
+    }
+
+    if (json.contains("loop")) {
+        d->_loop = json["loop"].toBool();
+    }
+
+    if (json.contains("timing")) {
+        d->_timing = ReleaseTiming::fromJson(json["timing"].toObject());
+    }
+}
+
+QJsonObject TraceReplay::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
@@ -0,0 +1,93 @@
+#ifndef TRACEREPLAY_H
+#define TRACEREPLAY_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <instrumentation.h>
+
+class TraceReplayPrivate;
+
+/**
+*   @brief  Component replaying binary trace (see tracefile.h) at original timing or scaled speed
+*
+*   Trace is memory-mapped, only records around current position are touched. Frames due at each tick are emitted
+*   as one batch, which CanDevice writes with single sendFrames call.
+*
+*   With precise timing (see ReleaseTiming) records are released by replay thread at their own time instead of
+*   at ticks, sendFrames and finished are then emitted from that thread. Lateness of releases against original
+*   timing is collected in releaseJitter and logged when replay stops.
+*/
+class TraceReplay : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(TraceReplay)
+
+public:
+    static constexpr int kTickIntervalMs = 2;
+    static constexpr int kMaxBatchRecords = 4096;
+
+    TraceReplay();
+    ~TraceReplay();
+
+    /**
+    *   @brief  Supported keys: file (trace path), speed (time scale, 1.0 is original timing), loop (restart at
+    *           end of trace), timing (precise release, see ReleaseTiming)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @brief  Moves replay position. Takes effect immediately if replay is running.
+    *   @param  offsetUs time from the first record of trace, in microseconds
+    *   @return false if no trace is open
+    */
+    bool seek(quint64 offsetUs);
+
+    /**
+    *   @return number of records in trace, 0 if trace could not be opened
+    */
+    quint64 recordCount() const;
+
+    /**
+    *   @return index of next record to be replayed
+    */
+    quint64 position() const;
+
+    /**
+    *   @return true if replay is in progress
+    */
+    bool isPlaying() const;
+
+    /**
+    *   @return lateness of released records against their time in trace since simulation start, in microseconds.
+    *           Not collected with virtual time.
+    */
+    Instrumentation::HistogramSnapshot releaseJitter() const;
+
+signals:
+    /**
+    *   @brief  Emitted with all records that became due since last tick (or since last release with precise timing)
+    *   @param  frames frames to be sent, timestamps cleared so that they are stamped on transmission
+    */
+    void sendFrames(const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Emitted when end of trace is reached (not emitted when looping)
+    */
+    void finished();
+
+public slots:
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<TraceReplayPrivate> d_ptr;
+};
+
+#endif // TRACEREPLAY_H
@@ -0,0 +1,348 @@
+#ifndef TRACEREPLAY_P_H
+#define TRACEREPLAY_P_H
+
+#include "tracereplay.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <instrumentation.h>
+#include <log.h>
+#include <mutex>
+#include <releasetiming.h>
+#include <simclock.h>
+#include <tracereader.h>
+
+class TraceReplayPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(TraceReplay)
+
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    TraceReplayPrivate(TraceReplay* q)
+        : _worker(*this)
+        , q_ptr(q)
+    {
+        _timer.setTimerType(Qt::PreciseTimer);
+        _timer.setInterval(TraceReplay::kTickIntervalMs);
+        connect(&_timer, &QTimer::timeout, this, &TraceReplayPrivate::tick);
+        _worker.setObjectName("TraceReplay");
+    }
+
+    ~TraceReplayPrivate()
+    {
+        stopWorker();
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["file"] = _file;
+        json["speed"] = _speed;
+        json["loop"] = _loop;
+
+        // Written only when set, projects replaying on timer stay as they were
+        if (_timing.isPrecise()) {
+            json["timing"] = _timing.toJson();
+        }
+    }
+
+    /**
+    *   @brief  Opens configured trace unless it is already open
+    *   @return true if trace is available
+    */
+    bool openTrace()
+    {
+        if (_reader.isOpen() && (_openedFile == _file)) {
+            return true;
+        }
+
+        // Records of open trace may be still read by replay thread
+        pause();
+        _openedFile = _file;
+        _position = 0;
+
+        if (!_reader.open(_file)) {
+            cds_error("Failed to open trace '{}'", _file.toStdString());
+            return false;
+        }
+
+        if (!_reader.isComplete()) {
+            cds_warn("Trace '{}' was not closed properly, recovered {} records", _file.toStdString(),
+                _reader.recordCount());
+        }
+
+        return true;
+    }
+
+    /**
+    *   @brief  Anchors replay clock at given record
+    */
+    void rebase(quint64 position)
+    {
+        _position = position;
+        _traceBase = (_position < _reader.recordCount()) ? _reader.record(_position)->timestamp : 0;
+        _clock.restart();
+        _clockBaseUs = SimClock::nowUs();
+    }
+
+    /**
+    *   @brief  Starts replay, with virtual time each tick is scheduled at time of the next record. With precise
+    *           timing records are released by replay thread one by one at their own time.
+    */
+    void play()
+    {
+        pause();
+        if (SimClock::isVirtual()) {
+            scheduleTick(SimClock::nowUs());
+        } else if (_timing.isPrecise()) {
+            _stopWorker = false;
+            _worker.start(QThread::TimeCriticalPriority);
+        } else {
+            _timer.start();
+        }
+    }
+
+    void pause()
+    {
+        _timer.stop();
+        SimClock::instance().cancel(_tickEvent);
+        _tickEvent = SimClock::kInvalidEvent;
+        stopWorker();
+    }
+
+    bool isPlaying() const
+    {
+        return _timer.isActive() || (_tickEvent != SimClock::kInvalidEvent) || _worker.isRunning();
+    }
+
+    void stopWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_workerMutex);
+            _stopWorker = true;
+        }
+
+        _workerWake.notify_all();
+        _worker.wait();
+    }
+
+    void recordRelease(quint64 lateUs)
+    {
+        std::lock_guard<std::mutex> lock(_jitterMutex);
+
+        _jitter.add(lateUs);
+        Instrumentation::record(Instrumentation::Histogram::ReleaseLatenessUs, lateUs);
+    }
+
+    Instrumentation::HistogramSnapshot releaseJitter() const
+    {
+        std::lock_guard<std::mutex> lock(_jitterMutex);
+
+        return _jitter;
+    }
+
+    void reportJitter() const
+    {
+        const auto jitter = releaseJitter();
+
+        if (jitter.count > 0) {
+            cds_info("Replay of '{}' released {} frames, lateness mean {:.1f} us, p99 {} us, max {} us",
+                _file.toStdString(), jitter.count, jitter.mean(), jitter.percentile(0.99), jitter.max);
+        }
+    }
+
+    quint64 elapsedUs() const
+    {
+        if (SimClock::isVirtual()) {
+            return SimClock::nowUs() - _clockBaseUs;
+        }
+
+        return static_cast<quint64>(_clock.nsecsElapsed() / 1000);
+    }
+
+    void scheduleTick(quint64 dueUs)
+    {
+        _tickEvent = SimClock::instance().schedule(this, dueUs, [this] {
+            _tickEvent = SimClock::kInvalidEvent;
+            tick();
+        });
+    }
+
+    /**
+    *   @brief  Schedules tick for virtual time of the next record, batch that was cut short continues at once
+    */
+    void scheduleNextRecord()
+    {
+        if (_position >= _reader.recordCount()) {
+            return;
+        }
+
+        const quint64 traceOffset = _reader.record(_position)->timestamp - _traceBase;
+        scheduleTick(_clockBaseUs + static_cast<quint64>(traceOffset / _speed));
+    }
+
+    void tick()
+    {
+        Q_Q(TraceReplay);
+        const quint64 count = _reader.recordCount();
+        const quint64 elapsed = elapsedUs();
+        const quint64 now = _traceBase + static_cast<quint64>(elapsed * _speed);
+        const bool measure = !SimClock::isVirtual();
+        CanFrameBatch batch;
+
+        // Only records in replay window are touched
+        while ((_position < count) && (batch.size() < TraceReplay::kMaxBatchRecords)) {
+            const CanFrameRecord* rec = _reader.record(_position);
+
+            if (rec->timestamp > now) {
+                break;
+            }
+
+            ++_position;
+            if (rec->hasFlag(CanFrameRecord::TxFailed) || rec->hasFlag(CanFrameRecord::Error)) {
+                continue;
+            }
+
+            if (measure) {
+                const auto plannedUs = static_cast<quint64>((rec->timestamp - _traceBase) / _speed);
+                recordRelease((elapsed > plannedUs) ? elapsed - plannedUs : 0);
+            }
+
+            batch.append(*rec);
+            batch.last().timestamp = 0;
+        }
+
+        if (!batch.isEmpty()) {
+            emit q->sendFrames(batch);
+        }
+
+        if (_position >= count) {
+            if (_loop && (count > 0)) {
+                rebase(0);
+            } else {
+                pause();
+                reportJitter();
+                emit q->finished();
+                return;
+            }
+        }
+
+        if (SimClock::isVirtual()) {
+            scheduleNextRecord();
+        }
+    }
+
+    /**
+    *   @brief  Precise replay run by replay thread. Records are read from mapped trace like in tick(), but thread
+    *           waits for release time of each record, see ReleaseTiming.
+    */
+    void runPrecise()
+    {
+        Q_Q(TraceReplay);
+        const quint64 count = _reader.recordCount();
+        quint64 traceBase = _traceBase;
+        Clock::time_point start = Clock::now();
+
+        _timing.applyToCurrentThread();
+
+        auto releaseTime = [this, &traceBase, &start](const CanFrameRecord* rec) {
+            return start
+                + std::chrono::microseconds(static_cast<qint64>((rec->timestamp - traceBase) / _speed));
+        };
+
+        while (true) {
+            if (_position >= count) {
+                if (!_loop || (count == 0)) {
+                    reportJitter();
+                    emit q->finished();
+                    return;
+                }
+
+                _position = 0;
+                traceBase = _reader.record(0)->timestamp;
+                start = Clock::now();
+            }
+
+            // Coarse part of wait can be interrupted by pause
+            const Clock::time_point deadline = releaseTime(_reader.record(_position));
+            {
+                std::unique_lock<std::mutex> lock(_workerMutex);
+                if (_workerWake.wait_until(lock, _timing.wakeUp(deadline), [this] { return _stopWorker; })) {
+                    return;
+                }
+            }
+            ReleaseTiming::spinUntil<Clock>(deadline);
+
+            const Clock::time_point now = Clock::now();
+            CanFrameBatch batch;
+
+            while ((_position < count) && (batch.size() < TraceReplay::kMaxBatchRecords)) {
+                const CanFrameRecord* rec = _reader.record(_position);
+                const Clock::time_point release = releaseTime(rec);
+
+                if (release > now) {
+                    break;
+                }
+
+                ++_position;
+                if (rec->hasFlag(CanFrameRecord::TxFailed) || rec->hasFlag(CanFrameRecord::Error)) {
+                    continue;
+                }
+
+                recordRelease(static_cast<quint64>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - release).count()));
+                batch.append(*rec);
+                batch.last().timestamp = 0;
+            }
+
+            if (!batch.isEmpty()) {
+                emit q->sendFrames(batch);
+            }
+        }
+    }
+
+    class Worker : public QThread {
+    public:
+        explicit Worker(TraceReplayPrivate& replay)
+            : _replay(replay)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            _replay.runPrecise();
+        }
+
+    private:
+        TraceReplayPrivate& _replay;
+    };
+
+    TraceReader _reader;
+    QTimer _timer;
+    QElapsedTimer _clock;
+    QString _file;
+    QString _openedFile;
+    double _speed{ 1.0 };
+    bool _loop{ false };
+    ReleaseTiming _timing;
+    std::atomic<quint64> _position{ 0 }; // advanced by replay thread in precise replay
+    quint64 _traceBase{ 0 }; // record timestamp corresponding to _clock start
+    quint64 _clockBaseUs{ 0 }; // SimClock time corresponding to _clock start
+    SimClock::EventId _tickEvent{ SimClock::kInvalidEvent }; // pending tick in virtual time
+    Worker _worker;
+    std::mutex _workerMutex;
+    std::condition_variable _workerWake;
+    bool _stopWorker{ false };
+    mutable std::mutex _jitterMutex;
+    Instrumentation::HistogramSnapshot _jitter; // lateness of releases since simulation start
+
+private:
+    TraceReplay* q_ptr;
+};
+
+#endif // TRACEREPLAY_P_H
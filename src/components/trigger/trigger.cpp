@@ -0,0 +1,82 @@
+#include "trigger.h"
+#include "trigger_p.h"
+
+constexpr int Trigger::kDefaultPreTriggerFrames;
+constexpr double Trigger::kDefaultPostTriggerTime;
+constexpr int TriggerPrivate::kMaxPreTriggerFrames;
+
+Trigger::Trigger()
+    : d_ptr(new TriggerPrivate(this))
+{
+}
+
+Trigger::~Trigger()
+{
+}
+
+void Trigger::setConfig(QJsonObject& json)
+{
+    Q_D(Trigger);
+
+    d->loadSettings(json);
+}
+
+QJsonObject Trigger::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
+
+Trigger::State Trigger::state() const
+{
+    return d_ptr->_state;
+}
+
+int Trigger::triggerCount() const
+{
+    return d_ptr->_triggerCount;
+}
+
+void Trigger::frameBatchReceived(const CanFrameBatch& frames)
+{
+    Q_D(Trigger);
+
+    d->process(frames);
+}
+
+void Trigger::frameBatchSent(bool status, const CanFrameBatch& frames)
+{
+    Q_D(Trigger);
+
+    if (status) {
+        d->process(frames);
+    }
+}
+
+void Trigger::signalsReceived(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog)
+{
+    Q_D(Trigger);
+
+    d->processSignals(samples, catalog);
+}
+
+void Trigger::startSimulation()
+{
+    Q_D(Trigger);
+
+    d->_triggerCount = 0;
+    d->arm();
+}
+
+void Trigger::stopSimulation()
+{
+    Q_D(Trigger);
+
+    d->stopWindowTimer();
+    d->_state = State::Idle;
+    d->_ring.clear();
+    d->_count = 0;
+}
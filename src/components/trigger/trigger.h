@@ -0,0 +1,74 @@
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <canframerecord.h>
+#include <componentinterface.h>
+#include <signalsample.h>
+
+class TriggerPrivate;
+
+/**
+*   @brief  Component capturing frames around rare event, meant to be connected to TraceLogger
+*
+*   While armed, frames are kept in fixed-size pre-trigger ring of compact records and every frame is checked
+*   against compiled conditions (see TriggerProgram). When a condition fires, contents of the ring are emitted
+*   followed by all frames of the post-trigger window. Window closes at its end also if no frame follows. Conditions
+*   on decoded signals are checked against samples passed from SignalDecoder.
+*/
+class Trigger : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(Trigger)
+
+public:
+    static constexpr int kDefaultPreTriggerFrames = 10000;
+    static constexpr double kDefaultPostTriggerTime = 1.0;
+
+    enum class State { Idle, Armed, Capturing, Done };
+
+    Trigger();
+    ~Trigger();
+
+    /**
+    *   @brief  Supported keys: conditions (see TriggerProgram::compile), preTriggerFrames (ring size),
+    *           postTriggerTime (seconds), rearm (arm again after post-trigger window)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    State state() const;
+
+    /**
+    *   @return number of times trigger fired since simulation start
+    */
+    int triggerCount() const;
+
+signals:
+    /**
+    *   @brief  Frames of capture, pre-trigger frames are emitted at once when trigger fires
+    */
+    void framesCaptured(const CanFrameBatch& frames);
+
+    /**
+    *   @param  timestamp timestamp of frame or sample satisfying condition
+    */
+    void triggered(quint64 timestamp);
+
+public slots:
+    void frameBatchReceived(const CanFrameBatch& frames);
+    void frameBatchSent(bool status, const CanFrameBatch& frames);
+    void signalsReceived(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<TriggerPrivate> d_ptr;
+};
+
+#endif // TRIGGER_H
@@ -0,0 +1,258 @@
+#ifndef TRIGGER_P_H
+#define TRIGGER_P_H
+
+#include "trigger.h"
+#include "triggerprogram.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <log.h>
+#include <simclock.h>
+#include <vector>
+
+class TriggerPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(Trigger)
+
+public:
+    // Pre-trigger ring is preallocated, so its size is limited
+    static constexpr int kMaxPreTriggerFrames = 10000000;
+
+    TriggerPrivate(Trigger* q)
+        : q_ptr(q)
+    {
+        _postTimer.setSingleShot(true);
+        _postTimer.setTimerType(Qt::PreciseTimer);
+        connect(&_postTimer, &QTimer::timeout, this, &TriggerPrivate::closeWindow);
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["conditions"] = _program.conditions();
+        json["preTriggerFrames"] = _preTriggerFrames;
+        json["postTriggerTime"] = _postTriggerUs / 1000000.0;
+        json["rearm"] = _rearm;
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        if (json.contains("conditions")) {
+            const QJsonArray conditions = json["conditions"].toArray();
+
+            const int compiled = _program.compile(conditions);
+
+            if (compiled < conditions.size()) {
+                cds_warn("{} of {} trigger conditions could not be compiled", conditions.size() - compiled,
+                    conditions.size());
+            }
+            if (_catalog) {
+                _program.bindSignals(*_catalog);
+            }
+        }
+
+        if (json.contains("preTriggerFrames")) {
+            const int frames = json["preTriggerFrames"].toInt(-1);
+
+            if ((frames >= 0) && (frames <= kMaxPreTriggerFrames)) {
+                _preTriggerFrames = frames;
+            } else {
+                cds_warn("Invalid preTriggerFrames '{}', keeping {}", frames, _preTriggerFrames);
+            }
+        }
+
+        if (json.contains("postTriggerTime")) {
+            const double seconds = json["postTriggerTime"].toDouble(-1.0);
+
+            if (seconds >= 0.0) {
+                _postTriggerUs = static_cast<quint64>(seconds * 1000000.0);
+            } else {
+                cds_warn("Invalid postTriggerTime '{}', keeping {} s", seconds, _postTriggerUs / 1000000.0);
+            }
+        }
+
+        _rearm = json["rearm"].toBool(_rearm);
+    }
+
+    void arm()
+    {
+        stopWindowTimer();
+        _ring.assign(static_cast<std::size_t>(_preTriggerFrames), CanFrameRecord{});
+        _head = 0;
+        _count = 0;
+        _state = Trigger::State::Armed;
+
+        if (!_program.hasFrameConditions() && !_program.hasSignalConditions()) {
+            cds_warn("Trigger has no conditions, nothing will be captured");
+        }
+    }
+
+    void process(const CanFrameBatch& frames)
+    {
+        if ((_state != Trigger::State::Armed) && (_state != Trigger::State::Capturing)) {
+            return;
+        }
+
+        CanFrameBatch captured;
+        quint64 now = 0;
+
+        for (const auto& rec : frames) {
+            quint64 timestamp = rec.timestamp;
+
+            if (timestamp == 0) {
+                // Not stamped by backend, time of arrival is the best we have
+                timestamp = now ? now : (now = canTimestampNow());
+            }
+
+            if (_state == Trigger::State::Capturing) {
+                if (timestamp <= _postEnd) {
+                    captured.append(rec);
+                    continue;
+                }
+
+                completeCapture();
+            }
+
+            if (_state == Trigger::State::Armed) {
+                push(rec);
+
+                if (_program.matches(rec)) {
+                    fire(timestamp, captured);
+
+                    if (_ring.empty()) {
+                        // Triggering frame is part of capture even without pre-trigger ring
+                        captured.append(rec);
+                    }
+                }
+            }
+        }
+
+        if (!captured.isEmpty()) {
+            emit q_func()->framesCaptured(captured);
+        }
+    }
+
+    void processSignals(const SignalSampleBatch& samples, const SignalCatalogPtr& catalog)
+    {
+        if (catalog && (catalog != _catalog)) {
+            _catalog = catalog;
+            _program.bindSignals(*_catalog);
+        }
+
+        if ((_state != Trigger::State::Armed) || !_program.hasSignalConditions()) {
+            return;
+        }
+
+        for (const auto& sample : samples) {
+            if (_program.matches(sample)) {
+                CanFrameBatch captured;
+
+                fire(sample.timestamp, captured);
+                emit q_func()->framesCaptured(captured);
+                break;
+            }
+        }
+    }
+
+    /**
+    *   @brief  Moves contents of pre-trigger ring to capture and opens post-trigger window
+    */
+    void fire(quint64 timestamp, CanFrameBatch& captured)
+    {
+        const std::size_t size = _ring.size();
+        const std::size_t preTrigger = _count;
+
+        captured.reserve(captured.size() + static_cast<int>(_count));
+        for (std::size_t i = 0; i < _count; ++i) {
+            captured.append(_ring[(_head + size - _count + i) % size]);
+        }
+        _count = 0;
+
+        _state = Trigger::State::Capturing;
+        _postEnd = timestamp + _postTriggerUs;
+        ++_triggerCount;
+        startWindowTimer(timestamp);
+
+        cds_info("Trigger fired, {} pre-trigger frames captured", preTrigger);
+        emit q_func()->triggered(timestamp);
+    }
+
+    /**
+    *   @brief  Closes post-trigger window at its end when no frame follows to close it
+    */
+    void startWindowTimer(quint64 timestamp)
+    {
+        const quint64 now = canTimestampNow();
+        const quint64 age = (now > timestamp) ? now - timestamp : 0;
+        // Timestamps older than whole window come from hardware clock of other time base, wait for whole window
+        const quint64 remainingUs = (age < _postTriggerUs) ? _postTriggerUs - age : _postTriggerUs;
+
+        if (SimClock::isVirtual()) {
+            _postEvent = SimClock::instance().schedule(this, now + remainingUs, [this] {
+                _postEvent = SimClock::kInvalidEvent;
+                closeWindow();
+            });
+        } else {
+            _postTimer.start(static_cast<int>((remainingUs + 999) / 1000));
+        }
+    }
+
+    void stopWindowTimer()
+    {
+        _postTimer.stop();
+        SimClock::instance().cancel(_postEvent);
+        _postEvent = SimClock::kInvalidEvent;
+    }
+
+    void closeWindow()
+    {
+        if (_state == Trigger::State::Capturing) {
+            completeCapture();
+        }
+    }
+
+    void completeCapture()
+    {
+        stopWindowTimer();
+
+        if (_rearm) {
+            _state = Trigger::State::Armed;
+        } else {
+            _state = Trigger::State::Done;
+            cds_info("Trigger capture complete");
+        }
+    }
+
+    void push(const CanFrameRecord& rec)
+    {
+        const std::size_t size = _ring.size();
+
+        if (size == 0) {
+            return;
+        }
+
+        _ring[_head] = rec;
+        _head = (_head + 1 == size) ? 0 : _head + 1;
+        _count = std::min(_count + 1, size);
+    }
+
+    TriggerProgram _program;
+    SignalCatalogPtr _catalog;
+    int _preTriggerFrames{ Trigger::kDefaultPreTriggerFrames };
+    quint64 _postTriggerUs{ static_cast<quint64>(Trigger::kDefaultPostTriggerTime * 1000000.0) };
+    bool _rearm{ false };
+
+    Trigger::State _state{ Trigger::State::Idle };
+    std::vector<CanFrameRecord> _ring;
+    std::size_t _head{ 0 }; // position of the next record
+    std::size_t _count{ 0 };
+    quint64 _postEnd{ 0 }; // end of post-trigger window, microseconds
+    QTimer _postTimer;
+    SimClock::EventId _postEvent{ SimClock::kInvalidEvent };
+    int _triggerCount{ 0 };
+
+private:
+    Trigger* q_ptr;
+};
+
+#endif // TRIGGER_P_H
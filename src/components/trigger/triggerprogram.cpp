@@ -0,0 +1,212 @@
+#include "triggerprogram.h"
+#include <QtCore/QJsonObject>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <log.h>
+
+namespace {
+constexpr quint64 kExtendedKey = 0x80000000ULL;
+constexpr std::size_t kMaxInstructions = std::numeric_limits<quint16>::max();
+
+quint64 frameKey(const CanFrameRecord& rec)
+{
+    // Same layout as CAN_EFF_FLAG, so id and format are compared in one step
+    return rec.id | ((rec.flags & CanFrameRecord::ExtendedId) ? kExtendedKey : 0);
+}
+} // namespace
+
+int TriggerProgram::compile(const QJsonArray& conditions)
+{
+    _conditions = conditions;
+    _program.clear();
+    _signals.clear();
+    _bySignal.clear();
+
+    int compiled = 0;
+
+    for (const auto& item : conditions) {
+        const QJsonObject obj = item.toObject();
+        const bool ok = obj.contains("signal") ? compileSignal(obj) : compileFrame(obj);
+
+        if (ok) {
+            ++compiled;
+        }
+    }
+
+    return compiled;
+}
+
+QJsonArray TriggerProgram::conditions() const
+{
+    return _conditions;
+}
+
+bool TriggerProgram::matches(const CanFrameRecord& rec) const
+{
+    const std::size_t size = _program.size();
+    const quint64 key = frameKey(rec);
+    std::size_t pc = 0;
+
+    while (pc < size) {
+        const Instruction& ins = _program[pc];
+        bool pass = false;
+
+        switch (ins.op) {
+        case Instruction::MatchId:
+            pass = (key & ins.mask) == ins.value;
+            break;
+
+        case Instruction::MinLength:
+            pass = rec.length >= ins.value;
+            break;
+
+        case Instruction::MatchWord: {
+            quint64 word;
+
+            std::memcpy(&word, rec.payload + 8 * ins.word, sizeof(word));
+            pass = (word & ins.mask) == ins.value;
+            break;
+        }
+
+        case Instruction::Accept:
+            return true;
+        }
+
+        pc = pass ? pc + 1 : ins.fail;
+    }
+
+    return false;
+}
+
+void TriggerProgram::bindSignals(const SignalCatalog& catalog)
+{
+    _bySignal.assign(catalog.size(), {});
+
+    for (std::size_t i = 0; i < _signals.size(); ++i) {
+        bool found = false;
+
+        for (std::size_t index = 0; index < catalog.size(); ++index) {
+            if (catalog[index].name == _signals[i].name) {
+                _bySignal[index].push_back(static_cast<int>(i));
+                found = true;
+            }
+        }
+
+        if (!found) {
+            cds_warn("Trigger signal '{}' is not decoded", _signals[i].name.toStdString());
+        }
+    }
+}
+
+bool TriggerProgram::matches(const SignalSample& sample) const
+{
+    if (sample.signal >= _bySignal.size()) {
+        return false;
+    }
+
+    for (int i : _bySignal[sample.signal]) {
+        const SignalCondition& condition = _signals[i];
+
+        if ((sample.value > condition.above) && (sample.value < condition.below)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TriggerProgram::hasFrameConditions() const
+{
+    return !_program.empty();
+}
+
+bool TriggerProgram::hasSignalConditions() const
+{
+    return !_signals.empty();
+}
+
+bool TriggerProgram::compileFrame(const QJsonObject& obj)
+{
+    if (!obj.contains("id")) {
+        cds_warn("Trigger condition without id or signal ignored");
+        return false;
+    }
+
+    const quint32 id = static_cast<quint32>(obj["id"].toDouble());
+    const quint32 mask = static_cast<quint32>(obj["mask"].toDouble(0x1fffffff)) & 0x1fffffff;
+    const bool extended = obj["extended"].toBool(id > 0x7ff);
+    const QByteArray data = QByteArray::fromHex(obj["data"].toString().toLatin1());
+    QByteArray dataMask = QByteArray::fromHex(obj["dataMask"].toString().toLatin1());
+
+    if ((data.size() > CanFrameRecord::kMaxPayload) || (dataMask.size() > data.size())) {
+        cds_warn("Invalid payload pattern of trigger condition for id 0x{:x} ignored", id);
+        return false;
+    }
+
+    // Bytes without mask are compared as a whole
+    dataMask.append(QByteArray(data.size() - dataMask.size(), '\xff'));
+
+    std::vector<Instruction> condition;
+    const quint64 keyMask = mask | kExtendedKey;
+
+    condition.push_back(
+        { Instruction::MatchId, 0, 0, keyMask, (id & keyMask) | (extended ? kExtendedKey : 0) });
+
+    if (!data.isEmpty()) {
+        // Bytes beyond length of frame are not defined
+        condition.push_back({ Instruction::MinLength, 0, 0, 0, static_cast<quint64>(data.size()) });
+    }
+
+    for (int w = 0; 8 * w < data.size(); ++w) {
+        quint8 maskBytes[8] = {};
+        quint8 valueBytes[8] = {};
+        const int bytes = std::min(8, data.size() - 8 * w);
+
+        for (int i = 0; i < bytes; ++i) {
+            maskBytes[i] = static_cast<quint8>(dataMask[8 * w + i]);
+            valueBytes[i] = static_cast<quint8>(data[8 * w + i]) & maskBytes[i];
+        }
+
+        // Words are loaded from payload memory as they are, so byte order does not matter
+        quint64 wordMask;
+        quint64 wordValue;
+        std::memcpy(&wordMask, maskBytes, sizeof(wordMask));
+        std::memcpy(&wordValue, valueBytes, sizeof(wordValue));
+
+        if (wordMask != 0) {
+            condition.push_back({ Instruction::MatchWord, static_cast<quint8>(w), 0, wordMask, wordValue });
+        }
+    }
+
+    condition.push_back({ Instruction::Accept, 0, 0, 0, 0 });
+
+    if (_program.size() + condition.size() > kMaxInstructions) {
+        cds_warn("Too many trigger conditions, condition for id 0x{:x} ignored", id);
+        return false;
+    }
+
+    // Failing test continues with the next condition
+    const auto next = static_cast<quint16>(_program.size() + condition.size());
+    for (auto& ins : condition) {
+        ins.fail = next;
+    }
+    _program.insert(_program.end(), condition.begin(), condition.end());
+
+    return true;
+}
+
+bool TriggerProgram::compileSignal(const QJsonObject& obj)
+{
+    const QString name = obj["signal"].toString();
+
+    if (name.isEmpty() || (!obj.contains("above") && !obj.contains("below"))) {
+        cds_warn("Trigger condition for signal '{}' needs above or below limit", name.toStdString());
+        return false;
+    }
+
+    _signals.push_back({ name, obj["above"].toDouble(-std::numeric_limits<double>::infinity()),
+        obj["below"].toDouble(std::numeric_limits<double>::infinity()) });
+
+    return true;
+}
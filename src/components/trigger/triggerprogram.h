@@ -0,0 +1,83 @@
+#ifndef TRIGGERPROGRAM_H
+#define TRIGGERPROGRAM_H
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QString>
+#include <canframerecord.h>
+#include <signalsample.h>
+#include <vector>
+
+/**
+*   @brief  Trigger conditions compiled into flat predicate program
+*
+*   Each frame condition becomes a short sequence of instructions (id under mask, minimal length, payload words
+*   under mask). Instructions of a condition are ANDed, failing test jumps to the first instruction of the next
+*   condition, so conditions are ORed. Payload is compared 8 bytes at a time, so evaluation costs a few integer
+*   operations per condition and does not allocate.
+*
+*   Signal conditions (threshold on decoded value) are kept separately, as samples arrive apart from frames.
+*/
+class TriggerProgram {
+public:
+    /**
+    *   @brief  Compiles conditions, invalid entries are reported and skipped
+    *
+    *   Frame condition: { "id": 0x123, "mask": 0x7ff, "extended": false, "data": "11..22", "dataMask": "ff00ff" }.
+    *   Omitted mask compares all id bits, omitted dataMask compares all bytes of data.
+    *   Signal condition: { "signal": "EngineSpeed", "above": 3000, "below": 5000 }, either limit may be omitted.
+    *
+    *   @param  conditions array of condition objects
+    *   @return number of conditions compiled
+    */
+    int compile(const QJsonArray& conditions);
+
+    /**
+    *   @return conditions as passed to compile()
+    */
+    QJsonArray conditions() const;
+
+    /**
+    *   @return true if frame satisfies any frame condition
+    */
+    bool matches(const CanFrameRecord& rec) const;
+
+    /**
+    *   @brief  Resolves names of signal conditions to indexes of catalog
+    */
+    void bindSignals(const SignalCatalog& catalog);
+
+    /**
+    *   @return true if sample satisfies any signal condition, signals have to be bound first
+    */
+    bool matches(const SignalSample& sample) const;
+
+    bool hasFrameConditions() const;
+    bool hasSignalConditions() const;
+
+private:
+    struct Instruction {
+        enum Op : quint8 { MatchId, MinLength, MatchWord, Accept };
+
+        Op op;
+        quint8 word; // MatchWord: index of 8 byte payload word
+        quint16 fail; // instruction taken when test fails
+        quint64 mask;
+        quint64 value;
+    };
+
+    struct SignalCondition {
+        QString name;
+        double above;
+        double below;
+    };
+
+    bool compileFrame(const QJsonObject& obj);
+    bool compileSignal(const QJsonObject& obj);
+
+    QJsonArray _conditions;
+    std::vector<Instruction> _program;
+    std::vector<SignalCondition> _signals;
+    std::vector<std::vector<int>> _bySignal; // catalog index -> signal conditions
+};
+
+#endif // TRIGGERPROGRAM_H
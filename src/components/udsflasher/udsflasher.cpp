@@ -0,0 +1,85 @@
+#include "udsflasher.h"
+#include "udsflasher_p.h"
+
+constexpr int UdsFlasher::kResponseTimeoutMs;
+constexpr int UdsFlasher::kPendingTimeoutMs;
+constexpr quint8 UdsFlasherPrivate::kRequestDownload;
+constexpr quint8 UdsFlasherPrivate::kTransferData;
+constexpr quint8 UdsFlasherPrivate::kRequestTransferExit;
+constexpr quint8 UdsFlasherPrivate::kNegativeResponse;
+constexpr quint8 UdsFlasherPrivate::kPositiveResponseOffset;
+constexpr quint8 UdsFlasherPrivate::kResponsePending;
+constexpr quint32 UdsFlasherPrivate::kMaxClassicPduLength;
+
+UdsFlasher::UdsFlasher()
+    : d_ptr(new UdsFlasherPrivate(this))
+{
+}
+
+UdsFlasher::~UdsFlasher()
+{
+}
+
+void UdsFlasher::startSimulation()
+{
+    Q_D(UdsFlasher);
+
+    // Download starts with simulation, like replay does
+    if (!d->_file.isEmpty()) {
+        d->start();
+    }
+}
+
+void UdsFlasher::stopSimulation()
+{
+    Q_D(UdsFlasher);
+
+    d->abort();
+}
+
+bool UdsFlasher::start()
+{
+    Q_D(UdsFlasher);
+
+    return d->start();
+}
+
+void UdsFlasher::abort()
+{
+    Q_D(UdsFlasher);
+
+    d->abort();
+}
+
+UdsFlasher::State UdsFlasher::state() const
+{
+    return d_ptr->_state;
+}
+
+FlashStatistics UdsFlasher::statistics() const
+{
+    return d_ptr->_stats;
+}
+
+void UdsFlasher::pduReceived(const IsoTpPdu& pdu)
+{
+    Q_D(UdsFlasher);
+
+    d->handleResponse(pdu);
+}
+
+void UdsFlasher::setConfig(QJsonObject& json)
+{
+    Q_D(UdsFlasher);
+
+    d->loadSettings(json);
+}
+
+QJsonObject UdsFlasher::getConfig() const
+{
+    QJsonObject config;
+
+    d_ptr->saveSettings(config);
+
+    return config;
+}
@@ -0,0 +1,99 @@
+#ifndef UDSFLASHER_H
+#define UDSFLASHER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <componentinterface.h>
+#include <isotppdu.h>
+
+class UdsFlasherPrivate;
+
+/**
+*   @brief  Outcome of download, throughput is counted in image bytes
+*/
+struct FlashStatistics {
+    quint64 bytes; // image bytes acknowledged by ECU
+    quint64 elapsedUs; // from RequestDownload to RequestTransferExit response
+    quint32 blocks; // TransferData requests
+    double throughput; // bytes/s
+    double busCapacity; // bytes/s of ISO-TP payload the bus carries at 100% load
+};
+
+/**
+*   @brief  Component downloading image to ECU with UDS RequestDownload / TransferData / RequestTransferExit
+*
+*   Image is memory-mapped, blocks are copied from the mapping straight into request buffer. The next
+*   TransferData request is prepared while the current one is being transferred, so positive response is answered
+*   without delay. Requests are passed to IsoTp node, which sends consecutive frames of each block in batches
+*   limited only by flow control of ECU.
+*
+*   Responses are accepted from ISO-TP channel requests are sent with (same txId).
+*/
+class UdsFlasher : public QObject, public ComponentInterface {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(UdsFlasher)
+
+public:
+    // P2 and P2* client timeouts
+    static constexpr int kResponseTimeoutMs = 1000;
+    static constexpr int kPendingTimeoutMs = 5000;
+
+    enum class State { Idle, RequestDownload, TransferData, TransferExit, Done, Failed };
+
+    UdsFlasher();
+    ~UdsFlasher();
+
+    /**
+    *   @brief  Supported keys: file (image path), address (memory address), txId (ISO-TP channel), rxId,
+    *           addressLength and sizeLength (bytes of addressAndLengthFormatIdentifier), dataFormat,
+    *           maxBlockLength (0 accepts length announced by ECU), canFd, bitrate, dataBitrate (for capacity)
+    *   @see ComponentInterface
+    */
+    void setConfig(QJsonObject& json) override;
+
+    /**
+    *   @see ComponentInterface
+    */
+    QJsonObject getConfig() const override;
+
+    /**
+    *   @brief  Starts download of configured image
+    *   @return false if download is already running or image could not be mapped
+    */
+    bool start();
+
+    /**
+    *   @brief  Stops download in progress, ECU is left in download mode until its session times out
+    */
+    void abort();
+
+    State state() const;
+
+    /**
+    *   @return statistics of the last download, updated after every block
+    */
+    FlashStatistics statistics() const;
+
+signals:
+    /**
+    *   @brief  Request to be sent. Data is valid only until handler returns, see IsoTpPdu.
+    */
+    void sendPdu(const IsoTpPdu& pdu);
+
+    /**
+    *   @brief  Emitted after every acknowledged block
+    */
+    void progress(quint64 bytes, quint64 total);
+
+    void finished(bool success);
+
+public slots:
+    void pduReceived(const IsoTpPdu& pdu);
+    void stopSimulation(void) override;
+    void startSimulation(void) override;
+
+private:
+    QScopedPointer<UdsFlasherPrivate> d_ptr;
+};
+
+#endif // UDSFLASHER_H
@@ -0,0 +1,414 @@
+#ifndef UDSFLASHER_P_H
+#define UDSFLASHER_P_H
+
+#include "udsflasher.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <canbustiming.h>
+#include <cstring>
+#include <log.h>
+#include <vector>
+
+class UdsFlasherPrivate : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(UdsFlasher)
+
+public:
+    // UDS service identifiers
+    static constexpr quint8 kRequestDownload = 0x34;
+    static constexpr quint8 kTransferData = 0x36;
+    static constexpr quint8 kRequestTransferExit = 0x37;
+    static constexpr quint8 kNegativeResponse = 0x7f;
+    static constexpr quint8 kPositiveResponseOffset = 0x40;
+    static constexpr quint8 kResponsePending = 0x78;
+    // Longest PDU of classic ISO-TP, FD long form allows more
+    static constexpr quint32 kMaxClassicPduLength = 4095;
+
+    UdsFlasherPrivate(UdsFlasher* q)
+        : q_ptr(q)
+    {
+        _responseTimer.setSingleShot(true);
+        connect(&_responseTimer, &QTimer::timeout, this, [this] {
+            cds_error("No response of ECU to service 0x{:x}", static_cast<int>(_pendingService));
+            finish(false);
+        });
+    }
+
+    void saveSettings(QJsonObject& json) const
+    {
+        json["file"] = _file;
+        json["address"] = static_cast<double>(_address);
+        json["txId"] = static_cast<double>(_txId);
+        json["rxId"] = static_cast<double>(_rxId);
+        json["addressLength"] = _addressLength;
+        json["sizeLength"] = _sizeLength;
+        json["dataFormat"] = _dataFormat;
+        json["maxBlockLength"] = static_cast<double>(_maxBlockLength);
+        json["canFd"] = _canFd;
+        json["bitrate"] = static_cast<double>(_bitrate);
+        json["dataBitrate"] = static_cast<double>(_dataBitrate);
+    }
+
+    void loadSettings(const QJsonObject& json)
+    {
+        const auto readLength = [&json](const QString& name, int& value) {
+            if (json.contains(name)) {
+                const int v = json[name].toInt();
+
+                if ((v >= 1) && (v <= 4)) {
+                    value = v;
+                } else {
+                    cds_warn("Invalid {} '{}', keeping {}", name.toStdString(), v, value);
+                }
+            }
+        };
+
+        _file = json["file"].toString(_file);
+        _address = static_cast<quint32>(json["address"].toDouble(_address));
+        _txId = static_cast<quint32>(json["txId"].toDouble(_txId));
+        _rxId = static_cast<quint32>(json["rxId"].toDouble(_rxId));
+        readLength("addressLength", _addressLength);
+        readLength("sizeLength", _sizeLength);
+        _dataFormat = json["dataFormat"].toInt(_dataFormat) & 0xff;
+        _maxBlockLength = static_cast<quint32>(json["maxBlockLength"].toDouble(_maxBlockLength));
+        _canFd = json["canFd"].toBool(_canFd);
+        _bitrate = static_cast<quint32>(json["bitrate"].toDouble(_bitrate));
+        _dataBitrate = static_cast<quint32>(json["dataBitrate"].toDouble(_dataBitrate));
+    }
+
+    bool start()
+    {
+        if ((_state != UdsFlasher::State::Idle) && (_state != UdsFlasher::State::Done)
+            && (_state != UdsFlasher::State::Failed)) {
+            cds_warn("Download already in progress");
+            return false;
+        }
+
+        if (!mapImage()) {
+            return false;
+        }
+
+        _offset = 0;
+        _acknowledged = 0;
+        _prepared = false;
+        _counter = 1;
+        _stats = FlashStatistics{ 0, 0, 0, 0.0, busCapacity() };
+        _elapsed.start();
+
+        // RequestDownload: format identifiers, memory address and size, big endian
+        _request.clear();
+        _request.push_back(kRequestDownload);
+        _request.push_back(static_cast<quint8>(_dataFormat));
+        _request.push_back(static_cast<quint8>((_sizeLength << 4) | _addressLength));
+        appendBigEndian(_address, _addressLength);
+        appendBigEndian(static_cast<quint32>(_size), _sizeLength);
+
+        _state = UdsFlasher::State::RequestDownload;
+        send();
+
+        return true;
+    }
+
+    void handleResponse(const IsoTpPdu& pdu)
+    {
+        if ((pdu.txId != _txId) || (pdu.length == 0) || !inProgress()) {
+            return;
+        }
+
+        const quint8* data = pdu.data;
+
+        if (data[0] == kNegativeResponse) {
+            if ((pdu.length >= 3) && (data[1] == _pendingService) && (data[2] == kResponsePending)) {
+                // ECU needs more time (e.g. erasing flash)
+                _responseTimer.start(UdsFlasher::kPendingTimeoutMs);
+                return;
+            }
+
+            cds_error("ECU rejected service 0x{:x} with NRC 0x{:x}", static_cast<int>(data[1]),
+                (pdu.length >= 3) ? static_cast<int>(data[2]) : 0);
+            finish(false);
+            return;
+        }
+
+        if (data[0] != (_pendingService + kPositiveResponseOffset)) {
+            // Response to something else sent over the same channel
+            return;
+        }
+
+        switch (_state) {
+        case UdsFlasher::State::RequestDownload:
+            downloadAccepted(data, pdu.length);
+            break;
+
+        case UdsFlasher::State::TransferData:
+            blockAccepted(data, pdu.length);
+            break;
+
+        case UdsFlasher::State::TransferExit:
+            _stats.elapsedUs = static_cast<quint64>(_elapsed.nsecsElapsed() / 1000);
+            updateThroughput();
+            finish(true);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void downloadAccepted(const quint8* data, quint32 length)
+    {
+        // lengthFormatIdentifier: high nibble is length of maxNumberOfBlockLength
+        const quint32 lengthBytes = (length >= 2) ? (data[1] >> 4) : 0;
+
+        if ((lengthBytes == 0) || (lengthBytes > 4) || (length < 2 + lengthBytes)) {
+            cds_error("Malformed RequestDownload response");
+            finish(false);
+            return;
+        }
+
+        quint32 maxBlock = 0;
+        for (quint32 i = 0; i < lengthBytes; ++i) {
+            maxBlock = (maxBlock << 8) | data[2 + i];
+        }
+
+        // Block length announced by ECU includes service id and block sequence counter
+        if (_maxBlockLength > 0) {
+            maxBlock = std::min(maxBlock, _maxBlockLength);
+        }
+        if (!_canFd) {
+            maxBlock = std::min(maxBlock, kMaxClassicPduLength);
+        }
+        if (maxBlock <= 2) {
+            cds_error("ECU block length {} cannot carry data", maxBlock);
+            finish(false);
+            return;
+        }
+
+        _blockData = maxBlock - 2;
+        cds_info("Download of {} bytes accepted, {} bytes per block", _size, _blockData);
+
+        _state = UdsFlasher::State::TransferData;
+        sendBlock();
+    }
+
+    void blockAccepted(const quint8* data, quint32 length)
+    {
+        if ((length < 2) || (data[1] != _sentCounter)) {
+            cds_error("TransferData response for block {} while {} was sent",
+                (length >= 2) ? static_cast<int>(data[1]) : 0, static_cast<int>(_sentCounter));
+            finish(false);
+            return;
+        }
+
+        _acknowledged = _sentEnd;
+        ++_stats.blocks;
+        _stats.bytes = _acknowledged;
+        _stats.elapsedUs = static_cast<quint64>(_elapsed.nsecsElapsed() / 1000);
+        updateThroughput();
+        emit q_func()->progress(_acknowledged, _size);
+
+        if (_acknowledged == _size) {
+            _request.assign(1, kRequestTransferExit);
+            _state = UdsFlasher::State::TransferExit;
+            send();
+            return;
+        }
+
+        sendBlock();
+    }
+
+    /**
+    *   @brief  Sends prepared TransferData request and prepares the following one while this one is in flight
+    */
+    void sendBlock()
+    {
+        if (!_prepared) {
+            prepareBlock();
+        }
+
+        _prepared = false;
+        _sentCounter = _preparedCounter;
+        _sentEnd = _preparedEnd;
+        send();
+
+        // Response may have been handled already if it was delivered synchronously
+        if ((_state == UdsFlasher::State::TransferData) && !_prepared) {
+            prepareBlock();
+        }
+    }
+
+    /**
+    *   @brief  Copies next block from image mapping to request buffer
+    */
+    void prepareBlock()
+    {
+        if (_offset >= _size) {
+            return;
+        }
+
+        const quint32 length = static_cast<quint32>(std::min<quint64>(_blockData, _size - _offset));
+
+        _request.resize(2 + length);
+        _request[0] = kTransferData;
+        _request[1] = _counter;
+        std::memcpy(_request.data() + 2, _image + _offset, length);
+
+        _prepared = true;
+        _preparedCounter = _counter;
+        _preparedEnd = _offset + length;
+        _offset += length;
+        // Block sequence counter wraps from 0xff to 0x00
+        _counter = static_cast<quint8>(_counter + 1);
+    }
+
+    /**
+    *   @brief  Sends request built in _request. Buffers are swapped, so that PDU data stays untouched while the next
+    *           request is built, also when ISO-TP sends it later (queued or worker edge). Buffer in flight is reused
+    *           only after its response arrived.
+    */
+    void send()
+    {
+        _inFlight.swap(_request);
+        _pendingService = _inFlight.front();
+        _responseTimer.start(UdsFlasher::kResponseTimeoutMs);
+        emit q_func()->sendPdu(
+            IsoTpPdu{ _rxId, _txId, _inFlight.data(), static_cast<quint32>(_inFlight.size()), canTimestampNow() });
+    }
+
+    void finish(bool success)
+    {
+        _responseTimer.stop();
+        _state = success ? UdsFlasher::State::Done : UdsFlasher::State::Failed;
+        unmapImage();
+
+        if (success) {
+            cds_info("Flashed {} bytes in {} ms, {:.1f} kB/s, {:.1f}% of bus capacity", _stats.bytes,
+                _stats.elapsedUs / 1000, _stats.throughput / 1000.0,
+                (_stats.busCapacity > 0.0) ? 100.0 * _stats.throughput / _stats.busCapacity : 0.0);
+        }
+
+        emit q_func()->finished(success);
+    }
+
+    void abort()
+    {
+        if (inProgress()) {
+            cds_warn("Download aborted after {} of {} bytes", _acknowledged, _size);
+            finish(false);
+        }
+    }
+
+    bool inProgress() const
+    {
+        return (_state == UdsFlasher::State::RequestDownload) || (_state == UdsFlasher::State::TransferData)
+            || (_state == UdsFlasher::State::TransferExit);
+    }
+
+    /**
+    *   @brief  ISO-TP payload carried by fully loaded bus: consecutive frames of TX_DL bytes back to back
+    */
+    double busCapacity() const
+    {
+        CanFrameRecord rec{};
+
+        rec.id = _txId;
+        rec.length = _canFd ? CanFrameRecord::kMaxPayload : 8;
+        rec.flags = (_txId > 0x7ff) ? CanFrameRecord::ExtendedId : 0;
+        if (_canFd) {
+            rec.flags |= CanFrameRecord::FlexibleDataRate | CanFrameRecord::BitrateSwitch;
+        }
+
+        const quint64 ns = frameBusTimeNs(rec, _bitrate, _dataBitrate);
+
+        return ns ? (rec.length - 1) * 1e9 / ns : 0.0;
+    }
+
+    void updateThroughput()
+    {
+        _stats.throughput = _stats.elapsedUs ? _stats.bytes * 1e6 / _stats.elapsedUs : 0.0;
+    }
+
+    bool mapImage()
+    {
+        unmapImage();
+        _imageFile.setFileName(_file);
+
+        if (!_imageFile.open(QIODevice::ReadOnly)) {
+            cds_error("Could not open image '{}'", _file.toStdString());
+            return false;
+        }
+
+        _size = static_cast<quint64>(_imageFile.size());
+        const quint64 maxSize = (_sizeLength >= 4) ? 0xffffffffULL : (1ULL << (8 * _sizeLength)) - 1;
+        if ((_size == 0) || (_size > maxSize)) {
+            cds_error("Image '{}' of {} bytes cannot be downloaded", _file.toStdString(), _size);
+            _imageFile.close();
+            return false;
+        }
+
+        _image = _imageFile.map(0, _imageFile.size());
+        if (!_image) {
+            cds_error("Could not map image '{}'", _file.toStdString());
+            _imageFile.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void unmapImage()
+    {
+        if (_image) {
+            _imageFile.unmap(_image);
+            _image = nullptr;
+        }
+        _imageFile.close();
+    }
+
+    void appendBigEndian(quint32 value, int bytes)
+    {
+        for (int i = bytes - 1; i >= 0; --i) {
+            _request.push_back(static_cast<quint8>(value >> (8 * i)));
+        }
+    }
+
+    QString _file;
+    quint32 _address{ 0 };
+    quint32 _txId{ 0x7e0 };
+    quint32 _rxId{ 0x7e8 };
+    int _addressLength{ 4 };
+    int _sizeLength{ 4 };
+    int _dataFormat{ 0 };
+    quint32 _maxBlockLength{ 0 };
+    bool _canFd{ false };
+    quint32 _bitrate{ 500000 };
+    quint32 _dataBitrate{ 2000000 };
+
+    UdsFlasher::State _state{ UdsFlasher::State::Idle };
+    FlashStatistics _stats{ 0, 0, 0, 0.0, 0.0 };
+    QFile _imageFile;
+    uchar* _image{ nullptr };
+    quint64 _size{ 0 };
+    quint64 _offset{ 0 }; // image offset of the next block to be prepared
+    quint64 _acknowledged{ 0 };
+    quint32 _blockData{ 0 }; // image bytes per TransferData request
+    quint8 _counter{ 1 }; // block sequence counter of the next block to be prepared
+    bool _prepared{ false }; // _request holds TransferData of the next block
+    quint8 _preparedCounter{ 0 };
+    quint64 _preparedEnd{ 0 };
+    quint8 _sentCounter{ 0 };
+    quint64 _sentEnd{ 0 };
+    quint8 _pendingService{ 0 };
+    std::vector<quint8> _request; // request being built
+    std::vector<quint8> _inFlight; // request last sent, referenced by its PDU
+    QTimer _responseTimer;
+    QElapsedTimer _elapsed;
+
+private:
+    UdsFlasher* q_ptr;
+};
+
+#endif // UDSFLASHER_P_H
@@ -0,0 +1,273 @@
+#include "simulationengine.h"
+#include "simulationengine_p.h"
+#include <QtCore/QEventLoop>
+#include <QtCore/QTimer>
+#include <candevice.h>
+#include <canrawsender.h>
+#include <framefilter.h>
+#include <isotp.h>
+#include <merge.h>
+#include <networkbridge.h>
+#include <simclock.h>
+#include <tracereplay.h>
+#include <trigger.h>
+
+constexpr SimulationEngine::SubscriptionId SimulationEngine::kInvalidSubscription;
+
+namespace {
+// Same conversion as done for consumers of CanDevice output
+CanFrameBatch deviceFrames(const QVector<QCanBusFrame>& frames, Direction dir, bool status)
+{
+    CanFrameBatch batch = toCanFrameBatch(frames, dir);
+
+    if (!status) {
+        for (auto& rec : batch) {
+            rec.flags |= CanFrameRecord::TxFailed;
+        }
+    }
+
+    return batch;
+}
+
+template <typename Producer>
+bool connectBatches(ComponentInterface* component, void (Producer::*signal)(const CanFrameBatch&),
+    QObject* context, const SimulationEngine::FrameCallback& callback, std::vector<QMetaObject::Connection>& out)
+{
+    auto producer = dynamic_cast<Producer*>(component);
+
+    if (producer) {
+        out.push_back(QObject::connect(producer, signal, context, callback));
+    }
+
+    return producer != nullptr;
+}
+
+template <typename Producer>
+bool connectFrames(ComponentInterface* component, void (Producer::*signal)(const QVector<QCanBusFrame>&),
+    QObject* context, const SimulationEngine::FrameCallback& callback, std::vector<QMetaObject::Connection>& out)
+{
+    auto producer = dynamic_cast<Producer*>(component);
+
+    if (producer) {
+        out.push_back(QObject::connect(producer, signal, context,
+            [callback](const QVector<QCanBusFrame>& frames) { callback(deviceFrames(frames, Direction::TX, true)); }));
+    }
+
+    return producer != nullptr;
+}
+} // namespace
+
+SimulationEngine::SimulationEngine()
+    : d_ptr(new SimulationEnginePrivate)
+{
+}
+
+SimulationEngine::~SimulationEngine()
+{
+    stop();
+    d_ptr->dropSubscriptions();
+}
+
+bool SimulationEngine::load(const QString& path)
+{
+    Q_D(SimulationEngine);
+
+    stop();
+    d->dropSubscriptions();
+
+    return d->_project.load(path);
+}
+
+bool SimulationEngine::load(const QJsonObject& project, const QString& baseDir)
+{
+    Q_D(SimulationEngine);
+
+    stop();
+    d->dropSubscriptions();
+
+    return d->_project.load(project, baseDir);
+}
+
+bool SimulationEngine::update(const QJsonObject& project, const QString& baseDir)
+{
+    Q_D(SimulationEngine);
+
+    const bool ok = d->_project.update(project, baseDir);
+    if (d->_running) {
+        d->settle();
+    }
+
+    return ok;
+}
+
+QStringList SimulationEngine::nodes() const
+{
+    return d_ptr->_project.nodeIds();
+}
+
+ComponentInterface* SimulationEngine::component(const QString& nodeId) const
+{
+    return d_ptr->_project.component(nodeId);
+}
+
+void SimulationEngine::setVirtualTime(bool enabled)
+{
+    d_ptr->_project.setVirtualTime(enabled);
+}
+
+void SimulationEngine::start()
+{
+    Q_D(SimulationEngine);
+
+    stop();
+    d->_baseline = Instrumentation::snapshot();
+    d->_project.startSimulation();
+    // Virtual time moves only within run()
+    SimClock::instance().setHeld(true);
+    d->_running = true;
+}
+
+void SimulationEngine::stop()
+{
+    Q_D(SimulationEngine);
+
+    if (!d->_running) {
+        return;
+    }
+
+    d->settle();
+    d->_project.stopSimulation();
+    // Frames sent by components stopping are still reported
+    d->settle();
+    d->_running = false;
+}
+
+bool SimulationEngine::isRunning() const
+{
+    return d_ptr->_running;
+}
+
+bool SimulationEngine::inject(const QString& deviceId, const CanFrameBatch& frames)
+{
+    Q_D(SimulationEngine);
+    auto device = dynamic_cast<CanDevice*>(d->_project.component(deviceId));
+
+    if (!device || !d->_running) {
+        return false;
+    }
+
+    QVector<QCanBusFrame> received;
+    received.reserve(frames.size());
+    for (const auto& rec : frames) {
+        received.append(toQCanBusFrame(rec));
+        stampFrame(received.last());
+    }
+
+    emit device->frameBatchReceived(received);
+
+    return true;
+}
+
+bool SimulationEngine::send(const QString& deviceId, const CanFrameBatch& frames)
+{
+    Q_D(SimulationEngine);
+    auto device = dynamic_cast<CanDevice*>(d->_project.component(deviceId));
+
+    if (!device || !d->_running) {
+        return false;
+    }
+
+    QVector<QCanBusFrame> written;
+    written.reserve(frames.size());
+    for (const auto& rec : frames) {
+        written.append(toQCanBusFrame(rec));
+    }
+
+    device->sendFrames(written);
+
+    return true;
+}
+
+SimulationEngine::SubscriptionId SimulationEngine::subscribe(const QString& nodeId, FrameCallback callback)
+{
+    Q_D(SimulationEngine);
+    ComponentInterface* component = d->_project.component(nodeId);
+    std::vector<QMetaObject::Connection> connections;
+    QObject* context = &d->_context;
+
+    if (!component || !callback) {
+        return kInvalidSubscription;
+    }
+
+    if (auto device = dynamic_cast<CanDevice*>(component)) {
+        connections.push_back(QObject::connect(device, &CanDevice::frameBatchReceived, context,
+            [callback](const QVector<QCanBusFrame>& frames) { callback(deviceFrames(frames, Direction::RX, true)); }));
+        connections.push_back(QObject::connect(device, &CanDevice::frameBatchSent, context,
+            [callback](bool status, const QVector<QCanBusFrame>& frames) {
+                callback(deviceFrames(frames, Direction::TX, status));
+            }));
+    } else if (!connectBatches(component, &TraceReplay::sendFrames, context, callback, connections)
+        && !connectBatches(component, &FrameFilter::framesFiltered, context, callback, connections)
+        && !connectBatches(component, &Merge::framesMerged, context, callback, connections)
+        && !connectBatches(component, &Trigger::framesCaptured, context, callback, connections)
+        && !connectBatches(component, &NetworkBridge::framesReceived, context, callback, connections)
+        && !connectFrames(component, &CanRawSender::sendFrames, context, callback, connections)
+        && !connectFrames(component, &IsoTp::sendFrames, context, callback, connections)) {
+        cds_warn("Node '{}' does not produce frames, nothing to subscribe to", nodeId.toStdString());
+        return kInvalidSubscription;
+    }
+
+    const SubscriptionId id = d->_nextSubscription++;
+    d->_subscriptions.emplace(id, std::move(connections));
+
+    return id;
+}
+
+void SimulationEngine::unsubscribe(SubscriptionId id)
+{
+    Q_D(SimulationEngine);
+    auto it = d->_subscriptions.find(id);
+
+    if (it != d->_subscriptions.end()) {
+        for (const auto& connection : it->second) {
+            QObject::disconnect(connection);
+        }
+        d->_subscriptions.erase(it);
+    }
+}
+
+void SimulationEngine::run(quint64 durationUs)
+{
+    Q_D(SimulationEngine);
+    QEventLoop loop;
+
+    if (SimClock::isVirtual()) {
+        // Clock stops at the end once everything scheduled before it ran
+        SimClock& clock = SimClock::instance();
+
+        clock.schedule(&loop, SimClock::nowUs() + durationUs, [&loop] { loop.quit(); });
+        clock.setHeld(false);
+        loop.exec();
+        clock.setHeld(true);
+    } else {
+        QTimer::singleShot(static_cast<int>(durationUs / 1000), &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    d->settle();
+}
+
+Instrumentation::Snapshot SimulationEngine::statistics() const
+{
+    return Instrumentation::snapshot() - d_ptr->_baseline;
+}
+
+NodeStats SimulationEngine::nodeStats(const QString& nodeId) const
+{
+    return d_ptr->_project.nodeStats(nodeId);
+}
+
+EdgeStats SimulationEngine::edgeStats(const QString& outId, const QString& inId) const
+{
+    return d_ptr->_project.edgeStats(outId, inId);
+}
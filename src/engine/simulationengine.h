@@ -0,0 +1,159 @@
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <canframerecord.h>
+#include <flowqueue.h>
+#include <functional>
+#include <instrumentation.h>
+#include <nodestats.h>
+
+class ComponentInterface;
+class SimulationEnginePrivate;
+
+/**
+*   @brief  In-process simulation engine for test automation, links without widgets
+*
+*   Runs project written by CANdevStudio (see HeadlessProject) and gives harness direct access to frames: frames are
+*   injected into devices as if they came from the bus or written to them, and frames of any producing node are
+*   passed to callbacks, one call per batch. Scenario is a sequence of calls in one thread:
+*
+*       SimulationEngine engine;
+*       engine.load("scenario.cds");
+*       engine.subscribe("view", [&](const CanFrameBatch& frames) { ... });
+*       engine.start();
+*       engine.inject("can0", frames);
+*       engine.run(100000);
+*       engine.stop();
+*
+*   Engine has to be used from thread of existing QCoreApplication, which runs components of main thread and
+*   callbacks while engine runs (see run). Application defines kDefaultLogger used by all components. Engines
+*   may be created and destroyed repeatedly, SimClock and Instrumentation are shared by all of them, so only one
+*   engine should run at a time.
+*
+*   Library target: cds-engine.
+*/
+class SimulationEngine {
+    Q_DECLARE_PRIVATE(SimulationEngine)
+
+public:
+    typedef std::function<void(const CanFrameBatch& frames)> FrameCallback;
+    typedef quint64 SubscriptionId;
+
+    static constexpr SubscriptionId kInvalidSubscription = 0;
+
+    SimulationEngine();
+    ~SimulationEngine();
+
+    SimulationEngine(const SimulationEngine&) = delete;
+    SimulationEngine& operator=(const SimulationEngine&) = delete;
+
+    /**
+    *   @brief  Loads project, stops simulation and drops subscriptions of project loaded before
+    *   @param  path project file path
+    *   @return false if file is not a valid project or contains node that cannot run without GUI
+    */
+    bool load(const QString& path);
+
+    /**
+    *   @brief  Loads project from parsed document, e.g. generated by the harness
+    *   @param  project project JSON (nodes and connections)
+    *   @param  baseDir directory side file references are resolved against
+    *   @return false if project contains node that cannot run without GUI
+    */
+    bool load(const QJsonObject& project, const QString& baseDir = QString());
+
+    /**
+    *   @brief  Applies edited project to the loaded one without restart, see HeadlessProject::update.
+    *           Subscriptions of nodes that were kept stay active, those of removed nodes end.
+    */
+    bool update(const QJsonObject& project, const QString& baseDir = QString());
+
+    /**
+    *   @return ids of loaded nodes
+    */
+    QStringList nodes() const;
+
+    /**
+    *   @return component of node, nullptr if there is no such node. For configuration not covered by engine.
+    */
+    ComponentInterface* component(const QString& nodeId) const;
+
+    /**
+    *   @brief  Runs simulations on virtual clock (see SimClock), so that replayed and synthetic traffic is not
+    *           paced by wall clock. Applies on next start.
+    */
+    void setVirtualTime(bool enabled);
+
+    /**
+    *   @brief  Starts simulation. Statistics and instrumentation counters start from zero.
+    */
+    void start();
+
+    /**
+    *   @brief  Stops simulation after queued batches were processed and passed to callbacks
+    */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+    *   @brief  Passes frames to device as if its backend received them from the bus
+    *   @param  deviceId id of CanDevice node
+    *   @param  frames frames in reception order, timestamps of 0 are stamped with current time
+    *   @return false if there is no such device or simulation does not run
+    */
+    bool inject(const QString& deviceId, const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Writes frames to device like any node connected to its input
+    *   @param  deviceId id of CanDevice node
+    *   @param  frames frames in transmission order
+    *   @return false if there is no such device or simulation does not run
+    */
+    bool send(const QString& deviceId, const CanFrameBatch& frames);
+
+    /**
+    *   @brief  Registers callback called with every batch node emits. Frames of devices are passed both when
+    *           received and when sent (with Tx flag). Callbacks run in thread of engine, from run() or stop().
+    *   @param  nodeId id of producing node: device, trace replay, sender, filter, merge, trigger, bridge, ISO-TP
+    *   @param  callback callback
+    *   @return id of subscription, kInvalidSubscription if node does not exist or does not produce frames
+    */
+    SubscriptionId subscribe(const QString& nodeId, FrameCallback callback);
+
+    /**
+    *   @brief  Drops subscription. Unknown ids are ignored.
+    */
+    void unsubscribe(SubscriptionId id);
+
+    /**
+    *   @brief  Processes events of simulation for given time, then waits for batches queued meanwhile
+    *   @param  durationUs time to run, virtual time when virtual clock is used. Virtual clock is then at the end
+    *           of the period, even if nothing was scheduled in it.
+    */
+    void run(quint64 durationUs);
+
+    /**
+    *   @return frame path counters of all nodes since start, see Instrumentation
+    */
+    Instrumentation::Snapshot statistics() const;
+
+    /**
+    *   @return frame path counters of node since start, zeros for unknown node
+    */
+    NodeStats nodeStats(const QString& nodeId) const;
+
+    /**
+    *   @return flow control counters of connection, zeros for unknown connection or connection without queue
+    */
+    EdgeStats edgeStats(const QString& outId, const QString& inId) const;
+
+private:
+    QScopedPointer<SimulationEnginePrivate> d_ptr;
+};
+
+#endif // SIMULATIONENGINE_H
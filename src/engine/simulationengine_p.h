@@ -0,0 +1,42 @@
+#ifndef SIMULATIONENGINE_P_H
+#define SIMULATIONENGINE_P_H
+
+#include "simulationengine.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <headlessproject.h>
+#include <unordered_map>
+#include <vector>
+
+class SimulationEnginePrivate {
+public:
+    /**
+    *   @brief  Lets frames emitted meanwhile reach callbacks: signals queued from device and worker threads are
+    *           delivered and queues of the plan drained
+    */
+    void settle()
+    {
+        QCoreApplication::processEvents();
+        _project.flush();
+        QCoreApplication::processEvents();
+    }
+
+    void dropSubscriptions()
+    {
+        for (const auto& subscription : _subscriptions) {
+            for (const auto& connection : subscription.second) {
+                QObject::disconnect(connection);
+            }
+        }
+        _subscriptions.clear();
+    }
+
+    HeadlessProject _project;
+    QObject _context; // callbacks are called in its thread
+    std::unordered_map<SimulationEngine::SubscriptionId, std::vector<QMetaObject::Connection>> _subscriptions;
+    SimulationEngine::SubscriptionId _nextSubscription{ SimulationEngine::kInvalidSubscription + 1 };
+    Instrumentation::Snapshot _baseline; // counters when simulation started
+    bool _running{ false };
+};
+
+#endif // SIMULATIONENGINE_P_H
@@ -1,7 +1,10 @@
 #include "mainwindow.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
 #include <QtCore/QtDebug>
 #include <QtCore/QtGlobal>
 #include <QtWidgets/QApplication>
+#include <canbackendcatalog.h>
 
 #include "log.h"
 
@@ -15,8 +18,8 @@ const std::string localFile(const std::string& fullPath)
 
 void setupLogger(bool verbose)
 {
-    kDefaultLogger = spdlog::stdout_color_mt("cds");
-    qtDefaultLogger = spdlog::stdout_color_mt("cds-qt");
+    kDefaultLogger = createAsyncLogger("cds");
+    qtDefaultLogger = createAsyncLogger("cds-qt");
     if (verbose) {
         kDefaultLogger->set_level(spdlog::level::debug);
         qtDefaultLogger->set_level(spdlog::level::debug);
@@ -51,6 +54,9 @@ void setupLogger(bool verbose)
 
 int main(int argc, char* argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
     QApplication a(argc, argv);
     QCoreApplication::setAttribute(Qt::AA_DontUseNativeMenuBar);
 
@@ -61,8 +67,14 @@ int main(int argc, char* argv[])
 
     qDebug() << "Qt message ";
 
+    // Plugins are loaded while main window is built, devices are created on simulation start only
+    CanBackendCatalog::prefetch();
+
     MainWindow w;
     w.show();
 
+    // Runs once window is shown and event loop is processing events
+    QTimer::singleShot(0, [&startup] { cds_info("User interface ready {} ms after start", startup.elapsed()); });
+
     return a.exec();
 }
@@ -2,15 +2,19 @@
 #include "mainwindow.h"
 #include "log.h"
 #include "modelvisitor.h" // apply_model_visitor
+#include "propertyeditordialog.h"
+#include "statsoverlay.h"
 #include "subwindow.h"
 #include "ui_mainwindow.h"
 
 #include <QCloseEvent>
 #include <QtCore/QFile>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QLabel>
 #include <QtWidgets/QMdiArea>
 #include <QtWidgets/QMdiSubWindow>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QStatusBar>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
@@ -20,6 +24,11 @@ MainWindow::MainWindow(QWidget* parent)
     ui->centralWidget->layout()->setContentsMargins(0, 0, 0, 0);
 
     projectConfig = std::make_unique<ProjectConfig>();
+    statsOverlay = new StatsOverlay(ui->centralWidget);
+    loadStatus = new QLabel(this);
+    loadStatus->setStyleSheet("color: #c05000;");
+    statusBar()->addPermanentWidget(loadStatus);
+    statusBar()->hide();
 
     setupMdiArea();
     connectToolbarSignals();
@@ -71,17 +80,18 @@ void MainWindow::connectToolbarSignals()
 
 void MainWindow::handleSaveAction()
 {
-    QString fileName = QFileDialog::getSaveFileName(
-        nullptr, "Project Configuration", QDir::homePath(), "CANdevStudio Files (*.cds)");
+    const QString jsonFilter = "CANdevStudio JSON export (*.cds)";
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(nullptr, "Project Configuration", QDir::homePath(),
+        "CANdevStudio Files (*.cds);;" + jsonFilter, &selectedFilter);
 
     if (!fileName.isEmpty()) {
         if (!fileName.endsWith(".cds", Qt::CaseInsensitive))
             fileName += ".cds";
 
-        QFile file(fileName);
-        if (file.open(QIODevice::WriteOnly)) {
-            file.write(projectConfig->save()); // FIXME
-        }
+        // Written in background, result is reported with projectSaved
+        projectConfig->save(fileName,
+            (selectedFilter == jsonFilter) ? ProjectWriter::Format::Json : ProjectWriter::Format::Binary);
     } else {
         cds_error("File name empty");
     }
@@ -97,20 +107,10 @@ void MainWindow::handleLoadAction()
         return;
     }
 
-    QFile file(fileName);
-
-    if (!file.open(QIODevice::ReadOnly)) {
-        cds_error("Could not open file");
-        return;
-    }
-
-    QByteArray wholeFile = file.readAll();
-
-    // TODO check if file is correct, nodeeditor library does not provide it and will crash if incorrect file is
-    // supplied
-
     projectConfig->clearGraphView();
-    projectConfig->load(wholeFile); // FIXME
+    if (!projectConfig->load(fileName)) {
+        QMessageBox::warning(this, "Load project", "Failed to load project " + fileName);
+    }
 }
 
 void MainWindow::connectMenuSignals()
@@ -129,6 +129,21 @@ void MainWindow::connectMenuSignals()
     connect(ui->actionTabView, &QAction::toggled, ui->actionCascade, &QAction::setDisabled);
     connect(ui->actionSubWindowView, &QAction::triggered, this,
         [this] { ui->mdiArea->setViewMode(QMdiArea::SubWindowView); });
+    connect(ui->actionStatsOverlay, &QAction::toggled, statsOverlay, &StatsOverlay::setVisible);
+    connect(ui->actionNodeStats, &QAction::toggled, projectConfig.get(), &ProjectConfig::setNodeStatsVisible);
+    connect(ui->actionVirtualTime, &QAction::toggled, projectConfig.get(), &ProjectConfig::setVirtualTime);
+    connect(ui->actionNodeProperties, &QAction::triggered, this, [this] {
+        QObject* properties = projectConfig->selectedNodeProperties();
+
+        if (!properties) {
+            QMessageBox::information(this, "Node properties", "Select one node to edit its properties");
+            return;
+        }
+
+        PropertyEditorDialog dialog(properties, this);
+        dialog.setWindowTitle("Node properties");
+        dialog.exec();
+    });
 }
 
 void MainWindow::componentWidgetCreated(QWidget* component)
@@ -149,4 +164,20 @@ void MainWindow::setupMdiArea()
     ui->mdiArea->setViewMode(QMdiArea::TabbedView);
     connect(projectConfig.get(), &ProjectConfig::componentWidgetCreated, this, &MainWindow::componentWidgetCreated);
     connect(projectConfig.get(), &ProjectConfig::handleDock, this, &MainWindow::handleDock);
+    connect(projectConfig.get(), &ProjectConfig::loadLevelChanged, this,
+        [this](LoadLevel level, const QString& reason) {
+            const bool degraded = (level != LoadLevel::Normal);
+            const QString mode = (level == LoadLevel::Sampled) ? "frames sampled" : "refresh reduced";
+
+            // Status bar takes space only while views are degraded
+            loadStatus->setText(degraded ? QString("GUI overloaded, %1 (%2)").arg(mode, reason) : QString());
+            statusBar()->setVisible(degraded);
+        });
+    connect(projectConfig.get(), &ProjectConfig::projectSaved, this, [this](const QString& path, bool status) {
+        if (status) {
+            cds_info("Project saved to '{}'", path.toStdString());
+        } else {
+            QMessageBox::warning(this, "Save project", "Failed to save project " + path);
+        }
+    });
 }
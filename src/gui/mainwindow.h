@@ -7,6 +7,8 @@
 #include "projectconfig/projectconfig.h"
 
 class QCloseEvent;
+class QLabel;
+class StatsOverlay;
 
 namespace Ui {
 class MainWindow;
@@ -22,6 +24,8 @@ public:
 private:
     std::unique_ptr<Ui::MainWindow> ui;
     std::unique_ptr<ProjectConfig> projectConfig;
+    StatsOverlay* statsOverlay;
+    QLabel* loadStatus; // shown in status bar while views are degraded
 
     void connectToolbarSignals();
     void connectMenuSignals();
@@ -0,0 +1,65 @@
+#include "statsoverlay.h"
+#include <QtCore/QEvent>
+
+constexpr int StatsOverlay::kRefreshIntervalMs;
+
+StatsOverlay::StatsOverlay(QWidget* parent)
+    : QLabel(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: white; padding: 6px;"
+                  " font-family: monospace; }");
+    setText("Collecting...");
+    hide();
+
+    // Overlay stays in top right corner when parent is resized
+    parent->installEventFilter(this);
+
+    _timer.setInterval(kRefreshIntervalMs);
+    connect(&_timer, &QTimer::timeout, this, &StatsOverlay::refresh);
+}
+
+bool StatsOverlay::eventFilter(QObject* watched, QEvent* event)
+{
+    if ((watched == parentWidget()) && (event->type() == QEvent::Resize)) {
+        reposition();
+    }
+
+    return QLabel::eventFilter(watched, event);
+}
+
+void StatsOverlay::showEvent(QShowEvent* event)
+{
+    _last = Instrumentation::snapshot();
+    _elapsed.start();
+    _timer.start();
+    raise();
+    reposition();
+
+    QLabel::showEvent(event);
+}
+
+void StatsOverlay::hideEvent(QHideEvent* event)
+{
+    _timer.stop();
+
+    QLabel::hideEvent(event);
+}
+
+void StatsOverlay::refresh()
+{
+    const Instrumentation::Snapshot now = Instrumentation::snapshot();
+    const double seconds = _elapsed.restart() / 1000.0;
+
+    setText(Instrumentation::toString(now - _last, seconds));
+    _last = now;
+    adjustSize();
+    reposition();
+}
+
+void StatsOverlay::reposition()
+{
+    const int margin = 8;
+
+    move(parentWidget()->width() - width() - margin, margin);
+}
@@ -0,0 +1,36 @@
+#ifndef STATSOVERLAY_H
+#define STATSOVERLAY_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+#include <QtWidgets/QLabel>
+#include <instrumentation.h>
+
+/**
+*   @brief  Translucent label showing instrumentation counters of the last refresh interval on top of its parent
+*
+*   Counters are only sampled while overlay is visible. Overlay ignores mouse, so widgets below stay usable.
+*/
+class StatsOverlay : public QLabel {
+    Q_OBJECT
+
+public:
+    static constexpr int kRefreshIntervalMs = 1000;
+
+    explicit StatsOverlay(QWidget* parent);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void refresh();
+    void reposition();
+
+    QTimer _timer;
+    QElapsedTimer _elapsed;
+    Instrumentation::Snapshot _last;
+};
+
+#endif // STATSOVERLAY_H
@@ -0,0 +1,535 @@
+#include "headlessproject.h"
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSet>
+#include <algorithm>
+#include <busstatistics.h>
+#include <candevice.h>
+#include <canrawsender.h>
+#include <canrawview.h>
+#include <framefilter.h>
+#include <functional>
+#include <gateway.h>
+#include <gui/bsheadlessgui.h>
+#include <gui/crsheadlessgui.h>
+#include <gui/crvheadlessgui.h>
+#include <gui/spheadlessgui.h>
+#include <isotp.h>
+#include <log.h>
+#include <merge.h>
+#include <networkbridge.h>
+#include <projectfile.h>
+#include <signaldecoder.h>
+#include <signalplot.h>
+#include <simclock.h>
+#include <tracelogger.h>
+#include <tracereplay.h>
+#include <trigger.h>
+#include <udsflasher.h>
+
+namespace {
+std::unique_ptr<ComponentInterface> createComponent(const QString& model)
+{
+    if (model == "CanDeviceModel") {
+        return std::make_unique<CanDevice>();
+    } else if (model == "CanRawViewModel") {
+        return std::make_unique<CanRawView>(CanRawViewCtx(new CRVHeadlessGui));
+    } else if (model == "CanRawSenderModel") {
+        // Lines are created from GUI only, so line widget factory is never used here
+        return std::make_unique<CanRawSender>(CanRawSenderCtx(new CRSHeadlessGui));
+    } else if (model == "TraceLoggerModel") {
+        return std::make_unique<TraceLogger>();
+    } else if (model == "TraceReplayModel") {
+        return std::make_unique<TraceReplay>();
+    } else if (model == "SignalDecoderModel") {
+        return std::make_unique<SignalDecoder>();
+    } else if (model == "SignalPlotModel") {
+        return std::make_unique<SignalPlot>(SignalPlotCtx(new SPHeadlessGui));
+    } else if (model == "BusStatisticsModel") {
+        return std::make_unique<BusStatistics>(BusStatisticsCtx(new BSHeadlessGui));
+    } else if (model == "IsoTpModel") {
+        return std::make_unique<IsoTp>();
+    } else if (model == "UdsFlasherModel") {
+        return std::make_unique<UdsFlasher>();
+    } else if (model == "TriggerModel") {
+        return std::make_unique<Trigger>();
+    } else if (model == "NetworkBridgeModel") {
+        return std::make_unique<NetworkBridge>();
+    } else if (model == "MergeModel") {
+        return std::make_unique<Merge>();
+    } else if (model == "GatewayModel") {
+        return std::make_unique<Gateway>();
+    } else if (model == "FrameFilterModel") {
+        return std::make_unique<FrameFilter>();
+    }
+
+    return {};
+}
+
+// Replay that ends by itself, project is finished when there is none left
+bool isPendingReplay(const ComponentInterface& component)
+{
+    auto replay = dynamic_cast<const TraceReplay*>(&component);
+
+    return replay && replay->isPlaying() && !replay->getConfig()["loop"].toBool();
+}
+} // namespace
+
+HeadlessProject::~HeadlessProject()
+{
+    if (_running) {
+        stopSimulation();
+    }
+}
+
+bool HeadlessProject::load(const QString& path)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        cds_error("Could not open project file '{}'", path.toStdString());
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    const bool binary = ProjectFile::isBinary(data);
+    QJsonObject project;
+
+    if (binary) {
+        // All nodes run at once, so every configuration is needed right away
+        ProjectFile::Document doc;
+        QString error;
+
+        if (!ProjectFile::read(data, doc, error)) {
+            cds_error("Invalid project file '{}': {}", path.toStdString(), error.toStdString());
+            return false;
+        }
+        project = doc.toJson();
+    } else {
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+        if (!doc.isObject()) {
+            cds_error("Invalid project file '{}': {}", path.toStdString(), error.errorString().toStdString());
+            return false;
+        }
+        project = doc.object();
+    }
+
+    if (!load(project, QFileInfo(path).absolutePath())) {
+        return false;
+    }
+
+    cds_info("Project '{}' ({}) with {} nodes loaded in {} ms", path.toStdString(), binary ? "binary" : "JSON",
+        _nodes.size(), timer.elapsed());
+
+    return true;
+}
+
+bool HeadlessProject::load(const QJsonObject& project, const QString& baseDir)
+{
+    const QDir dir(baseDir);
+
+    if (_running) {
+        stopSimulation();
+    }
+    _plan.clear();
+    _nodes.clear();
+    _connections.clear();
+
+    for (const auto& value : project["nodes"].toArray()) {
+        const QJsonObject json = value.toObject();
+        Node node = createNode(json);
+
+        if (!node.component) {
+            _nodes.clear();
+            return false;
+        }
+
+        configureNode(node, json["model"].toObject(), dir);
+        _nodes.push_back(std::move(node));
+    }
+
+    for (const auto& value : project["connections"].toArray()) {
+        if (!addConnection(value.toObject())) {
+            _plan.clear();
+            _nodes.clear();
+            _connections.clear();
+            return false;
+        }
+    }
+
+    cds_info("Loaded {} nodes", _nodes.size());
+
+    return true;
+}
+
+bool HeadlessProject::update(const QJsonObject& project, const QString& baseDir)
+{
+    const QDir dir(baseDir);
+    std::vector<Node> added;
+    std::vector<QJsonObject> addedModels;
+    std::vector<std::pair<QString, QJsonObject>> changed;
+    QSet<QString> kept;
+
+    // Components are created before anything is changed, so that rejected update leaves project as it was
+    for (const auto& value : project["nodes"].toArray()) {
+        const QJsonObject json = value.toObject();
+        const QJsonObject model = json["model"].toObject();
+        Node* node = find(json["id"].toString());
+
+        if (node && (node->model == model["name"].toString())) {
+            if (node->config != model) {
+                changed.emplace_back(node->id, model);
+            }
+            kept.insert(node->id);
+            continue;
+        }
+
+        Node created = createNode(json);
+        if (!created.component) {
+            return false;
+        }
+        added.push_back(std::move(created));
+        addedModels.push_back(model);
+    }
+
+    std::vector<QJsonObject> connections;
+    for (const auto& value : project["connections"].toArray()) {
+        connections.push_back(value.toObject());
+    }
+
+    // Connections are compared as a whole, edge with changed port or queue policy is made again
+    std::vector<QJsonObject> removedConnections;
+    for (const auto& conn : _connections) {
+        const bool endsKept = kept.contains(conn["out_id"].toString()) && kept.contains(conn["in_id"].toString());
+
+        if (!endsKept || (std::find(connections.begin(), connections.end(), conn) == connections.end())) {
+            removedConnections.push_back(conn);
+        }
+    }
+
+    for (const auto& conn : removedConnections) {
+        removeConnection(conn);
+    }
+
+    std::size_t removedNodes = 0;
+    for (auto it = _nodes.begin(); it != _nodes.end();) {
+        if (kept.contains(it->id)) {
+            ++it;
+            continue;
+        }
+
+        ++removedNodes;
+        _plan.removeComponent(*it->component);
+        if (_running) {
+            it->component->stopSimulation();
+        }
+        it = _nodes.erase(it);
+    }
+
+    for (const auto& entry : changed) {
+        configureNode(*find(entry.first), entry.second, dir);
+    }
+
+    const std::size_t firstAdded = _nodes.size();
+    for (std::size_t i = 0; i < added.size(); ++i) {
+        configureNode(added[i], addedModels[i], dir);
+        _nodes.push_back(std::move(added[i]));
+    }
+
+    bool ok = true;
+    std::size_t addedConnections = 0;
+    for (const auto& conn : connections) {
+        if (std::find(_connections.begin(), _connections.end(), conn) == _connections.end()) {
+            // Project stays usable, invalid connection is only reported
+            ok &= addConnection(conn);
+            ++addedConnections;
+        }
+    }
+
+    if (_running) {
+        // New consumers may need frames filtered out so far
+        updateAcceptanceFilters();
+
+        for (std::size_t i = firstAdded; i < _nodes.size(); ++i) {
+            _nodes[i].component->startSimulation();
+        }
+
+        // Added and reconfigured replays are counted again, removed ones are dropped. Untouched replays keep their
+        // state, as finished one may still be seen playing until its thread exits.
+        QSet<QString> touched;
+        for (const auto& entry : changed) {
+            touched.insert(entry.first);
+        }
+
+        QSet<const ComponentInterface*> pending;
+        for (std::size_t i = 0; i < _nodes.size(); ++i) {
+            const ComponentInterface* component = _nodes[i].component.get();
+            const bool recount = (i >= firstAdded) || touched.contains(_nodes[i].id);
+
+            if (recount ? isPendingReplay(*component) : _pendingReplays.contains(component)) {
+                pending.insert(component);
+            }
+        }
+
+        const bool wasPending = !_pendingReplays.isEmpty();
+        _pendingReplays = pending;
+        if (wasPending && _pendingReplays.isEmpty()) {
+            emit replaysFinished();
+        }
+    }
+
+    cds_info("Project updated: nodes {} added, {} removed, {} reconfigured; connections {} added, {} removed",
+        added.size(), removedNodes, changed.size(), addedConnections, removedConnections.size());
+
+    return ok;
+}
+
+void HeadlessProject::setVirtualTime(bool enabled)
+{
+    _virtualTime = enabled;
+}
+
+void HeadlessProject::startSimulation()
+{
+    // Filters must be known when devices start, as well as clock their traffic follows
+    updateAcceptanceFilters();
+    SimClock::instance().start(_virtualTime ? SimClock::Mode::Virtual : SimClock::Mode::RealTime);
+
+    for (auto& node : _nodes) {
+        node.component->startSimulation();
+    }
+
+    _pendingReplays.clear();
+    for (const auto& node : _nodes) {
+        if (isPendingReplay(*node.component)) {
+            _pendingReplays.insert(node.component.get());
+        }
+    }
+
+    _running = true;
+}
+
+void HeadlessProject::stopSimulation()
+{
+    // Pending events of simulated sources are dropped
+    SimClock::instance().stop();
+
+    // Devices stop first, so that consumers running on workers get every frame before they stop
+    for (auto& node : _nodes) {
+        if (dynamic_cast<CanDevice*>(node.component.get())) {
+            node.component->stopSimulation();
+        }
+    }
+
+    _plan.flush();
+    for (const auto& node : _nodes) {
+        for (auto consumer : node.consumers) {
+            const EdgeStats stats = _plan.edgeStats(*node.component, *consumer);
+
+            if (stats.droppedBatches > 0) {
+                cds_warn("Edge '{}' -> '{}' dropped {} batches ({} frames)", node.id.toStdString(),
+                    id(*consumer).toStdString(), stats.droppedBatches, stats.droppedFrames);
+            }
+        }
+    }
+
+    for (auto& node : _nodes) {
+        if (!dynamic_cast<CanDevice*>(node.component.get())) {
+            node.component->stopSimulation();
+        }
+    }
+
+    _running = false;
+}
+
+std::size_t HeadlessProject::nodeCount() const
+{
+    return _nodes.size();
+}
+
+QStringList HeadlessProject::nodeIds() const
+{
+    QStringList ids;
+
+    for (const auto& node : _nodes) {
+        ids.append(node.id);
+    }
+
+    return ids;
+}
+
+void HeadlessProject::flush()
+{
+    _plan.flush();
+}
+
+NodeStats HeadlessProject::nodeStats(const QString& id) const
+{
+    const ComponentInterface* node = component(id);
+
+    return node ? _plan.nodeStats(*node) : NodeStats();
+}
+
+EdgeStats HeadlessProject::edgeStats(const QString& outId, const QString& inId) const
+{
+    const ComponentInterface* out = component(outId);
+    const ComponentInterface* in = component(inId);
+
+    return (out && in) ? _plan.edgeStats(*out, *in) : EdgeStats{ 0, 0, 0 };
+}
+
+ComponentInterface* HeadlessProject::component(const QString& id) const
+{
+    for (const auto& node : _nodes) {
+        if (node.id == id) {
+            return node.component.get();
+        }
+    }
+
+    return nullptr;
+}
+
+QString HeadlessProject::id(const ComponentInterface& component) const
+{
+    for (const auto& node : _nodes) {
+        if (node.component.get() == &component) {
+            return node.id;
+        }
+    }
+
+    return {};
+}
+
+HeadlessProject::Node HeadlessProject::createNode(const QJsonObject& json)
+{
+    const QJsonObject model = json["model"].toObject();
+    Node node{ json["id"].toString(), model["name"].toString(), createComponent(model["name"].toString()), {}, {} };
+
+    if (!node.component) {
+        // Running project with part of it silently missing would give misleading results
+        cds_error("Node '{}' of type '{}' cannot run headless", node.id.toStdString(), node.model.toStdString());
+        return node;
+    }
+
+    if (auto replay = dynamic_cast<TraceReplay*>(node.component.get())) {
+        connect(replay, &TraceReplay::finished, this, [this, replay] { replayFinished(*replay); });
+    }
+
+    return node;
+}
+
+void HeadlessProject::configureNode(Node& node, const QJsonObject& model, const QDir& dir)
+{
+    QJsonObject config = model;
+    const bool sideDataChanged = model[kSideDataKey] != node.config[kSideDataKey];
+
+    node.component->setConfig(config);
+    _plan.setAffinity(*node.component, model[kThreadAffinityKey].toInt(FlowPlan::kMainThread));
+    if (model.contains(kSideDataKey) && sideDataChanged) {
+        node.component->loadSideData(dir.absoluteFilePath(model[kSideDataKey].toString()));
+    }
+    node.config = model;
+}
+
+bool HeadlessProject::addConnection(const QJsonObject& json)
+{
+    Node* out = find(json["out_id"].toString());
+    Node* in = find(json["in_id"].toString());
+
+    if (!out || !in
+        || !connectNodes(*out, *in, EdgePolicy::fromJson(json["queue"].toObject()), json["in_index"].toInt(),
+               json["out_index"].toInt())) {
+        cds_error("Invalid connection '{}' -> '{}'", json["out_id"].toString().toStdString(),
+            json["in_id"].toString().toStdString());
+        return false;
+    }
+
+    _connections.push_back(json);
+
+    return true;
+}
+
+void HeadlessProject::removeConnection(const QJsonObject& json)
+{
+    Node* out = find(json["out_id"].toString());
+    Node* in = find(json["in_id"].toString());
+
+    _connections.erase(std::remove(_connections.begin(), _connections.end(), json), _connections.end());
+    if (!out || !in) {
+        return;
+    }
+
+    // Plan removes all edges between the two nodes, those connecting other ports are made again
+    std::vector<QJsonObject> others;
+    for (auto it = _connections.begin(); it != _connections.end();) {
+        if ((find((*it)["out_id"].toString()) == out) && (find((*it)["in_id"].toString()) == in)) {
+            others.push_back(*it);
+            it = _connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    _plan.removeEdge(*out->component, *in->component);
+    auto& consumers = out->consumers;
+    consumers.erase(std::remove(consumers.begin(), consumers.end(), in->component.get()), consumers.end());
+
+    for (const auto& other : others) {
+        addConnection(other);
+    }
+}
+
+HeadlessProject::Node* HeadlessProject::find(const QString& id)
+{
+    for (auto& node : _nodes) {
+        if (node.id == id) {
+            return &node;
+        }
+    }
+
+    return nullptr;
+}
+
+bool HeadlessProject::connectNodes(Node& out, Node& in, const EdgePolicy& policy, int inPort, int outPort)
+{
+    if (!_plan.addEdge(*out.component, *in.component, policy, inPort, outPort)) {
+        return false;
+    }
+
+    if (dynamic_cast<CanDevice*>(out.component.get())) {
+        out.consumers.push_back(in.component.get());
+    }
+
+    return true;
+}
+
+void HeadlessProject::updateAcceptanceFilters()
+{
+    for (auto& node : _nodes) {
+        auto device = dynamic_cast<CanDevice*>(node.component.get());
+
+        if (device) {
+            QVector<CanFilterList> consumers;
+
+            for (auto consumer : node.consumers) {
+                consumers.append(consumer->acceptanceFilters());
+            }
+
+            device->setAcceptanceFilters(mergeCanFilters(consumers));
+        }
+    }
+}
+
+void HeadlessProject::replayFinished(const ComponentInterface& replay)
+{
+    if (_pendingReplays.remove(&replay) && _pendingReplays.isEmpty()) {
+        emit replaysFinished();
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef HEADLESSPROJECT_H
+#define HEADLESSPROJECT_H
+
+#include <QtCore/QDir>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <componentinterface.h>
+#include <flowplan.h>
+#include <memory>
+#include <vector>
+
+/**
+*   @brief  Project graph instantiated without node editor and widgets
+*
+*   Reads project file written by ProjectConfig, creates components with no-op GUI backends and connects them with
+*   direct signal/slot connections. Frames do not go through node data models nor through event queue of GUI
+*   thread, so project runs on QCoreApplication at full speed.
+*/
+class HeadlessProject : public QObject {
+    Q_OBJECT
+
+public:
+    HeadlessProject() = default;
+    ~HeadlessProject();
+
+    /**
+    *   @brief  Loads project. Project currently loaded is dropped first.
+    *   @param  path project file path, JSON or binary encoding (see ProjectFile)
+    *   @return false if file is not a valid project or contains node that cannot run headless
+    */
+    bool load(const QString& path);
+
+    /**
+    *   @brief  Loads project from parsed document
+    *   @param  project project JSON (nodes and connections)
+    *   @param  baseDir directory side file references are resolved against
+    *   @return false if project contains node that cannot run headless
+    */
+    bool load(const QJsonObject& project, const QString& baseDir);
+
+    /**
+    *   @brief  Applies edited project to the loaded one, also while simulation runs. Project is diffed by node id:
+    *           only nodes and connections that were added, removed or changed are touched, the others keep their
+    *           state (captures, open devices, queues). Added nodes start if simulation runs, removed ones stop.
+    *           Node with changed model type is replaced, node with changed configuration gets new configuration
+    *           (device applies it on next start).
+    *   @param  project project JSON (nodes and connections)
+    *   @param  baseDir directory side file references are resolved against
+    *   @return false if project contains node that cannot run headless (nothing is changed then) or connection
+    *           that cannot be made (the rest is applied)
+    */
+    bool update(const QJsonObject& project, const QString& baseDir);
+
+    /**
+    *   @brief  Runs simulation on virtual clock, see SimClock. Applies when simulation starts.
+    */
+    void setVirtualTime(bool enabled);
+
+    void startSimulation();
+    void stopSimulation();
+
+    std::size_t nodeCount() const;
+
+    /**
+    *   @return ids of nodes in project file order
+    */
+    QStringList nodeIds() const;
+
+    /**
+    *   @brief  Blocks until batches queued by edges of the plan were processed. Called from main thread.
+    */
+    void flush();
+
+    /**
+    *   @return frame path counters of node since simulation started, zeros for unknown node
+    */
+    NodeStats nodeStats(const QString& id) const;
+
+    /**
+    *   @return flow control counters of connection, zeros for unknown connection or connection without queue
+    */
+    EdgeStats edgeStats(const QString& outId, const QString& inId) const;
+
+    /**
+    *   @param  id node id from project file
+    *   @return component of node, nullptr if there is no such node
+    */
+    ComponentInterface* component(const QString& id) const;
+
+signals:
+    /**
+    *   @brief  Emitted when every non-looping trace replay of the project reached end of trace
+    */
+    void replaysFinished();
+
+private:
+    struct Node {
+        QString id;
+        QString model;
+        std::unique_ptr<ComponentInterface> component;
+        std::vector<ComponentInterface*> consumers; // nodes fed with frames of this one
+        QJsonObject config; // model JSON of project file
+    };
+
+    Node createNode(const QJsonObject& json);
+    void configureNode(Node& node, const QJsonObject& model, const QDir& dir);
+    bool addConnection(const QJsonObject& json);
+    void removeConnection(const QJsonObject& json);
+    Node* find(const QString& id);
+    QString id(const ComponentInterface& component) const;
+    bool connectNodes(Node& out, Node& in, const EdgePolicy& policy, int inPort, int outPort);
+    void updateAcceptanceFilters();
+    void replayFinished(const ComponentInterface& replay);
+
+    std::vector<Node> _nodes;
+    std::vector<QJsonObject> _connections; // connection JSONs of project file
+    FlowPlan _plan; // destroyed before nodes
+    QSet<const ComponentInterface*> _pendingReplays; // playing non-looping trace replays
+    bool _running{ false };
+    bool _virtualTime{ false };
+};
+
+#endif // HEADLESSPROJECT_H
@@ -0,0 +1,159 @@
+#include "headlessproject.h"
+#include <traceexporter.h>
+#include <canbackendcatalog.h>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+#include <csignal>
+
+#include "instrumentation.h"
+#include "log.h"
+#include "simclock.h"
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+// Interval of checking for SIGINT/SIGTERM, handler may only set flag
+constexpr int kSignalPollMs = 100;
+volatile std::sig_atomic_t quitRequested = 0;
+
+void quitOnSignal(int)
+{
+    quitRequested = 1;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QElapsedTimer startup;
+    startup.start();
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CANdevStudio-headless");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs CANdevStudio project without GUI");
+    parser.addHelpOption();
+    parser.addPositionalArgument("project", "Project file (.cds), or trace (.cdst) with --export.");
+    QCommandLineOption durationOption(QStringList{ "d", "duration" },
+        "Stop simulation after given number of seconds, 0 runs until interrupted.", "seconds", "0");
+    QCommandLineOption verboseOption(QStringList{ "v", "verbose" }, "Enable debug logs.");
+    QCommandLineOption statsOption(QStringList{ "s", "stats" },
+        "Log frame path statistics every given number of seconds and at exit, 0 logs them at exit only.", "seconds");
+    QCommandLineOption exportOption(QStringList{ "e", "export" },
+        "Export trace to given file and exit. Format is chosen by suffix: .asc, .blf, .log (candump) or .pcapng.",
+        "file");
+    QCommandLineOption virtualTimeOption("virtual-time",
+        "Run on virtual clock: replayed and synthetic traffic is generated as fast as it is processed, duration is "
+        "virtual time.");
+    parser.addOption(durationOption);
+    parser.addOption(verboseOption);
+    parser.addOption(statsOption);
+    parser.addOption(exportOption);
+    parser.addOption(virtualTimeOption);
+    parser.process(app);
+
+    kDefaultLogger = createAsyncLogger("cds");
+    if (parser.isSet(verboseOption) || CDS_DEBUG) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    if (parser.isSet(exportOption)) {
+        TraceExporter::Options options;
+
+        if (!TraceExporter::formatFromPath(parser.value(exportOption), options.format)) {
+            cds_error("Unknown export format of '{}'", parser.value(exportOption).toStdString());
+            return 1;
+        }
+
+        return TraceExporter::exportTrace(parser.value(exportOption), parser.positionalArguments().front(), options)
+            ? 0
+            : 1;
+    }
+
+    // Plugins are loaded while project is loaded
+    CanBackendCatalog::prefetch();
+
+    HeadlessProject project;
+    project.setVirtualTime(parser.isSet(virtualTimeOption));
+    if (!project.load(parser.positionalArguments().front())) {
+        return 1;
+    }
+
+    bool durationOk = false;
+    const double duration = parser.value(durationOption).toDouble(&durationOk);
+    if (!durationOk || (duration < 0)) {
+        cds_error("Invalid duration '{}'", parser.value(durationOption).toStdString());
+        return 1;
+    }
+
+    const double statsInterval = parser.value(statsOption).toDouble();
+    if (parser.isSet(statsOption) && (statsInterval < 0)) {
+        cds_error("Invalid statistics interval '{}'", parser.value(statsOption).toStdString());
+        return 1;
+    }
+
+    std::signal(SIGINT, quitOnSignal);
+    std::signal(SIGTERM, quitOnSignal);
+    QTimer signalTimer;
+    QObject::connect(&signalTimer, &QTimer::timeout, [] {
+        if (quitRequested) {
+            QCoreApplication::quit();
+        }
+    });
+    signalTimer.start(kSignalPollMs);
+
+    if ((duration > 0) && !parser.isSet(virtualTimeOption)) {
+        QTimer::singleShot(static_cast<int>(duration * 1000), &app, &QCoreApplication::quit);
+    }
+    // Projects replaying traces finish on their own
+    QObject::connect(&project, &HeadlessProject::replaysFinished, &app, &QCoreApplication::quit);
+
+    QElapsedTimer timer;
+    QTimer statsTimer;
+    Instrumentation::Snapshot lastStats = Instrumentation::snapshot();
+    qint64 lastStatsMs = 0;
+
+    if (statsInterval > 0) {
+        QObject::connect(&statsTimer, &QTimer::timeout, [&] {
+            const Instrumentation::Snapshot stats = Instrumentation::snapshot();
+            const qint64 now = timer.elapsed();
+
+            cds_info("Frame path statistics of last {:.1f} s:\n{}", (now - lastStatsMs) / 1000.0,
+                Instrumentation::toString(stats - lastStats, (now - lastStatsMs) / 1000.0).toStdString());
+            lastStats = stats;
+            lastStatsMs = now;
+        });
+        statsTimer.start(static_cast<int>(statsInterval * 1000));
+    }
+
+    timer.start();
+    project.startSimulation();
+    cds_info("Simulation started {} ms after start", startup.elapsed());
+
+    const quint64 simStartUs = SimClock::nowUs();
+    if ((duration > 0) && SimClock::isVirtual()) {
+        SimClock::instance().schedule(
+            &app, simStartUs + static_cast<quint64>(duration * 1000000), [] { QCoreApplication::quit(); });
+    }
+
+    const int ret = app.exec();
+
+    if (SimClock::isVirtual()) {
+        cds_info("Simulation covered {:.3f} s of virtual time", (SimClock::nowUs() - simStartUs) / 1000000.0);
+    }
+    project.stopSimulation();
+    cds_info("Simulation stopped after {:.3f} s", timer.elapsed() / 1000.0);
+
+    if (parser.isSet(statsOption)) {
+        cds_info("Frame path statistics:\n{}",
+            Instrumentation::toString(Instrumentation::snapshot(), timer.elapsed() / 1000.0).toStdString());
+    }
+
+    return ret;
+}
@@ -0,0 +1,225 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <atomic>
+#include <busstatistics.h>
+#include <catch.hpp>
+#include <context.h>
+#include <cstring>
+#include <fakeit.hpp>
+#include <gui/bsguiinterface.h>
+#include <log.h>
+#include <statstable.h>
+#include <thread>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, quint64 timestamp, quint8 flags = 0, quint8 length = 8, quint8 fill = 0)
+{
+    CanFrameRecord rec{};
+
+    rec.id = id;
+    rec.timestamp = timestamp;
+    rec.flags = flags;
+    rec.length = length;
+    std::memset(rec.payload, fill, length);
+
+    return rec;
+}
+
+const FrameStatistics* find(const std::vector<FrameStatistics>& stats, quint32 id, quint8 flags = 0)
+{
+    for (const auto& entry : stats) {
+        if ((entry.id == id) && (entry.flags == flags)) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+} // namespace
+
+TEST_CASE("Bus time includes worst case stuffing", "[busstatistics]")
+{
+    // 135 and 160 bits at 500 kbit/s
+    CHECK(frameBusTimeNs(makeRecord(1, 0), 500000, 2000000) == 270000);
+    CHECK(frameBusTimeNs(makeRecord(1, 0, CanFrameRecord::ExtendedId), 500000, 2000000) == 320000);
+    CHECK(frameBusTimeNs(makeRecord(1, 0, CanFrameRecord::Remote), 500000, 2000000) == 110000);
+
+    const auto fd = makeRecord(1, 0, CanFrameRecord::FlexibleDataRate, 64);
+    auto brs = fd;
+    brs.flags |= CanFrameRecord::BitrateSwitch;
+    CHECK(frameBusTimeNs(brs, 500000, 2000000) < frameBusTimeNs(fd, 500000, 2000000));
+}
+
+TEST_CASE("Cycle time, jitter and payload are tracked per id and direction", "[busstatistics]")
+{
+    StatsTable table;
+    const std::vector<CanFrameRecord> records{ makeRecord(0x100, 0), makeRecord(0x100, 10000),
+        makeRecord(0x100, 20000), makeRecord(0x100, 31000, 0, 2, 0xab), makeRecord(0x100, 5, CanFrameRecord::Tx),
+        makeRecord(0x100, 5, CanFrameRecord::ExtendedId), makeRecord(0, 0, CanFrameRecord::Error) };
+
+    table.update(records.data(), records.size());
+
+    CHECK(table.frameCount() == 6);
+    CHECK(table.errorFrameCount() == 1);
+    CHECK(table.busTimeNs() == 3 * 270000 + 150000 + 270000 + 320000);
+
+    const auto stats = table.snapshot();
+    REQUIRE(stats.size() == 3);
+    CHECK(find(stats, 0x100, FrameStatistics::Tx));
+    CHECK(find(stats, 0x100, FrameStatistics::Extended));
+
+    const FrameStatistics* rx = find(stats, 0x100);
+    REQUIRE(rx);
+    CHECK(rx->direction() == Direction::RX);
+    CHECK(rx->count == 4);
+    CHECK(rx->minCycle == 10000);
+    CHECK(rx->maxCycle == 11000);
+    CHECK(rx->avgCycle() == Approx(31000.0 / 3));
+    CHECK(rx->length == 2);
+    CHECK(rx->payload[1] == 0xab);
+    // Second cycle hits mean exactly, third one is 1 ms off
+    CHECK(rx->jitter[0] == 1);
+    CHECK(rx->jitter[FrameStatistics::jitterBin(1000)] == 1);
+    CHECK(rx->jitterPercentile(0.99) == 1024);
+
+    table.clear();
+    CHECK(table.snapshot().empty());
+    CHECK(table.frameCount() == 0);
+}
+
+TEST_CASE("Pairs not fitting into table are counted", "[busstatistics]")
+{
+    StatsTable table(4);
+    std::vector<CanFrameRecord> records;
+
+    for (quint32 id = 0; id < 5; ++id) {
+        records.push_back(makeRecord(id, 0));
+    }
+    table.update(records.data(), records.size());
+
+    CHECK(table.snapshot().size() == 3);
+    CHECK(table.untrackedCount() == 2);
+    CHECK(table.frameCount() == 5);
+}
+
+TEST_CASE("Snapshots taken during updates are consistent", "[busstatistics]")
+{
+    StatsTable table;
+    std::atomic<bool> done{ false };
+
+    std::thread writer([&] {
+        for (quint64 i = 1; i <= 100000; ++i) {
+            const auto rec = makeRecord(0x7ff, i * 10, 0, 8, static_cast<quint8>(i));
+            table.update(&rec, 1);
+        }
+        done = true;
+    });
+
+    int torn = 0;
+    while (!done) {
+        for (const auto& entry : table.snapshot()) {
+            torn += (entry.lastTimestamp != entry.count * 10) ? 1 : 0;
+            torn += (entry.payload[0] != static_cast<quint8>(entry.count)) ? 1 : 0;
+            torn += (entry.payload[7] != entry.payload[0]) ? 1 : 0;
+        }
+    }
+    writer.join();
+
+    CHECK(torn == 0);
+    CHECK(table.snapshot().at(0).count == 100000);
+}
+
+TEST_CASE("Component accounts frames in background thread", "[busstatistics]")
+{
+    using namespace fakeit;
+    Mock<BSGuiInterface> guiMock;
+
+    Fake(Dtor(guiMock));
+    Fake(Method(guiMock, setDockUndockCbk));
+    Fake(Method(guiMock, setStatistics));
+    When(Method(guiMock, isMainWidgetCreated)).AlwaysReturn(true);
+
+    BusStatistics statistics(BusStatisticsCtx(&guiMock.get()));
+    QJsonObject config{ { "bitrate", 250000 }, { "dataBitrate", 0 } };
+    statistics.setConfig(config);
+    CHECK(statistics.getConfig()["bitrate"].toInt() == 250000);
+    CHECK(statistics.getConfig()["dataBitrate"].toInt() == 2000000);
+
+    statistics.startSimulation();
+    statistics.frameBatchReceived({ makeRecord(0x10, 0), makeRecord(0x10, 1000) });
+    statistics.frameBatchSent(true, { makeRecord(0x20, 500, CanFrameRecord::Tx) });
+    statistics.frameBatchSent(false, { makeRecord(0x30, 600, CanFrameRecord::Tx | CanFrameRecord::TxFailed) });
+    statistics.stopSimulation();
+
+    CHECK(statistics.frameCount() == 3);
+    CHECK(statistics.statistics().size() == 2);
+    CHECK(statistics.busLoad() > 0.0);
+    Verify(Method(guiMock, setStatistics).Matching([](const std::vector<StatisticsRow>& rows, const BusSummary& s) {
+        return (rows.size() == 2) && (rows[0].stats.id == 0x10) && (s.frames == 3);
+    }));
+
+    // Previous run is forgotten
+    statistics.startSimulation();
+    statistics.stopSimulation();
+    CHECK(statistics.frameCount() == 0);
+}
+
+TEST_CASE("Transmit latency of devices is merged per id and shown with TX rows", "[busstatistics]")
+{
+    using namespace fakeit;
+    Mock<BSGuiInterface> guiMock;
+
+    Fake(Dtor(guiMock));
+    Fake(Method(guiMock, setDockUndockCbk));
+    Fake(Method(guiMock, setStatistics));
+    When(Method(guiMock, isMainWidgetCreated)).AlwaysReturn(true);
+
+    auto latency = [](quint32 id, quint64 us) {
+        TxLatencyStats stats;
+        stats.id = id;
+        stats.totalUs.add(us);
+        return stats;
+    };
+
+    BusStatistics statistics(BusStatisticsCtx(&guiMock.get()));
+    QObject device1;
+    QObject device2;
+    statistics.setTxLatencySource(&device1, [&] { return std::vector<TxLatencyStats>{ latency(0x20, 300) }; });
+    statistics.setTxLatencySource(
+        &device2, [&] { return std::vector<TxLatencyStats>{ latency(0x20, 1000), latency(0x21, 50) }; });
+
+    auto merged = statistics.txLatency();
+    REQUIRE(merged.size() == 2);
+    CHECK(merged[0].id == 0x20);
+    CHECK(merged[0].totalUs.count == 2);
+    CHECK(merged[0].totalUs.max == 1000);
+    CHECK(merged[1].totalUs.count == 1);
+
+    statistics.startSimulation();
+    statistics.frameBatchReceived({ makeRecord(0x20, 0) });
+    statistics.frameBatchSent(true, { makeRecord(0x20, 500, CanFrameRecord::Tx) });
+    statistics.stopSimulation();
+
+    Verify(Method(guiMock, setStatistics).Matching([](const std::vector<StatisticsRow>& rows, const BusSummary&) {
+        return (rows.size() == 2) && (rows[0].latencyUs.count == 0) && (rows[1].latencyUs.count == 2);
+    }));
+
+    // Removed source is not queried anymore
+    statistics.setTxLatencySource(&device2, {});
+    merged = statistics.txLatency();
+    REQUIRE(merged.size() == 1);
+    CHECK(merged[0].totalUs.count == 1);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -45,6 +45,7 @@ TEST_CASE("Calling frameReceived emits dataUpdated and outData returns that fram
     testFrame.setFrameId(123);
     QSignalSpy dataUpdatedSpy(&canDeviceModel, &CanDeviceModel::dataUpdated);
     canDeviceModel.frameReceived(testFrame);
+    QCoreApplication::processEvents(); // notifications are coalesced and delivered from event loop
 
     CHECK(dataUpdatedSpy.count() == 1);
     CHECK(std::dynamic_pointer_cast<CanDeviceDataOut>(canDeviceModel.outData(0))->frame().frameId()
@@ -58,11 +59,73 @@ TEST_CASE("Calling frameSent emits dataUpdated and outData returns that frame",
     testFrame.setFrameId(123);
     QSignalSpy dataUpdatedSpy(&canDeviceModel, &CanDeviceModel::dataUpdated);
     canDeviceModel.frameSent(true, testFrame);
+    QCoreApplication::processEvents(); // notifications are coalesced and delivered from event loop
     CHECK(dataUpdatedSpy.count() == 1);
     CHECK(std::dynamic_pointer_cast<CanDeviceDataOut>(canDeviceModel.outData(0))->frame().frameId()
         == testFrame.frameId());
 }
 
+TEST_CASE("Calling frameBatchReceived emits dataUpdated once for whole batch", "[candevice]")
+{
+    CanDeviceModel canDeviceModel;
+    QVector<QCanBusFrame> frames{ QCanBusFrame{ 0x11, QByteArray{} }, QCanBusFrame{ 0x22, QByteArray{} } };
+    QSignalSpy dataUpdatedSpy(&canDeviceModel, &CanDeviceModel::dataUpdated);
+    canDeviceModel.frameBatchReceived(frames);
+    QCoreApplication::processEvents();
+
+    CHECK(dataUpdatedSpy.count() == 1);
+    auto data = std::dynamic_pointer_cast<CanDeviceDataOut>(canDeviceModel.outData(0));
+    REQUIRE(data->records().size() == 2);
+    CHECK(data->records()[1].id == 0x22);
+    CHECK(data->direction() == Direction::RX);
+}
+
+TEST_CASE("outData returns the same shared data until new frames arrive", "[candevice]")
+{
+    CanDeviceModel canDeviceModel;
+    canDeviceModel.frameReceived(QCanBusFrame{ 0x11, QByteArray{ "\x01\x02" } });
+    QCoreApplication::processEvents();
+
+    auto first = canDeviceModel.outData(0);
+    CHECK(first == canDeviceModel.outData(0));
+
+    canDeviceModel.frameReceived(QCanBusFrame{ 0x22, QByteArray{} });
+    QCoreApplication::processEvents();
+    CHECK(first != canDeviceModel.outData(0));
+}
+
+TEST_CASE("Burst of frames results in single propagation pass", "[candevice]")
+{
+    CanDeviceModel canDeviceModel;
+    QSignalSpy dataUpdatedSpy(&canDeviceModel, &CanDeviceModel::dataUpdated);
+
+    for (int i = 0; i < 100; ++i) {
+        canDeviceModel.frameReceived(QCanBusFrame{ static_cast<quint32>(i), QByteArray{} });
+    }
+    CHECK(dataUpdatedSpy.count() == 0);
+
+    QCoreApplication::processEvents();
+    CHECK(dataUpdatedSpy.count() == 1);
+    auto data = std::dynamic_pointer_cast<CanDeviceDataOut>(canDeviceModel.outData(0));
+    REQUIRE(data->records().size() == 100);
+    CHECK(data->records()[99].id == 99);
+}
+
+TEST_CASE("Mixed directions are propagated as separate batches", "[candevice]")
+{
+    CanDeviceModel canDeviceModel;
+    QSignalSpy dataUpdatedSpy(&canDeviceModel, &CanDeviceModel::dataUpdated);
+
+    canDeviceModel.frameReceived(QCanBusFrame{ 0x1, QByteArray{} });
+    canDeviceModel.frameSent(false, QCanBusFrame{ 0x2, QByteArray{} });
+    QCoreApplication::processEvents();
+
+    CHECK(dataUpdatedSpy.count() == 2);
+    auto data = std::dynamic_pointer_cast<CanDeviceDataOut>(canDeviceModel.outData(0));
+    CHECK(data->direction() == Direction::TX);
+    CHECK(data->status() == false);
+}
+
 TEST_CASE("Calling setInData will result in sendFrame being emitted", "[candevice]")
 {
     CanDeviceModel canDeviceModel;
@@ -76,6 +139,27 @@ TEST_CASE("Calling setInData will result in sendFrame being emitted", "[candevic
     CHECK(qvariant_cast<QCanBusFrame>(sendFrameSpy.takeFirst().at(0)).frameId() == testFrame.frameId());
 }
 
+TEST_CASE("Batch passed to setInData is sent with single sendFrames", "[candevice]")
+{
+    CanDeviceModel canDeviceModel;
+    CanFrameBatch batch{ toCanFrameRecord(QCanBusFrame{ 0x1, QByteArray{} }),
+        toCanFrameRecord(QCanBusFrame{ 0x2, QByteArray{} }) };
+    QSignalSpy sendFrameSpy(&canDeviceModel, &CanDeviceModel::sendFrame);
+    QVector<QCanBusFrame> sent;
+    int calls = 0;
+
+    QObject::connect(&canDeviceModel, &CanDeviceModel::sendFrames, [&](const QVector<QCanBusFrame>& frames) {
+        sent = frames;
+        ++calls;
+    });
+
+    canDeviceModel.setInData(std::make_shared<CanDeviceDataIn>(batch), 0);
+    CHECK(sendFrameSpy.count() == 0);
+    CHECK(calls == 1);
+    REQUIRE(sent.size() == 2);
+    CHECK(sent[1].frameId() == 0x2);
+}
+
 TEST_CASE("Test save configuration", "[candevice]")
 {
     CanDeviceModel canDeviceModel;
@@ -1,3 +1,4 @@
+#include <candevice/canbackendcatalog.h>
 #include <candevice/candeviceqt.h>
 #include <catch.hpp>
 
@@ -20,3 +21,16 @@ TEST_CASE("Uninitialized device", "[candeviceqt]")
     REQUIRE_THROWS(dev.readFrame());
     REQUIRE_THROWS(dev.framesAvailable());
 }
+
+TEST_CASE("Backend discovery lists built-in backends", "[candeviceqt]")
+{
+    CanBackendCatalog::prefetch();
+
+    const auto backends = CanBackendCatalog::backends();
+
+    CHECK(CanBackendCatalog::isReady());
+    CHECK(CanBackendCatalog::waitUntilReady() < 1000);
+    REQUIRE(!backends.isEmpty());
+    CHECK(backends.front().name == SyntheticCanBusDevice::kBackendName);
+    CHECK(CanBackendCatalog::interfaces("no such backend").isEmpty());
+}
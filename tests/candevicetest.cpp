@@ -5,9 +5,11 @@
 #define CATCH_CONFIG_RUNNER
 #include <QSignalSpy>
 #include <QtSerialBus/QCanBusDevice>
+#include <canframerecord.h>
 #include <candeviceinterface.h>
 #include <context.h>
 #include <fakeit.hpp>
+#include <instrumentation.h>
 #include <log.h>
 
 std::shared_ptr<spdlog::logger> kDefaultLogger;
@@ -224,6 +226,145 @@ TEST_CASE("Emits all available frames when notified by backend", "[candevice]")
     }
 }
 
+TEST_CASE("Emits one batch with all frames read in a single drain", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+
+    const std::vector<QCanBusFrame> frames{ QCanBusFrame{ 0x123, QByteArray{ "\x01\x02" } },
+        QCanBusFrame{ 0x456, QByteArray{ "\x03" } }, QCanBusFrame{ 0x789, QByteArray{ "\x04\x05\x06" } } };
+    auto currentFrame = frames.begin();
+    CanDeviceInterface::framesReceived_t receivedCbk;
+
+    Fake(Dtor(deviceMock));
+    Fake(Method(deviceMock, setFramesWrittenCbk));
+    When(Method(deviceMock, setFramesReceivedCbk)).Do([&](auto&& fn) { receivedCbk = fn; });
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    When(Method(deviceMock, init)).Return(true);
+
+    When(Method(deviceMock, framesAvailable)).AlwaysDo([&]() { return std::distance(currentFrame, frames.end()); });
+    When(Method(deviceMock, readFrame)).AlwaysDo([&]() { return *currentFrame++; });
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    QSignalSpy batchSpy(&canDevice, &CanDevice::frameBatchReceived);
+    CHECK(canDevice.init("", "") == true);
+
+    receivedCbk();
+    REQUIRE(batchSpy.count() == 1);
+    const auto batch = qvariant_cast<QVector<QCanBusFrame>>(batchSpy.takeFirst().at(0));
+    REQUIRE(batch.size() == static_cast<int>(frames.size()));
+    for (auto i = 0u; i < frames.size(); ++i) {
+        CHECK(isEqual(batch[i], frames[i]));
+    }
+}
+
+TEST_CASE("Received frames are stamped unless backend provides timestamp", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+
+    QCanBusFrame stamped{ 0x1, QByteArray{ "\x01" } };
+    stamped.setTimeStamp(QCanBusFrame::TimeStamp(10, 20));
+    const std::vector<QCanBusFrame> frames{ stamped, QCanBusFrame{ 0x2, QByteArray{ "\x02" } } };
+    auto currentFrame = frames.begin();
+    CanDeviceInterface::framesReceived_t receivedCbk;
+
+    Fake(Dtor(deviceMock));
+    Fake(Method(deviceMock, setFramesWrittenCbk));
+    When(Method(deviceMock, setFramesReceivedCbk)).Do([&](auto&& fn) { receivedCbk = fn; });
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    When(Method(deviceMock, init)).Return(true);
+
+    When(Method(deviceMock, framesAvailable)).AlwaysDo([&]() { return std::distance(currentFrame, frames.end()); });
+    When(Method(deviceMock, readFrame)).AlwaysDo([&]() { return *currentFrame++; });
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    QSignalSpy batchSpy(&canDevice, &CanDevice::frameBatchReceived);
+    CHECK(canDevice.init("", "") == true);
+
+    const quint64 before = canTimestampNow();
+    receivedCbk();
+    REQUIRE(batchSpy.count() == 1);
+    const auto batch = qvariant_cast<QVector<QCanBusFrame>>(batchSpy.takeFirst().at(0));
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[0].timeStamp().seconds() == 10);
+    CHECK(batch[0].timeStamp().microSeconds() == 20);
+    CHECK(toCanFrameRecord(batch[1]).timestamp >= before);
+}
+
+TEST_CASE("framesWritten retires as many frames as reported by backend", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+    CanDeviceInterface::framesWritten_t writtenCbk;
+
+    Fake(Dtor(deviceMock));
+    When(Method(deviceMock, setFramesWrittenCbk)).Do([&](auto&& fn) { writtenCbk = fn; });
+    Fake(Method(deviceMock, setFramesReceivedCbk));
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    When(Method(deviceMock, writeFrame)).AlwaysReturn(true);
+    When(Method(deviceMock, init)).Return(true);
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    QSignalSpy batchSpy(&canDevice, &CanDevice::frameBatchSent);
+    QSignalSpy frameSentSpy(&canDevice, &CanDevice::frameSent);
+    CHECK(canDevice.init("", "") == true);
+
+    canDevice.sendFrame(QCanBusFrame{ 0x1, QByteArray{ "\x01" } });
+    canDevice.sendFrame(QCanBusFrame{ 0x2, QByteArray{ "\x02" } });
+    canDevice.sendFrame(QCanBusFrame{ 0x3, QByteArray{ "\x03" } });
+    writtenCbk(2);
+
+    REQUIRE(batchSpy.count() == 1);
+    auto args = batchSpy.takeFirst();
+    CHECK(args.at(0) == true);
+    const auto batch = qvariant_cast<QVector<QCanBusFrame>>(args.at(1));
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[0].frameId() == 0x1);
+    CHECK(batch[1].frameId() == 0x2);
+    CHECK(frameSentSpy.count() == 2);
+}
+
+TEST_CASE("sendFrames writes batch and reports rejected frames once", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+    CanDeviceInterface::framesWritten_t writtenCbk;
+
+    Fake(Dtor(deviceMock));
+    When(Method(deviceMock, setFramesWrittenCbk)).Do([&](auto&& fn) { writtenCbk = fn; });
+    Fake(Method(deviceMock, setFramesReceivedCbk));
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    When(Method(deviceMock, writeFrames)).Return(2);
+    When(Method(deviceMock, init)).Return(true);
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    QSignalSpy batchSpy(&canDevice, &CanDevice::frameBatchSent);
+    CHECK(canDevice.init("", "") == true);
+
+    canDevice.sendFrames({ QCanBusFrame{ 0x1, QByteArray{ "\x01" } }, QCanBusFrame{ 0x2, QByteArray{ "\x02" } },
+        QCanBusFrame{ 0x3, QByteArray{ "\x03" } }, QCanBusFrame{ 0x4, QByteArray{ "\x04" } } });
+    Verify(Method(deviceMock, writeFrames)).Once();
+
+    REQUIRE(batchSpy.count() == 1);
+    auto args = batchSpy.takeFirst();
+    CHECK(args.at(0) == false);
+    auto batch = qvariant_cast<QVector<QCanBusFrame>>(args.at(1));
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[0].frameId() == 0x3);
+    CHECK(batch[1].frameId() == 0x4);
+
+    // Only accepted frames are waiting for confirmation
+    writtenCbk(4);
+    REQUIRE(batchSpy.count() == 1);
+    args = batchSpy.takeFirst();
+    CHECK(args.at(0) == true);
+    batch = qvariant_cast<QVector<QCanBusFrame>>(args.at(1));
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[0].frameId() == 0x1);
+    CHECK(batch[1].frameId() == 0x2);
+}
+
 TEST_CASE("WriteError causes emitting frameSent with framSent=false", "[candevice]")
 {
     using namespace fakeit;
@@ -252,6 +393,206 @@ TEST_CASE("WriteError causes emitting frameSent with framSent=false", "[candevic
     CHECK(isEqual(qvariant_cast<QCanBusFrame>(args.at(1)), frame));
 }
 
+TEST_CASE("Configuration is applied on simulation start", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+
+    Fake(Dtor(deviceMock));
+    Fake(Method(deviceMock, setFramesWrittenCbk));
+    Fake(Method(deviceMock, setFramesReceivedCbk));
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    Fake(Method(deviceMock, setConfigurationParameter));
+    Fake(Method(deviceMock, disconnectDevice));
+    When(Method(deviceMock, init)).Return(true);
+    When(Method(deviceMock, connectDevice)).Return(true);
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    QJsonObject config;
+    config["backend"] = "virtualcan";
+    config["interface"] = "can3";
+    config["ioThread"] = false;
+    config["bitrate"] = 500000;
+    config["receiveOwn"] = true;
+    config["name"] = "CanDeviceModel";
+    canDevice.setConfig(config);
+
+    const auto saved = canDevice.getConfig();
+    CHECK(saved["interface"].toString() == "can3");
+    CHECK(saved["bitrate"].toInt() == 500000);
+    CHECK(saved.contains("name") == false);
+
+    Verify(Method(deviceMock, init)).Never();
+    canDevice.startSimulation();
+
+    Verify(Method(deviceMock, init).Using("virtualcan", "can3")).Once();
+    Verify(Method(deviceMock, setConfigurationParameter).Using(QCanBusDevice::BitRateKey, QVariant(500000))).Once();
+    Verify(Method(deviceMock, setConfigurationParameter).Using(QCanBusDevice::ReceiveOwnKey, QVariant(true))).Once();
+    Verify(Method(deviceMock, connectDevice)).Once();
+
+    // Configuration is not applied again if it did not change
+    canDevice.stopSimulation();
+    canDevice.startSimulation();
+    Verify(Method(deviceMock, init)).Once();
+}
+
+TEST_CASE("Acceptance filters are installed on simulation start", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+    QVariant installed;
+
+    Fake(Dtor(deviceMock));
+    Fake(Method(deviceMock, setFramesWrittenCbk));
+    Fake(Method(deviceMock, setFramesReceivedCbk));
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    When(Method(deviceMock, setConfigurationParameter)).AlwaysDo([&](int key, const QVariant& value) {
+        if (key == QCanBusDevice::RawFilterKey) {
+            installed = value;
+        }
+    });
+    Fake(Method(deviceMock, disconnectDevice));
+    When(Method(deviceMock, init)).Return(true);
+    When(Method(deviceMock, connectDevice)).Return(true);
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    CHECK(canDevice.init("", "") == true);
+
+    // Nothing is installed as long as all frames are accepted
+    canDevice.startSimulation();
+    CHECK(installed.isValid() == false);
+    canDevice.stopSimulation();
+
+    canDevice.setAcceptanceFilters({ makeCanFilter(0x123, 0x7ff) });
+    canDevice.startSimulation();
+    auto filters = installed.value<CanFilterList>();
+    REQUIRE(filters.size() == 1);
+    CHECK(filters[0].frameId == 0x123);
+    canDevice.stopSimulation();
+
+    // Filter matching everything replaces previously installed filters
+    canDevice.setAcceptanceFilters({});
+    canDevice.startSimulation();
+    filters = installed.value<CanFilterList>();
+    REQUIRE(filters.size() == 1);
+    CHECK(filters[0].frameIdMask == 0);
+
+    // Consumer connected while simulation runs gets its filters installed at once
+    canDevice.setAcceptanceFilters({ makeCanFilter(0x200, 0x7ff) });
+    filters = installed.value<CanFilterList>();
+    REQUIRE(filters.size() == 1);
+    CHECK(filters[0].frameId == 0x200);
+}
+
+TEST_CASE("Transmit latency is recorded per id from request to confirmation", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+    CanDeviceInterface::framesWritten_t writtenCbk;
+
+    Fake(Dtor(deviceMock));
+    When(Method(deviceMock, setFramesWrittenCbk)).Do([&](auto&& fn) { writtenCbk = fn; });
+    Fake(Method(deviceMock, setFramesReceivedCbk));
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    When(Method(deviceMock, writeFrame)).AlwaysReturn(true);
+    When(Method(deviceMock, init)).Return(true);
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    CHECK(canDevice.init("", "") == true);
+    const auto before = Instrumentation::snapshot();
+
+    canDevice.sendFrame(QCanBusFrame{ 0x1, QByteArray{ "\x01" } });
+    canDevice.sendFrame(QCanBusFrame{ 0x2, QByteArray{ "\x02" } });
+    canDevice.sendFrame(QCanBusFrame{ 0x1, QByteArray{ "\x03" } });
+
+    // Frames not confirmed yet are not accounted
+    CHECK(canDevice.txLatencyStats().empty());
+
+    writtenCbk(3);
+    const auto stats = canDevice.txLatencyStats();
+    REQUIRE(stats.size() == 2);
+    CHECK(stats[0].id == 0x1);
+    CHECK(stats[0].totalUs.count == 2);
+    CHECK(stats[0].totalUs.sum == stats[0].handoffUs.sum + stats[0].confirmUs.sum);
+    CHECK(stats[1].id == 0x2);
+    CHECK(stats[1].totalUs.count == 1);
+
+    const auto delta = Instrumentation::snapshot() - before;
+    CHECK(delta.histogram(Instrumentation::Histogram::TxLatencyUs).count == 3);
+    CHECK(delta.histogram(Instrumentation::Histogram::TxHandoffUs).count == 3);
+}
+
+TEST_CASE("Transmit queue writes frames in arbitration order", "[candevice]")
+{
+    using namespace fakeit;
+    Mock<CanDeviceInterface> deviceMock;
+    CanDeviceInterface::framesWritten_t writtenCbk;
+    std::vector<QVector<QCanBusFrame>> written;
+
+    Fake(Dtor(deviceMock));
+    When(Method(deviceMock, setFramesWrittenCbk)).Do([&](auto&& fn) { writtenCbk = fn; });
+    Fake(Method(deviceMock, setFramesReceivedCbk));
+    Fake(Method(deviceMock, setErrorOccurredCbk));
+    Fake(Method(deviceMock, setConfigurationParameter));
+    Fake(Method(deviceMock, disconnectDevice));
+    When(Method(deviceMock, writeFrames)).AlwaysDo([&](const QVector<QCanBusFrame>& frames) {
+        written.push_back(frames);
+        return static_cast<qint64>(frames.size());
+    });
+    When(Method(deviceMock, init)).Return(true);
+    When(Method(deviceMock, connectDevice)).Return(true);
+
+    CanDevice canDevice{ CanDeviceCtx(&deviceMock.get()) };
+    QSignalSpy batchSpy(&canDevice, &CanDevice::frameBatchSent);
+    QJsonObject config;
+    config["backend"] = "virtualcan";
+    config["interface"] = "can0";
+    config["ioThread"] = false;
+    config["txQueue"] = QJsonObject{ { "inFlight", 2 } };
+    canDevice.setConfig(config);
+    canDevice.startSimulation();
+
+    canDevice.sendFrames({ QCanBusFrame{ 0x300, QByteArray{ "\x03" } }, QCanBusFrame{ 0x100, QByteArray{ "\x01" } },
+        QCanBusFrame{ 0x200, QByteArray{ "\x02" } }, QCanBusFrame{ 0x050, QByteArray{ "\x00" } } });
+
+    // Only frames with highest priority are handed to backend
+    REQUIRE(written.size() == 1);
+    REQUIRE(written[0].size() == 2);
+    CHECK(written[0][0].frameId() == 0x050);
+    CHECK(written[0][1].frameId() == 0x100);
+    CHECK(batchSpy.count() == 0);
+
+    writtenCbk(2);
+    REQUIRE(batchSpy.count() == 1);
+    auto args = batchSpy.takeFirst();
+    CHECK(args.at(0) == true);
+    auto batch = qvariant_cast<QVector<QCanBusFrame>>(args.at(1));
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[0].frameId() == 0x050);
+    CHECK(batch[1].frameId() == 0x100);
+
+    REQUIRE(written.size() == 2);
+    REQUIRE(written[1].size() == 2);
+    CHECK(written[1][0].frameId() == 0x200);
+    CHECK(written[1][1].frameId() == 0x300);
+
+    // Frame waiting for room in backend is reported as failed when simulation stops
+    canDevice.sendFrame(QCanBusFrame{ 0x010, QByteArray{ "\x10" } });
+    CHECK(written.size() == 2);
+    canDevice.stopSimulation();
+    REQUIRE(batchSpy.count() == 1);
+    args = batchSpy.takeFirst();
+    CHECK(args.at(0) == false);
+    batch = qvariant_cast<QVector<QCanBusFrame>>(args.at(1));
+    REQUIRE(batch.size() == 1);
+    CHECK(batch[0].frameId() == 0x010);
+
+    const auto stats = canDevice.txQueueStats();
+    REQUIRE(stats.size() == 1);
+    CHECK(stats[0].queued == 5);
+    CHECK(stats[0].residencyUs.count == 4);
+}
+
 int main(int argc, char* argv[])
 {
     bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
@@ -261,5 +602,6 @@ int main(int argc, char* argv[])
     }
     cds_debug("Staring unit tests");
     qRegisterMetaType<QCanBusFrame>(); // required by QSignalSpy
+    qRegisterMetaType<QVector<QCanBusFrame>>(); // required by QSignalSpy
     return Catch::Session().run(argc, argv);
 }
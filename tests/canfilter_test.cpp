@@ -0,0 +1,40 @@
+#include <canfilter.h>
+#include <catch.hpp>
+
+TEST_CASE("Filters survive json round trip", "[canfilter]")
+{
+    CanFilterList filters{ makeCanFilter(0x123, 0x7ff), makeCanFilter(0x18DA0000, 0x1fff0000) };
+    filters[0].format = QCanBusDevice::Filter::MatchBaseFormat;
+
+    const auto back = canFiltersFromJson(canFiltersToJson(filters));
+    REQUIRE(back.size() == 2);
+    CHECK(back[0].frameId == 0x123);
+    CHECK(back[0].frameIdMask == 0x7ff);
+    CHECK(back[0].format == QCanBusDevice::Filter::MatchBaseFormat);
+    CHECK(back[1].frameId == 0x18DA0000);
+    CHECK(back[1].format == QCanBusDevice::Filter::MatchBaseAndExtendedFormat);
+}
+
+TEST_CASE("Consumer accepting all frames disables filtering", "[canfilter]")
+{
+    CHECK(mergeCanFilters({}).isEmpty());
+    CHECK(mergeCanFilters({ { makeCanFilter(0x1, 0x7ff) }, {} }).isEmpty());
+}
+
+TEST_CASE("Filters of consumers are merged without duplicates", "[canfilter]")
+{
+    const auto merged = mergeCanFilters({ { makeCanFilter(0x1, 0x7ff), makeCanFilter(0x2, 0x7ff) },
+        { makeCanFilter(0x2, 0x7ff), makeCanFilter(0x3, 0x7ff) } });
+
+    REQUIRE(merged.size() == 3);
+    CHECK(merged[2].frameId == 0x3);
+}
+
+TEST_CASE("Frame id is matched against id and mask", "[canfilter]")
+{
+    const CanFilterList filters{ makeCanFilter(0x100, 0x700) };
+
+    CHECK(canFiltersAccept({}, 0x555, false));
+    CHECK(canFiltersAccept(filters, 0x1ab, false));
+    CHECK(canFiltersAccept(filters, 0x2ab, false) == false);
+}
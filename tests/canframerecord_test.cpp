@@ -0,0 +1,76 @@
+#include <canframerecord.h>
+#include <catch.hpp>
+#include <hexformat.h>
+
+TEST_CASE("CanFrameRecord round trip keeps frame content", "[canframerecord]")
+{
+    QCanBusFrame frame(0x18DAF110, QByteArray("\x01\x02\x03\x04\x05", 5));
+    frame.setTimeStamp(QCanBusFrame::TimeStamp(12, 345678));
+
+    const auto rec = toCanFrameRecord(frame, Direction::TX);
+    CHECK(rec.id == 0x18DAF110);
+    CHECK(rec.length == 5);
+    CHECK(rec.payload[4] == 0x05);
+    CHECK(rec.timestamp == 12345678ULL);
+    CHECK(rec.hasFlag(CanFrameRecord::ExtendedId));
+    CHECK(rec.direction() == Direction::TX);
+
+    const auto back = toQCanBusFrame(rec);
+    CHECK(back.frameId() == frame.frameId());
+    CHECK(back.payload() == frame.payload());
+    CHECK(back.hasExtendedFrameFormat());
+    CHECK(back.timeStamp().seconds() == 12);
+    CHECK(back.timeStamp().microSeconds() == 345678);
+}
+
+TEST_CASE("CanFrameRecord marks remote frames", "[canframerecord]")
+{
+    QCanBusFrame frame(0x123, QByteArray());
+    frame.setFrameType(QCanBusFrame::RemoteRequestFrame);
+
+    const auto rec = toCanFrameRecord(frame);
+    CHECK(rec.hasFlag(CanFrameRecord::Remote));
+    CHECK(rec.direction() == Direction::RX);
+    CHECK(toQCanBusFrame(rec).frameType() == QCanBusFrame::RemoteRequestFrame);
+}
+
+TEST_CASE("CanFrameBatch converts all frames", "[canframerecord]")
+{
+    QVector<QCanBusFrame> frames{ QCanBusFrame(0x1, QByteArray()), QCanBusFrame(0x2, QByteArray("\xff", 1)) };
+    const auto batch = toCanFrameBatch(frames, Direction::RX);
+
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[1].id == 0x2);
+    CHECK(batch[1].payload[0] == 0xff);
+}
+
+TEST_CASE("canFdLength rounds up to FD DLC steps", "[canframerecord]")
+{
+    CHECK(canFdLength(0) == 0);
+    CHECK(canFdLength(8) == 8);
+    CHECK(canFdLength(9) == 12);
+    CHECK(canFdLength(33) == 48);
+    CHECK(canFdLength(64) == 64);
+    CHECK(canFdLength(100) == 64);
+}
+
+TEST_CASE("canFrameFlagsText lists frame format flags", "[canframerecord]")
+{
+    CHECK(canFrameFlagsText(0).isEmpty());
+    CHECK(canFrameFlagsText(CanFrameRecord::FlexibleDataRate | CanFrameRecord::BitrateSwitch) == "FD BRS");
+    CHECK(canFrameFlagsText(CanFrameRecord::ExtendedId | CanFrameRecord::Remote) == "EXT RTR");
+}
+
+TEST_CASE("payloadToHex formats full FD payload", "[canframerecord]")
+{
+    quint8 data[CanFrameRecord::kMaxPayload];
+    for (int i = 0; i < CanFrameRecord::kMaxPayload; ++i) {
+        data[i] = static_cast<quint8>(i * 4);
+    }
+
+    const auto text = HexFormat::payloadToHex(data, CanFrameRecord::kMaxPayload);
+    CHECK(text.size() == CanFrameRecord::kMaxPayload * 3 - 1);
+    CHECK(text.startsWith("00 04 08"));
+    CHECK(text.endsWith("f8 fc"));
+    CHECK(HexFormat::payloadToHex(data, 0).isEmpty());
+}
@@ -1,11 +1,12 @@
+#include <QFile>
 #include <QJsonArray>
 #include <QStandardItemModel>
+#include <QTemporaryDir>
 #include <canrawsender.h>
 #include <context.h>
 #include <fakeit.hpp>
 #include <gui/crsguiinterface.h>
 #include <memory>
-#include <newlinemanager.h>
 
 TEST_CASE("Add and remove frame test", "[canrawsender]")
 {
@@ -36,45 +37,22 @@ TEST_CASE("Add and remove frame test", "[canrawsender]")
 
     Mock<CRSGuiInterface> crsMock;
 
-    Mock<CheckBoxInterface> nlmCheckBoxMock;
-    Mock<LineEditInterface> nlmLineEditMock;
-    Mock<PushButtonInterface> nlmPushButtonMock;
-
-    Mock<NLMFactoryInterface> nlmFactoryMock;
-    Fake(Dtor(nlmFactoryMock));
     helpTestClass mHelp;
 
-    Fake(Dtor(nlmLineEditMock));
-    Fake(Method(nlmLineEditMock, textChangedCbk));
-    Fake(Method(nlmLineEditMock, init));
-    Fake(Method(nlmLineEditMock, setPlaceholderText));
-    Fake(Method(nlmLineEditMock, setDisabled));
-    When(Method(nlmLineEditMock, getMainWidget)).AlwaysDo([&]() {
-        return reinterpret_cast<QWidget*>(&nlmLineEditMock.get());
-    });
-    When(Method(nlmFactoryMock, createLineEdit)).AlwaysDo([&]() { return &nlmLineEditMock.get(); });
-
-    Fake(Dtor(nlmCheckBoxMock));
-    Fake(Method(nlmCheckBoxMock, releasedCbk));
-    When(Method(nlmCheckBoxMock, getMainWidget)).Return(reinterpret_cast<QWidget*>(&nlmCheckBoxMock.get()));
-    When(Method(nlmFactoryMock, createCheckBox)).Return(&nlmCheckBoxMock.get());
-
-    Fake(Dtor(nlmPushButtonMock));
-    Fake(Method(nlmPushButtonMock, init));
-    Fake(Method(nlmPushButtonMock, pressedCbk));
-    When(Method(nlmPushButtonMock, getMainWidget)).Return(reinterpret_cast<QWidget*>(&nlmPushButtonMock.get()));
-    When(Method(nlmFactoryMock, createPushButton)).Return(&nlmPushButtonMock.get());
-
     Fake(Dtor(crsMock));
     When(Method(crsMock, setAddCbk)).Do([&](auto&& fn) { addLineCbk = fn; });
     When(Method(crsMock, setRemoveCbk)).Do([&](auto&& fn) { removeLineCbk = fn; });
     Fake(Method(crsMock, setDockUndockCbk));
+    Fake(Method(crsMock, setImportCbk));
+    Fake(Method(crsMock, setStartCyclicCbk));
+    Fake(Method(crsMock, setFloodCbk));
+    Fake(Method(crsMock, setFloodEnabled));
+    Fake(Method(crsMock, setFloodStatus));
     Fake(Method(crsMock, getMainWidget));
     Fake(Method(crsMock, initTableView));
     When(Method(crsMock, getSelectedRows)).Do([&]() { return mHelp.getList(); });
-    Fake(Method(crsMock, setIndexWidget));
 
-    CanRawSender canRawSender{ CanRawSenderCtx(&crsMock.get(), &nlmFactoryMock.get()) };
+    CanRawSender canRawSender{ CanRawSenderCtx(&crsMock.get()) };
 
     CHECK(canRawSender.getLineCount() == 0);
     addLineCbk();
@@ -83,7 +61,7 @@ TEST_CASE("Add and remove frame test", "[canrawsender]")
     CHECK(canRawSender.getLineCount() == 0);
 }
 
-TEST_CASE("Can raw sender save configuration test", "[newlinemanager]")
+TEST_CASE("Can raw sender save configuration test", "[canrawsender]")
 {
     using namespace fakeit;
 
@@ -92,15 +70,16 @@ TEST_CASE("Can raw sender save configuration test", "[newlinemanager]")
     Fake(Method(crsMock, setAddCbk));
     Fake(Method(crsMock, setRemoveCbk));
     Fake(Method(crsMock, setDockUndockCbk));
+    Fake(Method(crsMock, setImportCbk));
+    Fake(Method(crsMock, setStartCyclicCbk));
+    Fake(Method(crsMock, setFloodCbk));
+    Fake(Method(crsMock, setFloodEnabled));
+    Fake(Method(crsMock, setFloodStatus));
     Fake(Method(crsMock, getMainWidget));
     Fake(Method(crsMock, initTableView));
     Fake(Method(crsMock, getSelectedRows));
-    Fake(Method(crsMock, setIndexWidget));
-
-    Mock<NLMFactoryInterface> nlmFactoryMock;
-    Fake(Dtor(nlmFactoryMock));
 
-    CanRawSender canRawSender{ CanRawSenderCtx(&crsMock.get(), &nlmFactoryMock.get()) };
+    CanRawSender canRawSender{ CanRawSenderCtx(&crsMock.get()) };
 
     QJsonObject json = canRawSender.getConfig();
 
@@ -125,3 +104,48 @@ TEST_CASE("Can raw sender save configuration test", "[newlinemanager]")
     const auto sortObj = json["sorting"].toObject();
     CHECK(sortObj.contains("currentIndex") == true);
 }
+
+TEST_CASE("Can raw sender restores configuration and imports schedule", "[canrawsender]")
+{
+    using namespace fakeit;
+
+    Mock<CRSGuiInterface> crsMock;
+    Fake(Dtor(crsMock));
+    Fake(Method(crsMock, setAddCbk));
+    Fake(Method(crsMock, setRemoveCbk));
+    Fake(Method(crsMock, setDockUndockCbk));
+    Fake(Method(crsMock, setImportCbk));
+    Fake(Method(crsMock, setStartCyclicCbk));
+    Fake(Method(crsMock, setFloodCbk));
+    Fake(Method(crsMock, setFloodEnabled));
+    Fake(Method(crsMock, setFloodStatus));
+    Fake(Method(crsMock, getMainWidget));
+    Fake(Method(crsMock, initTableView));
+    Fake(Method(crsMock, getSelectedRows));
+
+    CanRawSender canRawSender{ CanRawSenderCtx(&crsMock.get()) };
+    QJsonObject json{ { "content",
+        QJsonArray{ QJsonObject{ { "id", "12" }, { "data", "00" }, { "interval", "10" }, { "loop", 1 } },
+            QJsonObject{ { "id", "13" }, { "data", "" }, { "interval", "" }, { "loop", 0 } } } } };
+
+    canRawSender.setConfig(json);
+    REQUIRE(canRawSender.getLineCount() == 2);
+    CHECK(canRawSender.getConfig()["content"].toArray() == json["content"].toArray());
+
+    QTemporaryDir dir;
+    QFile file(dir.path() + "/schedule.csv");
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write("100;0102;10\n101;;\n102;;20\n");
+    file.close();
+
+    QString error;
+    REQUIRE(canRawSender.importSchedule(file.fileName(), error));
+    CHECK(canRawSender.getLineCount() == 3);
+    CHECK(canRawSender.startCyclic() == 0);
+    canRawSender.startSimulation();
+    CHECK(canRawSender.startCyclic() == 2);
+    canRawSender.stopSimulation();
+
+    CHECK(!canRawSender.importSchedule(dir.path() + "/missing.csv", error));
+    CHECK(canRawSender.getLineCount() == 3);
+}
@@ -52,6 +52,21 @@ TEST_CASE("Test save configuration", "[canrawsender]")
     CHECK(json.find("sorting") != json.end());
 }
 
+TEST_CASE("Main widget is built when requested for the first time", "[canrawsender]")
+{
+    CanRawSenderModel canRawSenderModel;
+    auto& component = canRawSenderModel.getComponent();
+
+    canRawSenderModel.save();
+    CHECK(!component.mainWidgetCreated());
+
+    QWidget* widget = component.getMainWidget();
+    REQUIRE(widget != nullptr);
+    CHECK(widget->windowTitle() == "CANrawSender");
+    CHECK(component.mainWidgetCreated());
+    CHECK(component.getMainWidget() == widget);
+}
+
 int main(int argc, char* argv[])
 {
     bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
@@ -1,4 +1,5 @@
 #include <QtWidgets/QApplication>
+#include <QtCore/QJsonArray>
 #include <projectconfig/canrawviewmodel.h>
 #include <datamodeltypes/canrawviewdata.h>
 #define CATCH_CONFIG_RUNNER
@@ -60,6 +61,20 @@ TEST_CASE("Calling setInData with direction RX will result in frameReceived bein
     CHECK(qvariant_cast<QCanBusFrame>(frameReceivedSpy.takeFirst().at(0)).frameId() == testFrame.frameId());
 }
 
+TEST_CASE("Calling setInData with batch emits frameBatchReceived once", "[canrawview]")
+{
+    CanRawViewModel canRawViewModel;
+    QVector<QCanBusFrame> frames{ QCanBusFrame{ 0x11, QByteArray{} }, QCanBusFrame{ 0x22, QByteArray{} } };
+    auto canRawViewDataIn = std::make_shared<CanRawViewDataIn>(frames, Direction::RX, true);
+    QSignalSpy batchSpy(&canRawViewModel, &CanRawViewModel::frameBatchReceived);
+
+    canRawViewModel.setInData(canRawViewDataIn, 0);
+    REQUIRE(batchSpy.count() == 1);
+    const auto batch = qvariant_cast<CanFrameBatch>(batchSpy.takeFirst().at(0));
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[1].id == 0x22);
+}
+
 TEST_CASE("Test save configuration", "[canrawview]")
 {
     CanRawViewModel canRawViewModel;
@@ -67,8 +82,83 @@ TEST_CASE("Test save configuration", "[canrawview]")
     CHECK(json.find("name") != json.end());
     CHECK(json.find("columns") != json.end());
     CHECK(json.find("scrolling") != json.end());
-    CHECK(json.find("models") != json.end());
     CHECK(json.find("sorting") != json.end());
+    // View contents are not embedded in project anymore
+    CHECK(json.find("models") == json.end());
+    // Empty view has nothing to store in side file
+    CHECK(!canRawViewModel.getComponent().sideData().write);
+}
+
+TEST_CASE("Main widget is built when requested for the first time", "[canrawview]")
+{
+    CanRawViewModel canRawViewModel;
+    auto& component = canRawViewModel.getComponent();
+
+    // Saving does not need widgets, hidden columns are known without them
+    const QJsonObject json = canRawViewModel.save();
+    CHECK(json["columns"].toArray().size() == 5);
+    CHECK(!component.mainWidgetCreated());
+
+    QWidget* widget = component.getMainWidget();
+    REQUIRE(widget != nullptr);
+    CHECK(widget->windowTitle() == "CANrawView");
+    CHECK(component.mainWidgetCreated());
+    CHECK(canRawViewModel.save()["columns"].toArray() == json["columns"].toArray());
+}
+
+TEST_CASE("Deferred configuration is restored on first use", "[canrawview]")
+{
+    CanRawViewModel canRawViewModel;
+    const QJsonObject saved = CanRawViewModel().save();
+    int loads = 0;
+
+    canRawViewModel.restore(QJsonObject{ { "name", "CanRawViewModel" }, { kDeferredRestoreKey, true } });
+    canRawViewModel.restoreLater([&loads, saved] {
+        ++loads;
+        return saved;
+    });
+    CHECK(loads == 0);
+
+    // Saving before first use gives back what was loaded
+    CHECK(canRawViewModel.save() == saved);
+    CHECK(loads == 1);
+
+    canRawViewModel.getComponent();
+    canRawViewModel.getComponent();
+    CHECK(loads == 2);
+    CHECK(canRawViewModel.save()["columns"] == saved["columns"]);
+}
+
+TEST_CASE("Thread affinity of deferred node is known before first use", "[canrawview]")
+{
+    CanRawViewModel canRawViewModel;
+    QJsonObject saved = CanRawViewModel().save();
+    saved[kThreadAffinityKey] = 2;
+
+    canRawViewModel.restore(QJsonObject{ { "name", "CanRawViewModel" }, { kDeferredRestoreKey, true } });
+    canRawViewModel.restoreLater([saved] { return saved; });
+    CHECK(canRawViewModel.threadAffinity() == 2);
+
+    // Simulation start takes the component, affinity stays
+    canRawViewModel.getComponent();
+    CHECK(canRawViewModel.threadAffinity() == 2);
+    CHECK(canRawViewModel.save()[kThreadAffinityKey].toInt() == 2);
+}
+
+TEST_CASE("Thread affinity is edited as node property", "[canrawview]")
+{
+    CanRawViewModel canRawViewModel;
+
+    CHECK(canRawViewModel.property("exposedProperties").toStringList().contains(kThreadAffinityKey));
+    CHECK(canRawViewModel.threadAffinity() == -1);
+
+    canRawViewModel.setProperty(kThreadAffinityKey, "3");
+    CHECK(canRawViewModel.threadAffinity() == 3);
+    CHECK(canRawViewModel.save()[kThreadAffinityKey].toInt() == 3);
+
+    canRawViewModel.setProperty(kThreadAffinityKey, "main");
+    CHECK(canRawViewModel.threadAffinity() == -1);
+    CHECK_FALSE(canRawViewModel.save().contains(kThreadAffinityKey));
 }
 
 int main(int argc, char* argv[])
@@ -80,6 +170,7 @@ int main(int argc, char* argv[])
     }
     cds_debug("Staring unit tests");
     qRegisterMetaType<QCanBusFrame>(); // required by QSignalSpy
+    qRegisterMetaType<CanFrameBatch>(); // required by QSignalSpy
     QApplication a(argc, argv); // QApplication must exist when contructing QWidgets TODO check QTest
     return Catch::Session().run(argc, argv);
 }
@@ -0,0 +1,158 @@
+#include <canrawview/capturestore.h>
+#include <catch.hpp>
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, int length, quint8 seed, quint8 flags = 0)
+{
+    CanFrameRecord rec{};
+
+    rec.id = id;
+    rec.flags = flags;
+    rec.length = static_cast<quint8>(length);
+    for (int i = 0; i < length; ++i) {
+        rec.payload[i] = static_cast<quint8>(seed + i * 7);
+    }
+
+    return rec;
+}
+
+// Mixes standard, extended and FD frames of changing payload and irregular times
+CanFrameRecord frameAt(int i)
+{
+    switch (i % 5) {
+    case 0:
+        return makeRecord(0x100, 8, static_cast<quint8>(i / 5));
+    case 1:
+        return makeRecord(0x1abcdef, 4, 0x11, CanFrameRecord::ExtendedId);
+    case 2:
+        return makeRecord(0x200 + static_cast<quint32>(i % 300), 2, static_cast<quint8>(i), CanFrameRecord::Tx);
+    case 3:
+        return makeRecord(0x7df, 64, static_cast<quint8>(i % 3), CanFrameRecord::FlexibleDataRate);
+    default:
+        return makeRecord(0x0, 0, 0);
+    }
+}
+
+double timeAt(int i)
+{
+    return -1.0 + i * 0.000125 + ((i % 7) ? 0.0 : 0.003);
+}
+
+void checkRow(const CaptureStore::Row& row, int i)
+{
+    const CanFrameRecord rec = frameAt(i);
+
+    REQUIRE(row.id == rec.id);
+    REQUIRE(row.flags == rec.flags);
+    REQUIRE(row.length == rec.length);
+    REQUIRE(std::equal(row.payload.begin(), row.payload.begin() + row.length, rec.payload));
+    REQUIRE(row.time == Approx(timeAt(i)).margin(0.0000005));
+}
+} // namespace
+
+TEST_CASE("Frames survive compression of sealed blocks", "[capturestore]")
+{
+    CaptureStore store;
+    const int count = 3 * CaptureStore::kBlockFrames + 100;
+
+    for (int i = 0; i < count; ++i) {
+        store.append(frameAt(i), timeAt(i));
+    }
+
+    CHECK(store.size() == count);
+    CHECK(store.blockCount() == 3);
+
+    // Access in both directions, so that blocks are evicted from cache and decoded again
+    for (int i = 0; i < count; i += 97) {
+        checkRow(store.row(i), i);
+    }
+    for (int i = count - 1; i >= 0; i -= 101) {
+        checkRow(store.row(i), i);
+    }
+}
+
+TEST_CASE("Length beyond payload is clamped", "[capturestore]")
+{
+    CaptureStore store;
+    const int maxPayload = CanFrameRecord::kMaxPayload;
+    CanFrameRecord rec = makeRecord(0x123, maxPayload, 1, CanFrameRecord::FlexibleDataRate);
+    rec.length = 200;
+
+    // Frame is read back from open and from sealed block
+    store.append(rec, 0.0);
+    CHECK(store.row(0).length == maxPayload);
+    for (int i = 1; i < CaptureStore::kBlockFrames; ++i) {
+        store.append(frameAt(i), timeAt(i));
+    }
+    REQUIRE(store.blockCount() == 1);
+
+    const CaptureStore::Row row = store.row(0);
+    CHECK(row.length == maxPayload);
+    CHECK(row.payload[maxPayload - 1] == rec.payload[maxPayload - 1]);
+}
+
+TEST_CASE("Dropped frames free their blocks", "[capturestore]")
+{
+    CaptureStore store;
+    const int count = 2 * CaptureStore::kBlockFrames + 10;
+
+    for (int i = 0; i < count; ++i) {
+        store.append(frameAt(i), timeAt(i));
+    }
+
+    store.dropFront(CaptureStore::kBlockFrames - 1);
+    CHECK(store.blockCount() == 2);
+    checkRow(store.row(0), CaptureStore::kBlockFrames - 1);
+
+    store.dropFront(2);
+    CHECK(store.blockCount() == 1);
+    CHECK(store.size() == count - CaptureStore::kBlockFrames - 1);
+    checkRow(store.row(0), CaptureStore::kBlockFrames + 1);
+    checkRow(store.row(store.size() - 1), count - 1);
+
+    // Frames appended after drop continue where the store ended
+    store.append(frameAt(count), timeAt(count));
+    checkRow(store.row(store.size() - 1), count);
+
+    store.clear();
+    CHECK(store.size() == 0);
+    CHECK(store.blockCount() == 0);
+    store.append(frameAt(3), timeAt(3));
+    checkRow(store.row(0), 3);
+}
+
+TEST_CASE("Range is read in order", "[capturestore]")
+{
+    CaptureStore store;
+    const int count = 2 * CaptureStore::kBlockFrames + 50;
+
+    for (int i = 0; i < count; ++i) {
+        store.append(frameAt(i), timeAt(i));
+    }
+    store.dropFront(10);
+
+    int expected = 100;
+    store.forEach(100, count + 5, [&expected](int index, const CaptureStore::Row& row) {
+        REQUIRE(index == expected);
+        checkRow(row, index + 10);
+        ++expected;
+    });
+    CHECK(expected == count - 10);
+}
+
+TEST_CASE("Cyclic traffic takes a few bytes per frame", "[capturestore]")
+{
+    CaptureStore store;
+    const int count = 64 * CaptureStore::kBlockFrames;
+
+    // 50 ids sent every 10 ms with a counter in the first byte
+    for (int i = 0; i < count; ++i) {
+        CanFrameRecord rec = makeRecord(0x100 + static_cast<quint32>(i % 50), 8, 0);
+        rec.payload[0] = static_cast<quint8>(i / 50);
+        store.append(rec, i * 0.0002);
+    }
+
+    const double perFrame = static_cast<double>(store.bytes()) / count;
+    CHECK(perFrame < 8.0);
+    CHECK(perFrame < sizeof(CaptureStore::Row) / 8.0);
+}
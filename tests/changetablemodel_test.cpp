@@ -0,0 +1,108 @@
+#include <QSignalSpy>
+#include <canrawview/changetablemodel.h>
+#include <catch.hpp>
+#include <cstring>
+
+namespace {
+CanFrameRecord makeFrame(quint32 id, const char* hex, Direction dir = Direction::RX)
+{
+    return toCanFrameRecord(QCanBusFrame(id, QByteArray::fromHex(hex)), dir);
+}
+
+CanFrameBatch makeBatch(const std::vector<CanFrameRecord>& frames)
+{
+    CanFrameBatch batch;
+
+    for (const auto& frame : frames) {
+        batch.append(frame);
+    }
+
+    return batch;
+}
+
+quint64 diff(const QByteArray& prev, const QByteArray& next)
+{
+    quint8 a[CanFrameRecord::kMaxPayload] = {};
+    quint8 b[CanFrameRecord::kMaxPayload] = {};
+
+    std::memcpy(a, prev.constData(), prev.size());
+    std::memcpy(b, next.constData(), next.size());
+    // Bytes beyond length are not compared
+    if (next.size() < CanFrameRecord::kMaxPayload) {
+        b[CanFrameRecord::kMaxPayload - 1] = 0x5a;
+    }
+
+    return ChangeTableModel::diffMask(a, prev.size(), b, next.size());
+}
+} // namespace
+
+TEST_CASE("Payload difference mask", "[changetablemodel]")
+{
+    CHECK(diff(QByteArray::fromHex("0102"), QByteArray::fromHex("0102")) == 0);
+    CHECK(diff(QByteArray::fromHex("0102"), QByteArray::fromHex("0103")) == 0x2);
+    CHECK(diff(QByteArray::fromHex("0102"), QByteArray::fromHex("010203")) == 0x4);
+    CHECK(diff(QByteArray::fromHex("010203"), QByteArray::fromHex("11")) == 0x7);
+
+    QByteArray fd(64, '\x33');
+    QByteArray changed = fd;
+    changed[9] = '\x34';
+    changed[63] = '\x00';
+    CHECK(diff(fd, fd) == 0);
+    CHECK(diff(fd, changed) == ((1ULL << 9) | (1ULL << 63)));
+}
+
+TEST_CASE("Rows are updated only when payload changes", "[changetablemodel]")
+{
+    ChangeTableModel model;
+    QSignalSpy inserted(&model, &ChangeTableModel::rowsInserted);
+    QSignalSpy changed(&model, &ChangeTableModel::dataChanged);
+
+    CHECK(model.appendFrames(makeBatch({ makeFrame(0x100, "0102"), makeFrame(0x200, "aa"),
+                                 makeFrame(0x100, "0102", Direction::TX), makeFrame(0x100, "0102") }),
+              { 0.1, 0.2, 0.3, 0.4 })
+        == 3);
+    REQUIRE(model.rowCount() == 3);
+    CHECK(inserted.count() == 1);
+    CHECK(changed.count() == 0);
+    CHECK(model.changedBytes(0) == 0x3);
+    CHECK(model.data(model.index(2, FrameTableModel::Dir)).toString() == "TX");
+
+    // Cyclic frames with the same payload cause no signals
+    CHECK(model.appendFrames(makeBatch({ makeFrame(0x100, "0102"), makeFrame(0x200, "aa") }), { 1.0, 1.0 }) == 0);
+    CHECK(inserted.count() == 1);
+    CHECK(changed.count() == 0);
+    CHECK(model.data(model.index(0, FrameTableModel::TimeDouble)).toDouble() == 0.1);
+
+    CHECK(model.appendFrames(makeBatch({ makeFrame(0x100, "0142"), makeFrame(0x200, "ab"), makeFrame(0x100, "0143") }),
+              { 2.0, 2.0, 2.1 })
+        == 3);
+    CHECK(inserted.count() == 1);
+    // Rows 0 and 1 reported as one range
+    REQUIRE(changed.count() == 1);
+    CHECK(changed[0][0].toModelIndex().row() == 0);
+    CHECK(changed[0][1].toModelIndex().row() == 1);
+    CHECK(model.changedBytes(0) == 0x2);
+    CHECK(model.changeCount(0) == 3);
+    CHECK(model.data(model.index(0, FrameTableModel::Data)).toString() == "01 43");
+    CHECK(model.data(model.index(0, FrameTableModel::TimeDouble)).toDouble() == 2.1);
+    CHECK(model.data(model.index(1, ChangeTableModel::ChangedBytesRole), ChangeTableModel::ChangedBytesRole)
+              .toULongLong()
+        == 0x1);
+
+    model.clear();
+    CHECK(model.rowCount() == 0);
+}
+
+TEST_CASE("Standard and extended frames with the same id get own rows", "[changetablemodel]")
+{
+    ChangeTableModel model;
+    CanFrameRecord extended = makeFrame(0x100, "0102");
+    extended.flags |= CanFrameRecord::ExtendedId;
+
+    CHECK(model.appendFrames(makeBatch({ makeFrame(0x100, "0102"), extended }), { 0.1, 0.2 }) == 2);
+    REQUIRE(model.rowCount() == 2);
+
+    // Each row keeps its own payload
+    CHECK(model.appendFrames(makeBatch({ extended }), { 0.3 }) == 0);
+    CHECK(model.changeCount(1) == 1);
+}
@@ -0,0 +1,102 @@
+#include <catch.hpp>
+#include <floodgenerator.h>
+
+namespace {
+struct FloodBus {
+    explicit FloodBus(FloodGenerator& flood)
+    {
+        QObject::connect(&flood, &FloodGenerator::framesGenerated,
+            [this](const QVector<QCanBusFrame>& generated) { frames += generated; });
+    }
+
+    QVector<QCanBusFrame> frames;
+};
+} // namespace
+
+TEST_CASE("Flood profile is read from JSON", "[flood]")
+{
+    auto profile = FloodProfile::fromJson({});
+    CHECK(profile.busLoad == 100.0);
+    CHECK(profile.idMode == FloodProfile::IdMode::Fixed);
+
+    profile = FloodProfile::fromJson({ { "busLoad", 150 }, { "idMode", "sweep" }, { "firstId", 0x10 },
+        { "lastId", 0x8 }, { "length", 12 }, { "payloadMode", "bogus" }, { "payload", "0102" } });
+    CHECK(profile.busLoad == 100.0);
+    CHECK(profile.idMode == FloodProfile::IdMode::Sweep);
+    CHECK(profile.firstId == 0x10);
+    CHECK(profile.lastId == 0x10);
+    CHECK(profile.length == 8);
+    CHECK(profile.payloadMode == FloodProfile::PayloadMode::Counter);
+    CHECK(profile.payload == QByteArray::fromHex("0102"));
+
+    profile = FloodProfile::fromJson(
+        { { "canFd", true }, { "length", 33 }, { "extended", true }, { "firstId", 0x1000 } });
+    CHECK(profile.length == 48);
+    CHECK(profile.firstId == 0x1000);
+
+    const auto copy = FloodProfile::fromJson(profile.toJson());
+    CHECK(copy.toJson() == profile.toJson());
+}
+
+TEST_CASE("Flood reaches target bus load", "[flood]")
+{
+    FloodGenerator flood;
+    FloodBus bus(flood);
+    FloodProfile profile;
+
+    // 8 byte standard frame takes 270 us at 500 kbit/s
+    profile.busLoad = 50.0;
+    profile.maxInFlight = 1000;
+    flood.setProfile(profile);
+    flood.start(false);
+
+    for (quint64 us = 1000; us <= 101000; us += 1000) {
+        flood.generate(us);
+        flood.framesConfirmed(true, bus.frames.mid(static_cast<int>(flood.stats().framesConfirmed)));
+    }
+
+    const FloodStats stats = flood.stats();
+    CHECK(stats.framesGenerated == static_cast<quint64>(bus.frames.size()));
+    CHECK(stats.framesGenerated >= 184);
+    CHECK(stats.framesGenerated <= 187);
+    CHECK(stats.framesConfirmed == stats.framesGenerated);
+    CHECK(stats.achievedLoad == Approx(50.0).epsilon(0.02));
+    CHECK(stats.seconds == Approx(0.1));
+
+    flood.stop();
+    flood.generate(200000);
+    CHECK(flood.stats().framesGenerated == stats.framesGenerated);
+}
+
+TEST_CASE("Flood waits for confirmations", "[flood]")
+{
+    FloodGenerator flood;
+    FloodBus bus(flood);
+    FloodProfile profile;
+
+    profile.maxInFlight = 4;
+    profile.idMode = FloodProfile::IdMode::Sweep;
+    profile.firstId = 0x10;
+    profile.lastId = 0x12;
+    flood.setProfile(profile);
+    flood.start(false);
+
+    flood.generate(1000);
+    flood.generate(50000);
+    REQUIRE(bus.frames.size() == 4);
+    CHECK(bus.frames[0].frameId() == 0x10);
+    CHECK(bus.frames[2].frameId() == 0x12);
+    CHECK(bus.frames[3].frameId() == 0x10);
+    // Counter payload
+    CHECK(bus.frames[3].payload()[0] == 3);
+
+    flood.framesConfirmed(false, bus.frames.mid(0, 2));
+    CHECK(flood.stats().framesFailed == 2);
+    // Bus was the bottleneck, frames are not sent in burst to catch up
+    flood.generate(50000);
+    CHECK(bus.frames.size() == 5);
+    flood.generate(50300);
+    CHECK(bus.frames.size() == 6);
+    flood.generate(60000);
+    CHECK(bus.frames.size() == 6);
+}
@@ -0,0 +1,439 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTemporaryDir>
+#include <candevice.h>
+#include <canrawview.h>
+#include <catch.hpp>
+#include <flowplan.h>
+#include <framefilter.h>
+#include <gui/crvheadlessgui.h>
+#include <isotp.h>
+#include <loadgovernor.h>
+#include <log.h>
+#include <merge.h>
+#include <tracelogger.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+void configure(TraceLogger& logger, const QString& file)
+{
+    QJsonObject config{ { "file", file }, { "flushInterval", 60000 } };
+    logger.setConfig(config);
+}
+} // namespace
+
+TEST_CASE("Device frames are fanned out to all consumers", "[flowplan]")
+{
+    QTemporaryDir dir;
+    CanDevice device;
+    TraceLogger first;
+    TraceLogger second;
+    FlowPlan plan;
+
+    configure(first, dir.path() + "/first.cdst");
+    configure(second, dir.path() + "/second.cdst");
+
+    REQUIRE(plan.addEdge(device, first));
+    REQUIRE(plan.addEdge(device, second));
+    // Adding the same edge again does not duplicate frames
+    REQUIRE(plan.addEdge(device, second));
+    CHECK(plan.edgeCount() == 2);
+    CHECK(plan.hasEdge(device, first));
+    CHECK(!plan.hasEdge(first, device));
+
+    first.startSimulation();
+    second.startSimulation();
+
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray(2, 1)), QCanBusFrame(0x11, QByteArray()) });
+    emit device.frameBatchSent(false, { QCanBusFrame(0x20, QByteArray()) });
+
+    plan.removeEdge(device, first);
+    CHECK(plan.edgeCount() == 1);
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray()) });
+
+    plan.removeComponent(second);
+    CHECK(plan.edgeCount() == 0);
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray()) });
+
+    // Trace is written in background, counters are final once loggers are stopped
+    first.stopSimulation();
+    second.stopSimulation();
+    CHECK(first.framesWritten() == 3);
+    CHECK(second.framesWritten() == 4);
+}
+
+TEST_CASE("Consumers run on worker threads", "[flowplan]")
+{
+    QTemporaryDir dir;
+    CanDevice device;
+    CanRawView view(CanRawViewCtx(new CRVHeadlessGui));
+    TraceLogger first;
+    TraceLogger second;
+    FlowPlan plan;
+
+    configure(first, dir.path() + "/first.cdst");
+    configure(second, dir.path() + "/second.cdst");
+
+    plan.setWorkerCount(2);
+    plan.setAffinity(first, FlowPlan::kAnyWorker);
+    plan.setAffinity(second, 2);
+    // Views touch widgets, they are kept in main thread
+    plan.setAffinity(view, FlowPlan::kAnyWorker);
+    REQUIRE(plan.addEdge(device, first));
+    REQUIRE(plan.addEdge(device, second));
+    REQUIRE(plan.addEdge(device, view));
+    CHECK(plan.workerCount() == 2);
+
+    first.startSimulation();
+    second.startSimulation();
+
+    for (int i = 0; i < 100; ++i) {
+        emit device.frameBatchReceived({ QCanBusFrame(i, QByteArray(8, 0)), QCanBusFrame(i, QByteArray()) });
+    }
+    emit device.frameBatchSent(true, { QCanBusFrame(0x20, QByteArray()) });
+
+    plan.flush();
+    first.stopSimulation();
+    second.stopSimulation();
+
+    CHECK(plan.droppedBatches() == 0);
+    CHECK(first.framesWritten() == 201);
+    CHECK(second.framesWritten() == 201);
+
+    plan.clear();
+    CHECK(plan.edgeCount() == 0);
+}
+
+TEST_CASE("Edge policies bound queued batches", "[flowplan]")
+{
+    QTemporaryDir dir;
+    CanDevice device;
+    TraceLogger dropping;
+    TraceLogger blocking;
+    FlowPlan plan;
+    EdgePolicy drop;
+    EdgePolicy block;
+
+    configure(dropping, dir.path() + "/dropping.cdst");
+    configure(blocking, dir.path() + "/blocking.cdst");
+
+    drop.mode = EdgePolicy::DropNewest;
+    drop.capacity = 4;
+    block.mode = EdgePolicy::Block;
+    block.capacity = 2;
+    REQUIRE(plan.addEdge(device, dropping, drop));
+    REQUIRE(plan.addEdge(device, blocking, block));
+
+    dropping.startSimulation();
+    blocking.startSimulation();
+
+    // Event loop does not run, queues are drained by flush or by blocked producer only
+    for (int i = 0; i < 10; ++i) {
+        emit device.frameBatchReceived({ QCanBusFrame(i, QByteArray()), QCanBusFrame(i, QByteArray()) });
+    }
+
+    const EdgeStats stats = plan.edgeStats(device, dropping);
+    CHECK(stats.droppedBatches == 6);
+    CHECK(stats.droppedFrames == 12);
+    CHECK(stats.queued == 4);
+    CHECK(plan.edgeStats(device, blocking).droppedBatches == 0);
+    CHECK(plan.droppedBatches() == 6);
+
+    plan.flush();
+    CHECK(plan.edgeStats(device, dropping).queued == 0);
+    dropping.stopSimulation();
+    blocking.stopSimulation();
+
+    CHECK(dropping.framesWritten() == 8);
+    CHECK(blocking.framesWritten() == 20);
+}
+
+TEST_CASE("Edge policy is read from JSON", "[flowplan]")
+{
+    auto policy = EdgePolicy::fromJson({});
+    CHECK(policy.mode == EdgePolicy::Direct);
+    CHECK(policy.capacity == EdgePolicy::kDefaultCapacity);
+
+    policy = EdgePolicy::fromJson({ { "policy", "decimate" }, { "capacity", 16 }, { "decimation", 0 } });
+    CHECK(policy.mode == EdgePolicy::Decimate);
+    CHECK(policy.capacity == 16);
+    CHECK(policy.decimation == EdgePolicy::kDefaultDecimation);
+
+    CHECK(EdgePolicy::fromJson(policy.toJson()).mode == EdgePolicy::Decimate);
+    CHECK(EdgePolicy::fromJson({ { "policy", "unknown" } }).mode == EdgePolicy::Direct);
+}
+
+TEST_CASE("Unsupported edges are rejected", "[flowplan]")
+{
+    CanDevice device;
+    CanRawView view(CanRawViewCtx(new CRVHeadlessGui));
+    TraceLogger logger;
+    FlowPlan plan;
+
+    CHECK(!plan.addEdge(view, device));
+    CHECK(!plan.addEdge(logger, view));
+    CHECK(plan.addEdge(device, view));
+    CHECK(plan.edgeCount() == 1);
+
+    plan.clear();
+    CHECK(plan.edgeCount() == 0);
+}
+
+TEST_CASE("ISO-TP node is wired to device in both directions", "[flowplan]")
+{
+    CanDevice device;
+    IsoTp isoTp;
+    IsoTp peer;
+    TraceLogger logger;
+    FlowPlan plan;
+
+    CHECK(plan.addEdge(device, isoTp));
+    CHECK(plan.addEdge(isoTp, device));
+    CHECK(plan.addEdge(isoTp, peer));
+    CHECK(!plan.addEdge(isoTp, logger));
+    CHECK(plan.edgeCount() == 3);
+
+    plan.removeComponent(isoTp);
+    CHECK(plan.edgeCount() == 0);
+}
+
+TEST_CASE("Input port of merge selects channel", "[flowplan]")
+{
+    CanDevice first;
+    CanDevice second;
+    Merge merge;
+    FlowPlan plan;
+    CanFrameBatch merged;
+
+    QObject::connect(&merge, &Merge::framesMerged, [&merged](const CanFrameBatch& frames) { merged += frames; });
+
+    REQUIRE(plan.addEdge(first, merge, EdgePolicy(), 0));
+    REQUIRE(plan.addEdge(second, merge, EdgePolicy(), 3));
+    merge.startSimulation();
+
+    QCanBusFrame early(0x10, QByteArray());
+    QCanBusFrame late(0x20, QByteArray());
+    early.setTimeStamp(QCanBusFrame::TimeStamp(1, 0));
+    late.setTimeStamp(QCanBusFrame::TimeStamp(2, 0));
+
+    emit second.frameBatchReceived({ late });
+    emit first.frameBatchReceived({ early });
+    merge.flush();
+
+    REQUIRE(merged.size() == 2);
+    CHECK(merged[0].id == 0x10);
+    CHECK(merged[0].channel == 1);
+    CHECK(merged[1].id == 0x20);
+    CHECK(merged[1].channel == 4);
+}
+
+TEST_CASE("Filter passes matching frames downstream", "[flowplan]")
+{
+    CanDevice device;
+    FrameFilter filter;
+    Merge merge;
+    FlowPlan plan;
+    CanFrameBatch merged;
+    QJsonObject config{ { "expression", "id == 0x10 || dir == TX" } };
+
+    filter.setConfig(config);
+    QObject::connect(&merge, &Merge::framesMerged, [&merged](const CanFrameBatch& frames) { merged += frames; });
+
+    REQUIRE(plan.addEdge(device, filter));
+    REQUIRE(plan.addEdge(filter, merge));
+    merge.startSimulation();
+
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray()), QCanBusFrame(0x11, QByteArray()) });
+    emit device.frameBatchSent(true, { QCanBusFrame(0x20, QByteArray()) });
+    merge.flush();
+
+    REQUIRE(merged.size() == 2);
+    CHECK(merged[0].id == 0x10);
+    CHECK(merged[1].id == 0x20);
+    CHECK(merged[1].hasFlag(CanFrameRecord::Tx));
+    CHECK(filter.framesRejected() == 1);
+}
+
+TEST_CASE("Node statistics count frames in and out", "[flowplan]")
+{
+    CanDevice device;
+    FrameFilter filter;
+    Merge first;
+    Merge second;
+    FlowPlan plan;
+    QJsonObject config{ { "expression", "id == 0x10" } };
+
+    filter.setConfig(config);
+    REQUIRE(plan.addEdge(device, filter));
+    REQUIRE(plan.addEdge(filter, first));
+    REQUIRE(plan.addEdge(filter, second));
+
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray()), QCanBusFrame(0x11, QByteArray()) });
+    emit device.frameBatchSent(true, { QCanBusFrame(0x10, QByteArray()) });
+
+    const NodeStats base = plan.nodeStats(filter);
+    CHECK(plan.nodeStats(device).framesOut == 3);
+    CHECK(base.framesIn == 3);
+    // Frames reaching two consumers are emitted once
+    CHECK(base.framesOut == 2);
+    CHECK(base.frameNs.count == 3);
+    CHECK(plan.nodeStats(first).framesIn == 2);
+    CHECK(plan.nodeStats(second).framesIn == 2);
+
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray()) });
+
+    const NodeStats delta = plan.nodeStats(filter) - base;
+    CHECK(delta.framesIn == 1);
+    CHECK(delta.framesOut == 1);
+    CHECK(delta.toString(0.5).startsWith("in 2/s, out 2/s"));
+
+    plan.removeComponent(filter);
+    CHECK(plan.nodeStats(filter).framesIn == 0);
+}
+
+TEST_CASE("Views of the same device share one capture", "[flowplan]")
+{
+    CanDevice device;
+    FrameFilter filter;
+    CanRawView first(CanRawViewCtx(new CRVHeadlessGui));
+    CanRawView second(CanRawViewCtx(new CRVHeadlessGui));
+    FlowPlan plan;
+    QJsonObject config{ { "displayRate", 0 } };
+
+    first.setConfig(config);
+    second.setConfig(config);
+    REQUIRE(plan.addEdge(device, first));
+    REQUIRE(plan.addEdge(device, second));
+    CHECK(second.sharesCapture(first));
+
+    first.startSimulation();
+    second.startSimulation();
+
+    // Both views are fed, frames are stored once
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray()), QCanBusFrame(0x11, QByteArray()) });
+    CHECK(first.frameCount() == 2);
+    CHECK(second.frameCount() == 2);
+
+    // Remaining view keeps frames and takes over the capture
+    plan.removeEdge(device, first);
+    CHECK(!second.sharesCapture(first));
+    CHECK(first.frameCount() == 0);
+    emit device.frameBatchReceived({ QCanBusFrame(0x12, QByteArray()) });
+    CHECK(second.frameCount() == 3);
+
+    REQUIRE(plan.addEdge(device, first));
+    CHECK(first.sharesCapture(second));
+    CHECK(first.frameCount() == 3);
+
+    // View with other input keeps its own capture
+    REQUIRE(plan.addEdge(filter, second));
+    CHECK(!second.sharesCapture(first));
+    CHECK(first.frameCount() == 3);
+
+    plan.clear();
+    CHECK(!second.sharesCapture(first));
+}
+
+TEST_CASE("Frames passed to consumers update directory of the device", "[flowplan]")
+{
+    CanDevice device;
+    CanRawView view(CanRawViewCtx(new CRVHeadlessGui));
+    FlowPlan plan;
+    const FrameIdDirectoryPtr directory = device.idDirectory();
+    quint8 payload[CanFrameRecord::kMaxPayload];
+    quint64 timestamp = 0;
+
+    view.setConfig(QJsonObject{ { "displayRate", 0 } });
+    REQUIRE(plan.addEdge(device, view));
+    view.startSimulation();
+
+    emit device.frameBatchReceived({ QCanBusFrame(0x10, QByteArray(2, 1)), QCanBusFrame(0x11, QByteArray()) });
+    emit device.frameBatchSent(true, { QCanBusFrame(0x10, QByteArray(1, 2)) });
+    CHECK(view.frameCount() == 3);
+
+    const auto handle = directory->find(0x10, false);
+    REQUIRE(handle < directory->size());
+    CHECK(directory->size() == 2);
+    CHECK(directory->frameCount(handle, Direction::RX) == 1);
+    CHECK(directory->frameCount(handle, Direction::TX) == 1);
+    CHECK(directory->lastPayload(handle, payload, timestamp) == 1);
+    CHECK(payload[0] == 2);
+}
+
+TEST_CASE("Load governor degrades at once and recovers step by step", "[flowplan]")
+{
+    LoadGovernor governor([] { return std::size_t(0); });
+    QVector<LoadLevel> levels;
+    const int recoveryMs = LoadGovernor::kRecoveryMs;
+
+    QObject::connect(
+        &governor, &LoadGovernor::levelChanged, [&levels](LoadLevel level, const QString&) { levels.append(level); });
+
+    governor.update(10, 0, 0);
+    CHECK(governor.level() == LoadLevel::Normal);
+
+    // Either lag or backlog is enough
+    governor.update(60, 0, 100);
+    CHECK(governor.level() == LoadLevel::Reduced);
+    governor.update(0, 1000, 200);
+    CHECK(governor.level() == LoadLevel::Sampled);
+
+    // Calm load has to last for recovery period before each step down
+    governor.update(0, 0, 300);
+    CHECK(governor.level() == LoadLevel::Sampled);
+    governor.update(0, 0, 200 + recoveryMs);
+    CHECK(governor.level() == LoadLevel::Reduced);
+    governor.update(0, 0, 300 + recoveryMs);
+    CHECK(governor.level() == LoadLevel::Reduced);
+    governor.update(0, 0, 200 + 2 * recoveryMs);
+    CHECK(governor.level() == LoadLevel::Normal);
+
+    governor.update(300, 0, 300 + 2 * recoveryMs);
+    governor.stop();
+    CHECK(governor.level() == LoadLevel::Normal);
+    CHECK(levels
+        == QVector<LoadLevel>{ LoadLevel::Reduced, LoadLevel::Sampled, LoadLevel::Reduced, LoadLevel::Normal,
+            LoadLevel::Sampled, LoadLevel::Normal });
+}
+
+TEST_CASE("Sampled view does not affect frame path", "[flowplan]")
+{
+    CanDevice device;
+    CanRawView view(CanRawViewCtx(new CRVHeadlessGui));
+    FlowPlan plan;
+    const FrameIdDirectoryPtr directory = device.idDirectory();
+
+    view.setConfig(QJsonObject{ { "displayRate", 0 } });
+    REQUIRE(plan.addEdge(device, view));
+    view.startSimulation();
+    view.setLoadLevel(LoadLevel::Sampled);
+
+    QVector<QCanBusFrame> batch;
+    for (int i = 0; i < 20; ++i) {
+        batch.append(QCanBusFrame(0x10, QByteArray()));
+    }
+    emit device.frameBatchReceived(batch);
+
+    // Buffered frames are flushed on stop
+    view.stopSimulation();
+    CHECK(view.frameCount() == 2);
+    CHECK(directory->frameCount(directory->find(0x10, false), Direction::RX) == 20);
+    CHECK(view.getConfig()["displayRate"].toInt() == 0);
+
+    view.setLoadLevel(LoadLevel::Normal);
+    view.startSimulation();
+    emit device.frameBatchReceived(batch);
+    CHECK(view.frameCount() == 20);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
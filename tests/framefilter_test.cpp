@@ -0,0 +1,177 @@
+#define CATCH_CONFIG_RUNNER
+#include <QSignalSpy>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
+#include <catch.hpp>
+#include <filterexpression.h>
+#include <framefilter.h>
+#include <log.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, const char* payload, Direction dir = Direction::RX)
+{
+    return toCanFrameRecord(QCanBusFrame(id, QByteArray::fromHex(payload)), dir);
+}
+
+bool matches(const char* expression, const CanFrameRecord& rec)
+{
+    FilterExpression filter;
+
+    REQUIRE(filter.compile(expression));
+    return filter.matches(rec);
+}
+
+QString compileError(const char* expression)
+{
+    FilterExpression filter;
+
+    CHECK_FALSE(filter.compile(expression));
+    CHECK_FALSE(filter.isValid());
+    return filter.errorString();
+}
+} // namespace
+
+TEST_CASE("Frames are matched against expression", "[framefilter]")
+{
+    const char* expression = "id in [0x100..0x1FF] && data[2] & 0x80 && dir == RX";
+
+    CHECK(matches(expression, makeRecord(0x150, "000080")));
+    CHECK_FALSE(matches(expression, makeRecord(0x150, "00007f")));
+    CHECK_FALSE(matches(expression, makeRecord(0x150, "000080", Direction::TX)));
+    CHECK_FALSE(matches(expression, makeRecord(0x200, "000080")));
+    // Byte beyond length of frame reads as 0
+    CHECK_FALSE(matches(expression, makeRecord(0x150, "0000")));
+
+    CHECK(matches("id == 0x123 || id == 0x124", makeRecord(0x124, "")));
+    CHECK_FALSE(matches("id == 0x123 || id == 0x124", makeRecord(0x125, "")));
+    CHECK(matches("!(id == 5) && 0x100 >= id", makeRecord(6, "")));
+    CHECK(matches("id in [3, 1..2, 10]", makeRecord(10, "")));
+    CHECK_FALSE(matches("id in [3, 1..2, 10]", makeRecord(5, "")));
+    CHECK(matches("len == 2 && data[0] << 8 | data[1] >= 0x1234", makeRecord(6, "1234")));
+    CHECK_FALSE(matches("len == 2 && data[0] << 8 | data[1] >= 0x1234", makeRecord(6, "1233")));
+    // Bitwise operators bind tighter than comparisons
+    CHECK(matches("data[0] & 0x0f == 2", makeRecord(6, "32")));
+    CHECK(matches("~data[0] & 0xff == 0xfe", makeRecord(6, "01")));
+    CHECK(matches("dir == TX && !failed", makeRecord(6, "", Direction::TX)));
+    CHECK(matches("ext", toCanFrameRecord(QCanBusFrame(0x1abcdef, QByteArray()), Direction::RX)));
+}
+
+TEST_CASE("Empty expression passes all frames", "[framefilter]")
+{
+    FilterExpression filter;
+
+    REQUIRE(filter.compile(""));
+    CHECK(filter.size() == 0);
+    CHECK(filter.matches(makeRecord(0x10, "")));
+    CHECK(filter.acceptanceFilters().isEmpty());
+}
+
+TEST_CASE("Syntax errors are reported with column", "[framefilter]")
+{
+    CHECK(compileError("id ==") == "Unexpected end of expression at column 6");
+    CHECK(compileError("id == 1 == 2") == "Comparisons cannot be chained at column 9");
+    CHECK(compileError("data[64]") == "Payload index has to be number below 64 at column 6");
+    CHECK(compileError("foo") == "Unknown name 'foo' at column 1");
+    CHECK(compileError("id in [5..1]") == "Empty range at column 8");
+    CHECK(compileError("0xzz") == "Invalid number '0xzz' at column 1");
+    CHECK(compileError("id in [1,]") == "Unexpected ']' at column 10");
+    CHECK(compileError("id $") == "Unexpected character '$' at column 4");
+    CHECK(compileError(QByteArray(300, '(').constData()).startsWith("Expression is nested too deep"));
+
+    // Invalid expression passes nothing
+    FilterExpression filter;
+    filter.compile("id ==");
+    CHECK_FALSE(filter.matches(makeRecord(0x10, "")));
+}
+
+TEST_CASE("Conditions on id become acceptance filters", "[framefilter]")
+{
+    FilterExpression filter;
+
+    REQUIRE(filter.compile("id == 0x123"));
+    REQUIRE(filter.acceptanceFilters().size() == 1);
+    CHECK(filter.acceptanceFilters()[0].frameId == 0x123);
+    CHECK(filter.acceptanceFilters()[0].frameIdMask == 0x1fffffff);
+
+    // Range is split into aligned blocks, other conditions do not widen it
+    REQUIRE(filter.compile("id in [0x100..0x1ff] && data[0] == 1"));
+    REQUIRE(filter.acceptanceFilters().size() == 1);
+    CHECK(filter.acceptanceFilters()[0].frameId == 0x100);
+    CHECK(filter.acceptanceFilters()[0].frameIdMask == 0x1fffff00);
+
+    REQUIRE(filter.compile("id in [0x101..0x103] || id == 0x7df"));
+    CHECK(filter.acceptanceFilters().size() == 3);
+
+    // Condition not on id may accept any id
+    REQUIRE(filter.compile("id in [0x100..0x1ff] || dir == TX"));
+    CHECK(filter.acceptanceFilters().isEmpty());
+    REQUIRE(filter.compile("len > 2"));
+    CHECK(filter.acceptanceFilters().isEmpty());
+
+    // Too many filters for device, filtering is left to software
+    REQUIRE(filter.compile("id in [1..100000]"));
+    CHECK(filter.acceptanceFilters().isEmpty());
+
+    // Contradiction accepts nothing, list must not be empty as that accepts everything
+    REQUIRE(filter.compile("id == 1 && id == 2"));
+    REQUIRE(filter.acceptanceFilters().size() == 1);
+    CHECK(filter.acceptanceFilters()[0].format == QCanBusDevice::Filter::MatchBaseFormat);
+}
+
+TEST_CASE("Batch passing as a whole is not copied", "[framefilter]")
+{
+    FilterExpression filter;
+    CanFrameBatch frames{ makeRecord(0x10, ""), makeRecord(0x11, ""), makeRecord(0x12, "") };
+
+    REQUIRE(filter.compile("id < 0x20"));
+    const CanFrameBatch all = filter.filter(frames);
+    CHECK(all.constData() == frames.constData());
+
+    REQUIRE(filter.compile("id != 0x11"));
+    const CanFrameBatch some = filter.filter(frames);
+    REQUIRE(some.size() == 2);
+    CHECK(some[0].id == 0x10);
+    CHECK(some[1].id == 0x12);
+}
+
+TEST_CASE("Filter component emits passed frames", "[framefilter]")
+{
+    FrameFilter filter;
+    QSignalSpy spy(&filter, &FrameFilter::framesFiltered);
+    QJsonObject config{ { "expression", "dir == TX || id == 0x10" } };
+
+    filter.setConfig(config);
+    CHECK(filter.getConfig()["expression"].toString() == "dir == TX || id == 0x10");
+    CHECK(filter.isValid());
+    filter.startSimulation();
+
+    filter.frameBatchReceived({ makeRecord(0x10, ""), makeRecord(0x11, "") });
+    filter.frameBatchReceived({ makeRecord(0x11, "") });
+    filter.frameBatchSent(true, { makeRecord(0x11, "", Direction::TX) });
+
+    // Batch without passed frames is not emitted
+    REQUIRE(spy.count() == 2);
+    CHECK(spy[0][0].value<CanFrameBatch>().size() == 1);
+    CHECK(spy[1][0].value<CanFrameBatch>()[0].hasFlag(CanFrameRecord::Tx));
+    CHECK(filter.framesPassed() == 2);
+    CHECK(filter.framesRejected() == 2);
+
+    config = QJsonObject{ { "expression", "id ==" } };
+    filter.setConfig(config);
+    CHECK_FALSE(filter.isValid());
+    CHECK_FALSE(filter.errorString().isEmpty());
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    qRegisterMetaType<CanFrameBatch>(); // required by QSignalSpy
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,129 @@
+#include <catch.hpp>
+#include <frameiddirectory.h>
+#include <thread>
+
+namespace {
+// Catch binds operands by reference, constants of header-only class have no out-of-class definition
+const FrameIdDirectory::Handle kInvalid = FrameIdDirectory::kInvalidHandle;
+const FrameIdDirectory::Handle kMaxEntries = FrameIdDirectory::kMaxEntries;
+
+CanFrameRecord frame(quint32 id, const QByteArray& payload, quint64 timestamp, Direction dir = Direction::RX)
+{
+    QCanBusFrame qFrame(id, payload);
+    qFrame.setTimeStamp(QCanBusFrame::TimeStamp(0, static_cast<qint64>(timestamp)));
+
+    return toCanFrameRecord(qFrame, dir);
+}
+} // namespace
+
+TEST_CASE("FrameIdDirectory assigns handles in order of first appearance", "[frameiddirectory]")
+{
+    FrameIdDirectory directory;
+
+    CHECK(directory.find(0x10, false) == kInvalid);
+    CHECK(directory.intern(0x10, false) == 0);
+    CHECK(directory.intern(0x10, true) == 1);
+    CHECK(directory.intern(0x18DAF110, true) == 2);
+    CHECK(directory.intern(0x10, false) == 0);
+    CHECK(directory.size() == 3);
+
+    CHECK(directory.find(0x10, false) == 0);
+    CHECK(directory.find(0x10, true) == 1);
+    CHECK(directory.find(0x18DAF110, true) == 2);
+    CHECK(directory.find(0x18DAF111, true) == kInvalid);
+
+    CHECK(directory.frameId(2) == 0x18DAF110);
+    CHECK(directory.isExtended(2));
+    CHECK(!directory.isExtended(0));
+    CHECK(directory.idText(0) == "0x10");
+    CHECK(directory.idText(2) == "0x18daf110");
+
+    directory.setMessageName(2, "Diag");
+    CHECK(directory.messageName(2) == "Diag");
+    CHECK(directory.messageName(0).isEmpty());
+}
+
+TEST_CASE("FrameIdDirectory keeps last payload and counters of every ID", "[frameiddirectory]")
+{
+    FrameIdDirectory directory;
+    quint8 payload[CanFrameRecord::kMaxPayload];
+    quint64 timestamp = 0;
+
+    CanFrameBatch frames{ frame(0x10, QByteArray("\x01\x02", 2), 100), frame(0x20, QByteArray(), 200),
+        frame(0x10, QByteArray("\x03\x04\x05", 3), 300), frame(0x10, QByteArray(1, 6), 400, Direction::TX) };
+    frames.last().flags |= CanFrameRecord::TxFailed;
+    directory.update(frames);
+
+    const auto handle = directory.find(0x10, false);
+    REQUIRE(handle != kInvalid);
+    CHECK(directory.frameCount(handle, Direction::RX) == 2);
+    CHECK(directory.frameCount(handle, Direction::TX) == 1);
+
+    // Failed transmission did not replace payload
+    CHECK(directory.lastPayload(handle, payload, timestamp) == 3);
+    CHECK(timestamp == 300);
+    CHECK(payload[0] == 3);
+    CHECK(payload[2] == 5);
+
+    // Handles and names survive reset
+    directory.setMessageName(handle, "Engine");
+    directory.resetSlots();
+    CHECK(directory.find(0x10, false) == handle);
+    CHECK(directory.messageName(handle) == "Engine");
+    CHECK(directory.frameCount(handle, Direction::RX) == 0);
+    CHECK(directory.lastPayload(handle, payload, timestamp) == 0);
+    CHECK(timestamp == 0);
+}
+
+TEST_CASE("FrameIdDirectory ignores standard IDs out of 11-bit range", "[frameiddirectory]")
+{
+    FrameIdDirectory directory;
+    CanFrameRecord rec = frame(0x1234, QByteArray::fromHex("01"), 10);
+
+    // Format flag lost on the way, e.g. by bridge peer
+    rec.flags = static_cast<quint8>(rec.flags & ~CanFrameRecord::ExtendedId);
+    CHECK(directory.intern(0x1234, false) == kInvalid);
+    CHECK(directory.find(0x1234, false) == kInvalid);
+
+    directory.update({ rec });
+    CHECK(directory.size() == 0);
+    CHECK(directory.find(0x1234, true) == kInvalid);
+}
+
+TEST_CASE("FrameIdDirectory interns IDs from several threads", "[frameiddirectory]")
+{
+    FrameIdDirectory directory;
+    std::vector<std::thread> threads;
+    constexpr quint32 kIds = 1000;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&directory] {
+            for (quint32 id = 0; id < kIds; ++id) {
+                directory.intern(0x1000000 + id * 7, true);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(directory.size() == kIds);
+    for (quint32 id = 0; id < kIds; ++id) {
+        const auto handle = directory.find(0x1000000 + id * 7, true);
+        REQUIRE(handle < kIds);
+        CHECK(directory.frameId(handle) == 0x1000000 + id * 7);
+    }
+}
+
+TEST_CASE("FrameIdDirectory stops interning when full", "[frameiddirectory]")
+{
+    FrameIdDirectory directory;
+
+    for (quint32 id = 0; id < kMaxEntries; ++id) {
+        REQUIRE(directory.intern(id, true) == id);
+    }
+
+    CHECK(directory.intern(kMaxEntries, true) == kInvalid);
+    CHECK(directory.find(kMaxEntries, true) == kInvalid);
+    CHECK(directory.find(kMaxEntries - 1, true) == kMaxEntries - 1);
+}
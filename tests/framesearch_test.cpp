@@ -0,0 +1,141 @@
+#define CATCH_CONFIG_RUNNER
+#include <QCoreApplication>
+#include <QSignalSpy>
+#include <canrawview/framesearch.h>
+#include <canrawview/frametablemodel.h>
+#include <canrawview/uniquefiltermodel.h>
+#include <catch.hpp>
+#include <log.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+// Ids cycle through 0x100..0x10f, every 5th frame is sent, payload carries low byte of index
+void fill(FrameTableModel& model, int count, int first = 0)
+{
+    CanFrameBatch batch;
+    std::vector<double> times;
+
+    for (int i = first; i < first + count; ++i) {
+        QByteArray payload = QByteArray::fromHex("aa00");
+        payload[1] = static_cast<char>(i);
+        batch.append(toCanFrameRecord(
+            QCanBusFrame(0x100 + (i % 16), payload), (i % 5 == 0) ? Direction::TX : Direction::RX));
+        times.push_back(i / 1000.0);
+    }
+
+    model.appendFrames(batch, times);
+}
+
+int runToCompletion(FrameSearch& search)
+{
+    int steps = 0;
+
+    while (!search.isComplete()) {
+        search.step();
+        ++steps;
+    }
+
+    return steps;
+}
+} // namespace
+
+TEST_CASE("Query text is parsed", "[framesearch]")
+{
+    const FrameQuery query = FrameQuery::parse("id:200,100-1ff,7df t:1.5- dir:TX data:11??22 bogus id:zz");
+
+    REQUIRE(query.idRanges.size() == 2);
+    CHECK(query.idRanges[0] == std::make_pair(0x100u, 0x200u));
+    CHECK(query.idRanges[1] == std::make_pair(0x7dfu, 0x7dfu));
+    CHECK(query.timeFrom == 1.5);
+    CHECK(query.direction == FrameQuery::Dir::Tx);
+    CHECK(query.data == QByteArray::fromHex("110022"));
+    CHECK(query.dataMask == QByteArray::fromHex("ff00ff"));
+
+    CHECK(query.matchesId(0x150));
+    CHECK(query.matchesId(0x7df));
+    CHECK_FALSE(query.matchesId(0x201));
+    CHECK(FrameQuery::parse("  ").isEmpty());
+}
+
+TEST_CASE("Search is evaluated in parallel chunks", "[framesearch]")
+{
+    FrameTableModel model;
+    FrameSearch search(model);
+    const int rows = FrameSearch::kStepRows + 1000;
+
+    model.setRetention(rows);
+    fill(model, rows);
+    search.setThreadCount(4);
+
+    SECTION("Id and direction")
+    {
+        search.start(FrameQuery::parse("id:103 dir:tx"));
+        CHECK(runToCompletion(search) == 2);
+
+        // Index i matches if i % 16 == 3 and i % 5 == 0, i.e. i % 80 == 35
+        CHECK(search.matchCount() == static_cast<std::size_t>((rows - 35 + 79) / 80));
+        CHECK(search.matches(model.seq(35)));
+        CHECK_FALSE(search.matches(model.seq(36)));
+    }
+
+    SECTION("Payload pattern and time range")
+    {
+        search.start(FrameQuery::parse("data:aa07 t:-0.5"));
+        runToCompletion(search);
+
+        // Low byte 7 every 256 frames within the first 501 rows
+        CHECK(search.matchCount() == 2);
+    }
+}
+
+TEST_CASE("Results are streamed into filtering proxy", "[framesearch]")
+{
+    FrameTableModel model;
+    FrameSearch search(model);
+    UniqueFilterModel proxy;
+    QSignalSpy progress(&search, &FrameSearch::progress);
+
+    proxy.setSourceModel(&model);
+    proxy.setSearch(&search);
+    fill(model, 100);
+    CHECK(proxy.rowCount() == 100);
+
+    search.start(FrameQuery::parse("id:101"));
+    proxy.refresh();
+    CHECK(proxy.rowCount() == 0);
+
+    search.step();
+    CHECK(proxy.rowCount() == 7);
+    CHECK(search.isComplete());
+    REQUIRE(progress.count() == 1);
+
+    // Appended rows are scanned by the next step
+    fill(model, 16, 100);
+    CHECK_FALSE(search.isComplete());
+    search.step();
+    CHECK(proxy.rowCount() == 8);
+
+    // Matches of evicted rows are dropped
+    model.setRetention(10);
+    CHECK(search.matchCount() == 0);
+    fill(model, 20);
+    search.step();
+    CHECK(search.matchCount() == 1);
+    CHECK(proxy.rowCount() == 1);
+
+    search.stop();
+    proxy.refresh();
+    CHECK(proxy.rowCount() == 10);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,150 @@
+#define CATCH_CONFIG_MAIN
+#include <QSignalSpy>
+#include <canrawview/frametablemodel.h>
+#include <catch.hpp>
+
+namespace {
+CanFrameBatch makeBatch(quint32 firstId, int count, Direction dir = Direction::RX)
+{
+    CanFrameBatch batch;
+
+    for (int i = 0; i < count; ++i) {
+        QCanBusFrame frame(firstId + i, QByteArray::fromHex("01ab"));
+        batch.append(toCanFrameRecord(frame, dir));
+    }
+
+    return batch;
+}
+} // namespace
+
+TEST_CASE("Rows are rendered lazily", "[frametablemodel]")
+{
+    FrameTableModel model;
+
+    model.appendFrames(makeBatch(0x12, 1, Direction::TX), { 1.5 });
+
+    REQUIRE(model.rowCount() == 1);
+    CHECK(model.columnCount() == FrameTableModel::ColumnCount);
+    CHECK(model.data(model.index(0, FrameTableModel::RowId)).toInt() == 0);
+    CHECK(model.data(model.index(0, FrameTableModel::TimeDouble)).toDouble() == 1.5);
+    CHECK(model.data(model.index(0, FrameTableModel::Time)).toString() == "1.500000");
+    CHECK(model.data(model.index(0, FrameTableModel::IdInt)).toInt() == 0x12);
+    CHECK(model.data(model.index(0, FrameTableModel::Id)).toString() == "0x12");
+    CHECK(model.data(model.index(0, FrameTableModel::Dir)).toString() == "TX");
+    CHECK(model.data(model.index(0, FrameTableModel::Dlc)).toInt() == 2);
+    CHECK(model.data(model.index(0, FrameTableModel::Data)).toString() == "01 ab");
+    CHECK(model.data(model.index(0, FrameTableModel::Data), FrameTableModel::PayloadRole).toByteArray()
+        == QByteArray::fromHex("01ab"));
+    CHECK(model.headerData(FrameTableModel::Data, Qt::Horizontal).toString() == "data");
+}
+
+TEST_CASE("CAN FD frames show format flags and full payload", "[frametablemodel]")
+{
+    FrameTableModel model;
+    CanFrameBatch batch{ toCanFrameRecord(QCanBusFrame(0x123, QByteArray(64, '\x5a'))) };
+    batch[0].flags |= CanFrameRecord::FlexibleDataRate | CanFrameRecord::BitrateSwitch;
+
+    model.appendFrames(batch, { 0.0 });
+
+    REQUIRE(model.rowCount() == 1);
+    CHECK(model.data(model.index(0, FrameTableModel::Dlc)).toInt() == 64);
+    CHECK(model.data(model.index(0, FrameTableModel::Flags)).toString() == "FD BRS");
+    CHECK(model.data(model.index(0, FrameTableModel::Data)).toString().count("5a") == 64);
+    CHECK(model.headerData(FrameTableModel::Flags, Qt::Horizontal).toString() == "flags");
+}
+
+TEST_CASE("Batch is inserted with single signal", "[frametablemodel]")
+{
+    FrameTableModel model;
+    QSignalSpy inserted(&model, &FrameTableModel::rowsInserted);
+
+    model.appendFrames(makeBatch(0, 100), std::vector<double>(100, 0.0));
+
+    CHECK(model.rowCount() == 100);
+    CHECK(inserted.count() == 1);
+}
+
+TEST_CASE("Oldest rows are evicted when retention is reached", "[frametablemodel]")
+{
+    FrameTableModel model;
+    model.setRetention(10);
+    QSignalSpy removed(&model, &FrameTableModel::rowsRemoved);
+
+    model.appendFrames(makeBatch(0, 8), std::vector<double>(8, 0.0));
+    CHECK(removed.count() == 0);
+
+    model.appendFrames(makeBatch(8, 5), std::vector<double>(5, 0.0));
+    CHECK(removed.count() == 1);
+    CHECK(model.rowCount() == 10);
+    CHECK(model.evictedCount() == 3);
+    CHECK(model.frameId(0) == 3);
+    CHECK(model.seq(0) == 3);
+    CHECK(model.frameId(9) == 12);
+
+    // Batch larger than retention keeps only the newest frames
+    model.appendFrames(makeBatch(100, 25), std::vector<double>(25, 0.0));
+    CHECK(model.rowCount() == 10);
+    CHECK(model.frameId(0) == 115);
+    CHECK(model.frameId(9) == 124);
+    CHECK(model.seq(9) == 37);
+}
+
+TEST_CASE("Clear resets model", "[frametablemodel]")
+{
+    FrameTableModel model;
+
+    model.appendFrames(makeBatch(0, 5), std::vector<double>(5, 0.0));
+    model.clear();
+
+    CHECK(model.rowCount() == 0);
+    CHECK(model.evictedCount() == 0);
+
+    model.appendFrames(makeBatch(7, 1), { 0.0 });
+    CHECK(model.seq(0) == 0);
+    CHECK(model.record(0).id == 7);
+}
+
+TEST_CASE("Standard and extended frames with the same id are both latest", "[frametablemodel]")
+{
+    FrameTableModel model;
+    CanFrameBatch batch = makeBatch(0x123, 1);
+    batch.append(batch[0]);
+    batch[1].flags |= CanFrameRecord::ExtendedId;
+
+    // No directory, pairs are tracked in hash
+    model.appendFrames(batch, { 0.0, 0.1 });
+    REQUIRE(model.rowCount() == 2);
+    CHECK(model.isLatest(0));
+    CHECK(model.isLatest(1));
+
+    model.appendFrames(makeBatch(0x123, 1), { 0.2 });
+    CHECK_FALSE(model.isLatest(0));
+    CHECK(model.isLatest(1));
+    CHECK(model.isLatest(2));
+}
+
+TEST_CASE("Latest frames survive directory swap", "[frametablemodel]")
+{
+    FrameTableModel model;
+    auto directory = std::make_shared<FrameIdDirectory>();
+    directory->intern(0x123, false);
+    directory->intern(0x123, true);
+    model.setIdDirectory(directory);
+
+    CanFrameBatch batch = makeBatch(0x123, 1);
+    batch.append(batch[0]);
+    batch[1].flags |= CanFrameRecord::ExtendedId;
+    model.appendFrames(batch, { 0.0, 0.1 });
+    REQUIRE(model.isLatest(0));
+    REQUIRE(model.isLatest(1));
+
+    // Pairs indexed by handles of old directory move to hash, formats stay apart
+    model.setIdDirectory(nullptr);
+    CHECK(model.isLatest(0));
+    CHECK(model.isLatest(1));
+
+    model.appendFrames(makeBatch(0x123, 1), { 0.2 });
+    CHECK_FALSE(model.isLatest(0));
+    CHECK(model.isLatest(1));
+    CHECK(model.isLatest(2));
+}
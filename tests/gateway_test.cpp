@@ -0,0 +1,215 @@
+#define CATCH_CONFIG_RUNNER
+#include <QSignalSpy>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <catch.hpp>
+#include <gateway.h>
+#include <gatewaytable.h>
+#include <log.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, bool extended)
+{
+    QCanBusFrame frame(id, QByteArray::fromHex("0102"));
+    frame.setExtendedFrameFormat(extended);
+
+    return toCanFrameRecord(frame, Direction::RX);
+}
+
+QJsonObject route(quint32 id, quint32 targetId, int channel)
+{
+    return { { "id", static_cast<double>(id) }, { "targetId", static_cast<double>(targetId) }, { "channel", channel } };
+}
+} // namespace
+
+TEST_CASE("Standard and extended ids are looked up", "[gateway]")
+{
+    GatewayTable table;
+    QJsonArray routes;
+
+    routes.append(route(0x123, 0x456, 1));
+    routes.append(route(0x18daf110, 0x18daf120, 2));
+    // Ids of both formats are independent, 0x100 extended does not collide with 0x100 standard
+    routes.append(
+        QJsonObject{ { "id", 0x100 }, { "extended", true }, { "targetId", 0x7ff }, { "targetExtended", false } });
+
+    REQUIRE(table.compile(routes, Gateway::kMaxChannels) == 3);
+    CHECK(table.size() == 3);
+
+    auto base = table.lookup(0x123, false);
+    REQUIRE(base != nullptr);
+    CHECK(base->targetId == 0x456);
+    CHECK(base->channel == 1);
+    CHECK_FALSE(base->extended());
+    CHECK_FALSE(base->drop());
+
+    auto ext = table.lookup(0x18daf110, true);
+    REQUIRE(ext != nullptr);
+    CHECK(ext->targetId == 0x18daf120);
+    CHECK(ext->channel == 2);
+    CHECK(ext->extended());
+
+    auto mixed = table.lookup(0x100, true);
+    REQUIRE(mixed != nullptr);
+    CHECK(mixed->targetId == 0x7ff);
+    CHECK_FALSE(mixed->extended());
+
+    CHECK(table.lookup(0x100, false) == nullptr);
+    CHECK(table.lookup(0x123, true) == nullptr);
+    CHECK(table.lookup(0x18daf111, true) == nullptr);
+    CHECK(table.lookup(0x923, false) == nullptr);
+}
+
+TEST_CASE("Many extended routes", "[gateway]")
+{
+    GatewayTable table;
+    QJsonArray routes;
+
+    for (quint32 i = 0; i < 1000; ++i) {
+        routes.append(route(0x10000000 + i * 7, i, 0));
+    }
+
+    REQUIRE(table.compile(routes, Gateway::kMaxChannels) == 1000);
+
+    for (quint32 i = 0; i < 1000; ++i) {
+        auto r = table.lookup(0x10000000 + i * 7, true);
+        REQUIRE(r != nullptr);
+        CHECK(r->targetId == i);
+    }
+
+    CHECK(table.lookup(0x10000001, true) == nullptr);
+}
+
+TEST_CASE("Invalid routes are skipped and later route wins", "[gateway]")
+{
+    GatewayTable table;
+    QJsonArray routes;
+
+    routes.append(QJsonObject{ { "targetId", 0x10 } });
+    routes.append(route(0x123, 0x10, Gateway::kMaxChannels));
+    routes.append(QJsonObject{ { "id", 0x800 }, { "extended", false } });
+    routes.append(route(0x200, 0x10, 0));
+    routes.append(route(0x200, 0x20, 3));
+    routes.append(QJsonObject{ { "id", 0x300 }, { "drop", true } });
+
+    CHECK(table.compile(routes, Gateway::kMaxChannels) == 3);
+    CHECK(table.size() == 2);
+    CHECK(table.routes() == routes);
+
+    auto r = table.lookup(0x200, false);
+    REQUIRE(r != nullptr);
+    CHECK(r->targetId == 0x20);
+    CHECK(r->channel == 3);
+
+    auto dropped = table.lookup(0x300, false);
+    REQUIRE(dropped != nullptr);
+    CHECK(dropped->drop());
+
+    // Dropped ids are not forwarded, so device does not need to receive them
+    const CanFilterList filters = table.forwardedIds();
+    REQUIRE(filters.size() == 1);
+    CHECK(filters[0].frameId == 0x200);
+}
+
+TEST_CASE("Acceptance filters follow routes", "[gateway]")
+{
+    Gateway gateway;
+    QJsonObject config{ { "routes", QJsonArray{ route(0x123, 0x456, 0) } } };
+
+    gateway.setConfig(config);
+    CHECK(gateway.acceptanceFilters().size() == 1);
+
+    config = QJsonObject{ { "routes", QJsonArray() } };
+    gateway.setConfig(config);
+    // Nothing is routed, filter must not be empty as empty list accepts everything
+    REQUIRE(gateway.acceptanceFilters().size() == 1);
+    CHECK(gateway.acceptanceFilters()[0].format == QCanBusDevice::Filter::MatchBaseFormat);
+
+    config = QJsonObject{ { "forwardUnmatched", true } };
+    gateway.setConfig(config);
+    CHECK(gateway.acceptanceFilters().isEmpty());
+    CHECK(gateway.getConfig()["forwardUnmatched"].toBool());
+}
+
+TEST_CASE("Frames passed through node graph are routed to channels", "[gateway]")
+{
+    Gateway gateway;
+    QSignalSpy spy(&gateway, &Gateway::framesRouted);
+    QJsonArray routes{ route(0x123, 0x18daf110, 2), route(0x18daf120, 0x7e8, 1),
+        QJsonObject{ { "id", 0x300 }, { "drop", true } } };
+    QJsonObject config{ { "routes", routes } };
+
+    gateway.setConfig(config);
+    gateway.startSimulation();
+
+    CanFrameBatch frames;
+    frames.append(makeRecord(0x123, false));
+    frames.append(makeRecord(0x18daf120, true));
+    frames.append(makeRecord(0x300, false));
+    frames.append(makeRecord(0x400, false));
+    gateway.frameBatchReceived(frames);
+
+    // Channels are emitted in order
+    REQUIRE(spy.count() == 2);
+    CHECK(spy[0][0].toInt() == 1);
+    auto ch1 = spy[0][1].value<CanFrameBatch>();
+    REQUIRE(ch1.size() == 1);
+    CHECK(ch1[0].id == 0x7e8);
+    CHECK_FALSE(ch1[0].hasFlag(CanFrameRecord::ExtendedId));
+
+    CHECK(spy[1][0].toInt() == 2);
+    auto ch2 = spy[1][1].value<CanFrameBatch>();
+    REQUIRE(ch2.size() == 1);
+    CHECK(ch2[0].id == 0x18daf110);
+    CHECK(ch2[0].hasFlag(CanFrameRecord::ExtendedId));
+    CHECK(ch2[0].length == 2);
+
+    CHECK(gateway.framesForwarded() == 2);
+    CHECK(gateway.framesDropped() == 2);
+
+    gateway.stopSimulation();
+}
+
+TEST_CASE("Unmatched frames are forwarded unchanged to channel 0", "[gateway]")
+{
+    Gateway gateway;
+    QSignalSpy spy(&gateway, &Gateway::framesRouted);
+    QJsonObject config{ { "forwardUnmatched", true } };
+
+    gateway.setConfig(config);
+    gateway.startSimulation();
+
+    gateway.frameBatchReceived({ makeRecord(0x1abcdef, true) });
+
+    REQUIRE(spy.count() == 1);
+    CHECK(spy[0][0].toInt() == 0);
+    auto out = spy[0][1].value<CanFrameBatch>();
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].id == 0x1abcdef);
+    CHECK(out[0].hasFlag(CanFrameRecord::ExtendedId));
+}
+
+TEST_CASE("Targets of invalid channels are ignored", "[gateway]")
+{
+    Gateway gateway;
+
+    gateway.setTarget(Gateway::kMaxChannels, reinterpret_cast<CanDevice*>(1));
+    CHECK(gateway.target(Gateway::kMaxChannels) == nullptr);
+    CHECK(gateway.target(0) == nullptr);
+    CHECK(gateway.source() == nullptr);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    qRegisterMetaType<CanFrameBatch>(); // required by QSignalSpy
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
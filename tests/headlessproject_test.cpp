@@ -0,0 +1,216 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QTemporaryDir>
+#include <candevice.h>
+#include <canrawview.h>
+#include <catch.hpp>
+#include <headlessproject.h>
+#include <log.h>
+#include <projectfile.h>
+#include <tracelogger.h>
+#include <tracelogger/tracewriter.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+QJsonObject node(const QString& id, QJsonObject model)
+{
+    return QJsonObject{ { "id", id }, { "model", model } };
+}
+
+QJsonObject connection(const QString& outId, const QString& inId)
+{
+    return QJsonObject{ { "out_id", outId }, { "out_index", 0 }, { "in_id", inId }, { "in_index", 0 } };
+}
+} // namespace
+
+TEST_CASE("Project runs headless and frames go straight to consumers", "[headless]")
+{
+    QTemporaryDir dir;
+    const QString trace = dir.path() + "/headless.cdst";
+    QJsonObject project;
+
+    project["nodes"] = QJsonArray{ node("dev", { { "name", "CanDeviceModel" } }),
+        node("log", { { "name", "TraceLoggerModel" }, { "file", trace }, { "flushInterval", 60000 } }),
+        node("view", { { "name", "CanRawViewModel" } }), node("sender", { { "name", "CanRawSenderModel" } }) };
+    project["connections"]
+        = QJsonArray{ connection("dev", "log"), connection("dev", "view"), connection("sender", "dev") };
+
+    HeadlessProject headless;
+    REQUIRE(headless.load(project, dir.path()));
+    CHECK(headless.nodeCount() == 4);
+    CHECK(headless.component("none") == nullptr);
+
+    auto device = dynamic_cast<CanDevice*>(headless.component("dev"));
+    auto logger = dynamic_cast<TraceLogger*>(headless.component("log"));
+    auto view = headless.component("view");
+    REQUIRE(device);
+    REQUIRE(logger);
+    REQUIRE(view);
+    CHECK(view->getMainWidget() == nullptr);
+
+    headless.startSimulation();
+    // Device has no backend configured, frames are injected as if backend delivered them
+    emit device->frameBatchReceived({ QCanBusFrame(0x10, QByteArray(2, 1)), QCanBusFrame(0x11, QByteArray()) });
+    emit device->frameBatchSent(false, { QCanBusFrame(0x20, QByteArray()) });
+    headless.stopSimulation();
+
+    CHECK(logger->framesWritten() == 3);
+}
+
+TEST_CASE("Binary project file is loaded", "[headless]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/binary.cds";
+    const QString trace = dir.path() + "/binary.cdst";
+    const std::vector<QJsonObject> nodes{ node("dev", { { "name", "CanDeviceModel" } }),
+        node("log", { { "name", "TraceLoggerModel" }, { "file", trace }, { "flushInterval", 60000 } }) };
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    REQUIRE(ProjectFile::write(file, nodes, { connection("dev", "log") }));
+    file.close();
+
+    HeadlessProject headless;
+    REQUIRE(headless.load(path));
+    CHECK(headless.nodeIds() == QStringList({ "dev", "log" }));
+
+    auto device = dynamic_cast<CanDevice*>(headless.component("dev"));
+    auto logger = dynamic_cast<TraceLogger*>(headless.component("log"));
+    REQUIRE(device);
+    REQUIRE(logger);
+    CHECK(logger->getConfig()["file"].toString() == trace);
+
+    headless.startSimulation();
+    emit device->frameBatchReceived({ QCanBusFrame(0x10, QByteArray(2, 1)) });
+    headless.stopSimulation();
+
+    CHECK(logger->framesWritten() == 1);
+}
+
+TEST_CASE("Running project is edited without restart", "[headless]")
+{
+    QTemporaryDir dir;
+    QJsonObject project;
+
+    project["nodes"] = QJsonArray{ node("dev", { { "name", "CanDeviceModel" } }),
+        node("view", { { "name", "CanRawViewModel" } }) };
+    project["connections"] = QJsonArray{ connection("dev", "view") };
+
+    HeadlessProject headless;
+    REQUIRE(headless.load(project, dir.path()));
+    auto device = dynamic_cast<CanDevice*>(headless.component("dev"));
+    auto view = headless.component("view");
+    REQUIRE(device);
+
+    headless.startSimulation();
+    emit device->frameBatchReceived({ QCanBusFrame(0x10, QByteArray(2, 1)), QCanBusFrame(0x11, QByteArray()) });
+
+    // Logger joins running simulation, view and device are kept
+    const QString trace = dir.path() + "/edit.cdst";
+    QJsonArray nodes = project["nodes"].toArray();
+    nodes.append(node("log", { { "name", "TraceLoggerModel" }, { "file", trace }, { "flushInterval", 60000 } }));
+    project["nodes"] = nodes;
+    project["connections"] = QJsonArray{ connection("dev", "view"), connection("dev", "log") };
+    REQUIRE(headless.update(project, dir.path()));
+    CHECK(headless.nodeCount() == 3);
+    CHECK(headless.component("dev") == device);
+    CHECK(headless.component("view") == view);
+
+    auto logger = dynamic_cast<TraceLogger*>(headless.component("log"));
+    REQUIRE(logger);
+    emit device->frameBatchReceived({ QCanBusFrame(0x12, QByteArray(1, 2)) });
+    headless.flush();
+    CHECK(headless.nodeStats("view").framesIn == 3);
+    CHECK(headless.nodeStats("log").framesIn == 1);
+
+    // Node that cannot run headless rejects the whole edit
+    QJsonObject invalid = project;
+    nodes.append(node("bad", { { "name", "Unknown" } }));
+    invalid["nodes"] = nodes;
+    CHECK_FALSE(headless.update(invalid, dir.path()));
+    CHECK(headless.nodeCount() == 3);
+
+    // View and its connection go, logger keeps receiving
+    project["nodes"] = QJsonArray{ node("dev", { { "name", "CanDeviceModel" } }),
+        node("log", { { "name", "TraceLoggerModel" }, { "file", trace }, { "flushInterval", 60000 } }) };
+    project["connections"] = QJsonArray{ connection("dev", "log") };
+    REQUIRE(headless.update(project, dir.path()));
+    CHECK(headless.nodeCount() == 2);
+    CHECK(headless.component("view") == nullptr);
+    CHECK(headless.component("log") == logger);
+
+    emit device->frameBatchReceived({ QCanBusFrame(0x13, QByteArray()) });
+    headless.stopSimulation();
+    CHECK(logger->framesWritten() == 2);
+}
+
+TEST_CASE("Replays removed or made looping while running finish project", "[headless]")
+{
+    QTemporaryDir dir;
+    const QString trace = dir.path() + "/replay.cdst";
+    CanFrameBatch batch;
+
+    // 100 s of traffic, replays do not end by themselves during test
+    for (int i = 0; i < 100; ++i) {
+        CanFrameRecord rec = toCanFrameRecord(QCanBusFrame(static_cast<quint32>(i), QByteArray()));
+        rec.timestamp = static_cast<quint64>(i) * 1000000;
+        batch.append(rec);
+    }
+    TraceWriter writer;
+    REQUIRE(writer.open(trace));
+    writer.append(batch);
+    writer.close();
+
+    const QJsonObject replay{ { "name", "TraceReplayModel" }, { "file", trace }, { "loop", false } };
+    QJsonObject looping = replay;
+    looping["loop"] = true;
+    QJsonObject project;
+    project["nodes"] = QJsonArray{ node("a", replay), node("b", replay) };
+
+    HeadlessProject headless;
+    int finished = 0;
+    QObject::connect(&headless, &HeadlessProject::replaysFinished, [&finished] { ++finished; });
+    REQUIRE(headless.load(project, dir.path()));
+    headless.startSimulation();
+
+    project["nodes"] = QJsonArray{ node("a", replay) };
+    REQUIRE(headless.update(project, dir.path()));
+    CHECK(finished == 0);
+
+    project["nodes"] = QJsonArray{ node("a", looping) };
+    REQUIRE(headless.update(project, dir.path()));
+    CHECK(finished == 1);
+
+    headless.stopSimulation();
+}
+
+TEST_CASE("Project with node that cannot run headless is rejected", "[headless]")
+{
+    QJsonObject project;
+    project["nodes"] = QJsonArray{ node("a", { { "name", "CanDeviceModel" } }), node("b", { { "name", "Unknown" } }) };
+
+    HeadlessProject headless;
+    CHECK(!headless.load(project, QString()));
+    CHECK(headless.nodeCount() == 0);
+
+    // Views cannot feed devices
+    project["nodes"] = QJsonArray{ node("a", { { "name", "CanDeviceModel" } }),
+        node("b", { { "name", "CanRawViewModel" } }) };
+    project["connections"] = QJsonArray{ connection("b", "a") };
+    CHECK(!headless.load(project, QString()));
+}
+
+int main(int argc, char* argv[])
+{
+    // No QApplication, creating any widget would abort
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
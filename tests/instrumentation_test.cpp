@@ -0,0 +1,68 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include <instrumentation.h>
+#include <thread>
+#include <vector>
+
+using namespace Instrumentation;
+
+TEST_CASE("Counters of all threads are summed", "[instrumentation]")
+{
+    const Snapshot before = snapshot();
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 10000; ++i) {
+                add(Counter::RxFrames);
+            }
+            add(Counter::TxFailed, 5);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Blocks of finished threads are kept
+    const Snapshot delta = snapshot() - before;
+    CHECK(delta.counter(Counter::RxFrames) == 40000);
+    CHECK(delta.counter(Counter::TxFailed) == 20);
+    CHECK(delta.counter(Counter::TxConfirmed) == 0);
+}
+
+TEST_CASE("Histogram percentiles are bounded by bins", "[instrumentation]")
+{
+    const Snapshot before = snapshot();
+
+    for (int i = 0; i < 98; ++i) {
+        record(Histogram::ReadToViewUs, 100);
+    }
+    record(Histogram::ReadToViewUs, 0);
+    record(Histogram::ReadToViewUs, 5000);
+
+    const HistogramSnapshot h = (snapshot() - before).histogram(Histogram::ReadToViewUs);
+    CHECK(h.count == 100);
+    CHECK(h.sum == 98 * 100 + 5000);
+    CHECK(h.mean() == Approx(148.0));
+    CHECK(h.bins[0] == 1);
+    CHECK(h.bins[histogramBin(100)] == 98);
+    // 100 falls into [64, 128)
+    CHECK(h.percentile(0.5) == 128);
+    CHECK(h.percentile(1.0) == 5000);
+    CHECK(h.max >= 5000);
+
+    CHECK(HistogramSnapshot().percentile(0.99) == 0);
+    CHECK(histogramBin(0) == 0);
+    CHECK(histogramBin(1) == 1);
+    CHECK(histogramBin(~0ULL) == kHistogramBins - 1);
+}
+
+TEST_CASE("Snapshot is formatted per line", "[instrumentation]")
+{
+    Snapshot s;
+    s.counters[static_cast<int>(Counter::RxFrames)] = 500;
+
+    const QString str = toString(s, 2.0);
+    CHECK(str.split('\n').size() == kCounters + kHistograms);
+    CHECK(str.startsWith("rx frames: 500 (250/s)"));
+}
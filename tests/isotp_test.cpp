@@ -0,0 +1,317 @@
+#define CATCH_CONFIG_RUNNER
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <catch.hpp>
+#include <deque>
+#include <isotp/isotp.h>
+#include <isotp/isotpchannel.h>
+#include <log.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+// Two channels talking to each other, frames are passed through queue so that nothing is handled re-entrantly
+struct Link {
+    explicit Link(IsoTpChannelConfig a = IsoTpChannelConfig(), IsoTpChannelConfig b = IsoTpChannelConfig())
+    {
+        b.rxId = a.txId;
+        b.txId = a.rxId;
+        b.extendedId = a.extendedId;
+
+        client.reset(new IsoTpChannel(a, callbacks(true)));
+        server.reset(new IsoTpChannel(b, callbacks(false)));
+    }
+
+    IsoTpChannel::Callbacks callbacks(bool isClient)
+    {
+        IsoTpChannel::Callbacks cb;
+
+        cb.sendFrame = [this, isClient](const QCanBusFrame& frame) {
+            queue.emplace_back(isClient, frame);
+            (isClient ? clientFrames : serverFrames).push_back(frame);
+        };
+        cb.sendBlock = [this, isClient](const QVector<QCanBusFrame>& frames, std::chrono::microseconds st) {
+            separation = st;
+            ++blocks;
+            for (const auto& frame : frames) {
+                queue.emplace_back(isClient, frame);
+                (isClient ? clientFrames : serverFrames).push_back(frame);
+            }
+            // Frames are emitted right away unless test holds them in scheduler
+            if (!holdBlocks) {
+                (isClient ? client : server)->blockSent();
+            }
+        };
+        cb.pduReceived = [this](const IsoTpPdu& pdu) {
+            received = QByteArray(reinterpret_cast<const char*>(pdu.data), static_cast<int>(pdu.length));
+        };
+        cb.failed = [this](IsoTpError error) { errors.push_back(error); };
+
+        return cb;
+    }
+
+    void pump()
+    {
+        while (!queue.empty()) {
+            const auto item = queue.front();
+            queue.pop_front();
+            (item.first ? server : client)->receive(toCanFrameRecord(item.second, Direction::RX));
+        }
+    }
+
+    std::unique_ptr<IsoTpChannel> client;
+    std::unique_ptr<IsoTpChannel> server;
+    std::deque<std::pair<bool, QCanBusFrame>> queue;
+    std::vector<QCanBusFrame> clientFrames;
+    std::vector<QCanBusFrame> serverFrames;
+    std::vector<IsoTpError> errors;
+    QByteArray received;
+    std::chrono::microseconds separation{ 0 };
+    int blocks{ 0 };
+    bool holdBlocks{ false };
+};
+
+QByteArray pattern(int length)
+{
+    QByteArray data(length, '\0');
+
+    for (int i = 0; i < length; ++i) {
+        data[i] = static_cast<char>(i * 7);
+    }
+
+    return data;
+}
+
+bool send(IsoTpChannel& channel, const QByteArray& data)
+{
+    return channel.send(reinterpret_cast<const quint8*>(data.constData()), static_cast<quint32>(data.size()));
+}
+
+void spin(int ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < ms) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+}
+} // namespace
+
+TEST_CASE("Single frame is padded and reassembled", "[isotp]")
+{
+    Link link;
+
+    REQUIRE(send(*link.client, QByteArray("\x22\xf1\x90", 3)));
+    REQUIRE(link.clientFrames.size() == 1);
+    CHECK(link.clientFrames[0].frameId() == 0x7e0);
+    CHECK(link.clientFrames[0].payload() == QByteArray::fromHex("0322f190cccccccc"));
+    CHECK_FALSE(link.client->isSending());
+
+    link.pump();
+    CHECK(link.received == QByteArray("\x22\xf1\x90", 3));
+    CHECK(link.errors.empty());
+}
+
+TEST_CASE("Segmented transfer follows block size of receiver", "[isotp]")
+{
+    IsoTpChannelConfig server;
+    server.blockSize = 4;
+    server.stMin = 0xf5;
+    Link link(IsoTpChannelConfig(), server);
+    const QByteArray data = pattern(100);
+
+    REQUIRE(send(*link.client, data));
+    CHECK(link.client->isSending());
+    CHECK(link.clientFrames[0].payload().left(2) == QByteArray::fromHex("1064"));
+
+    link.pump();
+    CHECK(link.received == data);
+    CHECK(link.errors.empty());
+    CHECK_FALSE(link.client->isSending());
+    CHECK_FALSE(link.server->isReceiving());
+
+    // 6 bytes in first frame, 94 in 14 consecutive frames sent in blocks of 4
+    CHECK(link.clientFrames.size() == 15);
+    CHECK(link.blocks == 4);
+    CHECK(link.serverFrames.size() == 4);
+    CHECK(link.serverFrames[0].payload() == QByteArray::fromHex("3004f5cccccccccc"));
+    CHECK(link.separation == std::chrono::microseconds(500));
+    CHECK(static_cast<quint8>(link.clientFrames[1].payload()[0]) == 0x21);
+    CHECK(static_cast<quint8>(link.clientFrames[14].payload()[0]) == 0x2e);
+}
+
+TEST_CASE("Channel is busy until last consecutive frame is sent", "[isotp]")
+{
+    Link link;
+    link.holdBlocks = true;
+
+    REQUIRE(send(*link.client, pattern(20)));
+    link.pump();
+    CHECK(link.received == pattern(20));
+    CHECK(link.blocks == 1);
+
+    // Flow control came and all frames are handed over, but owner did not emit them yet
+    CHECK(link.client->isSending());
+    CHECK_FALSE(send(*link.client, pattern(3)));
+    CHECK(link.errors.back() == IsoTpError::Busy);
+
+    link.client->blockSent();
+    CHECK_FALSE(link.client->isSending());
+    CHECK(send(*link.client, pattern(3)));
+}
+
+TEST_CASE("CAN FD channel uses 64 byte frames and long first frame", "[isotp]")
+{
+    IsoTpChannelConfig config;
+    config.canFd = true;
+    config.maxPduLength = 8192;
+
+    SECTION("Single frame escape")
+    {
+        Link link(config, config);
+        const QByteArray data = pattern(40);
+
+        REQUIRE(send(*link.client, data));
+        REQUIRE(link.clientFrames.size() == 1);
+        CHECK(link.clientFrames[0].payload().size() == 48);
+        CHECK(link.clientFrames[0].payload().left(2) == QByteArray::fromHex("0028"));
+        link.pump();
+        CHECK(link.received == data);
+    }
+
+    SECTION("Long form")
+    {
+        Link link(config, config);
+        const QByteArray data = pattern(5000);
+
+        REQUIRE(send(*link.client, data));
+        CHECK(link.clientFrames[0].payload().size() == 64);
+        CHECK(link.clientFrames[0].payload().left(6) == QByteArray::fromHex("100000001388"));
+        link.pump();
+        CHECK(link.received == data);
+        CHECK(link.errors.empty());
+        // Last consecutive frame is padded to DLC step
+        CHECK(canFdLength(link.clientFrames.back().payload().size()) == link.clientFrames.back().payload().size());
+    }
+}
+
+TEST_CASE("Receiver overflow aborts transfer on both sides", "[isotp]")
+{
+    IsoTpChannelConfig server;
+    server.maxPduLength = 50;
+    Link link(IsoTpChannelConfig(), server);
+
+    REQUIRE(send(*link.client, pattern(100)));
+    link.pump();
+
+    CHECK(link.received.isEmpty());
+    REQUIRE(link.serverFrames.size() == 1);
+    CHECK(static_cast<quint8>(link.serverFrames[0].payload()[0]) == 0x32);
+    REQUIRE(link.errors.size() == 2);
+    CHECK(link.errors[0] == IsoTpError::Overflow);
+    CHECK(link.errors[1] == IsoTpError::Overflow);
+    CHECK_FALSE(link.client->isSending());
+}
+
+TEST_CASE("Wrong sequence number and timeouts abort reception", "[isotp]")
+{
+    Link link;
+
+    link.server->receive(toCanFrameRecord(QCanBusFrame(0x7e0, QByteArray::fromHex("1014000102030405"))));
+    CHECK(link.server->isReceiving());
+    link.server->receive(toCanFrameRecord(QCanBusFrame(0x7e0, QByteArray::fromHex("2206070809101112"))));
+    CHECK_FALSE(link.server->isReceiving());
+    REQUIRE(link.errors.size() == 1);
+    CHECK(link.errors[0] == IsoTpError::WrongSequence);
+
+    link.server->receive(toCanFrameRecord(QCanBusFrame(0x7e0, QByteArray::fromHex("1014000102030405"))));
+    link.server->expire(canTimestampNow() + 2 * IsoTpChannel::kTimeoutUs);
+    CHECK_FALSE(link.server->isReceiving());
+    CHECK(link.errors.back() == IsoTpError::ConsecutiveFrameTimeout);
+
+    REQUIRE(send(*link.client, pattern(20)));
+    CHECK_FALSE(send(*link.client, pattern(20)));
+    CHECK(link.errors.back() == IsoTpError::Busy);
+    link.client->expire(canTimestampNow() + 2 * IsoTpChannel::kTimeoutUs);
+    CHECK_FALSE(link.client->isSending());
+    CHECK(link.errors.back() == IsoTpError::FlowControlTimeout);
+
+    // Frames of other ids and own transmissions are not consumed
+    CHECK_FALSE(link.server->receive(toCanFrameRecord(QCanBusFrame(0x7df, QByteArray::fromHex("0201")))));
+    CHECK_FALSE(
+        link.server->receive(toCanFrameRecord(QCanBusFrame(0x7e0, QByteArray::fromHex("0201")), Direction::TX)));
+}
+
+TEST_CASE("Separation time encoding", "[isotp]")
+{
+    CHECK(IsoTpChannel::separationTime(0) == std::chrono::microseconds(0));
+    CHECK(IsoTpChannel::separationTime(0x14) == std::chrono::milliseconds(20));
+    CHECK(IsoTpChannel::separationTime(0xf1) == std::chrono::microseconds(100));
+    CHECK(IsoTpChannel::separationTime(0xf9) == std::chrono::microseconds(900));
+    CHECK(IsoTpChannel::separationTime(0x80) == std::chrono::milliseconds(127));
+}
+
+TEST_CASE("Components exchange PDU paced by scheduler", "[isotp]")
+{
+    IsoTp client;
+    IsoTp server;
+    QJsonObject clientConfig{ { "channels", QJsonArray{ QJsonObject{ { "rxId", 0x18daf110 }, { "txId", 0x18da10f1 },
+                                               { "extended", true } } } } };
+    QJsonObject serverConfig{ { "channels", QJsonArray{ QJsonObject{ { "rxId", 0x18da10f1 }, { "txId", 0x18daf110 },
+                                               { "extended", true } } } },
+        { "blockSize", 3 }, { "stMin", 1 } };
+
+    client.setConfig(clientConfig);
+    server.setConfig(serverConfig);
+    CHECK(server.getConfig()["blockSize"].toInt() == 3);
+    REQUIRE(server.channelCount() == 1);
+    REQUIRE(server.acceptanceFilters().size() == 1);
+    CHECK(server.acceptanceFilters()[0].frameId == 0x18da10f1);
+
+    const auto wire = [](IsoTp& from, IsoTp& to) {
+        QObject::connect(&from, &IsoTp::sendFrames, &to, [&to](const QVector<QCanBusFrame>& frames) {
+            to.frameBatchReceived(toCanFrameBatch(frames, Direction::RX));
+        });
+    };
+    wire(client, server);
+    wire(server, client);
+
+    QByteArray received;
+    QObject::connect(&server, &IsoTp::pduReceived, [&received](const IsoTpPdu& pdu) {
+        CHECK(pdu.rxId == 0x18da10f1);
+        received = QByteArray(reinterpret_cast<const char*>(pdu.data), static_cast<int>(pdu.length));
+    });
+
+    client.startSimulation();
+    server.startSimulation();
+
+    const QByteArray data = pattern(300);
+    client.sendPdu(IsoTpPdu{ 0x18daf110, 0x18da10f1, reinterpret_cast<const quint8*>(data.constData()),
+        static_cast<quint32>(data.size()), 0 });
+
+    QElapsedTimer timer;
+    timer.start();
+    while (received.isEmpty() && (timer.elapsed() < 2000)) {
+        spin(5);
+    }
+
+    // 42 consecutive frames in blocks of 3, 1 ms apart within block
+    CHECK(received == data);
+    CHECK(timer.elapsed() >= 25);
+
+    client.stopSimulation();
+    server.stopSimulation();
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
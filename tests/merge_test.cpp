@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_RUNNER
+#include <QSignalSpy>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
+#include <catch.hpp>
+#include <log.h>
+#include <merge.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, quint64 timestamp)
+{
+    CanFrameRecord rec = toCanFrameRecord(QCanBusFrame(id, QByteArray(1, 0)), Direction::RX);
+    rec.timestamp = timestamp;
+
+    return rec;
+}
+
+// Frames of one id, timestamps in microseconds
+CanFrameBatch makeBatch(quint32 id, std::initializer_list<quint64> timestamps)
+{
+    CanFrameBatch batch;
+
+    for (auto timestamp : timestamps) {
+        batch.append(makeRecord(id, timestamp));
+    }
+
+    return batch;
+}
+
+struct Collector {
+    explicit Collector(Merge& merge)
+    {
+        QObject::connect(&merge, &Merge::framesMerged, [this](const CanFrameBatch& frames) { merged += frames; });
+    }
+
+    CanFrameBatch merged;
+};
+
+void configure(Merge& merge, double window)
+{
+    QJsonObject config{ { "reorderWindow", window } };
+    merge.setConfig(config);
+}
+} // namespace
+
+TEST_CASE("Channels are merged by timestamp and tagged", "[merge]")
+{
+    Merge merge;
+    Collector out(merge);
+
+    configure(merge, 1.0);
+    merge.startSimulation();
+
+    merge.channelReceived(0, makeBatch(0x100, { 10, 30, 50 }));
+    // Channel 1 has not delivered anything yet, so only channel 0 is active
+    CHECK(out.merged.size() == 3);
+
+    merge.channelReceived(1, makeBatch(0x200, { 60, 80 }));
+    merge.channelReceived(2, makeBatch(0x300, { 75 }));
+    CHECK(out.merged.size() == 3);
+
+    merge.channelReceived(0, makeBatch(0x100, { 70, 90 }));
+    CHECK(out.merged.size() == 6);
+
+    merge.flush();
+    REQUIRE(out.merged.size() == 8);
+
+    for (int i = 1; i < out.merged.size(); ++i) {
+        CHECK(out.merged[i - 1].timestamp <= out.merged[i].timestamp);
+    }
+    for (const auto& rec : out.merged) {
+        CHECK(rec.channel == (rec.id >> 8));
+    }
+    CHECK(merge.pendingFrames() == 0);
+}
+
+TEST_CASE("Frames wait for other active channels within reorder window", "[merge]")
+{
+    Merge merge;
+    Collector out(merge);
+
+    configure(merge, 0.001);
+    merge.startSimulation();
+
+    merge.channelReceived(0, makeBatch(0x100, { 1000 }));
+    merge.channelReceived(1, makeBatch(0x200, { 1100 }));
+    // Both heads known, 1000 released, 1100 waits for channel 0
+    REQUIRE(out.merged.size() == 1);
+    CHECK(out.merged[0].timestamp == 1000);
+
+    merge.channelReceived(0, makeBatch(0x100, { 1200, 1500 }));
+    REQUIRE(out.merged.size() == 2);
+    CHECK(out.merged[1].timestamp == 1100);
+    CHECK(merge.pendingFrames() == 2);
+
+    // Channel 1 is quiet, frames older than newest by more than window are released
+    merge.channelReceived(0, makeBatch(0x100, { 2600 }));
+    REQUIRE(out.merged.size() == 4);
+    CHECK(out.merged[2].timestamp == 1200);
+    CHECK(out.merged[3].timestamp == 1500);
+    CHECK(merge.pendingFrames() == 1);
+
+    // Frame of channel 1 arriving after window is released out of order and counted
+    merge.channelReceived(1, makeBatch(0x200, { 1400 }));
+    merge.flush();
+    CHECK(merge.lateFrames() == 1);
+}
+
+TEST_CASE("Queued frames are released when channels go quiet", "[merge]")
+{
+    Merge merge;
+    QSignalSpy spy(&merge, &Merge::framesMerged);
+
+    configure(merge, 0.01);
+    merge.startSimulation();
+
+    merge.channelReceived(0, makeBatch(0x100, { 1000 }));
+    merge.channelReceived(1, makeBatch(0x200, { 2000, 3000 }));
+    REQUIRE(spy.count() == 1);
+    CHECK(merge.pendingFrames() == 2);
+
+    REQUIRE(spy.wait(1000));
+    CHECK(merge.pendingFrames() == 0);
+    CHECK(spy.last().at(0).value<CanFrameBatch>().size() == 2);
+}
+
+TEST_CASE("Failed transmissions and invalid channels are ignored", "[merge]")
+{
+    Merge merge;
+    Collector out(merge);
+
+    merge.startSimulation();
+    merge.channelSent(0, false, makeBatch(0x100, { 10 }));
+    merge.channelReceived(Merge::kMaxChannels, makeBatch(0x100, { 20 }));
+    merge.channelSent(0, true, makeBatch(0x100, { 30 }));
+    merge.stopSimulation();
+
+    REQUIRE(out.merged.size() == 1);
+    CHECK(out.merged[0].timestamp == 30);
+    CHECK(out.merged[0].channel == 1);
+
+    QJsonObject config{ { "reorderWindow", -1 } };
+    merge.setConfig(config);
+    CHECK(merge.getConfig()["reorderWindow"].toDouble() == Merge::kDefaultReorderWindow);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    qRegisterMetaType<CanFrameBatch>(); // required by QSignalSpy
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,132 @@
+#include <QSignalSpy>
+#include <catch.hpp>
+#include <linux/can/raw.h>
+#include <nativesocketcanbusdevice.h>
+#include <net/if.h>
+
+namespace {
+CanFrameRecord roundTrip(const CanFrameRecord& rec)
+{
+    canfd_frame frame;
+    const std::size_t size = NativeSocketCanBusDevice::toKernelFrame(rec, frame);
+
+    return NativeSocketCanBusDevice::fromKernelFrame(frame, size, rec.timestamp);
+}
+
+CanFrameRecord record(quint32 id, quint8 flags, quint8 length)
+{
+    CanFrameRecord rec{};
+
+    rec.timestamp = 1234567;
+    rec.id = id;
+    rec.flags = flags;
+    rec.length = length;
+    for (quint8 i = 0; i < length; ++i) {
+        rec.payload[i] = i;
+    }
+
+    return rec;
+}
+} // namespace
+
+TEST_CASE("Classic frames map to CAN_MTU", "[nativesocketcan]")
+{
+    canfd_frame frame;
+    const auto rec = record(0x18DA00F1, CanFrameRecord::ExtendedId, 8);
+
+    REQUIRE(NativeSocketCanBusDevice::toKernelFrame(rec, frame) == CAN_MTU);
+    CHECK(frame.can_id == (0x18DA00F1 | CAN_EFF_FLAG));
+    CHECK(frame.len == 8);
+
+    const auto back = roundTrip(rec);
+    CHECK(back.id == rec.id);
+    CHECK(back.flags == rec.flags);
+    CHECK(back.length == 8);
+    CHECK(back.timestamp == rec.timestamp);
+    CHECK(std::memcmp(back.payload, rec.payload, 8) == 0);
+}
+
+TEST_CASE("CAN FD flags survive kernel frame conversion", "[nativesocketcan]")
+{
+    canfd_frame frame;
+    const quint8 flags
+        = CanFrameRecord::FlexibleDataRate | CanFrameRecord::BitrateSwitch | CanFrameRecord::ErrorStateIndicator;
+    const auto rec = record(0x123, flags, 64);
+
+    REQUIRE(NativeSocketCanBusDevice::toKernelFrame(rec, frame) == CANFD_MTU);
+    CHECK(frame.flags == (CANFD_BRS | CANFD_ESI));
+
+    const auto back = roundTrip(rec);
+    CHECK(back.flags == rec.flags);
+    CHECK(back.length == 64);
+    CHECK(back.payload[63] == 63);
+}
+
+TEST_CASE("Remote and error frames are recognized", "[nativesocketcan]")
+{
+    const auto remote = roundTrip(record(0x7ff, CanFrameRecord::Remote, 4));
+    CHECK(remote.hasFlag(CanFrameRecord::Remote));
+    CHECK(remote.id == 0x7ff);
+    CHECK(remote.length == 4);
+
+    canfd_frame frame{};
+    frame.can_id = CAN_ERR_FLAG | CAN_ERR_BUSOFF;
+    frame.len = CAN_ERR_DLC;
+
+    const auto error = NativeSocketCanBusDevice::fromKernelFrame(frame, CAN_MTU, 0);
+    CHECK(error.hasFlag(CanFrameRecord::Error));
+    CHECK(error.id == CAN_ERR_BUSOFF);
+}
+
+TEST_CASE("Acceptance filters translate to CAN_RAW_FILTER", "[nativesocketcan]")
+{
+    CanFilterList filters{ makeCanFilter(0x100, 0x700), makeCanFilter(0x18DA0000, 0x1fff0000) };
+    filters[0].format = QCanBusDevice::Filter::MatchBaseFormat;
+    filters[1].format = QCanBusDevice::Filter::MatchExtendedFormat;
+    filters[1].type = QCanBusFrame::DataFrame;
+
+    const auto kernel = NativeSocketCanBusDevice::toKernelFilters(filters);
+    REQUIRE(kernel.size() == 2);
+    CHECK(kernel[0].can_id == 0x100);
+    CHECK(kernel[0].can_mask == (0x700 | CAN_EFF_FLAG));
+    CHECK(kernel[1].can_id == (0x18DA0000 | CAN_EFF_FLAG));
+    CHECK(kernel[1].can_mask == (0x1fff0000 | CAN_EFF_FLAG | CAN_RTR_FLAG));
+}
+
+TEST_CASE("Frames are looped back on vcan0", "[nativesocketcan]")
+{
+    if (::if_nametoindex("vcan0") == 0) {
+        WARN("vcan0 not available, loopback not tested");
+        return;
+    }
+
+    NativeSocketCanBusDevice tx("vcan0");
+    NativeSocketCanBusDevice rx("vcan0");
+    QSignalSpy received(&rx, &QCanBusDevice::framesReceived);
+    QSignalSpy written(&tx, &QCanBusDevice::framesWritten);
+
+    REQUIRE(rx.connectDevice());
+    REQUIRE(tx.connectDevice());
+
+    QVector<QCanBusFrame> frames;
+    for (int i = 0; i < 100; ++i) {
+        frames.append(QCanBusFrame(0x200 + i, QByteArray(8, static_cast<char>(i))));
+    }
+
+    CHECK(tx.writeFrames(frames) == frames.size());
+    CHECK(written.count() == 1);
+
+    qint64 count = 0;
+    for (int attempt = 0; (attempt < 10) && (count < frames.size()); ++attempt) {
+        received.wait(100);
+        while (rx.framesAvailable() > 0) {
+            const QCanBusFrame frame = rx.readFrame();
+
+            CHECK(frame.frameId() == static_cast<quint32>(0x200 + count));
+            CHECK(frame.timeStamp().seconds() > 0);
+            ++count;
+        }
+    }
+
+    CHECK(count == frames.size());
+}
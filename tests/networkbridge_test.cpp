@@ -0,0 +1,268 @@
+#define CATCH_CONFIG_RUNNER
+#include <QSignalSpy>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonObject>
+#include <bridgeprotocol.h>
+#include <catch.hpp>
+#include <cstring>
+#include <log.h>
+#include <networkbridge.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, quint8 flags, int length, quint64 timestamp)
+{
+    CanFrameRecord rec{};
+
+    rec.timestamp = timestamp;
+    rec.id = id;
+    rec.flags = flags;
+    rec.length = static_cast<quint8>(length);
+    for (int i = 0; i < length; ++i) {
+        rec.payload[i] = static_cast<quint8>(id + i);
+    }
+
+    return rec;
+}
+
+bool sameRecord(const CanFrameRecord& a, const CanFrameRecord& b)
+{
+    return (a.timestamp == b.timestamp) && (a.id == b.id) && (a.flags == b.flags) && (a.length == b.length)
+        && (std::memcmp(a.payload, b.payload, a.length) == 0);
+}
+
+// Encodes as many records as fit in one batch
+QByteArray encode(BridgeProtocol::Encoder& encoder, const CanFrameBatch& records, int& encoded, quint32 sequence = 0)
+{
+    encoded = 0;
+    for (const auto& rec : records) {
+        if (!encoder.append(rec)) {
+            break;
+        }
+        ++encoded;
+    }
+
+    return encoder.finish(sequence, 7, 1000);
+}
+} // namespace
+
+TEST_CASE("Batch round trip keeps timestamps, flags and payload", "[networkbridge]")
+{
+    CanFrameBatch records;
+    records.append(makeRecord(0x123, 0, 8, 1000000));
+    records.append(makeRecord(0x1abcdef, CanFrameRecord::ExtendedId | CanFrameRecord::Tx, 3, 1000250));
+    records.append(makeRecord(0x10, CanFrameRecord::FlexibleDataRate | CanFrameRecord::BitrateSwitch, 64, 1000500));
+    records.append(makeRecord(0x7df, CanFrameRecord::Remote, 0, 999000));
+
+    BridgeProtocol::Encoder encoder(NetworkBridge::kDefaultMaxDatagramSize, false);
+    int encoded = 0;
+    const QByteArray batch = encode(encoder, records, encoded, 42);
+
+    REQUIRE(encoded == records.size());
+    CHECK(batch.size() == BridgeProtocol::kHeaderSize + 4 * BridgeProtocol::kFrameHeaderSize + 8 + 3 + 64);
+
+    BridgeProtocol::Header header;
+    REQUIRE(BridgeProtocol::readHeader(batch.constData(), header));
+    CHECK(header.count == 4);
+    CHECK(header.sequence == 42);
+    CHECK(header.source == 7);
+    CHECK(header.sendTimestamp == 1000);
+
+    CanFrameBatch decoded;
+    QByteArray scratch;
+    REQUIRE(BridgeProtocol::decode(batch.constData(), header, decoded, scratch));
+    REQUIRE(decoded.size() == records.size());
+    for (int i = 0; i < records.size(); ++i) {
+        CHECK(sameRecord(decoded[i], records[i]));
+    }
+}
+
+TEST_CASE("Batch is limited by maximum size", "[networkbridge]")
+{
+    CanFrameBatch records;
+    for (int i = 0; i < 100; ++i) {
+        records.append(makeRecord(static_cast<quint32>(i), CanFrameRecord::FlexibleDataRate, 64, 1000 + i));
+    }
+
+    BridgeProtocol::Encoder encoder(NetworkBridge::kDefaultMaxDatagramSize, false);
+    int encoded = 0;
+    const QByteArray first = encode(encoder, records, encoded);
+    const int firstCount = encoded;
+
+    CHECK(encoded == (NetworkBridge::kDefaultMaxDatagramSize - BridgeProtocol::kHeaderSize) / 74);
+    CHECK(first.size() <= NetworkBridge::kDefaultMaxDatagramSize);
+
+    // Encoder starts a new batch after finish()
+    const QByteArray second = encode(encoder, records.mid(encoded), encoded, 1);
+    BridgeProtocol::Header header;
+    CanFrameBatch decoded;
+    QByteArray scratch;
+
+    REQUIRE(BridgeProtocol::readHeader(second.constData(), header));
+    REQUIRE(BridgeProtocol::decode(second.constData(), header, decoded, scratch));
+    CHECK(decoded.size() == encoded);
+    CHECK(sameRecord(decoded.front(), records[firstCount]));
+}
+
+TEST_CASE("Malformed batches are rejected", "[networkbridge]")
+{
+    CanFrameBatch records;
+    records.append(makeRecord(0x100, 0, 8, 5000));
+    records.append(makeRecord(0x101, 0, 8, 5001));
+
+    BridgeProtocol::Encoder encoder(NetworkBridge::kDefaultMaxDatagramSize, false);
+    int encoded = 0;
+    QByteArray batch = encode(encoder, records, encoded);
+    BridgeProtocol::Header header;
+    CanFrameBatch decoded;
+    QByteArray scratch;
+
+    QByteArray badMagic = batch;
+    badMagic[0] = 'X';
+    CHECK_FALSE(BridgeProtocol::readHeader(badMagic.constData(), header));
+
+    REQUIRE(BridgeProtocol::readHeader(batch.constData(), header));
+
+    // Frame claims more payload than batch carries
+    QByteArray badLength = batch;
+    badLength[BridgeProtocol::kHeaderSize + 9] = 64;
+    CHECK_FALSE(BridgeProtocol::decode(badLength.constData(), header, decoded, scratch));
+    CHECK(decoded.isEmpty());
+
+    // Fewer frames than bytes
+    BridgeProtocol::Header shortHeader = header;
+    shortHeader.count = 1;
+    CHECK_FALSE(BridgeProtocol::decode(batch.constData(), shortHeader, decoded, scratch));
+    CHECK(decoded.isEmpty());
+}
+
+TEST_CASE("Lost and reordered batches are counted", "[networkbridge]")
+{
+    BridgeProtocol::SequenceTracker tracker;
+
+    CHECK(tracker.update(1, 10));
+    CHECK(tracker.update(1, 11));
+    CHECK(tracker.update(1, 14));
+    CHECK(tracker.lost() == 2);
+
+    // Batch 12 arrives late
+    CHECK_FALSE(tracker.update(1, 12));
+    CHECK(tracker.lost() == 1);
+    CHECK(tracker.reordered() == 1);
+
+    // Restarted sender starts new sequence
+    CHECK(tracker.update(2, 0));
+    CHECK(tracker.update(2, 1));
+    CHECK(tracker.lost() == 1);
+
+    // Wrap around of sequence number is not a loss
+    BridgeProtocol::SequenceTracker wrap;
+    CHECK(wrap.update(3, 0xffffffff));
+    CHECK(wrap.update(3, 0));
+    CHECK(wrap.lost() == 0);
+}
+
+TEST_CASE("Compressed batch round trip", "[networkbridge]")
+{
+    if (!BridgeProtocol::compressionSupported()) {
+        WARN("LZ4 compression not compiled in");
+        return;
+    }
+
+    // Periodic traffic with repeating payloads compresses well
+    CanFrameBatch records;
+    for (int i = 0; i < 100; ++i) {
+        CanFrameRecord rec = makeRecord(0x200 + i % 4, 0, 8, 10000 + i * 100);
+        std::memset(rec.payload, 0x55, 8);
+        records.append(rec);
+    }
+
+    BridgeProtocol::Encoder encoder(NetworkBridge::kMaxMessageSize, true);
+    int encoded = 0;
+    const QByteArray batch = encode(encoder, records, encoded);
+    BridgeProtocol::Header header;
+    CanFrameBatch decoded;
+    QByteArray scratch;
+
+    REQUIRE(BridgeProtocol::readHeader(batch.constData(), header));
+    CHECK((header.flags & BridgeProtocol::Compressed) != 0);
+    CHECK(header.payloadSize < header.uncompressedSize);
+    REQUIRE(BridgeProtocol::decode(batch.constData(), header, decoded, scratch));
+    REQUIRE(decoded.size() == records.size());
+    CHECK(sameRecord(decoded.back(), records.back()));
+}
+
+TEST_CASE("Invalid config values are ignored", "[networkbridge]")
+{
+    NetworkBridge bridge;
+    QJsonObject config;
+
+    config["transport"] = "sctp";
+    config["localPort"] = 70000;
+    config["maxDatagramSize"] = 10;
+    config["statsInterval"] = -1;
+    bridge.setConfig(config);
+
+    const QJsonObject result = bridge.getConfig();
+    CHECK(result["transport"].toString() == "udp");
+    CHECK(result["localPort"].toInt() == 0);
+    CHECK(result["maxDatagramSize"].toInt() == NetworkBridge::kDefaultMaxDatagramSize);
+    CHECK(result["statsInterval"].toDouble() == NetworkBridge::kDefaultStatsInterval);
+}
+
+TEST_CASE("Frames are forwarded over UDP loopback", "[networkbridge]")
+{
+    NetworkBridge receiver;
+    NetworkBridge sender;
+    QJsonObject config;
+
+    config["statsInterval"] = 0;
+    receiver.setConfig(config);
+    receiver.startSimulation();
+    REQUIRE(receiver.localPort() != 0);
+
+    config["remoteHost"] = "127.0.0.1";
+    config["remotePort"] = receiver.localPort();
+    sender.setConfig(config);
+    sender.startSimulation();
+
+    QSignalSpy spy(&receiver, &NetworkBridge::framesReceived);
+    CanFrameBatch records;
+    for (int i = 0; i < 50; ++i) {
+        records.append(makeRecord(static_cast<quint32>(i), CanFrameRecord::FlexibleDataRate, 64, 2000 + i));
+    }
+
+    sender.frameBatchReceived(records);
+
+    CanFrameBatch received;
+    while ((received.size() < records.size()) && spy.wait(2000)) {
+        while (!spy.isEmpty()) {
+            received += spy.takeFirst().at(0).value<CanFrameBatch>();
+        }
+    }
+
+    REQUIRE(received.size() == records.size());
+    CHECK(sameRecord(received.front(), records.front()));
+    CHECK(sameRecord(received.back(), records.back()));
+    CHECK(sender.stats().framesSent == static_cast<quint64>(records.size()));
+    CHECK(sender.stats().batchesSent > 1);
+    CHECK(receiver.stats().framesReceived == static_cast<quint64>(records.size()));
+    CHECK(receiver.stats().batchesLost == 0);
+
+    sender.stopSimulation();
+    receiver.stopSimulation();
+    CHECK(receiver.localPort() == 0);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    qRegisterMetaType<CanFrameBatch>(); // required by QSignalSpy
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,70 @@
+#define CATCH_CONFIG_MAIN
+#include <canframerecord.h>
+#include <catch.hpp>
+#include <poolallocator.h>
+#include <thread>
+
+using namespace Instrumentation;
+
+namespace {
+struct Payload {
+    CanFrameBatch frames;
+    int value;
+
+    Payload(int v)
+        : value(v)
+    {
+    }
+};
+} // namespace
+
+TEST_CASE("Released blocks are reused by the same thread", "[pool]")
+{
+    // Warm up free list of this size class
+    Pool::makeShared<Payload>(0);
+
+    const Snapshot before = snapshot();
+    for (int i = 0; i < 1000; ++i) {
+        auto p = Pool::makeShared<Payload>(i);
+        REQUIRE(p->value == i);
+    }
+    const Snapshot delta = snapshot() - before;
+
+    CHECK(delta.counter(Counter::PoolAllocations) == 1000);
+    CHECK(delta.counter(Counter::HeapAllocations) == 0);
+}
+
+TEST_CASE("Blocks freed by another thread go to its pool", "[pool]")
+{
+    std::shared_ptr<Payload> p = Pool::makeShared<Payload>(1);
+
+    std::thread([&p] { p.reset(); }).join();
+    CHECK(!p);
+
+    // Too big for pools
+    const Snapshot before = snapshot();
+    void* block = Pool::allocate(Pool::kMaxBlockSize + 1);
+    Pool::deallocate(block, Pool::kMaxBlockSize + 1);
+    CHECK((snapshot() - before).counter(Counter::HeapAllocations) == 1);
+}
+
+TEST_CASE("Frames are converted into reused batch", "[pool]")
+{
+    const QVector<QCanBusFrame> frames(16, QCanBusFrame(0x10, QByteArray(8, 1)));
+    CanFrameBatch batch;
+
+    toCanFrameBatch(frames, Direction::RX, batch);
+    const CanFrameRecord* storage = batch.constData();
+
+    toCanFrameBatch(frames.mid(0, 8), Direction::TX, batch);
+    CHECK(batch.size() == 8);
+    CHECK(batch.constData() == storage);
+    CHECK(batch[0].direction() == Direction::TX);
+
+    // Batch kept by consumer must not be overwritten
+    const CanFrameBatch kept = batch;
+    toCanFrameBatch(frames, Direction::RX, batch);
+    CHECK(kept.size() == 8);
+    CHECK(kept[0].direction() == Direction::TX);
+    CHECK(batch.constData() != kept.constData());
+}
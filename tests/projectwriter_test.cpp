@@ -0,0 +1,158 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QSignalSpy>
+#include <catch.hpp>
+#include <log.h>
+#include <projectconfig/projectwriter.h>
+#include <projectfile.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+ProjectWriter::SideFileWriter contentWriter(const QByteArray& content)
+{
+    return [content](const QString& path) {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && (file.write(content) == content.size());
+    };
+}
+
+QJsonObject readProject(const QString& path)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    REQUIRE(doc.isObject());
+    return doc.object();
+}
+} // namespace
+
+TEST_CASE("Project file has scene layout", "[projectwriter]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/layout.cds";
+    ProjectWriter::Project project;
+
+    for (int i = 0; i < 3; ++i) {
+        project.nodes.push_back(QJsonObject{ { "id", QString::number(i) }, { "model", QJsonObject{} } });
+    }
+    project.connections.push_back(QJsonObject{ { "in_id", "0" }, { "out_id", "1" } });
+
+    REQUIRE(ProjectWriter::write(path, project));
+
+    const QJsonObject root = readProject(path);
+    REQUIRE(root["nodes"].toArray().size() == 3);
+    CHECK(root["nodes"].toArray()[2].toObject()["id"].toString() == "2");
+    REQUIRE(root["connections"].toArray().size() == 1);
+    CHECK(root["connections"].toArray()[0].toObject()["out_id"].toString() == "1");
+    // No side files, no side directory
+    CHECK(!QDir(dir.path() + "/" + ProjectWriter::sideDataDir(path)).exists());
+}
+
+TEST_CASE("Side files are written next to project and stale ones removed", "[projectwriter]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/side.cds";
+    const QString sideDir = ProjectWriter::sideDataDir(path);
+    CHECK(sideDir == "side_data");
+
+    ProjectWriter::Project first;
+    first.sideFiles.emplace_back(sideDir + "/a.cdst", contentWriter("aaa"));
+    first.sideFiles.emplace_back(sideDir + "/b.cdst", contentWriter("bbb"));
+    REQUIRE(ProjectWriter::write(path, first));
+    CHECK(QFile(dir.path() + "/side_data/a.cdst").size() == 3);
+    CHECK(QFile::exists(dir.path() + "/side_data/b.cdst"));
+
+    ProjectWriter::Project second;
+    second.sideFiles.emplace_back(sideDir + "/a.cdst", contentWriter("aaaaa"));
+    REQUIRE(ProjectWriter::write(path, second));
+    CHECK(QFile(dir.path() + "/side_data/a.cdst").size() == 5);
+    CHECK(!QFile::exists(dir.path() + "/side_data/b.cdst"));
+    CHECK(!QFile::exists(dir.path() + "/side_data/a.cdst.tmp"));
+
+    // Failing side file is reported, project file is still written
+    ProjectWriter::Project failing;
+    failing.sideFiles.emplace_back(sideDir + "/c.cdst", [](const QString&) { return false; });
+    CHECK(!ProjectWriter::write(path, failing));
+    CHECK(QFile::exists(path));
+}
+
+TEST_CASE("Binary project keeps nodes, connections and configuration", "[projectwriter]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/binary.cds";
+    ProjectWriter::Project project;
+
+    project.format = ProjectWriter::Format::Binary;
+    for (int i = 0; i < 3; ++i) {
+        const QJsonObject model{ { "name", "CanRawSenderModel" }, { "lines", QJsonArray{ i, i + 1 } } };
+        const QJsonObject position{ { "x", i * 10 }, { "y", 0 } };
+
+        project.nodes.push_back(
+            QJsonObject{ { "id", QString::number(i) }, { "model", model }, { "position", position } });
+    }
+    project.connections.push_back(QJsonObject{ { "in_id", "0" }, { "out_id", "1" } });
+    REQUIRE(ProjectWriter::write(path, project));
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    ProjectFile::Document doc;
+    QString error;
+
+    REQUIRE(ProjectFile::isBinary(data));
+    REQUIRE(ProjectFile::read(data, doc, error));
+    REQUIRE(doc.nodes.size() == 3);
+    // Graph is known without parsing configuration
+    CHECK(doc.nodes[2].id == "2");
+    CHECK(doc.nodes[2].model == "CanRawSenderModel");
+    CHECK(doc.nodes[2].scene["position"].toObject()["x"].toInt() == 20);
+    CHECK(doc.model(doc.nodes[1]) == project.nodes[1]["model"].toObject());
+
+    // Export gives scene layout
+    const QJsonObject json = doc.toJson();
+    REQUIRE(json["nodes"].toArray().size() == 3);
+    CHECK(json["nodes"].toArray()[0].toObject() == project.nodes[0]);
+    REQUIRE(json["connections"].toArray().size() == 1);
+    CHECK(json["connections"].toArray()[0].toObject()["out_id"].toString() == "1");
+
+    // Truncated file is rejected
+    CHECK(!ProjectFile::read(data.left(data.size() - 4), doc, error));
+    CHECK(doc.nodes.empty());
+    CHECK(!ProjectFile::isBinary("{\n"));
+}
+
+TEST_CASE("Project is saved in background", "[projectwriter]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/async.cds";
+    ProjectWriter writer;
+    QSignalSpy savedSpy(&writer, &ProjectWriter::saved);
+    ProjectWriter::Project project;
+
+    project.nodes.push_back(QJsonObject{ { "id", "x" } });
+    writer.save(path, std::move(project));
+    // Spy is connected directly, so the signal is recorded as soon as worker emits it
+    REQUIRE(writer.wait(5000));
+    REQUIRE(savedSpy.count() == 1);
+
+    CHECK(savedSpy.at(0).at(0).toString() == path);
+    CHECK(savedSpy.at(0).at(1).toBool());
+    CHECK(readProject(path)["nodes"].toArray().size() == 1);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,105 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include <ringbuffer.h>
+#include <thread>
+
+TEST_CASE("SpscRingBuffer rounds capacity up to power of two", "[ringbuffer]")
+{
+    SpscRingBuffer<int> rb(100);
+    CHECK(rb.capacity() == 128);
+    CHECK(rb.size() == 0);
+}
+
+TEST_CASE("SpscRingBuffer rejects push when full", "[ringbuffer]")
+{
+    SpscRingBuffer<int> rb(4);
+    int value = 0;
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(rb.push(i));
+    }
+    CHECK(rb.push(4) == false);
+    CHECK(rb.size() == 4);
+
+    REQUIRE(rb.pop(value));
+    CHECK(value == 0);
+    CHECK(rb.push(4));
+}
+
+TEST_CASE("SpscRingBuffer consumeAll preserves order", "[ringbuffer]")
+{
+    SpscRingBuffer<int> rb(8);
+    std::vector<int> out;
+
+    for (int i = 0; i < 6; ++i) {
+        rb.push(i);
+    }
+
+    CHECK(rb.consumeAll([&out](int&& v) { out.push_back(v); }) == 6);
+    CHECK(out == std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+    CHECK(rb.size() == 0);
+}
+
+TEST_CASE("SpscRingBuffer transfers all elements between threads", "[ringbuffer]")
+{
+    constexpr int count = 100000;
+    SpscRingBuffer<int> rb(256);
+    long long sum = 0;
+    int received = 0;
+    int expected = 0;
+    bool ordered = true;
+
+    std::thread producer([&rb] {
+        for (int i = 0; i < count;) {
+            if (rb.push(i)) {
+                ++i;
+            }
+        }
+    });
+
+    while (received < count) {
+        rb.consumeAll([&](int&& v) {
+            ordered = ordered && (v == expected++);
+            sum += v;
+            ++received;
+        });
+    }
+
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(sum == static_cast<long long>(count) * (count - 1) / 2);
+}
+
+TEST_CASE("RingBuffer push fails when full, pushOverwrite drops oldest", "[ringbuffer]")
+{
+    RingBuffer<int> rb(4);
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(rb.push(i));
+    }
+    CHECK(rb.full());
+    CHECK(rb.push(4) == false);
+
+    CHECK(rb.pushOverwrite(4) == false);
+    CHECK(rb.size() == 4);
+    CHECK(rb.front() == 1);
+    CHECK(rb.back() == 4);
+}
+
+TEST_CASE("RingBuffer drop removes oldest elements", "[ringbuffer]")
+{
+    RingBuffer<int> rb(8);
+    int value = 0;
+
+    for (int i = 0; i < 5; ++i) {
+        rb.push(i);
+    }
+
+    CHECK(rb.drop(3) == 3);
+    CHECK(rb.size() == 2);
+    CHECK(rb[0] == 3);
+    CHECK(rb.drop(10) == 2);
+    CHECK(rb.empty());
+    CHECK(rb.pop(value) == false);
+}
@@ -0,0 +1,251 @@
+#define CATCH_CONFIG_RUNNER
+#include <QSignalSpy>
+#include <QtWidgets/QApplication>
+#include <canrawsender.h>
+#include <context.h>
+#include <fakeit.hpp>
+#include <gui/crsguiinterface.h>
+#include <log.h>
+#include <scheduleimport.h>
+#include <sendertablemodel.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+int id = qRegisterMetaType<QCanBusFrame>("QCanBusFrame");
+
+namespace {
+QModelIndex cell(const SenderTableModel& model, int row, SenderTableModel::Column column)
+{
+    return model.index(row, column);
+}
+} // namespace
+
+TEST_CASE("Create CanRawSender correctly", "[sendertablemodel]")
+{
+    using namespace fakeit;
+
+    Mock<CRSGuiInterface> crsMock;
+    Fake(Dtor(crsMock));
+    Fake(Method(crsMock, setAddCbk));
+    Fake(Method(crsMock, setRemoveCbk));
+    Fake(Method(crsMock, setDockUndockCbk));
+    Fake(Method(crsMock, setImportCbk));
+    Fake(Method(crsMock, setStartCyclicCbk));
+    Fake(Method(crsMock, setFloodCbk));
+    Fake(Method(crsMock, setFloodEnabled));
+    Fake(Method(crsMock, setFloodStatus));
+    Fake(Method(crsMock, getMainWidget));
+    Fake(Method(crsMock, initTableView));
+    Fake(Method(crsMock, getSelectedRows));
+
+    REQUIRE_NOTHROW(new CanRawSender(CanRawSenderCtx(&crsMock.get())));
+}
+
+TEST_CASE("Line without id or with simulation stopped is not sent", "[sendertablemodel]")
+{
+    TxScheduler scheduler;
+    SenderTableModel model(scheduler);
+    QSignalSpy sent(&model, &SenderTableModel::sendFrame);
+
+    REQUIRE(model.insertRows(0, 1));
+    model.setSimulationState(true);
+    CHECK(!model.data(cell(model, 0, SenderTableModel::SendColumn), SenderTableModel::SendRole).toBool());
+    CHECK(!model.setData(cell(model, 0, SenderTableModel::SendColumn), true, SenderTableModel::SendRole));
+
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::IdColumn), "22"));
+    model.setSimulationState(false);
+    CHECK(!model.send(0));
+    CHECK(sent.count() == 0);
+}
+
+TEST_CASE("Send cell sends one frame", "[sendertablemodel]")
+{
+    TxScheduler scheduler;
+    SenderTableModel model(scheduler);
+    QSignalSpy sent(&model, &SenderTableModel::sendFrame);
+
+    REQUIRE(model.insertRows(0, 1));
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::IdColumn), "22"));
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::DataColumn), "0102"));
+    model.setSimulationState(true);
+
+    CHECK(model.data(cell(model, 0, SenderTableModel::SendColumn), SenderTableModel::SendRole).toBool());
+    CHECK(model.setData(cell(model, 0, SenderTableModel::SendColumn), true, SenderTableModel::SendRole));
+    REQUIRE(sent.count() == 1);
+
+    const auto frame = sent.front().front().value<QCanBusFrame>();
+    CHECK(frame.frameId() == 0x22);
+    CHECK(frame.payload() == QByteArray::fromHex("0102"));
+    CHECK(!model.isCyclic(0));
+}
+
+TEST_CASE("Cyclic line is sent until loop is cleared", "[sendertablemodel]")
+{
+    TxScheduler scheduler;
+    SenderTableModel model(scheduler);
+    QSignalSpy sent(&model, &SenderTableModel::sendFrame);
+    QSignalSpy due(&scheduler, &TxScheduler::framesDue);
+
+    REQUIRE(model.insertRows(0, 1));
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::IdColumn), "21"));
+    // Interval can be entered only once loop is set
+    CHECK(!model.setData(cell(model, 0, SenderTableModel::IntervalColumn), "1"));
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::LoopColumn), Qt::Checked, Qt::CheckStateRole));
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::IntervalColumn), "1"));
+    model.setSimulationState(true);
+
+    REQUIRE(model.send(0));
+    CHECK(sent.count() == 1);
+    CHECK(model.isCyclic(0));
+    CHECK(scheduler.size() == 1);
+    CHECK(!(model.flags(cell(model, 0, SenderTableModel::IdColumn)) & Qt::ItemIsEditable));
+    CHECK(!model.setData(cell(model, 0, SenderTableModel::DataColumn), "ff"));
+
+    due.wait(100);
+    CHECK(due.count() > 0);
+
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::LoopColumn), Qt::Unchecked, Qt::CheckStateRole));
+    CHECK(!model.isCyclic(0));
+    CHECK(scheduler.size() == 0);
+    CHECK(model.flags(cell(model, 0, SenderTableModel::IdColumn)) & Qt::ItemIsEditable);
+
+    // Stopping simulation stops cyclic transmission as well
+    REQUIRE(model.setData(cell(model, 0, SenderTableModel::LoopColumn), Qt::Checked, Qt::CheckStateRole));
+    REQUIRE(model.send(0));
+    CHECK(scheduler.size() == 1);
+    model.setSimulationState(false);
+    CHECK(scheduler.size() == 0);
+}
+
+TEST_CASE("Edited text has to match column pattern", "[sendertablemodel]")
+{
+    TxScheduler scheduler;
+    SenderTableModel model(scheduler);
+
+    REQUIRE(model.insertRows(0, 1));
+
+    for (int column = 0; column < SenderTableModel::ColumnCount; ++column) {
+        CHECK(model.flags(model.index(0, column)) & Qt::ItemIsSelectable);
+    }
+    CHECK(model.flags(cell(model, 0, SenderTableModel::LoopColumn)) & Qt::ItemIsUserCheckable);
+    CHECK(!(model.flags(cell(model, 0, SenderTableModel::SendColumn)) & Qt::ItemIsEditable));
+    CHECK(SenderTableModel::pattern(SenderTableModel::SendColumn).isEmpty());
+
+    CHECK(model.setData(cell(model, 0, SenderTableModel::IdColumn), "1fffffff"));
+    CHECK(!model.setData(cell(model, 0, SenderTableModel::IdColumn), "2fffffff"));
+    CHECK(!model.setData(cell(model, 0, SenderTableModel::IdColumn), "zz"));
+    CHECK(model.line(0).id == "1fffffff");
+    CHECK(model.setData(cell(model, 0, SenderTableModel::DataColumn), QString(128, 'a')));
+    CHECK(!model.setData(cell(model, 0, SenderTableModel::DataColumn), QString(130, 'a')));
+
+    QJsonObject json;
+    model.lineToJson(0, json);
+    CHECK(json["id"].toString() == "1fffffff");
+    CHECK(json["loop"].toInt() == 0);
+}
+
+TEST_CASE("Lines are appended and removed in batches", "[sendertablemodel]")
+{
+    TxScheduler scheduler;
+    SenderTableModel model(scheduler);
+    QSignalSpy inserted(&model, &SenderTableModel::rowsInserted);
+    QSignalSpy removed(&model, &SenderTableModel::rowsRemoved);
+    std::vector<SenderTableModel::Line> lines;
+
+    for (int i = 0; i < 6; ++i) {
+        lines.push_back({ QString::number(i), "00", false, "" });
+    }
+    lines.push_back({ "xyz", "00", true, "10" });
+
+    model.appendLines(lines);
+    CHECK(inserted.count() == 1);
+    REQUIRE(model.rowCount() == 7);
+    // Invalid fields are not taken over
+    CHECK(model.line(6).id.isEmpty());
+    CHECK(model.line(6).interval == "10");
+
+    model.removeLines({ 4, 1, 0, 2, 2, 9 });
+    CHECK(removed.count() == 2);
+    REQUIRE(model.rowCount() == 3);
+    CHECK(model.line(0).id == "3");
+    CHECK(model.line(1).id == "5");
+}
+
+TEST_CASE("Imported schedule replaces lines and starts at once", "[sendertablemodel]")
+{
+    TxScheduler scheduler;
+    SenderTableModel model(scheduler);
+    QSignalSpy sent(&model, &SenderTableModel::sendFrame);
+    QSignalSpy reset(&model, &SenderTableModel::modelReset);
+    std::vector<SenderTableModel::Line> lines;
+    QString error;
+
+    REQUIRE(ScheduleImport::fromCsv("id;data;interval\n"
+                                    "# restbus\n"
+                                    "0x100;01 02 03;10\n"
+                                    "\n"
+                                    "101,,\n"
+                                    "18daf110,0000000000000000,100\n",
+        lines, error));
+    REQUIRE(lines.size() == 3);
+    CHECK(lines[0].id == "100");
+    CHECK(lines[0].data == "010203");
+    CHECK(lines[0].loop);
+    CHECK(!lines[1].loop);
+    CHECK(lines[2].interval == "100");
+
+    std::vector<SenderTableModel::Line> rejected;
+    CHECK(!ScheduleImport::fromCsv("100;xx;10\n", rejected, error));
+    CHECK(error.contains("data"));
+    CHECK(!ScheduleImport::fromCsv("100;01;10\n100;010;10\n", rejected, error));
+    CHECK(error.contains("line 2"));
+
+    REQUIRE(model.insertRows(0, 2));
+    model.setLines(lines);
+    CHECK(reset.count() == 1);
+    REQUIRE(model.rowCount() == 3);
+
+    CHECK(model.startCyclic() == 0);
+    model.setSimulationState(true);
+    CHECK(model.startCyclic() == 2);
+    CHECK(scheduler.size() == 2);
+    CHECK(model.isCyclic(0));
+    CHECK(!model.isCyclic(1));
+    // Started lines are not registered twice, first frames follow one interval later
+    CHECK(model.startCyclic() == 0);
+    CHECK(sent.count() == 0);
+
+    model.setLines({});
+    CHECK(scheduler.size() == 0);
+}
+
+TEST_CASE("DBC messages become schedule lines", "[sendertablemodel]")
+{
+    std::vector<SenderTableModel::Line> lines;
+    QString error;
+
+    REQUIRE(ScheduleImport::fromDbc("BO_ 256 Engine: 8 ECU\n"
+                                    "BO_ 2147484160 Extended: 12 ECU\n"
+                                    "BA_DEF_DEF_ \"GenMsgCycleTime\" 0;\n"
+                                    "BA_ \"GenMsgCycleTime\" BO_ 256 20;\n",
+        lines, error));
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0].id == "100");
+    CHECK(lines[0].data == QString(16, '0'));
+    CHECK(lines[0].loop);
+    CHECK(lines[0].interval == "20");
+    CHECK(lines[1].id == "200");
+    CHECK(lines[1].data.size() == 24);
+    CHECK(!lines[1].loop);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    cds_debug("Staring canrawsender unit tests");
+    QApplication a(argc, argv); // QApplication must exist when contructing QWidgets TODO check QTest
+    return Catch::Session().run(argc, argv);
+}
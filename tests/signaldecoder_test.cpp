@@ -0,0 +1,358 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <catch.hpp>
+#include <cmath>
+#include <log.h>
+#include <signaldecoder/batchdecoder.h>
+#include <signaldecoder/dbcparser.h>
+#include <signaldecoder/decodeplan.h>
+#include <signaldecoder/signalanalysis.h>
+#include <signaldecoder/signaldecoder.h>
+#include <tracelogger/tracewriter.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+const char kDbc[] = R"(VERSION ""
+
+NS_ :
+    CM_
+
+BU_: ECU Dash
+
+BO_ 256 Engine: 8 ECU
+ SG_ Rpm : 0|16@1+ (0.25,0) [0|16383.75] "rpm" Dash
+ SG_ Temp : 16|8@1- (1,-40) [-40|215] "degC" Dash
+ SG_ Speed : 39|12@0+ (0.1,0) [0|409.5] "km/h" Dash
+
+BO_ 2147484160 Extended: 64 ECU
+ SG_ Mode M : 0|8@1+ (1,0) [0|255] "" Dash
+ SG_ A m1 : 8|16@1+ (1,0) [0|65535] "" Dash
+ SG_ B m2 : 8|16@1- (1,0) [-32768|32767] "" Dash
+ SG_ Tail : 504|8@1+ (1,0) [0|255] "" Dash
+ SG_ Wide : 64|64@1+ (1,0) [0|0] "" Dash
+
+BO_ 3221225472 VECTOR__INDEPENDENT_SIG_MSG: 0 Vector__XXX
+ SG_ Orphan : 0|8@1+ (1,0) [0|0] "" Vector__XXX
+
+CM_ SG_ 256 Rpm "Engine speed";
+BA_DEF_ BO_ "GenMsgCycleTime" INT 0 65535;
+BA_DEF_DEF_ "GenMsgCycleTime" 0;
+BA_ "GenMsgCycleTime" BO_ 256 10;
+)";
+
+CanFrameRecord makeRecord(quint32 id, const QByteArray& payload, bool extended = false)
+{
+    QCanBusFrame frame(id, payload);
+
+    frame.setExtendedFrameFormat(extended);
+    frame.setTimeStamp(QCanBusFrame::TimeStamp(1, 5));
+
+    return toCanFrameRecord(frame);
+}
+
+DecodePlan makePlan()
+{
+    std::vector<DbcMessage> messages;
+    QString error;
+
+    REQUIRE(DbcParser::parse(kDbc, messages, error));
+
+    return DecodePlan(messages);
+}
+
+std::vector<SignalSample> decode(const DecodePlan& plan, const CanFrameRecord& rec)
+{
+    std::vector<SignalSample> samples(plan.maxSignalsPerMessage());
+
+    samples.resize(plan.decode(rec, samples.data()));
+
+    return samples;
+}
+} // namespace
+
+TEST_CASE("DBC messages and signals are parsed", "[signaldecoder]")
+{
+    std::vector<DbcMessage> messages;
+    QString error;
+
+    REQUIRE(DbcParser::parse(kDbc, messages, error));
+    REQUIRE(messages.size() == 2);
+
+    CHECK(messages[0].id == 256);
+    CHECK(!messages[0].extended);
+    REQUIRE(messages[0].signalList.size() == 3);
+    const auto& speed = messages[0].signalList[2];
+    CHECK(speed.name == "Speed");
+    CHECK(speed.startBit == 39);
+    CHECK(speed.length == 12);
+    CHECK(speed.bigEndian);
+    CHECK(!speed.isSigned);
+    CHECK(speed.factor == Approx(0.1));
+    CHECK(speed.unit == "km/h");
+    CHECK(messages[0].signalList[1].isSigned);
+    CHECK(messages[0].cycleTime == 10);
+
+    CHECK(messages[1].id == 0x200);
+    CHECK(messages[1].extended);
+    CHECK(messages[1].length == 64);
+    CHECK(messages[1].signalList[0].mux == DbcSignal::Mux::Multiplexer);
+    CHECK(messages[1].signalList[2].mux == DbcSignal::Mux::Multiplexed);
+    CHECK(messages[1].signalList[2].muxValue == 2);
+    CHECK(messages[1].cycleTime == 0);
+
+    CHECK(!DbcParser::parse("BO_ 1 M: 8 ECU\n SG_ Broken : 0|x@1+ (1,0) [0|0] \"\" ECU\n", messages, error));
+    CHECK(error.contains("line 2"));
+}
+
+TEST_CASE("Little and big endian signals are decoded", "[signaldecoder]")
+{
+    const DecodePlan plan = makePlan();
+    const auto samples = decode(plan, makeRecord(256, QByteArray::fromHex("1027f60012340000")));
+
+    CHECK(plan.messageCount() == 2);
+    REQUIRE(samples.size() == 3);
+    CHECK(samples[0].value == Approx(2500.0));
+    CHECK(samples[1].value == Approx(-50.0));
+    CHECK(samples[2].value == Approx(29.1));
+    CHECK(samples[2].timestamp == 1000005);
+    CHECK(plan.catalog()->at(samples[2].signal).name == "Speed");
+    CHECK(plan.catalog()->at(samples[2].signal).message == "Engine");
+
+    // Speed does not fit into short frame
+    CHECK(decode(plan, makeRecord(256, QByteArray::fromHex("1027f600"))).size() == 2);
+    // Same ID in other format does not match
+    CHECK(decode(plan, makeRecord(256, QByteArray(8, 0), true)).empty());
+    CHECK(decode(plan, makeRecord(257, QByteArray(8, 0))).empty());
+}
+
+TEST_CASE("Multiplexed and CAN FD signals are decoded", "[signaldecoder]")
+{
+    const DecodePlan plan = makePlan();
+    QByteArray payload(64, 0);
+
+    payload[0] = 1;
+    payload[1] = 0x34;
+    payload[2] = 0x12;
+    for (int i = 0; i < 8; ++i) {
+        payload[8 + i] = static_cast<char>(i + 1);
+    }
+    payload[63] = static_cast<char>(0xab);
+
+    auto samples = decode(plan, makeRecord(0x200, payload, true));
+    REQUIRE(samples.size() == 4);
+    CHECK(plan.catalog()->at(samples[1].signal).name == "A");
+    CHECK(samples[1].value == Approx(4660.0));
+    CHECK(samples[2].value == Approx(171.0));
+    CHECK(samples[3].value == static_cast<double>(0x0807060504030201ULL));
+
+    payload[0] = 2;
+    payload[1] = static_cast<char>(0xfe);
+    payload[2] = static_cast<char>(0xff);
+    samples = decode(plan, makeRecord(0x200, payload.left(8), true));
+    REQUIRE(samples.size() == 2);
+    CHECK(plan.catalog()->at(samples[1].signal).name == "B");
+    CHECK(samples[1].value == Approx(-2.0));
+}
+
+TEST_CASE("Decoder component loads DBC and decodes batches", "[signaldecoder]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/test.dbc";
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(kDbc);
+    file.close();
+
+    SignalDecoder decoder;
+    QJsonObject config{ { "file", path } };
+    decoder.setConfig(config);
+    CHECK(decoder.getConfig()["file"].toString() == path);
+    CHECK(decoder.messageCount() == 2);
+    CHECK(decoder.signalCatalog()->size() == 8);
+    CHECK(decoder.acceptanceFilters().size() == 2);
+
+    SignalSampleBatch received;
+    QObject::connect(
+        &decoder, &SignalDecoder::signalsDecoded, [&received](const SignalSampleBatch& s) { received += s; });
+
+    const CanFrameRecord frame = makeRecord(256, QByteArray::fromHex("1027f60012340000"));
+    decoder.frameBatchReceived({ frame, makeRecord(0x300, QByteArray(8, 0)), frame });
+    CHECK(received.size() == 6);
+    decoder.frameBatchSent(false, { frame });
+    CHECK(received.size() == 6);
+    decoder.frameBatchReceived({ makeRecord(0x300, QByteArray(8, 0)) });
+    CHECK(received.size() == 6);
+
+    config["file"] = dir.path() + "/missing.dbc";
+    decoder.setConfig(config);
+    CHECK(decoder.messageCount() == 0);
+    CHECK(decoder.decode({ frame }).isEmpty());
+}
+
+TEST_CASE("Batch decoding gives the same values with every kernel", "[signaldecoder]")
+{
+    using BatchDecoder::Kernel;
+    const DecodePlan plan = makePlan();
+    std::vector<CanFrameRecord> records;
+
+    // Odd count, so that kernels go through their scalar tails too
+    for (int i = 0; i < 301; ++i) {
+        QByteArray payload(64, 0);
+        for (int b = 0; b < payload.size(); ++b) {
+            payload[b] = static_cast<char>((i * 31 + b * 17) & 0xff);
+        }
+        payload[0] = static_cast<char>(1 + i % 2);
+
+        records.push_back(makeRecord(0x200, (i % 7) ? payload : payload.left(8), true));
+        records.back().timestamp = i;
+    }
+    records[5].id = 0x201;
+
+    SignalColumns reference;
+    REQUIRE(BatchDecoder::decode(plan, records.data(), records.size(), reference, Kernel::Scalar));
+    REQUIRE(reference.values.size() == 5);
+    REQUIRE(reference.timestamps.size() == records.size());
+    CHECK(reference.timestamps[300] == 300);
+
+    // Columns match frame by frame decoding
+    for (std::size_t r = 0; r < records.size(); ++r) {
+        const auto samples = decode(plan, records[r]);
+        std::size_t present = 0;
+
+        for (std::size_t c = 0; c < reference.values.size(); ++c) {
+            const double value = reference.values[c][r];
+
+            if (!std::isnan(value)) {
+                REQUIRE(present < samples.size());
+                CHECK(samples[present].signal == reference.signalIds[c]);
+                CHECK(samples[present].value == value);
+                ++present;
+            }
+        }
+        CHECK(present == samples.size());
+    }
+
+    for (auto kernel : { Kernel::Sse2, Kernel::Avx2, Kernel::Neon }) {
+        if (!BatchDecoder::isSupported(kernel)) {
+            continue;
+        }
+
+        INFO(BatchDecoder::kernelName(kernel));
+        SignalColumns columns;
+        REQUIRE(BatchDecoder::decode(plan, records.data(), records.size(), columns, kernel));
+        REQUIRE(columns.values.size() == reference.values.size());
+
+        for (std::size_t c = 0; c < columns.values.size(); ++c) {
+            for (std::size_t r = 0; r < records.size(); ++r) {
+                const double a = columns.values[c][r];
+                const double b = reference.values[c][r];
+                CHECK(((std::isnan(a) && std::isnan(b)) || (a == b)));
+            }
+        }
+    }
+
+    SignalColumns unknown;
+    CHECK(!BatchDecoder::decode(plan, records.data() + 5, 1, unknown));
+    CHECK(unknown.values.empty());
+}
+
+TEST_CASE("Trace analysis merges partitions decoded in parallel", "[signaldecoder]")
+{
+    QTemporaryDir dir;
+    const QString dbc = dir.path() + "/test.dbc";
+    const QString trace = dir.path() + "/analysis.cdst";
+    QFile file(dbc);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(kDbc);
+    file.close();
+
+    // Rpm ramps 0..99 every 100 frames, one frame per ms, three trace blocks
+    const int total = 10000;
+    CanFrameBatch records;
+    for (int i = 0; i < total; ++i) {
+        QByteArray payload(8, 0);
+        payload[0] = static_cast<char>(((i % 100) * 4) & 0xff);
+        payload[1] = static_cast<char>(((i % 100) * 4) >> 8);
+
+        records.append(makeRecord(256, payload));
+        records.last().timestamp = 1000000 + static_cast<quint64>(i) * 1000;
+    }
+    // Never on the bus, so not counted
+    records.insert(5000, makeRecord(256, QByteArray::fromHex("ffff000000000000")));
+    records[5000].timestamp = records[4999].timestamp;
+    records[5000].flags |= CanFrameRecord::Tx | CanFrameRecord::TxFailed;
+
+    TraceWriter writer;
+    REQUIRE(writer.open(trace));
+    writer.append(records);
+    writer.close();
+
+    SignalAnalysis::Options options;
+    options.thresholds["Engine.Rpm"] = 49.5;
+    options.threads = 2;
+    options.partitionRecords = 1;
+    options.useCache = false;
+
+    std::vector<quint64> progress;
+    SignalAnalysis::Report report;
+    REQUIRE(SignalAnalysis::analyze(
+        trace, dbc, options, report, [&progress](quint64 done, quint64) { progress.push_back(done); }));
+    CHECK(!report.cached);
+    CHECK(report.records == total + 1);
+    CHECK(progress.size() > 1);
+    CHECK(progress.back() == total + 1);
+
+    std::size_t rpm = 0;
+    while (report.catalog->at(rpm).name != "Rpm") {
+        ++rpm;
+    }
+
+    const SignalAggregate& a = report.aggregates[rpm];
+    CHECK(a.count == total);
+    CHECK(a.minimum == 0.0);
+    CHECK(a.maximum == 99.0);
+    CHECK(a.mean() == Approx(49.5));
+    // Each value above threshold holds for 1 ms, except for the last one
+    CHECK(a.aboveUs == (total / 2 - 1) * 1000);
+    REQUIRE(a.histogram.size() == SignalAnalysis::kDefaultHistogramBins);
+    CHECK(a.histogram[0] == total);
+
+    // Single partition gives the same result
+    SignalAnalysis::Report single;
+    options.threads = 1;
+    options.partitionRecords = SignalAnalysis::kPartitionRecords;
+    REQUIRE(SignalAnalysis::analyze(trace, dbc, options, single));
+    CHECK(single.aggregates[rpm].aboveUs == a.aboveUs);
+    CHECK(single.aggregates[rpm].histogram == a.histogram);
+    CHECK(single.aggregates[rpm].sum == a.sum);
+
+    // Second run is read from cache next to trace, as long as options are the same
+    options.useCache = true;
+    REQUIRE(SignalAnalysis::analyze(trace, dbc, options, report));
+    CHECK(!report.cached);
+    CHECK(QFile::exists(SignalAnalysis::cachePath(trace)));
+    REQUIRE(SignalAnalysis::analyze(trace, dbc, options, report));
+    CHECK(report.cached);
+    CHECK(report.aggregates[rpm].aboveUs == a.aboveUs);
+    CHECK(report.aggregates[rpm].histogram == a.histogram);
+    CHECK(report.aggregates[rpm].maximum == 99.0);
+
+    options.thresholds["Engine.Rpm"] = 89.5;
+    REQUIRE(SignalAnalysis::analyze(trace, dbc, options, report));
+    CHECK(!report.cached);
+    CHECK(report.aggregates[rpm].aboveUs == (total / 10 - 1) * 1000);
+
+    CHECK(!SignalAnalysis::analyze(dir.path() + "/missing.cdst", dbc, options, report));
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
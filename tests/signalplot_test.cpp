@@ -0,0 +1,169 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <algorithm>
+#include <catch.hpp>
+#include <context.h>
+#include <fakeit.hpp>
+#include <limits>
+#include <signalplot/gui/spguiinterface.h>
+#include <signalplot/sampleseries.h>
+#include <signalplot/signalplot.h>
+
+namespace {
+SignalCatalogPtr makeCatalog()
+{
+    return std::make_shared<const SignalCatalog>(SignalCatalog{
+        { "Engine", "Rpm", "rpm", 0x100, false, 0, 8000 }, { "Engine", "Temp", "", 0x100, false, -40, 215 } });
+}
+
+SignalSample sample(quint32 signal, quint64 timestamp, double value)
+{
+    return SignalSample{ timestamp, signal, 0, value };
+}
+} // namespace
+
+TEST_CASE("Pyramid grows with series", "[sampleseries]")
+{
+    SampleSeries series;
+
+    for (quint64 i = 0; i < SampleSeries::kFanout; ++i) {
+        series.append(i, static_cast<double>(i));
+    }
+    CHECK(series.levelCount() == 0);
+
+    series.append(SampleSeries::kFanout, -1.0);
+    CHECK(series.levelCount() == 1);
+
+    for (quint64 i = series.size(); i < 2 * SampleSeries::kChunkSamples; ++i) {
+        series.append(i, static_cast<double>(i % 100));
+    }
+    CHECK(series.size() == 2 * SampleSeries::kChunkSamples);
+    CHECK(series.levelCount() == 3);
+    CHECK(series.timestampAt(SampleSeries::kChunkSamples + 5) == SampleSeries::kChunkSamples + 5);
+
+    // Timestamps never go back
+    series.append(0, 1.0);
+    CHECK(series.timestampAt(series.size() - 1) == 2 * SampleSeries::kChunkSamples - 1);
+
+    series.clear();
+    CHECK(series.isEmpty());
+    CHECK(series.levelCount() == 0);
+}
+
+TEST_CASE("Envelope matches samples in every column", "[sampleseries]")
+{
+    SampleSeries series;
+    const quint64 count = 100000;
+
+    // Sawtooth with one spike, which must survive reduction
+    for (quint64 i = 0; i < count; ++i) {
+        series.append(1000 + i * 10, (i == 54321) ? 1000.0 : static_cast<double>(i % 50));
+    }
+
+    std::vector<EnvelopeColumn> columns;
+    series.envelope(1000, 1000 + count * 10 - 1, 100, columns);
+    REQUIRE(columns.size() == 100);
+    for (int c = 0; c < 100; ++c) {
+        REQUIRE(columns[c].isValid());
+        CHECK(columns[c].min == 0.0);
+        CHECK(columns[c].max == ((c == 54) ? 1000.0 : 49.0));
+    }
+
+    // Range not aligned to buckets
+    series.envelope(1000 + 33 * 10, 1000 + 37 * 10, 5, columns);
+    CHECK(columns[0].min == 33.0);
+    CHECK(columns[4].max == 37.0);
+
+    // Range before data
+    series.envelope(0, 999, 10, columns);
+    CHECK(std::none_of(columns.begin(), columns.end(), [](const EnvelopeColumn& c) { return c.isValid(); }));
+
+    series.envelope(0, std::numeric_limits<quint64>::max(), 1, columns);
+    CHECK(columns[0].min == 0.0);
+    CHECK(columns[0].max == 1000.0);
+}
+
+TEST_CASE("Envelope is exact for buckets crossing columns", "[sampleseries]")
+{
+    SampleSeries series;
+    const quint64 count = 4096;
+
+    // Gap inside bucket and buckets not aligned to columns
+    for (quint64 i = 0; i < count; ++i) {
+        series.append((i < 1000) ? i : 100000 + i, static_cast<double>(i));
+    }
+
+    const quint64 from = 0;
+    const quint64 to = 100000 + count - 1;
+    const int width = 37;
+    std::vector<EnvelopeColumn> expected(
+        width, EnvelopeColumn{ std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() });
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        const auto c = static_cast<int>((series.timestampAt(i) - from) * static_cast<double>(width) / (to - from + 1));
+        expected[c].min = std::min(expected[c].min, series.valueAt(i));
+        expected[c].max = std::max(expected[c].max, series.valueAt(i));
+    }
+
+    std::vector<EnvelopeColumn> columns;
+    series.envelope(from, to, width, columns);
+    REQUIRE(columns.size() == static_cast<std::size_t>(width));
+    for (int c = 0; c < width; ++c) {
+        CHECK(columns[c].isValid() == expected[c].isValid());
+        if (expected[c].isValid()) {
+            CHECK(columns[c].min == expected[c].min);
+            CHECK(columns[c].max == expected[c].max);
+        }
+    }
+}
+
+TEST_CASE("Plot keeps series of selected signals", "[signalplot]")
+{
+    using namespace fakeit;
+    Mock<SPGuiInterface> guiMock;
+    SPGuiInterface::envelope_t envelope;
+
+    Fake(Dtor(guiMock));
+    Fake(Method(guiMock, setDockUndockCbk));
+    When(Method(guiMock, setEnvelopeCbk)).Do([&](const SPGuiInterface::envelope_t& cb) { envelope = cb; });
+    Fake(Method(guiMock, setDataDuration));
+    Fake(Method(guiMock, refresh));
+    When(Method(guiMock, isMainWidgetCreated)).AlwaysReturn(false);
+
+    SignalPlot plot(SignalPlotCtx(&guiMock.get()));
+    const auto catalog = makeCatalog();
+    REQUIRE(envelope);
+    CHECK(!plot.mainWidgetCreated());
+
+    plot.startSimulation();
+    plot.signalsReceived({ sample(0, 5000000, 1.0), sample(1, 5000000, 20.0), sample(0, 7000000, 3.0) }, catalog);
+    CHECK(plot.seriesCount() == 2);
+    REQUIRE(plot.series("Engine.Rpm"));
+    CHECK(plot.series("Engine.Rpm")->size() == 2);
+    CHECK(plot.series("Engine.Speed") == nullptr);
+
+    std::vector<PlotCurve> curves;
+    envelope(0.0, 2.0, 2, curves);
+    REQUIRE(curves.size() == 2);
+    CHECK(curves[0].label == "Engine.Rpm [rpm]");
+    CHECK(curves[0].columns[0].max == 1.0);
+    CHECK(curves[0].columns[1].max == 3.0);
+    CHECK(curves[1].label == "Engine.Temp");
+
+    plot.stopSimulation();
+    Verify(Method(guiMock, setDataDuration).Using(2.0));
+
+    QJsonObject config{ { "signals", QJsonArray{ "Engine.Temp" } } };
+    plot.setConfig(config);
+    CHECK(plot.getConfig()["signals"].toArray().size() == 1);
+    plot.signalsReceived({ sample(0, 8000000, 1.0), sample(1, 8000000, 20.0) }, catalog);
+    CHECK(plot.series("Engine.Rpm") == nullptr);
+    CHECK(plot.series("Engine.Temp")->size() == 1);
+}
+
+int main(int argc, char* argv[])
+{
+    // Refresh timer needs event dispatcher
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
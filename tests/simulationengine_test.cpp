@@ -0,0 +1,136 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QTemporaryDir>
+#include <catch.hpp>
+#include <log.h>
+#include <simulationengine.h>
+#include <tracelogger/tracewriter.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+QJsonObject node(const QString& id, QJsonObject model)
+{
+    return QJsonObject{ { "id", id }, { "model", model } };
+}
+
+QJsonObject connection(const QString& outId, const QString& inId)
+{
+    return QJsonObject{ { "out_id", outId }, { "out_index", 0 }, { "in_id", inId }, { "in_index", 0 } };
+}
+
+CanFrameBatch makeFrames(int count, quint32 firstId)
+{
+    CanFrameBatch batch;
+
+    for (int i = 0; i < count; ++i) {
+        batch.append(toCanFrameRecord(QCanBusFrame(firstId + static_cast<quint32>(i), QByteArray(4, 0x55))));
+        batch.last().timestamp = 0;
+    }
+
+    return batch;
+}
+} // namespace
+
+TEST_CASE("Injected frames reach subscribers and consumers", "[engine]")
+{
+    QTemporaryDir dir;
+    QJsonObject project;
+
+    project["nodes"] = QJsonArray{ node("dev", { { "name", "CanDeviceModel" } }),
+        node("log", { { "name", "TraceLoggerModel" }, { "file", dir.path() + "/engine.cdst" } }),
+        node("view", { { "name", "CanRawViewModel" } }) };
+    project["connections"] = QJsonArray{ connection("dev", "log"), connection("dev", "view") };
+
+    SimulationEngine engine;
+    REQUIRE(engine.load(project, dir.path()));
+    CHECK(engine.nodes() == QStringList({ "dev", "log", "view" }));
+
+    QVector<quint32> ids;
+    int batches = 0;
+    const auto id = engine.subscribe("dev", [&](const CanFrameBatch& frames) {
+        ++batches;
+        for (const auto& rec : frames) {
+            CHECK(rec.timestamp != 0);
+            ids.append(rec.id);
+        }
+    });
+    CHECK(id != SimulationEngine::kInvalidSubscription);
+    CHECK(engine.subscribe("none", [](const CanFrameBatch&) {}) == SimulationEngine::kInvalidSubscription);
+    CHECK(engine.subscribe("log", [](const CanFrameBatch&) {}) == SimulationEngine::kInvalidSubscription);
+
+    CHECK_FALSE(engine.inject("dev", makeFrames(1, 0x10)));
+
+    engine.start();
+    CHECK(engine.isRunning());
+    CHECK_FALSE(engine.inject("log", makeFrames(1, 0x10)));
+    REQUIRE(engine.inject("dev", makeFrames(3, 0x10)));
+    REQUIRE(engine.inject("dev", makeFrames(2, 0x20)));
+    engine.run(1000);
+
+    CHECK(batches == 2);
+    CHECK(ids == QVector<quint32>({ 0x10, 0x11, 0x12, 0x20, 0x21 }));
+    CHECK(engine.nodeStats("log").framesIn == 5);
+    CHECK(engine.nodeStats("view").framesIn == 5);
+
+    engine.unsubscribe(id);
+    REQUIRE(engine.inject("dev", makeFrames(1, 0x30)));
+    engine.stop();
+    CHECK_FALSE(engine.isRunning());
+    CHECK(batches == 2);
+    CHECK(engine.nodeStats("log").framesIn == 6);
+}
+
+TEST_CASE("Trace replays in virtual time without waiting for it", "[engine]")
+{
+    QTemporaryDir dir;
+    const QString trace = dir.path() + "/replay.cdst";
+    const int total = 5000;
+
+    // One record every 2 ms, 10 s of traffic
+    TraceWriter writer;
+    CanFrameBatch records = makeFrames(total, 0);
+    for (int i = 0; i < total; ++i) {
+        records[i].id = static_cast<quint32>(i % 0x7ff);
+        records[i].timestamp = 1000000 + static_cast<quint64>(i) * 2000;
+    }
+    REQUIRE(writer.open(trace));
+    writer.append(records);
+    writer.close();
+
+    QJsonObject project;
+    project["nodes"] = QJsonArray{ node("replay", { { "name", "TraceReplayModel" }, { "file", trace } }) };
+
+    SimulationEngine engine;
+    REQUIRE(engine.load(project, dir.path()));
+    engine.setVirtualTime(true);
+
+    int received = 0;
+    engine.subscribe("replay", [&received](const CanFrameBatch& frames) { received += frames.size(); });
+
+    QElapsedTimer timer;
+    timer.start();
+    engine.start();
+
+    // Half of the trace, then the rest
+    engine.run(4999000);
+    CHECK(received == total / 2);
+    engine.run(6000000);
+    CHECK(received == total);
+    engine.stop();
+
+    CHECK(timer.elapsed() < 5000);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
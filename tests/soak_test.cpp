@@ -0,0 +1,190 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
+#include <algorithm>
+#include <candevice.h>
+#include <catch.hpp>
+#include <headlessproject.h>
+#include <instrumentation.h>
+#include <log.h>
+#include <syntheticcanbusdevice.h>
+#include <tracelogger.h>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+
+/**
+*   @brief  Limits the soak run has to stay within, stored in soak_thresholds.json next to this file. Frame count
+*           can be raised for long runs with CDS_SOAK_FRAMES environment variable.
+*/
+struct Thresholds {
+    qint64 frames{ 1000000 };
+    double warmupFraction{ 0.2 };
+    double minFramesPerSecond{ 0.0 };
+    double maxRssGrowthKbPerMillion{ 0.0 };
+    double maxBatchP99Us{ 0.0 };
+
+    static Thresholds read()
+    {
+        Thresholds thresholds;
+        QFile file(CDS_SOAK_THRESHOLDS);
+
+        REQUIRE(file.open(QIODevice::ReadOnly));
+        const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+
+        thresholds.frames = static_cast<qint64>(json["frames"].toDouble(thresholds.frames));
+        thresholds.warmupFraction = json["warmupFraction"].toDouble(thresholds.warmupFraction);
+        thresholds.minFramesPerSecond = json["minFramesPerSecond"].toDouble();
+        thresholds.maxRssGrowthKbPerMillion = json["maxRssGrowthKbPerMillion"].toDouble();
+        thresholds.maxBatchP99Us = json["maxBatchP99Us"].toDouble();
+
+        const qint64 frames = qEnvironmentVariableIntValue("CDS_SOAK_FRAMES");
+        if (frames > 0) {
+            thresholds.frames = frames;
+        }
+
+        return thresholds;
+    }
+};
+
+/**
+*   @return resident set size in kilobytes, -1 if it cannot be read on this platform
+*/
+qint64 residentKb()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+
+        if (fields.size() > 1) {
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE) / 1024;
+        }
+    }
+#endif
+
+    return -1;
+}
+
+QJsonObject node(const QString& id, QJsonObject model)
+{
+    return QJsonObject{ { "id", id }, { "model", model } };
+}
+
+QJsonObject connection(const QString& outId, const QString& inId)
+{
+    return QJsonObject{ { "out_id", outId }, { "out_index", 0 }, { "in_id", inId }, { "in_index", 0 } };
+}
+
+} // namespace
+
+TEST_CASE("Frame path keeps throughput, memory and latency over long run", "[soak]")
+{
+    const Thresholds thresholds = Thresholds::read();
+    QTemporaryDir dir;
+    QJsonObject project;
+
+    // View keeps fewer rows than warm-up pushes, so its ring buffer is full before memory baseline is taken
+    project["nodes"] = QJsonArray{ node("dev", { { "name", "CanDeviceModel" } }),
+        node("view", { { "name", "CanRawViewModel" }, { "retention", 100000 } }),
+        node("log", { { "name", "TraceLoggerModel" }, { "file", dir.path() + "/soak.cdst" } }) };
+    project["connections"] = QJsonArray{ connection("dev", "view"), connection("dev", "log") };
+
+    HeadlessProject headless;
+    REQUIRE(headless.load(project, dir.path()));
+    auto device = dynamic_cast<CanDevice*>(headless.component("dev"));
+    auto logger = dynamic_cast<TraceLogger*>(headless.component("log"));
+    REQUIRE(device);
+    REQUIRE(logger);
+
+    // Traffic is generated ahead of wall clock, 100 ms of fully loaded bus at a time
+    SyntheticCanBusDevice synthetic;
+    synthetic.setConfigurationParameter(
+        SyntheticCanBusDevice::ProfileKey, QJsonObject{ { "ids", 200 }, { "busLoad", 100 }, { "batchInterval", 0 } });
+    REQUIRE(synthetic.connectDevice());
+    quint64 busTimeUs = canTimestampNow();
+
+    Instrumentation::HistogramSnapshot batchUs;
+    const qint64 warmup = static_cast<qint64>(thresholds.frames * thresholds.warmupFraction);
+    qint64 frames = 0;
+    qint64 warmedUp = 0;
+    qint64 baselineKb = -1;
+    QElapsedTimer total;
+    QElapsedTimer measured;
+    QElapsedTimer batchTimer;
+
+    headless.startSimulation();
+    total.start();
+
+    while (frames < thresholds.frames) {
+        busTimeUs += 100000;
+        synthetic.generate(busTimeUs);
+
+        QVector<QCanBusFrame> batch;
+        while (synthetic.framesAvailable() > 0) {
+            batch.append(synthetic.readFrame());
+        }
+
+        batchTimer.start();
+        emit device->frameBatchReceived(batch);
+        const auto us = static_cast<quint64>(batchTimer.nsecsElapsed() / 1000);
+
+        // View and logger flush from their timers
+        QCoreApplication::processEvents();
+
+        const bool measuring = baselineKb >= 0;
+        frames += batch.size();
+
+        if (measuring) {
+            batchUs.bins[Instrumentation::histogramBin(us)] += 1;
+            batchUs.count += 1;
+            batchUs.sum += us;
+            batchUs.max = std::max(batchUs.max, us);
+        } else if (frames >= warmup) {
+            baselineKb = std::max<qint64>(residentKb(), 0);
+            warmedUp = frames;
+            measured.start();
+        }
+    }
+
+    const qint64 measuredFrames = frames - warmedUp;
+    const double seconds = std::max<qint64>(measured.elapsed(), 1) / 1000.0;
+    const double framesPerSecond = measuredFrames / seconds;
+    const qint64 rssKb = residentKb();
+    const double rssGrowthKbPerMillion
+        = (rssKb >= 0) ? (rssKb - baselineKb) * 1000000.0 / std::max<qint64>(measuredFrames, 1) : 0.0;
+    const double p99Us = static_cast<double>(batchUs.percentile(0.99));
+
+    headless.stopSimulation();
+
+    cds_info("Soak: {} frames in {:.1f} s, {:.0f} frames/s, RSS growth {:.0f} kB per million frames, "
+             "batch dispatch mean {:.1f} us, p99 {:.0f} us, max {} us",
+        frames, total.elapsed() / 1000.0, framesPerSecond, rssGrowthKbPerMillion, batchUs.mean(), p99Us, batchUs.max);
+
+    CHECK(logger->framesWritten() == static_cast<quint64>(frames));
+    CHECK(framesPerSecond >= thresholds.minFramesPerSecond);
+    if (rssKb >= 0) {
+        CHECK(rssGrowthKbPerMillion <= thresholds.maxRssGrowthKbPerMillion);
+    }
+    CHECK(p99Us <= thresholds.maxBatchP99Us);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
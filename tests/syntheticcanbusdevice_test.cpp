@@ -0,0 +1,181 @@
+#include <QSignalSpy>
+#include <QtCore/QJsonArray>
+#include <candeviceqt.h>
+#include <canbustiming.h>
+#include <canframerecord.h>
+#include <catch.hpp>
+#include <syntheticcanbusdevice.h>
+
+namespace {
+
+// Standard 8 byte frame at 500 kbit/s
+constexpr quint64 kFrameUs = 270;
+
+QVector<QCanBusFrame> readAll(QCanBusDevice& device)
+{
+    QVector<QCanBusFrame> frames;
+
+    while (device.framesAvailable() > 0) {
+        frames.append(device.readFrame());
+    }
+
+    return frames;
+}
+
+quint64 timestampUs(const QCanBusFrame& frame)
+{
+    return static_cast<quint64>(frame.timeStamp().seconds()) * 1000000 + frame.timeStamp().microSeconds();
+}
+
+/**
+*   @brief  Connects device with profile stepped manually
+*   @return time right before connection in microseconds
+*/
+quint64 start(SyntheticCanBusDevice& device, QJsonObject profile)
+{
+    profile["batchInterval"] = 0;
+    device.setConfigurationParameter(SyntheticCanBusDevice::ProfileKey, profile);
+
+    const quint64 now = canTimestampNow();
+    REQUIRE(device.connectDevice());
+
+    return now;
+}
+
+} // namespace
+
+TEST_CASE("Synthetic profile is read from JSON", "[synthetic]")
+{
+    auto profile = SyntheticTrafficProfile::fromJson({});
+    CHECK(profile.ids == 16);
+    CHECK(profile.length == 8);
+    CHECK(profile.periods == QVector<int>{ 10 });
+
+    profile = SyntheticTrafficProfile::fromJson({ { "ids", 100 }, { "periods", QJsonArray{ 5, 0, 20 } },
+        { "canFd", true }, { "length", 30 }, { "busLoad", 150 }, { "batchInterval", -1 } });
+    CHECK(profile.ids == 100);
+    CHECK(profile.periods == (QVector<int>{ 5, 20 }));
+    CHECK(profile.length == 32);
+    CHECK(profile.busLoad == 0.0);
+    CHECK(profile.batchInterval == 1);
+
+    // Classic frames cannot carry more than 8 bytes, FD frames default to 64
+    CHECK(SyntheticTrafficProfile::fromJson({ { "length", 12 } }).length == 8);
+    CHECK(SyntheticTrafficProfile::fromJson({ { "canFd", true } }).length == 64);
+}
+
+TEST_CASE("Periodic frames are generated with bus timestamps", "[synthetic]")
+{
+    SyntheticCanBusDevice device;
+    QSignalSpy received(&device, &QCanBusDevice::framesReceived);
+    const quint64 t0 = start(device, { { "ids", 10 }, { "periods", QJsonArray{ 10 } }, { "randomPayload", false } });
+
+    device.generate(t0 + 1000000);
+    CHECK(received.count() == 1);
+
+    const auto frames = readAll(device);
+    CHECK(frames.size() <= 1000);
+    CHECK(frames.size() >= 990);
+
+    for (int i = 1; i < frames.size(); ++i) {
+        REQUIRE(timestampUs(frames[i]) >= timestampUs(frames[i - 1]) + kFrameUs);
+    }
+    CHECK(timestampUs(frames.last()) <= t0 + 1000000);
+    CHECK(frames[0].frameId() == 0x100);
+    CHECK(frames[9].frameId() == 0x109);
+    CHECK(frames[10].frameId() == 0x100);
+    // Counter payload
+    CHECK(frames[10].payload().at(0) == 1);
+
+    // Nothing new until time advances
+    device.generate(t0 + 1000000);
+    CHECK(received.count() == 1);
+    CHECK(device.framesAvailable() == 0);
+}
+
+TEST_CASE("Bus load target sets frame rate", "[synthetic]")
+{
+    SyntheticCanBusDevice device;
+    const quint64 t0 = start(device, { { "ids", 20 }, { "busLoad", 50 } });
+
+    device.generate(t0 + 1000000);
+    const int half = readAll(device).size();
+    // 0.5 s of 270 us frames
+    CHECK(half >= 1800);
+    CHECK(half <= 1852);
+
+    device.disconnectDevice();
+    const quint64 t1 = start(device, { { "ids", 4 }, { "busLoad", 100 } });
+
+    device.generate(t1 + 1000000);
+    const auto frames = readAll(device);
+    CHECK(frames.size() >= 3650);
+    CHECK(frames.size() <= 3704);
+    for (int i = 1; i < frames.size(); ++i) {
+        REQUIRE(timestampUs(frames[i]) - timestampUs(frames[i - 1]) == kFrameUs);
+    }
+}
+
+TEST_CASE("Bursts are sent back-to-back", "[synthetic]")
+{
+    SyntheticCanBusDevice device;
+    const quint64 t0 = start(device, { { "ids", 0 }, { "burstLength", 5 }, { "burstInterval", 100 } });
+
+    device.generate(t0 + 1000000);
+    const auto frames = readAll(device);
+    REQUIRE(frames.size() == 45);
+    CHECK(frames[0].frameId() == 0x100);
+    CHECK(timestampUs(frames[4]) - timestampUs(frames[0]) == 4 * kFrameUs);
+    CHECK(timestampUs(frames[5]) - timestampUs(frames[0]) >= 99000);
+}
+
+TEST_CASE("CAN FD frames", "[synthetic]")
+{
+    SyntheticCanBusDevice device;
+    const quint64 t0 = start(device, { { "ids", 1 }, { "canFd", true }, { "periods", QJsonArray{ 1 } } });
+
+    device.generate(t0 + 10000);
+    const auto frames = readAll(device);
+    REQUIRE(frames.size() >= 9);
+    CHECK(frames[0].payload().size() == 64);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    CHECK(frames[0].hasFlexibleDataRateFormat());
+#endif
+}
+
+TEST_CASE("Written frames are confirmed and looped back", "[synthetic]")
+{
+    SyntheticCanBusDevice device;
+    QSignalSpy written(&device, &QCanBusDevice::framesWritten);
+    const QCanBusFrame frame(0x123, QByteArray(8, 0x55));
+
+    CHECK(!device.writeFrame(frame));
+
+    device.setConfigurationParameter(QCanBusDevice::ReceiveOwnKey, true);
+    start(device, { { "ids", 0 } });
+    CHECK(!device.writeFrame(QCanBusFrame(QCanBusFrame::InvalidFrame)));
+    CHECK(device.writeFrame(frame));
+    CHECK(device.writeFrame(frame));
+    CHECK(device.writeFrame(frame));
+
+    device.generate(canTimestampNow() + 10000);
+    REQUIRE(written.count() == 1);
+    CHECK(written.at(0).at(0).toLongLong() == 3);
+
+    const auto frames = readAll(device);
+    REQUIRE(frames.size() == 3);
+    CHECK(frames[2].frameId() == 0x123);
+    CHECK(timestampUs(frames[2]) - timestampUs(frames[1]) == kFrameUs);
+}
+
+TEST_CASE("Synthetic backend is selected by name", "[synthetic]")
+{
+    CanDeviceQt device;
+    const QJsonObject profile{ { "ids", 0 }, { "batchInterval", 0 } };
+
+    REQUIRE(device.init(SyntheticCanBusDevice::kBackendName, "sim0"));
+    device.setConfigurationParameter(SyntheticCanBusDevice::ProfileKey, profile);
+    CHECK(device.connectDevice());
+    CHECK(device.writeFrame(QCanBusFrame(0x1, QByteArray(1, 0))));
+    device.disconnectDevice();
+}
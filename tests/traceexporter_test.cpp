@@ -0,0 +1,255 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <catch.hpp>
+#include <cstring>
+#include <log.h>
+#include <tracelogger/traceexporter.h>
+#include <tracelogger/tracewriter.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, quint8 flags, const char* payload, quint64 timestamp)
+{
+    const QByteArray data = QByteArray::fromHex(payload);
+    CanFrameRecord rec{};
+
+    rec.timestamp = timestamp;
+    rec.id = id;
+    rec.flags = flags;
+    rec.length = static_cast<quint8>(data.size());
+    std::memcpy(rec.payload, data.constData(), static_cast<std::size_t>(data.size()));
+
+    return rec;
+}
+
+// One classic frame per millisecond, ids equal to record index (modulo 11-bit range)
+CanFrameBatch makeRecords(int count)
+{
+    CanFrameBatch records;
+
+    for (int i = 0; i < count; ++i) {
+        const quint64 timestamp = 1000000 + static_cast<quint64>(i) * 1000;
+
+        records.append(makeRecord(static_cast<quint32>(i) & 0x7ff, 0, "aabb", timestamp));
+    }
+
+    return records;
+}
+
+QByteArray exportToMemory(const CanFrameBatch& records, TraceExporter::Format format, int threads = 1)
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/export";
+    TraceExporter::Options options;
+    options.format = format;
+    options.threads = threads;
+
+    REQUIRE(TraceExporter::exportRecords(path, records, options));
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    return file.readAll();
+}
+
+template <typename T> T read(const QByteArray& data, int offset)
+{
+    T value;
+    REQUIRE(offset + static_cast<int>(sizeof(T)) <= data.size());
+    std::memcpy(&value, data.constData() + offset, sizeof(T));
+    return value;
+}
+} // namespace
+
+TEST_CASE("Format is guessed from suffix", "[traceexporter]")
+{
+    TraceExporter::Format format;
+
+    CHECK(TraceExporter::formatFromPath("a/b.asc", format));
+    CHECK(format == TraceExporter::Format::Asc);
+    CHECK(TraceExporter::formatFromPath("b.BLF", format));
+    CHECK(format == TraceExporter::Format::Blf);
+    CHECK(TraceExporter::formatFromPath("b.log", format));
+    CHECK(format == TraceExporter::Format::Candump);
+    CHECK(TraceExporter::formatFromPath("b.pcapng", format));
+    CHECK(format == TraceExporter::Format::Pcapng);
+    CHECK_FALSE(TraceExporter::formatFromPath("b.cdst", format));
+}
+
+TEST_CASE("Candump log lines", "[traceexporter]")
+{
+    CanFrameBatch records;
+    records.append(makeRecord(0x123, 0, "deadbeef", 1436509052249713ULL));
+    records.append(makeRecord(0x1abcdef, CanFrameRecord::ExtendedId | CanFrameRecord::Tx, "01", 1436509052249714ULL));
+    records.append(makeRecord(0x7df, CanFrameRecord::Remote, "", 1436509052249715ULL));
+    records.append(makeRecord(0x10, CanFrameRecord::FlexibleDataRate | CanFrameRecord::BitrateSwitch,
+        "00112233445566778899aabb", 1436509052249716ULL));
+
+    const QList<QByteArray> lines = exportToMemory(records, TraceExporter::Format::Candump).split('\n');
+
+    REQUIRE(lines.size() == 5);
+    CHECK(lines[0] == "(1436509052.249713) can0 123#DEADBEEF");
+    CHECK(lines[1] == "(1436509052.249714) can0 01ABCDEF#01");
+    CHECK(lines[2] == "(1436509052.249715) can0 7DF#R");
+    CHECK(lines[3] == "(1436509052.249716) can0 010##100112233445566778899AABB");
+    CHECK(lines[4].isEmpty());
+}
+
+TEST_CASE("ASC file has header, relative timestamps and footer", "[traceexporter]")
+{
+    CanFrameBatch records;
+    records.append(makeRecord(0x123, 0, "112233", 5000000));
+    records.append(makeRecord(0x1abcdef, CanFrameRecord::ExtendedId | CanFrameRecord::Tx, "01", 6500000));
+    records.append(makeRecord(0x10, CanFrameRecord::FlexibleDataRate, "00112233445566778899aabb", 6500001));
+
+    const QList<QByteArray> lines = exportToMemory(records, TraceExporter::Format::Asc).split('\n');
+
+    REQUIRE(lines.size() == 11);
+    CHECK(lines[0].startsWith("date "));
+    CHECK(lines[1] == "base hex  timestamps absolute");
+    CHECK(lines[4].startsWith("Begin Triggerblock "));
+    CHECK(lines[6] == "   0.000000 1  123             Rx   d 3 11 22 33");
+    CHECK(lines[7] == "   1.500000 1  1ABCDEFx        Tx   d 1 01");
+    CHECK(lines[8].startsWith("   1.500001 CANFD   1 Rx         10"));
+    CHECK(lines[8].contains(" 0 0 9 12 00 11 22 33 44 55 66 77 88 99 AA BB "));
+    CHECK(lines[9] == "End TriggerBlock");
+}
+
+TEST_CASE("Chunks formatted by several threads are written in order", "[traceexporter]")
+{
+    const int count = 3 * TraceExporter::kChunkRecords + 5;
+    const CanFrameBatch records = makeRecords(count);
+
+    const QByteArray parallel = exportToMemory(records, TraceExporter::Format::Candump, 4);
+    const QByteArray serial = exportToMemory(records, TraceExporter::Format::Candump, 1);
+
+    CHECK(parallel == serial);
+    CHECK(parallel.count('\n') == count);
+    // Record 49156 is the last one, its id wraps to 0x004
+    CHECK(parallel.endsWith("(50.156000) can0 004#AABB\n"));
+}
+
+TEST_CASE("pcapng uses SocketCAN link type", "[traceexporter]")
+{
+    CanFrameBatch records;
+    records.append(makeRecord(0x1abcdef, CanFrameRecord::ExtendedId, "0102", 0x123456789ULL));
+    records.append(makeRecord(0x10, CanFrameRecord::FlexibleDataRate | CanFrameRecord::Tx, "00112233445566778899", 2));
+
+    const QByteArray data = exportToMemory(records, TraceExporter::Format::Pcapng);
+
+    // Section header block
+    REQUIRE(read<quint32>(data, 0) == 0x0A0D0D0A);
+    CHECK(read<quint32>(data, 8) == 0x1A2B3C4D);
+    int offset = static_cast<int>(read<quint32>(data, 4));
+
+    // Interface description block
+    REQUIRE(read<quint32>(data, offset) == 1);
+    CHECK(read<quint16>(data, offset + 8) == 227);
+    offset += static_cast<int>(read<quint32>(data, offset + 4));
+
+    // Classic frame in enhanced packet block
+    REQUIRE(read<quint32>(data, offset) == 6);
+    CHECK(read<quint32>(data, offset + 12) == 0x1);
+    CHECK(read<quint32>(data, offset + 16) == 0x23456789);
+    CHECK(read<quint32>(data, offset + 20) == 16);
+    CHECK(qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(data.constData()) + offset + 28) == 0x81abcdef);
+    CHECK(read<quint8>(data, offset + 32) == 2);
+    CHECK(read<quint8>(data, offset + 36) == 0x01);
+    offset += static_cast<int>(read<quint32>(data, offset + 4));
+
+    // CAN FD frame is 72 bytes and marked as outbound
+    REQUIRE(read<quint32>(data, offset) == 6);
+    CHECK(read<quint32>(data, offset + 20) == 72);
+    CHECK(read<quint8>(data, offset + 32) == 10);
+    CHECK(read<quint8>(data, offset + 33) == 0x04);
+    CHECK(read<quint16>(data, offset + 28 + 72) == 2);
+    CHECK(read<quint32>(data, offset + 28 + 72 + 4) == 2);
+    offset += static_cast<int>(read<quint32>(data, offset + 4));
+
+    CHECK(offset == data.size());
+}
+
+TEST_CASE("BLF objects are stored in compressed containers", "[traceexporter]")
+{
+    // Enough records for several containers
+    const int count = 3 * TraceExporter::kBlfContainerSize / 48;
+    const CanFrameBatch records = makeRecords(count);
+
+    const QByteArray data = exportToMemory(records, TraceExporter::Format::Blf, 2);
+
+    REQUIRE(read<quint32>(data, 0) == 0x47474F4C);
+    REQUIRE(read<quint32>(data, 4) == 144);
+    CHECK(read<quint64>(data, 16) == static_cast<quint64>(data.size()));
+    CHECK(read<quint32>(data, 32) == static_cast<quint32>(count));
+
+    int offset = 144;
+    int containers = 0;
+    int objects = 0;
+
+    while (offset < data.size()) {
+        REQUIRE(read<quint32>(data, offset) == 0x4A424F4C);
+        REQUIRE(read<quint32>(data, offset + 12) == 10);
+        const quint32 size = read<quint32>(data, offset + 8);
+        const quint32 uncompressedSize = read<quint32>(data, offset + 24);
+
+        // qUncompress expects zlib stream prefixed with big endian size
+        QByteArray compressed(4, '\0');
+        qToBigEndian(uncompressedSize, reinterpret_cast<uchar*>(compressed.data()));
+        compressed.append(data.constData() + offset + 32, static_cast<int>(size) - 32);
+        const QByteArray inner = qUncompress(compressed);
+        REQUIRE(inner.size() == static_cast<int>(uncompressedSize));
+        CHECK(inner.size() <= TraceExporter::kBlfContainerSize);
+
+        for (int pos = 0; pos < inner.size(); pos += 48) {
+            REQUIRE(read<quint32>(inner, pos) == 0x4A424F4C);
+            REQUIRE(read<quint32>(inner, pos + 12) == 1);
+            CHECK(read<quint64>(inner, pos + 24) == static_cast<quint64>(objects) * 1000000);
+            CHECK(read<quint32>(inner, pos + 36) == (static_cast<quint32>(objects) & 0x7ff));
+            ++objects;
+        }
+
+        offset += static_cast<int>(size + size % 4);
+        ++containers;
+    }
+
+    CHECK(containers >= 3);
+    CHECK(objects == count);
+}
+
+TEST_CASE("Binary trace is exported straight from file", "[traceexporter]")
+{
+    QTemporaryDir dir;
+    const QString tracePath = dir.path() + "/trace.cdst";
+    const QString path = dir.path() + "/trace.log";
+    const CanFrameBatch records = makeRecords(TraceWriter::kBlockRecords + 10);
+
+    REQUIRE(TraceWriter::writeTrace(tracePath, records));
+
+    TraceExporter::Options options;
+    options.format = TraceExporter::Format::Candump;
+    options.interfaceName = "vcan1";
+    REQUIRE(TraceExporter::exportTrace(path, tracePath, options));
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+
+    CHECK(data.count('\n') == records.size());
+    CHECK(data.startsWith("(1.000000) vcan1 000#AABB\n"));
+
+    CHECK_FALSE(TraceExporter::exportTrace(path, dir.path() + "/missing.cdst", options));
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,172 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <catch.hpp>
+#include <log.h>
+#include <tracefile.h>
+#include <tracelogger/tracelogger.h>
+#include <tracelogger/tracewriter.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameBatch makeBatch(quint32 firstId, int count, quint64 firstTimestamp)
+{
+    CanFrameBatch batch;
+
+    for (int i = 0; i < count; ++i) {
+        CanFrameRecord rec = toCanFrameRecord(QCanBusFrame(firstId + i, QByteArray::fromHex("0102")));
+        rec.timestamp = firstTimestamp + i;
+        batch.append(rec);
+    }
+
+    return batch;
+}
+
+template <typename T> T readAt(const QByteArray& data, qint64 offset)
+{
+    T value;
+    REQUIRE(offset + static_cast<qint64>(sizeof(T)) <= data.size());
+    std::memcpy(&value, data.constData() + offset, sizeof(T));
+    return value;
+}
+} // namespace
+
+TEST_CASE("Trace consists of header, data blocks, index and trailer", "[tracelogger]")
+{
+    using namespace TraceFile;
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/test.cdst";
+    const int total = 2 * TraceWriter::kBlockRecords + 100;
+
+    TraceWriter writer;
+    REQUIRE(writer.open(path));
+    writer.append(makeBatch(0x100, total, 1000));
+    writer.close();
+    CHECK(writer.recordsWritten() == static_cast<quint64>(total));
+    CHECK(writer.recordsDropped() == 0);
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+
+    const auto header = readAt<FileHeader>(data, 0);
+    CHECK(header.magic == kFileMagic);
+    CHECK(header.version == kVersion);
+    CHECK(header.recordSize == sizeof(CanFrameRecord));
+
+    const auto trailer = readAt<FileTrailer>(data, data.size() - sizeof(FileTrailer));
+    CHECK(trailer.magic == kTrailerMagic);
+    CHECK(trailer.recordCount == static_cast<quint64>(total));
+
+    const auto index = readAt<BlockHeader>(data, trailer.lastIndexOffset);
+    CHECK(index.magic == kBlockMagic);
+    CHECK(index.kind == IndexBlock);
+    CHECK(index.link == 0);
+    CHECK(index.minTimestamp == 1000);
+    CHECK(index.maxTimestamp == 1000 + total - 1);
+
+    quint64 records = 0;
+    for (quint32 i = 0; i < index.count; ++i) {
+        const qint64 entryOffset = trailer.lastIndexOffset + sizeof(BlockHeader) + i * sizeof(IndexEntry);
+        const auto entry = readAt<IndexEntry>(data, entryOffset);
+        const auto block = readAt<BlockHeader>(data, entry.offset);
+        CHECK(block.kind == DataBlock);
+        CHECK(block.count == entry.count);
+        CHECK(block.link == records);
+        CHECK(entry.firstRecord == records);
+
+        const auto rec = readAt<CanFrameRecord>(data, entry.offset + sizeof(BlockHeader));
+        CHECK(rec.id == 0x100 + records);
+        CHECK(rec.timestamp == block.minTimestamp);
+        records += block.count;
+    }
+    CHECK(records == static_cast<quint64>(total));
+}
+
+TEST_CASE("Records are flushed periodically while trace is open", "[tracelogger]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/periodic.cdst";
+
+    TraceWriter writer;
+    REQUIRE(writer.open(path, 10));
+    writer.append(makeBatch(0x1, 5, 1));
+
+    const qint64 expectedSize
+        = sizeof(TraceFile::FileHeader) + sizeof(TraceFile::BlockHeader) + 5 * sizeof(CanFrameRecord);
+
+    // Nothing triggers the write except flush interval
+    for (int i = 0; (i < 100) && (QFile(path).size() < expectedSize); ++i) {
+        QThread::msleep(10);
+    }
+    CHECK(writer.recordsWritten() == 5);
+    CHECK(QFile(path).size() == expectedSize);
+}
+
+TEST_CASE("Snapshot is written synchronously as complete trace", "[tracelogger]")
+{
+    using namespace TraceFile;
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/snapshot.cdst";
+    const int total = TraceWriter::kBlockRecords + 1;
+
+    REQUIRE(TraceWriter::writeTrace(path, makeBatch(0x200, total, 50)));
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+
+    const auto trailer = readAt<FileTrailer>(data, data.size() - sizeof(FileTrailer));
+    CHECK(trailer.magic == kTrailerMagic);
+    CHECK(trailer.recordCount == static_cast<quint64>(total));
+    CHECK(trailer.endTimestamp == 50 + total - 1);
+
+    const auto index = readAt<BlockHeader>(data, trailer.lastIndexOffset);
+    CHECK(index.count == 2);
+
+    CHECK(!TraceWriter::writeTrace(dir.path() + "/missing/snapshot.cdst", makeBatch(0x200, 1, 50)));
+}
+
+TEST_CASE("TraceLogger writes trace between simulation start and stop", "[tracelogger]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/logger.cdst";
+    TraceLogger logger;
+    QJsonObject config;
+
+    config["file"] = path;
+    config["flushInterval"] = 60000; // everything is written on stop, in a single block
+    logger.setConfig(config);
+    CHECK(logger.getConfig()["file"].toString() == path);
+
+    // Frames outside of simulation are ignored
+    logger.frameBatchReceived(makeBatch(0x10, 3, 1));
+    logger.startSimulation();
+    logger.frameBatchReceived(makeBatch(0x20, 3, 1));
+    logger.frameBatchSent(false, makeBatch(0x30, 1, 10));
+    logger.stopSimulation();
+
+    CHECK(logger.tracePath() == path);
+    CHECK(logger.framesWritten() == 4);
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    const qint64 firstRecord = sizeof(TraceFile::FileHeader) + sizeof(TraceFile::BlockHeader);
+
+    CHECK(readAt<CanFrameRecord>(data, firstRecord).id == 0x20);
+    const auto failed = readAt<CanFrameRecord>(data, firstRecord + 3 * sizeof(CanFrameRecord));
+    CHECK(failed.id == 0x30);
+    CHECK(failed.hasFlag(CanFrameRecord::TxFailed));
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
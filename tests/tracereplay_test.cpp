@@ -0,0 +1,306 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <catch.hpp>
+#include <log.h>
+#include <releasetiming.h>
+#include <atomic>
+#include <simclock.h>
+#include <tracelogger/tracewriter.h>
+#include <tracereader.h>
+#include <tracereplay/tracereplay.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+// Writes trace with one record per millisecond, ids equal to record index
+void writeTrace(const QString& path, int count, quint64 firstTimestamp = 1000000)
+{
+    TraceWriter writer;
+    CanFrameBatch batch;
+
+    for (int i = 0; i < count; ++i) {
+        CanFrameRecord rec = toCanFrameRecord(QCanBusFrame(static_cast<quint32>(i), QByteArray::fromHex("aa")));
+        rec.timestamp = firstTimestamp + static_cast<quint64>(i) * 1000;
+        batch.append(rec);
+    }
+
+    REQUIRE(writer.open(path));
+    writer.append(batch);
+    writer.close();
+}
+} // namespace
+
+TEST_CASE("Reader gives random access to records of complete trace", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/reader.cdst";
+    const int total = 3 * TraceWriter::kBlockRecords + 10;
+    writeTrace(path, total);
+
+    TraceReader reader;
+    REQUIRE(reader.open(path));
+    CHECK(reader.isComplete());
+    CHECK(reader.recordCount() == static_cast<quint64>(total));
+    CHECK(reader.blocks().size() == 4);
+    CHECK(reader.firstTimestamp() == 1000000);
+    CHECK(reader.lastTimestamp() == 1000000 + static_cast<quint64>(total - 1) * 1000);
+    CHECK(reader.record(TraceWriter::kBlockRecords + 5)->id == static_cast<quint32>(TraceWriter::kBlockRecords + 5));
+
+    // Range spanning block boundary
+    const auto batch = reader.records(TraceWriter::kBlockRecords - 2, 4);
+    REQUIRE(batch.size() == 4);
+    CHECK(batch[0].id == static_cast<quint32>(TraceWriter::kBlockRecords - 2));
+    CHECK(batch[3].id == static_cast<quint32>(TraceWriter::kBlockRecords + 1));
+
+    CHECK(reader.findTimestamp(0) == 0);
+    CHECK(reader.findTimestamp(1000000 + 5000) == 5);
+    CHECK(reader.findTimestamp(1000000 + 5001) == 6);
+    CHECK(reader.findTimestamp(2000000000) == static_cast<quint64>(total));
+}
+
+TEST_CASE("Reader recovers trace without trailer", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/truncated.cdst";
+    writeTrace(path, TraceWriter::kBlockRecords + 1);
+
+    QFile file(path);
+    REQUIRE(file.resize(file.size() - static_cast<qint64>(sizeof(TraceFile::FileTrailer))));
+
+    TraceReader reader;
+    REQUIRE(reader.open(path));
+    CHECK_FALSE(reader.isComplete());
+    CHECK(reader.recordCount() == static_cast<quint64>(TraceWriter::kBlockRecords + 1));
+    CHECK(reader.record(TraceWriter::kBlockRecords)->id == static_cast<quint32>(TraceWriter::kBlockRecords));
+}
+
+TEST_CASE("Reader rejects files that are not traces", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/garbage.cdst";
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(100, 'x'));
+    file.close();
+
+    TraceReader reader;
+    CHECK_FALSE(reader.open(path));
+    CHECK_FALSE(reader.open(dir.path() + "/missing.cdst"));
+}
+
+TEST_CASE("Replay emits all frames in order at scaled speed", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/replay.cdst";
+    writeTrace(path, 200); // 200 ms of traffic
+
+    TraceReplay replay;
+    QJsonObject config;
+    config["file"] = path;
+    config["speed"] = 10.0;
+    replay.setConfig(config);
+
+    QVector<quint32> ids;
+    int batches = 0;
+    bool finished = false;
+    bool stamped = false;
+    QObject::connect(&replay, &TraceReplay::sendFrames, [&](const CanFrameBatch& frames) {
+        ++batches;
+        for (const auto& rec : frames) {
+            ids.append(rec.id);
+            stamped |= (rec.timestamp != 0);
+        }
+    });
+    QObject::connect(&replay, &TraceReplay::finished, [&] { finished = true; });
+
+    QElapsedTimer timer;
+    timer.start();
+    replay.startSimulation();
+    CHECK(replay.recordCount() == 200);
+
+    while (!finished && (timer.elapsed() < 2000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    REQUIRE(finished);
+    CHECK_FALSE(replay.isPlaying());
+    REQUIRE(ids.size() == 200);
+    for (int i = 0; i < ids.size(); ++i) {
+        CHECK(ids[i] == static_cast<quint32>(i));
+    }
+    CHECK_FALSE(stamped);
+    // Frames due in the same tick are sent as one batch
+    CHECK(batches < 200);
+    CHECK(timer.elapsed() >= 15);
+}
+
+TEST_CASE("Replay in virtual time skips idle periods", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/virtual.cdst";
+    const int total = 10000;
+    writeTrace(path, total); // 10 s of traffic
+
+    TraceReplay replay;
+    QJsonObject config;
+    config["file"] = path;
+    replay.setConfig(config);
+
+    int received = 0;
+    bool ordered = true;
+    bool finished = false;
+    QObject::connect(&replay, &TraceReplay::sendFrames, [&](const CanFrameBatch& frames) {
+        for (const auto& rec : frames) {
+            ordered &= (rec.id == static_cast<quint32>(received++));
+        }
+    });
+    QObject::connect(&replay, &TraceReplay::finished, [&] { finished = true; });
+
+    SimClock& clock = SimClock::instance();
+    clock.start(SimClock::Mode::Virtual);
+    const quint64 startUs = SimClock::nowUs();
+
+    QElapsedTimer timer;
+    timer.start();
+    replay.startSimulation();
+    CHECK(replay.isPlaying());
+
+    while (!finished && (timer.elapsed() < 5000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    REQUIRE(finished);
+    CHECK(received == total);
+    CHECK(ordered);
+    CHECK_FALSE(replay.isPlaying());
+    CHECK(SimClock::nowUs() - startUs == static_cast<quint64>(total - 1) * 1000);
+    CHECK(clock.pendingEvents() == 0);
+    CHECK(timer.elapsed() < 5000);
+
+    clock.stop();
+    CHECK_FALSE(SimClock::isVirtual());
+}
+
+TEST_CASE("Virtual clock waits for events of other threads without blocking", "[tracereplay]")
+{
+    QThread worker;
+    QObject remote;
+    QObject local;
+    std::atomic<bool> release{ false };
+    bool localRan = false;
+
+    remote.moveToThread(&worker);
+    worker.start();
+
+    SimClock& clock = SimClock::instance();
+    clock.start(SimClock::Mode::Virtual);
+    const quint64 startUs = SimClock::nowUs();
+
+    clock.schedule(&remote, startUs + 1000, [&release] {
+        while (!release.load()) {
+            QThread::yieldCurrentThread();
+        }
+    });
+    clock.schedule(&local, startUs + 2000, [&localRan] { localRan = true; });
+
+    // Remote event is posted, clock stays at its instant until it reports back
+    CHECK(clock.step());
+    CHECK_FALSE(clock.step());
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    CHECK(SimClock::nowUs() == startUs + 1000);
+    CHECK_FALSE(localRan);
+
+    release = true;
+    QElapsedTimer timer;
+    timer.start();
+    while (!localRan && (timer.elapsed() < 3000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    CHECK(localRan);
+    CHECK(SimClock::nowUs() == startUs + 2000);
+
+    clock.stop();
+    worker.quit();
+    worker.wait();
+}
+
+TEST_CASE("Seek moves replay position by trace time", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/seek.cdst";
+    writeTrace(path, 100);
+
+    TraceReplay replay;
+    QJsonObject config;
+    config["file"] = path;
+    replay.setConfig(config);
+
+    REQUIRE(replay.seek(50000));
+    CHECK(replay.position() == 50);
+    CHECK(replay.getConfig()["file"].toString() == path);
+}
+
+TEST_CASE("Precise replay releases records from replay thread", "[tracereplay]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/precise.cdst";
+    writeTrace(path, 100); // 100 ms of traffic
+
+    ReleaseTiming timing;
+    timing.spin = std::chrono::microseconds(300);
+
+    TraceReplay replay;
+    QJsonObject config;
+    config["file"] = path;
+    config["speed"] = 4.0;
+    config["timing"] = timing.toJson();
+    replay.setConfig(config);
+    CHECK(replay.getConfig().contains("timing"));
+
+    // Context object queues frames to this thread like FlowPlan does
+    QObject receiver;
+    QVector<quint32> ids;
+    bool finished = false;
+    QObject::connect(&replay, &TraceReplay::sendFrames, &receiver, [&](const CanFrameBatch& frames) {
+        for (const auto& rec : frames) {
+            ids.append(rec.id);
+        }
+    });
+    QObject::connect(&replay, &TraceReplay::finished, &receiver, [&] { finished = true; });
+
+    QElapsedTimer timer;
+    timer.start();
+    replay.startSimulation();
+    CHECK(replay.isPlaying());
+
+    while (!finished && (timer.elapsed() < 2000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    REQUIRE(finished);
+    REQUIRE(ids.size() == 100);
+    for (int i = 0; i < ids.size(); ++i) {
+        CHECK(ids[i] == static_cast<quint32>(i));
+    }
+    CHECK(timer.elapsed() >= 20);
+
+    const auto jitter = replay.releaseJitter();
+    CHECK(jitter.count == 100);
+    CHECK(jitter.max >= jitter.percentile(0.5));
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
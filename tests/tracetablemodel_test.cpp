@@ -0,0 +1,170 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTemporaryDir>
+#include <canrawview/tracetablemodel.h>
+#include <catch.hpp>
+#include <log.h>
+#include <tracelogger/tracewriter.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+// Ids cycle through 0x100..0x103, timestamps grow by 1ms starting at 1s
+void writeTrace(const QString& path, int count)
+{
+    CanFrameBatch batch;
+
+    for (int i = 0; i < count; ++i) {
+        CanFrameRecord rec = toCanFrameRecord(QCanBusFrame(0x100 + (i % 4), QByteArray(1, static_cast<char>(i))));
+        rec.timestamp = 1000000 + i * 1000;
+        batch.append(rec);
+    }
+
+    TraceWriter writer;
+    REQUIRE(writer.open(path));
+    writer.append(batch);
+    writer.close();
+}
+
+bool waitForIndex(TraceTableModel& model)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!model.isIndexReady() && (timer.elapsed() < 5000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+
+    return model.isIndexReady();
+}
+} // namespace
+
+TEST_CASE("Trace records are shown as rows", "[tracetablemodel]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/view.cdst";
+    writeTrace(path, 5000);
+
+    TraceTableModel model;
+    REQUIRE(model.open(path));
+    CHECK(model.rowCount() == 5000);
+    CHECK(model.columnCount() == FrameTableModel::ColumnCount);
+
+    const auto idx = [&model](int row, int col) { return model.data(model.index(row, col)); };
+    CHECK(idx(0, FrameTableModel::RowId).toULongLong() == 1);
+    CHECK(idx(4097, FrameTableModel::Id).toString() == "0x101");
+    CHECK(idx(10, FrameTableModel::Time).toString() == "0.010000");
+    CHECK(idx(10, FrameTableModel::Dir).toString() == "RX");
+    CHECK(idx(10, FrameTableModel::Data).toString() == "0a");
+
+    REQUIRE(waitForIndex(model));
+    // Newest frame of each id is marked
+    CHECK(model.data(model.index(4999, 0), FrameTableModel::LatestRole).toBool());
+    CHECK(!model.data(model.index(4000, 0), FrameTableModel::LatestRole).toBool());
+
+    model.close();
+    CHECK(model.rowCount() == 0);
+}
+
+TEST_CASE("Unique view and id filter are served from index", "[tracetablemodel]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/filter.cdst";
+    writeTrace(path, 1000);
+
+    TraceTableModel model;
+    REQUIRE(model.open(path));
+    REQUIRE(waitForIndex(model));
+
+    model.setUniqueOnly(true);
+    REQUIRE(model.rowCount() == 4);
+    CHECK(model.recordIndex(0) == 996);
+    CHECK(model.recordIndex(3) == 999);
+
+    model.setUniqueOnly(false);
+    model.setIdFilter({ 0x102, 0x100 });
+    REQUIRE(model.rowCount() == 500);
+    CHECK(model.record(0).id == 0x100);
+    CHECK(model.record(1).id == 0x102);
+    CHECK(model.recordIndex(499) == 998);
+
+    model.setUniqueOnly(true);
+    CHECK(model.rowCount() == 2);
+
+    model.setUniqueOnly(false);
+    model.setIdFilter({});
+    CHECK(model.rowCount() == 1000);
+}
+
+TEST_CASE("Standard and extended frames with the same id are kept apart", "[tracetablemodel]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/mixed.cdst";
+    CanFrameBatch batch;
+
+    // Standard RX, extended RX and standard TX frames of id 0x100
+    for (int i = 0; i < 30; ++i) {
+        CanFrameRecord rec = toCanFrameRecord(
+            QCanBusFrame(0x100, QByteArray(1, static_cast<char>(i))), (i % 3 == 2) ? Direction::TX : Direction::RX);
+        if (i % 3 == 1) {
+            rec.flags |= CanFrameRecord::ExtendedId;
+        }
+        rec.timestamp = 1000000 + i * 1000;
+        batch.append(rec);
+    }
+
+    TraceWriter writer;
+    REQUIRE(writer.open(path));
+    writer.append(batch);
+    writer.close();
+
+    TraceTableModel model;
+    REQUIRE(model.open(path));
+    REQUIRE(waitForIndex(model));
+
+    model.setUniqueOnly(true);
+    REQUIRE(model.rowCount() == 3);
+    CHECK(model.recordIndex(0) == 27);
+    CHECK(model.recordIndex(1) == 28);
+    CHECK(model.recordIndex(2) == 29);
+
+    // Id filter matches every format and direction, records stay in trace order
+    model.setUniqueOnly(false);
+    model.setIdFilter({ 0x100 });
+    REQUIRE(model.rowCount() == 30);
+    CHECK(model.recordIndex(1) == 1);
+    CHECK(model.recordIndex(29) == 29);
+}
+
+TEST_CASE("Row is found by time", "[tracetablemodel]")
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/time.cdst";
+    writeTrace(path, 10000);
+
+    TraceTableModel model;
+    CHECK(model.rowForTime(1.0) == -1);
+
+    REQUIRE(model.open(path));
+    CHECK(model.rowForTime(0.0) == 0);
+    CHECK(model.rowForTime(5.0) == 5000);
+    CHECK(model.rowForTime(5.0005) == 5001);
+    CHECK(model.rowForTime(100.0) == 9999);
+
+    REQUIRE(waitForIndex(model));
+    model.setIdFilter({ 0x101 });
+    // Record 5001 is the first 0x101 frame at or after 5s
+    CHECK(model.rowForTime(5.0) == 1250);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    return Catch::Session().run(argc, argv);
+}
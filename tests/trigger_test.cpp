@@ -0,0 +1,229 @@
+#define CATCH_CONFIG_RUNNER
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <catch.hpp>
+#include <log.h>
+#include <simclock.h>
+#include <trigger.h>
+#include <triggerprogram.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+CanFrameRecord makeRecord(quint32 id, quint64 timestamp, const char* hex = "00", bool extended = false)
+{
+    QCanBusFrame frame(id, QByteArray::fromHex(hex));
+    frame.setExtendedFrameFormat(extended);
+
+    CanFrameRecord rec = toCanFrameRecord(frame, Direction::RX);
+    rec.timestamp = timestamp;
+
+    return rec;
+}
+
+// Frames one millisecond apart, the first one at given millisecond
+CanFrameBatch makeBatch(quint64 first, int count, quint32 id = 0x100)
+{
+    CanFrameBatch batch;
+
+    for (int i = 0; i < count; ++i) {
+        batch.append(makeRecord(id, (first + i) * 1000));
+    }
+
+    return batch;
+}
+
+QJsonObject triggerConfig(const QJsonArray& conditions, int pre, double post, bool rearm = false)
+{
+    return QJsonObject{ { "conditions", conditions }, { "preTriggerFrames", pre }, { "postTriggerTime", post },
+        { "rearm", rearm } };
+}
+} // namespace
+
+TEST_CASE("Frame conditions compare id, format and payload under mask", "[trigger]")
+{
+    TriggerProgram program;
+
+    REQUIRE(program.compile(QJsonArray{ QJsonObject{ { "id", 0x120 }, { "mask", 0x7f0 } },
+                QJsonObject{
+                    { "id", 0x18daf110 }, { "data", "0000000000000000aa55" }, { "dataMask", "0000000000000000" } },
+                QJsonObject{ { "id", 0x200 }, { "data", "1f" }, { "dataMask", "f0" } },
+                QJsonObject{ { "data", "11" } }, QJsonObject{ { "signal", "Speed" } } })
+        == 3);
+    CHECK(program.hasFrameConditions());
+    CHECK_FALSE(program.hasSignalConditions());
+
+    CHECK(program.matches(makeRecord(0x12f, 0)));
+    CHECK_FALSE(program.matches(makeRecord(0x130, 0)));
+    // Same id in extended format is another frame
+    CHECK_FALSE(program.matches(makeRecord(0x120, 0, "00", true)));
+
+    CHECK(program.matches(makeRecord(0x18daf110, 0, "ffffffffffffffffaa55", true)));
+    CHECK_FALSE(program.matches(makeRecord(0x18daf110, 0, "ffffffffffffffffaa56", true)));
+    CHECK_FALSE(program.matches(makeRecord(0x18daf110, 0, "ffffffffffffffffaa", true)));
+
+    CHECK(program.matches(makeRecord(0x200, 0, "10")));
+    CHECK_FALSE(program.matches(makeRecord(0x200, 0, "21")));
+    CHECK_FALSE(program.matches(makeRecord(0x200, 0, "")));
+}
+
+TEST_CASE("Pre-trigger ring and post-trigger window are captured", "[trigger]")
+{
+    Trigger trigger;
+    std::vector<CanFrameRecord> captured;
+    std::vector<quint64> fired;
+
+    QJsonObject config = triggerConfig(QJsonArray{ QJsonObject{ { "id", 0x7df } } }, 3, 0.005);
+    trigger.setConfig(config);
+    QObject::connect(&trigger, &Trigger::framesCaptured, [&captured](const CanFrameBatch& frames) {
+        captured.insert(captured.end(), frames.begin(), frames.end());
+    });
+    QObject::connect(&trigger, &Trigger::triggered, [&fired](quint64 timestamp) { fired.push_back(timestamp); });
+
+    trigger.frameBatchReceived(makeBatch(1, 10));
+    CHECK(trigger.state() == Trigger::State::Idle);
+
+    trigger.startSimulation();
+    CHECK(trigger.state() == Trigger::State::Armed);
+
+    CanFrameBatch batch = makeBatch(1, 10);
+    batch.append(makeRecord(0x7df, 11000));
+    batch.append(makeBatch(12, 2));
+    trigger.frameBatchReceived(batch);
+
+    CHECK(trigger.state() == Trigger::State::Capturing);
+    REQUIRE(fired.size() == 1);
+    CHECK(fired[0] == 11000);
+    // Three newest frames before trigger (trigger frame included), the rest as it arrives
+    REQUIRE(captured.size() == 5);
+    CHECK(captured[0].timestamp == 9000);
+    CHECK(captured[2].id == 0x7df);
+
+    trigger.frameBatchSent(true, makeBatch(14, 10));
+    CHECK(trigger.state() == Trigger::State::Done);
+    CHECK(captured.size() == 5 + 3);
+    CHECK(captured.back().timestamp == 16000);
+
+    // Capture is not repeated without rearm
+    trigger.frameBatchReceived({ makeRecord(0x7df, 30000) });
+    CHECK(trigger.triggerCount() == 1);
+    CHECK(captured.size() == 8);
+
+    trigger.stopSimulation();
+    CHECK(trigger.state() == Trigger::State::Idle);
+}
+
+TEST_CASE("Rearmed trigger captures every occurrence", "[trigger]")
+{
+    Trigger trigger;
+    int batches = 0;
+
+    QJsonObject config
+        = triggerConfig(QJsonArray{ QJsonObject{ { "id", 0x100 }, { "data", "02" } } }, 0, 0.0, true);
+    trigger.setConfig(config);
+    QObject::connect(&trigger, &Trigger::framesCaptured, [&batches](const CanFrameBatch& frames) {
+        CHECK(frames.size() == 1);
+        ++batches;
+    });
+
+    trigger.startSimulation();
+    trigger.frameBatchReceived({ makeRecord(0x100, 1000, "01"), makeRecord(0x100, 2000, "02") });
+    trigger.frameBatchReceived({ makeRecord(0x100, 3000, "01"), makeRecord(0x100, 4000, "02") });
+
+    CHECK(trigger.triggerCount() == 2);
+    CHECK(batches == 2);
+}
+
+TEST_CASE("Post-trigger window closes without following frame", "[trigger]")
+{
+    Trigger trigger;
+    int captured = 0;
+
+    QJsonObject config = triggerConfig(QJsonArray{ QJsonObject{ { "id", 0x7df } } }, 10, 0.02);
+    trigger.setConfig(config);
+    QObject::connect(&trigger, &Trigger::framesCaptured, [&captured](const CanFrameBatch& frames) {
+        captured += frames.size();
+    });
+
+    trigger.startSimulation();
+    trigger.frameBatchReceived({ makeRecord(0x100, canTimestampNow()), makeRecord(0x7df, canTimestampNow()) });
+    CHECK(trigger.state() == Trigger::State::Capturing);
+    CHECK(captured == 2);
+
+    QElapsedTimer timer;
+    timer.start();
+    while ((trigger.state() == Trigger::State::Capturing) && (timer.elapsed() < 2000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    CHECK(trigger.state() == Trigger::State::Done);
+    CHECK(timer.elapsed() >= 15);
+}
+
+TEST_CASE("Post-trigger window closes in virtual time", "[trigger]")
+{
+    Trigger trigger;
+
+    QJsonObject config = triggerConfig(QJsonArray{ QJsonObject{ { "id", 0x7df } } }, 10, 0.02);
+    trigger.setConfig(config);
+
+    SimClock& clock = SimClock::instance();
+    clock.start(SimClock::Mode::Virtual);
+    const quint64 startUs = SimClock::nowUs();
+
+    trigger.startSimulation();
+    trigger.frameBatchReceived({ makeRecord(0x7df, startUs) });
+    CHECK(trigger.state() == Trigger::State::Capturing);
+
+    QElapsedTimer timer;
+    timer.start();
+    while ((trigger.state() == Trigger::State::Capturing) && (timer.elapsed() < 2000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    CHECK(trigger.state() == Trigger::State::Done);
+    CHECK(SimClock::nowUs() - startUs == 20000);
+    CHECK(clock.pendingEvents() == 0);
+
+    clock.stop();
+}
+
+TEST_CASE("Signal threshold fires trigger", "[trigger]")
+{
+    Trigger trigger;
+    std::vector<CanFrameRecord> captured;
+    auto catalog = std::make_shared<SignalCatalog>(SignalCatalog{ { "Engine", "Rpm", "1/min", 0x100, false, 0, 8000 },
+        { "Vehicle", "Speed", "km/h", 0x200, false, 0, 300 } });
+
+    QJsonObject config = triggerConfig(QJsonArray{ QJsonObject{ { "signal", "Speed" }, { "above", 120 } } }, 100, 1.0);
+    trigger.setConfig(config);
+    QObject::connect(&trigger, &Trigger::framesCaptured, [&captured](const CanFrameBatch& frames) {
+        captured.insert(captured.end(), frames.begin(), frames.end());
+    });
+
+    trigger.startSimulation();
+    trigger.frameBatchReceived(makeBatch(1, 5));
+    trigger.signalsReceived({ { 1000, 1, 0, 100.0 }, { 2000, 0, 0, 5000.0 } }, catalog);
+    CHECK(trigger.state() == Trigger::State::Armed);
+
+    trigger.signalsReceived({ { 5000, 1, 0, 130.0 } }, catalog);
+    CHECK(trigger.state() == Trigger::State::Capturing);
+    CHECK(captured.size() == 5);
+
+    CHECK(trigger.getConfig()["conditions"].toArray().size() == 1);
+    CHECK(trigger.getConfig()["preTriggerFrames"].toInt() == 100);
+    CHECK(trigger.getConfig()["postTriggerTime"].toDouble() == 1.0);
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
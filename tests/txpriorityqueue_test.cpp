@@ -0,0 +1,182 @@
+#include <QtCore/QJsonArray>
+#include <catch.hpp>
+#include <txpriorityqueue.h>
+
+namespace {
+
+QCanBusFrame makeFrame(quint32 id, bool extended = false)
+{
+    QCanBusFrame frame(id, QByteArray(8, '\0'));
+    frame.setExtendedFrameFormat(extended);
+
+    return frame;
+}
+
+std::vector<quint32> takeAll(TxPriorityQueue& queue)
+{
+    std::vector<quint32> ids;
+
+    while (!queue.empty()) {
+        ids.push_back(queue.take().frame.frameId());
+    }
+
+    return ids;
+}
+
+TxClass makeClass(const QString& name, quint32 id, quint32 mask, int quota, int maxAgeMs = 0)
+{
+    TxClass txClass;
+
+    txClass.name = name;
+    txClass.filters.append(makeCanFilter(id, mask));
+    txClass.quota = quota;
+    txClass.maxAgeMs = maxAgeMs;
+
+    return txClass;
+}
+
+} // namespace
+
+TEST_CASE("Frames are taken in arbitration order", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue;
+
+    CHECK(queue.push(makeFrame(0x300), 0));
+    CHECK(queue.push(makeFrame(0x100), 0));
+    CHECK(queue.push(makeFrame(0x200), 0));
+    CHECK(queue.size() == 3);
+
+    CHECK(takeAll(queue) == std::vector<quint32>{ 0x100, 0x200, 0x300 });
+}
+
+TEST_CASE("Base frame wins against extended frame with the same base id", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue;
+    const quint32 extendedId = 0x100u << 18;
+
+    queue.push(makeFrame(extendedId, true), 0);
+    queue.push(makeFrame(0x100), 0);
+    queue.push(makeFrame(extendedId | 1, true), 0);
+    queue.push(makeFrame(0x0ff), 0);
+
+    CHECK(takeAll(queue) == std::vector<quint32>{ 0x0ff, 0x100, extendedId, extendedId | 1 });
+
+    QCanBusFrame remote = makeFrame(0x100);
+    remote.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    CHECK(TxPriorityQueue::arbitrationKey(makeFrame(0x100)) < TxPriorityQueue::arbitrationKey(remote));
+}
+
+TEST_CASE("Frames with equal priority keep their order", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue;
+
+    for (char i = 0; i < 5; ++i) {
+        queue.push(QCanBusFrame(0x123, QByteArray(1, i)), 0);
+    }
+
+    for (char i = 0; i < 5; ++i) {
+        CHECK(queue.take().frame.payload() == QByteArray(1, i));
+    }
+}
+
+TEST_CASE("Restored frame keeps its place", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue;
+
+    queue.push(QCanBusFrame(0x10, QByteArray(1, 1)), 0);
+    queue.push(QCanBusFrame(0x10, QByteArray(1, 2)), 0);
+    queue.push(makeFrame(0x20), 0);
+
+    auto pending = queue.take();
+    CHECK(pending.frame.payload() == QByteArray(1, 1));
+    pending.retries += 1;
+    queue.restore(std::move(pending));
+
+    pending = queue.take();
+    CHECK(pending.frame.payload() == QByteArray(1, 1));
+    CHECK(pending.retries == 1);
+    CHECK(queue.take().frame.payload() == QByteArray(1, 2));
+}
+
+TEST_CASE("Quota of class and capacity of queue are enforced", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue(4);
+
+    queue.setClasses({ makeClass("diag", 0x700, 0x700, 1) });
+    REQUIRE(queue.classes().size() == 2);
+    CHECK(queue.classes().back().name == "default");
+
+    CHECK(queue.push(makeFrame(0x7df), 0));
+    CHECK_FALSE(queue.push(makeFrame(0x7e0), 0));
+    CHECK(queue.push(makeFrame(0x100), 0));
+    CHECK(queue.push(makeFrame(0x101), 0));
+    CHECK(queue.push(makeFrame(0x102), 0));
+    CHECK_FALSE(queue.push(makeFrame(0x103), 0));
+
+    auto stats = queue.stats();
+    REQUIRE(stats.size() == 2);
+    CHECK(stats[0].name == "diag");
+    CHECK(stats[0].queued == 1);
+    CHECK(stats[0].rejected == 1);
+    CHECK(stats[0].pending == 1);
+    CHECK(stats[1].queued == 3);
+    CHECK(stats[1].rejected == 1);
+
+    // Taking frame frees quota of its class
+    CHECK(queue.take().frame.frameId() == 0x100);
+    CHECK_FALSE(queue.push(makeFrame(0x7e0), 0));
+    queue.take();
+    queue.take();
+    CHECK(queue.take().frame.frameId() == 0x7df);
+    CHECK(queue.push(makeFrame(0x7e0), 0));
+}
+
+TEST_CASE("Stale frames are dropped", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue;
+
+    queue.setClasses({ makeClass("cyclic", 0x100, 0x700, 16, 10) });
+    queue.push(makeFrame(0x100), 1000);
+    queue.push(makeFrame(0x200), 1000);
+    queue.push(makeFrame(0x101), 6000);
+
+    CHECK(queue.dropStale(10999).isEmpty());
+
+    const auto dropped = queue.dropStale(11000);
+    REQUIRE(dropped.size() == 1);
+    CHECK(dropped[0].frameId() == 0x100);
+    CHECK(queue.size() == 2);
+
+    CHECK(queue.dropStale(16000).size() == 1);
+    CHECK(queue.stats()[0].stale == 2);
+    CHECK(takeAll(queue) == std::vector<quint32>{ 0x200 });
+}
+
+TEST_CASE("Residency is recorded per class", "[txpriorityqueue]")
+{
+    TxPriorityQueue queue;
+
+    queue.push(makeFrame(0x100), 100);
+    const auto pending = queue.take();
+    queue.recordResidency(pending, 350);
+
+    const auto stats = queue.stats();
+    REQUIRE(stats.size() == 1);
+    CHECK(stats[0].residencyUs.count == 1);
+    CHECK(stats[0].residencyUs.max == 250);
+}
+
+TEST_CASE("Transmit class is read from JSON", "[txpriorityqueue]")
+{
+    const QJsonObject json{ { "name", "diag" }, { "quota", 8 }, { "maxAge", 50 },
+        { "filters", canFiltersToJson({ makeCanFilter(0x700, 0x700) }) } };
+
+    const TxClass txClass = TxClass::fromJson(json);
+    CHECK(txClass.name == "diag");
+    CHECK(txClass.quota == 8);
+    CHECK(txClass.maxAgeMs == 50);
+    CHECK(txClass.filters.size() == 1);
+    CHECK(TxClass::fromJson(txClass.toJson()).toJson() == txClass.toJson());
+
+    CHECK(TxClass::fromJson({ { "quota", 0 } }).quota == TxClass::kDefaultQuota);
+}
@@ -0,0 +1,183 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <catch.hpp>
+#include <txscheduler.h>
+
+namespace {
+struct FrameCounter {
+    explicit FrameCounter(TxScheduler& scheduler)
+    {
+        QObject::connect(&scheduler, &TxScheduler::framesDue, [this](const QVector<QCanBusFrame>& frames) {
+            count += frames.size();
+            if (!frames.isEmpty()) {
+                lastId = frames.last().frameId();
+            }
+        });
+    }
+
+    int count{ 0 };
+    quint32 lastId{ 0 };
+};
+
+void spin(int ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < ms) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+}
+} // namespace
+
+TEST_CASE("Scheduler delivers cyclic frames in owner thread", "[txscheduler]")
+{
+    TxScheduler scheduler;
+    FrameCounter counter(scheduler);
+
+    const auto id = scheduler.add(QCanBusFrame(0x123, QByteArray("\x01", 1)), std::chrono::milliseconds(5));
+    CHECK(id != TxScheduler::kInvalidEntry);
+    CHECK(scheduler.size() == 1);
+
+    spin(100);
+
+    // Deadlines are absolute, so number of frames follows elapsed time regardless of delivery latency
+    CHECK(counter.count >= 15);
+    CHECK(counter.count <= 21);
+    CHECK(counter.lastId == 0x123);
+}
+
+TEST_CASE("Removed entry is not sent anymore", "[txscheduler]")
+{
+    TxScheduler scheduler;
+    FrameCounter counter(scheduler);
+
+    const auto id = scheduler.add(QCanBusFrame(0x1, QByteArray()), std::chrono::milliseconds(1));
+    spin(20);
+    scheduler.remove(id);
+    CHECK(scheduler.size() == 0);
+    spin(5);
+
+    CHECK(counter.count > 0);
+    const int count = counter.count;
+    spin(20);
+    CHECK(counter.count == count);
+
+    // Unknown ids are ignored
+    REQUIRE_NOTHROW(scheduler.remove(id));
+    REQUIRE_NOTHROW(scheduler.remove(TxScheduler::kInvalidEntry));
+}
+
+TEST_CASE("Payload mutator is applied before each transmission", "[txscheduler]")
+{
+    TxScheduler scheduler;
+    QVector<QCanBusFrame> sent;
+
+    QObject::connect(
+        &scheduler, &TxScheduler::framesDue, [&sent](const QVector<QCanBusFrame>& frames) { sent += frames; });
+
+    // Rolling counter in the first byte
+    const auto id = scheduler.add(QCanBusFrame(0x10, QByteArray("\x00\xAA", 2)), std::chrono::milliseconds(2),
+        [](quint8* payload, int length, quint64 count) {
+            if (length > 0) {
+                payload[0] = static_cast<quint8>(count + 1);
+            }
+        });
+    spin(30);
+
+    REQUIRE(sent.size() >= 2);
+    for (int i = 0; i < sent.size(); ++i) {
+        CHECK(static_cast<quint8>(sent[i].payload()[0]) == static_cast<quint8>(i + 1));
+        CHECK(static_cast<quint8>(sent[i].payload()[1]) == 0xAA);
+    }
+
+    CHECK(scheduler.update(id, QCanBusFrame(0x20, QByteArray("\x00", 1))));
+    sent.clear();
+    spin(10);
+    REQUIRE(!sent.isEmpty());
+    CHECK(sent.last().frameId() == 0x20);
+    CHECK(sent.last().payload().size() == 1);
+
+    CHECK_FALSE(scheduler.update(TxScheduler::kInvalidEntry, QCanBusFrame()));
+}
+
+TEST_CASE("Sequence is sent once with minimal separation", "[txscheduler]")
+{
+    TxScheduler scheduler;
+    QVector<QCanBusFrame> sent;
+    QVector<qint64> times;
+    QElapsedTimer timer;
+
+    QObject::connect(&scheduler, &TxScheduler::framesDue, [&](const QVector<QCanBusFrame>& frames) {
+        sent += frames;
+        times.append(timer.nsecsElapsed());
+    });
+
+    const QVector<QCanBusFrame> frames{ QCanBusFrame(0x1, QByteArray()), QCanBusFrame(0x2, QByteArray()),
+        QCanBusFrame(0x3, QByteArray()) };
+
+    CHECK(scheduler.addSequence({}, std::chrono::milliseconds(1)) == TxScheduler::kInvalidEntry);
+
+    timer.start();
+    const auto id = scheduler.addSequence(frames, std::chrono::milliseconds(5));
+    CHECK(id != TxScheduler::kInvalidEntry);
+    spin(50);
+
+    REQUIRE(sent.size() == 3);
+    CHECK(sent[0].frameId() == 0x1);
+    CHECK(sent[2].frameId() == 0x3);
+    // Each frame was delivered separately, at least interval after the previous one
+    REQUIRE(times.size() == 3);
+    CHECK(times[2] - times[0] >= 2 * 4000000);
+    CHECK(scheduler.size() == 0);
+
+    // Zero interval sends whole sequence at once
+    sent.clear();
+    scheduler.addSequence(frames, std::chrono::microseconds(0));
+    spin(10);
+    CHECK(sent.size() == 3);
+}
+
+TEST_CASE("Release timing survives configuration round trip", "[txscheduler]")
+{
+    ReleaseTiming timing;
+    CHECK_FALSE(timing.isPrecise());
+    CHECK(ReleaseTiming::fromJson(QJsonObject()) == timing);
+
+    timing.spin = std::chrono::microseconds(150);
+    timing.cpu = 2;
+    timing.priority = 50;
+    CHECK(timing.isPrecise());
+    CHECK(ReleaseTiming::fromJson(timing.toJson()) == timing);
+
+    // Out of range values fall back to the nearest valid ones
+    const auto clamped = ReleaseTiming::fromJson(QJsonObject{ { "spinUs", -5 }, { "cpu", -7 }, { "rtPriority", 500 } });
+    CHECK(clamped.spin.count() == 0);
+    const int anyCpu = ReleaseTiming::kAnyCpu;
+    CHECK(clamped.cpu == anyCpu);
+    CHECK(clamped.priority == 99);
+}
+
+TEST_CASE("Precise timing collects lateness of releases", "[txscheduler]")
+{
+    TxScheduler scheduler;
+    FrameCounter counter(scheduler);
+
+    // Only spinning, affinity and priority need privileges
+    ReleaseTiming timing;
+    timing.spin = std::chrono::microseconds(500);
+    scheduler.setTiming(timing);
+    CHECK(scheduler.timing() == timing);
+
+    const auto id = scheduler.add(QCanBusFrame(0x10, QByteArray()), std::chrono::milliseconds(2));
+    spin(50);
+
+    const auto jitter = scheduler.releaseJitter();
+    CHECK(counter.count >= 15);
+    CHECK(jitter.count >= 15);
+    CHECK(jitter.max >= jitter.percentile(0.5));
+
+    scheduler.resetReleaseJitter();
+    scheduler.remove(id);
+    CHECK(scheduler.releaseJitter().count <= 1);
+}
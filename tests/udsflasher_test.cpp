@@ -0,0 +1,238 @@
+#define CATCH_CONFIG_RUNNER
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <catch.hpp>
+#include <log.h>
+#include <udsflasher/udsflasher.h>
+
+std::shared_ptr<spdlog::logger> kDefaultLogger;
+
+namespace {
+// Answers requests of flasher from event loop, as responses would come from IsoTp node
+struct FakeEcu {
+    explicit FakeEcu(UdsFlasher& flasher)
+        : flasher(flasher)
+    {
+        QObject::connect(&flasher, &UdsFlasher::sendPdu, [this](const IsoTpPdu& pdu) {
+            if (deferCopy) {
+                // Request data stays valid until its response, as for a queued ISO-TP sender
+                QTimer::singleShot(0, [this, pdu] {
+                    const QByteArray request(reinterpret_cast<const char*>(pdu.data), static_cast<int>(pdu.length));
+                    requests.push_back(request);
+                    handle(request);
+                });
+                return;
+            }
+            const QByteArray request(reinterpret_cast<const char*>(pdu.data), static_cast<int>(pdu.length));
+            requests.push_back(request);
+            QTimer::singleShot(0, [this, request] { handle(request); });
+        });
+    }
+
+    void handle(const QByteArray& request)
+    {
+        const auto sid = static_cast<quint8>(request[0]);
+
+        if (sid == 0x34) {
+            if (pending) {
+                pending = false;
+                respond(QByteArray::fromHex("7f3478"));
+                QTimer::singleShot(20, [this] { respond(QByteArray::fromHex("74200102")); });
+                return;
+            }
+            respond(QByteArray::fromHex("7410") + QByteArray(1, static_cast<char>(blockLength)));
+        } else if (sid == 0x36) {
+            if (rejectBlock && (requests.size() - 1 == rejectBlock)) {
+                respond(QByteArray::fromHex("7f3672"));
+                return;
+            }
+            image.append(request.mid(2));
+            const auto counter = static_cast<char>(request[1] + counterSkew);
+            respond(QByteArray(1, '\x76') + QByteArray(1, counter));
+        } else if (sid == 0x37) {
+            respond(QByteArray::fromHex("77"));
+        }
+    }
+
+    void respond(const QByteArray& response)
+    {
+        flasher.pduReceived(IsoTpPdu{ 0x7e0, 0x7e8, reinterpret_cast<const quint8*>(response.constData()),
+            static_cast<quint32>(response.size()), 0 });
+    }
+
+    UdsFlasher& flasher;
+    std::vector<QByteArray> requests;
+    QByteArray image;
+    int blockLength{ 0x82 };
+    bool pending{ false };
+    int counterSkew{ 0 };
+    std::size_t rejectBlock{ 0 };
+    bool deferCopy{ false };
+};
+
+QString writeImage(const QTemporaryDir& dir, int length)
+{
+    const QString path = dir.filePath("image.bin");
+    QFile file(path);
+    QByteArray data(length, '\0');
+
+    for (int i = 0; i < length; ++i) {
+        data[i] = static_cast<char>(i * 13);
+    }
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+
+    return path;
+}
+
+bool waitFinished(UdsFlasher& flasher)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while ((flasher.state() != UdsFlasher::State::Done) && (flasher.state() != UdsFlasher::State::Failed)
+        && (timer.elapsed() < 3000)) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    return flasher.state() == UdsFlasher::State::Done;
+}
+
+void configure(UdsFlasher& flasher, const QString& file)
+{
+    QJsonObject config{ { "file", file }, { "address", 0x8000 }, { "addressLength", 3 }, { "sizeLength", 2 } };
+    flasher.setConfig(config);
+}
+} // namespace
+
+TEST_CASE("Image is downloaded in blocks with wrapping counter", "[udsflasher]")
+{
+    QTemporaryDir dir;
+    UdsFlasher flasher;
+    FakeEcu ecu(flasher);
+    std::vector<quint64> progress;
+
+    // 128 bytes per block, 300 blocks make counter wrap
+    const QString file = writeImage(dir, 300 * 128 - 5);
+    configure(flasher, file);
+    CHECK(flasher.getConfig()["addressLength"].toInt() == 3);
+    QObject::connect(
+        &flasher, &UdsFlasher::progress, [&progress](quint64 bytes, quint64) { progress.push_back(bytes); });
+
+    REQUIRE(flasher.start());
+    CHECK_FALSE(flasher.start());
+    REQUIRE(waitFinished(flasher));
+
+    QFile image(file);
+    image.open(QIODevice::ReadOnly);
+    CHECK(ecu.image == image.readAll());
+
+    REQUIRE(ecu.requests.size() == 302);
+    CHECK(ecu.requests[0] == QByteArray::fromHex("34002300800095fb"));
+    CHECK(ecu.requests[1].size() == 130);
+    CHECK(ecu.requests[1].left(2) == QByteArray::fromHex("3601"));
+    CHECK(ecu.requests[255].left(2) == QByteArray::fromHex("36ff"));
+    CHECK(ecu.requests[256].left(2) == QByteArray::fromHex("3600"));
+    CHECK(ecu.requests[300].size() == 125);
+    CHECK(ecu.requests[301] == QByteArray::fromHex("37"));
+
+    const FlashStatistics stats = flasher.statistics();
+    CHECK(stats.bytes == 300 * 128 - 5);
+    CHECK(stats.blocks == 300);
+    CHECK(stats.elapsedUs > 0);
+    CHECK(stats.throughput > 0.0);
+    CHECK(stats.busCapacity > 0.0);
+    CHECK(progress.size() == 300);
+    CHECK(progress.back() == stats.bytes);
+}
+
+TEST_CASE("Block in flight is not overwritten by next prepared block", "[udsflasher]")
+{
+    QTemporaryDir dir;
+    UdsFlasher flasher;
+    FakeEcu ecu(flasher);
+    ecu.deferCopy = true;
+
+    const QString file = writeImage(dir, 4 * 128);
+    configure(flasher, file);
+
+    REQUIRE(flasher.start());
+    REQUIRE(waitFinished(flasher));
+
+    QFile image(file);
+    image.open(QIODevice::ReadOnly);
+    CHECK(ecu.image == image.readAll());
+
+    REQUIRE(ecu.requests.size() == 6);
+    CHECK(ecu.requests[1].left(2) == QByteArray::fromHex("3601"));
+    CHECK(ecu.requests[4].left(2) == QByteArray::fromHex("3604"));
+    CHECK(ecu.requests[5] == QByteArray::fromHex("37"));
+}
+
+TEST_CASE("Response pending extends timeout and block length is limited", "[udsflasher]")
+{
+    QTemporaryDir dir;
+    UdsFlasher flasher;
+    FakeEcu ecu(flasher);
+
+    ecu.pending = true;
+    configure(flasher, writeImage(dir, 10000));
+
+    REQUIRE(flasher.start());
+    REQUIRE(waitFinished(flasher));
+
+    // ECU announced 0x0102 bytes, classic ISO-TP keeps it
+    CHECK(ecu.requests[1].size() == 0x102);
+    CHECK(ecu.image.size() == 10000);
+}
+
+TEST_CASE("Download fails on unexpected counter or negative response", "[udsflasher]")
+{
+    QTemporaryDir dir;
+    UdsFlasher flasher;
+    FakeEcu ecu(flasher);
+    bool success = true;
+
+    QObject::connect(&flasher, &UdsFlasher::finished, [&success](bool s) { success = s; });
+    configure(flasher, writeImage(dir, 1000));
+
+    SECTION("Counter mismatch")
+    {
+        ecu.counterSkew = 1;
+        REQUIRE(flasher.start());
+        CHECK_FALSE(waitFinished(flasher));
+        CHECK(ecu.requests.size() == 2);
+    }
+
+    SECTION("Negative response")
+    {
+        ecu.rejectBlock = 3;
+        REQUIRE(flasher.start());
+        CHECK_FALSE(waitFinished(flasher));
+        CHECK(ecu.requests.size() == 4);
+        CHECK(flasher.statistics().blocks == 2);
+    }
+
+    CHECK_FALSE(success);
+    CHECK(flasher.state() == UdsFlasher::State::Failed);
+
+    // Missing image is reported right away
+    QJsonObject config{ { "file", dir.filePath("missing.bin") } };
+    flasher.setConfig(config);
+    CHECK_FALSE(flasher.start());
+}
+
+int main(int argc, char* argv[])
+{
+    bool haveDebug = std::getenv("CDS_DEBUG") != nullptr;
+    kDefaultLogger = spdlog::stdout_color_mt("cds");
+    if (haveDebug) {
+        kDefaultLogger->set_level(spdlog::level::debug);
+    }
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
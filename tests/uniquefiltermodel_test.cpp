@@ -0,0 +1,112 @@
+#include <QSignalSpy>
+#include <canrawview/frametablemodel.h>
+#include <canrawview/uniquefiltermodel.h>
+#include <catch.hpp>
+
+namespace {
+CanFrameBatch makeBatch(const std::vector<quint32>& ids)
+{
+    CanFrameBatch batch;
+
+    for (auto id : ids) {
+        batch.append(toCanFrameRecord(QCanBusFrame(id, QByteArray::fromHex("00"))));
+    }
+
+    return batch;
+}
+
+quint32 proxyId(const UniqueFilterModel& proxy, int row)
+{
+    return static_cast<quint32>(proxy.index(row, FrameTableModel::IdInt).data().toInt());
+}
+} // namespace
+
+TEST_CASE("Natural order does not sort", "[uniquefiltermodel]")
+{
+    FrameTableModel model;
+    UniqueFilterModel proxy;
+    proxy.setSourceModel(&model);
+
+    proxy.sort(FrameTableModel::RowId, Qt::AscendingOrder);
+    CHECK(proxy.sortColumn() == -1);
+
+    proxy.sort(FrameTableModel::TimeDouble, Qt::AscendingOrder);
+    CHECK(proxy.sortColumn() == -1);
+
+    proxy.sort(FrameTableModel::RowId, Qt::DescendingOrder);
+    CHECK(proxy.sortColumn() == FrameTableModel::RowId);
+}
+
+TEST_CASE("Appended frames keep sort order", "[uniquefiltermodel]")
+{
+    FrameTableModel model;
+    UniqueFilterModel proxy;
+    proxy.setSourceModel(&model);
+
+    model.appendFrames(makeBatch({ 5, 1, 9 }), std::vector<double>(3, 0.0));
+    proxy.sort(FrameTableModel::IdInt, Qt::AscendingOrder);
+
+    model.appendFrames(makeBatch({ 3, 7 }), std::vector<double>(2, 1.0));
+
+    REQUIRE(proxy.rowCount() == 5);
+    CHECK(proxyId(proxy, 0) == 1);
+    CHECK(proxyId(proxy, 1) == 3);
+    CHECK(proxyId(proxy, 2) == 5);
+    CHECK(proxyId(proxy, 3) == 7);
+    CHECK(proxyId(proxy, 4) == 9);
+}
+
+TEST_CASE("Paused sort keeps source order until resumed", "[uniquefiltermodel]")
+{
+    FrameTableModel model;
+    UniqueFilterModel proxy;
+    proxy.setSourceModel(&model);
+
+    model.appendFrames(makeBatch({ 5, 1, 9 }), std::vector<double>(3, 0.0));
+    proxy.sort(FrameTableModel::IdInt, Qt::AscendingOrder);
+    proxy.setSortPaused(true);
+    CHECK(proxy.isSortPaused());
+    CHECK(proxy.sortColumn() == -1);
+
+    model.appendFrames(makeBatch({ 3 }), std::vector<double>(1, 1.0));
+    // Sort requested while paused replaces the one to be restored
+    proxy.sort(FrameTableModel::IdInt, Qt::DescendingOrder);
+
+    REQUIRE(proxy.rowCount() == 4);
+    CHECK(proxyId(proxy, 0) == 5);
+    CHECK(proxyId(proxy, 3) == 3);
+
+    proxy.setSortPaused(false);
+    CHECK(proxy.sortColumn() == FrameTableModel::IdInt);
+    CHECK(proxyId(proxy, 0) == 9);
+    CHECK(proxyId(proxy, 1) == 5);
+    CHECK(proxyId(proxy, 2) == 3);
+    CHECK(proxyId(proxy, 3) == 1);
+}
+
+TEST_CASE("Filter shows newest frame per id and direction", "[uniquefiltermodel]")
+{
+    FrameTableModel model;
+    UniqueFilterModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.toggleFilter();
+    REQUIRE(proxy.isFilterActive());
+
+    model.appendFrames(makeBatch({ 1, 2, 1 }), std::vector<double>(3, 0.0));
+    CHECK(proxy.rowCount() == 2);
+
+    CanFrameBatch tx;
+    tx.append(toCanFrameRecord(QCanBusFrame(1, QByteArray()), Direction::TX));
+    model.appendFrames(tx, { 1.0 });
+    CHECK(proxy.rowCount() == 3);
+
+    QSignalSpy changed(&model, &FrameTableModel::dataChanged);
+    model.appendFrames(makeBatch({ 2 }), { 2.0 });
+    CHECK(changed.count() == 1);
+    REQUIRE(proxy.rowCount() == 3);
+    CHECK(model.isLatest(1) == false);
+    CHECK(model.isLatest(4));
+
+    proxy.toggleFilter();
+    CHECK(proxy.rowCount() == 5);
+}
@@ -0,0 +1,103 @@
+#include <catch.hpp>
+#include <string>
+#include <visitor.h>
+
+namespace {
+struct Shape {
+    virtual ~Shape() = default;
+};
+
+struct Other {
+    virtual ~Other() = default;
+    int other{ 0 };
+};
+
+struct Circle : public Shape, public Other {
+    int radius{ 1 };
+};
+
+struct Square : public Shape, public Other {
+    int side{ 2 };
+};
+
+struct Triangle : public Shape {
+};
+
+struct Unknown : public Shape {
+};
+
+using Shapes = TypeTags<Circle, Square, Triangle>;
+
+struct ShapeVisitor : Visitor<ShapeVisitor, Circle, Square> {
+    using Visitor::Visitor;
+};
+} // namespace
+
+TEST_CASE("Tags follow order of types", "[visitor]")
+{
+    static_assert(Shapes::tag_of<Circle>() == 0, "");
+    static_assert(Shapes::tag_of<Triangle>() == 2, "");
+    static_assert(Shapes::none == 3, "");
+
+    Square square;
+    Unknown unknown;
+    const Shape& s = square;
+
+    CHECK(Shapes::tag(s) == Shapes::tag_of<Square>());
+    CHECK(Shapes::tag(static_cast<const Shape&>(unknown)) == Shapes::none);
+}
+
+TEST_CASE("Dispatch reaches sibling base without cross cast", "[visitor]")
+{
+    Circle circle;
+    Square square;
+    Unknown unknown;
+    Shape* shapes[] = { &circle, &square };
+    int sum = 0;
+
+    circle.other = 3;
+    square.other = 4;
+
+    using Others = TypeTags<Circle, Square>;
+
+    for (Shape* s : shapes) {
+        CHECK(Others::dispatch(*s, [&sum](Other& o) { sum += o.other; }));
+    }
+
+    CHECK(sum == 7);
+    CHECK_FALSE(Shapes::dispatch(static_cast<Shape&>(unknown), [&sum](Shape&) { sum = 0; }));
+    CHECK(sum == 7);
+}
+
+TEST_CASE("Cast checks exact type", "[visitor]")
+{
+    Circle circle;
+    Shape* s = &circle;
+
+    REQUIRE(Shapes::cast<Circle>(s) == &circle);
+    CHECK(Shapes::cast<Square>(s) == nullptr);
+    CHECK(Shapes::cast<Circle>(static_cast<Shape*>(nullptr)) == nullptr);
+}
+
+TEST_CASE("for_each visits types in tag order", "[visitor]")
+{
+    std::string order;
+
+    Shapes::for_each([&order](auto t) { order += std::to_string(Shapes::tag_of<typename decltype(t)::type>()); });
+
+    CHECK(order == "012");
+}
+
+TEST_CASE("Visitor dispatches to matching action", "[visitor]")
+{
+    Square square;
+    Triangle triangle;
+    int side = 0;
+    bool circle = false;
+    ShapeVisitor v{ [&circle](Circle&) { circle = true; }, [&side](Square& s) { side = s.side; } };
+
+    CHECK(v.dispatch(static_cast<Shape&>(square)));
+    CHECK(side == 2);
+    CHECK_FALSE(circle);
+    CHECK_FALSE(v.dispatch(static_cast<Shape&>(triangle)));
+}